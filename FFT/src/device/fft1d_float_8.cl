@@ -58,6 +58,20 @@ except:
     kernel_param_attributes = [{"in": "", "out": ""} for i in range(num_replications)]
 */
 
+// Additional FFT sizes can be given to the code generator with fft_additional_log_sizes.
+// A separate FFT engine is generated for every size. The kernel names of these engines
+// get the suffix _log<LOGN>, while the kernels for LOG_FFT_SIZE keep their names.
+/* PY_CODE_GEN 
+try:
+    fft_log_sizes = [None] + [l for l in fft_additional_log_sizes]
+except:
+    fft_log_sizes = [None]
+def size_suffix(l):
+    return "" if l is None else "_log%d" % l
+def size_logn(l):
+    return "LOG_FFT_SIZE" if l is None else "%d" % l
+*/
+
 
 #define min(a,b) (a<b?a:b)
 
@@ -69,19 +83,32 @@ except:
 // Need some depth to our channels to accommodate their bursty filling.
 #ifdef INTEL_FPGA
 #pragma OPENCL EXTENSION cl_intel_channels : enable
-// PY_CODE_GEN block_start [replace(local_variables=locals()) for i in range(num_total_replications)]
-channel float2 chanin/*PY_CODE_GEN i*/[POINTS] __attribute__((depth(POINTS)));
+// PY_CODE_GEN block_start [replace(local_variables=locals()) for i in range(num_total_replications) for l in fft_log_sizes]
+channel float2 chanin/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[POINTS] __attribute__((depth(POINTS)));
+// PY_CODE_GEN block_end
+#ifdef FFT_CONVOLUTION
+// Channels that connect the forward FFT engine, the filter and the inverse FFT engine of the convolution
+// PY_CODE_GEN block_start [replace(local_variables=locals()) for i in range(num_total_replications) for l in fft_log_sizes]
+channel float2 chanconv/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[POINTS] __attribute__((depth(POINTS)));
+channel float2 chanfilt/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[POINTS] __attribute__((depth(POINTS)));
 // PY_CODE_GEN block_end
 #endif
+#endif
 #ifdef XILINX_FPGA
 #define XILINX_PIPE_DEPTH 16
 //#define XILINX_PIPE_DEPTH ((1 << (LOGN - LOGPOINTS) < 16) ? 16 : (1 << (LOGN - LOGPOINTS)))
 
 // Compiler states, that the pipe depth needs at least to be 16
-// PY_CODE_GEN block_start [replace(local_variables=locals()) for i in range(num_total_replications)]
-pipe float2x8 chanin/*PY_CODE_GEN i*/ __attribute__((xcl_reqd_pipe_depth(XILINX_PIPE_DEPTH)));
-pipe float2x8 chanout/*PY_CODE_GEN i*/ __attribute__((xcl_reqd_pipe_depth(XILINX_PIPE_DEPTH)));
+// PY_CODE_GEN block_start [replace(local_variables=locals()) for i in range(num_total_replications) for l in fft_log_sizes]
+pipe float2x8 chanin/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/ __attribute__((xcl_reqd_pipe_depth(XILINX_PIPE_DEPTH)));
+pipe float2x8 chanout/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/ __attribute__((xcl_reqd_pipe_depth(XILINX_PIPE_DEPTH)));
 // PY_CODE_GEN block_end
+#ifdef FFT_CONVOLUTION
+// PY_CODE_GEN block_start [replace(local_variables=locals()) for i in range(num_total_replications) for l in fft_log_sizes]
+pipe float2x8 chanconv/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/ __attribute__((xcl_reqd_pipe_depth(XILINX_PIPE_DEPTH)));
+pipe float2x8 chanfilt/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/ __attribute__((xcl_reqd_pipe_depth(XILINX_PIPE_DEPTH)));
+// PY_CODE_GEN block_end
+#endif
 #endif
 
 uint bit_reversed(uint x, uint bits) {
@@ -96,11 +123,15 @@ __attribute__((opencl_unroll_hint()))
   return y;
 }
 
-// PY_CODE_GEN block_start [replace(local_variables=locals()) for i in range(num_total_replications)]
+// PY_CODE_GEN block_start [replace(local_variables=locals()) for i in range(num_total_replications) for l in fft_log_sizes]
+
+// Every engine is generated with its own FFT size
+#undef LOGN
+#define LOGN /*PY_CODE_GEN size_logn(l)*/
 
 __kernel
 __attribute__ ((max_global_work_dim(0), reqd_work_group_size(1,1,1)))
-void fetch/*PY_CODE_GEN i*/(__global /*PY_CODE_GEN kernel_param_attributes[i]["in"]*/ float2 * restrict src, int iter) {
+void fetch/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/(__global /*PY_CODE_GEN kernel_param_attributes[i]["in"]*/ float2 * restrict src, int iter) {
 
   const int N = (1 << LOGN);
 
@@ -164,17 +195,17 @@ void fetch/*PY_CODE_GEN i*/(__global /*PY_CODE_GEN kernel_param_attributes[i]["i
       buf2x8.i7 = write_chunk[7];
 
       // Start in the second iteration to forward the buffered data over the pipe
-      write_pipe_block(chanin/*PY_CODE_GEN i*/, &buf2x8);
+      write_pipe_block(chanin/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/, &buf2x8);
 #endif
 #ifdef INTEL_FPGA
-        write_channel_intel(chanin/*PY_CODE_GEN i*/[0], write_chunk[0]); 
-        write_channel_intel(chanin/*PY_CODE_GEN i*/[1], write_chunk[1]);  
-        write_channel_intel(chanin/*PY_CODE_GEN i*/[2], write_chunk[2]);  
-        write_channel_intel(chanin/*PY_CODE_GEN i*/[3], write_chunk[3]);  
-        write_channel_intel(chanin/*PY_CODE_GEN i*/[4], write_chunk[4]);  
-        write_channel_intel(chanin/*PY_CODE_GEN i*/[5], write_chunk[5]); 
-        write_channel_intel(chanin/*PY_CODE_GEN i*/[6], write_chunk[6]);  
-        write_channel_intel(chanin/*PY_CODE_GEN i*/[7], write_chunk[7]);  
+        write_channel_intel(chanin/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[0], write_chunk[0]); 
+        write_channel_intel(chanin/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[1], write_chunk[1]);  
+        write_channel_intel(chanin/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[2], write_chunk[2]);  
+        write_channel_intel(chanin/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[3], write_chunk[3]);  
+        write_channel_intel(chanin/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[4], write_chunk[4]);  
+        write_channel_intel(chanin/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[5], write_chunk[5]); 
+        write_channel_intel(chanin/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[6], write_chunk[6]);  
+        write_channel_intel(chanin/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[7], write_chunk[7]);  
 #endif
     }
   }
@@ -189,16 +220,22 @@ void fetch/*PY_CODE_GEN i*/(__global /*PY_CODE_GEN kernel_param_attributes[i]["i
  * using restrict pointers as there are no dependencies between the buffers
  * 'count' represents the number of 4k sets to process
  * 'inverse' toggles between the direct and the inverse transform
+ * 'convolution' forwards the result to the filter kernel of the convolution instead of
+ * storing it in global memory. It is only available, if FFT_CONVOLUTION is defined.
  */
 
 __attribute__ ((max_global_work_dim(0)))
 __attribute__((reqd_work_group_size(1,1,1)))
-kernel void fft1d/*PY_CODE_GEN i*/(
+kernel void fft1d/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/(
 #ifdef INTEL_FPGA
                 // Intel does not need a store kernel and directly writes back the result to global memory
                 __global /*PY_CODE_GEN kernel_param_attributes[i]["out"]*/ float2 * restrict dest,
 #endif
-                int count, int inverse) {
+                int count, int inverse
+#ifdef FFT_CONVOLUTION
+                , int convolution
+#endif
+                ) {
 
   const int N = (1 << LOGN);
 
@@ -235,17 +272,17 @@ kernel void fft1d/*PY_CODE_GEN i*/(
     // Perform memory transfers only when reading data in range
     if (i < count * (N / POINTS)) {
 #ifdef INTEL_FPGA
-      data.i0 = read_channel_intel(chanin/*PY_CODE_GEN i*/[0]);
-      data.i1 = read_channel_intel(chanin/*PY_CODE_GEN i*/[1]);
-      data.i2 = read_channel_intel(chanin/*PY_CODE_GEN i*/[2]);
-      data.i3 = read_channel_intel(chanin/*PY_CODE_GEN i*/[3]);
-      data.i4 = read_channel_intel(chanin/*PY_CODE_GEN i*/[4]);
-      data.i5 = read_channel_intel(chanin/*PY_CODE_GEN i*/[5]);
-      data.i6 = read_channel_intel(chanin/*PY_CODE_GEN i*/[6]);
-      data.i7 = read_channel_intel(chanin/*PY_CODE_GEN i*/[7]);
+      data.i0 = read_channel_intel(chanin/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[0]);
+      data.i1 = read_channel_intel(chanin/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[1]);
+      data.i2 = read_channel_intel(chanin/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[2]);
+      data.i3 = read_channel_intel(chanin/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[3]);
+      data.i4 = read_channel_intel(chanin/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[4]);
+      data.i5 = read_channel_intel(chanin/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[5]);
+      data.i6 = read_channel_intel(chanin/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[6]);
+      data.i7 = read_channel_intel(chanin/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[7]);
 #endif
 #ifdef XILINX_FPGA
-      read_pipe_block(chanin/*PY_CODE_GEN i*/, &data);
+      read_pipe_block(chanin/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/, &data);
 #endif
     } else {
       data.i0 = data.i1 = data.i2 = data.i3 = 
@@ -259,6 +296,24 @@ kernel void fft1d/*PY_CODE_GEN i*/(
      * N / 8 - 1 steps, hence gate writes accordingly
      */
     if (i >= N / POINTS - 1) {
+#ifdef FFT_CONVOLUTION
+      if (convolution) {
+#ifdef INTEL_FPGA
+        write_channel_intel(chanconv/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[0], data.i0);
+        write_channel_intel(chanconv/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[1], data.i1);
+        write_channel_intel(chanconv/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[2], data.i2);
+        write_channel_intel(chanconv/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[3], data.i3);
+        write_channel_intel(chanconv/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[4], data.i4);
+        write_channel_intel(chanconv/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[5], data.i5);
+        write_channel_intel(chanconv/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[6], data.i6);
+        write_channel_intel(chanconv/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[7], data.i7);
+#endif
+#ifdef XILINX_FPGA
+        write_pipe_block(chanconv/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/, &data);
+#endif
+      }
+      else {
+#endif
 #ifdef INTEL_FPGA
       int base = POINTS * (i - (N / POINTS - 1));
  
@@ -274,7 +329,10 @@ kernel void fft1d/*PY_CODE_GEN i*/(
 #endif
 #ifdef XILINX_FPGA
     // For Xilinx send the data to the store kernel to enable memory bursts
-      write_pipe_block(chanout/*PY_CODE_GEN i*/, &data);
+      write_pipe_block(chanout/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/, &data);
+#endif
+#ifdef FFT_CONVOLUTION
+      }
 #endif
     }
   }
@@ -287,14 +345,14 @@ This kernel works without conditional branches which enables memory bursts.
  */
 __kernel
 __attribute__ ((max_global_work_dim(0), reqd_work_group_size(1,1,1)))
-void store/*PY_CODE_GEN i*/(__global /*PY_CODE_GEN kernel_param_attributes[i]["out"]*/ float2 * restrict dest, int iter) {
+void store/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/(__global /*PY_CODE_GEN kernel_param_attributes[i]["out"]*/ float2 * restrict dest, int iter) {
 
   const int N = (1 << LOGN);
 
   // write the data back to global memory using memory bursts
   for(unsigned k = 0; k < iter * (N / POINTS); k++){ 
       float2x8 buf2x8;
-      read_pipe_block(chanout/*PY_CODE_GEN i*/, &buf2x8);
+      read_pipe_block(chanout/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/, &buf2x8);
 
       dest[(k << LOGPOINTS)]     = buf2x8.i0;    
       dest[(k << LOGPOINTS) + 1] = buf2x8.i1; 
@@ -308,4 +366,201 @@ void store/*PY_CODE_GEN i*/(__global /*PY_CODE_GEN kernel_param_attributes[i]["o
 }
 #endif
 
+#ifdef FFT_MULTI_DIMENSIONAL
+/**
+The transpose kernel is used between the FFT passes of a multi-dimensional FFT.
+The data is interpreted as count matrices with rows x N values each. Every matrix is transposed, so
+the next pass will calculate the FFT over the next dimension.
+The output of the FFT engine is in bit reversed order, so the columns are reordered to the natural order during the transposition.
+This way, the result of a complete multi-dimensional FFT is in natural order.
+Similar to the blocked transposition of PTRANS, POINTS rows are buffered in local memory,
+so the data can be read and written in chunks of POINTS consecutive values.
+The buffered values are shifted to prevent bank conflicts for both access patterns.
+ */
+__kernel
+__attribute__ ((max_global_work_dim(0), reqd_work_group_size(1,1,1)))
+void transpose/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/(__global /*PY_CODE_GEN kernel_param_attributes[i]["out"]*/ const float2 * restrict src,
+                __global /*PY_CODE_GEN kernel_param_attributes[i]["in"]*/ float2 * restrict dest, int rows, int count) {
+
+  const int N = (1 << LOGN);
+
+  float2 buf[N][POINTS] __attribute__((numbanks(POINTS), xcl_array_partition(complete, 2)));
+
+  for (int m = 0; m < count; m++) {
+    for (int block = 0; block < rows / POINTS; block++) {
+      const unsigned matrix_offset = m * rows * N;
+      const unsigned row_offset = block * POINTS;
+
+      // Read POINTS rows of the matrix
+      for (unsigned k = 0; k < N; k++) {
+        unsigned row = k / (N / POINTS);
+        unsigned col_base = (k & (N / POINTS - 1)) << LOGPOINTS;
+        __attribute__((opencl_unroll_hint(POINTS)))
+        for (int j = 0; j < POINTS; j++) {
+          unsigned col = col_base + j;
+          buf[col][(row + col) & (POINTS - 1)] = src[matrix_offset + (row_offset + row) * N + col];
+        }
+      }
+
+      // Write the columns of the buffered rows in natural order
+      for (unsigned col = 0; col < N; col++) {
+        unsigned buffer_col = bit_reversed(col, LOGN);
+        float2 write_chunk[POINTS];
+        __attribute__((opencl_unroll_hint(POINTS)))
+        for (int j = 0; j < POINTS; j++) {
+          write_chunk[j] = buf[buffer_col][(j + buffer_col) & (POINTS - 1)];
+        }
+        __attribute__((opencl_unroll_hint(POINTS)))
+        for (int j = 0; j < POINTS; j++) {
+          dest[matrix_offset + col * rows + row_offset + j] = write_chunk[j];
+        }
+      }
+    }
+  }
+}
+#endif
+
+#ifdef FFT_CONVOLUTION
+/**
+The filter kernel is the second stage of the convolution. It multiplies the output of the forward FFT engine
+pointwise with the spectrum of the filter and forwards the result to the inverse FFT engine.
+The output of the forward engine is in bit reversed order, so the filter has to be given in the same order.
+The inverse engine expects its input in the same order as it is produced by the fetch kernel.
+Chunk s of the output of the forward engine contains the values for step bit_reversed(s) of the inverse engine,
+so the chunks of a whole FFT are buffered and forwarded in bit reversed order of the chunks.
+Like in the fetch kernel, a double buffer is used, so the next FFT can be received while the current one is forwarded.
+ */
+__kernel
+__attribute__ ((max_global_work_dim(0), reqd_work_group_size(1,1,1)))
+void filter/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/(__global /*PY_CODE_GEN kernel_param_attributes[i]["in"]*/ const float2 * restrict filter, int iter) {
+
+  const int N = (1 << LOGN);
+
+  float2 coefficients[N/POINTS][POINTS] __attribute__((numbanks(POINTS), xcl_array_partition(complete, 2)));
+  float2 buf[2*N/POINTS][POINTS] __attribute__((numbanks(POINTS), xcl_array_partition(complete, 2)));
+
+  // The filter is the same for all FFTs, so it is only read once from global memory
+  for (unsigned k = 0; k < N / POINTS; k++) {
+    __attribute__((opencl_unroll_hint(POINTS)))
+    for (int j = 0; j < POINTS; j++) {
+      coefficients[k][j] = filter[(k << LOGPOINTS) + j];
+    }
+  }
+
+  // for iter iterations and one additional iteration to empty the last buffer
+  for (unsigned k = 0; k < (iter + 1) * (N / POINTS); k++) {
+    if (k < iter * (N / POINTS)) {
+      float2x8 data;
+#ifdef INTEL_FPGA
+      data.i0 = read_channel_intel(chanconv/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[0]);
+      data.i1 = read_channel_intel(chanconv/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[1]);
+      data.i2 = read_channel_intel(chanconv/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[2]);
+      data.i3 = read_channel_intel(chanconv/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[3]);
+      data.i4 = read_channel_intel(chanconv/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[4]);
+      data.i5 = read_channel_intel(chanconv/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[5]);
+      data.i6 = read_channel_intel(chanconv/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[6]);
+      data.i7 = read_channel_intel(chanconv/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[7]);
+#endif
+#ifdef XILINX_FPGA
+      read_pipe_block(chanconv/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/, &data);
+#endif
+      float2 read_chunk[POINTS] = {data.i0, data.i1, data.i2, data.i3, data.i4, data.i5, data.i6, data.i7};
+
+      // Complex multiplication with the filter coefficients
+      __attribute__((opencl_unroll_hint(POINTS)))
+      for (int j = 0; j < POINTS; j++) {
+        float2 c = coefficients[k & (N/POINTS - 1)][j];
+        float2 v = read_chunk[j];
+        buf[k & (2 * N/POINTS - 1)][j] = (float2)(v.x * c.x - v.y * c.y, v.x * c.y + v.y * c.x);
+      }
+    }
+    if (k >= (N / POINTS)) {
+      unsigned offset = (((k >> (LOGN - LOGPOINTS)) & 1) == 0) ? (N / POINTS) : 0;
+      unsigned chunk = bit_reversed(k & (N/POINTS - 1), LOGN - LOGPOINTS);
+
+      float2 write_chunk[POINTS];
+      __attribute__((opencl_unroll_hint(POINTS)))
+      for (int j = 0; j < POINTS; j++) {
+        write_chunk[j] = buf[offset + chunk][j];
+      }
+#ifdef INTEL_FPGA
+      write_channel_intel(chanfilt/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[0], write_chunk[0]);
+      write_channel_intel(chanfilt/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[1], write_chunk[1]);
+      write_channel_intel(chanfilt/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[2], write_chunk[2]);
+      write_channel_intel(chanfilt/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[3], write_chunk[3]);
+      write_channel_intel(chanfilt/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[4], write_chunk[4]);
+      write_channel_intel(chanfilt/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[5], write_chunk[5]);
+      write_channel_intel(chanfilt/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[6], write_chunk[6]);
+      write_channel_intel(chanfilt/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[7], write_chunk[7]);
+#endif
+#ifdef XILINX_FPGA
+      float2x8 buf2x8;
+      buf2x8.i0 = write_chunk[0];
+      buf2x8.i1 = write_chunk[1];
+      buf2x8.i2 = write_chunk[2];
+      buf2x8.i3 = write_chunk[3];
+      buf2x8.i4 = write_chunk[4];
+      buf2x8.i5 = write_chunk[5];
+      buf2x8.i6 = write_chunk[6];
+      buf2x8.i7 = write_chunk[7];
+      write_pipe_block(chanfilt/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/, &buf2x8);
+#endif
+    }
+  }
+}
+
+/**
+The inverse FFT engine is the last stage of the convolution. It receives the filtered spectrum from the filter kernel
+and writes the result to global memory in bit reversed order like the forward FFT engine.
+For Xilinx, the result is also directly written to global memory, since the output pipe of the store kernel is
+already written by the forward FFT engine.
+ */
+__attribute__ ((max_global_work_dim(0)))
+__attribute__((reqd_work_group_size(1,1,1)))
+kernel void ifft1d/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/(__global /*PY_CODE_GEN kernel_param_attributes[i]["out"]*/ float2 * restrict dest, int count) {
+
+  const int N = (1 << LOGN);
+
+  float2 fft_delay_elements[N + POINTS * (LOGN - 2)] __attribute__((xcl_array_partition(complete, 0)));
+
+   __attribute__((xcl_pipeline_loop(1)))
+  for (unsigned i = 0; i < count * (N / POINTS) + N / POINTS - 1; i++) {
+    float2x8 data;
+    if (i < count * (N / POINTS)) {
+#ifdef INTEL_FPGA
+      data.i0 = read_channel_intel(chanfilt/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[0]);
+      data.i1 = read_channel_intel(chanfilt/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[1]);
+      data.i2 = read_channel_intel(chanfilt/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[2]);
+      data.i3 = read_channel_intel(chanfilt/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[3]);
+      data.i4 = read_channel_intel(chanfilt/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[4]);
+      data.i5 = read_channel_intel(chanfilt/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[5]);
+      data.i6 = read_channel_intel(chanfilt/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[6]);
+      data.i7 = read_channel_intel(chanfilt/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/[7]);
+#endif
+#ifdef XILINX_FPGA
+      read_pipe_block(chanfilt/*PY_CODE_GEN i*//*PY_CODE_GEN size_suffix(l)*/, &data);
+#endif
+    } else {
+      data.i0 = data.i1 = data.i2 = data.i3 = 
+                data.i4 = data.i5 = data.i6 = data.i7 = 0;
+    }
+
+    data = fft_step(data, i % (N / POINTS), fft_delay_elements, 1, LOGN);
+
+    if (i >= N / POINTS - 1) {
+      int base = POINTS * (i - (N / POINTS - 1));
+
+      dest[base]     = data.i0;
+      dest[base + 1] = data.i1;
+      dest[base + 2] = data.i2;
+      dest[base + 3] = data.i3;
+      dest[base + 4] = data.i4;
+      dest[base + 5] = data.i5;
+      dest[base + 6] = data.i6;
+      dest[base + 7] = data.i7;
+    }
+  }
+}
+#endif
+
 //PY_CODE_GEN block_end
@@ -48,6 +48,48 @@ simple exchange of the different calculation methods.
     std::unique_ptr<fft::FFTExecutionTimings>
     calculate(hpcc_base::ExecutionSettings<fft::FFTProgramSettings> const& config, std::complex<HOST_DATA_TYPE>* data, std::complex<HOST_DATA_TYPE>* data_out, unsigned iterations, bool inverse);
 
+/**
+Execution of a multi-dimensional FFT. Every dimension is calculated by a pass over the FFT engine followed by a
+transposition on the device. If the distributed mode is used, a single 3D FFT is calculated by all ranks using a slab decomposition.
+
+@param config struct that contains all necessary information to execute the kernel on the FPGA
+@param data The input data. The input of every multi-dimensional FFT is stored in row-major order.
+            In distributed mode, every rank holds a contiguous slab of planes of the first dimension.
+@param data_out The output data in natural order and the same layout as the input.
+            In distributed mode, every rank holds a contiguous slab of the second dimension for every index of the first dimension.
+@param iterations Number of multi-dimensional FFTs. It is ignored in distributed mode.
+@param inverse Calculate the inverse FFT
+
+@return The measured execution times
+*/
+    std::unique_ptr<fft::FFTExecutionTimings>
+    calculate_multi_dimensional(hpcc_base::ExecutionSettings<fft::FFTProgramSettings> const& config, std::complex<HOST_DATA_TYPE>* data, std::complex<HOST_DATA_TYPE>* data_out, unsigned iterations, bool inverse);
+
+/**
+Execution of the convolution. The forward FFT, the multiplication with the filter and the inverse FFT are
+chained on the device with channels, so the intermediate results are neither written to global memory nor to the host.
+
+@param config struct that contains all necessary information to execute the kernel on the FPGA
+@param data The input data
+@param data_out The result of the convolution in bit-reversed order like the output of the FFT
+@param filter The spectrum of the filter in natural order. It contains a single value per point of a FFT.
+@param iterations Number of FFTs that are convolved with the filter
+
+@return The measured execution times
+*/
+    std::unique_ptr<fft::FFTExecutionTimings>
+    calculate_convolution(hpcc_base::ExecutionSettings<fft::FFTProgramSettings> const& config, std::complex<HOST_DATA_TYPE>* data, std::complex<HOST_DATA_TYPE>* data_out, const std::complex<HOST_DATA_TYPE>* filter, unsigned iterations);
+
+/**
+Calculate the FFTs on the CPU with the same data layout as the FPGA execution.
+FFTW is used, if it was found, and the reference implementation otherwise. The FFTs of the batch are calculated in parallel with OpenMP.
+The output of one-dimensional FFTs is stored in bit-reversed order like the output of the FPGA kernel. The distributed mode and the convolution are not supported.
+
+@copydoc bm_execution::calculate()
+*/
+    std::unique_ptr<fft::FFTExecutionTimings>
+    calculate_cpu(hpcc_base::ExecutionSettings<fft::FFTProgramSettings> const& config, std::complex<HOST_DATA_TYPE>* data, std::complex<HOST_DATA_TYPE>* data_out, unsigned iterations, bool inverse);
+
 }  // namespace bm_execution
 
 #endif  // SRC_HOST_EXECUTION_H_
@@ -0,0 +1,110 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* Related header files */
+#include "execution.h"
+
+/* C++ standard library headers */
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+/* External library headers */
+#ifdef _USE_FFTW_
+#include "fftw3.h"
+#endif
+
+namespace bm_execution {
+
+    /*
+    Calculate the FFTs on the CPU
+     @copydoc bm_execution::calculate_cpu()
+    */
+    std::unique_ptr<fft::FFTExecutionTimings>
+    calculate_cpu(hpcc_base::ExecutionSettings<fft::FFTProgramSettings> const&  config,
+            std::complex<HOST_DATA_TYPE>* data,
+            std::complex<HOST_DATA_TYPE>* data_out,
+            unsigned iterations,
+            bool inverse) {
+        if (config.programSettings->distributed) {
+            std::cerr << "ERROR: The distributed FFT is not supported by the CPU execution!" << std::endl;
+            return std::unique_ptr<fft::FFTExecutionTimings>(nullptr);
+        }
+        if (config.programSettings->convolution) {
+            std::cerr << "ERROR: The convolution is not supported by the CPU execution!" << std::endl;
+            return std::unique_ptr<fft::FFTExecutionTimings>(nullptr);
+        }
+        const int log_size = config.programSettings->logFFTSize;
+        const int dimensions = config.programSettings->dimensions;
+        size_t volume_size = 1;
+        for (int d = 0; d < dimensions; d++) {
+            volume_size *= (1 << log_size);
+        }
+
+#ifdef _USE_FFTW_
+        // A single plan is created for all FFTs of the batch and executed on the different arrays in parallel
+        std::vector<int> sizes(dimensions, 1 << log_size);
+        fftwf_plan plan = fftwf_plan_dft(dimensions, sizes.data(), reinterpret_cast<fftwf_complex*>(data), reinterpret_cast<fftwf_complex*>(data_out),
+                                        inverse ? FFTW_BACKWARD : FFTW_FORWARD, FFTW_ESTIMATE | FFTW_PRESERVE_INPUT | FFTW_UNALIGNED);
+#endif
+
+        std::vector<double> calculationTimings;
+        for (uint r = 0; r < config.programSettings->numRepetitions; r++) {
+            auto startCalculation = std::chrono::high_resolution_clock::now();
+            #pragma omp parallel for schedule(static)
+            for (int i = 0; i < static_cast<int>(iterations); i++) {
+#ifdef _USE_FFTW_
+                fftwf_execute_dft(plan, reinterpret_cast<fftwf_complex*>(&data[i * volume_size]), reinterpret_cast<fftwf_complex*>(&data_out[i * volume_size]));
+#else
+                std::copy(&data[i * volume_size], &data[(i + 1) * volume_size], &data_out[i * volume_size]);
+                if (dimensions > 1) {
+                    fft::fourier_transform_gold_nd(inverse, log_size, dimensions, &data_out[i * volume_size]);
+                }
+                else {
+                    fft::fourier_transform_gold(inverse, log_size, &data_out[i * volume_size]);
+                }
+#endif
+            }
+            auto endCalculation = std::chrono::high_resolution_clock::now();
+            std::chrono::duration<double> calculationTime =
+                    std::chrono::duration_cast<std::chrono::duration<double>>
+                            (endCalculation - startCalculation);
+            calculationTimings.push_back(calculationTime.count());
+        }
+#ifdef _USE_FFTW_
+        fftwf_destroy_plan(plan);
+#endif
+
+        if (dimensions == 1) {
+            // Use the same output order as the FPGA kernel. This is not included in the measured time.
+            fft::bit_reverse(data_out, iterations, log_size);
+        }
+
+        std::unique_ptr<fft::FFTExecutionTimings> result(new fft::FFTExecutionTimings{
+                calculationTimings, {}
+        });
+        return result;
+    }
+
+}  // namespace bm_execution
@@ -27,6 +27,9 @@ SOFTWARE.
 #include <memory>
 #include <vector>
 #include <chrono>
+#include <string>
+#include <iostream>
+#include <algorithm>
 
 /* External library headers */
 #ifdef INTEL_FPGA
@@ -40,6 +43,45 @@ SOFTWARE.
 
 namespace bm_execution {
 
+    /*
+    Get the memory bank of the input or output buffer of a kernel replication.
+    If no bank map is given and memory interleaving is not used, every buffer is placed in its own bank on Intel boards with DDR.
+    For boards with HBM, the selection of memory banks is done in the kernel code.
+    */
+    int
+    get_memory_bank(hpcc_base::ExecutionSettings<fft::FFTProgramSettings> const& config, int replication, int buffer) {
+        int default_bank = -1;
+#if defined(INTEL_FPGA) && !defined(USE_HBM)
+        if (!config.programSettings->useMemoryInterleaving) {
+            default_bank = 2 * replication + buffer;
+        }
+#endif
+        return config.programSettings->memoryBanks.bank(replication, buffer, 2, default_bank);
+    }
+
+    /*
+    Get the name of the kernel for the given replication and FFT size.
+    The kernels for additional FFT sizes in the bitstream have the Log2 of the size as suffix.
+    */
+    std::string
+    get_kernel_name(const std::string &base_name, int replication, uint log_size) {
+        std::string name = base_name + std::to_string(replication);
+        if (log_size != LOG_FFT_SIZE) {
+            name += "_log" + std::to_string(log_size);
+        }
+#ifdef XILINX_FPGA
+        name += ":{" + name + "_1}";
+#endif
+        return name;
+    }
+
+    std::unique_ptr<fft::FFTExecutionTimings>
+    calculate_streaming(hpcc_base::ExecutionSettings<fft::FFTProgramSettings> const&  config,
+            std::complex<HOST_DATA_TYPE>* data,
+            std::complex<HOST_DATA_TYPE>* data_out,
+            unsigned iterations,
+            bool inverse);
+
     /*
     Implementation for the single kernel.
      @copydoc bm_execution::calculate()
@@ -51,7 +93,15 @@ namespace bm_execution {
             unsigned iterations,
             bool inverse) {
         
+        if (config.programSettings->dimensions > 1) {
+            return calculate_multi_dimensional(config, data, data_out, iterations, inverse);
+        }
+        if (config.programSettings->streamingBatches > 0) {
+            return calculate_streaming(config, data, data_out, iterations, inverse);
+        }
+
         int err;
+        const int fft_size = 1 << config.programSettings->logFFTSize;
 
         std::vector<cl::Buffer> inBuffers;
         std::vector<cl::Buffer> outBuffers;
@@ -65,37 +115,15 @@ namespace bm_execution {
         unsigned iterations_per_kernel = iterations / config.programSettings->kernelReplications;
 
         for (int r=0; r < config.programSettings->kernelReplications; r++) {
-                // Array of flags for each buffer that is allocated in this benchmark
-                // The content of the flags will be changed according to the used compiler flags
-                // to support different kinds of devices
-                int memory_bank_info[2] = {0};
-#ifdef INTEL_FPGA
-#ifdef USE_HBM
-                // For Intel HBM the buffers have to be created with a special flag
-                for (int& v : memory_bank_info) {
-                         v = CL_MEM_HETEROGENEOUS_INTELFPGA;
-                }
-#else
-                // Set the memory bank bits if memory interleaving is not used
-                // Three bits are used to represent the target memory bank for the buffer on the FPGA by using the values 1-7.
-                // This does also mean, that only up to 7 memory banks can be accessed with this functionality.
-                // For boards with HBM, the selection of memory banks is done in the kernel code.
-                if (!config.programSettings->useMemoryInterleaving) {
-                        for (int k = 0; k < 2; k++) {
-                                memory_bank_info[k] = (((2 * r) + 1 + k) << 16);
-                        }
-                }
-#endif
-#endif
-                inBuffers.push_back(cl::Buffer(*config.context, CL_MEM_READ_ONLY | memory_bank_info[0], (1 << LOG_FFT_SIZE) * iterations_per_kernel * 2 * sizeof(HOST_DATA_TYPE), NULL, &err));
+                inBuffers.push_back(placement::createBuffer(*config.context, CL_MEM_READ_ONLY, fft_size * iterations_per_kernel * 2 * sizeof(HOST_DATA_TYPE), get_memory_bank(config, r, 0), &err));
                 ASSERT_CL(err)
-                outBuffers.push_back(cl::Buffer(*config.context, CL_MEM_WRITE_ONLY | memory_bank_info[1], (1 << LOG_FFT_SIZE) * iterations_per_kernel * 2 * sizeof(HOST_DATA_TYPE), NULL, &err));
+                outBuffers.push_back(placement::createBuffer(*config.context, CL_MEM_WRITE_ONLY, fft_size * iterations_per_kernel * 2 * sizeof(HOST_DATA_TYPE), get_memory_bank(config, r, 1), &err));
                 ASSERT_CL(err)
 
         #ifdef INTEL_FPGA
-                cl::Kernel fetchKernel(*config.program, (FETCH_KERNEL_NAME + std::to_string(r)).c_str(), &err);
+                cl::Kernel fetchKernel(*config.program, get_kernel_name(FETCH_KERNEL_NAME, r, config.programSettings->logFFTSize).c_str(), &err);
                 ASSERT_CL(err)
-                cl::Kernel fftKernel(*config.program, (FFT_KERNEL_NAME + std::to_string(r)).c_str(), &err);
+                cl::Kernel fftKernel(*config.program, get_kernel_name(FFT_KERNEL_NAME, r, config.programSettings->logFFTSize).c_str(), &err);
                 ASSERT_CL(err)
         #ifdef USE_SVM
                 err = clSetKernelArgSVMPointer(fetchKernel(), 0,
@@ -114,14 +142,19 @@ namespace bm_execution {
                 ASSERT_CL(err)
                 err = fftKernel.setArg(2, static_cast<cl_int>(inverse));
                 ASSERT_CL(err)
+        #ifdef FFT_CONVOLUTION
+                // Store the result of the FFT instead of forwarding it to the filter kernel
+                err = fftKernel.setArg(3, static_cast<cl_int>(0));
+                ASSERT_CL(err)
+        #endif
         #endif
 
         #ifdef XILINX_FPGA
-                cl::Kernel fetchKernel(*config.program, (std::string(FETCH_KERNEL_NAME) + std::to_string(r) + ":{" + FETCH_KERNEL_NAME + std::to_string(r) + "_1"  + "}").c_str(), &err);
+                cl::Kernel fetchKernel(*config.program, get_kernel_name(FETCH_KERNEL_NAME, r, config.programSettings->logFFTSize).c_str(), &err);
                 ASSERT_CL(err)
-                cl::Kernel fftKernel(*config.program, (std::string(FFT_KERNEL_NAME) + std::to_string(r) + ":{" + FFT_KERNEL_NAME + std::to_string(r) + "_1" + "}").c_str(), &err);
+                cl::Kernel fftKernel(*config.program, get_kernel_name(FFT_KERNEL_NAME, r, config.programSettings->logFFTSize).c_str(), &err);
                 ASSERT_CL(err)
-                cl::Kernel storeKernel(*config.program, (std::string(STORE_KERNEL_NAME) + std::to_string(r) + ":{" + STORE_KERNEL_NAME + std::to_string(r) + "_1" + "}").c_str(), &err);
+                cl::Kernel storeKernel(*config.program, get_kernel_name(STORE_KERNEL_NAME, r, config.programSettings->logFFTSize).c_str(), &err);
                 ASSERT_CL(err)
                 err = storeKernel.setArg(0, outBuffers[r]);
                 ASSERT_CL(err)
@@ -135,8 +168,13 @@ namespace bm_execution {
                 ASSERT_CL(err)
                 err = fftKernel.setArg(1, static_cast<cl_int>(inverse));
                 ASSERT_CL(err)
+        #ifdef FFT_CONVOLUTION
+                // Store the result of the FFT instead of forwarding it to the filter kernel
+                err = fftKernel.setArg(2, static_cast<cl_int>(0));
+                ASSERT_CL(err)
+        #endif
 
-                storeQueues.push_back(cl::CommandQueue(*config.context, *config.device, 0, &err));
+                storeQueues.push_back(cl::CommandQueue(*config.context, *config.device, profiling::PROFILING_QUEUE_PROPERTIES, &err));
                 ASSERT_CL(err)
 
                 storeKernels.push_back(storeKernel);
@@ -145,9 +183,9 @@ namespace bm_execution {
                 err = fetchKernel.setArg(1, iterations_per_kernel);
                 ASSERT_CL(err)
 
-                fetchQueues.push_back(cl::CommandQueue(*config.context, *config.device, 0, &err));
+                fetchQueues.push_back(cl::CommandQueue(*config.context, *config.device, profiling::PROFILING_QUEUE_PROPERTIES, &err));
                 ASSERT_CL(err)
-                fftQueues.push_back(cl::CommandQueue(*config.context, *config.device, 0, &err));
+                fftQueues.push_back(cl::CommandQueue(*config.context, *config.device, profiling::PROFILING_QUEUE_PROPERTIES, &err));
                 ASSERT_CL(err)
 
                 fetchKernels.push_back(fetchKernel);
@@ -156,30 +194,37 @@ namespace bm_execution {
 #ifdef USE_SVM
                 err = clEnqueueSVMMap(fetchQueues[r](), CL_TRUE,
                                 CL_MAP_READ,
-                                reinterpret_cast<void *>(&data[r * (1 << LOG_FFT_SIZE) * iterations_per_kernel]),
-                                (1 << LOG_FFT_SIZE) * iterations_per_kernel * 2 * sizeof(HOST_DATA_TYPE), 0,
+                                reinterpret_cast<void *>(&data[r * fft_size * iterations_per_kernel]),
+                                fft_size * iterations_per_kernel * 2 * sizeof(HOST_DATA_TYPE), 0,
                                 NULL, NULL);
                 ASSERT_CL(err)
                 err = clEnqueueSVMMap(fftQueues[r](), CL_TRUE,
                                 CL_MAP_WRITE,
-                                reinterpret_cast<void *>(&data_out[r * (1 << LOG_FFT_SIZE) * iterations_per_kernel]),
-                                (1 << LOG_FFT_SIZE) * iterations_per_kernel * 2 * sizeof(HOST_DATA_TYPE), 0,
+                                reinterpret_cast<void *>(&data_out[r * fft_size * iterations_per_kernel]),
+                                fft_size * iterations_per_kernel * 2 * sizeof(HOST_DATA_TYPE), 0,
                                 NULL, NULL);
                 ASSERT_CL(err)
 #else
-                err = fetchQueues[r].enqueueWriteBuffer(inBuffers[r],CL_TRUE,0, (1 << LOG_FFT_SIZE) * iterations_per_kernel * 2 * sizeof(HOST_DATA_TYPE), &data[r * (1 << LOG_FFT_SIZE) * iterations_per_kernel]);
+                err = fetchQueues[r].enqueueWriteBuffer(inBuffers[r],CL_TRUE,0, fft_size * iterations_per_kernel * 2 * sizeof(HOST_DATA_TYPE), &data[r * fft_size * iterations_per_kernel]);
                 ASSERT_CL(err)
 #endif
         }
 
         std::vector<double> calculationTimings;
+        profiling::EventProfiler profiler;
         for (uint r =0; r < config.programSettings->numRepetitions; r++) {
             auto startCalculation = std::chrono::high_resolution_clock::now();
             for (int r=0; r < config.programSettings->kernelReplications; r++) {
-                fetchQueues[r].enqueueNDRangeKernel(fetchKernels[r], cl::NullRange, cl::NDRange(1), cl::NDRange(1));
-                fftQueues[r].enqueueNDRangeKernel(fftKernels[r], cl::NullRange, cl::NDRange(1), cl::NDRange(1));
+                cl::Event fetch_event;
+                cl::Event fft_event;
+                fetchQueues[r].enqueueNDRangeKernel(fetchKernels[r], cl::NullRange, cl::NDRange(1), cl::NDRange(1), NULL, &fetch_event);
+                fftQueues[r].enqueueNDRangeKernel(fftKernels[r], cl::NullRange, cl::NDRange(1), cl::NDRange(1), NULL, &fft_event);
+                profiler.record("fetch", r, fetch_event);
+                profiler.record("fft", r, fft_event);
         #ifdef XILINX_FPGA
-                storeQueues[r].enqueueNDRangeKernel(storeKernels[r], cl::NullRange, cl::NDRange(1), cl::NDRange(1));
+                cl::Event store_event;
+                storeQueues[r].enqueueNDRangeKernel(storeKernels[r], cl::NullRange, cl::NDRange(1), cl::NDRange(1), NULL, &store_event);
+                profiler.record("store", r, store_event);
         #endif
             }
             for (int r=0; r < config.programSettings->kernelReplications; r++) {
@@ -194,26 +239,614 @@ namespace bm_execution {
                     std::chrono::duration_cast<std::chrono::duration<double>>
                             (endCalculation - startCalculation);
             calculationTimings.push_back(calculationTime.count());
+            profiler.collect(r);
         }
         for (int r=0; r < config.programSettings->kernelReplications; r++) {
 #ifdef USE_SVM
                 err = clEnqueueSVMUnmap(fetchQueues[r](),
-                                        reinterpret_cast<void *>(&data[r * (1 << LOG_FFT_SIZE) * iterations_per_kernel]), 0,
+                                        reinterpret_cast<void *>(&data[r * fft_size * iterations_per_kernel]), 0,
                                         NULL, NULL);
                 ASSERT_CL(err)
                 err = clEnqueueSVMUnmap(fftQueues[r](),
-                                        reinterpret_cast<void *>(&data_out[r * (1 << LOG_FFT_SIZE) * iterations_per_kernel]), 0,
+                                        reinterpret_cast<void *>(&data_out[r * fft_size * iterations_per_kernel]), 0,
                                         NULL, NULL);
                 ASSERT_CL(err)
 #else
-                err = fetchQueues[r].enqueueReadBuffer(outBuffers[r],CL_TRUE,0, (1 << LOG_FFT_SIZE) * iterations_per_kernel * 2 * sizeof(HOST_DATA_TYPE), &data_out[r * (1 << LOG_FFT_SIZE) * iterations_per_kernel]);
+                err = fetchQueues[r].enqueueReadBuffer(outBuffers[r],CL_TRUE,0, fft_size * iterations_per_kernel * 2 * sizeof(HOST_DATA_TYPE), &data_out[r * fft_size * iterations_per_kernel]);
+                ASSERT_CL(err)
+#endif
+        }
+        std::unique_ptr<fft::FFTExecutionTimings> result(new fft::FFTExecutionTimings{
+                calculationTimings,
+                profiler.timings
+        });
+        return result;
+    }
+
+    /*
+    Implementation of the streaming mode.
+    The batch of every kernel replication is split into sub-batches. Two sets of device buffers are used alternately,
+    so the transfers of a sub-batch to and from the device can overlap with the FFT calculation of the previous sub-batch.
+     @copydoc bm_execution::calculate()
+    */
+    std::unique_ptr<fft::FFTExecutionTimings>
+    calculate_streaming(hpcc_base::ExecutionSettings<fft::FFTProgramSettings> const&  config,
+            std::complex<HOST_DATA_TYPE>* data,
+            std::complex<HOST_DATA_TYPE>* data_out,
+            unsigned iterations,
+            bool inverse) {
+#ifdef USE_SVM
+        std::cerr << "ERROR: The streaming mode is not supported with SVM!" << std::endl;
+        return std::unique_ptr<fft::FFTExecutionTimings>(nullptr);
+#else
+        int err;
+        const int fft_size = 1 << config.programSettings->logFFTSize;
+
+        unsigned iterations_per_kernel = iterations / config.programSettings->kernelReplications;
+        unsigned num_batches = config.programSettings->streamingBatches;
+        if (iterations_per_kernel % num_batches != 0) {
+            std::cerr << "ERROR: The batch size of every replication (" << iterations_per_kernel
+                      << ") has to be a multiple of the number of streaming sub-batches!" << std::endl;
+            return std::unique_ptr<fft::FFTExecutionTimings>(nullptr);
+        }
+        unsigned iterations_per_batch = iterations_per_kernel / num_batches;
+        size_t batch_size_bytes = static_cast<size_t>(fft_size) * iterations_per_batch * 2 * sizeof(HOST_DATA_TYPE);
+        const uint num_slots = 2;
+
+        // Buffers and kernels for every slot and replication.
+        // The kernels of a slot are bound to the buffers of the slot.
+        std::vector<std::vector<cl::Buffer>> inBuffers(num_slots);
+        std::vector<std::vector<cl::Buffer>> outBuffers(num_slots);
+        std::vector<std::vector<cl::Kernel>> fetchKernels(num_slots);
+        std::vector<std::vector<cl::Kernel>> fftKernels(num_slots);
+        std::vector<std::vector<cl::Kernel>> storeKernels(num_slots);
+
+        // The kernels of a replication are connected with channels, so all sub-batches have to be
+        // processed in the same order by every kernel. This is guaranteed by using a single in-order queue per kernel.
+        std::vector<cl::CommandQueue> fetchQueues;
+        std::vector<cl::CommandQueue> fftQueues;
+        std::vector<cl::CommandQueue> storeQueues;
+        std::vector<cl::CommandQueue> writeQueues;
+        std::vector<cl::CommandQueue> readQueues;
+
+        for (int r=0; r < config.programSettings->kernelReplications; r++) {
+            for (uint slot = 0; slot < num_slots; slot++) {
+                inBuffers[slot].push_back(placement::createBuffer(*config.context, CL_MEM_READ_ONLY, batch_size_bytes, get_memory_bank(config, r, 0), &err));
+                ASSERT_CL(err)
+                outBuffers[slot].push_back(placement::createBuffer(*config.context, CL_MEM_WRITE_ONLY, batch_size_bytes, get_memory_bank(config, r, 1), &err));
+                ASSERT_CL(err)
+
+        #ifdef INTEL_FPGA
+                cl::Kernel fetchKernel(*config.program, get_kernel_name(FETCH_KERNEL_NAME, r, config.programSettings->logFFTSize).c_str(), &err);
+                ASSERT_CL(err)
+                cl::Kernel fftKernel(*config.program, get_kernel_name(FFT_KERNEL_NAME, r, config.programSettings->logFFTSize).c_str(), &err);
+                ASSERT_CL(err)
+                err = fetchKernel.setArg(0, inBuffers[slot][r]);
+                ASSERT_CL(err)
+                err = fftKernel.setArg(0, outBuffers[slot][r]);
+                ASSERT_CL(err)
+                err = fftKernel.setArg(1, iterations_per_batch);
+                ASSERT_CL(err)
+                err = fftKernel.setArg(2, static_cast<cl_int>(inverse));
+                ASSERT_CL(err)
+        #ifdef FFT_CONVOLUTION
+                // Store the result of the FFT instead of forwarding it to the filter kernel
+                err = fftKernel.setArg(3, static_cast<cl_int>(0));
+                ASSERT_CL(err)
+        #endif
+        #endif
+
+        #ifdef XILINX_FPGA
+                cl::Kernel fetchKernel(*config.program, get_kernel_name(FETCH_KERNEL_NAME, r, config.programSettings->logFFTSize).c_str(), &err);
+                ASSERT_CL(err)
+                cl::Kernel fftKernel(*config.program, get_kernel_name(FFT_KERNEL_NAME, r, config.programSettings->logFFTSize).c_str(), &err);
+                ASSERT_CL(err)
+                cl::Kernel storeKernel(*config.program, get_kernel_name(STORE_KERNEL_NAME, r, config.programSettings->logFFTSize).c_str(), &err);
+                ASSERT_CL(err)
+                err = storeKernel.setArg(0, outBuffers[slot][r]);
+                ASSERT_CL(err)
+                err = storeKernel.setArg(1, iterations_per_batch);
+                ASSERT_CL(err)
+                err = fetchKernel.setArg(0, inBuffers[slot][r]);
+                ASSERT_CL(err)
+                err = fftKernel.setArg(0, iterations_per_batch);
+                ASSERT_CL(err)
+                err = fftKernel.setArg(1, static_cast<cl_int>(inverse));
+                ASSERT_CL(err)
+        #ifdef FFT_CONVOLUTION
+                // Store the result of the FFT instead of forwarding it to the filter kernel
+                err = fftKernel.setArg(2, static_cast<cl_int>(0));
+                ASSERT_CL(err)
+        #endif
+                storeKernels[slot].push_back(storeKernel);
+        #endif
+                err = fetchKernel.setArg(1, iterations_per_batch);
+                ASSERT_CL(err)
+
+                fetchKernels[slot].push_back(fetchKernel);
+                fftKernels[slot].push_back(fftKernel);
+            }
+
+            fetchQueues.push_back(cl::CommandQueue(*config.context, *config.device, profiling::PROFILING_QUEUE_PROPERTIES, &err));
+            ASSERT_CL(err)
+            fftQueues.push_back(cl::CommandQueue(*config.context, *config.device, profiling::PROFILING_QUEUE_PROPERTIES, &err));
+            ASSERT_CL(err)
+#ifdef XILINX_FPGA
+            storeQueues.push_back(cl::CommandQueue(*config.context, *config.device, profiling::PROFILING_QUEUE_PROPERTIES, &err));
+            ASSERT_CL(err)
+#endif
+            writeQueues.push_back(cl::CommandQueue(*config.context, *config.device, profiling::PROFILING_QUEUE_PROPERTIES, &err));
+            ASSERT_CL(err)
+            readQueues.push_back(cl::CommandQueue(*config.context, *config.device, profiling::PROFILING_QUEUE_PROPERTIES, &err));
+            ASSERT_CL(err)
+        }
+
+        // The input buffer of a slot can be overwritten after the fetch kernel completed.
+        // The output buffer of a slot can be overwritten after it was read back.
+        std::vector<std::vector<cl::Event>> inFreeEvents(config.programSettings->kernelReplications, std::vector<cl::Event>(num_slots));
+        std::vector<std::vector<cl::Event>> outFreeEvents(config.programSettings->kernelReplications, std::vector<cl::Event>(num_slots));
+
+        std::vector<double> calculationTimings;
+        profiling::EventProfiler profiler;
+        for (uint rep = 0; rep < config.programSettings->numRepetitions; rep++) {
+            auto startCalculation = std::chrono::high_resolution_clock::now();
+            for (uint b = 0; b < num_batches; b++) {
+                uint slot = b % num_slots;
+                for (int r=0; r < config.programSettings->kernelReplications; r++) {
+                    size_t offset = static_cast<size_t>(fft_size) * (static_cast<size_t>(iterations_per_kernel) * r + static_cast<size_t>(iterations_per_batch) * b);
+                    std::vector<cl::Event> in_free;
+                    if (inFreeEvents[r][slot]() != nullptr) {
+                        in_free.push_back(inFreeEvents[r][slot]);
+                    }
+                    std::vector<cl::Event> out_free;
+                    if (outFreeEvents[r][slot]() != nullptr) {
+                        out_free.push_back(outFreeEvents[r][slot]);
+                    }
+
+                    std::vector<cl::Event> write_event(1);
+                    ASSERT_CL(writeQueues[r].enqueueWriteBuffer(inBuffers[slot][r], CL_FALSE, 0, batch_size_bytes, &data[offset], &in_free, &write_event[0]))
+                    cl::Event fetch_event;
+                    ASSERT_CL(fetchQueues[r].enqueueNDRangeKernel(fetchKernels[slot][r], cl::NullRange, cl::NDRange(1), cl::NDRange(1), &write_event, &fetch_event))
+                    inFreeEvents[r][slot] = fetch_event;
+                    std::vector<cl::Event> output_done(1);
+#ifdef XILINX_FPGA
+                    cl::Event fft_event;
+                    ASSERT_CL(fftQueues[r].enqueueNDRangeKernel(fftKernels[slot][r], cl::NullRange, cl::NDRange(1), cl::NDRange(1), NULL, &fft_event))
+                    ASSERT_CL(storeQueues[r].enqueueNDRangeKernel(storeKernels[slot][r], cl::NullRange, cl::NDRange(1), cl::NDRange(1), &out_free, &output_done[0]))
+                    profiler.record("store", r, output_done[0]);
+#else
+                    ASSERT_CL(fftQueues[r].enqueueNDRangeKernel(fftKernels[slot][r], cl::NullRange, cl::NDRange(1), cl::NDRange(1), &out_free, &output_done[0]))
+                    cl::Event fft_event = output_done[0];
+#endif
+                    cl::Event read_event;
+                    ASSERT_CL(readQueues[r].enqueueReadBuffer(outBuffers[slot][r], CL_FALSE, 0, batch_size_bytes, &data_out[offset], &output_done, &read_event))
+                    outFreeEvents[r][slot] = read_event;
+
+                    profiler.record("write", r, write_event[0]);
+                    profiler.record("fetch", r, fetch_event);
+                    profiler.record("fft", r, fft_event);
+                    profiler.record("read", r, read_event);
+                }
+            }
+            for (int r=0; r < config.programSettings->kernelReplications; r++) {
+                ASSERT_CL(readQueues[r].finish())
+            }
+            auto endCalculation = std::chrono::high_resolution_clock::now();
+            std::chrono::duration<double> calculationTime =
+                    std::chrono::duration_cast<std::chrono::duration<double>>
+                            (endCalculation - startCalculation);
+            calculationTimings.push_back(calculationTime.count());
+            profiler.collect(rep);
+        }
+        std::unique_ptr<fft::FFTExecutionTimings> result(new fft::FFTExecutionTimings{
+                calculationTimings,
+                profiler.timings
+        });
+        return result;
+#endif
+    }
+
+    /*
+    Implementation of the multi-dimensional FFT.
+    Every pass calculates the FFT over the last dimension of the data of every replication and transposes the result,
+    so the last dimension of the next pass is the next dimension of the data. The transposition writes the result back
+    to the input buffer, so the passes can be chained on the device without additional transfers.
+    In the distributed mode, the first two dimensions of the local slab are calculated on the device. Afterwards, the
+    data is exchanged between all ranks with an all-to-all. The last dimension is calculated on the device in a third pass.
+     @copydoc bm_execution::calculate_multi_dimensional()
+    */
+    std::unique_ptr<fft::FFTExecutionTimings>
+    calculate_multi_dimensional(hpcc_base::ExecutionSettings<fft::FFTProgramSettings> const&  config,
+            std::complex<HOST_DATA_TYPE>* data,
+            std::complex<HOST_DATA_TYPE>* data_out,
+            unsigned iterations,
+            bool inverse) {
+#ifndef FFT_MULTI_DIMENSIONAL
+        std::cerr << "ERROR: The bitstream does not contain the transpose kernel that is required for multi-dimensional FFTs. Build it with FFT_MULTI_DIMENSIONAL!" << std::endl;
+        return std::unique_ptr<fft::FFTExecutionTimings>(nullptr);
+#elif defined(USE_SVM)
+        std::cerr << "ERROR: Multi-dimensional FFTs are not supported with SVM!" << std::endl;
+        return std::unique_ptr<fft::FFTExecutionTimings>(nullptr);
+#else
+        int err;
+        const size_t fft_size = 1 << config.programSettings->logFFTSize;
+        const uint dimensions = config.programSettings->dimensions;
+        const bool distributed = config.programSettings->distributed;
+
+        int mpi_size = 1;
+#ifdef _USE_MPI_
+        if (distributed) {
+            MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
+        }
+#else
+        if (distributed) {
+            std::cerr << "ERROR: The distributed FFT requires a build with MPI support!" << std::endl;
+            return std::unique_ptr<fft::FFTExecutionTimings>(nullptr);
+        }
+#endif
+        if (fft_size % mpi_size != 0) {
+            std::cerr << "ERROR: The FFT size (" << fft_size << ") has to be a multiple of the number of ranks!" << std::endl;
+            return std::unique_ptr<fft::FFTExecutionTimings>(nullptr);
+        }
+
+        // Every multi-dimensional FFT is transposed as a matrix with rows_per_matrix rows of length fft_size
+        size_t rows_per_matrix = 1;
+        unsigned matrices_per_kernel = 1;
+        if (distributed) {
+            rows_per_matrix = fft_size * fft_size / mpi_size;
+        }
+        else {
+            for (uint d = 1; d < dimensions; d++) {
+                rows_per_matrix *= fft_size;
+            }
+            matrices_per_kernel = iterations / config.programSettings->kernelReplications;
+        }
+        cl_uint rows_per_kernel = static_cast<cl_uint>(rows_per_matrix * matrices_per_kernel);
+        size_t buffer_size_bytes = fft_size * rows_per_kernel * 2 * sizeof(HOST_DATA_TYPE);
+
+        std::vector<cl::Buffer> inBuffers;
+        std::vector<cl::Buffer> outBuffers;
+        std::vector<cl::Kernel> fetchKernels;
+        std::vector<cl::Kernel> fftKernels;
+        std::vector<cl::Kernel> storeKernels;
+        std::vector<cl::Kernel> transposeKernels;
+        std::vector<cl::CommandQueue> fetchQueues;
+        std::vector<cl::CommandQueue> fftQueues;
+        std::vector<cl::CommandQueue> storeQueues;
+        std::vector<cl::CommandQueue> transposeQueues;
+
+        for (int r=0; r < config.programSettings->kernelReplications; r++) {
+                // The input buffer is also written by the transpose kernel
+                inBuffers.push_back(placement::createBuffer(*config.context, CL_MEM_READ_WRITE, buffer_size_bytes, get_memory_bank(config, r, 0), &err));
+                ASSERT_CL(err)
+                outBuffers.push_back(placement::createBuffer(*config.context, CL_MEM_READ_WRITE, buffer_size_bytes, get_memory_bank(config, r, 1), &err));
+                ASSERT_CL(err)
+
+                cl::Kernel fetchKernel(*config.program, get_kernel_name(FETCH_KERNEL_NAME, r, config.programSettings->logFFTSize).c_str(), &err);
+                ASSERT_CL(err)
+                cl::Kernel fftKernel(*config.program, get_kernel_name(FFT_KERNEL_NAME, r, config.programSettings->logFFTSize).c_str(), &err);
+                ASSERT_CL(err)
+                cl::Kernel transposeKernel(*config.program, get_kernel_name(TRANSPOSE_KERNEL_NAME, r, config.programSettings->logFFTSize).c_str(), &err);
+                ASSERT_CL(err)
+                err = fetchKernel.setArg(0, inBuffers[r]);
+                ASSERT_CL(err)
+                err = fetchKernel.setArg(1, rows_per_kernel);
+                ASSERT_CL(err)
+        #ifdef INTEL_FPGA
+                err = fftKernel.setArg(0, outBuffers[r]);
+                ASSERT_CL(err)
+                err = fftKernel.setArg(1, rows_per_kernel);
+                ASSERT_CL(err)
+                err = fftKernel.setArg(2, static_cast<cl_int>(inverse));
+                ASSERT_CL(err)
+        #ifdef FFT_CONVOLUTION
+                // Store the result of the FFT instead of forwarding it to the filter kernel
+                err = fftKernel.setArg(3, static_cast<cl_int>(0));
+                ASSERT_CL(err)
+        #endif
+        #endif
+        #ifdef XILINX_FPGA
+                cl::Kernel storeKernel(*config.program, get_kernel_name(STORE_KERNEL_NAME, r, config.programSettings->logFFTSize).c_str(), &err);
+                ASSERT_CL(err)
+                err = storeKernel.setArg(0, outBuffers[r]);
+                ASSERT_CL(err)
+                err = storeKernel.setArg(1, rows_per_kernel);
+                ASSERT_CL(err)
+                err = fftKernel.setArg(0, rows_per_kernel);
+                ASSERT_CL(err)
+                err = fftKernel.setArg(1, static_cast<cl_int>(inverse));
+                ASSERT_CL(err)
+        #ifdef FFT_CONVOLUTION
+                // Store the result of the FFT instead of forwarding it to the filter kernel
+                err = fftKernel.setArg(2, static_cast<cl_int>(0));
+                ASSERT_CL(err)
+        #endif
+                storeKernels.push_back(storeKernel);
+                storeQueues.push_back(cl::CommandQueue(*config.context, *config.device, profiling::PROFILING_QUEUE_PROPERTIES, &err));
+                ASSERT_CL(err)
+        #endif
+                err = transposeKernel.setArg(0, outBuffers[r]);
+                ASSERT_CL(err)
+                err = transposeKernel.setArg(1, inBuffers[r]);
+                ASSERT_CL(err)
+                err = transposeKernel.setArg(2, static_cast<cl_int>(rows_per_matrix));
+                ASSERT_CL(err)
+                err = transposeKernel.setArg(3, static_cast<cl_int>(matrices_per_kernel));
                 ASSERT_CL(err)
+
+                fetchQueues.push_back(cl::CommandQueue(*config.context, *config.device, profiling::PROFILING_QUEUE_PROPERTIES, &err));
+                ASSERT_CL(err)
+                fftQueues.push_back(cl::CommandQueue(*config.context, *config.device, profiling::PROFILING_QUEUE_PROPERTIES, &err));
+                ASSERT_CL(err)
+                transposeQueues.push_back(cl::CommandQueue(*config.context, *config.device, profiling::PROFILING_QUEUE_PROPERTIES, &err));
+                ASSERT_CL(err)
+
+                fetchKernels.push_back(fetchKernel);
+                fftKernels.push_back(fftKernel);
+                transposeKernels.push_back(transposeKernel);
+        }
+
+        profiling::EventProfiler profiler;
+
+        // Enqueue a single pass over the FFT engine followed by the transposition for the given replication.
+        // The pass starts after the given events completed. Returns the event of the transposition.
+        auto enqueue_pass = [&](int r, cl::Event &previous) {
+            std::vector<cl::Event> wait_list;
+            if (previous() != nullptr) {
+                wait_list.push_back(previous);
+            }
+            cl::Event fetch_event;
+            ASSERT_CL(fetchQueues[r].enqueueNDRangeKernel(fetchKernels[r], cl::NullRange, cl::NDRange(1), cl::NDRange(1), &wait_list, &fetch_event))
+            std::vector<cl::Event> output_done(1);
+            ASSERT_CL(fftQueues[r].enqueueNDRangeKernel(fftKernels[r], cl::NullRange, cl::NDRange(1), cl::NDRange(1), &wait_list, &output_done[0]))
+            profiler.record("fetch", r, fetch_event);
+            profiler.record("fft", r, output_done[0]);
+#ifdef XILINX_FPGA
+            ASSERT_CL(storeQueues[r].enqueueNDRangeKernel(storeKernels[r], cl::NullRange, cl::NDRange(1), cl::NDRange(1), &wait_list, &output_done[0]))
+            profiler.record("store", r, output_done[0]);
 #endif
+            cl::Event transpose_event;
+            ASSERT_CL(transposeQueues[r].enqueueNDRangeKernel(transposeKernels[r], cl::NullRange, cl::NDRange(1), cl::NDRange(1), &output_done, &transpose_event))
+            profiler.record("transpose", r, transpose_event);
+            previous = transpose_event;
+        };
+
+        std::vector<double> calculationTimings;
+        for (uint rep = 0; rep < config.programSettings->numRepetitions; rep++) {
+            if (!distributed) {
+                // The transpositions overwrite the input buffers, so they have to be initialized for every repetition
+                for (int r=0; r < config.programSettings->kernelReplications; r++) {
+                    ASSERT_CL(fetchQueues[r].enqueueWriteBuffer(inBuffers[r], CL_TRUE, 0, buffer_size_bytes, &data[r * fft_size * rows_per_kernel]))
+                }
+                auto startCalculation = std::chrono::high_resolution_clock::now();
+                for (int r=0; r < config.programSettings->kernelReplications; r++) {
+                    cl::Event last_event;
+                    for (uint d = 0; d < dimensions; d++) {
+                        enqueue_pass(r, last_event);
+                    }
+                }
+                for (int r=0; r < config.programSettings->kernelReplications; r++) {
+                    ASSERT_CL(transposeQueues[r].finish())
+                }
+                auto endCalculation = std::chrono::high_resolution_clock::now();
+                std::chrono::duration<double> calculationTime =
+                        std::chrono::duration_cast<std::chrono::duration<double>>
+                                (endCalculation - startCalculation);
+                calculationTimings.push_back(calculationTime.count());
+            }
+#ifdef _USE_MPI_
+            else {
+                // The distributed FFT includes the transfers between host and device and the all-to-all communication,
+                // so the measured time corresponds to the execution time of the complete 3D FFT.
+                // Every rank holds fft_size / mpi_size planes of the first dimension of the data.
+                const size_t local_planes = fft_size / mpi_size;
+                const size_t block_points = local_planes * local_planes * fft_size;
+                std::vector<std::complex<HOST_DATA_TYPE>> received(fft_size * rows_per_kernel);
+
+                MPI_Barrier(MPI_COMM_WORLD);
+                auto startCalculation = std::chrono::high_resolution_clock::now();
+                cl::Event last_event;
+                ASSERT_CL(fetchQueues[0].enqueueWriteBuffer(inBuffers[0], CL_TRUE, 0, buffer_size_bytes, data))
+                // Calculate the first two dimensions. The result is stored in the order [kb][kc][a_local]
+                enqueue_pass(0, last_event);
+                enqueue_pass(0, last_event);
+                ASSERT_CL(transposeQueues[0].finish())
+                ASSERT_CL(transposeQueues[0].enqueueReadBuffer(inBuffers[0], CL_TRUE, 0, buffer_size_bytes, data_out))
+
+                // The values for every other rank are stored in a single block, because kb is the slowest changing index
+                MPI_Alltoall(data_out, block_points * 2 * sizeof(HOST_DATA_TYPE), MPI_BYTE,
+                            received.data(), block_points * 2 * sizeof(HOST_DATA_TYPE), MPI_BYTE, MPI_COMM_WORLD);
+
+                // Reorder the received blocks into [kb_local][kc][a]
+                for (size_t p = 0; p < static_cast<size_t>(mpi_size); p++) {
+                    for (size_t bc = 0; bc < local_planes * fft_size; bc++) {
+                        std::copy_n(&received[p * block_points + bc * local_planes], local_planes,
+                                    &data_out[bc * fft_size + p * local_planes]);
+                    }
+                }
+
+                // Calculate the last dimension. The result is stored in the order [ka][kb_local][kc]
+                ASSERT_CL(fetchQueues[0].enqueueWriteBuffer(inBuffers[0], CL_TRUE, 0, buffer_size_bytes, data_out))
+                enqueue_pass(0, last_event);
+                ASSERT_CL(transposeQueues[0].finish())
+                ASSERT_CL(transposeQueues[0].enqueueReadBuffer(inBuffers[0], CL_TRUE, 0, buffer_size_bytes, data_out))
+                auto endCalculation = std::chrono::high_resolution_clock::now();
+                std::chrono::duration<double> calculationTime =
+                        std::chrono::duration_cast<std::chrono::duration<double>>
+                                (endCalculation - startCalculation);
+                calculationTimings.push_back(calculationTime.count());
+            }
+#endif
+            profiler.collect(rep);
+        }
+        if (!distributed) {
+            // The result of the last transposition is stored in the input buffers
+            for (int r=0; r < config.programSettings->kernelReplications; r++) {
+                ASSERT_CL(fetchQueues[r].enqueueReadBuffer(inBuffers[r], CL_TRUE, 0, buffer_size_bytes, &data_out[r * fft_size * rows_per_kernel]))
+            }
+        }
+        std::unique_ptr<fft::FFTExecutionTimings> result(new fft::FFTExecutionTimings{
+                calculationTimings,
+                profiler.timings
+        });
+        return result;
+#endif
+    }
+
+    /*
+    Implementation of the convolution.
+    The fetch kernel, the forward FFT engine, the filter kernel and the inverse FFT engine of a replication are connected
+    with channels, so only the input, the filter and the result of the convolution are stored in global memory.
+     @copydoc bm_execution::calculate_convolution()
+    */
+    std::unique_ptr<fft::FFTExecutionTimings>
+    calculate_convolution(hpcc_base::ExecutionSettings<fft::FFTProgramSettings> const&  config,
+            std::complex<HOST_DATA_TYPE>* data,
+            std::complex<HOST_DATA_TYPE>* data_out,
+            const std::complex<HOST_DATA_TYPE>* filter,
+            unsigned iterations) {
+#ifndef FFT_CONVOLUTION
+        std::cerr << "ERROR: The bitstream does not contain the filter kernel and the inverse FFT engine that are required for the convolution. Build it with FFT_CONVOLUTION!" << std::endl;
+        return std::unique_ptr<fft::FFTExecutionTimings>(nullptr);
+#elif defined(USE_SVM)
+        std::cerr << "ERROR: The convolution is not supported with SVM!" << std::endl;
+        return std::unique_ptr<fft::FFTExecutionTimings>(nullptr);
+#else
+        int err;
+        const uint log_size = config.programSettings->logFFTSize;
+        const int fft_size = 1 << log_size;
+
+        unsigned iterations_per_kernel = iterations / config.programSettings->kernelReplications;
+        size_t buffer_size_bytes = static_cast<size_t>(fft_size) * iterations_per_kernel * 2 * sizeof(HOST_DATA_TYPE);
+
+        // The forward FFT engine returns the spectrum in bit reversed order, so the filter is reordered accordingly.
+        // The normalization of the inverse FFT is included in the filter.
+        const auto &plan = fft::getFFTPlan(log_size);
+        std::vector<std::complex<HOST_DATA_TYPE>> device_filter(fft_size);
+        for (int i = 0; i < fft_size; i++) {
+            device_filter[i] = filter[plan.bit_reverse[i]] / static_cast<HOST_DATA_TYPE>(fft_size);
+        }
+
+        std::vector<cl::Buffer> inBuffers;
+        std::vector<cl::Buffer> outBuffers;
+        std::vector<cl::Buffer> filterBuffers;
+        std::vector<cl::Kernel> fetchKernels;
+        std::vector<cl::Kernel> fftKernels;
+        std::vector<cl::Kernel> filterKernels;
+        std::vector<cl::Kernel> ifftKernels;
+        std::vector<cl::CommandQueue> fetchQueues;
+        std::vector<cl::CommandQueue> fftQueues;
+        std::vector<cl::CommandQueue> filterQueues;
+        std::vector<cl::CommandQueue> ifftQueues;
+
+        for (int r=0; r < config.programSettings->kernelReplications; r++) {
+                inBuffers.push_back(placement::createBuffer(*config.context, CL_MEM_READ_ONLY, buffer_size_bytes, get_memory_bank(config, r, 0), &err));
+                ASSERT_CL(err)
+                outBuffers.push_back(placement::createBuffer(*config.context, CL_MEM_WRITE_ONLY, buffer_size_bytes, get_memory_bank(config, r, 1), &err));
+                ASSERT_CL(err)
+                // The filter is only read once by the filter kernel, so it shares the bank with the input
+                filterBuffers.push_back(placement::createBuffer(*config.context, CL_MEM_READ_ONLY, fft_size * 2 * sizeof(HOST_DATA_TYPE), get_memory_bank(config, r, 0), &err));
+                ASSERT_CL(err)
+
+                cl::Kernel fetchKernel(*config.program, get_kernel_name(FETCH_KERNEL_NAME, r, log_size).c_str(), &err);
+                ASSERT_CL(err)
+                cl::Kernel fftKernel(*config.program, get_kernel_name(FFT_KERNEL_NAME, r, log_size).c_str(), &err);
+                ASSERT_CL(err)
+                cl::Kernel filterKernel(*config.program, get_kernel_name(FILTER_KERNEL_NAME, r, log_size).c_str(), &err);
+                ASSERT_CL(err)
+                cl::Kernel ifftKernel(*config.program, get_kernel_name(IFFT_KERNEL_NAME, r, log_size).c_str(), &err);
+                ASSERT_CL(err)
+
+                err = fetchKernel.setArg(0, inBuffers[r]);
+                ASSERT_CL(err)
+                err = fetchKernel.setArg(1, iterations_per_kernel);
+                ASSERT_CL(err)
+        #ifdef INTEL_FPGA
+                // The output buffer is not written by the forward FFT engine in the convolution
+                err = fftKernel.setArg(0, outBuffers[r]);
+                ASSERT_CL(err)
+                err = fftKernel.setArg(1, iterations_per_kernel);
+                ASSERT_CL(err)
+                err = fftKernel.setArg(2, static_cast<cl_int>(0));
+                ASSERT_CL(err)
+                err = fftKernel.setArg(3, static_cast<cl_int>(1));
+                ASSERT_CL(err)
+        #endif
+        #ifdef XILINX_FPGA
+                err = fftKernel.setArg(0, iterations_per_kernel);
+                ASSERT_CL(err)
+                err = fftKernel.setArg(1, static_cast<cl_int>(0));
+                ASSERT_CL(err)
+                err = fftKernel.setArg(2, static_cast<cl_int>(1));
+                ASSERT_CL(err)
+        #endif
+                err = filterKernel.setArg(0, filterBuffers[r]);
+                ASSERT_CL(err)
+                err = filterKernel.setArg(1, iterations_per_kernel);
+                ASSERT_CL(err)
+                err = ifftKernel.setArg(0, outBuffers[r]);
+                ASSERT_CL(err)
+                err = ifftKernel.setArg(1, iterations_per_kernel);
+                ASSERT_CL(err)
+
+                fetchQueues.push_back(cl::CommandQueue(*config.context, *config.device, profiling::PROFILING_QUEUE_PROPERTIES, &err));
+                ASSERT_CL(err)
+                fftQueues.push_back(cl::CommandQueue(*config.context, *config.device, profiling::PROFILING_QUEUE_PROPERTIES, &err));
+                ASSERT_CL(err)
+                filterQueues.push_back(cl::CommandQueue(*config.context, *config.device, profiling::PROFILING_QUEUE_PROPERTIES, &err));
+                ASSERT_CL(err)
+                ifftQueues.push_back(cl::CommandQueue(*config.context, *config.device, profiling::PROFILING_QUEUE_PROPERTIES, &err));
+                ASSERT_CL(err)
+
+                fetchKernels.push_back(fetchKernel);
+                fftKernels.push_back(fftKernel);
+                filterKernels.push_back(filterKernel);
+                ifftKernels.push_back(ifftKernel);
+
+                ASSERT_CL(fetchQueues[r].enqueueWriteBuffer(inBuffers[r], CL_TRUE, 0, buffer_size_bytes, &data[r * fft_size * iterations_per_kernel]))
+                ASSERT_CL(filterQueues[r].enqueueWriteBuffer(filterBuffers[r], CL_TRUE, 0, fft_size * 2 * sizeof(HOST_DATA_TYPE), device_filter.data()))
+        }
+
+        std::vector<double> calculationTimings;
+        profiling::EventProfiler profiler;
+        for (uint rep = 0; rep < config.programSettings->numRepetitions; rep++) {
+            auto startCalculation = std::chrono::high_resolution_clock::now();
+            for (int r=0; r < config.programSettings->kernelReplications; r++) {
+                cl::Event fetch_event;
+                cl::Event fft_event;
+                cl::Event filter_event;
+                cl::Event ifft_event;
+                ASSERT_CL(fetchQueues[r].enqueueNDRangeKernel(fetchKernels[r], cl::NullRange, cl::NDRange(1), cl::NDRange(1), NULL, &fetch_event))
+                ASSERT_CL(fftQueues[r].enqueueNDRangeKernel(fftKernels[r], cl::NullRange, cl::NDRange(1), cl::NDRange(1), NULL, &fft_event))
+                ASSERT_CL(filterQueues[r].enqueueNDRangeKernel(filterKernels[r], cl::NullRange, cl::NDRange(1), cl::NDRange(1), NULL, &filter_event))
+                ASSERT_CL(ifftQueues[r].enqueueNDRangeKernel(ifftKernels[r], cl::NullRange, cl::NDRange(1), cl::NDRange(1), NULL, &ifft_event))
+                profiler.record("fetch", r, fetch_event);
+                profiler.record("fft", r, fft_event);
+                profiler.record("filter", r, filter_event);
+                profiler.record("ifft", r, ifft_event);
+            }
+            for (int r=0; r < config.programSettings->kernelReplications; r++) {
+                ASSERT_CL(fetchQueues[r].finish())
+                ASSERT_CL(fftQueues[r].finish())
+                ASSERT_CL(filterQueues[r].finish())
+                ASSERT_CL(ifftQueues[r].finish())
+            }
+            auto endCalculation = std::chrono::high_resolution_clock::now();
+            std::chrono::duration<double> calculationTime =
+                    std::chrono::duration_cast<std::chrono::duration<double>>
+                            (endCalculation - startCalculation);
+            calculationTimings.push_back(calculationTime.count());
+            profiler.collect(rep);
+        }
+        for (int r=0; r < config.programSettings->kernelReplications; r++) {
+            ASSERT_CL(ifftQueues[r].enqueueReadBuffer(outBuffers[r], CL_TRUE, 0, buffer_size_bytes, &data_out[r * fft_size * iterations_per_kernel]))
         }
         std::unique_ptr<fft::FFTExecutionTimings> result(new fft::FFTExecutionTimings{
-                calculationTimings
+                calculationTimings,
+                profiler.timings
         });
         return result;
+#endif
     }
 
 }  // namespace bm_execution
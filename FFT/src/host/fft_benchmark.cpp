@@ -28,37 +28,94 @@ SOFTWARE.
 
 /* C++ standard library headers */
 #include <memory>
-#include <random>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <sstream>
 
 /* Project's headers */
+#include "counter_rng.hpp"
 #include "execution.h"
 #include "parameters.h"
 
 fft::FFTProgramSettings::FFTProgramSettings(cxxopts::ParseResult &results) : hpcc_base::BaseSettings(results),
-    iterations(results["b"].as<uint>()), inverse(results.count("inverse")), kernelReplications(results["r"].as<uint>()) {
-
+    iterations(results["b"].as<uint>()), inverse(results.count("inverse")), kernelReplications(results["r"].as<uint>()),
+    streamingBatches(results["streaming"].as<uint>()),
+    logFFTSizes(results["log-size"].as<std::vector<uint>>()), dimensions(results["dimensions"].as<uint>()),
+    distributed(results.count("distributed")), realInput(results.count("real")), convolution(results.count("convolution")) {
+    auto available = getAvailableLogSizes();
+    for (auto l : logFFTSizes) {
+        if (std::find(available.begin(), available.end(), l) == available.end()) {
+            throw std::runtime_error("The FFT size 2^" + std::to_string(l) + " is not available in the bitstream!");
+        }
+    }
+    logFFTSize = logFFTSizes.front();
+    if (dimensions < 1 || dimensions > 3) {
+        throw std::runtime_error("Only 1D, 2D and 3D FFTs are supported!");
+    }
+#ifndef FFT_MULTI_DIMENSIONAL
+    if (dimensions > 1) {
+        throw std::runtime_error("Multi-dimensional FFTs require a bitstream that is built with FFT_MULTI_DIMENSIONAL!");
+    }
+#endif
+    if (dimensions > 1 && streamingBatches > 0) {
+        throw std::runtime_error("The streaming mode is not supported for multi-dimensional FFTs!");
+    }
+    if (distributed && (dimensions != 3 || kernelReplications != 1)) {
+        throw std::runtime_error("The distributed FFT is only supported for 3D FFTs with a single kernel replication!");
+    }
+    if (realInput && (inverse || dimensions > 1)) {
+        throw std::runtime_error("Real input is only supported for the forward 1D FFT!");
+    }
+#ifndef FFT_CONVOLUTION
+    if (convolution) {
+        throw std::runtime_error("The convolution requires a bitstream that is built with FFT_CONVOLUTION!");
+    }
+#endif
+    if (convolution && (inverse || realInput || dimensions > 1 || streamingBatches > 0)) {
+        throw std::runtime_error("The convolution is only supported for 1D FFTs with complex input and without streaming!");
+    }
 }
 
 std::map<std::string, std::string>
 fft::FFTProgramSettings::getSettingsMap() {
         auto map = hpcc_base::BaseSettings::getSettingsMap();
-        map["FFT Size"] = std::to_string(1 << LOG_FFT_SIZE);
-        map["Batch Size"] = std::to_string(iterations);
+        map["FFT Size"] = std::to_string(1 << logFFTSize);
+        if (logFFTSizes.size() > 1) {
+            std::stringstream ss;
+            for (auto l : logFFTSizes) {
+                ss << (1 << l) << " ";
+            }
+            map["FFT Size Sweep"] = ss.str();
+        }
+        map["FFT Dimensions"] = std::to_string(dimensions) + ((distributed) ? " (distributed)" : "");
+        map["Input Data"] = (realInput) ? "Real (two signals per FFT)" : "Complex";
+        map["Batch Size"] = (distributed) ? "1" : std::to_string(iterations);
         map["Kernel Replications"] = std::to_string(kernelReplications);
+        map["Streaming Sub-Batches"] = (streamingBatches > 0) ? std::to_string(streamingBatches) : "Disabled";
+        map["Convolution"] = (convolution) ? "Enabled" : "Disabled";
         return map;
 }
 
-fft::FFTData::FFTData(cl::Context context, uint iterations) : context(context) {
+std::vector<uint>
+fft::getAvailableLogSizes() {
+    return std::vector<uint>{LOG_FFT_SIZE, FFT_ADDITIONAL_LOG_SIZES};
+}
+
+fft::FFTData::FFTData(cl::Context context, uint iterations, uint log_size) : context(context) {
 #ifdef USE_SVM
     data = reinterpret_cast<std::complex<HOST_DATA_TYPE>*>(
                         clSVMAlloc(context(), 0 ,
-                        iterations * (1 << LOG_FFT_SIZE) * sizeof(std::complex<HOST_DATA_TYPE>), 1024));
+                        iterations * (1 << log_size) * sizeof(std::complex<HOST_DATA_TYPE>), 1024));
     data_out = reinterpret_cast<std::complex<HOST_DATA_TYPE>*>(
                         clSVMAlloc(context(), 0 ,
-                        iterations * (1 << LOG_FFT_SIZE) * sizeof(std::complex<HOST_DATA_TYPE>), 1024));
+                        iterations * (1 << log_size) * sizeof(std::complex<HOST_DATA_TYPE>), 1024));
 #else
-    posix_memalign(reinterpret_cast<void**>(&data), 64, iterations * (1 << LOG_FFT_SIZE) * sizeof(std::complex<HOST_DATA_TYPE>));
-    posix_memalign(reinterpret_cast<void**>(&data_out), 64, iterations * (1 << LOG_FFT_SIZE) * sizeof(std::complex<HOST_DATA_TYPE>));
+    numa::memalign(reinterpret_cast<void**>(&data), 64, iterations * (1 << log_size) * sizeof(std::complex<HOST_DATA_TYPE>));
+    numa::memalign(reinterpret_cast<void**>(&data_out), 64, iterations * (1 << log_size) * sizeof(std::complex<HOST_DATA_TYPE>));
 #endif
 }
 
@@ -67,8 +124,8 @@ fft::FFTData::~FFTData() {
     clSVMFree(context(), reinterpret_cast<void*>(data));
     clSVMFree(context(), reinterpret_cast<void*>(data_out));
 #else
-    free(data);
-    free(data_out);
+    numa::free(data);
+    numa::free(data_out);
 #endif
 }
 
@@ -78,23 +135,101 @@ fft::FFTBenchmark::FFTBenchmark(int argc, char* argv[]) : HpccFpgaBenchmark(argc
 
 fft::FFTBenchmark::FFTBenchmark() {}
 
+bool
+fft::FFTBenchmark::executeSizeSweep() {
+    if (!executionSettings) {
+        return executeBenchmark();
+    }
+    bool success = true;
+    for (auto l : executionSettings->programSettings->logFFTSizes) {
+        executionSettings->programSettings->logFFTSize = l;
+        if (mpi_comm_rank == 0 && executionSettings->programSettings->logFFTSizes.size() > 1) {
+            std::cout << HLINE << "FFT Size: " << (1 << l) << std::endl;
+        }
+        success = executeBenchmark() && success;
+    }
+    return success;
+}
+
+size_t
+fft::FFTBenchmark::getNumberOfRows() {
+    const size_t fft_size = 1 << executionSettings->programSettings->logFFTSize;
+    if (executionSettings->programSettings->distributed) {
+        // Every rank holds a slab of the 3D data
+        return fft_size * fft_size / mpi_comm_size;
+    }
+    size_t rows = executionSettings->programSettings->iterations;
+    for (uint d = 1; d < executionSettings->programSettings->dimensions; d++) {
+        rows *= fft_size;
+    }
+    return rows;
+}
+
 void
 fft::FFTBenchmark::addAdditionalParseOptions(cxxopts::Options &options) {
     options.add_options()
             ("b", "Number of batched FFT calculations (iterations)",
              cxxopts::value<uint>()->default_value(std::to_string(DEFAULT_ITERATIONS)))
-            ("inverse", "If set, the inverse FFT is calculated instead");
+            ("log-size", "Log2 of the FFT size. A comma separated list of sizes can be given to measure all of them in one run. All sizes have to be available in the bitstream",
+             cxxopts::value<std::vector<uint>>()->default_value(std::to_string(LOG_FFT_SIZE)))
+            ("inverse", "If set, the inverse FFT is calculated instead")
+            ("streaming", "Split the batch of every replication into the given number of sub-batches and overlap the PCIe transfers with the FFT calculation. 0 disables the streaming mode",
+             cxxopts::value<uint>()->default_value("0"))
+            ("dimensions", "Number of dimensions of the FFT. Every dimension uses the same FFT size. The batch size gives the number of multi-dimensional FFTs",
+             cxxopts::value<uint>()->default_value("1"))
+            ("distributed", "Calculate a single 3D FFT distributed over all MPI ranks")
+            ("real", "Use real-valued input signals. Two signals are packed into the real and imaginary part of every complex FFT")
+            ("convolution", "Convolve every FFT of the batch with a filter. The forward FFT, the filter and the inverse FFT are chained on the device");
 }
 
 std::unique_ptr<fft::FFTExecutionTimings>
 fft::FFTBenchmark::executeKernel(FFTData &data) {
-    return bm_execution::calculate(*executionSettings, data.data, data.data_out, executionSettings->programSettings->iterations,
+    std::unique_ptr<fft::FFTExecutionTimings> timings;
+    if (executionSettings->programSettings->communicationType == hpcc_base::CommunicationType::cpu_only) {
+        timings = bm_execution::calculate_cpu(*executionSettings, data.data, data.data_out, executionSettings->programSettings->iterations,
                                          executionSettings->programSettings->inverse);
+    }
+    else if (executionSettings->programSettings->convolution) {
+        timings = bm_execution::calculate_convolution(*executionSettings, data.data, data.data_out, data.filter.data(),
+                                         executionSettings->programSettings->iterations);
+    }
+    else {
+        timings = bm_execution::calculate(*executionSettings, data.data, data.data_out, executionSettings->programSettings->iterations,
+                                         executionSettings->programSettings->inverse);
+    }
+    if (timings && executionSettings->programSettings->realInput) {
+        // Separate the spectra of the packed real signals. This is not included in the measured time.
+        fft::unpack_real_fft(data.data_out, executionSettings->programSettings->iterations, executionSettings->programSettings->logFFTSize, true);
+    }
+    return timings;
 }
 
 void
 fft::FFTBenchmark::collectAndPrintResults(const fft::FFTExecutionTimings &output) {
-    double gflop = static_cast<double>(5 * (1 << LOG_FFT_SIZE) * LOG_FFT_SIZE) * executionSettings->programSettings->iterations * 1.0e-9 * mpi_comm_size;
+    const uint log_size = executionSettings->programSettings->logFFTSize;
+    const uint dimensions = executionSettings->programSettings->dimensions;
+    const uint fft_size = 1 << log_size;
+    // Number of points and flop of a single (multi-dimensional) FFT
+    double fft_points = std::pow(static_cast<double>(fft_size), dimensions);
+    double flop_per_point = 5.0 * log_size * dimensions;
+    if (executionSettings->programSettings->convolution) {
+        // The forward and inverse FFT and a complex multiplication per point
+        flop_per_point = 2.0 * 5.0 * log_size + 6.0;
+    }
+    double gflop = flop_per_point * fft_points * 1.0e-9;
+    // Number of FFTs that are calculated by all ranks and kernel replications.
+    // The measured times are normalized to a single FFT.
+    double total_ffts = static_cast<double>(executionSettings->programSettings->iterations) * mpi_comm_size;
+    double time_divisor = static_cast<double>(executionSettings->programSettings->iterations) * executionSettings->programSettings->kernelReplications;
+    if (executionSettings->programSettings->distributed) {
+        total_ffts = 1;
+        time_divisor = 1;
+    }
+    if (executionSettings->programSettings->realInput) {
+        // Every complex FFT calculates two real FFTs with half of the flop each, so the time is given per real FFT
+        time_divisor *= 2;
+    }
+    gflop *= total_ffts;
 
     uint number_measurements = output.timings.size();
     std::vector<double> avg_measures(number_measurements);
@@ -106,54 +241,131 @@ fft::FFTBenchmark::collectAndPrintResults(const fft::FFTExecutionTimings &output
 #else
     std::copy(output.timings.begin(), output.timings.end(), avg_measures.begin());
 #endif
+    avg_measures = discardWarmup(avg_measures);
     if (mpi_comm_rank == 0) {
+        // Distinguish the results of the different FFT sizes in a sweep
+        std::string key_suffix = (executionSettings->programSettings->logFFTSizes.size() > 1) ? "_log" + std::to_string(log_size) : "";
         double minTime = *min_element(avg_measures.begin(), avg_measures.end());
         double avgTime = accumulate(avg_measures.begin(), avg_measures.end(), 0.0) / avg_measures.size();
 
+        timings.emplace("calculation" + key_suffix, avg_measures);
+        for (const auto& t : profiling::toTimingsMap(output.deviceTimings)) {
+            timings.emplace("device_" + t.first + key_suffix, discardWarmup(t.second));
+        }
+        results.emplace("t_avg" + key_suffix, hpcc_base::HpccResult(avgTime / time_divisor, "s"));
+        results.emplace("t_min" + key_suffix, hpcc_base::HpccResult(minTime / time_divisor, "s"));
+        results.emplace("gflops_avg" + key_suffix, hpcc_base::HpccResult(gflop / avgTime, "GFLOP/s"));
+        results.emplace("gflops_min" + key_suffix, hpcc_base::HpccResult(gflop / minTime, "GFLOP/s"));
+        // Every FFT reads its complex input and writes its complex output once to global memory
+        double intensity = flop_per_point / (2.0 * sizeof(std::complex<HOST_DATA_TYPE>));
+        results.emplace("arithmetic_intensity" + key_suffix, hpcc_base::HpccResult(intensity, "FLOP/Byte"));
+
         std::cout << std::setw(ENTRY_SPACE) << " " << std::setw(ENTRY_SPACE) << "avg"
                 << std::setw(ENTRY_SPACE) << "best" << std::endl;
-        std::cout << std::setw(ENTRY_SPACE) << "Time in s:" << std::setw(ENTRY_SPACE) << avgTime / (executionSettings->programSettings->iterations * executionSettings->programSettings->kernelReplications)
-                    << std::setw(ENTRY_SPACE) << minTime / (executionSettings->programSettings->iterations * executionSettings->programSettings->kernelReplications) << std::endl;
+        std::cout << std::setw(ENTRY_SPACE) << "Time in s:" << std::setw(ENTRY_SPACE) << avgTime / time_divisor
+                    << std::setw(ENTRY_SPACE) << minTime / time_divisor << std::endl;
         std::cout << std::setw(ENTRY_SPACE) << "GFLOPS:" << std::setw(ENTRY_SPACE) << gflop / avgTime
                     << std::setw(ENTRY_SPACE) << gflop / minTime << std::endl;
+        if (executionSettings->programSettings->streamingBatches > 0) {
+            // In streaming mode the measured time includes the transfers of the input and output data
+            double gbytes = static_cast<double>(2 * fft_size * sizeof(std::complex<HOST_DATA_TYPE>)) * total_ffts * 1.0e-9;
+            results.emplace("gbs_avg" + key_suffix, hpcc_base::HpccResult(gbytes / avgTime, "GB/s"));
+            results.emplace("gbs_min" + key_suffix, hpcc_base::HpccResult(gbytes / minTime, "GB/s"));
+            std::cout << std::setw(ENTRY_SPACE) << "GB/s:" << std::setw(ENTRY_SPACE) << gbytes / avgTime
+                    << std::setw(ENTRY_SPACE) << gbytes / minTime << std::endl;
+        }
+        if (executionSettings->programSettings->convolution) {
+            // All stages of the convolution are executed on the device, so every sample is processed end to end
+            double msamples = fft_points * total_ffts * 1.0e-6;
+            results.emplace("msps_avg" + key_suffix, hpcc_base::HpccResult(msamples / avgTime, "MSamples/s"));
+            results.emplace("msps_min" + key_suffix, hpcc_base::HpccResult(msamples / minTime, "MSamples/s"));
+            std::cout << std::setw(ENTRY_SPACE) << "MSamples/s:" << std::setw(ENTRY_SPACE) << msamples / avgTime
+                    << std::setw(ENTRY_SPACE) << msamples / minTime << std::endl;
+        }
+        // The statistics are given for a single FFT like the other times
+        std::vector<double> fft_times(avg_measures);
+        std::for_each(fft_times.begin(), fft_times.end(), [time_divisor](double& x) {x /= time_divisor;});
+        addStatistics("t" + key_suffix, fft_times);
     }
 }
 
 std::unique_ptr<fft::FFTData>
 fft::FFTBenchmark::generateInputData() {
-    auto d = std::unique_ptr<fft::FFTData>(new fft::FFTData(*executionSettings->context, executionSettings->programSettings->iterations));
-    std::mt19937 gen(0);
-    auto dis = std::uniform_real_distribution<HOST_DATA_TYPE>(-1.0, 1.0);
-    for (int i=0; i< executionSettings->programSettings->iterations * (1 << LOG_FFT_SIZE); i++) {
-        d->data[i].real(dis(gen));
-        d->data[i].imag(dis(gen));
+    const size_t rows = getNumberOfRows();
+    auto d = std::unique_ptr<fft::FFTData>(new fft::FFTData(*executionSettings->context, rows,
+                                                                executionSettings->programSettings->logFFTSize));
+    const size_t fft_size = 1 << executionSettings->programSettings->logFFTSize;
+    // The values only depend on the index of the element, so the data can be generated in parallel
+    const uint64_t seed = 0;
+#pragma omp parallel for
+    for (size_t i=0; i< rows * fft_size; i++) {
+        d->data[i].real(static_cast<HOST_DATA_TYPE>(rng::uniform(seed, 0, i, -1.0, 1.0)));
+        d->data[i].imag(static_cast<HOST_DATA_TYPE>(rng::uniform(seed, 1, i, -1.0, 1.0)));
         d->data_out[i].real(0.0);
         d->data_out[i].imag(0.0);
     }
+    if (executionSettings->programSettings->convolution) {
+        // The filter has a random phase and a gain of at most 1 for every frequency
+        d->filter.resize(fft_size);
+        for (size_t i = 0; i < fft_size; i++) {
+            d->filter[i] = std::polar(static_cast<HOST_DATA_TYPE>(rng::uniform(seed, 2, i, 0.0, 1.0)),
+                                        static_cast<HOST_DATA_TYPE>(rng::uniform(seed, 3, i, -M_PI, M_PI)));
+        }
+    }
     return d;
 }
 
+std::vector<memory_tracker::MemoryRequirement>
+fft::FFTBenchmark::estimateMemoryUsage() {
+    size_t data_bytes = getNumberOfRows() * (static_cast<size_t>(1) << executionSettings->programSettings->logFFTSize)
+                            * sizeof(std::complex<HOST_DATA_TYPE>);
+    std::vector<memory_tracker::MemoryRequirement> requirements = {{"data, data_out", data_bytes, 2, false}};
+    if (executionSettings->programSettings->communicationType != hpcc_base::CommunicationType::cpu_only) {
+        // The data is split between the input and output buffers of the kernel replications
+        requirements.push_back({"in, out", data_bytes, 2, true});
+        if (executionSettings->programSettings->convolution) {
+            requirements.push_back({"filter", (static_cast<size_t>(1) << executionSettings->programSettings->logFFTSize) * sizeof(std::complex<HOST_DATA_TYPE>),
+                                    executionSettings->programSettings->kernelReplications, true});
+        }
+    }
+    return requirements;
+}
+
 bool  
 fft::FFTBenchmark::validateOutputAndPrintError(fft::FFTData &data) {
+    const int log_size = executionSettings->programSettings->logFFTSize;
+    const int fft_size = 1 << log_size;
+    const int dimensions = executionSettings->programSettings->dimensions;
+    if (dimensions > 1) {
+        return validateMultiDimensional(data);
+    }
+    if (executionSettings->programSettings->realInput) {
+        return validateRealInput(data);
+    }
+    if (executionSettings->programSettings->convolution) {
+        return validateConvolution(data);
+    }
     double residual_max = 0;
+    // Every FFT of the batch is validated independently
+    #pragma omp parallel for schedule(static) reduction(max:residual_max)
     for (int i = 0; i < executionSettings->programSettings->iterations; i++) {
         // we have to bit reverse the output data of the FPGA kernel, since it will be provided in bit-reversed order.
         // Directly applying iFFT on the data would thus not form the identity function we want to have for verification.
         // TODO: This might need to be changed for other FPGA implementations that return the data in correct order
-        fft::bit_reverse(&data.data_out[i * (1 << LOG_FFT_SIZE)], 1);
-        fft::fourier_transform_gold(true, LOG_FFT_SIZE, &data.data_out[i * (1 << LOG_FFT_SIZE)]);
+        fft::bit_reverse(&data.data_out[i * fft_size], 1, log_size);
+        fft::fourier_transform_gold(true, log_size, &data.data_out[i * fft_size]);
 
         // Normalize the data after applying iFFT
-        for (int j = 0; j < (1 << LOG_FFT_SIZE); j++) {
-            data.data_out[i * (1 << LOG_FFT_SIZE) + j] /= (1 << LOG_FFT_SIZE);
+        for (int j = 0; j < fft_size; j++) {
+            data.data_out[i * fft_size + j] /= fft_size;
         }
-        for (int j = 0; j < (1 << LOG_FFT_SIZE); j++) {
-            double tmp_error =  std::abs(data.data[i * (1 << LOG_FFT_SIZE) + j] - data.data_out[i * (1 << LOG_FFT_SIZE) + j]);
+        for (int j = 0; j < fft_size; j++) {
+            double tmp_error =  std::abs(data.data[i * fft_size + j] - data.data_out[i * fft_size + j]);
             residual_max = residual_max > tmp_error ? residual_max : tmp_error;
         }
     }
     double error = residual_max /
-                   (std::numeric_limits<HOST_DATA_TYPE>::epsilon() * LOG_FFT_SIZE);
+                   (std::numeric_limits<HOST_DATA_TYPE>::epsilon() * log_size);
 
     std::cout << std::setw(ENTRY_SPACE) << "res. error" << std::setw(ENTRY_SPACE) << "mach. eps" << std::endl;
     std::cout << std::setw(ENTRY_SPACE) << error << std::setw(ENTRY_SPACE)
@@ -163,111 +375,279 @@ fft::FFTBenchmark::validateOutputAndPrintError(fft::FFTData &data) {
     return error < 1.0;
 }
 
-void 
-fft::bit_reverse(std::complex<HOST_DATA_TYPE> *data, unsigned iterations) {
-    auto *tmp = new std::complex<HOST_DATA_TYPE>[(1 << LOG_FFT_SIZE)];
-    for (int k=0; k < iterations; k++) {
-        for (int i = 0; i < (1 << LOG_FFT_SIZE); i++) {
-            int fwd = i;
-            int bit_rev = 0;
-            for (int j = 0; j < LOG_FFT_SIZE; j++) {
-                bit_rev <<= 1;
-                bit_rev |= fwd & 1;
-                fwd >>= 1;
+bool
+fft::FFTBenchmark::validateRealInput(fft::FFTData &data) {
+    const int log_size = executionSettings->programSettings->logFFTSize;
+    const int fft_size = 1 << log_size;
+    double residual_max = 0;
+    #pragma omp parallel for schedule(static) reduction(max:residual_max)
+    for (int i = 0; i < executionSettings->programSettings->iterations; i++) {
+        std::vector<std::complex<HOST_DATA_TYPE>> spectrum(fft_size);
+        for (int s = 0; s < 2; s++) {
+            // Restore the full spectrum of the real signal from its first half and apply the iFFT
+            const std::complex<HOST_DATA_TYPE>* half = &data.data_out[i * fft_size + s * fft_size / 2];
+            spectrum[0] = half[0].real();
+            spectrum[fft_size / 2] = half[0].imag();
+            for (int k = 1; k < fft_size / 2; k++) {
+                spectrum[k] = half[k];
+                spectrum[fft_size - k] = std::conj(half[k]);
+            }
+            fft::fourier_transform_gold(true, log_size, spectrum.data());
+            for (int j = 0; j < fft_size; j++) {
+                HOST_DATA_TYPE expected = (s == 0) ? data.data[i * fft_size + j].real() : data.data[i * fft_size + j].imag();
+                double tmp_error = std::abs(spectrum[j] / static_cast<HOST_DATA_TYPE>(fft_size) - std::complex<HOST_DATA_TYPE>(expected, 0.0));
+                residual_max = residual_max > tmp_error ? residual_max : tmp_error;
+            }
+        }
+    }
+    double error = residual_max /
+                   (std::numeric_limits<HOST_DATA_TYPE>::epsilon() * log_size);
+
+    std::cout << std::setw(ENTRY_SPACE) << "res. error" << std::setw(ENTRY_SPACE) << "mach. eps" << std::endl;
+    std::cout << std::setw(ENTRY_SPACE) << error << std::setw(ENTRY_SPACE)
+              << std::numeric_limits<HOST_DATA_TYPE>::epsilon() << std::endl << std::endl;
+
+    return error < 1.0;
+}
+
+bool
+fft::FFTBenchmark::validateConvolution(fft::FFTData &data) {
+    const int log_size = executionSettings->programSettings->logFFTSize;
+    const int fft_size = 1 << log_size;
+    double residual_max = 0;
+    #pragma omp parallel for schedule(static) reduction(max:residual_max)
+    for (int i = 0; i < executionSettings->programSettings->iterations; i++) {
+        std::vector<std::complex<HOST_DATA_TYPE>> expected(&data.data[i * fft_size], &data.data[(i + 1) * fft_size]);
+        fft::convolution_gold(log_size, data.filter.data(), expected.data());
+        // The inverse FFT engine returns the result in bit reversed order
+        fft::bit_reverse(&data.data_out[i * fft_size], 1, log_size);
+        for (int j = 0; j < fft_size; j++) {
+            double tmp_error = std::abs(expected[j] - data.data_out[i * fft_size + j]);
+            residual_max = residual_max > tmp_error ? residual_max : tmp_error;
+        }
+    }
+    // The error of the forward and the inverse FFT is accumulated
+    double error = residual_max /
+                   (std::numeric_limits<HOST_DATA_TYPE>::epsilon() * 2 * log_size);
+
+    std::cout << std::setw(ENTRY_SPACE) << "res. error" << std::setw(ENTRY_SPACE) << "mach. eps" << std::endl;
+    std::cout << std::setw(ENTRY_SPACE) << error << std::setw(ENTRY_SPACE)
+              << std::numeric_limits<HOST_DATA_TYPE>::epsilon() << std::endl << std::endl;
+
+    return error < 1.0;
+}
+
+bool
+fft::FFTBenchmark::validateMultiDimensional(fft::FFTData &data) {
+    const int log_size = executionSettings->programSettings->logFFTSize;
+    const int dimensions = executionSettings->programSettings->dimensions;
+    const size_t fft_size = 1 << log_size;
+    const size_t volume_size = getNumberOfRows() * fft_size / ((executionSettings->programSettings->distributed) ? 1 : executionSettings->programSettings->iterations);
+    double residual_max = 0;
+    if (!executionSettings->programSettings->distributed) {
+        // The output of the multi-dimensional FFT is already in natural order
+        for (uint i = 0; i < executionSettings->programSettings->iterations; i++) {
+            fft::fourier_transform_gold_nd(true, log_size, dimensions, &data.data_out[i * volume_size]);
+            for (size_t j = 0; j < volume_size; j++) {
+                double tmp_error =  std::abs(data.data[i * volume_size + j] - data.data_out[i * volume_size + j] / static_cast<HOST_DATA_TYPE>(volume_size));
+                residual_max = residual_max > tmp_error ? residual_max : tmp_error;
+            }
+        }
+    }
+#ifdef _USE_MPI_
+    else {
+        // Gather the input and output slabs on rank 0 and validate the complete 3D FFT there.
+        // The input is distributed over the first dimension, the output over the second dimension.
+        const size_t local_planes = fft_size / mpi_comm_size;
+        const size_t total_size = fft_size * fft_size * fft_size;
+        std::vector<std::complex<HOST_DATA_TYPE>> input;
+        std::vector<std::complex<HOST_DATA_TYPE>> output;
+        std::vector<std::complex<HOST_DATA_TYPE>> gathered;
+        if (mpi_comm_rank == 0) {
+            input.resize(total_size);
+            output.resize(total_size);
+            gathered.resize(total_size);
+        }
+        MPI_Gather(data.data, volume_size * 2 * sizeof(HOST_DATA_TYPE), MPI_BYTE, input.data(),
+                    volume_size * 2 * sizeof(HOST_DATA_TYPE), MPI_BYTE, 0, MPI_COMM_WORLD);
+        MPI_Gather(data.data_out, volume_size * 2 * sizeof(HOST_DATA_TYPE), MPI_BYTE, gathered.data(),
+                    volume_size * 2 * sizeof(HOST_DATA_TYPE), MPI_BYTE, 0, MPI_COMM_WORLD);
+        if (mpi_comm_rank == 0) {
+            for (size_t p = 0; p < static_cast<size_t>(mpi_comm_size); p++) {
+                for (size_t a = 0; a < fft_size; a++) {
+                    std::copy_n(&gathered[p * volume_size + a * local_planes * fft_size], local_planes * fft_size,
+                                &output[(a * fft_size + p * local_planes) * fft_size]);
+                }
+            }
+            fft::fourier_transform_gold_nd(true, log_size, dimensions, output.data());
+            for (size_t j = 0; j < total_size; j++) {
+                double tmp_error =  std::abs(input[j] - output[j] / static_cast<HOST_DATA_TYPE>(total_size));
+                residual_max = residual_max > tmp_error ? residual_max : tmp_error;
             }
-            tmp[i] = data[bit_rev];
         }
-        for (int i = 0; i < (1 << LOG_FFT_SIZE); i++) {
-            data[k * (1 << LOG_FFT_SIZE) + i] = tmp[i];
+        MPI_Bcast(&residual_max, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    }
+#endif
+    double error = residual_max /
+                   (std::numeric_limits<HOST_DATA_TYPE>::epsilon() * log_size * dimensions);
+
+    if (mpi_comm_rank == 0) {
+        std::cout << std::setw(ENTRY_SPACE) << "res. error" << std::setw(ENTRY_SPACE) << "mach. eps" << std::endl;
+        std::cout << std::setw(ENTRY_SPACE) << error << std::setw(ENTRY_SPACE)
+                << std::numeric_limits<HOST_DATA_TYPE>::epsilon() << std::endl << std::endl;
+    }
+
+    return error < 1.0;
+}
+
+fft::FFTPlan::FFTPlan(int lognr_points) : lognr_points(lognr_points), bit_reverse(1 << lognr_points),
+                                            twiddles((1 << lognr_points) / 2) {
+    const int nr_points = 1 << lognr_points;
+    for (int i = 0; i < nr_points; i++) {
+        unsigned fwd = i;
+        unsigned bit_rev = 0;
+        for (int j = 0; j < lognr_points; j++) {
+            bit_rev <<= 1;
+            bit_rev |= fwd & 1;
+            fwd >>= 1;
         }
+        bit_reverse[i] = bit_rev;
+    }
+    for (int i = 0; i < nr_points / 2; i++) {
+        twiddles[i] = std::complex<double>(cos(2 * M_PI * i / nr_points), -sin(2 * M_PI * i / nr_points));
     }
-    delete [] tmp;
 }
 
-// The function definitions and implementations below this comment are taken from the
-// FFT1D example implementation of the Intel FPGA SDK for OpenCL 19.4
-// They are licensed under the following conditions:
-//
-// Copyright (C) 2013-2019 Altera Corporation, San Jose, California, USA. All rights reserved.
-// Permission is hereby granted, free of charge, to any person obtaining a copy of this
-// software and associated documentation files (the "Software"), to deal in the Software
-// without restriction, including without limitation the rights to use, copy, modify, merge,
-// publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to
-// whom the Software is furnished to do so, subject to the following conditions:
-// The above copyright notice and this permission notice shall be included in all copies or
-// substantial portions of the Software.
-//
-// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
-// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
-// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
-// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
-// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
-// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
-// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
-// OTHER DEALINGS IN THE SOFTWARE.
-//
-// This agreement shall be governed in all respects by the laws of the State of California and
-// by the laws of the United States of America.
+const fft::FFTPlan&
+fft::getFFTPlan(int lognr_points) {
+    static std::map<int, std::unique_ptr<fft::FFTPlan>> plans;
+    static std::mutex plans_mutex;
+    std::lock_guard<std::mutex> lock(plans_mutex);
+    auto &plan = plans[lognr_points];
+    if (!plan) {
+        plan = std::unique_ptr<fft::FFTPlan>(new fft::FFTPlan(lognr_points));
+    }
+    return *plan;
+}
 
+void 
+fft::bit_reverse(std::complex<HOST_DATA_TYPE> *data, unsigned iterations, int lognr_points) {
+    const auto &plan = getFFTPlan(lognr_points);
+    for (int k=0; k < iterations; k++) {
+        auto *block = &data[k * (1 << lognr_points)];
+        for (int i = 0; i < (1 << lognr_points); i++) {
+            unsigned bit_rev = plan.bit_reverse[i];
+            // Swap every pair only once
+            if (i < bit_rev) {
+                std::swap(block[i], block[bit_rev]);
+            }
+        }
+    }
+}
 
 void 
 fft::fourier_transform_gold(bool inverse, const int lognr_points, std::complex<HOST_DATA_TYPE> *data_sp) {
     const int nr_points = 1 << lognr_points;
+    const auto &plan = getFFTPlan(lognr_points);
 
-    auto *data = new std::complex<double>[nr_points];
-
-    for (int i=0; i < nr_points; i++) {
-        data[i] = data_sp[i];
+    // Calculate in double precision in bit reversed order, so the butterflies produce the result in natural order
+    std::vector<std::complex<double>> data(nr_points);
+    for (int i = 0; i < nr_points; i++) {
+        data[plan.bit_reverse[i]] = data_sp[i];
     }
 
     // The inverse requires swapping the real and imaginary component
-
     if (inverse) {
         for (int i = 0; i < nr_points; i++) {
-            double tmp = data[i].imag();
-            data[i].imag(data[i].real());
-            data[i].real(tmp);
+            data[i] = std::complex<double>(data[i].imag(), data[i].real());
+        }
+    }
+
+    // Iterative radix-2 decimation in time
+    for (int len = 2; len <= nr_points; len <<= 1) {
+        const int half = len / 2;
+        const int twiddle_stride = nr_points / len;
+        for (int offset = 0; offset < nr_points; offset += len) {
+            for (int i = 0; i < half; i++) {
+                std::complex<double> t = plan.twiddles[i * twiddle_stride] * data[offset + i + half];
+                std::complex<double> u = data[offset + i];
+                data[offset + i] = u + t;
+                data[offset + i + half] = u - t;
+            }
         }
     }
-    // Do a FT recursively
-    fft::fourier_stage(lognr_points, data);
 
     // The inverse requires swapping the real and imaginary component
     if (inverse) {
         for (int i = 0; i < nr_points; i++) {
-            double tmp = data[i].real();
-            data[i].real(data[i].imag());
-            data[i].imag(tmp);
+            data[i] = std::complex<double>(data[i].imag(), data[i].real());
         }
     }
 
-    // Do the bit reversal
     for (int i = 0; i < nr_points; i++) {
-        data_sp[i] = data[i];
+        data_sp[i] = std::complex<HOST_DATA_TYPE>(data[i]);
     }
+}
 
-    delete [] data;
+void
+fft::unpack_real_fft(std::complex<HOST_DATA_TYPE> *data, unsigned iterations, int lognr_points, bool bit_reversed_input) {
+    const int nr_points = 1 << lognr_points;
+    const auto &plan = getFFTPlan(lognr_points);
+    std::vector<std::complex<HOST_DATA_TYPE>> z(nr_points);
+    for (unsigned i = 0; i < iterations; i++) {
+        auto *block = &data[i * nr_points];
+        for (int k = 0; k < nr_points; k++) {
+            z[k] = block[(bit_reversed_input) ? plan.bit_reverse[k] : k];
+        }
+        // For the packed input x + iy, the spectra are X[k] = (Z[k] + conj(Z[N-k])) / 2 and Y[k] = (Z[k] - conj(Z[N-k])) / 2i
+        for (int k = 0; k < nr_points / 2; k++) {
+            std::complex<HOST_DATA_TYPE> zk = z[k];
+            std::complex<HOST_DATA_TYPE> zn = std::conj(z[(nr_points - k) & (nr_points - 1)]);
+            block[k] = (zk + zn) * static_cast<HOST_DATA_TYPE>(0.5);
+            block[nr_points / 2 + k] = (zk - zn) * std::complex<HOST_DATA_TYPE>(0.0, -0.5);
+        }
+        // Frequency 0 and N/2 are real for both signals, so they are stored together in a single complex value
+        std::complex<HOST_DATA_TYPE> zh = z[nr_points / 2];
+        block[0].imag(zh.real());
+        block[nr_points / 2].imag(zh.imag());
+    }
 }
 
-void 
-fft::fourier_stage(int lognr_points, std::complex<double> *data) {
-    int nr_points = 1 << lognr_points;
-    if (nr_points == 1) return;
-    auto *half1 = new std::complex<double>[nr_points / 2];
-    auto *half2 = new std::complex<double>[nr_points / 2];
-    for (int i = 0; i < nr_points / 2; i++) {
-        half1[i] = data[2 * i];
-        half2[i] = data[2 * i + 1];
+void
+fft::convolution_gold(const int lognr_points, const std::complex<HOST_DATA_TYPE> *filter, std::complex<HOST_DATA_TYPE> *data) {
+    const int nr_points = 1 << lognr_points;
+    fourier_transform_gold(false, lognr_points, data);
+    for (int i = 0; i < nr_points; i++) {
+        data[i] *= filter[i];
     }
-    fourier_stage(lognr_points - 1, half1);
-    fourier_stage(lognr_points - 1, half2);
-    for (int i = 0; i < nr_points / 2; i++) {
-        data[i].real(half1[i].real() + cos (2 * M_PI * i / nr_points) * half2[i].real() + sin (2 * M_PI * i / nr_points) * half2[i].imag());
-        data[i].imag(half1[i].imag() - sin (2 * M_PI * i / nr_points) * half2[i].real() + cos (2 * M_PI * i / nr_points) * half2[i].imag());
-        data[i + nr_points / 2].real(half1[i].real() - cos (2 * M_PI * i / nr_points) * half2[i].real() - sin (2 * M_PI * i / nr_points) * half2[i].imag());
-        data[i + nr_points / 2].imag(half1[i].imag() + sin (2 * M_PI * i / nr_points) * half2[i].real() - cos (2 * M_PI * i / nr_points) * half2[i].imag());
+    fourier_transform_gold(true, lognr_points, data);
+    for (int i = 0; i < nr_points; i++) {
+        data[i] /= static_cast<HOST_DATA_TYPE>(nr_points);
     }
+}
 
-    delete [] half1;
-    delete [] half2;
+void
+fft::fourier_transform_gold_nd(bool inverse, const int lognr_points, const int dimensions, std::complex<HOST_DATA_TYPE> *data) {
+    const long nr_points = 1 << lognr_points;
+    long rows = 1;
+    for (int d = 1; d < dimensions; d++) {
+        rows *= nr_points;
+    }
+    std::vector<std::complex<HOST_DATA_TYPE>> tmp(rows * nr_points);
+    for (int d = 0; d < dimensions; d++) {
+        // Calculate the FFT over the last dimension
+        #pragma omp parallel for schedule(static)
+        for (long i = 0; i < rows; i++) {
+            fourier_transform_gold(inverse, lognr_points, &data[i * nr_points]);
+        }
+        // Rotate the dimensions, so the next dimension will be the last one.
+        // After all dimensions are calculated, the data is in the original order again.
+        #pragma omp parallel for schedule(static)
+        for (long i = 0; i < rows; i++) {
+            for (long j = 0; j < nr_points; j++) {
+                tmp[j * rows + i] = data[i * nr_points + j];
+            }
+        }
+        std::copy(tmp.begin(), tmp.end(), data);
+    }
 }
@@ -26,9 +26,11 @@ SOFTWARE.
 /* C++ standard library headers */
 #include <complex>
 #include <memory>
+#include <vector>
 
 /* Project's headers */
 #include "hpcc_benchmark.hpp"
+#include "profiling.hpp"
 #include "parameters.h"
 
 /**
@@ -61,6 +63,54 @@ public:
      */
     uint kernelReplications;
 
+    /**
+     * @brief Number of sub-batches the batch of every kernel replication is split into in streaming mode.
+     *          If 0, the streaming mode is disabled.
+     * 
+     */
+    uint streamingBatches;
+
+    /**
+     * @brief Log2 of all FFT sizes that should be measured in this run
+     * 
+     */
+    std::vector<uint> logFFTSizes;
+
+    /**
+     * @brief Log2 of the FFT size that is currently measured.
+     *          It is one of the sizes in logFFTSizes.
+     * 
+     */
+    uint logFFTSize;
+
+    /**
+     * @brief Number of dimensions of the calculated FFT. Every dimension has the same FFT size.
+     *          Multi-dimensional FFTs require a bitstream with the transpose kernel.
+     * 
+     */
+    uint dimensions;
+
+    /**
+     * @brief If true, a single 3D FFT is distributed over all MPI ranks using a slab decomposition
+     * 
+     */
+    bool distributed;
+
+    /**
+     * @brief If true, every complex FFT input contains two real-valued signals in its real and imaginary part.
+     *          The spectra of both signals are separated on the host after the execution.
+     * 
+     */
+    bool realInput;
+
+    /**
+     * @brief If true, every FFT of the batch is convolved with a filter. The forward FFT, the multiplication with the
+     *          spectrum of the filter and the inverse FFT are chained on the device.
+     *          The convolution requires a bitstream with the filter kernel and the inverse FFT engine.
+     * 
+     */
+    bool convolution;
+
     /**
      * @brief Construct a new FFT Program Settings object
      * 
@@ -77,6 +127,14 @@ public:
 
 };
 
+/**
+ * @brief Get the Log2 of all FFT sizes the bitstream contains an FFT engine for.
+ *          The first entry is always LOG_FFT_SIZE.
+ * 
+ * @return std::vector<uint> The available sizes
+ */
+std::vector<uint> getAvailableLogSizes();
+
 /**
  * @brief Data class cotnaining the data the kernel is exeucted with
  * 
@@ -97,6 +155,13 @@ public:
      */
     std::complex<HOST_DATA_TYPE>* data_out;
 
+    /**
+     * @brief The spectrum of the filter in natural order that is used for the convolution.
+     *          It is empty, if the convolution is not used.
+     * 
+     */
+    std::vector<std::complex<HOST_DATA_TYPE>> filter;
+
     /**
      * @brief The context that is used to allocate memory in SVM mode
      * 
@@ -108,8 +173,9 @@ public:
      * 
      * @param context The OpenCL context used to allocate memory in SVM mode
      * @param iterations Number of FFT data that will be stored sequentially in the array
+     * @param log_size Log2 of the size of a single FFT
      */
-    FFTData(cl::Context context, uint iterations);
+    FFTData(cl::Context context, uint iterations, uint log_size = LOG_FFT_SIZE);
 
     /**
      * @brief Destroy the FFT Data object. Free the allocated memory
@@ -131,6 +197,13 @@ public:
      */
     std::vector<double> timings;
 
+    /**
+     * @brief Device-side timings of the kernel executions of all replications
+     *          measured with OpenCL event profiling
+     * 
+     */
+    std::vector<profiling::DeviceTiming> deviceTimings;
+
 };
 
 /**
@@ -159,6 +232,14 @@ public:
     std::unique_ptr<FFTData>
     generateInputData() override;
 
+    /**
+     * @brief Estimate the memory of the input and output data and the buffers of the kernel replications
+     * 
+     * @return std::vector<memory_tracker::MemoryRequirement> The estimated allocations of this rank
+     */
+    std::vector<memory_tracker::MemoryRequirement>
+    estimateMemoryUsage() override;
+
     /**
      * @brief FFT specific implementation of the kernel execution
      * 
@@ -178,6 +259,37 @@ public:
     bool
     validateOutputAndPrintError(FFTData &data) override;
 
+    /**
+     * @brief Validate the output of multi-dimensional FFTs by applying the inverse FFT on the CPU.
+     *          In distributed mode, the data is gathered and validated on rank 0.
+     * 
+     * @param data The input and output data of the benchmark
+     * @return true If validation is successful
+     * @return false otherwise
+     */
+    bool
+    validateMultiDimensional(FFTData &data);
+
+    /**
+     * @brief Validate the separated spectra of the real input signals by applying the inverse FFT on the CPU
+     * 
+     * @param data The input and output data of the benchmark
+     * @return true If validation is successful
+     * @return false otherwise
+     */
+    bool
+    validateRealInput(FFTData &data);
+
+    /**
+     * @brief Validate the result of the convolution by calculating the convolution on the CPU
+     * 
+     * @param data The input and output data of the benchmark
+     * @return true If validation is successful
+     * @return false otherwise
+     */
+    bool
+    validateConvolution(FFTData &data);
+
     /**
      * @brief FFT specific implementation of printing the execution results
      * 
@@ -186,6 +298,25 @@ public:
     void
     collectAndPrintResults(const FFTExecutionTimings &output) override;
 
+    /**
+     * @brief Execute the benchmark once for every FFT size given in the program settings.
+     *          The device setup is reused for all sizes.
+     * 
+     * @return true If the validation succeeded for all sizes
+     * @return false otherwise
+     */
+    bool
+    executeSizeSweep();
+
+    /**
+     * @brief Get the number of 1D FFTs of the size logFFTSize that are stored in the data of this rank.
+     *          For multi-dimensional FFTs, every row of every multi-dimensional FFT is counted.
+     * 
+     * @return size_t The number of rows of the length of a single FFT in the data
+     */
+    size_t
+    getNumberOfRows();
+
     /**
      * @brief Construct a new FFT Benchmark object
      * 
@@ -201,56 +332,103 @@ public:
 
 };
 
+/**
+ * @brief Precomputed tables for the host reference FFT of a fixed size
+ * 
+ */
+struct FFTPlan {
+
+    /**
+     * @brief The log2 of the FFT size the plan was created for
+     * 
+     */
+    int lognr_points;
+
+    /**
+     * @brief Bit reversed index for every index of the FFT data
+     * 
+     */
+    std::vector<unsigned> bit_reverse;
+
+    /**
+     * @brief The twiddle factors exp(-2*pi*i*k/N) for k < N/2
+     * 
+     */
+    std::vector<std::complex<double>> twiddles;
+
+    /**
+     * @brief Construct a new FFT plan and calculate the tables
+     * 
+     * @param lognr_points The log2 of the FFT size
+     */
+    explicit FFTPlan(int lognr_points);
+};
+
+/**
+ * @brief Get the plan for the given FFT size. The plan is only created once and reused for later calls.
+ *          This function is thread safe.
+ * 
+ * @param lognr_points The log2 of the FFT size
+ * @return const FFTPlan& The cached plan
+ */
+const FFTPlan& getFFTPlan(int lognr_points);
+
 /**
  * Bit reverses the order of the given FFT data in place
  *
  * @param data Array of complex numbers that will be sorted in bit reversed order
  * @param iterations Length of the data array will be calculated with iterations * FFT Size
+ * @param lognr_points The log2 of the FFT size
  */
-void bit_reverse(std::complex<HOST_DATA_TYPE> *data, unsigned iterations);
-
-// The function definitions and implementations below this comment are taken from the
-// FFT1D example implementation of the Intel FPGA SDK for OpenCL 19.4
-// They are licensed under the following conditions:
-//
-// Copyright (C) 2013-2019 Altera Corporation, San Jose, California, USA. All rights reserved.
-// Permission is hereby granted, free of charge, to any person obtaining a copy of this
-// software and associated documentation files (the "Software"), to deal in the Software
-// without restriction, including without limitation the rights to use, copy, modify, merge,
-// publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to
-// whom the Software is furnished to do so, subject to the following conditions:
-// The above copyright notice and this permission notice shall be included in all copies or
-// substantial portions of the Software.
-//
-// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
-// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
-// OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
-// NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
-// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
-// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
-// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
-// OTHER DEALINGS IN THE SOFTWARE.
-//
-// This agreement shall be governed in all respects by the laws of the State of California and
-// by the laws of the United States of America.
+void bit_reverse(std::complex<HOST_DATA_TYPE> *data, unsigned iterations, int lognr_points = LOG_FFT_SIZE);
 
 /**
- * @brief Do a FFT with a reference implementation on the CPU
+ * @brief Do a FFT with a reference implementation on the CPU.
+ *          The FFT is calculated iteratively in double precision using the tables of getFFTPlan().
+ *          The result is given in natural order and is not normalized.
  * 
  * @param inverse if false, the FFT will be calculated, else the iFFT
  * @param lognr_points The log2 of the FFT size that should be calculated 
- * @param data The input data for the FFT
+ * @param data The input data for the FFT. It will be overwritten with the result.
  */
 void fourier_transform_gold(bool inverse, const int lognr_points, std::complex<HOST_DATA_TYPE> *data);
 
 /**
- * @brief Calculate a single stage of the whole FFT calculation.
- *          This function will mainly be used by fourier_transform_gold() to calculate the FFT.
+ * @brief Separate the spectra of two real-valued signals that were transformed together with a single complex FFT.
+ *          The first signal is given by the real part, the second signal by the imaginary part of the FFT input.
+ *          Because of the symmetry of the spectrum of a real signal, only the first N/2 frequencies of every signal
+ *          are stored. The real valued frequency N/2 is stored in the imaginary part of frequency 0.
+ *          The first N/2 values of every block will contain the spectrum of the first signal, the following values the spectrum of the second signal.
  * 
- * @param lognr_points The log2 of the FFT size that should be calculated 
- * @param data The input data for the FFT stage
+ * @param data The FFT output of multiple blocks that will be overwritten with the separated spectra in natural order
+ * @param iterations Number of FFT blocks in the data
+ * @param lognr_points The log2 of the FFT size
+ * @param bit_reversed_input If true, the FFT output is given in bit reversed order like the output of the FPGA kernel
+ */
+void unpack_real_fft(std::complex<HOST_DATA_TYPE> *data, unsigned iterations, int lognr_points, bool bit_reversed_input);
+
+/**
+ * @brief Do a cyclic convolution with the reference implementation on the CPU.
+ *          The FFT of the data is multiplied with the spectrum of the filter and transformed back with the iFFT.
+ *          The result is given in natural order and is normalized.
+ * 
+ * @param lognr_points The log2 of the FFT size
+ * @param filter The spectrum of the filter in natural order
+ * @param data The input data of the convolution. It will be overwritten with the result.
+ */
+void convolution_gold(const int lognr_points, const std::complex<HOST_DATA_TYPE> *filter, std::complex<HOST_DATA_TYPE> *data);
+
+/**
+ * @brief Do a multi-dimensional FFT with the reference implementation on the CPU.
+ *          Every dimension has the same size. The data is expected in row-major order.
+ *          The result is given in natural order and is not normalized.
+ * 
+ * @param inverse if false, the FFT will be calculated, else the iFFT
+ * @param lognr_points The log2 of the FFT size of every dimension
+ * @param dimensions The number of dimensions
+ * @param data The input data for the FFT. It will be overwritten with the result.
  */
-void fourier_stage(int lognr_points, std::complex<double> *data);
+void fourier_transform_gold_nd(bool inverse, const int lognr_points, const int dimensions, std::complex<HOST_DATA_TYPE> *data);
 
 } // namespace fft
 
@@ -13,7 +13,7 @@ int
 main(int argc, char *argv[]) {
     // Setup benchmark
     FFTBenchmark bm(argc, argv);
-    bool success = bm.executeBenchmark();
+    bool success = bm.executeSizeSweep();
     if (success) {
         return 0;
     }
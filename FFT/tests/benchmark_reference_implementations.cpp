@@ -0,0 +1,64 @@
+/*
+Microbenchmarks of the host reference implementations of FFT that are used for the validation.
+The size argument is the log2 of the FFT size. The benchmarks are executed for multiple numbers of OpenMP threads.
+*/
+#include <complex>
+#include <random>
+#include <vector>
+
+#include "reference_benchmark.hpp"
+#include "fft_benchmark.hpp"
+#include "parameters.h"
+
+// Number of FFTs that are bit reversed in a single call
+static const unsigned BIT_REVERSE_ITERATIONS = 16;
+
+/**
+Generate random input data for FFTs
+
+@param count Number of complex values
+@return The data
+*/
+static std::vector<std::complex<HOST_DATA_TYPE>>
+generateData(size_t count) {
+    std::vector<std::complex<HOST_DATA_TYPE>> data(count);
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<HOST_DATA_TYPE> dis(-1.0, 1.0);
+    for (auto &d : data) {
+        d = std::complex<HOST_DATA_TYPE>(dis(gen), dis(gen));
+    }
+    return data;
+}
+
+static void
+BM_fourier_transform_gold(benchmark::State &state) {
+    reference_benchmark::setThreads(state);
+    int log_size = static_cast<int>(state.range(0));
+    auto data = generateData(1UL << log_size);
+    // The tables of the plan are created once and cached, so they are not part of the measurement
+    fft::getFFTPlan(log_size);
+    for (auto _ : state) {
+        // FFT and iFFT are executed alternately, so the values stay in the same range
+        fft::fourier_transform_gold(false, log_size, data.data());
+        fft::fourier_transform_gold(true, log_size, data.data());
+        benchmark::DoNotOptimize(data.data());
+        benchmark::ClobberMemory();
+    }
+    state.counters["FLOP/s"] = benchmark::Counter(2.0 * 5.0 * (1UL << log_size) * log_size, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+static void
+BM_bit_reverse(benchmark::State &state) {
+    reference_benchmark::setThreads(state);
+    int log_size = static_cast<int>(state.range(0));
+    auto data = generateData(BIT_REVERSE_ITERATIONS * (1UL << log_size));
+    for (auto _ : state) {
+        fft::bit_reverse(data.data(), BIT_REVERSE_ITERATIONS, log_size);
+        benchmark::DoNotOptimize(data.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * data.size() * sizeof(std::complex<HOST_DATA_TYPE>));
+}
+
+REFERENCE_BENCHMARK(BM_fourier_transform_gold, 8, 12, 16, 20);
+REFERENCE_BENCHMARK(BM_bit_reverse, 8, 12, 16, 20);
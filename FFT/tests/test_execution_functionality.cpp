@@ -184,3 +184,114 @@ TEST_F(FFTKernelTest, FPGAiFFTAndCPUiFFTGiveSameResults) {
         EXPECT_NEAR(std::abs(data->data_out[i]), 0.0, 0.001);
     }
 }
+
+/**
+ * Check if FPGA FFT and reference FFT give the same results in streaming mode
+ */
+TEST_F(FFTKernelTest, FPGAFFTAndCPUFFTGiveSameResultsStreamingMode) {
+    bm->getExecutionSettings().programSettings->iterations = 4 * bm->getExecutionSettings().programSettings->kernelReplications;
+    bm->getExecutionSettings().programSettings->streamingBatches = 4;
+    data = bm->generateInputData();
+    auto verify_data = bm->generateInputData();
+
+    auto result = bm->executeKernel(*data);
+    ASSERT_NE(result, nullptr);
+
+    for (int b=0; b < bm->getExecutionSettings().programSettings->iterations; b++) {
+        fft::fourier_transform_gold(false,LOG_FFT_SIZE,&verify_data->data[b * (1 << LOG_FFT_SIZE)]);
+    }
+    fft::bit_reverse(verify_data->data, bm->getExecutionSettings().programSettings->iterations);
+
+    for (int i=0; i < bm->getExecutionSettings().programSettings->iterations * (1 << LOG_FFT_SIZE); i++) {
+        EXPECT_NEAR(std::abs(data->data_out[i] - verify_data->data[i]), 0.0, 0.001);
+    }
+}
+
+/**
+ * Check if FPGA FFT and reference FFT give the same results for all FFT sizes in the bitstream
+ */
+TEST_F(FFTKernelTest, FPGAFFTAndCPUFFTGiveSameResultsForAllAvailableSizes) {
+    for (auto log_size : fft::getAvailableLogSizes()) {
+        bm->getExecutionSettings().programSettings->logFFTSize = log_size;
+        data = bm->generateInputData();
+        auto verify_data = bm->generateInputData();
+
+        auto result = bm->executeKernel(*data);
+
+        fft::fourier_transform_gold(false, log_size, verify_data->data);
+        fft::bit_reverse(verify_data->data, 1, log_size);
+
+        for (int i=0; i < (1 << log_size); i++) {
+            EXPECT_NEAR(std::abs(data->data_out[i] - verify_data->data[i]), 0.0, 0.001);
+        }
+    }
+}
+
+/**
+ * Check if the CPU backend gives the same results as the reference FFT and uses the same output order as the FPGA
+ */
+TEST_F(FFTKernelTest, CPUFFTAndReferenceFFTGiveSameResults) {
+    bm->getExecutionSettings().programSettings->communicationType = hpcc_base::CommunicationType::cpu_only;
+    bm->getExecutionSettings().programSettings->iterations = 2;
+    data = bm->generateInputData();
+    auto verify_data = bm->generateInputData();
+
+    auto result = bm->executeKernel(*data);
+    ASSERT_NE(result, nullptr);
+    EXPECT_EQ(1, result->timings.size());
+
+    for (int b=0; b < 2; b++) {
+        fft::fourier_transform_gold(false,LOG_FFT_SIZE,&verify_data->data[b * (1 << LOG_FFT_SIZE)]);
+    }
+    fft::bit_reverse(verify_data->data, 2);
+
+    for (int i=0; i < 2 * (1 << LOG_FFT_SIZE); i++) {
+        EXPECT_NEAR(std::abs(data->data_out[i] - verify_data->data[i]), 0.0, 0.001);
+    }
+}
+
+#ifdef FFT_MULTI_DIMENSIONAL
+/**
+ * Check if the 2D FFT on the FPGA gives the same result as the CPU reference. The result is expected in natural order.
+ */
+TEST_F(FFTKernelTest, FPGAFFTAndCPUFFTGiveSameResults2D) {
+    bm->getExecutionSettings().programSettings->dimensions = 2;
+    bm->getExecutionSettings().programSettings->iterations = bm->getExecutionSettings().programSettings->kernelReplications;
+    data = bm->generateInputData();
+    auto verify_data = bm->generateInputData();
+
+    auto result = bm->executeKernel(*data);
+
+    const int volume_size = 1 << (2 * LOG_FFT_SIZE);
+    fft::fourier_transform_gold_nd(false, LOG_FFT_SIZE, 2, verify_data->data);
+
+    for (int i=0; i < volume_size; i++) {
+        // The magnitude of the result grows with the FFT size, so the error is scaled accordingly
+        EXPECT_NEAR(std::abs(data->data_out[i] - verify_data->data[i]) / (1 << LOG_FFT_SIZE), 0.0, 0.001);
+    }
+}
+#endif
+
+#ifdef FFT_CONVOLUTION
+/**
+ * Check if the convolution on the FPGA gives the same result as the CPU reference. The result is expected in bit reversed order.
+ */
+TEST_F(FFTKernelTest, FPGAConvolutionAndCPUConvolutionGiveSameResults) {
+    bm->getExecutionSettings().programSettings->convolution = true;
+    data = bm->generateInputData();
+    auto verify_data = bm->generateInputData();
+
+    auto result = bm->executeKernel(*data);
+    ASSERT_NE(result, nullptr);
+
+    const int fft_size = 1 << LOG_FFT_SIZE;
+    for (int b=0; b < bm->getExecutionSettings().programSettings->iterations; b++) {
+        fft::convolution_gold(LOG_FFT_SIZE, verify_data->filter.data(), &verify_data->data[b * fft_size]);
+    }
+    fft::bit_reverse(verify_data->data, bm->getExecutionSettings().programSettings->iterations);
+
+    for (int i=0; i < bm->getExecutionSettings().programSettings->iterations * fft_size; i++) {
+        EXPECT_NEAR(std::abs(data->data_out[i] - verify_data->data[i]), 0.0, 0.001);
+    }
+}
+#endif
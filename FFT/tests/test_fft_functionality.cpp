@@ -119,4 +119,100 @@ TEST_F(FFTHostTest, FFTandiFFTProduceResultCloseToSource) {
     for (int i=1; i < (1 << LOG_FFT_SIZE); i++) {
         EXPECT_NEAR(std::abs(data->data[i]), std::abs(verify_data->data[i]), 0.001);
     }
-}
\ No newline at end of file
+}
+/**
+ * Check if FFT calculates the same result as a direct calculation of the DFT
+ */
+TEST_F(FFTHostTest, FFTEqualsDirectDFT) {
+    auto verify_data = bm->generateInputData();
+    fft::fourier_transform_gold(false, LOG_FFT_SIZE, data->data);
+    const int nr_points = 1 << LOG_FFT_SIZE;
+    for (int k=0; k < nr_points; k++) {
+        std::complex<double> sum(0.0, 0.0);
+        for (int n=0; n < nr_points; n++) {
+            sum += std::complex<double>(verify_data->data[n]) * std::polar(1.0, -2.0 * M_PI * (static_cast<double>(k) * n) / nr_points);
+        }
+        EXPECT_NEAR(data->data[k].real(), sum.real(), 0.001);
+        EXPECT_NEAR(data->data[k].imag(), sum.imag(), 0.001);
+    }
+}
+
+/**
+ * Check if bit reversal is applied to every FFT of the batch and applying it twice forms the identity
+ */
+TEST_F(FFTHostTest, BitReverseTwiceIsIdentityForBatch) {
+    auto verify_data = bm->generateInputData();
+    unsigned iterations = bm->getExecutionSettings().programSettings->iterations;
+    fft::bit_reverse(data->data, iterations);
+    if (iterations > 1) {
+        EXPECT_FLOAT_EQ(data->data[(1 << LOG_FFT_SIZE) + 1].real(), verify_data->data[(1 << LOG_FFT_SIZE) + (1 << (LOG_FFT_SIZE - 1))].real());
+    }
+    fft::bit_reverse(data->data, iterations);
+    for (int i=0; i < iterations * (1 << LOG_FFT_SIZE); i++) {
+        EXPECT_FLOAT_EQ(data->data[i].real(), verify_data->data[i].real());
+        EXPECT_FLOAT_EQ(data->data[i].imag(), verify_data->data[i].imag());
+    }
+}
+
+/**
+ * Check if the multi-dimensional FFT followed by the multi-dimensional iFFT produces the source data
+ */
+TEST_F(FFTHostTest, MultiDimensionalFFTandiFFTProduceResultCloseToSource) {
+    const int log_size = 4;
+    for (int dimensions = 2; dimensions <= 3; dimensions++) {
+        const int volume_size = 1 << (log_size * dimensions);
+        std::vector<std::complex<HOST_DATA_TYPE>> values(volume_size);
+        for (int i=0; i < volume_size; i++) {
+            values[i] = std::complex<HOST_DATA_TYPE>(std::sin(static_cast<HOST_DATA_TYPE>(i)), std::cos(static_cast<HOST_DATA_TYPE>(3 * i)));
+        }
+        auto verify_values = values;
+        fft::fourier_transform_gold_nd(false, log_size, dimensions, values.data());
+        fft::fourier_transform_gold_nd(true, log_size, dimensions, values.data());
+        for (int i=0; i < volume_size; i++) {
+            EXPECT_NEAR(std::abs(values[i] / static_cast<HOST_DATA_TYPE>(volume_size) - verify_values[i]), 0.0, 0.001);
+        }
+    }
+}
+
+/**
+ * Check if the spectra of two packed real signals are separated correctly
+ */
+TEST_F(FFTHostTest, UnpackRealFFTGivesSpectraOfBothSignals) {
+    const int fft_size = 1 << LOG_FFT_SIZE;
+    auto verify_data = bm->generateInputData();
+    fft::fourier_transform_gold(false, LOG_FFT_SIZE, data->data);
+    fft::unpack_real_fft(data->data, 1, LOG_FFT_SIZE, false);
+    for (int s = 0; s < 2; s++) {
+        std::vector<std::complex<HOST_DATA_TYPE>> signal(fft_size);
+        for (int i = 0; i < fft_size; i++) {
+            signal[i] = (s == 0) ? verify_data->data[i].real() : verify_data->data[i].imag();
+        }
+        fft::fourier_transform_gold(false, LOG_FFT_SIZE, signal.data());
+        const std::complex<HOST_DATA_TYPE>* half = &data->data[s * fft_size / 2];
+        EXPECT_NEAR(half[0].real(), signal[0].real(), 0.001);
+        EXPECT_NEAR(half[0].imag(), signal[fft_size / 2].real(), 0.001);
+        for (int k = 1; k < fft_size / 2; k++) {
+            EXPECT_NEAR(std::abs(half[k] - signal[k]), 0.0, 0.001);
+        }
+    }
+}
+
+/**
+ * Check if the convolution with the spectrum of a short filter gives the same result as the cyclic convolution in the time domain
+ */
+TEST_F(FFTHostTest, ConvolutionGivesSameResultAsCyclicConvolution) {
+    const int fft_size = 1 << LOG_FFT_SIZE;
+    const std::vector<std::complex<HOST_DATA_TYPE>> taps = {{0.5, 0.0}, {0.25, -0.25}, {0.0, 0.125}};
+    std::vector<std::complex<HOST_DATA_TYPE>> filter(fft_size);
+    std::copy(taps.begin(), taps.end(), filter.begin());
+    fft::fourier_transform_gold(false, LOG_FFT_SIZE, filter.data());
+    fft::convolution_gold(LOG_FFT_SIZE, filter.data(), data->data);
+    auto verify_data = bm->generateInputData();
+    for (int i = 0; i < fft_size; i++) {
+        std::complex<HOST_DATA_TYPE> expected = 0.0;
+        for (int t = 0; t < static_cast<int>(taps.size()); t++) {
+            expected += taps[t] * verify_data->data[(i - t + fft_size) % fft_size];
+        }
+        EXPECT_NEAR(std::abs(data->data[i] - expected), 0.0, 0.001);
+    }
+}
@@ -22,6 +22,10 @@ SOFTWARE.
 
 #include "parameters.h"
 
+// Every kernel replication gets its own counter slot
+#define KERNEL_COUNTER_SLOTS /*PY_CODE_GEN num_replications*/
+#include "kernel_counters.h"
+
 #if DATA_TYPE_SIZE == 8
 #pragma OPENCL EXTENSION cl_khr_fp64 : enable
 #endif
@@ -265,7 +269,10 @@ to BRAM.
 /**
 Two level blocked GEMM kernel
 
-calculates C_OUT = alpha * A.dot(B) + beta * C
+calculates C_OUT = alpha * op(A).dot(op(B)) + beta * C
+where op(A) is a M x K matrix and op(B) is a K x N matrix.
+All matrices are stored in row-major order. A transposed matrix is still read row by row
+and the rows are stored as columns in the local memory blocks.
 
 @param a The data array representing the whole matrix a in global memory
 @param b The data array representing the whole matrix b in global memory
@@ -273,7 +280,16 @@ calculates C_OUT = alpha * A.dot(B) + beta * C
 @param c_out The data array that will used as output of the result
 @param alpha The alpha scalar value
 @param beta The beta scalar value
-@param a_size the x and y size of the matrix in blocks
+@param m_size the number of rows of op(A) and C in blocks
+@param k_size the number of columns of op(A) and rows of op(B) in blocks
+@param n_size the number of columns of op(B) and C in blocks
+@param out_offset the first block row of C that is calculated by this kernel
+@param max_block the block row of C after the last row that is calculated by this kernel
+@param transpose_a if not 0, A is stored as a K x M matrix and op(A) = A^T
+@param transpose_b if not 0, B is stored as a N x K matrix and op(B) = B^T
+@param batch_count the number of independent matrix multiplications that are calculated one after another
+@param matrix_stride the distance between two matrices of a batch in number of values. It is used for all matrices.
+@param kernel_counters Only with USE_KERNEL_COUNTERS: Buffer the device side counters are accumulated in
 */
 __attribute__((uses_global_work_offset(0)))
 __kernel
@@ -295,11 +311,29 @@ void gemm/*PY_CODE_GEN i*/(
           const DEVICE_DATA_TYPE alpha,
           const DEVICE_DATA_TYPE beta,
 #endif
-          const uint a_size,
+          const uint m_size,
+          const uint k_size,
+          const uint n_size,
           const uint out_offset,
-          const uint max_block) {
+          const uint max_block,
+          const uint transpose_a,
+          const uint transpose_b,
+          const uint batch_count,
+          const uint matrix_stride
+          KERNEL_COUNTERS_ARG) {
+
+    KERNEL_COUNTERS_START(/*PY_CODE_GEN i*/)
 
-    const unsigned size = a_size * BLOCK_SIZE;
+    // Row strides of the matrices in global memory
+    const unsigned lda = ((transpose_a) ? m_size : k_size) * BLOCK_SIZE;
+    const unsigned ldb = ((transpose_b) ? k_size : n_size) * BLOCK_SIZE;
+    const unsigned ldc = n_size * BLOCK_SIZE;
+
+#ifdef INTEL_FPGA
+#pragma disable_loop_pipelining
+#endif
+    for (unsigned batch = 0; batch < batch_count; batch++) {
+    const unsigned matrix_offset = batch * matrix_stride;
 
     // Level 1 Matrix Multiplication
 #ifdef INTEL_FPGA
@@ -314,13 +348,13 @@ void gemm/*PY_CODE_GEN i*/(
 #ifdef INTEL_FPGA
 #pragma disable_loop_pipelining
 #endif
-        for (unsigned x_block = 0; x_block < a_size; x_block++) {
+        for (unsigned x_block = 0; x_block < n_size; x_block++) {
             DEVICE_DATA_TYPE c_block[BLOCK_SIZE / GEMM_BLOCK][BLOCK_SIZE / GEMM_BLOCK]
             [GEMM_BLOCK][GEMM_BLOCK]  __attribute((numbanks(GEMM_BLOCK * GEMM_BLOCK),xcl_array_partition(complete, 3),xcl_array_partition(complete, 4)));
 #ifdef INTEL_FPGA
 #pragma disable_loop_pipelining
 #endif
-            for (unsigned diagonal_block=0; diagonal_block < a_size; diagonal_block++) {
+            for (unsigned diagonal_block=0; diagonal_block < k_size; diagonal_block++) {
                 DEVICE_DATA_TYPE a_block[BLOCK_SIZE / GEMM_BLOCK][BLOCK_SIZE / GEMM_BLOCK]
                                         [GEMM_BLOCK][GEMM_BLOCK]  __attribute((numbanks(GEMM_BLOCK * GEMM_BLOCK),xcl_array_partition(complete, 3),xcl_array_partition(complete, 4)));
                 DEVICE_DATA_TYPE b_block[BLOCK_SIZE / GEMM_BLOCK][BLOCK_SIZE / GEMM_BLOCK]
@@ -352,6 +386,13 @@ __attribute__((xcl_pipeline_loop(1)))
 #endif
                     for (unsigned j = 0; j < BLOCK_SIZE; j += GLOBAL_MEM_UNROLL) {
 
+                        // Position of the values in global memory. For transposed matrices, row i of the
+                        // stored block is read, which is column i of the block of op(A) or op(B)
+                        const unsigned a_row = (transpose_a) ? diagonal_block * BLOCK_SIZE + i : y_block * BLOCK_SIZE + i;
+                        const unsigned a_col = (transpose_a) ? y_block * BLOCK_SIZE + j : diagonal_block * BLOCK_SIZE + j;
+                        const unsigned b_row = (transpose_b) ? x_block * BLOCK_SIZE + i : diagonal_block * BLOCK_SIZE + i;
+                        const unsigned b_col = (transpose_b) ? diagonal_block * BLOCK_SIZE + j : x_block * BLOCK_SIZE + j;
+
 #ifdef ENABLE_MIXED_PRECISION
                         float a_reorder_buffer[GLOBAL_MEM_UNROLL];
                         float b_reorder_buffer[GLOBAL_MEM_UNROLL];
@@ -361,28 +402,51 @@ __attribute__((xcl_pipeline_loop(1)))
 #endif
 __attribute__((opencl_unroll_hint(GLOBAL_MEM_UNROLL)))
                         for (unsigned u = 0; u < GLOBAL_MEM_UNROLL; u++) {
-                            a_reorder_buffer[u] = a[(y_block * size + diagonal_block) * BLOCK_SIZE +
-                                j + u + i * size];
-                            b_reorder_buffer[u] = b[(diagonal_block * size + x_block) * BLOCK_SIZE +
-                                                          j + u + i * size];
+                            a_reorder_buffer[u] = a[matrix_offset + a_row * lda + a_col + u];
+                            b_reorder_buffer[u] = b[matrix_offset + b_row * ldb + b_col + u];
                         }
+                        KERNEL_COUNTERS_ACTIVE(1)
 __attribute__((opencl_unroll_hint(GLOBAL_MEM_UNROLL/GEMM_BLOCK)))
                         for (unsigned b = 0; b < GLOBAL_MEM_UNROLL/GEMM_BLOCK; b++) {
 __attribute__((opencl_unroll_hint(GEMM_BLOCK)))
                             for (unsigned u = 0; u < GEMM_BLOCK; u++) {
 #ifdef ENABLE_MIXED_PRECISION
-                                vstore_half(a_reorder_buffer[b * GEMM_BLOCK + u], u, &a_block[i / GEMM_BLOCK][j / GEMM_BLOCK + b][i & (GEMM_BLOCK - 1)][0]);
-                                vstore_half(b_reorder_buffer[b * GEMM_BLOCK + u], u , &b_block[i / GEMM_BLOCK][j / GEMM_BLOCK + b][i & (GEMM_BLOCK - 1)][0]);
+                                if (transpose_a) {
+                                    vstore_half(a_reorder_buffer[b * GEMM_BLOCK + u], i & (GEMM_BLOCK - 1), &a_block[j / GEMM_BLOCK + b][i / GEMM_BLOCK][u][0]);
+                                }
+                                else {
+                                    vstore_half(a_reorder_buffer[b * GEMM_BLOCK + u], u, &a_block[i / GEMM_BLOCK][j / GEMM_BLOCK + b][i & (GEMM_BLOCK - 1)][0]);
+                                }
+                                if (transpose_b) {
+                                    vstore_half(b_reorder_buffer[b * GEMM_BLOCK + u], i & (GEMM_BLOCK - 1), &b_block[j / GEMM_BLOCK + b][i / GEMM_BLOCK][u][0]);
+                                }
+                                else {
+                                    vstore_half(b_reorder_buffer[b * GEMM_BLOCK + u], u , &b_block[i / GEMM_BLOCK][j / GEMM_BLOCK + b][i & (GEMM_BLOCK - 1)][0]);
+                                }
 #else
-                                a_block[i / GEMM_BLOCK][j / GEMM_BLOCK + b][i & (GEMM_BLOCK - 1)][u] = a_reorder_buffer[b * GEMM_BLOCK + u];
-                                b_block[i / GEMM_BLOCK][j / GEMM_BLOCK + b][i & (GEMM_BLOCK - 1)][u] = b_reorder_buffer[b * GEMM_BLOCK + u];
+                                if (transpose_a) {
+                                    a_block[j / GEMM_BLOCK + b][i / GEMM_BLOCK][u][i & (GEMM_BLOCK - 1)] = a_reorder_buffer[b * GEMM_BLOCK + u];
+                                }
+                                else {
+                                    a_block[i / GEMM_BLOCK][j / GEMM_BLOCK + b][i & (GEMM_BLOCK - 1)][u] = a_reorder_buffer[b * GEMM_BLOCK + u];
+                                }
+                                if (transpose_b) {
+                                    b_block[j / GEMM_BLOCK + b][i / GEMM_BLOCK][u][i & (GEMM_BLOCK - 1)] = b_reorder_buffer[b * GEMM_BLOCK + u];
+                                }
+                                else {
+                                    b_block[i / GEMM_BLOCK][j / GEMM_BLOCK + b][i & (GEMM_BLOCK - 1)][u] = b_reorder_buffer[b * GEMM_BLOCK + u];
+                                }
 #endif
                             }
                         }
                     }
                 }
 
+                // The calculation only uses local memory, so all of its cycles are counted as active
+                KERNEL_COUNTERS_TIMESTAMP(/*PY_CODE_GEN i*/, gemm_start)
                 local_gemm(a_block, b_block, c_block, diagonal_block);
+                KERNEL_COUNTERS_TIMESTAMP(/*PY_CODE_GEN i*/, gemm_end)
+                KERNEL_COUNTERS_ACTIVE(gemm_end - gemm_start)
             }
 
     unsigned moved_y_block = y_block - out_offset;
@@ -410,6 +474,7 @@ __attribute__((xcl_pipeline_loop(1)))
 #endif
 #endif
                 for (unsigned j = 0; j < BLOCK_SIZE/GLOBAL_MEM_UNROLL; j++) {
+                    KERNEL_COUNTERS_ACTIVE(1)
 
 #ifdef ENABLE_MIXED_PRECISION
                     // With half precision data type this algorithm still uses single precision for the last addition
@@ -418,24 +483,22 @@ __attribute__((xcl_pipeline_loop(1)))
                     float matrix_block_part[GLOBAL_MEM_UNROLL];
                     __attribute__((opencl_unroll_hint(GLOBAL_MEM_UNROLL)))
                     for (unsigned u = 0; u < GLOBAL_MEM_UNROLL; u++) {
-                        c_reorder_buffer[u] = c[(y_block * size + x_block) * BLOCK_SIZE + j * GLOBAL_MEM_UNROLL + i * size + u];
+                        c_reorder_buffer[u] = c[matrix_offset + (y_block * BLOCK_SIZE + i) * ldc + x_block * BLOCK_SIZE + j * GLOBAL_MEM_UNROLL + u];
                         matrix_block_part[u] = vload_half(0, &c_block[i/GEMM_BLOCK][(j * GLOBAL_MEM_UNROLL + u)/GEMM_BLOCK][i & (GEMM_BLOCK - 1)][u & (GEMM_BLOCK - 1)]);
                     }
 __attribute__((opencl_unroll_hint(GLOBAL_MEM_UNROLL)))
                     for (unsigned u = 0; u < GLOBAL_MEM_UNROLL; u++) {
-                        c_out[(moved_y_block * size + x_block) * BLOCK_SIZE + j * GLOBAL_MEM_UNROLL + u
-                                + i * size] = beta * c_reorder_buffer[u] + alpha * c_block[i/GEMM_BLOCK][j * GLOBAL_MEM_UNROLL/ GEMM_BLOCK][i & (GEMM_BLOCK - 1)][u];
+                        c_out[matrix_offset + (moved_y_block * BLOCK_SIZE + i) * ldc + x_block * BLOCK_SIZE + j * GLOBAL_MEM_UNROLL + u] = beta * c_reorder_buffer[u] + alpha * c_block[i/GEMM_BLOCK][j * GLOBAL_MEM_UNROLL/ GEMM_BLOCK][i & (GEMM_BLOCK - 1)][u];
                     }
 #else
                     DEVICE_DATA_TYPE c_reorder_buffer[GLOBAL_MEM_UNROLL];
 __attribute__((opencl_unroll_hint(GLOBAL_MEM_UNROLL)))
                     for (unsigned u = 0; u < GLOBAL_MEM_UNROLL; u++) {
-                        c_reorder_buffer[u] = c[(y_block * size + x_block) * BLOCK_SIZE + j * GLOBAL_MEM_UNROLL + i * size + u];
+                        c_reorder_buffer[u] = c[matrix_offset + (y_block * BLOCK_SIZE + i) * ldc + x_block * BLOCK_SIZE + j * GLOBAL_MEM_UNROLL + u];
                     }
 __attribute__((opencl_unroll_hint(GLOBAL_MEM_UNROLL)))
                     for (unsigned u = 0; u < GLOBAL_MEM_UNROLL; u++) {
-                        c_out[(moved_y_block * size + x_block) * BLOCK_SIZE + j * GLOBAL_MEM_UNROLL + u
-                                + i * size] = beta * c_reorder_buffer[u] +
+                        c_out[matrix_offset + (moved_y_block * BLOCK_SIZE + i) * ldc + x_block * BLOCK_SIZE + j * GLOBAL_MEM_UNROLL + u] = beta * c_reorder_buffer[u] +
                                 alpha * c_block[i/GEMM_BLOCK][(j * GLOBAL_MEM_UNROLL + u)/GEMM_BLOCK][i & (GEMM_BLOCK - 1)][(j * GLOBAL_MEM_UNROLL + u) & (GEMM_BLOCK - 1)];
                     }
 #endif
@@ -443,6 +506,8 @@ __attribute__((opencl_unroll_hint(GLOBAL_MEM_UNROLL)))
             }
         }
     }
+    }
+    KERNEL_COUNTERS_END(/*PY_CODE_GEN i*/)
 }
 
 // PY_CODE_GEN block_end
@@ -48,11 +48,27 @@ simple exchange of the different calculation methods.
                 execution in number of items
 @param blockSize Size of a block that is calculated by the kernel
 
+@tparam T The data type of the matrices. It has to match the data type of the kernels in the bitstream.
+            Instantiated for half_float::half, cl_float and cl_double.
+
 @return The time measurements and the error rate counted from the executions
 */
+template<typename T>
+std::unique_ptr<gemm::GEMMExecutionTimings>
+calculate(hpcc_base::ExecutionSettings<gemm::GEMMProgramSettings> const& config, T* a, T* b, T* c,
+        T* c_out, T alpha, T beta);
+
+/**
+Calculate the matrix multiplication on the CPU with the same data and configuration as the FPGA execution.
+The multiplication uses BLAS, if it was found, and the optimized reference implementation otherwise.
+The distributed execution broadcasts the blocks of A and B in the torus rows and columns with MPI.
+
+@copydoc bm_execution::calculate()
+*/
+template<typename T>
 std::unique_ptr<gemm::GEMMExecutionTimings>
-calculate(hpcc_base::ExecutionSettings<gemm::GEMMProgramSettings> const& config, HOST_DATA_TYPE* a, HOST_DATA_TYPE* b, HOST_DATA_TYPE* c,
-        HOST_DATA_TYPE* c_out, HOST_DATA_TYPE alpha, HOST_DATA_TYPE beta);
+calculate_cpu(hpcc_base::ExecutionSettings<gemm::GEMMProgramSettings> const& config, T* a, T* b, T* c,
+        T* c_out, T alpha, T beta);
 }  // namespace bm_execution
 
 #endif  // SRC_HOST_EXECUTION_H_
@@ -0,0 +1,121 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* Related header files */
+#include "execution.h"
+
+/* C++ standard library headers */
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace bm_execution {
+
+/*
+ Calculate the matrix multiplication on the CPU
+
+ @copydoc bm_execution::calculate_cpu()
+*/
+template<typename T>
+std::unique_ptr<gemm::GEMMExecutionTimings>
+calculate_cpu(hpcc_base::ExecutionSettings<gemm::GEMMProgramSettings> const& config, T* a, T* b, T* c, T* c_out,
+        T alpha, T beta) {
+    const size_t m = config.programSettings->matrixSize;
+    const size_t k = config.programSettings->matrixSizeK;
+    const size_t n = config.programSettings->matrixSizeN;
+#ifdef _USE_MPI_
+    MPI_Comm row_communicator;
+    MPI_Comm col_communicator;
+    std::vector<T> a_received;
+    std::vector<T> b_received;
+    if (config.programSettings->distributed) {
+        // The rank within the row communicator is the torus column and vice versa
+        MPI_Comm_split(MPI_COMM_WORLD, config.programSettings->torus_row, config.programSettings->torus_col, &row_communicator);
+        MPI_Comm_split(MPI_COMM_WORLD, config.programSettings->torus_col, config.programSettings->torus_row, &col_communicator);
+        a_received.resize(m * m);
+        b_received.resize(m * m);
+    }
+#else
+    if (config.programSettings->distributed) {
+        std::cerr << "ERROR: The distributed execution requires MPI!" << std::endl;
+        return std::unique_ptr<gemm::GEMMExecutionTimings>(nullptr);
+    }
+#endif
+
+    std::vector<double> executionTimes;
+    for (int rep = 0; rep < config.programSettings->numRepetitions; rep++) {
+#ifdef _USE_MPI_
+        MPI_Barrier(MPI_COMM_WORLD);
+#endif
+        auto t1 = std::chrono::high_resolution_clock::now();
+        // The result is calculated out-of-place like on the FPGA, so C is copied to the output first
+        for (size_t batch = 0; batch < config.programSettings->batchCount; batch++) {
+            size_t offset = batch * config.programSettings->batchStride;
+            std::copy(c + offset, c + offset + m * n, c_out + offset);
+            if (!config.programSettings->distributed) {
+                gemm::gemm_ref(a + offset, b + offset, c_out + offset, m, k, n, alpha, beta,
+                                config.programSettings->transposeA, config.programSettings->transposeB);
+            }
+        }
+#ifdef _USE_MPI_
+        if (config.programSettings->distributed) {
+            // In step i, the blocks of A in torus column i are broadcast in the rows and the blocks of B in torus row i in the columns
+            const int block_bytes = m * m * sizeof(T);
+            for (int i = 0; i < config.programSettings->torus_width; i++) {
+                T* a_block = (config.programSettings->torus_col == i) ? a : a_received.data();
+                T* b_block = (config.programSettings->torus_row == i) ? b : b_received.data();
+                MPI_Bcast(a_block, block_bytes, MPI_BYTE, i, row_communicator);
+                MPI_Bcast(b_block, block_bytes, MPI_BYTE, i, col_communicator);
+                gemm::gemm_ref(a_block, b_block, c_out, m, alpha, (i == 0) ? beta : static_cast<T>(1.0));
+            }
+        }
+#endif
+        auto t2 = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> timespan = t2 - t1;
+        executionTimes.push_back(timespan.count());
+    }
+#ifdef _USE_MPI_
+    if (config.programSettings->distributed) {
+        MPI_Comm_free(&row_communicator);
+        MPI_Comm_free(&col_communicator);
+    }
+#endif
+
+    std::unique_ptr<gemm::GEMMExecutionTimings> results(
+                    new gemm::GEMMExecutionTimings{executionTimes, {}});
+    return results;
+}
+
+template std::unique_ptr<gemm::GEMMExecutionTimings>
+calculate_cpu<half_float::half>(hpcc_base::ExecutionSettings<gemm::GEMMProgramSettings> const& config, half_float::half* a, half_float::half* b, half_float::half* c, half_float::half* c_out,
+        half_float::half alpha, half_float::half beta);
+
+template std::unique_ptr<gemm::GEMMExecutionTimings>
+calculate_cpu<cl_float>(hpcc_base::ExecutionSettings<gemm::GEMMProgramSettings> const& config, cl_float* a, cl_float* b, cl_float* c, cl_float* c_out,
+        cl_float alpha, cl_float beta);
+
+template std::unique_ptr<gemm::GEMMExecutionTimings>
+calculate_cpu<cl_double>(hpcc_base::ExecutionSettings<gemm::GEMMProgramSettings> const& config, cl_double* a, cl_double* b, cl_double* c, cl_double* c_out,
+        cl_double alpha, cl_double beta);
+
+}  // namespace bm_execution
@@ -26,6 +26,7 @@ SOFTWARE.
 /* C++ standard library headers */
 #include <chrono>
 #include <fstream>
+#include <iostream>
 #include <memory>
 #include <vector>
 
@@ -34,31 +35,100 @@ SOFTWARE.
 #include "CL/cl_ext_intelfpga.h"
 #endif
 
+/* Project's headers */
+#include "kernel_counters.hpp"
+
 
 namespace bm_execution {
 
+template<typename T>
+std::unique_ptr<gemm::GEMMExecutionTimings>
+calculate_tiled(hpcc_base::ExecutionSettings<gemm::GEMMProgramSettings> const& config, T* a, T* b, T* c, T* c_out,
+        T alpha, T beta);
+
+template<typename T>
+std::unique_ptr<gemm::GEMMExecutionTimings>
+calculate_distributed(hpcc_base::ExecutionSettings<gemm::GEMMProgramSettings> const& config, T* a, T* b, T* c, T* c_out,
+        T alpha, T beta);
+
+template<typename T>
+std::unique_ptr<gemm::GEMMExecutionTimings>
+calculate_batched(hpcc_base::ExecutionSettings<gemm::GEMMProgramSettings> const& config, T* a, T* b, T* c, T* c_out,
+        T alpha, T beta);
+
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+/*
+ Create the device side counters with a slot for every kernel replication and set them as last argument of the given kernels.
+*/
+std::unique_ptr<kernel_counters::KernelCounters>
+initialize_kernel_counters(hpcc_base::ExecutionSettings<gemm::GEMMProgramSettings> const& config, std::vector<cl::Kernel> &kernels) {
+    std::vector<std::string> names;
+    for (int i = 0; i < config.programSettings->kernelReplications; i++) {
+        names.push_back(KERNEL_NAME + std::to_string(i));
+    }
+    std::unique_ptr<kernel_counters::KernelCounters> counters(new kernel_counters::KernelCounters(*config.context, names));
+    for (auto &kernel : kernels) {
+        counters->setKernelArg(kernel, 15);
+    }
+    return counters;
+}
+#endif
+
+/*
+ Get the memory bank of one of the four buffers A, B, C and out of a kernel replication.
+ If no bank map is given and memory interleaving is not used, every buffer is placed in its own bank on Intel boards with DDR.
+ For boards with HBM, the selection of memory banks is done in the kernel code.
+*/
+int
+get_memory_bank(hpcc_base::ExecutionSettings<gemm::GEMMProgramSettings> const& config, int replication, int buffer) {
+    int default_bank = -1;
+#if defined(INTEL_FPGA) && !defined(USE_HBM)
+    if (!config.programSettings->useMemoryInterleaving) {
+        default_bank = buffer;
+    }
+#endif
+    return config.programSettings->memoryBanks.bank(replication, buffer, 4, default_bank);
+}
+
 /*
  Prepare kernels and execute benchmark
 
  @copydoc bm_execution::calculate()
 */
+template<typename T>
 std::unique_ptr<gemm::GEMMExecutionTimings>
-calculate(hpcc_base::ExecutionSettings<gemm::GEMMProgramSettings> const& config, HOST_DATA_TYPE* a, HOST_DATA_TYPE* b, HOST_DATA_TYPE* c, HOST_DATA_TYPE* c_out,
-        HOST_DATA_TYPE alpha, HOST_DATA_TYPE beta) {
+calculate(hpcc_base::ExecutionSettings<gemm::GEMMProgramSettings> const& config, T* a, T* b, T* c, T* c_out,
+        T alpha, T beta) {
+
+    if (config.programSettings->tileSizeInBlocks > 0) {
+        return calculate_tiled(config, a, b, c, c_out, alpha, beta);
+    }
+    if (config.programSettings->distributed) {
+        return calculate_distributed(config, a, b, c, c_out, alpha, beta);
+    }
+    if (config.programSettings->batchCount > 1) {
+        return calculate_batched(config, a, b, c, c_out, alpha, beta);
+    }
 
     int err;
 
     // Create Command queue
     std::vector<cl::CommandQueue> compute_queues;
     for (int i=0; i < config.programSettings->kernelReplications; i++) {
-        compute_queues.push_back(cl::CommandQueue(*config.context, *config.device, 0, &err));
+        compute_queues.push_back(cl::CommandQueue(*config.context, *config.device, profiling::PROFILING_QUEUE_PROPERTIES, &err));
         ASSERT_CL(err)
     }
 
+    // The block rows of C are distributed over the kernel replications
     cl_int size_in_blocks = config.programSettings->matrixSize / config.programSettings->blockSize;
+    cl_uint k_blocks = config.programSettings->matrixSizeK / config.programSettings->blockSize;
+    cl_uint n_blocks = config.programSettings->matrixSizeN / config.programSettings->blockSize;
     size_t number_blocks_per_kernel = ((size_in_blocks + config.programSettings->kernelReplications - 1)/(config.programSettings->kernelReplications));
-    size_t out_buffer_size = config.programSettings->matrixSize * 
+    size_t out_buffer_size = config.programSettings->matrixSizeN * 
                                 (number_blocks_per_kernel) * config.programSettings->blockSize;
+    size_t a_bytes = sizeof(T) * config.programSettings->matrixSize * config.programSettings->matrixSizeK;
+    size_t b_bytes = sizeof(T) * config.programSettings->matrixSizeK * config.programSettings->matrixSizeN;
+    size_t c_bytes = sizeof(T) * config.programSettings->matrixSize * config.programSettings->matrixSizeN;
 
     std::vector<cl::Buffer> a_buffers;
     std::vector<cl::Buffer> b_buffers;
@@ -68,41 +138,19 @@ calculate(hpcc_base::ExecutionSettings<gemm::GEMMProgramSettings> const& config,
     // Create an output buffer for every kernel to still allow restrict optimizations
     // For the other buffers this is not necessary, since they are read only
     for (int i=0; i < config.programSettings->kernelReplications; i++) {
-        // Array of flags for each buffer that is allocated in this benchmark
-        // The content of the flags will be changed according to the used compiler flags
-        // to support different kinds of devices
-        int memory_bank_info[4] = {0};
-#ifdef INTEL_FPGA
-#ifdef USE_HBM
-        // For Intel HBM the buffers have to be created with a special flag
-        for (int& v : memory_bank_info) {
-                    v = CL_MEM_HETEROGENEOUS_INTELFPGA;
-        }
-#else
-        // Set the memory bank bits if memory interleaving is not used
-        // Three bits are used to represent the target memory bank for the buffer on the FPGA by using the values 1-7.
-        // This does also mean, that only up to 7 memory banks can be accessed with this functionality.
-        // For boards with HBM, the selection of memory banks is done in the kernel code.
-        if (!config.programSettings->useMemoryInterleaving) {
-                for (int k = 0; k < 4; k++) {
-                    memory_bank_info[k] = ((1 + k) << 16);
-                }
-        }
-#endif
-#endif
         if (i == 0 || config.programSettings->replicateInputBuffers) {
-            a_buffers.push_back(cl::Buffer(*config.context, CL_MEM_READ_ONLY | memory_bank_info[0],
-                                sizeof(HOST_DATA_TYPE) *config.programSettings->matrixSize*config.programSettings->matrixSize, NULL, &err));
+            a_buffers.push_back(placement::createBuffer(*config.context, CL_MEM_READ_ONLY,
+                                a_bytes, get_memory_bank(config, i, 0), &err));
             ASSERT_CL(err)
-            b_buffers.push_back(cl::Buffer(*config.context, CL_MEM_READ_ONLY | memory_bank_info[1],
-                                sizeof(HOST_DATA_TYPE) *config.programSettings->matrixSize*config.programSettings->matrixSize, NULL, &err));
+            b_buffers.push_back(placement::createBuffer(*config.context, CL_MEM_READ_ONLY,
+                                b_bytes, get_memory_bank(config, i, 1), &err));
             ASSERT_CL(err)
-            c_buffers.push_back(cl::Buffer(*config.context, CL_MEM_READ_ONLY | memory_bank_info[2],
-                                sizeof(HOST_DATA_TYPE) *config.programSettings->matrixSize*config.programSettings->matrixSize, NULL, &err));
+            c_buffers.push_back(placement::createBuffer(*config.context, CL_MEM_READ_ONLY,
+                                c_bytes, get_memory_bank(config, i, 2), &err));
             ASSERT_CL(err)
         }
-        out_buffers.push_back(cl::Buffer(*config.context, CL_MEM_WRITE_ONLY | memory_bank_info[3],
-                                    sizeof(HOST_DATA_TYPE) * out_buffer_size, NULL, &err));
+        out_buffers.push_back(placement::createBuffer(*config.context, CL_MEM_WRITE_ONLY,
+                                    sizeof(T) * out_buffer_size, get_memory_bank(config, i, 3), &err));
         ASSERT_CL(err)
     }
 
@@ -153,9 +201,22 @@ calculate(hpcc_base::ExecutionSettings<gemm::GEMMProgramSettings> const& config,
         ASSERT_CL(err);
         err = gemmkernel.setArg(6, size_in_blocks);
         ASSERT_CL(err);
-        err = gemmkernel.setArg(7, static_cast<cl_uint>(i * number_blocks_per_kernel));
+        err = gemmkernel.setArg(7, k_blocks);
+        ASSERT_CL(err);
+        err = gemmkernel.setArg(8, n_blocks);
+        ASSERT_CL(err);
+        err = gemmkernel.setArg(9, static_cast<cl_uint>(i * number_blocks_per_kernel));
+        ASSERT_CL(err);
+        err = gemmkernel.setArg(10, static_cast<cl_uint>(std::min<cl_uint>(i * number_blocks_per_kernel + number_blocks_per_kernel, size_in_blocks)));
         ASSERT_CL(err);
-        err = gemmkernel.setArg(8, static_cast<cl_uint>(std::min<cl_uint>(i * number_blocks_per_kernel + number_blocks_per_kernel, size_in_blocks)));
+        err = gemmkernel.setArg(11, static_cast<cl_uint>(config.programSettings->transposeA));
+        ASSERT_CL(err);
+        err = gemmkernel.setArg(12, static_cast<cl_uint>(config.programSettings->transposeB));
+        ASSERT_CL(err);
+        // A single matrix multiplication per kernel execution
+        err = gemmkernel.setArg(13, static_cast<cl_uint>(1));
+        ASSERT_CL(err);
+        err = gemmkernel.setArg(14, static_cast<cl_uint>(0));
         ASSERT_CL(err);
 
         gemmkernels.push_back(gemmkernel);
@@ -164,49 +225,58 @@ calculate(hpcc_base::ExecutionSettings<gemm::GEMMProgramSettings> const& config,
     /* --- Execute actual benchmark kernels --- */
 
     double t;
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+    auto counters = initialize_kernel_counters(config, gemmkernels);
+#endif
     std::vector<double> executionTimes;
+    profiling::EventProfiler profiler;
     for (int i = 0; i < config.programSettings->numRepetitions; i++) {
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+        counters->reset(compute_queues[0]);
+#endif
 #ifdef USE_SVM
         err = clEnqueueSVMMap(compute_queues[0](), CL_TRUE,
                         CL_MAP_READ,
                         reinterpret_cast<void *>(a),
-                        sizeof(HOST_DATA_TYPE) *
-                        (config.programSettings->matrixSize * config.programSettings->matrixSize), 0,
+                        a_bytes, 0,
                         NULL, NULL);
         ASSERT_CL(err)
         err = clEnqueueSVMMap(compute_queues[0](), CL_TRUE,
                         CL_MAP_READ,
                         reinterpret_cast<void *>(b),
-                        sizeof(HOST_DATA_TYPE) *
-                        (config.programSettings->matrixSize * config.programSettings->matrixSize), 0,
+                        b_bytes, 0,
                         NULL, NULL);
         ASSERT_CL(err)
         err = clEnqueueSVMMap(compute_queues[0](), CL_TRUE,
                         CL_MAP_READ,
                         reinterpret_cast<void *>(c),
-                        sizeof(HOST_DATA_TYPE) *
-                        (config.programSettings->matrixSize * config.programSettings->matrixSize), 0,
+                        c_bytes, 0,
                         NULL, NULL);
         ASSERT_CL(err)
         err = clEnqueueSVMMap(compute_queues[0](), CL_TRUE,
                         CL_MAP_WRITE,
                         reinterpret_cast<void *>(c_out),
-                        sizeof(HOST_DATA_TYPE) *
-                        (config.programSettings->matrixSize * config.programSettings->matrixSize), 0,
+                        c_bytes, 0,
                         NULL, NULL);
         ASSERT_CL(err)
 #else
 
         for (int i=0; i < (config.programSettings->replicateInputBuffers ? config.programSettings->kernelReplications : 1); i++) {
+            cl::Event write_a_event;
+            cl::Event write_b_event;
+            cl::Event write_c_event;
             err = compute_queues[i].enqueueWriteBuffer(a_buffers[i], CL_TRUE, 0,
-                                        sizeof(HOST_DATA_TYPE)*config.programSettings->matrixSize*config.programSettings->matrixSize, a);
+                                        a_bytes, a, NULL, &write_a_event);
             ASSERT_CL(err)
             err = compute_queues[i].enqueueWriteBuffer(b_buffers[i], CL_TRUE, 0,
-                                        sizeof(HOST_DATA_TYPE)*config.programSettings->matrixSize*config.programSettings->matrixSize, b);
+                                        b_bytes, b, NULL, &write_b_event);
             ASSERT_CL(err)
             err = compute_queues[i].enqueueWriteBuffer(c_buffers[i], CL_TRUE, 0,
-                                        sizeof(HOST_DATA_TYPE)*config.programSettings->matrixSize*config.programSettings->matrixSize, c);
+                                        c_bytes, c, NULL, &write_c_event);
             ASSERT_CL(err)
+            profiler.record("write_A", i, write_a_event);
+            profiler.record("write_B", i, write_b_event);
+            profiler.record("write_C", i, write_c_event);
         }
         for (int i=0; i < config.programSettings->kernelReplications; i++) {
             compute_queues[i].finish();
@@ -214,7 +284,9 @@ calculate(hpcc_base::ExecutionSettings<gemm::GEMMProgramSettings> const& config,
 #endif
         auto t1 = std::chrono::high_resolution_clock::now();
         for (int i=0; i < config.programSettings->kernelReplications; i++) {
-            compute_queues[i].enqueueNDRangeKernel(gemmkernels[i], cl::NullRange, cl::NDRange(1));
+            cl::Event kernel_event;
+            compute_queues[i].enqueueNDRangeKernel(gemmkernels[i], cl::NullRange, cl::NDRange(1), cl::NullRange, NULL, &kernel_event);
+            profiler.record("kernel", i, kernel_event);
         }
         for (int i=0; i < config.programSettings->kernelReplications; i++) {
             compute_queues[i].finish();
@@ -222,6 +294,11 @@ calculate(hpcc_base::ExecutionSettings<gemm::GEMMProgramSettings> const& config,
         auto t2 = std::chrono::high_resolution_clock::now();
         std::chrono::duration<double> timespan = t2 - t1;
         executionTimes.push_back(timespan.count());
+        profiler.collect(i);
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+        counters->read(compute_queues[0]);
+        counters->print(i);
+#endif
     }
 
     /* --- Read back results from Device --- */
@@ -245,9 +322,8 @@ calculate(hpcc_base::ExecutionSettings<gemm::GEMMProgramSettings> const& config,
 #else
         // The last buffer might only contain a little bit less data 
     for (int i=0; i < config.programSettings->kernelReplications; i++) {
-        long max_bytes_to_read = (static_cast<long>(sizeof(HOST_DATA_TYPE)*config.programSettings->matrixSize*config.programSettings->matrixSize))
-                                            - i * sizeof(HOST_DATA_TYPE) *  out_buffer_size;
-        long bytes_to_read = std::min(max_bytes_to_read, static_cast<long>(sizeof(HOST_DATA_TYPE) * out_buffer_size));
+        long max_bytes_to_read = static_cast<long>(c_bytes) - i * sizeof(T) *  out_buffer_size;
+        long bytes_to_read = std::min(max_bytes_to_read, static_cast<long>(sizeof(T) * out_buffer_size));
         if (bytes_to_read > 0) {
             err = compute_queues[0].enqueueReadBuffer(out_buffers[i], CL_TRUE, 0,
                                     bytes_to_read, 
@@ -259,8 +335,589 @@ calculate(hpcc_base::ExecutionSettings<gemm::GEMMProgramSettings> const& config,
 
 
     std::unique_ptr<gemm::GEMMExecutionTimings> results(
-                    new gemm::GEMMExecutionTimings{executionTimes});
+                    new gemm::GEMMExecutionTimings{executionTimes, profiler.timings});
     return results;
 }
 
+/*
+ Transfer a square tile between a matrix in host memory and a device buffer without an additional copy on the host.
+ The tile is stored contiguously in the device buffer.
+ The C API is used, because the rectangular transfers have different signatures in the C++ bindings.
+*/
+template<typename T>
+cl::Event
+transfer_tile(cl::CommandQueue &queue, cl::Buffer &buffer, T* matrix, size_t matrix_size, size_t tile_size,
+                size_t row, size_t col, const std::vector<cl::Event> &wait_list, bool write) {
+    std::vector<cl_event> wait_events;
+    for (const auto &e : wait_list) {
+        if (e() != nullptr) {
+            wait_events.push_back(e());
+        }
+    }
+    size_t buffer_origin[3] = {0, 0, 0};
+    size_t host_origin[3] = {col * sizeof(T), row, 0};
+    size_t region[3] = {tile_size * sizeof(T), tile_size, 1};
+    cl_event event;
+    int err;
+    if (write) {
+        err = clEnqueueWriteBufferRect(queue(), buffer(), CL_FALSE, buffer_origin, host_origin, region,
+                                        0, 0, matrix_size * sizeof(T), 0, matrix,
+                                        wait_events.size(), wait_events.empty() ? NULL : wait_events.data(), &event);
+    }
+    else {
+        err = clEnqueueReadBufferRect(queue(), buffer(), CL_FALSE, buffer_origin, host_origin, region,
+                                        0, 0, matrix_size * sizeof(T), 0, matrix,
+                                        wait_events.size(), wait_events.empty() ? NULL : wait_events.data(), &event);
+    }
+    ASSERT_CL(err)
+    return cl::Event(event);
+}
+
+/*
+ Out-of-core execution of the GEMM.
+ The output matrix is split into square tiles that are distributed round-robin over the kernel replications.
+ A tile of C is calculated by multiplying the panels of A and B tile by tile with the unchanged kernel.
+ The partial results are accumulated on the device by using the previous output as the C input of the next kernel execution with beta = 1.
+ Two sets of buffers are used for the tiles of A and B, so the transfer of the next tiles overlaps with the calculation.
+
+ @copydoc bm_execution::calculate()
+*/
+template<typename T>
+std::unique_ptr<gemm::GEMMExecutionTimings>
+calculate_tiled(hpcc_base::ExecutionSettings<gemm::GEMMProgramSettings> const& config, T* a, T* b, T* c, T* c_out,
+        T alpha, T beta) {
+#ifdef USE_SVM
+    std::cerr << "ERROR: The out-of-core execution is not supported with SVM!" << std::endl;
+    return std::unique_ptr<gemm::GEMMExecutionTimings>(nullptr);
+#else
+    int err;
+    const size_t matrix_size = config.programSettings->matrixSize;
+    const cl_uint tile_blocks = config.programSettings->tileSizeInBlocks;
+    const size_t tile_size = tile_blocks * config.programSettings->blockSize;
+    const size_t tiles_per_dim = matrix_size / tile_size;
+    const size_t tile_bytes = tile_size * tile_size * sizeof(T);
+    const uint num_slots = 2;
+    const int replications = config.programSettings->kernelReplications;
+    // Scaling of the accumulated partial results
+    const T one = static_cast<T>(1.0);
+
+    std::vector<cl::CommandQueue> write_queues;
+    std::vector<cl::CommandQueue> compute_queues;
+    std::vector<cl::CommandQueue> read_queues;
+    std::vector<std::vector<cl::Buffer>> a_buffers(replications);
+    std::vector<std::vector<cl::Buffer>> b_buffers(replications);
+    std::vector<cl::Buffer> c_buffers;
+    std::vector<std::vector<cl::Buffer>> out_buffers(replications);
+    std::vector<cl::Kernel> gemmkernels;
+
+    for (int i=0; i < replications; i++) {
+        for (uint slot = 0; slot < num_slots; slot++) {
+            a_buffers[i].push_back(placement::createBuffer(*config.context, CL_MEM_READ_ONLY, tile_bytes, get_memory_bank(config, i, 0), &err));
+            ASSERT_CL(err)
+            b_buffers[i].push_back(placement::createBuffer(*config.context, CL_MEM_READ_ONLY, tile_bytes, get_memory_bank(config, i, 1), &err));
+            ASSERT_CL(err)
+            // The output buffers are alternately used as input for C to accumulate the partial results
+            out_buffers[i].push_back(placement::createBuffer(*config.context, CL_MEM_READ_WRITE, tile_bytes, get_memory_bank(config, i, 3), &err));
+            ASSERT_CL(err)
+        }
+        c_buffers.push_back(placement::createBuffer(*config.context, CL_MEM_READ_ONLY, tile_bytes, get_memory_bank(config, i, 2), &err));
+        ASSERT_CL(err)
+
+#ifdef INTEL_FPGA
+        cl::Kernel gemmkernel(*config.program, (KERNEL_NAME + std::to_string(i)).c_str(),
+                                        &err);
+        ASSERT_CL(err);
+#endif
+#ifdef XILINX_FPGA
+        cl::Kernel gemmkernel(*config.program, (std::string(KERNEL_NAME) + "0:{" + KERNEL_NAME + "0_" +  std::to_string(i + 1) + "}").c_str(),
+                                        &err);
+        ASSERT_CL(err);
+#endif
+        // Every kernel execution calculates a complete tile
+        err = gemmkernel.setArg(4, alpha);
+        ASSERT_CL(err);
+        err = gemmkernel.setArg(6, tile_blocks);
+        ASSERT_CL(err);
+        err = gemmkernel.setArg(7, tile_blocks);
+        ASSERT_CL(err);
+        err = gemmkernel.setArg(8, tile_blocks);
+        ASSERT_CL(err);
+        err = gemmkernel.setArg(9, static_cast<cl_uint>(0));
+        ASSERT_CL(err);
+        err = gemmkernel.setArg(10, tile_blocks);
+        ASSERT_CL(err);
+        err = gemmkernel.setArg(11, static_cast<cl_uint>(0));
+        ASSERT_CL(err);
+        err = gemmkernel.setArg(12, static_cast<cl_uint>(0));
+        ASSERT_CL(err);
+        // A single matrix multiplication per kernel execution
+        err = gemmkernel.setArg(13, static_cast<cl_uint>(1));
+        ASSERT_CL(err);
+        err = gemmkernel.setArg(14, static_cast<cl_uint>(0));
+        ASSERT_CL(err);
+        gemmkernels.push_back(gemmkernel);
+
+        write_queues.push_back(cl::CommandQueue(*config.context, *config.device, profiling::PROFILING_QUEUE_PROPERTIES, &err));
+        ASSERT_CL(err)
+        compute_queues.push_back(cl::CommandQueue(*config.context, *config.device, profiling::PROFILING_QUEUE_PROPERTIES, &err));
+        ASSERT_CL(err)
+        read_queues.push_back(cl::CommandQueue(*config.context, *config.device, profiling::PROFILING_QUEUE_PROPERTIES, &err));
+        ASSERT_CL(err)
+    }
+
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+    auto counters = initialize_kernel_counters(config, gemmkernels);
+#endif
+    std::vector<double> executionTimes;
+    profiling::EventProfiler profiler;
+    for (int rep = 0; rep < config.programSettings->numRepetitions; rep++) {
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+        counters->reset(compute_queues[0]);
+#endif
+        // Events that have to complete before a buffer can be overwritten
+        std::vector<std::vector<cl::Event>> ab_free(replications, std::vector<cl::Event>(num_slots));
+        std::vector<std::vector<cl::Event>> out_free(replications, std::vector<cl::Event>(num_slots));
+        std::vector<cl::Event> c_free(replications);
+        std::vector<uint> launches(replications, 0);
+
+        auto t1 = std::chrono::high_resolution_clock::now();
+        for (size_t tile = 0; tile < tiles_per_dim * tiles_per_dim; tile++) {
+            const int r = tile % replications;
+            const size_t row = (tile / tiles_per_dim) * tile_size;
+            const size_t col = (tile % tiles_per_dim) * tile_size;
+            std::vector<cl::Event> write_c(1);
+            write_c[0] = transfer_tile(write_queues[r], c_buffers[r], c, matrix_size, tile_size, row, col, {c_free[r]}, true);
+            profiler.record("write_C", r, write_c[0]);
+            uint out_slot = 0;
+            std::vector<cl::Event> last_kernel(1);
+            for (size_t k = 0; k < tiles_per_dim; k++) {
+                const uint slot = launches[r] % num_slots;
+                out_slot = k % num_slots;
+                std::vector<cl::Event> kernel_wait;
+                kernel_wait.push_back(transfer_tile(write_queues[r], a_buffers[r][slot], a, matrix_size, tile_size, row, k * tile_size, {ab_free[r][slot]}, true));
+                kernel_wait.push_back(transfer_tile(write_queues[r], b_buffers[r][slot], b, matrix_size, tile_size, k * tile_size, col, {ab_free[r][slot]}, true));
+                profiler.record("write_A", r, kernel_wait[0]);
+                profiler.record("write_B", r, kernel_wait[1]);
+                if (k == 0) {
+                    kernel_wait.push_back(write_c[0]);
+                }
+                if (out_free[r][out_slot]() != nullptr) {
+                    kernel_wait.push_back(out_free[r][out_slot]);
+                }
+                err = gemmkernels[r].setArg(0, a_buffers[r][slot]);
+                ASSERT_CL(err);
+                err = gemmkernels[r].setArg(1, b_buffers[r][slot]);
+                ASSERT_CL(err);
+                err = gemmkernels[r].setArg(2, (k == 0) ? c_buffers[r] : out_buffers[r][(k - 1) % num_slots]);
+                ASSERT_CL(err);
+                err = gemmkernels[r].setArg(3, out_buffers[r][out_slot]);
+                ASSERT_CL(err);
+                err = gemmkernels[r].setArg(5, (k == 0) ? beta : one);
+                ASSERT_CL(err);
+                cl::Event kernel_event;
+                err = compute_queues[r].enqueueNDRangeKernel(gemmkernels[r], cl::NullRange, cl::NDRange(1), cl::NullRange, &kernel_wait, &kernel_event);
+                ASSERT_CL(err)
+                profiler.record("kernel", r, kernel_event);
+                ab_free[r][slot] = kernel_event;
+                last_kernel[0] = kernel_event;
+                if (k == 0) {
+                    c_free[r] = kernel_event;
+                }
+                launches[r]++;
+            }
+            // Read the accumulated tile back after the last kernel execution
+            out_free[r][out_slot] = transfer_tile(read_queues[r], out_buffers[r][out_slot], c_out, matrix_size, tile_size, row, col, last_kernel, false);
+            profiler.record("read_C", r, out_free[r][out_slot]);
+        }
+        for (int i=0; i < replications; i++) {
+            ASSERT_CL(compute_queues[i].finish())
+            ASSERT_CL(read_queues[i].finish())
+        }
+        auto t2 = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> timespan = t2 - t1;
+        executionTimes.push_back(timespan.count());
+        profiler.collect(rep);
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+        counters->read(compute_queues[0]);
+        counters->print(rep);
+#endif
+    }
+
+    std::unique_ptr<gemm::GEMMExecutionTimings> results(
+                    new gemm::GEMMExecutionTimings{executionTimes, profiler.timings});
+    return results;
+#endif
+}
+
+/*
+ Distributed execution of a single GEMM over all MPI ranks using SUMMA.
+ The ranks are arranged in a square torus and every rank holds one block of A, B and C.
+ In step k, the ranks in torus column k broadcast their block of A within their torus row and the ranks in
+ torus row k broadcast their block of B within their torus column. Every rank multiplies the received blocks on the device
+ and accumulates the result to its block of C by using the previous output as C input with beta = 1.
+ The broadcast of the next blocks overlaps with the calculation on the device.
+ Every kernel replication calculates a range of block rows of C, so it only requires the corresponding rows of A.
+
+ @copydoc bm_execution::calculate()
+*/
+template<typename T>
+std::unique_ptr<gemm::GEMMExecutionTimings>
+calculate_distributed(hpcc_base::ExecutionSettings<gemm::GEMMProgramSettings> const& config, T* a, T* b, T* c, T* c_out,
+        T alpha, T beta) {
+#if defined(USE_SVM) || !defined(_USE_MPI_)
+    std::cerr << "ERROR: The distributed execution requires MPI and is not supported with SVM!" << std::endl;
+    return std::unique_ptr<gemm::GEMMExecutionTimings>(nullptr);
+#else
+    int err;
+    const size_t matrix_size = config.programSettings->matrixSize;
+    const cl_uint size_in_blocks = matrix_size / config.programSettings->blockSize;
+    const size_t block_elements = matrix_size * matrix_size;
+    const int torus_width = config.programSettings->torus_width;
+    const uint num_slots = 2;
+    // Scaling of the accumulated partial results
+    const T one = static_cast<T>(1.0);
+
+    // The rank within the row communicator is the torus column and vice versa
+    MPI_Comm row_communicator;
+    MPI_Comm_split(MPI_COMM_WORLD, config.programSettings->torus_row, config.programSettings->torus_col, &row_communicator);
+    MPI_Comm col_communicator;
+    MPI_Comm_split(MPI_COMM_WORLD, config.programSettings->torus_col, config.programSettings->torus_row, &col_communicator);
+
+    // Host buffers for the blocks received from other ranks
+    std::vector<std::vector<T>> a_received(num_slots, std::vector<T>(block_elements));
+    std::vector<std::vector<T>> b_received(num_slots, std::vector<T>(block_elements));
+
+    // Split the block rows of C between the kernel replications
+    size_t blocks_per_kernel = (size_in_blocks + config.programSettings->kernelReplications - 1) / config.programSettings->kernelReplications;
+    std::vector<size_t> first_row;
+    std::vector<size_t> row_count;
+    for (size_t first = 0; first < size_in_blocks; first += blocks_per_kernel) {
+        first_row.push_back(first * config.programSettings->blockSize);
+        row_count.push_back(std::min(blocks_per_kernel, size_in_blocks - first) * config.programSettings->blockSize);
+    }
+    const int replications = first_row.size();
+
+    std::vector<cl::CommandQueue> write_queues;
+    std::vector<cl::CommandQueue> compute_queues;
+    std::vector<std::vector<cl::Buffer>> a_buffers(replications);
+    std::vector<std::vector<cl::Buffer>> b_buffers(replications);
+    std::vector<cl::Buffer> c_buffers;
+    std::vector<std::vector<cl::Buffer>> out_buffers(replications);
+    std::vector<cl::Kernel> gemmkernels;
+
+    for (int i=0; i < replications; i++) {
+        const size_t rows_bytes = row_count[i] * matrix_size * sizeof(T);
+        for (uint slot = 0; slot < num_slots; slot++) {
+            a_buffers[i].push_back(placement::createBuffer(*config.context, CL_MEM_READ_ONLY, rows_bytes, get_memory_bank(config, i, 0), &err));
+            ASSERT_CL(err)
+            b_buffers[i].push_back(placement::createBuffer(*config.context, CL_MEM_READ_ONLY, block_elements * sizeof(T), get_memory_bank(config, i, 1), &err));
+            ASSERT_CL(err)
+            out_buffers[i].push_back(placement::createBuffer(*config.context, CL_MEM_READ_WRITE, rows_bytes, get_memory_bank(config, i, 3), &err));
+            ASSERT_CL(err)
+        }
+        c_buffers.push_back(placement::createBuffer(*config.context, CL_MEM_READ_ONLY, rows_bytes, get_memory_bank(config, i, 2), &err));
+        ASSERT_CL(err)
+
+#ifdef INTEL_FPGA
+        cl::Kernel gemmkernel(*config.program, (KERNEL_NAME + std::to_string(i)).c_str(),
+                                        &err);
+        ASSERT_CL(err);
+#endif
+#ifdef XILINX_FPGA
+        cl::Kernel gemmkernel(*config.program, (std::string(KERNEL_NAME) + "0:{" + KERNEL_NAME + "0_" +  std::to_string(i + 1) + "}").c_str(),
+                                        &err);
+        ASSERT_CL(err);
+#endif
+        // The buffers only contain the rows of the replication, so the kernel calculates all rows of its buffers
+        err = gemmkernel.setArg(4, alpha);
+        ASSERT_CL(err);
+        err = gemmkernel.setArg(6, static_cast<cl_uint>(row_count[i] / config.programSettings->blockSize));
+        ASSERT_CL(err);
+        err = gemmkernel.setArg(7, size_in_blocks);
+        ASSERT_CL(err);
+        err = gemmkernel.setArg(8, size_in_blocks);
+        ASSERT_CL(err);
+        err = gemmkernel.setArg(9, static_cast<cl_uint>(0));
+        ASSERT_CL(err);
+        err = gemmkernel.setArg(10, static_cast<cl_uint>(row_count[i] / config.programSettings->blockSize));
+        ASSERT_CL(err);
+        err = gemmkernel.setArg(11, static_cast<cl_uint>(0));
+        ASSERT_CL(err);
+        err = gemmkernel.setArg(12, static_cast<cl_uint>(0));
+        ASSERT_CL(err);
+        // A single matrix multiplication per kernel execution
+        err = gemmkernel.setArg(13, static_cast<cl_uint>(1));
+        ASSERT_CL(err);
+        err = gemmkernel.setArg(14, static_cast<cl_uint>(0));
+        ASSERT_CL(err);
+        gemmkernels.push_back(gemmkernel);
+
+        write_queues.push_back(cl::CommandQueue(*config.context, *config.device, profiling::PROFILING_QUEUE_PROPERTIES, &err));
+        ASSERT_CL(err)
+        compute_queues.push_back(cl::CommandQueue(*config.context, *config.device, profiling::PROFILING_QUEUE_PROPERTIES, &err));
+        ASSERT_CL(err)
+    }
+
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+    auto counters = initialize_kernel_counters(config, gemmkernels);
+#endif
+    std::vector<double> executionTimes;
+    profiling::EventProfiler profiler;
+    for (int rep = 0; rep < config.programSettings->numRepetitions; rep++) {
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+        counters->reset(compute_queues[0]);
+#endif
+        std::vector<std::vector<cl::Event>> ab_free(replications, std::vector<cl::Event>(num_slots));
+        std::vector<std::vector<cl::Event>> host_free(num_slots);
+        std::vector<MPI_Request> requests(2 * num_slots);
+        std::vector<T*> a_blocks(num_slots);
+        std::vector<T*> b_blocks(num_slots);
+
+        // Start the broadcast of the blocks of A and B that are required in the given step
+        auto start_broadcast = [&](int k) {
+            const uint slot = k % num_slots;
+            a_blocks[slot] = (config.programSettings->torus_col == k) ? a : a_received[slot].data();
+            b_blocks[slot] = (config.programSettings->torus_row == k) ? b : b_received[slot].data();
+            MPI_Ibcast(a_blocks[slot], block_elements * sizeof(T), MPI_BYTE, k, row_communicator, &requests[2 * slot]);
+            MPI_Ibcast(b_blocks[slot], block_elements * sizeof(T), MPI_BYTE, k, col_communicator, &requests[2 * slot + 1]);
+        };
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        auto t1 = std::chrono::high_resolution_clock::now();
+        std::vector<cl::Event> write_c(replications);
+        for (int i=0; i < replications; i++) {
+            ASSERT_CL(write_queues[i].enqueueWriteBuffer(c_buffers[i], CL_FALSE, 0, row_count[i] * matrix_size * sizeof(T),
+                                                    &c[first_row[i] * matrix_size], NULL, &write_c[i]))
+            profiler.record("write_C", i, write_c[i]);
+        }
+        start_broadcast(0);
+        for (int k = 0; k < torus_width; k++) {
+            const uint slot = k % num_slots;
+            MPI_Waitall(2, &requests[2 * slot], MPI_STATUSES_IGNORE);
+            if (k + 1 < torus_width) {
+                // The host buffers of the next slot can be reused after they were copied to the device
+                for (auto &e : host_free[(k + 1) % num_slots]) {
+                    ASSERT_CL(e.wait())
+                }
+                host_free[(k + 1) % num_slots].clear();
+                start_broadcast(k + 1);
+            }
+            for (int i=0; i < replications; i++) {
+                std::vector<cl::Event> kernel_wait(2);
+                std::vector<cl::Event> slot_free;
+                if (ab_free[i][slot]() != nullptr) {
+                    slot_free.push_back(ab_free[i][slot]);
+                }
+                ASSERT_CL(write_queues[i].enqueueWriteBuffer(a_buffers[i][slot], CL_FALSE, 0, row_count[i] * matrix_size * sizeof(T),
+                                                    &a_blocks[slot][first_row[i] * matrix_size], &slot_free, &kernel_wait[0]))
+                ASSERT_CL(write_queues[i].enqueueWriteBuffer(b_buffers[i][slot], CL_FALSE, 0, block_elements * sizeof(T),
+                                                    b_blocks[slot], &slot_free, &kernel_wait[1]))
+                profiler.record("write_A", i, kernel_wait[0]);
+                profiler.record("write_B", i, kernel_wait[1]);
+                host_free[slot].push_back(kernel_wait[0]);
+                host_free[slot].push_back(kernel_wait[1]);
+                if (k == 0) {
+                    kernel_wait.push_back(write_c[i]);
+                }
+                err = gemmkernels[i].setArg(0, a_buffers[i][slot]);
+                ASSERT_CL(err);
+                err = gemmkernels[i].setArg(1, b_buffers[i][slot]);
+                ASSERT_CL(err);
+                err = gemmkernels[i].setArg(2, (k == 0) ? c_buffers[i] : out_buffers[i][(k - 1) % num_slots]);
+                ASSERT_CL(err);
+                err = gemmkernels[i].setArg(3, out_buffers[i][k % num_slots]);
+                ASSERT_CL(err);
+                err = gemmkernels[i].setArg(5, (k == 0) ? beta : one);
+                ASSERT_CL(err);
+                cl::Event kernel_event;
+                ASSERT_CL(compute_queues[i].enqueueNDRangeKernel(gemmkernels[i], cl::NullRange, cl::NDRange(1), cl::NullRange, &kernel_wait, &kernel_event))
+                profiler.record("kernel", i, kernel_event);
+                ab_free[i][slot] = kernel_event;
+            }
+        }
+        for (int i=0; i < replications; i++) {
+            cl::Event read_event;
+            ASSERT_CL(compute_queues[i].enqueueReadBuffer(out_buffers[i][(torus_width - 1) % num_slots], CL_TRUE, 0, row_count[i] * matrix_size * sizeof(T),
+                                                    &c_out[first_row[i] * matrix_size], NULL, &read_event))
+            profiler.record("read_C", i, read_event);
+        }
+        auto t2 = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> timespan = t2 - t1;
+        executionTimes.push_back(timespan.count());
+        profiler.collect(rep);
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+        counters->read(compute_queues[0]);
+        counters->print(rep);
+#endif
+    }
+    MPI_Comm_free(&row_communicator);
+    MPI_Comm_free(&col_communicator);
+
+    std::unique_ptr<gemm::GEMMExecutionTimings> results(
+                    new gemm::GEMMExecutionTimings{executionTimes, profiler.timings});
+    return results;
+#endif
+}
+
+/*
+ Batched execution of many small independent matrix multiplications.
+ The batch is split into contiguous parts that are calculated by the kernel replications.
+ Every kernel execution loops over all matrices of its part, so the launch overhead is only paid once per part.
+ Since the calculation of a small matrix is short compared to the transfer, the measured time includes
+ the transfers of the inputs and the output.
+
+ @copydoc bm_execution::calculate()
+*/
+template<typename T>
+std::unique_ptr<gemm::GEMMExecutionTimings>
+calculate_batched(hpcc_base::ExecutionSettings<gemm::GEMMProgramSettings> const& config, T* a, T* b, T* c, T* c_out,
+        T alpha, T beta) {
+#ifdef USE_SVM
+    std::cerr << "ERROR: The batched execution is not supported with SVM!" << std::endl;
+    return std::unique_ptr<gemm::GEMMExecutionTimings>(nullptr);
+#else
+    int err;
+    const size_t matrix_elements = static_cast<size_t>(config.programSettings->matrixSize) * config.programSettings->matrixSize;
+    const size_t stride = config.programSettings->batchStride;
+    const cl_uint size_in_blocks = config.programSettings->matrixSize / config.programSettings->blockSize;
+    const size_t matrices_per_kernel = (config.programSettings->batchCount + config.programSettings->kernelReplications - 1) / config.programSettings->kernelReplications;
+
+    std::vector<cl::CommandQueue> compute_queues;
+    std::vector<cl::Buffer> a_buffers;
+    std::vector<cl::Buffer> b_buffers;
+    std::vector<cl::Buffer> c_buffers;
+    std::vector<cl::Buffer> out_buffers;
+    std::vector<cl::Kernel> gemmkernels;
+    // Index of the first matrix and the total size of the part that is calculated by every replication
+    std::vector<size_t> first_matrix;
+    std::vector<size_t> part_bytes;
+
+    for (int i=0; i < config.programSettings->kernelReplications; i++) {
+        size_t first = i * matrices_per_kernel;
+        if (first >= config.programSettings->batchCount) {
+            // Not enough matrices to use all kernel replications
+            break;
+        }
+        size_t count = std::min(matrices_per_kernel, config.programSettings->batchCount - first);
+        first_matrix.push_back(first);
+        part_bytes.push_back(((count - 1) * stride + matrix_elements) * sizeof(T));
+
+        a_buffers.push_back(placement::createBuffer(*config.context, CL_MEM_READ_ONLY, part_bytes[i], get_memory_bank(config, i, 0), &err));
+        ASSERT_CL(err)
+        b_buffers.push_back(placement::createBuffer(*config.context, CL_MEM_READ_ONLY, part_bytes[i], get_memory_bank(config, i, 1), &err));
+        ASSERT_CL(err)
+        c_buffers.push_back(placement::createBuffer(*config.context, CL_MEM_READ_ONLY, part_bytes[i], get_memory_bank(config, i, 2), &err));
+        ASSERT_CL(err)
+        out_buffers.push_back(placement::createBuffer(*config.context, CL_MEM_WRITE_ONLY, part_bytes[i], get_memory_bank(config, i, 3), &err));
+        ASSERT_CL(err)
+
+#ifdef INTEL_FPGA
+        cl::Kernel gemmkernel(*config.program, (KERNEL_NAME + std::to_string(i)).c_str(),
+                                        &err);
+        ASSERT_CL(err);
+#endif
+#ifdef XILINX_FPGA
+        cl::Kernel gemmkernel(*config.program, (std::string(KERNEL_NAME) + "0:{" + KERNEL_NAME + "0_" +  std::to_string(i + 1) + "}").c_str(),
+                                        &err);
+        ASSERT_CL(err);
+#endif
+        err = gemmkernel.setArg(0, a_buffers[i]);
+        ASSERT_CL(err);
+        err = gemmkernel.setArg(1, b_buffers[i]);
+        ASSERT_CL(err);
+        err = gemmkernel.setArg(2, c_buffers[i]);
+        ASSERT_CL(err);
+        err = gemmkernel.setArg(3, out_buffers[i]);
+        ASSERT_CL(err);
+        err = gemmkernel.setArg(4, alpha);
+        ASSERT_CL(err);
+        err = gemmkernel.setArg(5, beta);
+        ASSERT_CL(err);
+        // Every kernel execution calculates complete matrices
+        err = gemmkernel.setArg(6, size_in_blocks);
+        ASSERT_CL(err);
+        err = gemmkernel.setArg(7, size_in_blocks);
+        ASSERT_CL(err);
+        err = gemmkernel.setArg(8, size_in_blocks);
+        ASSERT_CL(err);
+        err = gemmkernel.setArg(9, static_cast<cl_uint>(0));
+        ASSERT_CL(err);
+        err = gemmkernel.setArg(10, size_in_blocks);
+        ASSERT_CL(err);
+        err = gemmkernel.setArg(11, static_cast<cl_uint>(0));
+        ASSERT_CL(err);
+        err = gemmkernel.setArg(12, static_cast<cl_uint>(0));
+        ASSERT_CL(err);
+        err = gemmkernel.setArg(13, static_cast<cl_uint>(count));
+        ASSERT_CL(err);
+        err = gemmkernel.setArg(14, static_cast<cl_uint>(stride));
+        ASSERT_CL(err);
+        gemmkernels.push_back(gemmkernel);
+
+        compute_queues.push_back(cl::CommandQueue(*config.context, *config.device, profiling::PROFILING_QUEUE_PROPERTIES, &err));
+        ASSERT_CL(err)
+    }
+
+    /* --- Execute actual benchmark kernels --- */
+
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+    auto counters = initialize_kernel_counters(config, gemmkernels);
+#endif
+    std::vector<double> executionTimes;
+    profiling::EventProfiler profiler;
+    for (int rep = 0; rep < config.programSettings->numRepetitions; rep++) {
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+        counters->reset(compute_queues[0]);
+#endif
+        auto t1 = std::chrono::high_resolution_clock::now();
+        for (size_t i=0; i < gemmkernels.size(); i++) {
+            size_t offset = first_matrix[i] * stride;
+            cl::Event write_a_event;
+            cl::Event write_b_event;
+            cl::Event write_c_event;
+            ASSERT_CL(compute_queues[i].enqueueWriteBuffer(a_buffers[i], CL_FALSE, 0, part_bytes[i], &a[offset], NULL, &write_a_event))
+            ASSERT_CL(compute_queues[i].enqueueWriteBuffer(b_buffers[i], CL_FALSE, 0, part_bytes[i], &b[offset], NULL, &write_b_event))
+            ASSERT_CL(compute_queues[i].enqueueWriteBuffer(c_buffers[i], CL_FALSE, 0, part_bytes[i], &c[offset], NULL, &write_c_event))
+            profiler.record("write_A", i, write_a_event);
+            profiler.record("write_B", i, write_b_event);
+            profiler.record("write_C", i, write_c_event);
+            // The queues are in-order, so the kernel starts after the transfers are completed
+            cl::Event kernel_event;
+            ASSERT_CL(compute_queues[i].enqueueNDRangeKernel(gemmkernels[i], cl::NullRange, cl::NDRange(1), cl::NullRange, NULL, &kernel_event))
+            profiler.record("kernel", i, kernel_event);
+            cl::Event read_event;
+            ASSERT_CL(compute_queues[i].enqueueReadBuffer(out_buffers[i], CL_FALSE, 0, part_bytes[i], &c_out[offset], NULL, &read_event))
+            profiler.record("read_C", i, read_event);
+        }
+        for (auto &q : compute_queues) {
+            q.finish();
+        }
+        auto t2 = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> timespan = t2 - t1;
+        executionTimes.push_back(timespan.count());
+        profiler.collect(rep);
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+        counters->read(compute_queues[0]);
+        counters->print(rep);
+#endif
+    }
+
+    std::unique_ptr<gemm::GEMMExecutionTimings> results(
+                    new gemm::GEMMExecutionTimings{executionTimes, profiler.timings});
+    return results;
+#endif
+}
+
+template std::unique_ptr<gemm::GEMMExecutionTimings>
+calculate<half_float::half>(hpcc_base::ExecutionSettings<gemm::GEMMProgramSettings> const& config, half_float::half* a, half_float::half* b, half_float::half* c, half_float::half* c_out,
+        half_float::half alpha, half_float::half beta);
+
+template std::unique_ptr<gemm::GEMMExecutionTimings>
+calculate<cl_float>(hpcc_base::ExecutionSettings<gemm::GEMMProgramSettings> const& config, cl_float* a, cl_float* b, cl_float* c, cl_float* c_out,
+        cl_float alpha, cl_float beta);
+
+template std::unique_ptr<gemm::GEMMExecutionTimings>
+calculate<cl_double>(hpcc_base::ExecutionSettings<gemm::GEMMProgramSettings> const& config, cl_double* a, cl_double* b, cl_double* c, cl_double* c_out,
+        cl_double alpha, cl_double beta);
+
 }  // namespace bm_execution
@@ -28,60 +28,138 @@ SOFTWARE.
 
 /* C++ standard library headers */
 #include <memory>
-#include <random>
+#include <stdexcept>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define GEMM_REF_X86
+#include <immintrin.h>
+#endif
 
 /* Project's headers */
+#include "counter_rng.hpp"
 #include "execution.h"
+#include "half_conversion.hpp"
 #include "parameters.h"
 
 gemm::GEMMProgramSettings::GEMMProgramSettings(cxxopts::ParseResult &results) : hpcc_base::BaseSettings(results),
     matrixSize(results["b"].as<uint>() * results["m"].as<uint>()), blockSize(results["b"].as<uint>()), kernelReplications(results["r"].as<uint>()),
-    replicateInputBuffers(results["replicate-inputs"].count() > 0) {
+    replicateInputBuffers(results["replicate-inputs"].count() > 0), tileSizeInBlocks(results["tile-blocks"].as<uint>()),
+    distributed(results.count("distributed") > 0), torus_row(0), torus_col(0), torus_width(1),
+    batchCount(results["batch"].as<uint>()), batchStride(results["batch-stride"].as<uint>()),
+    matrixSizeK(results["b"].as<uint>() * results["k-blocks"].as<uint>()), matrixSizeN(results["b"].as<uint>() * results["n-blocks"].as<uint>()),
+    transposeA(results.count("transpose-a") > 0), transposeB(results.count("transpose-b") > 0),
+    dataType(hpcc_base::retrieveDataType(results["data-type"].as<std::string>())) {
+    // Use square matrices by default
+    if (matrixSizeK == 0) {
+        matrixSizeK = matrixSize;
+    }
+    if (matrixSizeN == 0) {
+        matrixSizeN = matrixSize;
+    }
+    if (!isSquare() && (batchCount > 1 || tileSizeInBlocks > 0 || distributed)) {
+        throw std::runtime_error("Non-square or transposed matrices are not supported in the batched, out-of-core or distributed execution!");
+    }
+    if (batchStride == 0) {
+        batchStride = matrixSize * matrixSize;
+    }
+    if (batchStride < matrixSize * matrixSize) {
+        throw std::runtime_error("The batch stride has to be at least the number of values of a single matrix!");
+    }
+    if (batchCount > 1 && (tileSizeInBlocks > 0 || distributed)) {
+        throw std::runtime_error("The batched mode can not be combined with the out-of-core or distributed execution!");
+    }
+    if (tileSizeInBlocks > 0 && (matrixSize / blockSize) % tileSizeInBlocks != 0) {
+        throw std::runtime_error("The matrix size in blocks has to be a multiple of the tile size!");
+    }
+    if (distributed) {
+#ifdef _USE_MPI_
+        int mpi_comm_rank;
+        int mpi_comm_size;
+        MPI_Comm_rank(MPI_COMM_WORLD, &mpi_comm_rank);
+        MPI_Comm_size(MPI_COMM_WORLD, &mpi_comm_size);
+        // calculate the row and column of the MPI rank in the torus
+        torus_width = static_cast<int>(std::sqrt(mpi_comm_size));
+        torus_row = mpi_comm_rank / torus_width;
+        torus_col = mpi_comm_rank % torus_width;
+        if (torus_width * torus_width != mpi_comm_size) {
+            throw std::runtime_error("The distributed GEMM requires a square number of MPI ranks!");
+        }
+        if (tileSizeInBlocks > 0) {
+            throw std::runtime_error("The distributed GEMM can not be combined with the out-of-core execution!");
+        }
+#else
+        throw std::runtime_error("The distributed GEMM requires a build with MPI support!");
+#endif
+    }
+}
 
+bool
+gemm::GEMMProgramSettings::isSquare() const {
+    return matrixSizeK == matrixSize && matrixSizeN == matrixSize && !transposeA && !transposeB;
 }
 
 std::map<std::string, std::string>
 gemm::GEMMProgramSettings::getSettingsMap() {
         auto map = hpcc_base::BaseSettings::getSettingsMap();
-        map["Matrix Size"] = std::to_string(matrixSize);
+        map["Matrix Size"] = isSquare() ? std::to_string(matrixSize * torus_width) :
+                                std::to_string(matrixSize) + " x " + std::to_string(matrixSizeK) + " x " + std::to_string(matrixSizeN) + " (M x K x N)";
+        map["Data Type"] = hpcc_base::dataTypeToString(dataType);
+        map["Transposed Inputs"] = (transposeA) ? ((transposeB) ? "A, B" : "A") : ((transposeB) ? "B" : "None");
+        map["Distributed"] = distributed ? "SUMMA on " + std::to_string(torus_width) + "x" + std::to_string(torus_width) + " ranks" : "No";
         map["Kernel Replications"] = std::to_string(kernelReplications);
         map["Replicate Inputs"] = replicateInputBuffers ? "Yes" : "No";
+        map["Batch Size"] = (batchCount > 1) ? std::to_string(batchCount) + " (stride " + std::to_string(batchStride) + ")" : "Disabled";
+        map["Out-of-core Tile Size"] = (tileSizeInBlocks > 0) ? std::to_string(tileSizeInBlocks * blockSize) : "Disabled";
         return map;
 }
 
-gemm::GEMMData::GEMMData(cl::Context context, uint size) : normtotal(0.0), alpha(0.5), beta(2.0), context(context) {
+template<typename T>
+gemm::TypedGEMMData<T>::TypedGEMMData(cl::Context context, hpcc_base::DataType dataType, uint size, uint batch, size_t stride) : TypedGEMMData(context, dataType, size, size, size, batch, stride) {}
+
+template<typename T>
+gemm::TypedGEMMData<T>::TypedGEMMData(cl::Context context, hpcc_base::DataType dataType, uint m, uint k, uint n, uint batch, size_t stride) : GEMMData(context, dataType),
+                normtotal(static_cast<T>(0.0)), alpha(static_cast<T>(0.5)), beta(static_cast<T>(2.0)) {
+    // The last matrix of a batch does not require the padding of the stride
+    size_t a_elements = (stride == 0) ? static_cast<size_t>(batch) * m * k : (batch - 1) * stride + static_cast<size_t>(m) * k;
+    size_t b_elements = (stride == 0) ? static_cast<size_t>(batch) * k * n : (batch - 1) * stride + static_cast<size_t>(k) * n;
+    size_t c_elements = (stride == 0) ? static_cast<size_t>(batch) * m * n : (batch - 1) * stride + static_cast<size_t>(m) * n;
 #ifdef USE_SVM
-    A = reinterpret_cast<HOST_DATA_TYPE*>(
+    A = reinterpret_cast<T*>(
                         clSVMAlloc(context(), 0 ,
-                        size * size * sizeof(HOST_DATA_TYPE), 1024));
-    B = reinterpret_cast<HOST_DATA_TYPE*>(
+                        a_elements * sizeof(T), 1024));
+    B = reinterpret_cast<T*>(
                         clSVMAlloc(context(), 0 ,
-                        size * size * sizeof(HOST_DATA_TYPE), 1024));
-    C = reinterpret_cast<HOST_DATA_TYPE*>(
+                        b_elements * sizeof(T), 1024));
+    C = reinterpret_cast<T*>(
                         clSVMAlloc(context(), 0 ,
-                        size * size * sizeof(HOST_DATA_TYPE), 1024));
-    C_out = reinterpret_cast<HOST_DATA_TYPE*>(
+                        c_elements * sizeof(T), 1024));
+    C_out = reinterpret_cast<T*>(
                         clSVMAlloc(context(), 0 ,
-                        size * size * sizeof(HOST_DATA_TYPE), 1024));
+                        c_elements * sizeof(T), 1024));
 #else
-    posix_memalign(reinterpret_cast<void**>(&A), 4096, size * size * sizeof(HOST_DATA_TYPE));
-    posix_memalign(reinterpret_cast<void**>(&B), 4096, size * size * sizeof(HOST_DATA_TYPE));
-    posix_memalign(reinterpret_cast<void**>(&C), 4096, size * size * sizeof(HOST_DATA_TYPE));
-    posix_memalign(reinterpret_cast<void**>(&C_out), 4096, size * size * sizeof(HOST_DATA_TYPE));
+    numa::memalign(reinterpret_cast<void**>(&A), 4096, a_elements * sizeof(T));
+    numa::memalign(reinterpret_cast<void**>(&B), 4096, b_elements * sizeof(T));
+    numa::memalign(reinterpret_cast<void**>(&C), 4096, c_elements * sizeof(T));
+    numa::memalign(reinterpret_cast<void**>(&C_out), 4096, c_elements * sizeof(T));
 #endif
 }
 
-gemm::GEMMData::~GEMMData() {
+template<typename T>
+gemm::TypedGEMMData<T>::~TypedGEMMData() {
 #ifdef USE_SVM
     clSVMFree(context(), reinterpret_cast<void**>(A));
     clSVMFree(context(), reinterpret_cast<void**>(B));
     clSVMFree(context(), reinterpret_cast<void**>(C));
     clSVMFree(context(), reinterpret_cast<void**>(C_out));
 #else
-    free(A);
-    free(B);
-    free(C);
-    free(C_out);
+    numa::free(A);
+    numa::free(B);
+    numa::free(C);
+    numa::free(C_out);
 #endif
 }
 
@@ -96,11 +174,61 @@ gemm::GEMMBenchmark::addAdditionalParseOptions(cxxopts::Options &options) {
              cxxopts::value<cl_uint>()->default_value(std::to_string(DEFAULT_MATRIX_SIZE)))
             ("b", "Block size in number of values in one dimension",
              cxxopts::value<cl_uint>()->default_value(std::to_string(BLOCK_SIZE)))
-            ("replicate-inputs", "Also replicates the input buffer for each kernel");
+            ("replicate-inputs", "Also replicates the input buffer for each kernel")
+            ("tile-blocks", "Size of the tiles in number of blocks in one dimension for the out-of-core execution. Only tiles of the matrices are stored on the device and the measured time includes all transfers. 0 disables the out-of-core execution",
+             cxxopts::value<cl_uint>()->default_value("0"))
+            ("batch", "Number of independent matrix multiplications that are calculated with a single kernel execution",
+             cxxopts::value<cl_uint>()->default_value("1"))
+            ("batch-stride", "Distance between two matrices of a batch in number of values. 0 stores the matrices without gaps",
+             cxxopts::value<cl_uint>()->default_value("0"))
+            ("k-blocks", "Number of columns of op(A) and rows of op(B) in number of blocks. 0 uses the matrix size given with -m",
+             cxxopts::value<cl_uint>()->default_value("0"))
+            ("n-blocks", "Number of columns of op(B) and C in number of blocks. 0 uses the matrix size given with -m",
+             cxxopts::value<cl_uint>()->default_value("0"))
+            ("transpose-a", "Use the transposed matrix A in the calculation: C = alpha * A^T * op(B) + beta * C")
+            ("transpose-b", "Use the transposed matrix B in the calculation: C = alpha * op(A) * B^T + beta * C")
+            ("distributed", "Calculate a single GEMM distributed over all MPI ranks. The ranks are arranged in a square torus and the matrix size is given per rank")
+            ("data-type", "Data type of the matrices. Valid values: HALF, FLOAT, DOUBLE or AUTO to use the data type of the kernels in the bitstream",
+             cxxopts::value<std::string>()->default_value("AUTO"));
+}
+
+void
+gemm::GEMMBenchmark::adaptSettingsToBitstream() {
+    auto &settings = *executionSettings->programSettings;
+    hpcc_base::DataType detected = hpcc_base::DataType::automatic;
+    if (executionSettings->program) {
+        detected = hpcc_base::detectDataType(*executionSettings->program, hpcc_base::DataType::automatic);
+    }
+    if (settings.dataType == hpcc_base::DataType::automatic) {
+        // The data type of the build is used, if the argument types are not available
+        settings.dataType = (detected != hpcc_base::DataType::automatic) ? detected :
+                            (sizeof(HOST_DATA_TYPE) == 2) ? hpcc_base::DataType::half_precision :
+                            (sizeof(HOST_DATA_TYPE) == 4) ? hpcc_base::DataType::single_precision : hpcc_base::DataType::double_precision;
+    }
+    else if (detected != hpcc_base::DataType::automatic && detected != settings.dataType
+                && settings.communicationType != hpcc_base::CommunicationType::cpu_only) {
+        // Only the CPU execution can use a different data type than the kernels
+        throw std::runtime_error("The data type " + hpcc_base::dataTypeToString(settings.dataType) + " does not match the data type "
+                                    + hpcc_base::dataTypeToString(detected) + " of the kernels!");
+    }
 }
 
 std::unique_ptr<gemm::GEMMExecutionTimings>
 gemm::GEMMBenchmark::executeKernel(GEMMData &data) {
+    switch (data.dataType) {
+        case hpcc_base::DataType::half_precision: return executeTypedKernel(data.as<half_float::half>());
+        case hpcc_base::DataType::single_precision: return executeTypedKernel(data.as<cl_float>());
+        case hpcc_base::DataType::double_precision: return executeTypedKernel(data.as<cl_double>());
+        default: throw std::runtime_error("Data type " + hpcc_base::dataTypeToString(data.dataType) + " is not supported by the benchmark!");
+    }
+}
+
+template<typename T>
+std::unique_ptr<gemm::GEMMExecutionTimings>
+gemm::GEMMBenchmark::executeTypedKernel(TypedGEMMData<T> &data) {
+    if (executionSettings->programSettings->communicationType == hpcc_base::CommunicationType::cpu_only) {
+        return bm_execution::calculate_cpu(*executionSettings, data.A, data.B, data.C, data.C_out, data.alpha, data.beta);
+    }
     return bm_execution::calculate(*executionSettings, data.A, data.B, data.C, data.C_out, data.alpha, data.beta);
 }
 
@@ -117,6 +245,7 @@ gemm::GEMMBenchmark::collectAndPrintResults(const gemm::GEMMExecutionTimings &ou
 #else
     std::copy(output.timings.begin(), output.timings.end(), avg_measures.begin());
 #endif
+    avg_measures = discardWarmup(avg_measures);
     if (mpi_comm_rank == 0) {
         std::cout << std::setw(ENTRY_SPACE)
                 << "best" << std::setw(ENTRY_SPACE) << "mean"
@@ -126,9 +255,13 @@ gemm::GEMMBenchmark::collectAndPrintResults(const gemm::GEMMExecutionTimings &ou
         double tmean = 0;
         double tmin = std::numeric_limits<double>::max();
 
-        double gflops = mpi_comm_size * 2.0 * (static_cast<double>(executionSettings->programSettings->matrixSize)
-                            *static_cast<double>(executionSettings->programSettings->matrixSize)
-                            *static_cast<double>(executionSettings->programSettings->matrixSize))/1.0e9;
+        // In the distributed mode, all ranks calculate a single GEMM with the width of the torus times the local matrix size
+        double total_matrix_size = static_cast<double>(executionSettings->programSettings->matrixSize) * executionSettings->programSettings->torus_width;
+        double gflops = (executionSettings->programSettings->distributed) ? 2.0 * total_matrix_size * total_matrix_size * total_matrix_size / 1.0e9 : mpi_comm_size * 2.0 * (static_cast<double>(executionSettings->programSettings->matrixSize)
+                            *static_cast<double>(executionSettings->programSettings->matrixSizeK)
+                            *static_cast<double>(executionSettings->programSettings->matrixSizeN))/1.0e9;
+        // All matrix multiplications of a batch are included in a single measurement
+        gflops *= executionSettings->programSettings->batchCount;
         for (double currentTime : avg_measures) {
             tmean +=  currentTime;
             if (currentTime < tmin) {
@@ -137,44 +270,174 @@ gemm::GEMMBenchmark::collectAndPrintResults(const gemm::GEMMExecutionTimings &ou
         }
         tmean = tmean / avg_measures.size();
 
+        timings.emplace("execution", avg_measures);
+        for (const auto& t : profiling::toTimingsMap(output.deviceTimings)) {
+            timings.emplace("device_" + t.first, discardWarmup(t.second));
+        }
+        results.emplace("t_min", hpcc_base::HpccResult(tmin, "s"));
+        results.emplace("t_mean", hpcc_base::HpccResult(tmean, "s"));
+        results.emplace("gflops", hpcc_base::HpccResult(gflops / tmin, "GFLOP/s"));
+
+        // Estimate the global memory traffic of the blocked multiplication: A is read once for every block column of C,
+        // B once for every block row of C and C is read and written once
+        double m = executionSettings->programSettings->matrixSize;
+        double k = executionSettings->programSettings->matrixSizeK;
+        double n = executionSettings->programSettings->matrixSizeN;
+        double block_size = executionSettings->programSettings->blockSize;
+        double element_bytes = hpcc_base::dataTypeSize(executionSettings->programSettings->dataType);
+        double intensity = (2.0 * m * k * n) / (element_bytes * (m * k * n / block_size + k * n * m / block_size + 2.0 * m * n));
+        results.emplace("arithmetic_intensity", hpcc_base::HpccResult(intensity, "FLOP/Byte"));
+
         std::cout << std::setw(ENTRY_SPACE)
                 << tmin << std::setw(ENTRY_SPACE) << tmean
                 << std::setw(ENTRY_SPACE) << gflops / tmin
                 << std::endl;
+
+        if (executionSettings->programSettings->batchCount > 1) {
+            double tmatrix = tmin / executionSettings->programSettings->batchCount;
+            results.emplace("t_matrix", hpcc_base::HpccResult(tmatrix, "s"));
+            std::cout << "Time per matrix multiplication: " << tmatrix << " s" << std::endl;
+        }
+        addStatistics("t", avg_measures);
     }
 }
 
 std::unique_ptr<gemm::GEMMData>
 gemm::GEMMBenchmark::generateInputData() {
-    auto d = std::unique_ptr<gemm::GEMMData>(new gemm::GEMMData(*executionSettings->context, executionSettings->programSettings->matrixSize));
-    std::mt19937 gen(7);
-    std::uniform_real_distribution<> dis(-1.0, 1.0);
-    for (int j = 0; j < executionSettings->programSettings->matrixSize; j++) {
-        for (int i = 0; i < executionSettings->programSettings->matrixSize; i++) {
-            d->A[executionSettings->programSettings->matrixSize*i+j] = OPTIONAL_CAST(static_cast<double>(dis(gen)));
-            d->B[executionSettings->programSettings->matrixSize*i+j] = OPTIONAL_CAST(static_cast<double>(dis(gen)));
-            d->C[executionSettings->programSettings->matrixSize*i+j] = OPTIONAL_CAST(static_cast<double>(dis(gen)));
-            d->C_out[executionSettings->programSettings->matrixSize*i+j] = OPTIONAL_CAST(0.0);
-            d->normtotal = std::max(std::max(d->normtotal, d->A[executionSettings->programSettings->matrixSize*i+j]), 
-                                        std::max(d->B[executionSettings->programSettings->matrixSize*i+j], 
-                                        d->C[executionSettings->programSettings->matrixSize*i+j]));
+    switch (executionSettings->programSettings->dataType) {
+        case hpcc_base::DataType::half_precision: return generateTypedInputData<half_float::half>();
+        case hpcc_base::DataType::single_precision: return generateTypedInputData<cl_float>();
+        case hpcc_base::DataType::double_precision: return generateTypedInputData<cl_double>();
+        default: throw std::runtime_error("Data type " + hpcc_base::dataTypeToString(executionSettings->programSettings->dataType) + " is not supported by the benchmark!");
+    }
+}
+
+template<typename T>
+std::unique_ptr<gemm::GEMMData>
+gemm::GEMMBenchmark::generateTypedInputData() {
+    auto &settings = *executionSettings->programSettings;
+    auto d = new gemm::TypedGEMMData<T>(*executionSettings->context, settings.dataType, settings.matrixSize, settings.matrixSizeK,
+                                            settings.matrixSizeN, settings.batchCount, settings.batchStride);
+    // Every rank holds a different part of the matrices in the distributed mode.
+    // The values are calculated from the index of the element with a counter-based RNG, so the
+    // matrices can be filled in parallel and do not depend on the number of threads.
+    const uint64_t seed = 7;
+    const uint64_t stream = (settings.distributed) ? 3 * static_cast<uint64_t>(mpi_comm_rank) : 0;
+    size_t a_elements = static_cast<size_t>(settings.matrixSize) * settings.matrixSizeK;
+    size_t b_elements = static_cast<size_t>(settings.matrixSizeK) * settings.matrixSizeN;
+    size_t c_elements = static_cast<size_t>(settings.matrixSize) * settings.matrixSizeN;
+    double norm = 0.0;
+    for (size_t b = 0; b < settings.batchCount; b++) {
+        size_t offset = b * settings.batchStride;
+#pragma omp parallel for reduction(max:norm)
+        for (size_t i = offset; i < offset + a_elements; i++) {
+            d->A[i] = static_cast<T>(rng::uniform(seed, stream, i, -1.0, 1.0));
+            norm = std::max(norm, static_cast<double>(d->A[i]));
+        }
+#pragma omp parallel for reduction(max:norm)
+        for (size_t i = offset; i < offset + b_elements; i++) {
+            d->B[i] = static_cast<T>(rng::uniform(seed, stream + 1, i, -1.0, 1.0));
+            norm = std::max(norm, static_cast<double>(d->B[i]));
+        }
+#pragma omp parallel for reduction(max:norm)
+        for (size_t i = offset; i < offset + c_elements; i++) {
+            d->C[i] = static_cast<T>(rng::uniform(seed, stream + 2, i, -1.0, 1.0));
+            d->C_out[i] = static_cast<T>(0.0);
+            norm = std::max(norm, static_cast<double>(d->C[i]));
         }
     }
-    return d;
+    d->normtotal = static_cast<T>(norm);
+    return std::unique_ptr<gemm::GEMMData>(d);
+}
+
+std::vector<memory_tracker::MemoryRequirement>
+gemm::GEMMBenchmark::estimateMemoryUsage() {
+    const auto &settings = *executionSettings->programSettings;
+    size_t value_size = hpcc_base::dataTypeSize(settings.dataType);
+    size_t batch = settings.batchCount;
+    size_t stride = settings.batchStride;
+    size_t a_elements = static_cast<size_t>(settings.matrixSize) * settings.matrixSizeK;
+    size_t b_elements = static_cast<size_t>(settings.matrixSizeK) * settings.matrixSizeN;
+    size_t c_elements = static_cast<size_t>(settings.matrixSize) * settings.matrixSizeN;
+    // Same sizes as allocated by TypedGEMMData
+    size_t a_bytes = ((stride == 0) ? batch * a_elements : (batch - 1) * stride + a_elements) * value_size;
+    size_t b_bytes = ((stride == 0) ? batch * b_elements : (batch - 1) * stride + b_elements) * value_size;
+    size_t c_bytes = ((stride == 0) ? batch * c_elements : (batch - 1) * stride + c_elements) * value_size;
+    std::vector<memory_tracker::MemoryRequirement> requirements = {
+        {"A", a_bytes, 1, false}, {"B", b_bytes, 1, false}, {"C, C_out", c_bytes, 2, false}};
+    if (!settings.skipValidation) {
+        // The validation generates the input data again to calculate the reference result
+        requirements.push_back({"Reference A, B", a_bytes + b_bytes, 1, false});
+        requirements.push_back({"Reference C, C_out", c_bytes, 2, false});
+        if (settings.distributed) {
+            // The blocks of A of the torus row and the blocks of B of the torus column
+            requirements.push_back({"Gathered A, B", (a_elements + b_elements) * value_size, static_cast<size_t>(settings.torus_width), false});
+        }
+    }
+    if (settings.communicationType != hpcc_base::CommunicationType::cpu_only) {
+        size_t input_copies = settings.replicateInputBuffers ? settings.kernelReplications : 1;
+        requirements.push_back({"A, B, C", a_bytes + b_bytes + c_bytes, input_copies, true});
+        requirements.push_back({"C_out", c_bytes, 1, true});
+    }
+    return requirements;
 }
 
 bool  
 gemm::GEMMBenchmark::validateOutputAndPrintError(gemm::GEMMData &data) {
-    auto ref_data = generateInputData();
+    switch (data.dataType) {
+        case hpcc_base::DataType::half_precision: return validateTypedOutputAndPrintError(data.as<half_float::half>());
+        case hpcc_base::DataType::single_precision: return validateTypedOutputAndPrintError(data.as<cl_float>());
+        case hpcc_base::DataType::double_precision: return validateTypedOutputAndPrintError(data.as<cl_double>());
+        default: throw std::runtime_error("Data type " + hpcc_base::dataTypeToString(data.dataType) + " is not supported by the benchmark!");
+    }
+}
 
-    gemm_ref(ref_data->A, ref_data->B, ref_data->C, executionSettings->programSettings->matrixSize, OPTIONAL_CAST(0.5), OPTIONAL_CAST(2.0));
+template<typename T>
+bool  
+gemm::GEMMBenchmark::validateTypedOutputAndPrintError(gemm::TypedGEMMData<T> &data) {
+    auto ref_data_ptr = generateInputData();
+    auto &ref_data = ref_data_ptr->as<T>();
+
+    if (!executionSettings->programSettings->distributed) {
+        for (size_t b = 0; b < executionSettings->programSettings->batchCount; b++) {
+            size_t offset = b * executionSettings->programSettings->batchStride;
+            gemm_ref(ref_data.A + offset, ref_data.B + offset, ref_data.C + offset, executionSettings->programSettings->matrixSize,
+                        executionSettings->programSettings->matrixSizeK, executionSettings->programSettings->matrixSizeN,
+                        static_cast<T>(0.5), static_cast<T>(2.0), executionSettings->programSettings->transposeA, executionSettings->programSettings->transposeB);
+        }
+    }
+#ifdef _USE_MPI_
+    else {
+        // Collect the blocks of A in the same torus row and the blocks of B in the same torus column
+        // to calculate the reference result for the local block of C
+        const size_t block_elements = static_cast<size_t>(executionSettings->programSettings->matrixSize) * executionSettings->programSettings->matrixSize;
+        const int block_bytes = block_elements * sizeof(T);
+        MPI_Comm row_communicator;
+        MPI_Comm_split(MPI_COMM_WORLD, executionSettings->programSettings->torus_row, executionSettings->programSettings->torus_col, &row_communicator);
+        MPI_Comm col_communicator;
+        MPI_Comm_split(MPI_COMM_WORLD, executionSettings->programSettings->torus_col, executionSettings->programSettings->torus_row, &col_communicator);
+        std::vector<T> a_row(block_elements * executionSettings->programSettings->torus_width);
+        std::vector<T> b_col(block_elements * executionSettings->programSettings->torus_width);
+        MPI_Allgather(ref_data.A, block_bytes, MPI_BYTE, a_row.data(), block_bytes, MPI_BYTE, row_communicator);
+        MPI_Allgather(ref_data.B, block_bytes, MPI_BYTE, b_col.data(), block_bytes, MPI_BYTE, col_communicator);
+        MPI_Comm_free(&row_communicator);
+        MPI_Comm_free(&col_communicator);
+        for (int k = 0; k < executionSettings->programSettings->torus_width; k++) {
+            gemm_ref(&a_row[k * block_elements], &b_col[k * block_elements], ref_data.C, executionSettings->programSettings->matrixSize,
+                        static_cast<T>(0.5), (k == 0) ? static_cast<T>(2.0) : static_cast<T>(1.0));
+        }
+    }
+#endif
 
-    double resid = OPTIONAL_CAST(0.0);
-    double normx = OPTIONAL_CAST(0.0);
+    double resid = 0.0;
+    double normx = 0.0;
 
-    for (int i = 0; i < executionSettings->programSettings->matrixSize * executionSettings->programSettings->matrixSize; i++) {
-        resid = (resid > fabs(data.C_out[i] - ref_data->C[i])) ? resid : fabs(data.C_out[i] - ref_data->C[i]);
-        normx = (normx > fabs(data.C_out[i])) ? normx : fabs(data.C_out[i]);
+    for (size_t b = 0; b < executionSettings->programSettings->batchCount; b++) {
+        size_t offset = b * executionSettings->programSettings->batchStride;
+        for (size_t i = offset; i < offset + executionSettings->programSettings->matrixSize * executionSettings->programSettings->matrixSizeN; i++) {
+            resid = (resid > std::fabs(static_cast<double>(data.C_out[i]) - static_cast<double>(ref_data.C[i]))) ? resid : std::fabs(static_cast<double>(data.C_out[i]) - static_cast<double>(ref_data.C[i]));
+            normx = (normx > std::fabs(static_cast<double>(data.C_out[i]))) ? normx : std::fabs(static_cast<double>(data.C_out[i]));
+        }
     }
 
 #ifdef _USE_MPI_
@@ -186,8 +449,12 @@ gemm::GEMMBenchmark::validateOutputAndPrintError(gemm::GEMMData &data) {
     // Calculate the overall error only on rank 0
     if (mpi_comm_rank == 0) {
         // Calculate the residual error normalized to the total matrix size, input values and machine epsilon
-        double eps = std::numeric_limits<HOST_DATA_TYPE>::epsilon();
-        double residn = resid / (executionSettings->programSettings->matrixSize*executionSettings->programSettings->matrixSize*ref_data->normtotal*normx*eps);
+        double eps = static_cast<double>(std::numeric_limits<T>::epsilon());
+        // For non-square matrices, the largest dimension is used
+        double total_matrix_size = static_cast<double>(std::max(executionSettings->programSettings->matrixSize,
+                                        std::max(executionSettings->programSettings->matrixSizeK, executionSettings->programSettings->matrixSizeN)))
+                                        * executionSettings->programSettings->torus_width;
+        double residn = resid / (total_matrix_size*total_matrix_size*static_cast<double>(ref_data.normtotal)*normx*eps);
 
         std::cout << "  norm. resid        resid       "\
                     "machep" << std::endl;
@@ -202,72 +469,423 @@ gemm::GEMMBenchmark::validateOutputAndPrintError(gemm::GEMMData &data) {
     return true;
 }
 
-void 
-gemm::gemm_ref(HOST_DATA_TYPE* a,HOST_DATA_TYPE* b, HOST_DATA_TYPE* c,
-                                int n, HOST_DATA_TYPE alpha, HOST_DATA_TYPE beta) {
-#ifdef _USE_BLAS_
-    char ta = 'N';
-    char tb = 'N';
-#endif
-#if (defined(_USE_BLAS_) && DATA_TYPE_SIZE == 2) 
-        // convert matrices to single precision to allow the use of BLAS routine
-        std::unique_ptr<float[]> temp_a = std::unique_ptr<float[]>(new float[n * n]);
-        std::unique_ptr<float[]> temp_b = std::unique_ptr<float[]>(new float[n * n]);
-        std::unique_ptr<float[]> temp_c = std::unique_ptr<float[]>(new float[n * n]);
-        for (int i=0; i < n; i++) {
-            for (int j=0; j < n; j++) {
-                temp_a[i * n + j] = half_float::half_cast<float, half_float::half>(a[i*n + j]);
-                temp_b[i * n + j] = half_float::half_cast<float, half_float::half>(b[i*n + j]);
-                temp_c[i * n + j] = half_float::half_cast<float, half_float::half>(c[i*n + j]);
+namespace {
+
+/**
+ * @brief Data type used for the accumulation in the reference implementation.
+ *          Half precision values are converted to single precision while packing the blocks.
+ */
+template<typename T>
+struct RefComputeType {
+    typedef float type;
+};
+
+template<>
+struct RefComputeType<cl_double> {
+    typedef double type;
+};
+
+/**
+ * @brief Number of rows of C that are calculated by the micro kernel
+ */
+const int REF_MR = 6;
+
+/**
+ * @brief Number of columns of C that are calculated by the micro kernel.
+ *          Two AVX2 or one AVX-512 vector register per row.
+ */
+template<typename C>
+struct RefNR {
+    static const int value = 64 / sizeof(C);
+};
+
+/**
+ * @brief Size of the blocks of A, B and C that are packed into contiguous buffers.
+ *          REF_MC and REF_NC have to be multiples of REF_MR and RefNR.
+ */
+const int REF_MC = 96;
+const int REF_NC = 256;
+const int REF_KC = 256;
+
+/**
+ * @brief Convert a contiguous row of values to the compute type
+ */
+template<typename T, typename C>
+inline void
+convert_row(const T* src, C* dst, int count) {
+    for (int i = 0; i < count; i++) {
+        dst[i] = static_cast<C>(src[i]);
+    }
+}
+
+/**
+ * @brief Convert a contiguous row of half precision values to single precision with the SIMD conversion of the host
+ */
+template<>
+inline void
+convert_row<half_float::half, float>(const half_float::half* src, float* dst, int count) {
+    // half_float::half only contains the 16 bit representation of the value
+    half_conversion::halfToFloat(reinterpret_cast<const uint16_t*>(src), dst, count);
+}
+
+/**
+ * @brief Convert a contiguous row of single precision values back to half precision with the SIMD conversion of the host
+ */
+template<>
+inline void
+convert_row<float, half_float::half>(const float* src, half_float::half* dst, int count) {
+    half_conversion::floatToHalf(src, reinterpret_cast<uint16_t*>(dst), count);
+}
+
+/**
+ * @brief Function used for the conversion of rows while packing
+ */
+template<typename T, typename C>
+using convert_row_t = void (*)(const T*, C*, int);
+
+/**
+ * @brief Pack a block of op(A) into strips of REF_MR rows, so the micro kernel can read the values of a column contiguously.
+ *          Missing rows are filled with zeros. A transposed matrix is still read row by row.
+ */
+template<typename T, typename C>
+void
+pack_a(const T* a, int lda, int mc, int kc, bool transposed, C* packed, C* row, convert_row_t<T, C> convert) {
+    if (transposed) {
+        for (int k = 0; k < kc; k++) {
+            convert(a + static_cast<size_t>(k) * lda, row, mc);
+            for (int s = 0; s < mc; s += REF_MR) {
+                C* strip = packed + s * kc + k * REF_MR;
+                for (int r = 0; r < REF_MR; r++) {
+                    strip[r] = (s + r < mc) ? row[s + r] : 0;
+                }
             }
         }
-        float alpha_sp = half_float::half_cast<float, half_float::half>(alpha);
-        float beta_sp = half_float::half_cast<float, half_float::half>(beta);
-        // Use single precision for validation
-        sgemm_(&ta, &tb, &n, &n, &n, &alpha_sp, temp_b.get(), &n, temp_a.get(), &n, &beta_sp, temp_c.get(), &n);
-        // convert the result back to half precision
-        for (int i=0; i < n; i++) {
-            for (int j=0; j < n; j++) {
-                c[i * n + j] = half_float::half_cast<half_float::half, float>(temp_c[i*n + j]);
+        return;
+    }
+    for (int s = 0; s < mc; s += REF_MR) {
+        C* strip = packed + s * kc;
+        for (int r = 0; r < REF_MR; r++) {
+            if (s + r < mc) {
+                convert(a + static_cast<size_t>(s + r) * lda, row, kc);
+                for (int k = 0; k < kc; k++) {
+                    strip[k * REF_MR + r] = row[k];
+                }
             }
-        }
-#endif
-#if (defined(_USE_BLAS_) && DATA_TYPE_SIZE == 4) 
-        // Use single precision for validation
-        sgemm_(&ta, &tb, &n, &n, &n, &alpha, b, &n, a, &n, &beta, c, &n);
-#endif
-#if (defined(_USE_BLAS_) && DATA_TYPE_SIZE == 8) 
-        // use double precision for validation
-        dgemm_(&ta, &tb, &n, &n, &n, &alpha, b, &n, a, &n, &beta, c, &n);
-#endif
-#if (!defined(_USE_BLAS_) || (DATA_TYPE_SIZE != 2 && DATA_TYPE_SIZE != 4 && DATA_TYPE_SIZE != 8)) 
-        // Caclulate manually. Thisi s the default, if BLAS is not found
-        #pragma omp parallel
-        {
-        #pragma omp for
-        for (int i=0; i < n; i++) {
-            for (int j=0; j < n; j++) {
-                c[i * n + j] = beta * c[i*n + j];
+            else {
+                for (int k = 0; k < kc; k++) {
+                    strip[k * REF_MR + r] = 0;
+                }
             }
         }
+    }
+}
 
-#define HOST_MM_BLOCK_SIZE 256
-
-        #pragma omp for collapse(2)
-        for (int i=0; i < n; i+=HOST_MM_BLOCK_SIZE) {
-            for (int j=0; j < n; j+=HOST_MM_BLOCK_SIZE) {
-                for (int k=0; k < n; k+=HOST_MM_BLOCK_SIZE) {
-                     for (int ii=i; ii < std::min(i + HOST_MM_BLOCK_SIZE, n); ii++) {
-                        for (int kk=k; kk < std::min(k + HOST_MM_BLOCK_SIZE, n); kk++) {  
-                            HOST_DATA_TYPE scaled_a =  alpha * a[ii*n + kk];
-                            for (int jj=j; jj < std::min(j + HOST_MM_BLOCK_SIZE, n); jj++) {   
-                                c[ii*n + jj] += scaled_a * b[kk*n + jj];
-                            }
-                        }
-                     }
+/**
+ * @brief Pack a block of op(B) into strips of RefNR columns, so the micro kernel can read the values of a row contiguously.
+ *          Missing columns are filled with zeros. A transposed matrix is still read row by row.
+ */
+template<typename T, typename C>
+void
+pack_b(const T* b, int ldb, int kc, int nc, bool transposed, C* packed, C* row, convert_row_t<T, C> convert) {
+    const int nr = RefNR<C>::value;
+    if (transposed) {
+        for (int t = 0; t < nc; t += nr) {
+            C* strip = packed + t * kc;
+            for (int c = 0; c < nr; c++) {
+                if (t + c < nc) {
+                    convert(b + static_cast<size_t>(t + c) * ldb, row, kc);
+                    for (int k = 0; k < kc; k++) {
+                        strip[k * nr + c] = row[k];
+                    }
                 }
+                else {
+                    for (int k = 0; k < kc; k++) {
+                        strip[k * nr + c] = 0;
+                    }
+                }
+            }
+        }
+        return;
+    }
+    for (int k = 0; k < kc; k++) {
+        convert(b + static_cast<size_t>(k) * ldb, row, nc);
+        for (int t = 0; t < nc; t += nr) {
+            C* strip = packed + t * kc + k * nr;
+            for (int c = 0; c < nr; c++) {
+                strip[c] = (t + c < nc) ? row[t + c] : 0;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Calculate a REF_MR x RefNR tile of the product of the packed strips and add it to the tile of C.
+ */
+template<typename C>
+void
+micro_kernel(int kc, const C* a, const C* b, C* c, int ldc) {
+    const int nr = RefNR<C>::value;
+    C acc[REF_MR][RefNR<C>::value] = {};
+    for (int k = 0; k < kc; k++) {
+        for (int r = 0; r < REF_MR; r++) {
+            C a_val = a[k * REF_MR + r];
+            for (int j = 0; j < nr; j++) {
+                acc[r][j] += a_val * b[k * nr + j];
             }
         }
+    }
+    for (int r = 0; r < REF_MR; r++) {
+        for (int j = 0; j < nr; j++) {
+            c[r * ldc + j] += acc[r][j];
+        }
+    }
+}
+
+#ifdef GEMM_REF_X86
+/**
+ * @brief AVX2 version of the micro kernel that keeps the whole tile of C in 12 vector registers
+ */
+__attribute__((target("avx2,fma"))) void
+micro_kernel_avx2(int kc, const double* a, const double* b, double* c, int ldc) {
+    const int w = 4;
+    const int nr = RefNR<double>::value;
+    __m256d acc[REF_MR][2];
+    for (int r = 0; r < REF_MR; r++) {
+        acc[r][0] = _mm256_setzero_pd();
+        acc[r][1] = _mm256_setzero_pd();
+    }
+    for (int k = 0; k < kc; k++) {
+        __m256d b0 = _mm256_loadu_pd(b + k * nr);
+        __m256d b1 = _mm256_loadu_pd(b + k * nr + w);
+        for (int r = 0; r < REF_MR; r++) {
+            __m256d a_val = _mm256_broadcast_sd(a + k * REF_MR + r);
+            acc[r][0] = _mm256_fmadd_pd(a_val, b0, acc[r][0]);
+            acc[r][1] = _mm256_fmadd_pd(a_val, b1, acc[r][1]);
+        }
+    }
+    for (int r = 0; r < REF_MR; r++) {
+        _mm256_storeu_pd(c + r * ldc, _mm256_add_pd(_mm256_loadu_pd(c + r * ldc), acc[r][0]));
+        _mm256_storeu_pd(c + r * ldc + w, _mm256_add_pd(_mm256_loadu_pd(c + r * ldc + w), acc[r][1]));
+    }
+}
+
+/**
+ * @brief AVX2 version of the micro kernel for single precision
+ */
+__attribute__((target("avx2,fma"))) void
+micro_kernel_avx2(int kc, const float* a, const float* b, float* c, int ldc) {
+    const int w = 8;
+    const int nr = RefNR<float>::value;
+    __m256 acc[REF_MR][2];
+    for (int r = 0; r < REF_MR; r++) {
+        acc[r][0] = _mm256_setzero_ps();
+        acc[r][1] = _mm256_setzero_ps();
+    }
+    for (int k = 0; k < kc; k++) {
+        __m256 b0 = _mm256_loadu_ps(b + k * nr);
+        __m256 b1 = _mm256_loadu_ps(b + k * nr + w);
+        for (int r = 0; r < REF_MR; r++) {
+            __m256 a_val = _mm256_broadcast_ss(a + k * REF_MR + r);
+            acc[r][0] = _mm256_fmadd_ps(a_val, b0, acc[r][0]);
+            acc[r][1] = _mm256_fmadd_ps(a_val, b1, acc[r][1]);
+        }
+    }
+    for (int r = 0; r < REF_MR; r++) {
+        _mm256_storeu_ps(c + r * ldc, _mm256_add_ps(_mm256_loadu_ps(c + r * ldc), acc[r][0]));
+        _mm256_storeu_ps(c + r * ldc + w, _mm256_add_ps(_mm256_loadu_ps(c + r * ldc + w), acc[r][1]));
+    }
+}
+
+/**
+ * @brief AVX-512 version of the micro kernel that uses a single vector register per row of the tile
+ */
+__attribute__((target("avx512f"))) void
+micro_kernel_avx512(int kc, const double* a, const double* b, double* c, int ldc) {
+    const int nr = RefNR<double>::value;
+    __m512d acc[REF_MR];
+    for (int r = 0; r < REF_MR; r++) {
+        acc[r] = _mm512_setzero_pd();
+    }
+    for (int k = 0; k < kc; k++) {
+        __m512d b0 = _mm512_loadu_pd(b + k * nr);
+        for (int r = 0; r < REF_MR; r++) {
+            acc[r] = _mm512_fmadd_pd(_mm512_set1_pd(a[k * REF_MR + r]), b0, acc[r]);
         }
+    }
+    for (int r = 0; r < REF_MR; r++) {
+        _mm512_storeu_pd(c + r * ldc, _mm512_add_pd(_mm512_loadu_pd(c + r * ldc), acc[r]));
+    }
+}
+
+/**
+ * @brief AVX-512 version of the micro kernel for single precision
+ */
+__attribute__((target("avx512f"))) void
+micro_kernel_avx512(int kc, const float* a, const float* b, float* c, int ldc) {
+    const int nr = RefNR<float>::value;
+    __m512 acc[REF_MR];
+    for (int r = 0; r < REF_MR; r++) {
+        acc[r] = _mm512_setzero_ps();
+    }
+    for (int k = 0; k < kc; k++) {
+        __m512 b0 = _mm512_loadu_ps(b + k * nr);
+        for (int r = 0; r < REF_MR; r++) {
+            acc[r] = _mm512_fmadd_ps(_mm512_set1_ps(a[k * REF_MR + r]), b0, acc[r]);
+        }
+    }
+    for (int r = 0; r < REF_MR; r++) {
+        _mm512_storeu_ps(c + r * ldc, _mm512_add_ps(_mm512_loadu_ps(c + r * ldc), acc[r]));
+    }
+}
 #endif
+
+/**
+ * @brief Function type of the micro kernels
+ */
+template<typename C>
+using micro_kernel_t = void (*)(int, const C*, const C*, C*, int);
+
+/**
+ * @brief Select the fastest micro kernel that is supported by the CPU at runtime,
+ *          so the host code does not have to be compiled for a specific CPU.
+ */
+template<typename C>
+micro_kernel_t<C>
+select_micro_kernel() {
+#ifdef GEMM_REF_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return static_cast<micro_kernel_t<C>>(micro_kernel_avx512);
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return static_cast<micro_kernel_t<C>>(micro_kernel_avx2);
+    }
+#endif
+    return micro_kernel<C>;
+}
+
+/**
+ * @brief Select the conversion used for packing
+ */
+template<typename T, typename C>
+convert_row_t<T, C>
+select_convert_row() {
+    return convert_row<T, C>;
+}
+
+}  // namespace
+
+template<typename T>
+void 
+gemm::gemm_ref(T* a,T* b, T* c,
+                                int n, T alpha, T beta) {
+    gemm_ref(a, b, c, n, n, n, alpha, beta, false, false);
 }
+
+template<typename T>
+void 
+gemm::gemm_ref(T* a,T* b, T* c,
+                                int m, int k, int n, T alpha, T beta,
+                                bool transpose_a, bool transpose_b) {
+    typedef typename RefComputeType<T>::type ref_compute_t;
+    const int nr = RefNR<ref_compute_t>::value;
+    int lda = (transpose_a) ? m : k;
+    int ldb = (transpose_b) ? k : n;
+    // Packed and register blocked implementation. This is the default, if BLAS is not found or half precision is used.
+    // Half precision values are converted to single precision while packing the blocks.
+    micro_kernel_t<ref_compute_t> kernel = select_micro_kernel<ref_compute_t>();
+    convert_row_t<T, ref_compute_t> convert = select_convert_row<T, ref_compute_t>();
+    ref_compute_t alpha_c;
+    ref_compute_t beta_c;
+    convert_row(&alpha, &alpha_c, 1);
+    convert_row(&beta, &beta_c, 1);
+    int row_blocks = (m + REF_MC - 1) / REF_MC;
+    int col_blocks = (n + REF_NC - 1) / REF_NC;
+    #pragma omp parallel
+    {
+    // The packed blocks and the partial result of a block of C are stored in buffers of every thread
+    std::vector<ref_compute_t> packed_a(REF_MC * REF_KC);
+    std::vector<ref_compute_t> packed_b(REF_KC * REF_NC);
+    std::vector<ref_compute_t> c_block(REF_MC * REF_NC);
+    std::vector<ref_compute_t> row(std::max(REF_KC, REF_NC));
+    #pragma omp for collapse(2) schedule(dynamic)
+    for (int ib = 0; ib < row_blocks; ib++) {
+        for (int jb = 0; jb < col_blocks; jb++) {
+            int i = ib * REF_MC;
+            int j = jb * REF_NC;
+            int mc = std::min(REF_MC, m - i);
+            int nc = std::min(REF_NC, n - j);
+            std::fill(c_block.begin(), c_block.end(), static_cast<ref_compute_t>(0));
+            for (int l = 0; l < k; l += REF_KC) {
+                int kc = std::min(REF_KC, k - l);
+                const T* a_block = (transpose_a) ? a + static_cast<size_t>(l) * lda + i : a + static_cast<size_t>(i) * lda + l;
+                const T* b_block = (transpose_b) ? b + static_cast<size_t>(j) * ldb + l : b + static_cast<size_t>(l) * ldb + j;
+                pack_a(a_block, lda, mc, kc, transpose_a, packed_a.data(), row.data(), convert);
+                pack_b(b_block, ldb, kc, nc, transpose_b, packed_b.data(), row.data(), convert);
+                for (int s = 0; s < mc; s += REF_MR) {
+                    for (int t = 0; t < nc; t += nr) {
+                        kernel(kc, packed_a.data() + s * kc, packed_b.data() + t * kc, c_block.data() + s * REF_NC + t, REF_NC);
+                    }
+                }
+            }
+            for (int ii = 0; ii < mc; ii++) {
+                T* c_row = c + static_cast<size_t>(i + ii) * n + j;
+                convert(c_row, row.data(), nc);
+                for (int jj = 0; jj < nc; jj++) {
+                    row[jj] = beta_c * row[jj] + alpha_c * c_block[ii * REF_NC + jj];
+                }
+                convert_row(row.data(), c_row, nc);
+            }
+        }
+    }
+    }
+}
+
+#ifdef _USE_BLAS_
+template<>
+void 
+gemm::gemm_ref<cl_float>(cl_float* a, cl_float* b, cl_float* c,
+                                int m, int k, int n, cl_float alpha, cl_float beta,
+                                bool transpose_a, bool transpose_b) {
+    int lda = (transpose_a) ? m : k;
+    int ldb = (transpose_b) ? k : n;
+    // BLAS expects column-major matrices, so C^T = op(B)^T * op(A)^T is calculated
+    char ta = (transpose_a) ? 'T' : 'N';
+    char tb = (transpose_b) ? 'T' : 'N';
+    sgemm_(&tb, &ta, &n, &m, &k, &alpha, b, &ldb, a, &lda, &beta, c, &n);
+}
+
+template<>
+void 
+gemm::gemm_ref<cl_double>(cl_double* a, cl_double* b, cl_double* c,
+                                int m, int k, int n, cl_double alpha, cl_double beta,
+                                bool transpose_a, bool transpose_b) {
+    int lda = (transpose_a) ? m : k;
+    int ldb = (transpose_b) ? k : n;
+    char ta = (transpose_a) ? 'T' : 'N';
+    char tb = (transpose_b) ? 'T' : 'N';
+    dgemm_(&tb, &ta, &n, &m, &k, &alpha, b, &ldb, a, &lda, &beta, c, &n);
+}
+#endif
+
+template void gemm::gemm_ref<half_float::half>(half_float::half* a, half_float::half* b, half_float::half* c,
+                                int n, half_float::half alpha, half_float::half beta);
+template void gemm::gemm_ref<cl_float>(cl_float* a, cl_float* b, cl_float* c,
+                                int n, cl_float alpha, cl_float beta);
+template void gemm::gemm_ref<cl_double>(cl_double* a, cl_double* b, cl_double* c,
+                                int n, cl_double alpha, cl_double beta);
+template void gemm::gemm_ref<half_float::half>(half_float::half* a, half_float::half* b, half_float::half* c,
+                                int m, int k, int n, half_float::half alpha, half_float::half beta,
+                                bool transpose_a, bool transpose_b);
+#ifndef _USE_BLAS_
+template void gemm::gemm_ref<cl_float>(cl_float* a, cl_float* b, cl_float* c,
+                                int m, int k, int n, cl_float alpha, cl_float beta,
+                                bool transpose_a, bool transpose_b);
+template void gemm::gemm_ref<cl_double>(cl_double* a, cl_double* b, cl_double* c,
+                                int m, int k, int n, cl_double alpha, cl_double beta,
+                                bool transpose_a, bool transpose_b);
+#endif
+
+template class gemm::TypedGEMMData<half_float::half>;
+template class gemm::TypedGEMMData<cl_float>;
+template class gemm::TypedGEMMData<cl_double>;
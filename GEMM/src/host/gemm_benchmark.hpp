@@ -26,9 +26,11 @@ SOFTWARE.
 /* C++ standard library headers */
 #include <complex>
 #include <memory>
+#include <stdexcept>
 
 /* Project's headers */
 #include "hpcc_benchmark.hpp"
+#include "profiling.hpp"
 #include "parameters.h"
 
 #include "half.hpp"
@@ -60,7 +62,8 @@ class GEMMProgramSettings : public hpcc_base::BaseSettings {
 
 public:
     /**
-     * @brief The size of the whole matrix in one dimension
+     * @brief The size of the whole matrix in one dimension.
+     *          For non-square matrices, it is the number of rows of op(A) and C.
      * 
      */
     uint matrixSize;
@@ -82,6 +85,87 @@ public:
      */
     bool replicateInputBuffers;
 
+    /**
+     * @brief Size of a tile in number of blocks in one dimension, if the out-of-core execution is used.
+     *          Only tiles of A, B and C are kept in device memory, so the matrices can exceed the device memory.
+     *          If 0, the whole matrices are copied to the device.
+     */
+    uint tileSizeInBlocks;
+
+    /**
+     * @brief If true, a single GEMM is distributed over all MPI ranks using SUMMA.
+     *          The ranks are arranged in a square torus and every rank holds a block of size matrixSize of every matrix.
+     */
+    bool distributed;
+
+    /**
+     * @brief The row position of this MPI rank in the torus
+     * 
+     */
+    int torus_row;
+
+    /**
+     * @brief The column position of this MPI rank in the torus
+     * 
+     */
+    int torus_col;
+
+    /**
+     * @brief Width of the torus in number of ranks
+     * 
+     */
+    int torus_width;
+
+    /**
+     * @brief Number of independent matrix multiplications that are calculated in the batched mode.
+     *          If 1, a single matrix multiplication is calculated.
+     */
+    uint batchCount;
+
+    /**
+     * @brief Distance between two matrices of a batch in number of values.
+     *          It is at least the number of values of a single matrix.
+     */
+    uint batchStride;
+
+    /**
+     * @brief Number of columns of op(A) and rows of op(B)
+     * 
+     */
+    uint matrixSizeK;
+
+    /**
+     * @brief Number of columns of op(B) and C
+     * 
+     */
+    uint matrixSizeN;
+
+    /**
+     * @brief If true, A is stored as a K x M matrix and op(A) = A^T
+     * 
+     */
+    bool transposeA;
+
+    /**
+     * @brief If true, B is stored as a N x K matrix and op(B) = B^T
+     * 
+     */
+    bool transposeB;
+
+    /**
+     * @brief The data type of the matrices
+     * 
+     */
+    hpcc_base::DataType dataType;
+
+    /**
+     * @brief Check, if the multiplied matrices are square and not transposed
+     * 
+     * @return true, if all matrices have the size matrixSize x matrixSize and are not transposed
+     */
+    bool
+    isSquare() const;
+
     /**
      * @brief Construct a new GEMM Program Settings object
      * 
@@ -98,78 +182,150 @@ public:
 
 };
 
+template<typename T>
+class TypedGEMMData;
+
 /**
  * @brief Data class containing all data needed by the kernel to calculate
  *          \f$C\_out = \alpha * A * B + \beta * C\f$
+ *          The matrices are stored by TypedGEMMData for the data type that is used in the execution.
  * 
  */
 class GEMMData {
 
+public:
+    /**
+     * @brief The data type of the matrices
+     * 
+     */
+    hpcc_base::DataType dataType;
+
+    /**
+     * @brief The context that is used to allocate memory in SVM mode
+     * 
+     */
+    cl::Context context;
+
+    /**
+     * @brief Construct a new GEMM Data object
+     * 
+     * @param context The OpenCL context used to allocate memory in SVM mode
+     * @param dataType The data type of the matrices
+     */
+    GEMMData(cl::Context context, hpcc_base::DataType dataType) : dataType(dataType), context(context) {}
+
+    /**
+     * @brief Destroy the GEMM Data object
+     * 
+     */
+    virtual ~GEMMData() {}
+
+    /**
+     * @brief Access the matrices with their data type
+     * 
+     * @tparam T The data type of the matrices
+     * @return TypedGEMMData<T>& The data with the typed matrices. Will throw a runtime error if the matrices have a different type.
+     */
+    template<typename T>
+    TypedGEMMData<T>&
+    as();
+
+};
+
+/**
+ * @brief The matrices and scalars of the calculation for a specific data type
+ * 
+ * @tparam T The data type of the matrices
+ */
+template<typename T>
+class TypedGEMMData : public GEMMData {
+
 public:
     /**
      * @brief Pointer to the matrix A of the calculation
      * 
      */
-    HOST_DATA_TYPE *A;
+    T *A;
 
     /**
      * @brief Pointer to the matrix B of the calculation
      * 
      */
-    HOST_DATA_TYPE *B;
+    T *B;
 
     /**
      * @brief Pointer to the matrix C of the calculation
      * 
      */
-    HOST_DATA_TYPE *C;
+    T *C;
 
     /**
      * @brief Pointer to the output matrix of the calculation
      * 
      */
-    HOST_DATA_TYPE *C_out;
+    T *C_out;
 
     /**
      * @brief Stores the maximum value of all input matrices for the error calculation
      * 
      */
-    HOST_DATA_TYPE normtotal;
+    T normtotal;
 
     /**
      * @brief The scalar value that will be used for \f$\alpha\f$ in the calculation
      * 
      */
-    HOST_DATA_TYPE alpha;
+    T alpha;
 
     /**
-     * @brief The context that is used to allocate memory in SVM mode
+     * @brief The scalar value that will be used for \f$\beta\f$ in the calculation
      * 
      */
-    cl::Context context;
+    T beta;
 
     /**
-     * @brief The scalar value that will be used for \f$\beta\f$ in the calculation
+     * @brief Construct a new Typed GEMM Data object
      * 
+     * @param context The OpenCL context used to allocate memory in SVM mode
+     * @param dataType The data type of the matrices. Has to match T.
+     * @param size Size of the allocated square matrices
+     * @param batch Number of matrices that are stored for every operand
+     * @param stride Distance between two matrices in number of values. If 0, the matrices are stored without gaps.
      */
-    HOST_DATA_TYPE beta;
+    TypedGEMMData(cl::Context context, hpcc_base::DataType dataType, uint size, uint batch = 1, size_t stride = 0);
 
     /**
-     * @brief Construct a new GEMM Data object
+     * @brief Construct a new Typed GEMM Data object for non-square matrices.
+     *          A contains m x k values, B k x n values and C m x n values.
      * 
      * @param context The OpenCL context used to allocate memory in SVM mode
-     * @param size Size of the allocated square matrices
+     * @param dataType The data type of the matrices. Has to match T.
+     * @param m Number of rows of op(A) and C
+     * @param k Number of columns of op(A) and rows of op(B)
+     * @param n Number of columns of op(B) and C
+     * @param batch Number of matrices that are stored for every operand
+     * @param stride Distance between two matrices in number of values. If 0, the matrices are stored without gaps.
      */
-    GEMMData(cl::Context context, uint size);
+    TypedGEMMData(cl::Context context, hpcc_base::DataType dataType, uint m, uint k, uint n, uint batch, size_t stride);
 
     /**
-     * @brief Destroy the GEMM Data object. Free the allocated memory
+     * @brief Destroy the Typed GEMM Data object. Free the allocated memory
      * 
      */
-    ~GEMMData();
+    ~TypedGEMMData() override;
 
 };
 
+template<typename T>
+TypedGEMMData<T>&
+GEMMData::as() {
+    auto typed = dynamic_cast<TypedGEMMData<T>*>(this);
+    if (typed == nullptr) {
+        throw std::runtime_error("The matrices are not stored with the requested data type!");
+    }
+    return *typed;
+}
+
 /**
  * @brief Measured execution timing from the kernel execution
  * 
@@ -182,6 +338,13 @@ public:
      */
     std::vector<double> timings;
 
+    /**
+     * @brief Device-side timings of the kernel executions and buffer transfers of all replications
+     *          measured with OpenCL event profiling
+     * 
+     */
+    std::vector<profiling::DeviceTiming> deviceTimings;
+
 };
 
 /**
@@ -200,6 +363,49 @@ protected:
     void
     addAdditionalParseOptions(cxxopts::Options &options) override;
 
+    /**
+     * @brief Detect the data type of the matrices from the kernel arguments, if it is not given by the user.
+     *          If the bitstream does not contain the argument types, the data type of the build is used.
+     * 
+     */
+    void
+    adaptSettingsToBitstream() override;
+
+private:
+
+    /**
+     * @brief Generate the input data for a specific data type
+     * 
+     * @tparam T The data type of the matrices
+     * @return std::unique_ptr<GEMMData> The generated data
+     */
+    template<typename T>
+    std::unique_ptr<GEMMData>
+    generateTypedInputData();
+
+    /**
+     * @brief Execute the kernel for a specific data type
+     * 
+     * @tparam T The data type of the matrices
+     * @param data The matrices used in the execution
+     * @return std::unique_ptr<GEMMExecutionTimings> The measured timings
+     */
+    template<typename T>
+    std::unique_ptr<GEMMExecutionTimings>
+    executeTypedKernel(TypedGEMMData<T> &data);
+
+    /**
+     * @brief Validate the result of a specific data type. The machine epsilon of the data type is used for the normalization of the error.
+     * 
+     * @tparam T The data type of the matrices
+     * @param data The matrices after the execution
+     * @return true If the validation is a success
+     * @return false otherwise
+     */
+    template<typename T>
+    bool
+    validateTypedOutputAndPrintError(TypedGEMMData<T> &data);
+
 public:
 
     /**
@@ -210,6 +416,15 @@ public:
     std::unique_ptr<GEMMData>
     generateInputData() override;
 
+    /**
+     * @brief Estimate the memory of the matrices, the reference matrices of the validation and the buffers.
+     *          The buffers are estimated like for the execution without tiles, so the estimate is an upper bound for the tiled execution.
+     * 
+     * @return std::vector<memory_tracker::MemoryRequirement> The estimated allocations of this rank
+     */
+    std::vector<memory_tracker::MemoryRequirement>
+    estimateMemoryUsage() override;
+
     /**
      * @brief GEMM specific implementation of the kernel execution
      * 
@@ -257,15 +472,57 @@ Multiply matrix with a vector and add it to another vector.
 
 C = alpha * A * B + beta * C
 
+If no BLAS library is found or half precision is used, a packed and cache blocked implementation is used.
+Its micro kernel uses AVX2 or AVX-512 depending on the CPU it is executed on.
+
 @param a matrix A
 @param b matrix B
 @param c matrix C that will also be the result matrix
 @param n size of all quadratic matrices
 @param alpha scalar value used to scale A * B
 @param beta scalar value used to scale C
+@tparam T the data type of the matrices
+*/
+template<typename T>
+void gemm_ref( T* a, T* b, T* c,
+                                int n, T alpha, T beta);
+
+/**
+Multiply non-square and optionally transposed matrices in row-major order.
+
+C = alpha * op(A) * op(B) + beta * C
+
+@param a matrix A with m x k values or k x m values, if it is transposed
+@param b matrix B with k x n values or n x k values, if it is transposed
+@param c matrix C with m x n values that will also be the result matrix
+@param m number of rows of op(A) and C
+@param k number of columns of op(A) and rows of op(B)
+@param n number of columns of op(B) and C
+@param alpha scalar value used to scale op(A) * op(B)
+@param beta scalar value used to scale C
+@param transpose_a if true, op(A) = A^T
+@param transpose_b if true, op(B) = B^T
+@tparam T the data type of the matrices
 */
-void gemm_ref( HOST_DATA_TYPE* a, HOST_DATA_TYPE* b, HOST_DATA_TYPE* c,
-                                int n, HOST_DATA_TYPE alpha, HOST_DATA_TYPE beta);
+template<typename T>
+void gemm_ref( T* a, T* b, T* c,
+                                int m, int k, int n, T alpha, T beta,
+                                bool transpose_a, bool transpose_b);
+
+#ifdef _USE_BLAS_
+/**
+ * @brief Single and double precision are calculated with BLAS
+ */
+template<>
+void gemm_ref<cl_float>( cl_float* a, cl_float* b, cl_float* c,
+                                int m, int k, int n, cl_float alpha, cl_float beta,
+                                bool transpose_a, bool transpose_b);
+
+template<>
+void gemm_ref<cl_double>( cl_double* a, cl_double* b, cl_double* c,
+                                int m, int k, int n, cl_double alpha, cl_double beta,
+                                bool transpose_a, bool transpose_b);
+#endif
 
 } // namespace gemm
 
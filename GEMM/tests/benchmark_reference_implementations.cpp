@@ -0,0 +1,36 @@
+/*
+Microbenchmarks of the host reference implementation of GEMM that is used for the validation.
+The benchmarks are executed for multiple matrix sizes and numbers of OpenMP threads.
+*/
+#include <random>
+#include <vector>
+
+#include "reference_benchmark.hpp"
+#include "gemm_benchmark.hpp"
+#include "parameters.h"
+
+template<typename T>
+static void
+BM_gemm_ref(benchmark::State &state) {
+    reference_benchmark::setThreads(state);
+    int n = static_cast<int>(state.range(0));
+    std::vector<T> a(n * n);
+    std::vector<T> b(n * n);
+    std::vector<T> c(n * n);
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> dis(-1.0, 1.0);
+    for (int i = 0; i < n * n; i++) {
+        a[i] = static_cast<T>(dis(gen));
+        b[i] = static_cast<T>(dis(gen));
+        c[i] = static_cast<T>(0.0);
+    }
+    for (auto _ : state) {
+        gemm::gemm_ref(a.data(), b.data(), c.data(), n, static_cast<T>(1.0), static_cast<T>(0.0));
+        benchmark::DoNotOptimize(c.data());
+        benchmark::ClobberMemory();
+    }
+    state.counters["FLOP/s"] = benchmark::Counter(2.0 * n * n * n, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+REFERENCE_BENCHMARK(BM_gemm_ref<cl_float>, 256, 512, 1024, 2048);
+REFERENCE_BENCHMARK(BM_gemm_ref<cl_double>, 256, 512, 1024, 2048);
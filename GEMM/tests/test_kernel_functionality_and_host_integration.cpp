@@ -28,11 +28,21 @@ struct GEMMKernelTest : testing::Test, testing::WithParamInterface<unsigned> {
         bm = std::unique_ptr<gemm::GEMMBenchmark>(new gemm::GEMMBenchmark(global_argc, global_argv));
         matrix_size = GetParam() * BLOCK_SIZE;
         bm->getExecutionSettings().programSettings->matrixSize = matrix_size;
+        bm->getExecutionSettings().programSettings->matrixSizeK = matrix_size;
+        bm->getExecutionSettings().programSettings->matrixSizeN = matrix_size;
     }
 
     void SetUp() {
         data = bm->generateInputData();
     }
+
+    /**
+     * @brief Access the matrices with the data type of the build
+     */
+    gemm::TypedGEMMData<HOST_DATA_TYPE>&
+    arrays() {
+        return data->as<HOST_DATA_TYPE>();
+    }
 };
 
 /**
@@ -59,15 +69,15 @@ TEST_P(GEMMKernelTest, FPGACorrectNumberOfRepetitionsIs3) {
 TEST_P(GEMMKernelTest, FPGACorrectCtimesBeta) {
     for (int i = 0; i < matrix_size; i++) {
         for (int j = 0; j < matrix_size; j++) {
-            data->A[i * matrix_size + j] = OPTIONAL_CAST(0.0);
-            data->B[i * matrix_size + j] = OPTIONAL_CAST(0.0);
-            data->C[i * matrix_size + j] = OPTIONAL_CAST(1.0);
+            arrays().A[i * matrix_size + j] = OPTIONAL_CAST(0.0);
+            arrays().B[i * matrix_size + j] = OPTIONAL_CAST(0.0);
+            arrays().C[i * matrix_size + j] = OPTIONAL_CAST(1.0);
         }
     }
     auto result = bm->executeKernel(*data);
     for (int i = 0; i < matrix_size; i++) {
         for (int j = 0; j < matrix_size; j++) {
-            EXPECT_NEAR(data->C_out[i * matrix_size + j], 2.0 * data->C[i * matrix_size + j], std::numeric_limits<HOST_DATA_TYPE>::epsilon());
+            EXPECT_NEAR(arrays().C_out[i * matrix_size + j], 2.0 * arrays().C[i * matrix_size + j], std::numeric_limits<HOST_DATA_TYPE>::epsilon());
         }
     }
 }
@@ -78,17 +88,17 @@ TEST_P(GEMMKernelTest, FPGACorrectCtimesBeta) {
 TEST_P(GEMMKernelTest, FPGACorrectAtimesAlpha) {
     for (int i = 0; i < matrix_size; i++) {
         for (int j = 0; j < matrix_size; j++) {
-            data->B[i * matrix_size + j] = i == j ? OPTIONAL_CAST(1.0) : OPTIONAL_CAST(0.0);
-            data->C[i * matrix_size + j] = OPTIONAL_CAST(0.0);
+            arrays().B[i * matrix_size + j] = i == j ? OPTIONAL_CAST(1.0) : OPTIONAL_CAST(0.0);
+            arrays().C[i * matrix_size + j] = OPTIONAL_CAST(0.0);
         }
     }
-    data->alpha = 2.0;
-    data->beta = 0.0;
+    arrays().alpha = 2.0;
+    arrays().beta = 0.0;
 
     auto result = bm->executeKernel(*data);
     for (int i = 0; i < matrix_size; i++) {
         for (int j = 0; j < matrix_size; j++) {
-            EXPECT_NEAR(data->C_out[i * matrix_size + j], 2.0 * data->A[i * matrix_size + j], std::numeric_limits<HOST_DATA_TYPE>::epsilon());
+            EXPECT_NEAR(arrays().C_out[i * matrix_size + j], 2.0 * arrays().A[i * matrix_size + j], std::numeric_limits<HOST_DATA_TYPE>::epsilon());
         }
     }
 }
@@ -99,16 +109,16 @@ TEST_P(GEMMKernelTest, FPGACorrectAtimesAlpha) {
 TEST_P(GEMMKernelTest, FPGACorrectBtimesAlpha) {
     for (int i = 0; i < matrix_size; i++) {
         for (int j = 0; j < matrix_size; j++) {
-            data->A[i * matrix_size + j] = i == j ? OPTIONAL_CAST(1.0) : OPTIONAL_CAST(0.0);
-            data->C[i * matrix_size + j] = OPTIONAL_CAST(0.0);
+            arrays().A[i * matrix_size + j] = i == j ? OPTIONAL_CAST(1.0) : OPTIONAL_CAST(0.0);
+            arrays().C[i * matrix_size + j] = OPTIONAL_CAST(0.0);
         }
     }
-    data->alpha = 2.0;
-    data->beta = 0.0;
+    arrays().alpha = 2.0;
+    arrays().beta = 0.0;
     auto result = bm->executeKernel(*data);
     for (int i = 0; i < matrix_size; i++) {
         for (int j = 0; j < matrix_size; j++) {
-            EXPECT_NEAR(data->C_out[i * matrix_size + j], 2.0 * data->B[i * matrix_size + j], std::numeric_limits<HOST_DATA_TYPE>::epsilon());
+            EXPECT_NEAR(arrays().C_out[i * matrix_size + j], 2.0 * arrays().B[i * matrix_size + j], std::numeric_limits<HOST_DATA_TYPE>::epsilon());
         }
     }
 }
@@ -119,20 +129,20 @@ TEST_P(GEMMKernelTest, FPGACorrectBtimesAlpha) {
 TEST_P(GEMMKernelTest, FPGACorrectAmulB) {
     for (int i = 0; i < matrix_size; i++) {
         for (int j = 0; j < matrix_size; j++) {
-            data->C[i * matrix_size + j] = OPTIONAL_CAST(0.0);
-            data->A[i * matrix_size + j] = OPTIONAL_CAST(j % 10);
-            data->B[i * matrix_size + j] = OPTIONAL_CAST(i % 10);
+            arrays().C[i * matrix_size + j] = OPTIONAL_CAST(0.0);
+            arrays().A[i * matrix_size + j] = OPTIONAL_CAST(j % 10);
+            arrays().B[i * matrix_size + j] = OPTIONAL_CAST(i % 10);
         }
     }
-    data->alpha = 1.0;
-    data->beta = 1.0;
+    arrays().alpha = 1.0;
+    arrays().beta = 1.0;
     auto result = bm->executeKernel(*data);
 
     HOST_DATA_TYPE c_ref_out[matrix_size * matrix_size];
-    ref_matmul(data->A,data->B,c_ref_out,matrix_size);
+    ref_matmul(arrays().A,arrays().B,c_ref_out,matrix_size);
     for (int i = 0; i < matrix_size; i++) {
         for (int j = 0; j < matrix_size; j++) {
-            EXPECT_NEAR(data->C_out[i * matrix_size + j], c_ref_out[i * matrix_size + j], 0.001);
+            EXPECT_NEAR(arrays().C_out[i * matrix_size + j], c_ref_out[i * matrix_size + j], 0.001);
         }
     }
 }
@@ -144,16 +154,16 @@ TEST_P(GEMMKernelTest, FPGACorrectCplusA) {
 
     for (int i = 0; i < matrix_size; i++) {
         for (int j = 0; j < matrix_size; j++) {
-            data->B[i * matrix_size + j] = i == j ? 1.0 : 0.0;
+            arrays().B[i * matrix_size + j] = i == j ? 1.0 : 0.0;
         }
     }
-    data->alpha = 1.0;
-    data->beta = 1.0;
+    arrays().alpha = 1.0;
+    arrays().beta = 1.0;
 
     auto result = bm->executeKernel(*data);
     for (int i = 0; i < matrix_size; i++) {
         for (int j = 0; j < matrix_size; j++) {
-            EXPECT_FLOAT_EQ(data->C_out[i * matrix_size + j], data->A[i * matrix_size + j] + data->C[i * matrix_size + j]);
+            EXPECT_FLOAT_EQ(arrays().C_out[i * matrix_size + j], arrays().A[i * matrix_size + j] + arrays().C[i * matrix_size + j]);
         }
     }
 }
@@ -168,16 +178,166 @@ TEST_P(GEMMKernelTest, FPGACorrectbetaCplusalphaAB) {
     auto result = bm->executeKernel(*data);
     for (int i = 0; i < matrix_size; i++) {
         for (int j = 0; j < matrix_size; j++) {
-           c_ref_out[i * matrix_size + j] = data->C[i * matrix_size + j];
+           c_ref_out[i * matrix_size + j] = arrays().C[i * matrix_size + j];
+        }
+    }
+    gemm::gemm_ref(arrays().A,arrays().B,c_ref_out,matrix_size,OPTIONAL_CAST(0.5),OPTIONAL_CAST(2.0));
+    for (int i = 0; i < matrix_size; i++) {
+        for (int j = 0; j < matrix_size; j++) {
+            EXPECT_NEAR(arrays().C_out[i * matrix_size + j], c_ref_out[i * matrix_size + j], std::numeric_limits<HOST_DATA_TYPE>::epsilon() * matrix_size * matrix_size);
+        }
+    }
+}
+
+/**
+ * Tests full multiply add with the out-of-core execution using tiles of a single block
+ */
+TEST_P(GEMMKernelTest, FPGACorrectbetaCplusalphaABOutOfCore) {
+    bm->getExecutionSettings().programSettings->tileSizeInBlocks = 1;
+    HOST_DATA_TYPE c_ref_out[matrix_size * matrix_size];
+    auto result = bm->executeKernel(*data);
+    for (int i = 0; i < matrix_size; i++) {
+        for (int j = 0; j < matrix_size; j++) {
+           c_ref_out[i * matrix_size + j] = arrays().C[i * matrix_size + j];
         }
     }
-    gemm::gemm_ref(data->A,data->B,c_ref_out,matrix_size,OPTIONAL_CAST(0.5),OPTIONAL_CAST(2.0));
+    gemm::gemm_ref(arrays().A,arrays().B,c_ref_out,matrix_size,OPTIONAL_CAST(0.5),OPTIONAL_CAST(2.0));
     for (int i = 0; i < matrix_size; i++) {
         for (int j = 0; j < matrix_size; j++) {
-            EXPECT_NEAR(data->C_out[i * matrix_size + j], c_ref_out[i * matrix_size + j], std::numeric_limits<HOST_DATA_TYPE>::epsilon() * matrix_size * matrix_size);
+            EXPECT_NEAR(arrays().C_out[i * matrix_size + j], c_ref_out[i * matrix_size + j], std::numeric_limits<HOST_DATA_TYPE>::epsilon() * matrix_size * matrix_size);
+        }
+    }
+}
+
+/**
+ * Tests full multiply add with non-square matrices
+ */
+TEST_P(GEMMKernelTest, FPGACorrectbetaCplusalphaABNonSquare) {
+    bm->getExecutionSettings().programSettings->matrixSizeK = 2 * matrix_size;
+    bm->getExecutionSettings().programSettings->matrixSizeN = 3 * matrix_size;
+    data = bm->generateInputData();
+    auto result = bm->executeKernel(*data);
+    EXPECT_TRUE(bm->validateOutputAndPrintError(*data));
+}
+
+/**
+ * Tests full multiply add with non-square and transposed matrices
+ */
+TEST_P(GEMMKernelTest, FPGACorrectbetaCplusalphaATBTNonSquare) {
+    bm->getExecutionSettings().programSettings->matrixSizeK = 2 * matrix_size;
+    bm->getExecutionSettings().programSettings->matrixSizeN = 3 * matrix_size;
+    bm->getExecutionSettings().programSettings->transposeA = true;
+    bm->getExecutionSettings().programSettings->transposeB = true;
+    data = bm->generateInputData();
+    auto result = bm->executeKernel(*data);
+    EXPECT_TRUE(bm->validateOutputAndPrintError(*data));
+}
+
+/**
+ * Tests the transposed reference implementation with a small example
+ */
+TEST(GEMMHostReference, TransposedMatricesGiveSameResultAsNonTransposed) {
+    const int m = 3;
+    const int k = 4;
+    const int n = 5;
+    HOST_DATA_TYPE a[m * k];
+    HOST_DATA_TYPE a_t[k * m];
+    HOST_DATA_TYPE b[k * n];
+    HOST_DATA_TYPE b_t[n * k];
+    HOST_DATA_TYPE c[m * n];
+    HOST_DATA_TYPE c_t[m * n];
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < k; j++) {
+            a[i * k + j] = OPTIONAL_CAST(static_cast<float>(i * k + j));
+            a_t[j * m + i] = a[i * k + j];
         }
     }
+    for (int i = 0; i < k; i++) {
+        for (int j = 0; j < n; j++) {
+            b[i * n + j] = OPTIONAL_CAST(static_cast<float>(i - j));
+            b_t[j * k + i] = b[i * n + j];
+        }
+    }
+    for (int i = 0; i < m * n; i++) {
+        c[i] = OPTIONAL_CAST(1.0);
+        c_t[i] = OPTIONAL_CAST(1.0);
+    }
+    gemm::gemm_ref(a, b, c, m, k, n, OPTIONAL_CAST(0.5), OPTIONAL_CAST(2.0), false, false);
+    gemm::gemm_ref(a_t, b_t, c_t, m, k, n, OPTIONAL_CAST(0.5), OPTIONAL_CAST(2.0), true, true);
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < n; j++) {
+            double expected = 2.0;
+            for (int l = 0; l < k; l++) {
+                expected += 0.5 * (i * k + l) * (l - j);
+            }
+            EXPECT_NEAR(c[i * n + j], expected, 1.0e-3);
+            EXPECT_NEAR(c_t[i * n + j], expected, 1.0e-3);
+        }
+    }
+}
+
+/**
+ * Tests full multiply add with the batched execution and a stride that leaves a gap between the matrices
+ */
+TEST_P(GEMMKernelTest, FPGACorrectbetaCplusalphaABBatched) {
+    bm->getExecutionSettings().programSettings->batchCount = 3;
+    bm->getExecutionSettings().programSettings->batchStride = matrix_size * matrix_size + 16;
+    data = bm->generateInputData();
+    auto result = bm->executeKernel(*data);
+    EXPECT_TRUE(bm->validateOutputAndPrintError(*data));
+}
+
+/**
+ * Tests full multiply add with non-square and transposed matrices calculated by the CPU backend
+ */
+TEST_P(GEMMKernelTest, CPUCorrectbetaCplusalphaATBTNonSquare) {
+    bm->getExecutionSettings().programSettings->communicationType = hpcc_base::CommunicationType::cpu_only;
+    bm->getExecutionSettings().programSettings->matrixSizeK = 2 * matrix_size;
+    bm->getExecutionSettings().programSettings->matrixSizeN = 3 * matrix_size;
+    bm->getExecutionSettings().programSettings->transposeA = true;
+    bm->getExecutionSettings().programSettings->transposeB = true;
+    data = bm->generateInputData();
+    auto result = bm->executeKernel(*data);
+    EXPECT_EQ(bm->getExecutionSettings().programSettings->numRepetitions, result->timings.size());
+    EXPECT_TRUE(bm->validateOutputAndPrintError(*data));
+}
+
+/**
+ * Tests if the data type is detected from the kernel arguments in the bitstream
+ */
+TEST_P(GEMMKernelTest, DataTypeIsDetectedFromBitstream) {
+    EXPECT_EQ(bm->getExecutionSettings().programSettings->dataType,
+                hpcc_base::detectDataType(*bm->getExecutionSettings().program, bm->getExecutionSettings().programSettings->dataType));
+    EXPECT_EQ(sizeof(HOST_DATA_TYPE), hpcc_base::dataTypeSize(bm->getExecutionSettings().programSettings->dataType));
+}
+
+/**
+ * Tests if the CPU backend calculates the correct result for all data types independent of the kernels in the bitstream
+ */
+TEST_P(GEMMKernelTest, CPUCorrectbetaCplusalphaABForAllDataTypes) {
+    bm->getExecutionSettings().programSettings->communicationType = hpcc_base::CommunicationType::cpu_only;
+    bm->getExecutionSettings().programSettings->numRepetitions = 1;
+    for (auto type : {hpcc_base::DataType::half_precision, hpcc_base::DataType::single_precision, hpcc_base::DataType::double_precision}) {
+        bm->getExecutionSettings().programSettings->dataType = type;
+        data = bm->generateInputData();
+        EXPECT_EQ(type, data->dataType);
+        auto result = bm->executeKernel(*data);
+        EXPECT_TRUE(bm->validateOutputAndPrintError(*data)) << hpcc_base::dataTypeToString(type);
+    }
+    EXPECT_THROW(data->as<cl_float>(), std::runtime_error);
+}
+
+#ifdef _USE_MPI_
+/**
+ * Tests full multiply add with the distributed execution
+ */
+TEST_P(GEMMKernelTest, FPGACorrectbetaCplusalphaABDistributed) {
+    bm->getExecutionSettings().programSettings->distributed = true;
+    data = bm->generateInputData();
+    auto result = bm->executeKernel(*data);
+    EXPECT_TRUE(bm->validateOutputAndPrintError(*data));
 }
+#endif
 
 INSTANTIATE_TEST_CASE_P(Default, GEMMKernelTest,
          testing::Values(1,2));
@@ -27,6 +27,14 @@ SOFTWARE.
 
 #pragma OPENCL EXTENSION cl_intel_channels : enable
 
+// The three network kernels and every replication of the inner update kernel get their own counter slot
+#define KERNEL_COUNTER_SLOT_NETWORK_BOTTOMRIGHT 0
+#define KERNEL_COUNTER_SLOT_NETWORK_TOP 1
+#define KERNEL_COUNTER_SLOT_NETWORK_LEFT 2
+#define KERNEL_COUNTER_SLOT_INNER 3
+#define KERNEL_COUNTER_SLOTS (KERNEL_COUNTER_SLOT_INNER + /*PY_CODE_GEN num_replications*/)
+#include "kernel_counters.h"
+
 typedef struct tmp_channel_chunk { DEVICE_DATA_TYPE data[GEMM_BLOCK];} ch_chunk_t;
 
 // external channels from other devices
@@ -73,32 +81,38 @@ So the internal channels do not form a cycle because of the network kernel.
  __attribute__((uses_global_work_offset(0)))
 __kernel
 void network_layer_bottomright( const uint operation_type,
-				   				const uint forward_type) {
+				   				const uint forward_type
+								KERNEL_COUNTERS_ARG) {
+
+	KERNEL_COUNTERS_START(KERNEL_COUNTER_SLOT_NETWORK_BOTTOMRIGHT)
 
 	// For every row or column of the block, something needs to be sent
 	#pragma loop_coalesce
 	for (uint row = 0; row < BLOCK_SIZE; row++) {
 		// Number of chunks that has to be processed
 		for (uint chunk = 0; chunk < BLOCK_SIZE/GEMM_BLOCK; chunk++) {
+			KERNEL_COUNTERS_ACTIVE(1)
 
 			// Registers to store incoming and outgoing data chunks
 			ch_chunk_t to_right;
 			ch_chunk_t to_bottom;
 
 			if ((operation_type & (LU_BLOCK_OUT)) && chunk < BLOCK_SIZE/GEMM_BLOCK - (row >> REGISTER_BLOCK_LOG)) {
-				to_right = read_channel_intel(ch_lu_col_out);
-				to_bottom = read_channel_intel(ch_lu_row_out);
+				KERNEL_COUNTERS_READ_CHANNEL(to_right, ch_lu_col_out)
+				KERNEL_COUNTERS_READ_CHANNEL(to_bottom, ch_lu_row_out)
 			}
 			// If LU block is not calculated on this FPGA
 			// If left block, read from top and forward to bottom
 			if (!(operation_type & (LU_BLOCK_OUT)) && ((forward_type & NETWORK_FWD_BOTTOM) || (operation_type & (LEFT_BLOCK))) && (chunk < BLOCK_SIZE/GEMM_BLOCK - (row >> REGISTER_BLOCK_LOG))) {
-				ch_chunk_t from_top = read_channel_intel(ch_top_in);
+				ch_chunk_t from_top;
+				KERNEL_COUNTERS_READ_CHANNEL(from_top, ch_top_in)
 				// Forward chunk to the next top block
 				to_bottom = from_top;
 			}
 			// If top block, read from left and forward to right
 			if (!(operation_type & (LU_BLOCK_OUT)) && ((forward_type & NETWORK_FWD_RIGHT) || (operation_type & (TOP_BLOCK))) && (chunk < BLOCK_SIZE/GEMM_BLOCK - (row >> REGISTER_BLOCK_LOG))) {
-				ch_chunk_t from_left = read_channel_intel(ch_left_in);
+				ch_chunk_t from_left;
+				KERNEL_COUNTERS_READ_CHANNEL(from_left, ch_left_in)
 				// Forward chunk to the next top block
 				to_right = from_left;
 			}
@@ -106,21 +120,22 @@ void network_layer_bottomright( const uint operation_type,
 			//END LU block is not calculated on this FPGA
 
 			if ((operation_type & (LEFT_BLOCK)) && chunk < BLOCK_SIZE/GEMM_BLOCK - (row >> REGISTER_BLOCK_LOG)) {
-				write_channel_intel(ch_left_row_in, to_bottom);
+				KERNEL_COUNTERS_WRITE_CHANNEL(ch_left_row_in, to_bottom)
 			}
 			if ((operation_type & (TOP_BLOCK)) && chunk < BLOCK_SIZE/GEMM_BLOCK - (row >> REGISTER_BLOCK_LOG)) {
-				write_channel_intel(ch_top_col_in, to_right);
+				KERNEL_COUNTERS_WRITE_CHANNEL(ch_top_col_in, to_right)
 			}
 
 
 			if ((forward_type & NETWORK_FWD_RIGHT) && chunk < BLOCK_SIZE/GEMM_BLOCK - (row >> REGISTER_BLOCK_LOG)) {
-				write_channel_intel(ch_right_out, to_right);
+				KERNEL_COUNTERS_WRITE_CHANNEL(ch_right_out, to_right)
 			}
 			if ((forward_type & NETWORK_FWD_BOTTOM) && chunk < BLOCK_SIZE/GEMM_BLOCK - (row >> REGISTER_BLOCK_LOG)) {
-				write_channel_intel(ch_bottom_out, to_bottom);
+				KERNEL_COUNTERS_WRITE_CHANNEL(ch_bottom_out, to_bottom)
 			}
 		}
 	}
+	KERNEL_COUNTERS_END(KERNEL_COUNTER_SLOT_NETWORK_BOTTOMRIGHT)
 }
 
 /**
@@ -131,7 +146,10 @@ Will receive or forward data from the Left and Top kernel to the Inner kernel an
 __kernel
 void network_layer_top(__global DEVICE_DATA_TYPE* restrict top_buffer,
 							const uint operation_type,
-				   			const uint forward_type) {
+				   			const uint forward_type
+							KERNEL_COUNTERS_ARG) {
+
+	KERNEL_COUNTERS_START(KERNEL_COUNTER_SLOT_NETWORK_TOP)
 
 
 	// For every row or column of the block, something needs to be sent
@@ -139,16 +157,18 @@ void network_layer_top(__global DEVICE_DATA_TYPE* restrict top_buffer,
 	for (uint row = 0; row < BLOCK_SIZE; row++) {
 		// Number of chunks that has to be processed
 		for (uint chunk = 0; chunk < BLOCK_SIZE/GEMM_BLOCK; chunk++) {
+			KERNEL_COUNTERS_ACTIVE(1)
 
 			// Registers to store incoming and outgoing data chunks
 			ch_chunk_t to_top;
 
 			if (operation_type & (TOP_BLOCK_OUT)) {
-				to_top = read_channel_intel(ch_top_row_out);
+				KERNEL_COUNTERS_READ_CHANNEL(to_top, ch_top_row_out)
 			}
 			// If inner block, receive from right and bottom and forward to left and top
 			if (!(operation_type & (TOP_BLOCK_OUT)) && ((operation_type & (STORE_TOP_INNER))|| (forward_type & NETWORK_FWD_TOP))) {
-				ch_chunk_t from_bottom = read_channel_intel(ch_bottom_in);
+				ch_chunk_t from_bottom;
+				KERNEL_COUNTERS_READ_CHANNEL(from_bottom, ch_bottom_in)
 				// Forward chunk to the next top block
 				to_top = from_bottom;
 			}
@@ -161,10 +181,11 @@ void network_layer_top(__global DEVICE_DATA_TYPE* restrict top_buffer,
 			}
 
 			if ((forward_type & NETWORK_FWD_TOP)) {
-				write_channel_intel(ch_top_out, to_top);
+				KERNEL_COUNTERS_WRITE_CHANNEL(ch_top_out, to_top)
 			}
 		}
 	}
+	KERNEL_COUNTERS_END(KERNEL_COUNTER_SLOT_NETWORK_TOP)
 }
 
 /**
@@ -175,7 +196,10 @@ Will receive or forward data from the Left and Top kernel to the Inner kernel an
 __kernel
 void network_layer_left(__global DEVICE_DATA_TYPE* restrict left_buffer,
 							const uint operation_type,
-				   			const uint forward_type) {
+				   			const uint forward_type
+							KERNEL_COUNTERS_ARG) {
+
+	KERNEL_COUNTERS_START(KERNEL_COUNTER_SLOT_NETWORK_LEFT)
 
 
 	// For every row or column of the block, something needs to be sent
@@ -183,17 +207,19 @@ void network_layer_left(__global DEVICE_DATA_TYPE* restrict left_buffer,
 	for (uint row = 0; row < BLOCK_SIZE; row++) {
 		// Number of chunks that has to be processed
 		for (uint chunk = 0; chunk < BLOCK_SIZE/GEMM_BLOCK; chunk++) {
+			KERNEL_COUNTERS_ACTIVE(1)
 
 			// Registers to store incoming and outgoing data chunks
 			ch_chunk_t to_left;
 
 			if (operation_type & (LEFT_BLOCK_OUT)) {
-				to_left = read_channel_intel(ch_left_col_out);
+				KERNEL_COUNTERS_READ_CHANNEL(to_left, ch_left_col_out)
 			}
 	
 			// If inner block, receive from right and bottom and forward to left and top
 			if (!(operation_type & (LEFT_BLOCK_OUT)) && ((operation_type & (STORE_LEFT_INNER)) || (forward_type & NETWORK_FWD_LEFT))) {
-				ch_chunk_t from_right = read_channel_intel(ch_right_in);
+				ch_chunk_t from_right;
+				KERNEL_COUNTERS_READ_CHANNEL(from_right, ch_right_in)
 				// Forward chunk to the next top block
 				to_left = from_right;
 			}
@@ -206,10 +232,11 @@ void network_layer_left(__global DEVICE_DATA_TYPE* restrict left_buffer,
 			}
 
 			if ((forward_type & NETWORK_FWD_LEFT)) {
-				write_channel_intel(ch_left_out, to_left);
+				KERNEL_COUNTERS_WRITE_CHANNEL(ch_left_out, to_left)
 			}
 		}
 	}
+	KERNEL_COUNTERS_END(KERNEL_COUNTER_SLOT_NETWORK_LEFT)
 }
 
 
@@ -852,7 +879,10 @@ void inner_update_mm/*PY_CODE_GEN i*/(__global DEVICE_DATA_TYPE* restrict a,
 				__global DEVICE_DATA_TYPE* restrict top_global_buffer,
 				const uint block_col,
 				const uint block_row,
-				const uint blocks_per_row) {
+				const uint blocks_per_row
+				KERNEL_COUNTERS_ARG) {
+
+	KERNEL_COUNTERS_START(KERNEL_COUNTER_SLOT_INNER + /*PY_CODE_GEN i*/)
 
 	// Store current block in local memory
 	local DEVICE_DATA_TYPE a_buffer[BLOCK_SIZE/GEMM_BLOCK][BLOCK_SIZE/GEMM_BLOCK][GEMM_BLOCK][GEMM_BLOCK];
@@ -864,6 +894,7 @@ void inner_update_mm/*PY_CODE_GEN i*/(__global DEVICE_DATA_TYPE* restrict a,
 	for (int i =0; i < BLOCK_SIZE/GEMM_BLOCK_MM; i++) {
 		for (int ii =0; ii < GEMM_BLOCK_MM; ii++) {
 			for (int j =0; j < BLOCK_SIZE/GEMM_BLOCK_MM; j++) {
+				KERNEL_COUNTERS_ACTIVE(1)
 				__attribute__((opencl_unroll_hint(GEMM_BLOCK_MM)))
 				for (int jj =0; jj < GEMM_BLOCK_MM; jj++) {
 					a_buffer[i][j][ii][jj] = a[block_col * BLOCK_SIZE  + (block_row * BLOCK_SIZE + i * GEMM_BLOCK_MM + ii) * BLOCK_SIZE * blocks_per_row + j * GEMM_BLOCK_MM + jj];
@@ -887,6 +918,7 @@ void inner_update_mm/*PY_CODE_GEN i*/(__global DEVICE_DATA_TYPE* restrict a,
 		int mcol = c / ((BLOCK_SIZE/GEMM_BLOCK_MM)*(BLOCK_SIZE/GEMM_BLOCK_MM));
 		int row = (c / (BLOCK_SIZE/GEMM_BLOCK_MM)) & ((BLOCK_SIZE/GEMM_BLOCK_MM) - 1);
 		int curr_col = c & ((BLOCK_SIZE/GEMM_BLOCK_MM) - 1);
+		KERNEL_COUNTERS_ACTIVE(1)
 
 		DEVICE_DATA_TYPE top_sub[GEMM_BLOCK_MM][GEMM_BLOCK_MM];
 		DEVICE_DATA_TYPE left_sub[GEMM_BLOCK_MM][GEMM_BLOCK_MM];
@@ -936,13 +968,14 @@ void inner_update_mm/*PY_CODE_GEN i*/(__global DEVICE_DATA_TYPE* restrict a,
 	for (int i =0; i < BLOCK_SIZE/GEMM_BLOCK_MM; i++) {
 		for (int ii =0; ii < GEMM_BLOCK_MM; ii++) {
 			for (int j =0; j < BLOCK_SIZE/GEMM_BLOCK_MM; j++) {
+				KERNEL_COUNTERS_ACTIVE(1)
 				__attribute__((opencl_unroll_hint(GEMM_BLOCK_MM)))
 				for (int jj =0; jj < GEMM_BLOCK_MM; jj++) {
 					a[block_col * BLOCK_SIZE  + (block_row * BLOCK_SIZE + i * GEMM_BLOCK_MM + ii) * BLOCK_SIZE * blocks_per_row + j * GEMM_BLOCK_MM + jj] = a_buffer[i][j][ii][jj];
 				}
 			}
 		}
-	}
+	}	KERNEL_COUNTERS_END(KERNEL_COUNTER_SLOT_INNER + /*PY_CODE_GEN i*/)
 }
 
 // PY_CODE_GEN block_end
@@ -208,6 +208,7 @@ update_block(const DEVICE_DATA_TYPE a[GEMM_BLOCK][GEMM_BLOCK],
 	}
 }
 
+#ifndef USE_PIVOTING
 __attribute__((uses_global_work_offset(0)))
 __kernel
 void
@@ -444,6 +445,98 @@ lu(__global DEVICE_DATA_TYPE* restrict a,
 		}
 	}
 }
+#else
+
+/**
+Calculate the LU factorization of a single block with partial pivoting.
+
+The pivot element is searched only within the current row of the block, which is a column of the matrix
+in the host view. So the pivoting is restricted to the rows of the matrix that are stored in the same block.
+The selected pivot of every step is written to pivots as index within the block, so the same
+exchanges can be applied to the blocks below the LU block by left_update.
+The exchanges are only applied to the current and all following rows of the block like it is done for LINPACK.
+Since the search and the exchange depend on the result of the previous step, this version of the kernel is
+not pipelined over the steps.
+
+ */
+__attribute__((uses_global_work_offset(0)))
+__kernel
+void
+lu(__global DEVICE_DATA_TYPE* restrict a, 
+   __global DEVICE_DATA_TYPE* restrict a_block_trans,
+   __global DEVICE_DATA_TYPE* restrict a_block,
+				const uint block_col,
+				const uint block_row,
+				const uint blocks_per_row,
+				__global int* restrict pivots) {
+
+	local DEVICE_DATA_TYPE a_buffer[BLOCK_SIZE][BLOCK_SIZE] __attribute((xcl_array_partition(cyclic, GEMM_BLOCK, 2)));
+
+	// Load block to local memory
+	#pragma loop_coalesce
+	for (int i =0; i < BLOCK_SIZE; i++) {
+		__attribute__((opencl_unroll_hint(GEMM_BLOCK)))
+		for (int j =0; j < BLOCK_SIZE; j++) {
+			a_buffer[i][j] = a[block_col * BLOCK_SIZE  + (block_row * BLOCK_SIZE + i) * BLOCK_SIZE * blocks_per_row + j];
+		}
+	}
+
+	// The iterations depend on each other, so loop pipelining is disabled here
+	#pragma disable_loop_pipelining
+	for (int k = 0; k < BLOCK_SIZE; k++) {
+
+		// Search the element with the largest absolute value in the current row
+		DEVICE_DATA_TYPE max_value = fabs(a_buffer[k][k]);
+		int pvt = k;
+		for (int j = k + 1; j < BLOCK_SIZE; j++) {
+			DEVICE_DATA_TYPE value = fabs(a_buffer[k][j]);
+			if (value > max_value) {
+				max_value = value;
+				pvt = j;
+			}
+		}
+		pivots[k] = pvt;
+
+		// Exchange the columns for the current and all following rows
+		if (pvt != k) {
+			for (int i = k; i < BLOCK_SIZE; i++) {
+				DEVICE_DATA_TYPE tmp = a_buffer[i][k];
+				a_buffer[i][k] = a_buffer[i][pvt];
+				a_buffer[i][pvt] = tmp;
+			}
+		}
+
+		// Store the negative inverse of the pivot and scale the current row
+		DEVICE_DATA_TYPE inv_scale_a = -1.0 / a_buffer[k][k];
+		a_buffer[k][k] = inv_scale_a;
+		__attribute__((opencl_unroll_hint(GEMM_BLOCK)))
+		for (int j = k + 1; j < BLOCK_SIZE; j++) {
+			a_buffer[k][j] *= inv_scale_a;
+		}
+
+		// Update all following rows
+		for (int i = k + 1; i < BLOCK_SIZE; i++) {
+			DEVICE_DATA_TYPE scale = a_buffer[i][k];
+			__attribute__((opencl_unroll_hint(GEMM_BLOCK)))
+			for (int j = k + 1; j < BLOCK_SIZE; j++) {
+				a_buffer[i][j] += a_buffer[k][j] * scale;
+			}
+		}
+	}
+
+	// Store the block in global memory, separately and also transposed to allow easier access from the top kernel
+	#pragma loop_coalesce
+	for (int i =0; i < BLOCK_SIZE; i++) {
+		__attribute__((opencl_unroll_hint(GEMM_BLOCK)))
+		for (int j =0; j < BLOCK_SIZE; j++) {
+			DEVICE_DATA_TYPE value = a_buffer[i][j];
+			a[block_col * BLOCK_SIZE  + (block_row * BLOCK_SIZE + i) * BLOCK_SIZE * blocks_per_row + j] = value;
+			a_block[i * BLOCK_SIZE + j] = value;
+			a_block_trans[j * BLOCK_SIZE + i] = value;
+		}
+	}
+}
+#endif
 
 /**
 Update the blocks to the right of the current LU block
@@ -593,7 +686,11 @@ void left_update(__global DEVICE_DATA_TYPE* restrict a,
 				const uint is_first_block,
 				const uint block_col,
 				const uint block_row,
-				const uint blocks_per_row) {
+				const uint blocks_per_row
+#ifdef USE_PIVOTING
+				, __global const int* restrict pivots
+#endif
+				) {
 
 	// Store current block in local memory
 	local DEVICE_DATA_TYPE a_buffer[BLOCK_SIZE/GEMM_BLOCK][BLOCK_SIZE/GEMM_BLOCK][GEMM_BLOCK][GEMM_BLOCK] __attribute((xcl_array_partition(complete, 3),xcl_array_partition(complete, 4)));
@@ -619,6 +716,22 @@ void left_update(__global DEVICE_DATA_TYPE* restrict a,
 		int k = gk / GEMM_BLOCK;
 		int kk = gk & (GEMM_BLOCK - 1);
 
+#ifdef USE_PIVOTING
+		// Apply the column exchange of the LU block for the current step to all rows of the block
+		int pvt = pivots[gk];
+		if (pvt != gk) {
+			int pk = pvt / GEMM_BLOCK;
+			int pkk = pvt & (GEMM_BLOCK - 1);
+			for (int row = 0; row < BLOCK_SIZE/GEMM_BLOCK; row++) {
+				for (int i = 0; i < GEMM_BLOCK; i++) {
+					DEVICE_DATA_TYPE tmp = a_buffer[row][k][i][kk];
+					a_buffer[row][k][i][kk] = a_buffer[row][pk][i][pkk];
+					a_buffer[row][pk][i][pkk] = tmp;
+				}
+			}
+		}
+#endif
+
 		DEVICE_DATA_TYPE current_lu_row[BLOCK_SIZE/GEMM_BLOCK][GEMM_BLOCK] __attribute((xcl_array_partition(complete, 2)));
 		DEVICE_DATA_TYPE current_col[BLOCK_SIZE/GEMM_BLOCK][GEMM_BLOCK] __attribute((xcl_array_partition(complete, 2)));
 
@@ -0,0 +1,215 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef EXECUTION_TYPES_EXECUTION_CPU_HPP
+#define EXECUTION_TYPES_EXECUTION_CPU_HPP
+
+/* C++ standard library headers */
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+/* External library headers */
+#include "mpi.h"
+
+#include "parameters.h"
+#include "linpack_benchmark.hpp"
+
+namespace linpack {
+namespace execution {
+namespace cpu {
+
+/*
+ Calculate the blocked LU factorization on the CPU with OpenMP. The blocks are distributed over the torus
+ in the same way as for the FPGA execution and the LU, top and left blocks are exchanged with MPI broadcasts.
+ The result uses the same representation as gefa_ref_nopvt, so the validation is the same for all communication types.
+
+ @copydoc bm_execution::calculate()
+*/
+std::unique_ptr<linpack::LinpackExecutionTimings>
+calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&config,
+          HOST_DATA_TYPE* A,
+          HOST_DATA_TYPE* b,
+          cl_int* ipvt) {
+
+    const int n = config.programSettings->matrixSize;
+    const int bs = config.programSettings->blockSize;
+    const int torus_width = config.programSettings->torus_width;
+    const int torus_row = config.programSettings->torus_row;
+    const int torus_col = config.programSettings->torus_col;
+    const int blocks_per_row = n / bs;
+
+    // Communicate with all ranks in the same row of the torus
+    MPI_Comm row_communicator;
+    MPI_Comm col_communicator;
+
+    MPI_Comm_split(config.programSettings->torus_communicator, torus_row, 0, &row_communicator);
+    MPI_Comm_split(config.programSettings->torus_communicator, torus_col, 0, &col_communicator);
+
+    // Every repetition starts with the input matrix like the FPGA execution, which copies the matrix to the device
+    std::vector<HOST_DATA_TYPE> a(A, A + static_cast<size_t>(n) * n);
+    std::vector<HOST_DATA_TYPE> lu_block(bs * bs);
+    std::vector<HOST_DATA_TYPE> left_blocks(static_cast<size_t>(blocks_per_row) * bs * bs);
+    std::vector<HOST_DATA_TYPE> top_blocks(static_cast<size_t>(blocks_per_row) * bs * bs);
+#ifdef USE_PIVOTING
+    std::vector<cl_int> lu_pivot(bs);
+#endif
+
+    std::vector<double> gefaExecutionTimes;
+    std::vector<double> geslExecutionTimes;
+    for (int r = 0; r < config.programSettings->numRepetitions; r++) {
+        std::copy(A, A + static_cast<size_t>(n) * n, a.begin());
+
+        MPI_Barrier(config.communicator);
+        auto t1 = std::chrono::high_resolution_clock::now();
+
+        for (int block_row = 0; block_row < blocks_per_row * torus_width; block_row++) {
+            int local_block_row_remainder = (block_row % torus_width);
+            int local_block_row = (block_row / torus_width);
+            bool in_same_row_as_lu = local_block_row_remainder == torus_row;
+            bool in_same_col_as_lu = local_block_row_remainder == torus_col;
+            int start_row_index = local_block_row + ((local_block_row_remainder >= torus_row) ? 1: 0);
+            int start_col_index = local_block_row + ((local_block_row_remainder >= torus_col) ? 1: 0);
+            int num_left_blocks = blocks_per_row - start_row_index;
+            int num_top_blocks = blocks_per_row - start_col_index;
+
+            // Factorize the LU block and copy it to the communication buffer
+            HOST_DATA_TYPE* diag = &a[static_cast<size_t>(local_block_row) * bs * n + local_block_row * bs];
+            if (in_same_row_as_lu && in_same_col_as_lu) {
+#ifdef USE_PIVOTING
+                linpack::gefa_ref_block_pvt(diag, bs, n, bs, lu_pivot.data());
+                // Store the pivots as global row indices for the solution of the system
+                for (int i = 0; i < bs; i++) {
+                    ipvt[local_block_row * bs + i] = block_row * bs + lu_pivot[i];
+                }
+#else
+                linpack::gefa_ref_nopvt(diag, bs, n);
+#endif
+                for (int j = 0; j < bs; j++) {
+                    std::copy(&diag[static_cast<size_t>(j) * n], &diag[static_cast<size_t>(j) * n + bs], &lu_block[j * bs]);
+                }
+            }
+            MPI_Bcast(lu_block.data(), bs * bs, MPI_DATA_TYPE, local_block_row_remainder, col_communicator);
+            MPI_Bcast(lu_block.data(), bs * bs, MPI_DATA_TYPE, local_block_row_remainder, row_communicator);
+#ifdef USE_PIVOTING
+            // The row exchanges only affect the left blocks, so the pivots are only needed in the column
+            MPI_Bcast(lu_pivot.data(), bs, MPI_INT, local_block_row_remainder, col_communicator);
+#endif
+
+            // Update the top blocks right of the LU block
+            if (in_same_row_as_lu) {
+                #pragma omp parallel for schedule(static)
+                for (int tops = start_col_index; tops < blocks_per_row; tops++) {
+                    HOST_DATA_TYPE* top = &a[static_cast<size_t>(local_block_row) * bs * n + tops * bs];
+                    for (int k = 0; k < bs; k++) {
+                        for (int kk = 0; kk < k; kk++) {
+                            HOST_DATA_TYPE scale = lu_block[k * bs + kk];
+                            for (int i = 0; i < bs; i++) {
+                                top[static_cast<size_t>(k) * n + i] += top[static_cast<size_t>(kk) * n + i] * scale;
+                            }
+                        }
+                        for (int i = 0; i < bs; i++) {
+                            top[static_cast<size_t>(k) * n + i] *= lu_block[k * bs + k];
+                        }
+                    }
+                    for (int k = 0; k < bs; k++) {
+                        std::copy(&top[static_cast<size_t>(k) * n], &top[static_cast<size_t>(k) * n + bs], &top_blocks[(static_cast<size_t>(tops - start_col_index) * bs + k) * bs]);
+                    }
+                }
+            }
+
+            // Update the left blocks below the LU block
+            if (in_same_col_as_lu) {
+                #pragma omp parallel for schedule(static)
+                for (int lefts = start_row_index; lefts < blocks_per_row; lefts++) {
+                    HOST_DATA_TYPE* left = &a[static_cast<size_t>(lefts) * bs * n + local_block_row * bs];
+                    for (int j = 0; j < bs; j++) {
+                        HOST_DATA_TYPE* left_row = &left[static_cast<size_t>(j) * n];
+                        for (int k = 0; k < bs; k++) {
+#ifdef USE_PIVOTING
+                            std::swap(left_row[k], left_row[lu_pivot[k]]);
+#endif
+                            HOST_DATA_TYPE scale = left_row[k];
+                            for (int i = k + 1; i < bs; i++) {
+                                left_row[i] += lu_block[k * bs + i] * scale;
+                            }
+                        }
+                        std::copy(left_row, left_row + bs, &left_blocks[(static_cast<size_t>(lefts - start_row_index) * bs + j) * bs]);
+                    }
+                }
+            }
+
+            // Exchange the top blocks in the columns and the left blocks in the rows of the torus
+            if (num_left_blocks > 0) {
+                MPI_Bcast(left_blocks.data(), num_left_blocks * bs * bs, MPI_DATA_TYPE, local_block_row_remainder, row_communicator);
+            }
+            if (num_top_blocks > 0) {
+                MPI_Bcast(top_blocks.data(), num_top_blocks * bs * bs, MPI_DATA_TYPE, local_block_row_remainder, col_communicator);
+            }
+
+            // Update all inner blocks with the product of the left and top blocks
+            #pragma omp parallel for collapse(2) schedule(static)
+            for (int lefts = start_row_index; lefts < blocks_per_row; lefts++) {
+                for (int tops = start_col_index; tops < blocks_per_row; tops++) {
+                    const HOST_DATA_TYPE* left = &left_blocks[static_cast<size_t>(lefts - start_row_index) * bs * bs];
+                    const HOST_DATA_TYPE* top = &top_blocks[static_cast<size_t>(tops - start_col_index) * bs * bs];
+                    HOST_DATA_TYPE* inner = &a[static_cast<size_t>(lefts) * bs * n + tops * bs];
+                    for (int j = 0; j < bs; j++) {
+                        for (int k = 0; k < bs; k++) {
+                            HOST_DATA_TYPE scale = left[j * bs + k];
+                            for (int i = 0; i < bs; i++) {
+                                inner[static_cast<size_t>(j) * n + i] += top[k * bs + i] * scale;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        auto t2 = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> timespan =
+                std::chrono::duration_cast<std::chrono::duration<double>>
+                                                                    (t2 - t1);
+        gefaExecutionTimes.push_back(timespan.count());
+
+        // The system is solved during the validation like for the FPGA execution
+        geslExecutionTimes.push_back(0.0);
+    }
+
+    std::copy(a.begin(), a.end(), A);
+
+    MPI_Comm_free(&row_communicator);
+    MPI_Comm_free(&col_communicator);
+
+    std::unique_ptr<linpack::LinpackExecutionTimings> results(
+                    new linpack::LinpackExecutionTimings{gefaExecutionTimes, geslExecutionTimes});
+
+    MPI_Barrier(config.communicator);
+
+    return results;
+}
+
+}   // namespace cpu
+}   // namespace execution
+}  // namespace linpack
+
+#endif
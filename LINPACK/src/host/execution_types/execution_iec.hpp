@@ -28,6 +28,7 @@ SOFTWARE.
 #include <memory>
 #include <vector>
 #include <list>
+#include <utility>
 
 /* External library headers */
 #if QUARTUS_MAJOR_VERSION > 18
@@ -36,6 +37,8 @@ SOFTWARE.
 
 #include "parameters.h"
 #include "linpack_benchmark.hpp"
+#include "execution_types/execution_plan.hpp"
+#include "kernel_counters.hpp"
 
 namespace linpack {
 namespace execution {
@@ -64,6 +67,9 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
                                         sizeof(HOST_DATA_TYPE)*config.programSettings->matrixSize);
     cl::Buffer Buffer_pivot(*config.context, CL_MEM_READ_WRITE,
                                         sizeof(cl_int)*config.programSettings->matrixSize);
+    placement::trackBuffer(Buffer_a, memory_tracker::DEFAULT_BANK);
+    placement::trackBuffer(Buffer_b, memory_tracker::DEFAULT_BANK);
+    placement::trackBuffer(Buffer_pivot, memory_tracker::DEFAULT_BANK);
 
     // Buffers only used to store data received over the network layer
     // The content will not be modified by the host
@@ -80,6 +86,18 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
 
     /* --- Execute actual benchmark kernels --- */
 
+    // Kernels, queues and buffers are created in the first repetition and reused in all following repetitions
+    ExecutionPlan plan(*config.context, *config.device, *config.program, blocks_per_row * config.programSettings->torus_width);
+
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+    // The slots are ordered like in the kernel code: the three network kernels followed by the inner update replications
+    std::vector<std::string> counter_names({"network_layer_bottomright", "network_layer_top", "network_layer_left"});
+    for (int r = 0; r < config.programSettings->kernelReplications; r++) {
+        counter_names.push_back("inner_update_mm" + std::to_string(r));
+    }
+    kernel_counters::KernelCounters counters(*config.context, counter_names);
+#endif
+
     double t;
     std::vector<double> gefaExecutionTimes;
     std::vector<double> geslExecutionTimes;
@@ -93,10 +111,13 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
                                     sizeof(HOST_DATA_TYPE)*config.programSettings->matrixSize, b);
         ASSERT_CL(err)
         buffer_queue.finish();
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+        counters.reset(buffer_queue);
+#endif
 
         // Command queues 
-        // A new command queue is created for every iteration of the algorithm to reduce the overhead
-        // of too large queues
+        // A separate command queue is used for every iteration of the algorithm to reduce the overhead
+        // of too large queues. The queues are taken from the execution plan, so they are only created once.
         std::vector<cl::CommandQueue> lu_queues;
         std::vector<cl::CommandQueue> top_queues;
         std::vector<cl::CommandQueue> left_queues;
@@ -119,11 +140,12 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
         left_buffers.emplace_back();
         top_buffers.emplace_back();
         kernels.emplace_back();
-        inner_queues.emplace_back();
-        for (uint rep = 0; rep < config.programSettings->kernelReplications; rep++) {
-            inner_queues.back().emplace_back(*config.context, *config.device, 0, &err);
-            ASSERT_CL(err)
-        }
+        // Separate queues for the update of the first block row and column of the trailing matrix of every step.
+        // These blocks form the panel of the next step, so they are not queued behind the remaining inner updates.
+        std::vector<std::vector<cl::CommandQueue>> panel_queues;
+        // Events of the trailing updates of the previous step that modify the panel of the current step
+        std::vector<std::vector<cl::Event>> lookahead_events;
+        lookahead_events.emplace_back();
 
         std::chrono::time_point<std::chrono::high_resolution_clock> t1, t2, twait1, twait2;
         std::chrono::duration<double> currentwaittime = std::chrono::duration<double>::zero();
@@ -131,27 +153,34 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
         uint current_replication = 0;
 
         std::cout << "Torus " << config.programSettings->torus_row << "," << config.programSettings->torus_col <<  "Start! " << std::endl;
-        MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Barrier(config.communicator);
         t1 = std::chrono::high_resolution_clock::now();
         // Trigger the user event that will start the first tasks in the queue
         start_event.setStatus(CL_COMPLETE);
 
         // For every row of blocks create kernels and enqueue them
         for (int block_row=0; block_row < config.programSettings->matrixSize / config.programSettings->blockSize * config.programSettings->torus_width; block_row++) {
+            tracing::ScopedSpan enqueue_span("Enqueue block row " + std::to_string(block_row));
+
+            // Indices of the kernels, queues and buffers of this step in the execution plan
+            uint plan_kernel = 0;
+            uint plan_queue = 0;
+            uint plan_buffer = 0;
 
             // Create Command queues
-            lu_queues.emplace_back(*config.context, *config.device, 0, &err);
-            ASSERT_CL(err)
-            top_queues.emplace_back(*config.context, *config.device, 0, &err);
-            ASSERT_CL(err)
-            left_queues.emplace_back(*config.context, *config.device, 0, &err);
-            ASSERT_CL(err)
-            network_queues_bottomright.emplace_back(*config.context, *config.device, 0, &err);
-            ASSERT_CL(err)
-            network_queues_top.emplace_back(*config.context, *config.device, 0, &err);
-            ASSERT_CL(err)
-            network_queues_left.emplace_back(*config.context, *config.device, 0, &err);
-            ASSERT_CL(err)
+            lu_queues.push_back(plan.getQueue(block_row, plan_queue++));
+            top_queues.push_back(plan.getQueue(block_row, plan_queue++));
+            left_queues.push_back(plan.getQueue(block_row, plan_queue++));
+            network_queues_bottomright.push_back(plan.getQueue(block_row, plan_queue++));
+            network_queues_top.push_back(plan.getQueue(block_row, plan_queue++));
+            network_queues_left.push_back(plan.getQueue(block_row, plan_queue++));
+            panel_queues.emplace_back();
+            for (uint rep = 0; rep < config.programSettings->kernelReplications; rep++) {
+                panel_queues.back().push_back(plan.getQueue(block_row, plan_queue++));
+            }
+
+            // The events of the communication kernels of this step will be appended to this list
+            size_t num_previous_events = all_events.back().size();
 
             // already emplace new buffer list for next iteration since left and top buffers need to be stored until all MMs are executed.
             // this is only the case after the next iteration is finished, because the inner MMs are calculated overlapped with the next iteration!
@@ -177,8 +206,7 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
 
             if (is_calulating_lu_block) {
                 // create the LU kernel
-                kernels.back().emplace_back(*config.program, "lu",
-                                            &err);
+                kernels.back().push_back(plan.getKernel(block_row, plan_kernel++, "lu"));
 #ifndef NDEBUG
                 std::cout << "Torus " << config.programSettings->torus_row << "," << config.programSettings->torus_col << " LU     " << local_block_row << "," << local_block_row <<  std::endl;
 #endif
@@ -201,8 +229,7 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
             if (num_top_blocks > 0) {
                 // Create top kernels
                 for (int tops=start_col_index; tops < (config.programSettings->matrixSize / config.programSettings->blockSize); tops++) {
-                    kernels.back().emplace_back(*config.program, "top_update",
-                                                    &err);
+                    kernels.back().push_back(plan.getKernel(block_row, plan_kernel++, "top_update"));
 #ifndef NDEBUG
                     std::cout << "Torus " << config.programSettings->torus_row << "," << config.programSettings->torus_col << " Top    " << local_block_row << "," << tops <<  std::endl;
 #endif
@@ -238,8 +265,7 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
             if (num_left_blocks > 0) {
                 // Create left kernels
                 for (int tops=start_row_index; tops < (config.programSettings->matrixSize / config.programSettings->blockSize); tops++) {
-                    kernels.back().emplace_back(*config.program, "left_update",
-                                                    &err);
+                    kernels.back().push_back(plan.getKernel(block_row, plan_kernel++, "left_update"));
 #ifndef NDEBUG
                     std::cout << "Torus " << config.programSettings->torus_row << "," << config.programSettings->torus_col <<  " Left   " <<tops  << "," << local_block_row <<  std::endl;
 #endif
@@ -308,20 +334,19 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
                 bool left_block_is_received = num_inner_block_rows > nw_exe_count;
                 bool top_block_is_received = num_inner_block_cols > nw_exe_count;
                 if (left_block_is_received) {
-                    left_buffers.back().emplace_back(*config.context, CL_MEM_READ_WRITE,
-                                        sizeof(HOST_DATA_TYPE)*config.programSettings->blockSize*config.programSettings->blockSize);
+                    left_buffers.back().push_back(plan.getBuffer(block_row, plan_buffer++, CL_MEM_READ_WRITE,
+                                        sizeof(HOST_DATA_TYPE)*config.programSettings->blockSize*config.programSettings->blockSize));
                     op_flags |= STORE_LEFT_INNER;
                 }
                 if (top_block_is_received) {
-                    top_buffers.back().emplace_back(*config.context, CL_MEM_READ_WRITE,
-                                        sizeof(HOST_DATA_TYPE)*config.programSettings->blockSize*config.programSettings->blockSize);
+                    top_buffers.back().push_back(plan.getBuffer(block_row, plan_buffer++, CL_MEM_READ_WRITE,
+                                        sizeof(HOST_DATA_TYPE)*config.programSettings->blockSize*config.programSettings->blockSize));
                     op_flags |= STORE_TOP_INNER;
                 }
 
                 if (it == network_layer_op_flags.begin()) {
                     // Create the network kernel
-                    kernels.back().emplace_back(*config.program, "network_layer_bottomright",
-                                                &err);
+                    kernels.back().push_back(plan.getKernel(block_row, plan_kernel++, "network_layer_bottomright"));
     #ifndef NDEBUG
                     std::cout << "Torus " << config.programSettings->torus_row << "," << config.programSettings->torus_col <<  " Nw ->    " << op_flags << "," << network_forward_flags <<  std::endl;
     #endif
@@ -330,13 +355,15 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
                     ASSERT_CL(err)
                     err = kernels.back().back().setArg(1, network_forward_flags);
                     ASSERT_CL(err)
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+                    counters.setKernelArg(kernels.back().back(), 2);
+#endif
                     
                     err = network_queues_bottomright.back().enqueueNDRangeKernel(kernels.back().back(), cl::NullRange, cl::NDRange(1), cl::NDRange(1), &(*std::prev(std::prev(all_events.end()))));
                     ASSERT_CL(err) 
                 }
                 // Create the network kernel for down -> top direction
-                kernels.back().emplace_back(*config.program, "network_layer_top",
-                                            &err);
+                kernels.back().push_back(plan.getKernel(block_row, plan_kernel++, "network_layer_top"));
     #ifndef NDEBUG
                 std::cout << "Torus " << config.programSettings->torus_row << "," << config.programSettings->torus_col <<  " Nw T <-    " << op_flags << "," << network_forward_flags <<  std::endl;
     #endif
@@ -347,6 +374,9 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
                 ASSERT_CL(err)
                 err = kernels.back().back().setArg(2, network_forward_flags);
                 ASSERT_CL(err)
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+                counters.setKernelArg(kernels.back().back(), 3);
+#endif
 
                 if (std::distance(it,network_layer_op_flags.end()) == 1) {
                     all_events.back().emplace_back();
@@ -359,8 +389,7 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
                 }
 
                 // Create the network kernel for right -> left direction
-                kernels.back().emplace_back(*config.program, "network_layer_left",
-                                            &err);
+                kernels.back().push_back(plan.getKernel(block_row, plan_kernel++, "network_layer_left"));
     #ifndef NDEBUG
                 std::cout << "Torus " << config.programSettings->torus_row << "," << config.programSettings->torus_col <<  " Nw L <-    " << op_flags << "," << network_forward_flags <<  std::endl;
     #endif
@@ -371,6 +400,9 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
                 ASSERT_CL(err)
                 err = kernels.back().back().setArg(2, network_forward_flags);
                 ASSERT_CL(err)
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+                counters.setKernelArg(kernels.back().back(), 3);
+#endif
 
                 if (std::distance(it,network_layer_op_flags.end()) == 1) {
                     all_events.back().emplace_back();
@@ -386,10 +418,14 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
 
             }
 
+            // The panel update only has to wait for the communication of this step and the look-ahead updates of the
+            // previous step. The remaining inner updates of the previous step may still be executed in parallel.
+            std::vector<cl::Event> panel_wait_events(all_events.back().begin() + num_previous_events, all_events.back().end());
+            panel_wait_events.insert(panel_wait_events.end(), lookahead_events.back().begin(), lookahead_events.back().end());
+
             // update all remaining inner blocks using only global memory
 
             all_events.emplace_back(all_events.back());
-            //auto communication_events = all_events.back();
 
             uint current_update = 0;
             uint total_inner_updates_first_row = top_buffers.back().size();
@@ -398,8 +434,7 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
             uint total_updates_per_replication = total_inner_updates/ config.programSettings->kernelReplications;
             for (auto l = std::next(left_buffers.back().begin()); l < left_buffers.back().end(); l++) {
                 // select the matrix multiplication kernel that should be used for this block updated 
-                kernels.back().emplace_back(*config.program, ("inner_update_mm" + std::to_string(current_replication)).c_str(),
-                                    &err);
+                kernels.back().push_back(plan.getKernel(block_row, plan_kernel++, ("inner_update_mm" + std::to_string(current_replication)).c_str()));
 
                 int block_col = static_cast<cl_uint>((config.programSettings->matrixSize / config.programSettings->blockSize) - num_inner_block_cols);
                 int block_row = static_cast<cl_uint>((config.programSettings->matrixSize / config.programSettings->blockSize) - num_inner_block_rows + std::distance(left_buffers.back().begin(), l));  
@@ -416,6 +451,9 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
                 ASSERT_CL(err)
                 err = kernels.back().back().setArg(5, blocks_per_row);
                 ASSERT_CL(err)
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+                counters.setKernelArg(kernels.back().back(), 6);
+#endif
 
                 if ((left_buffers.back().size() - 1) - current_update <= config.programSettings->kernelReplications) {
 #ifndef NDEBUG
@@ -424,16 +462,14 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
                     // this is the last taks that will be enqueued in this queue, so create an event
                     all_events.back().emplace_back();
                     // Distribute the workload over all available matrix multiplication kernels
-                    err = inner_queues.back()[(current_replication)].enqueueNDRangeKernel(kernels.back().back(), cl::NullRange, cl::NDRange(1), cl::NDRange(1),  &(*std::prev(std::prev(all_events.end()))), &(all_events.back().back()));         
-                    //err = inner_queues.back()[(current_replication)].enqueueNDRangeKernel(kernels.back().back(), cl::NullRange, cl::NDRange(1), cl::NDRange(1),  &communication_events, &(all_events.back().back()));         
+                    err = panel_queues.back()[(current_replication)].enqueueNDRangeKernel(kernels.back().back(), cl::NullRange, cl::NDRange(1), cl::NDRange(1),  &panel_wait_events, &(all_events.back().back()));
                 }
                 else {
 #ifndef NDEBUG
                     std::cout << "Torus " << config.programSettings->torus_row << "," << config.programSettings->torus_col << " Inner L " << block_row << "," << block_col <<  std::endl;
 #endif 
                     // Distribute the workload over all available matrix multiplication kernels
-                    err = inner_queues.back()[(current_replication)].enqueueNDRangeKernel(kernels.back().back(), cl::NullRange, cl::NDRange(1), cl::NDRange(1),  &(*std::prev(std::prev(all_events.end()))));         
-                    //err = inner_queues.back()[(current_replication)].enqueueNDRangeKernel(kernels.back().back(), cl::NullRange, cl::NDRange(1), cl::NDRange(1),  &communication_events);         
+                    err = panel_queues.back()[(current_replication)].enqueueNDRangeKernel(kernels.back().back(), cl::NullRange, cl::NDRange(1), cl::NDRange(1),  &panel_wait_events);
                 }
                 current_update++;
                 current_replication = (current_replication + 1) % config.programSettings->kernelReplications;
@@ -442,8 +478,7 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
             current_update = 0;
             for (auto t = top_buffers.back().begin(); t < top_buffers.back().end(); t++) {
                 // select the matrix multiplication kernel that should be used for this block updated 
-                kernels.back().emplace_back(*config.program, ("inner_update_mm" + std::to_string(current_replication)).c_str(),
-                                    &err);
+                kernels.back().push_back(plan.getKernel(block_row, plan_kernel++, ("inner_update_mm" + std::to_string(current_replication)).c_str()));
 
                 int block_col = static_cast<cl_uint>((config.programSettings->matrixSize / config.programSettings->blockSize) - num_inner_block_cols + std::distance(top_buffers.back().begin(), t));
                 int block_row = static_cast<cl_uint>((config.programSettings->matrixSize / config.programSettings->blockSize) - num_inner_block_rows);
@@ -461,6 +496,9 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
                 ASSERT_CL(err)
                 err = kernels.back().back().setArg(5, blocks_per_row);
                 ASSERT_CL(err)
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+                counters.setKernelArg(kernels.back().back(), 6);
+#endif
                 // If number of blocks is not dividable by the number of replications, the first replications will do one update more
                 if (top_buffers.back().size() - current_update <= config.programSettings->kernelReplications) {
 #ifndef NDEBUG
@@ -469,14 +507,14 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
                     // this is the last taks that will be enqueued in this queue, so create an event
                     all_events.back().emplace_back();
                     // Distribute the workload over all available matrix multiplication kernels
-                    err = inner_queues.back()[(current_replication)].enqueueNDRangeKernel(kernels.back().back(), cl::NullRange, cl::NDRange(1), cl::NDRange(1),  &(*std::prev(std::prev(all_events.end()))), &(all_events.back().back()));         
+                    err = panel_queues.back()[(current_replication)].enqueueNDRangeKernel(kernels.back().back(), cl::NullRange, cl::NDRange(1), cl::NDRange(1),  &panel_wait_events, &(all_events.back().back()));
                 }
                 else {
 #ifndef NDEBUG
                     std::cout << "Torus " << config.programSettings->torus_row << "," << config.programSettings->torus_col << " Inner T " << block_row << "," << block_col <<  std::endl;
 #endif 
                     // Distribute the workload over all available matrix multiplication kernels
-                    err = inner_queues.back()[(current_replication)].enqueueNDRangeKernel(kernels.back().back(), cl::NullRange, cl::NDRange(1), cl::NDRange(1),  &(*std::prev(std::prev(all_events.end()))));         
+                    err = panel_queues.back()[(current_replication)].enqueueNDRangeKernel(kernels.back().back(), cl::NullRange, cl::NDRange(1), cl::NDRange(1),  &panel_wait_events);
                 }
                 ASSERT_CL(err) 
                 current_update++;
@@ -489,104 +527,93 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
             inner_queues.emplace_back();
             current_update = 0;
             for (uint rep = 0; rep < config.programSettings->kernelReplications; rep++) {
-                inner_queues.back().emplace_back(*config.context, *config.device, 0, &err);
-                ASSERT_CL(err)
+                inner_queues.back().push_back(plan.getQueue(block_row, plan_queue++));
             }
 
-            for (auto l = std::next(left_buffers.back().begin()); l < left_buffers.back().end(); l++) {
-                for (auto t = std::next(top_buffers.back().begin()); t < top_buffers.back().end(); t++) {
-                    // select the matrix multiplication kernel that should be used for this block updated 
-                    kernels.back().emplace_back(*config.program, ("inner_update_mm" + std::to_string(current_replication)).c_str(),
-                                        &err);
-
-                    int block_col = static_cast<cl_uint>((config.programSettings->matrixSize / config.programSettings->blockSize) - num_inner_block_cols + std::distance(top_buffers.back().begin(), t));
-                    int block_row = static_cast<cl_uint>((config.programSettings->matrixSize / config.programSettings->blockSize) - num_inner_block_rows + std::distance(left_buffers.back().begin(), l));
-  
-                    ASSERT_CL(err);
-                    err = kernels.back().back().setArg(0, Buffer_a);
-                    ASSERT_CL(err);
-                    err = kernels.back().back().setArg(1, *l);
-                    ASSERT_CL(err)
-                    err = kernels.back().back().setArg(2, *t);
-                    ASSERT_CL(err)
-                    err = kernels.back().back().setArg(3, block_col);
-                    ASSERT_CL(err)
-                    err = kernels.back().back().setArg(4, block_row);
-                    ASSERT_CL(err)
-                    err = kernels.back().back().setArg(5, blocks_per_row);
-                    ASSERT_CL(err)
+            // Order the trailing updates so that the blocks which belong to the panel of the next step are updated first.
+            // Their completion is tracked in a separate list of events, so the panel update and the LU of the next step
+            // can start while the remaining trailing blocks of this step are still updated (look-ahead).
+            int next_block_row_remainder = ((block_row + 1) % config.programSettings->torus_width);
+            int next_local_block_row = ((block_row + 1) / config.programSettings->torus_width);
+            int next_start_row_index = next_local_block_row + ((next_block_row_remainder >= config.programSettings->torus_row) ? 1: 0);
+            int next_start_col_index = next_local_block_row + ((next_block_row_remainder >= config.programSettings->torus_col) ? 1: 0);
+            // Pairs of indices into the left and top buffers of this step
+            std::vector<std::pair<uint, uint>> trailing_updates;
+            std::vector<std::pair<uint, uint>> remaining_updates;
+            for (uint l = 1; l < left_buffers.back().size(); l++) {
+                for (uint t = 1; t < top_buffers.back().size(); t++) {
+                    int update_block_col = blocks_per_row - num_inner_block_cols + t;
+                    int update_block_row = blocks_per_row - num_inner_block_rows + l;
+                    if (update_block_row == next_start_row_index || update_block_col == next_start_col_index) {
+                        trailing_updates.emplace_back(l, t);
+                    }
+                    else {
+                        remaining_updates.emplace_back(l, t);
+                    }
+                }
+            }
+            uint num_lookahead_updates = trailing_updates.size();
+            trailing_updates.insert(trailing_updates.end(), remaining_updates.begin(), remaining_updates.end());
+            lookahead_events.emplace_back();
+
+            for (auto u = trailing_updates.begin(); u < trailing_updates.end(); u++) {
+                // select the matrix multiplication kernel that should be used for this block updated 
+                kernels.back().push_back(plan.getKernel(block_row, plan_kernel++, ("inner_update_mm" + std::to_string(current_replication)).c_str()));
+
+                int block_col = static_cast<cl_uint>((config.programSettings->matrixSize / config.programSettings->blockSize) - num_inner_block_cols + u->second);
+                int block_row = static_cast<cl_uint>((config.programSettings->matrixSize / config.programSettings->blockSize) - num_inner_block_rows + u->first);
+
+                ASSERT_CL(err);
+                err = kernels.back().back().setArg(0, Buffer_a);
+                ASSERT_CL(err);
+                err = kernels.back().back().setArg(1, left_buffers.back()[u->first]);
+                ASSERT_CL(err)
+                err = kernels.back().back().setArg(2, top_buffers.back()[u->second]);
+                ASSERT_CL(err)
+                err = kernels.back().back().setArg(3, block_col);
+                ASSERT_CL(err)
+                err = kernels.back().back().setArg(4, block_row);
+                ASSERT_CL(err)
+                err = kernels.back().back().setArg(5, blocks_per_row);
+                ASSERT_CL(err)
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+                counters.setKernelArg(kernels.back().back(), 6);
+#endif
 
-                    // If number of blocks is not dividable by the number of replications, the first replications will do one update more
-                    if (((top_buffers.back().size() - 1) * (left_buffers.back().size() - 1)) - current_update <= config.programSettings->kernelReplications) {
+                // The last look-ahead updates in every queue additionally create an event that is used by the next step
+                bool is_last_lookahead_update = (current_update < num_lookahead_updates) && (num_lookahead_updates - current_update <= config.programSettings->kernelReplications);
+                // If number of blocks is not dividable by the number of replications, the first replications will do one update more
+                if ((trailing_updates.size() - current_update <= config.programSettings->kernelReplications) || is_last_lookahead_update) {
 #ifndef NDEBUG
                     std::cout << "Torus " << config.programSettings->torus_row << "," << config.programSettings->torus_col << " Inner Ev " << block_row << "," << block_col <<  std::endl;
 #endif 
-                        // this is the last taks that will be enqueued in this queue, so create an event
-                        all_events.back().emplace_back();
-                        // Distribute the workload over all available matrix multiplication kernels
-                        err = inner_queues.back()[(current_replication)].enqueueNDRangeKernel(kernels.back().back(), cl::NullRange, cl::NDRange(1), cl::NDRange(1),  &(*std::prev(std::prev(all_events.end()))), &(all_events.back().back()));
+                    // this is the last taks that will be enqueued in this queue, so create an event
+                    all_events.back().emplace_back();
+                    // Distribute the workload over all available matrix multiplication kernels
+                    err = inner_queues.back()[(current_replication)].enqueueNDRangeKernel(kernels.back().back(), cl::NullRange, cl::NDRange(1), cl::NDRange(1),  &(*std::prev(std::prev(all_events.end()))), &(all_events.back().back()));
+                    if (is_last_lookahead_update) {
+                        lookahead_events.back().push_back(all_events.back().back());
                     }
-                    else {
+                }
+                else {
 #ifndef NDEBUG
                     std::cout << "Torus " << config.programSettings->torus_row << "," << config.programSettings->torus_col << " Inner " << block_row << "," << block_col <<  std::endl;
 #endif 
-                        // Distribute the workload over all available matrix multiplication kernels
-                        err = inner_queues.back()[(current_replication)].enqueueNDRangeKernel(kernels.back().back(), cl::NullRange, cl::NDRange(1), cl::NDRange(1),  &(*std::prev(std::prev(all_events.end()))));
-                    }
-
-                    ASSERT_CL(err)
-                    current_update++;
-                    current_replication = (current_replication + 1) % config.programSettings->kernelReplications;
-//             uint total_inner_updates = left_buffers.back().size() * top_buffers.back().size();
-//             uint updates_per_replication = total_inner_updates / config.programSettings->kernelReplications;
-//             for (auto l = left_buffers.back().begin(); l < left_buffers.back().end(); l++) {
-//                 for (auto t = top_buffers.back().begin(); t < top_buffers.back().end(); t++) {
-//                     // select the matrix multiplication kernel that should be used for this block updated 
-//                     kernels.back().emplace_back(*config.program, ("inner_update_mm" + std::to_string(current_replication)).c_str(),
-//                                         &err);
-
-//                     int block_col = static_cast<cl_uint>((config.programSettings->matrixSize / config.programSettings->blockSize) - num_inner_block_cols + std::distance(top_buffers.back().begin(), t));
-//                     int block_row = static_cast<cl_uint>((config.programSettings->matrixSize / config.programSettings->blockSize) - num_inner_block_rows + std::distance(left_buffers.back().begin(), l));
-// #ifndef NDEBUG
-//                     std::cout << "Torus " << config.programSettings->torus_row << "," << config.programSettings->torus_col << " Inner " << block_row << "," << block_col <<  std::endl;
-// #endif   
-//                     ASSERT_CL(err);
-//                     err = kernels.back().back().setArg(0, Buffer_a);
-//                     ASSERT_CL(err);
-//                     err = kernels.back().back().setArg(1, *l);
-//                     ASSERT_CL(err)
-//                     err = kernels.back().back().setArg(2, *t);
-//                     ASSERT_CL(err)
-//                     err = kernels.back().back().setArg(3, block_col);
-//                     ASSERT_CL(err)
-//                     err = kernels.back().back().setArg(4, block_row);
-//                     ASSERT_CL(err)
-//                     err = kernels.back().back().setArg(5, blocks_per_row);
-//                     ASSERT_CL(err)
-//                     // If number of blocks is not dividable by the number of replications, the first replications will do one update more
-//                     uint updates_for_current_replication = updates_per_replication + ((current_replication < total_inner_updates % config.programSettings->kernelReplications) ? 1 : 0);
-//                     if ((current_update + 1) == updates_for_current_replication) {
-//                         // this is the last taks that will be enqueued in this queue, so create an event
-//                         all_events.back().emplace_back();
-//                         // Distribute the workload over all available matrix multiplication kernels
-//                         err = inner_queues.back()[(current_replication) + 1].enqueueNDRangeKernel(kernels.back().back(), cl::NullRange, cl::NDRange(1), cl::NDRange(1),  &(*std::prev(std::prev(all_events.end()))), &(all_events.back().back()));         
-//                         current_update = 0;
-//                         current_replication++;
-//                     }
-//                     else {
-//                         // Distribute the workload over all available matrix multiplication kernels
-//                         err = inner_queues.back()[(current_replication) + 1].enqueueNDRangeKernel(kernels.back().back(), cl::NullRange, cl::NDRange(1), cl::NDRange(1),  &(*std::prev(std::prev(all_events.end()))));         
-//                         current_update++;
-//                     }
+                    // Distribute the workload over all available matrix multiplication kernels
+                    err = inner_queues.back()[(current_replication)].enqueueNDRangeKernel(kernels.back().back(), cl::NullRange, cl::NDRange(1), cl::NDRange(1),  &(*std::prev(std::prev(all_events.end()))));
                 }
+
+                ASSERT_CL(err)
+                current_update++;
+                current_replication = (current_replication + 1) % config.programSettings->kernelReplications;
             }
 #ifndef NDEBUG
-            MPI_Barrier(MPI_COMM_WORLD);
+            MPI_Barrier(config.communicator);
             if (is_calulating_lu_block) std::cout << "---------------" << std::endl;
 
             // // Execute GEFA
             if (block_row == 0) {
-                MPI_Barrier(MPI_COMM_WORLD);
+                MPI_Barrier(config.communicator);
                 t1 = std::chrono::high_resolution_clock::now();
                 // Trigger the user event that will start the first tasks in the queue
                 start_event.setStatus(CL_COMPLETE);
@@ -656,6 +683,7 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
         }
 #ifdef NDEBUG
 
+        tracing::ScopedSpan wait_span("Wait for completion");
         int count = 0;
         for (auto evs = all_events.end() - config.programSettings->torus_width; evs != all_events.end(); evs++) {
             cl::Event::waitForEvents(*evs);
@@ -675,6 +703,10 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
                 std::chrono::duration_cast<std::chrono::duration<double>>
                                                                     (t2 - t1);
         gefaExecutionTimes.push_back(timespan.count());
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+        counters.read(buffer_queue);
+        counters.print(i);
+#endif
 
         // Execute GESL
         t1 = std::chrono::high_resolution_clock::now();
@@ -721,7 +753,7 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
     std::unique_ptr<linpack::LinpackExecutionTimings> results(
                     new linpack::LinpackExecutionTimings{gefaExecutionTimes, geslExecutionTimes});
     
-    MPI_Barrier(MPI_COMM_WORLD);
+    MPI_Barrier(config.communicator);
 
     return results;
 }
@@ -38,11 +38,99 @@ SOFTWARE.
 
 #include "parameters.h"
 #include "linpack_benchmark.hpp"
+#include "execution_types/execution_plan.hpp"
+#include "shared_memory.hpp"
 
 namespace linpack {
 namespace execution {
 namespace pcie {
 
+/**
+ * @brief Broadcast blocks from the root to all ranks of a communicator.
+ *          If all ranks of the communicator are on the same node, the blocks are not copied.
+ *          Instead, the ranks directly read the blocks from the segment of the root in the shared buffer.
+ *
+ * @tparam T Data type of the blocks
+ * @param buffer The shared buffer of the communicator that contains the blocks
+ * @param blocks Pointers to the blocks in the local segment of the shared buffer
+ * @param count Number of values in every block
+ * @param type MPI data type of the values
+ * @param root Rank that sends the blocks
+ * @param comm Communicator used for the broadcast
+ * @param requests If not null, the blocks are broadcast with non-blocking collectives and the requests are appended
+ *                  to this list. The received blocks can only be used after the requests are completed.
+ * @return std::vector<T*> Pointers to the received blocks. They point into the segment of the root if the blocks were
+ *                          not copied
+ */
+template<typename T>
+std::vector<T*>
+broadcastBlocks(shared_memory::NodeSharedBuffer &buffer, const std::vector<T*> &blocks, int count,
+                    MPI_Datatype type, int root, MPI_Comm comm, std::vector<MPI_Request> *requests = nullptr) {
+    if (buffer.isNodeLocal()) {
+        buffer.fence(comm);
+        std::vector<T*> root_blocks;
+        for (T* block : blocks) {
+            root_blocks.push_back(buffer.translate(block, root));
+        }
+        return root_blocks;
+    }
+    for (T* block : blocks) {
+        if (requests) {
+            requests->emplace_back();
+            MPI_Ibcast(block, count, type, root, comm, &requests->back());
+        }
+        else {
+            MPI_Bcast(block, count, type, root, comm);
+        }
+    }
+    return blocks;
+}
+
+/**
+ * @brief Broadcast blocks that are read back from the FPGA with non-blocking collectives.
+ *          The root starts the broadcast of every block as soon as the block is read back, so the transfers over
+ *          PCIe and the network overlap. If the blocks are exchanged over shared memory, the root waits for all blocks.
+ *
+ * @tparam T Data type of the blocks
+ * @param buffer The shared buffer of the communicator that contains the blocks
+ * @param blocks Pointers to the blocks in the local segment of the shared buffer
+ * @param read_events Events of the read operations of the blocks on the root. Events of blocks that are not read
+ *                      back from the FPGA are empty.
+ * @param count Number of values in every block
+ * @param type MPI data type of the values
+ * @param root Rank that sends the blocks
+ * @param comm Communicator used for the broadcast
+ * @param requests The requests of the broadcasts are appended to this list in the order of the blocks
+ * @return std::vector<T*> Pointers to the received blocks as returned by broadcastBlocks()
+ */
+template<typename T>
+std::vector<T*>
+startPipelinedBroadcast(shared_memory::NodeSharedBuffer &buffer, const std::vector<T*> &blocks, std::vector<cl::Event> &read_events,
+                    int count, MPI_Datatype type, int root, MPI_Comm comm, std::vector<MPI_Request> &requests) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    if (buffer.isNodeLocal()) {
+        if (rank == root) {
+            tracing::ScopedSpan span("Wait for blocks");
+            for (auto &ev : read_events) {
+                if (ev() != nullptr) {
+                    ev.wait();
+                }
+            }
+        }
+        return broadcastBlocks(buffer, blocks, count, type, root, comm);
+    }
+    for (size_t i = 0; i < blocks.size(); i++) {
+        if (rank == root && i < read_events.size() && read_events[i]() != nullptr) {
+            tracing::ScopedSpan span("Wait for block");
+            read_events[i].wait();
+        }
+        requests.emplace_back();
+        MPI_Ibcast(blocks[i], count, type, root, comm, &requests.back());
+    }
+    return blocks;
+}
+
 /*
  Prepare kernels and execute benchmark
 
@@ -62,8 +150,8 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
     MPI_Comm row_communicator;
     MPI_Comm col_communicator;
 
-    MPI_Comm_split(MPI_COMM_WORLD, config.programSettings->torus_row, 0, &row_communicator);
-    MPI_Comm_split(MPI_COMM_WORLD, config.programSettings->torus_col, 0, &col_communicator);
+    MPI_Comm_split(config.programSettings->torus_communicator, config.programSettings->torus_row, 0, &row_communicator);
+    MPI_Comm_split(config.programSettings->torus_communicator, config.programSettings->torus_col, 0, &col_communicator);
 
     cl::CommandQueue buffer_queue(*config.context, *config.device, 0, &err);
     ASSERT_CL(err)
@@ -75,12 +163,29 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
                                         sizeof(HOST_DATA_TYPE)*config.programSettings->matrixSize);
     cl::Buffer Buffer_pivot(*config.context, CL_MEM_READ_WRITE,
                                         sizeof(cl_int)*config.programSettings->matrixSize);
+    placement::trackBuffer(Buffer_a, memory_tracker::DEFAULT_BANK);
+    placement::trackBuffer(Buffer_b, memory_tracker::DEFAULT_BANK);
+    placement::trackBuffer(Buffer_pivot, memory_tracker::DEFAULT_BANK);
 
 
     /* --- Setup MPI communication and required additional buffers --- */
-    HOST_DATA_TYPE *lu_block, *lu_trans_block;
-    posix_memalign(reinterpret_cast<void**>(&lu_block), 4096, sizeof(HOST_DATA_TYPE) * (config.programSettings->blockSize)*(config.programSettings->blockSize));
-    posix_memalign(reinterpret_cast<void**>(&lu_trans_block), 4096, sizeof(HOST_DATA_TYPE) * (config.programSettings->blockSize)*(config.programSettings->blockSize));
+    // All blocks that are broadcast in a row or column of the torus are placed in a shared buffer of the communicator.
+    // If all ranks of the communicator are on the same node, the receivers directly read the blocks of the sender.
+    size_t block_bytes = ((sizeof(HOST_DATA_TYPE) * config.programSettings->blockSize * config.programSettings->blockSize
+                            + shared_memory::SEGMENT_ALIGNMENT - 1) / shared_memory::SEGMENT_ALIGNMENT) * shared_memory::SEGMENT_ALIGNMENT;
+    // Contains the transposed LU block followed by the left blocks
+    shared_memory::NodeSharedBuffer row_shared(row_communicator, block_bytes * (blocks_per_row + 1), config.programSettings->useSharedMemory);
+    // Contains the LU block followed by the top blocks and the pivots
+    shared_memory::NodeSharedBuffer col_shared(col_communicator, block_bytes * (blocks_per_row + 1) + sizeof(cl_int) * config.programSettings->blockSize,
+                                                config.programSettings->useSharedMemory);
+    HOST_DATA_TYPE *lu_block = col_shared.data<HOST_DATA_TYPE>();
+    HOST_DATA_TYPE *lu_trans_block = row_shared.data<HOST_DATA_TYPE>();
+#ifdef USE_PIVOTING
+    // Pivots of the current LU block given as index within the block
+    cl_int *lu_pivot = col_shared.data<cl_int>(block_bytes * (blocks_per_row + 1));
+    cl::Buffer Buffer_lu_pivot(*config.context, CL_MEM_READ_WRITE,
+                                        sizeof(cl_int)*(config.programSettings->blockSize));
+#endif
 
     // Buffers only used to store data received over the network layer
     // The content will not be modified by the host
@@ -95,8 +200,8 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
     std::vector<HOST_DATA_TYPE*> top_blocks(blocks_per_row);
 
     for (int i =0; i < blocks_per_row; i++) {
-        posix_memalign(reinterpret_cast<void**>(&(left_blocks[i])), 4096, sizeof(HOST_DATA_TYPE) * (config.programSettings->blockSize)*(config.programSettings->blockSize));
-        posix_memalign(reinterpret_cast<void**>(&(top_blocks[i])), 4096, sizeof(HOST_DATA_TYPE) * (config.programSettings->blockSize)*(config.programSettings->blockSize));
+        left_blocks[i] = row_shared.data<HOST_DATA_TYPE>(block_bytes * (i + 1));
+        top_blocks[i] = col_shared.data<HOST_DATA_TYPE>(block_bytes * (i + 1));
         Buffer_top_list.emplace_back(*config.context, CL_MEM_USE_HOST_PTR | CL_MEM_WRITE_ONLY,
                                         sizeof(HOST_DATA_TYPE)*config.programSettings->blockSize * (config.programSettings->blockSize), top_blocks[i]);
         Buffer_left_list.emplace_back(*config.context, CL_MEM_USE_HOST_PTR | CL_MEM_WRITE_ONLY,
@@ -105,6 +210,9 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
 
     /* --- Execute actual benchmark kernels --- */
 
+    // Kernels, queues and buffers are created in the first repetition and reused in all following repetitions
+    ExecutionPlan plan(*config.context, *config.device, *config.program, blocks_per_row * config.programSettings->torus_width);
+
     double t;
     std::vector<double> gefaExecutionTimes;
     std::vector<double> geslExecutionTimes;
@@ -118,8 +226,8 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
         buffer_queue.finish();
 
         // Command queues 
-        // A new command queue is created for every iteration of the algorithm to reduce the overhead
-        // of too large queues
+        // A separate command queue is used for every iteration of the algorithm to reduce the overhead
+        // of too large queues. The queues are taken from the execution plan, so they are only created once.
         std::list<cl::CommandQueue> lu_queues;
         std::list<cl::CommandQueue> top_queues;
         std::list<cl::CommandQueue> left_queues;
@@ -142,21 +250,33 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
         kernels.emplace_back();
         inner_queues.emplace_back();
         for (uint rep = 0; rep < config.programSettings->kernelReplications; rep++) {
-            inner_queues.back().emplace_back(*config.context, *config.device, 0, &err);
-            ASSERT_CL(err)
+            // the inner queues used by the first step are stored behind the regular queues of the first step
+            inner_queues.back().push_back(plan.getQueue(0, 4 + config.programSettings->kernelReplications + rep));
         }
 
         std::chrono::time_point<std::chrono::high_resolution_clock> t1, t2, twait1, twait2;
         std::chrono::duration<double> currentwaittime = std::chrono::duration<double>::zero();
 
         std::cout << "Torus " << config.programSettings->torus_row << "," << config.programSettings->torus_col <<  "Start! " << std::endl;
-        MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Barrier(config.communicator);
         t1 = std::chrono::high_resolution_clock::now();
         // Trigger the user event that will start the first tasks in the queue
         start_event.setStatus(CL_COMPLETE);
 
 
         int kernel_offset = 0;
+        // Pointers to the received blocks of the current step. They point into the shared segment of the sender
+        // if the blocks were not copied.
+        HOST_DATA_TYPE *lu_block_src = lu_block;
+        HOST_DATA_TYPE *lu_trans_block_src = lu_trans_block;
+#ifdef USE_PIVOTING
+        cl_int *lu_pivot_src = lu_pivot;
+#endif
+        std::vector<HOST_DATA_TYPE*> left_block_src(left_blocks);
+        std::vector<HOST_DATA_TYPE*> top_block_src(top_blocks);
+        // Events of the read operations of the left and top blocks calculated in the current step
+        std::vector<cl::Event> left_read_events(blocks_per_row);
+        std::vector<cl::Event> top_read_events(blocks_per_row);
         #pragma omp parallel
         {
 
@@ -194,18 +314,23 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
             #pragma omp single
             {
 
+            // Reserve the entries of this step in the execution plan, so kernels can be requested from all threads.
+            // Kernels are stored in the order LU, top, left, first inner column, first inner row, remaining inner blocks.
+            // Queues are stored in the order LU, top, left, buffer transfer, inner queues.
+            plan.reserve(block_row, 1 + 4 * blocks_per_row + std::max(num_inner_block_rows - 1, 0) * std::max(num_inner_block_cols - 1, 0),
+                            4 + 2 * config.programSettings->kernelReplications, num_inner_block_rows + num_inner_block_cols);
+
+            std::fill(left_read_events.begin(), left_read_events.end(), cl::Event());
+            std::fill(top_read_events.begin(), top_read_events.end(), cl::Event());
+
             // Create Command queues
-            lu_queues.emplace_back(*config.context, *config.device, 0, &err);
-            ASSERT_CL(err)
-            top_queues.emplace_back(*config.context, *config.device, 0, &err);
-            ASSERT_CL(err)
-            left_queues.emplace_back(*config.context, *config.device, 0, &err);
-            ASSERT_CL(err)
+            lu_queues.push_back(plan.getQueue(block_row, 0));
+            top_queues.push_back(plan.getQueue(block_row, 1));
+            left_queues.push_back(plan.getQueue(block_row, 2));
 
             if (is_calulating_lu_block) {
                 // create the LU kernel
-                private_kernels.emplace_back(*config.program, "lu",
-                                            &err);
+                private_kernels.push_back(plan.getKernel(block_row, 0, "lu"));
 #ifndef NDEBUG
                 std::cout << "Torus " << config.programSettings->torus_row << "," << config.programSettings->torus_col << " LU     " << local_block_row << "," << local_block_row <<  std::endl;
 #endif
@@ -221,6 +346,10 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
                 ASSERT_CL(err)
                 err =private_kernels.back().setArg(5, config.programSettings->matrixSize / config.programSettings->blockSize);
                 ASSERT_CL(err)
+#ifdef USE_PIVOTING
+                err = private_kernels.back().setArg(6, Buffer_lu_pivot);
+                ASSERT_CL(err)
+#endif
                 err = lu_queues.back().enqueueNDRangeKernel(private_kernels.back(), cl::NullRange, cl::NDRange(1), cl::NDRange(1),  &(*std::prev(std::prev(all_events.end()))));
                 ASSERT_CL(err)
                 // read back result of LU calculation so it can be distributed 
@@ -228,16 +357,49 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
                 ASSERT_CL(err)
                 err = lu_queues.back().enqueueReadBuffer(Buffer_lu1, CL_FALSE, 0, sizeof(HOST_DATA_TYPE)*config.programSettings->blockSize * (config.programSettings->blockSize), lu_trans_block);
                 ASSERT_CL(err)
+#ifdef USE_PIVOTING
+                err = lu_queues.back().enqueueReadBuffer(Buffer_lu_pivot, CL_FALSE, 0, sizeof(cl_int)*config.programSettings->blockSize, lu_pivot);
+                ASSERT_CL(err)
+#endif
             }
 
             // Exchange LU blocks on all ranks to prevent stalls in MPI broadcast
             // All tasks until now need to be executed so we can use the result of the LU factorization and communicate it via MPI with the other FPGAs
-            lu_queues.back().finish();
+            {
+                tracing::ScopedSpan span("Wait for LU block");
+                lu_queues.back().finish();
+            }
 
+            // In the pipelined mode, the broadcasts in the row and column are executed concurrently
+            std::vector<MPI_Request> lu_requests;
+            std::vector<MPI_Request> *lu_requests_ptr = (config.programSettings->isPipelinedBroadcast) ? &lu_requests : nullptr;
             // Broadcast LU block in column to update all left blocks
-            MPI_Bcast(lu_block, config.programSettings->blockSize*config.programSettings->blockSize, MPI_DATA_TYPE, local_block_row_remainder, col_communicator);
+            lu_block_src = broadcastBlocks<HOST_DATA_TYPE>(col_shared, {lu_block}, config.programSettings->blockSize*config.programSettings->blockSize, MPI_DATA_TYPE, local_block_row_remainder, col_communicator, lu_requests_ptr)[0];
             // Broadcast LU block in row to update all top blocks
-            MPI_Bcast(lu_trans_block, config.programSettings->blockSize*config.programSettings->blockSize, MPI_DATA_TYPE, local_block_row_remainder, row_communicator);
+            lu_trans_block_src = broadcastBlocks<HOST_DATA_TYPE>(row_shared, {lu_trans_block}, config.programSettings->blockSize*config.programSettings->blockSize, MPI_DATA_TYPE, local_block_row_remainder, row_communicator, lu_requests_ptr)[0];
+#ifdef USE_PIVOTING
+            // The row exchanges only affect the LU block and the left blocks, so the pivots are only needed in the column.
+            // They are already visible with the LU block if the column is on a single node.
+            if (col_shared.isNodeLocal()) {
+                lu_pivot_src = col_shared.translate(lu_pivot, local_block_row_remainder);
+            }
+            else if (lu_requests_ptr) {
+                lu_requests.emplace_back();
+                MPI_Ibcast(lu_pivot, config.programSettings->blockSize, MPI_INT, local_block_row_remainder, col_communicator, &lu_requests.back());
+            }
+            else {
+                MPI_Bcast(lu_pivot, config.programSettings->blockSize, MPI_INT, local_block_row_remainder, col_communicator);
+            }
+#endif
+            MPI_Waitall(lu_requests.size(), lu_requests.data(), MPI_STATUSES_IGNORE);
+#ifdef USE_PIVOTING
+            if (is_calulating_lu_block) {
+                // Store the pivots as global row indices for the solution of the system
+                for (int i = 0; i < config.programSettings->blockSize; i++) {
+                    ipvt[local_block_row * config.programSettings->blockSize + i] = block_row * config.programSettings->blockSize + lu_pivot[i];
+                }
+            }
+#endif
            }
 
             if (num_top_blocks > 0) {
@@ -246,7 +408,7 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
                 {
                 cl::Event write_lu_trans_done;
                 // Copy LU block to FPGA for calulation of top blocks only if required
-                err = top_queues.back().enqueueWriteBuffer(Buffer_lu1, CL_FALSE, 0, sizeof(HOST_DATA_TYPE)*config.programSettings->blockSize * (config.programSettings->blockSize), lu_trans_block, NULL, &write_lu_trans_done);
+                err = top_queues.back().enqueueWriteBuffer(Buffer_lu1, CL_FALSE, 0, sizeof(HOST_DATA_TYPE)*config.programSettings->blockSize * (config.programSettings->blockSize), lu_trans_block_src, NULL, &write_lu_trans_done);
                 ASSERT_CL(err)
                 (*std::prev(std::prev(all_events.end()))).push_back(write_lu_trans_done);
                 }
@@ -254,8 +416,7 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
                 // Create top kernels
                 #pragma omp for
                 for (int tops=start_col_index; tops < (config.programSettings->matrixSize / config.programSettings->blockSize); tops++) {
-                    cl::Kernel k(*config.program, "top_update",
-                                                    &err);
+                    cl::Kernel k = plan.getKernel(block_row, 1 + tops - start_col_index, "top_update");
 #ifndef NDEBUG
                     std::cout << "Torus " << config.programSettings->torus_row << "," << config.programSettings->torus_col << " Top    " << local_block_row << "," << tops <<  std::endl;
 #endif
@@ -278,7 +439,8 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
                     err = top_queues.back().enqueueNDRangeKernel(k, cl::NullRange, cl::NDRange(1), cl::NDRange(1),  &(*std::prev(std::prev(all_events.end()))));
                     ASSERT_CL(err) 
 
-                    err = top_queues.back().enqueueReadBuffer(Buffer_top_list[tops - start_col_index], CL_FALSE, 0, sizeof(HOST_DATA_TYPE)*config.programSettings->blockSize * (config.programSettings->blockSize), top_blocks[tops - start_col_index]);
+                    err = top_queues.back().enqueueReadBuffer(Buffer_top_list[tops - start_col_index], CL_FALSE, 0, sizeof(HOST_DATA_TYPE)*config.programSettings->blockSize * (config.programSettings->blockSize), top_blocks[tops - start_col_index],
+                                                                NULL, &top_read_events[tops - start_col_index]);
                     ASSERT_CL(err)
 
                     private_kernels.push_back(k);
@@ -291,16 +453,21 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
                 {
                 cl::Event write_lu_done;
                 // Copy LU block to FPGA for calulation of left blocks only if required
-                err = left_queues.back().enqueueWriteBuffer(Buffer_lu2, CL_FALSE, 0, sizeof(HOST_DATA_TYPE)*config.programSettings->blockSize * (config.programSettings->blockSize), lu_block, NULL, &write_lu_done);
+                err = left_queues.back().enqueueWriteBuffer(Buffer_lu2, CL_FALSE, 0, sizeof(HOST_DATA_TYPE)*config.programSettings->blockSize * (config.programSettings->blockSize), lu_block_src, NULL, &write_lu_done);
                 ASSERT_CL(err)
                 (*std::prev(std::prev(all_events.end()))).push_back(write_lu_done);
+#ifdef USE_PIVOTING
+                cl::Event write_pivot_done;
+                err = left_queues.back().enqueueWriteBuffer(Buffer_lu_pivot, CL_FALSE, 0, sizeof(cl_int)*config.programSettings->blockSize, lu_pivot_src, NULL, &write_pivot_done);
+                ASSERT_CL(err)
+                (*std::prev(std::prev(all_events.end()))).push_back(write_pivot_done);
+#endif
                 }
 
                 // Create left kernels
                 #pragma omp for
                 for (int tops=start_row_index; tops < (config.programSettings->matrixSize / config.programSettings->blockSize); tops++) {
-                    cl::Kernel k(*config.program, "left_update",
-                                                    &err);
+                    cl::Kernel k = plan.getKernel(block_row, 1 + blocks_per_row + tops - start_row_index, "left_update");
 #ifndef NDEBUG
                     std::cout << "Torus " << config.programSettings->torus_row << "," << config.programSettings->torus_col <<  " Left   " <<tops  << "," << local_block_row <<  std::endl;
 #endif
@@ -319,11 +486,16 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
                     ASSERT_CL(err)
                     err = k.setArg(6, config.programSettings->matrixSize / config.programSettings->blockSize);
                     ASSERT_CL(err)
+#ifdef USE_PIVOTING
+                    err = k.setArg(7, Buffer_lu_pivot);
+                    ASSERT_CL(err)
+#endif
 
                     err = left_queues.back().enqueueNDRangeKernel(k, cl::NullRange, cl::NDRange(1), cl::NDRange(1),  &(*std::prev(std::prev(all_events.end()))));
                     ASSERT_CL(err) 
 
-                    err = left_queues.back().enqueueReadBuffer(Buffer_left_list[tops - start_row_index], CL_FALSE, 0, sizeof(HOST_DATA_TYPE)*config.programSettings->blockSize * (config.programSettings->blockSize), left_blocks[tops - start_row_index]);
+                    err = left_queues.back().enqueueReadBuffer(Buffer_left_list[tops - start_row_index], CL_FALSE, 0, sizeof(HOST_DATA_TYPE)*config.programSettings->blockSize * (config.programSettings->blockSize), left_blocks[tops - start_row_index],
+                                                                NULL, &left_read_events[tops - start_row_index]);
 
                     ASSERT_CL(err) 
 
@@ -333,16 +505,32 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
 
             #pragma omp single
             {
-            // Wait until all top and left blocks are calculated
-            top_queues.back().finish();
-            left_queues.back().finish();
-
-            // Send the left and top blocks to all other ranks so they can be used to update all inner blocks
-            for (int lbi=0; lbi < blocks_per_row - local_block_row; lbi++) {
-                MPI_Bcast(left_blocks[lbi], config.programSettings->blockSize*config.programSettings->blockSize, MPI_DATA_TYPE, local_block_row_remainder, row_communicator);
+            std::vector<HOST_DATA_TYPE*> bcast_left_blocks(left_blocks.begin(), left_blocks.begin() + (blocks_per_row - local_block_row));
+            std::vector<HOST_DATA_TYPE*> bcast_top_blocks(top_blocks.begin(), top_blocks.begin() + (blocks_per_row - local_block_row));
+            // Requests of the pipelined broadcast. The requests of the left blocks are followed by the ones of the top blocks
+            std::vector<MPI_Request> block_requests;
+            size_t num_left_requests = 0;
+            if (config.programSettings->isPipelinedBroadcast) {
+                // Send every left and top block as soon as it is calculated
+                left_block_src = startPipelinedBroadcast(row_shared, bcast_left_blocks, left_read_events,
+                                                config.programSettings->blockSize*config.programSettings->blockSize, MPI_DATA_TYPE, local_block_row_remainder, row_communicator, block_requests);
+                num_left_requests = block_requests.size();
+                top_block_src = startPipelinedBroadcast(col_shared, bcast_top_blocks, top_read_events,
+                                                config.programSettings->blockSize*config.programSettings->blockSize, MPI_DATA_TYPE, local_block_row_remainder, col_communicator, block_requests);
             }
-            for (int tbi=0; tbi < blocks_per_row  - local_block_row; tbi++) {
-                MPI_Bcast(top_blocks[tbi], config.programSettings->blockSize*config.programSettings->blockSize, MPI_DATA_TYPE, local_block_row_remainder, col_communicator);
+            else {
+                // Wait until all top and left blocks are calculated
+                {
+                    tracing::ScopedSpan span("Wait for top and left blocks");
+                    top_queues.back().finish();
+                    left_queues.back().finish();
+                }
+
+                // Send the left and top blocks to all other ranks so they can be used to update all inner blocks
+                left_block_src = broadcastBlocks(row_shared, bcast_left_blocks,
+                                                config.programSettings->blockSize*config.programSettings->blockSize, MPI_DATA_TYPE, local_block_row_remainder, row_communicator);
+                top_block_src = broadcastBlocks(col_shared, bcast_top_blocks,
+                                                config.programSettings->blockSize*config.programSettings->blockSize, MPI_DATA_TYPE, local_block_row_remainder, col_communicator);
             }
 
             // update all remaining inner blocks using only global memory
@@ -352,18 +540,50 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
             left_buffers.emplace_back();
             top_buffers.emplace_back();
             
-            cl::CommandQueue buffer_transfer_queue(*config.context, *config.device, 0, &err);
+            cl::CommandQueue buffer_transfer_queue = plan.getQueue(block_row, 3);
 
-            // Write all left and top blocks to FPGA memory
             for (int lbi=0; lbi < num_inner_block_rows; lbi++) {
-                left_buffers.back().emplace_back(*config.context, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY,
-                                        sizeof(HOST_DATA_TYPE)*config.programSettings->blockSize * (config.programSettings->blockSize), left_blocks[lbi]);
-                err = buffer_transfer_queue.enqueueWriteBuffer(left_buffers.back().back(), CL_FALSE, 0, sizeof(HOST_DATA_TYPE)*config.programSettings->blockSize * (config.programSettings->blockSize), left_blocks[lbi]);
+                left_buffers.back().push_back(plan.getBuffer(block_row, lbi, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY,
+                                        sizeof(HOST_DATA_TYPE)*config.programSettings->blockSize * (config.programSettings->blockSize), left_block_src[lbi]));
             }
             for (int tbi=0; tbi < num_inner_block_cols; tbi++) {
-                top_buffers.back().emplace_back(*config.context, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY,
-                        sizeof(HOST_DATA_TYPE)*config.programSettings->blockSize * config.programSettings->blockSize, top_blocks[tbi]);
-                err = buffer_transfer_queue.enqueueWriteBuffer(top_buffers.back().back(), CL_FALSE, 0, sizeof(HOST_DATA_TYPE)*config.programSettings->blockSize * (config.programSettings->blockSize), top_blocks[tbi]);
+                top_buffers.back().push_back(plan.getBuffer(block_row, num_inner_block_rows + tbi, CL_MEM_USE_HOST_PTR | CL_MEM_READ_ONLY,
+                        sizeof(HOST_DATA_TYPE)*config.programSettings->blockSize * config.programSettings->blockSize, top_block_src[tbi]));
+            }
+            auto write_left_block = [&](int lbi) {
+                if (lbi < num_inner_block_rows) {
+                    err = buffer_transfer_queue.enqueueWriteBuffer(left_buffers.back()[lbi], CL_FALSE, 0, sizeof(HOST_DATA_TYPE)*config.programSettings->blockSize * (config.programSettings->blockSize), left_block_src[lbi]);
+                    ASSERT_CL(err)
+                }
+            };
+            auto write_top_block = [&](int tbi) {
+                if (tbi < num_inner_block_cols) {
+                    err = buffer_transfer_queue.enqueueWriteBuffer(top_buffers.back()[tbi], CL_FALSE, 0, sizeof(HOST_DATA_TYPE)*config.programSettings->blockSize * (config.programSettings->blockSize), top_block_src[tbi]);
+                    ASSERT_CL(err)
+                }
+            };
+
+            // Write all left and top blocks to FPGA memory. Blocks that are still broadcast are written as soon
+            // as they are received, while the remaining blocks are transferred over the network
+            if (num_left_requests == 0) {
+                for (int lbi=0; lbi < num_inner_block_rows; lbi++) {
+                    write_left_block(lbi);
+                }
+            }
+            if (block_requests.size() == num_left_requests) {
+                for (int tbi=0; tbi < num_inner_block_cols; tbi++) {
+                    write_top_block(tbi);
+                }
+            }
+            for (size_t r = 0; r < block_requests.size(); r++) {
+                int index;
+                MPI_Waitany(block_requests.size(), block_requests.data(), &index, MPI_STATUS_IGNORE);
+                if (static_cast<size_t>(index) < num_left_requests) {
+                    write_left_block(index);
+                }
+                else {
+                    write_top_block(index - num_left_requests);
+                }
             }
 
             kernel_offset = kernels.back().size();
@@ -373,7 +593,10 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
             all_events.back().reserve(omp_get_num_threads()*config.programSettings->kernelReplications*2);
 
             // Wait until data is copied to FPGA
-            buffer_transfer_queue.finish();
+            {
+                tracing::ScopedSpan span("Write left and top blocks");
+                buffer_transfer_queue.finish();
+            }
             }
             current_update = 0;    
 
@@ -384,12 +607,10 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
 
                 // select the matrix multiplication kernel that should be used for this block updated 
 #ifdef INTEL_FPGA
-                cl::Kernel k(*config.program, ("inner_update_mm" + std::to_string(current_replication)).c_str(),
-                                    &err);
+                cl::Kernel k = plan.getKernel(block_row, 1 + 2 * blocks_per_row + lbi - 1, ("inner_update_mm" + std::to_string(current_replication)).c_str());
 #endif
 #ifdef XILINX_FPGA
-                cl::Kernel k(*config.program, ("inner_update_mm0:{inner_update_mm0_" + std::to_string(current_replication + 1) + "}").c_str(),
-                                    &err);
+                cl::Kernel k = plan.getKernel(block_row, 1 + 2 * blocks_per_row + lbi - 1, ("inner_update_mm0:{inner_update_mm0_" + std::to_string(current_replication + 1) + "}").c_str());
 #endif
 
                 int block_col = static_cast<cl_uint>((config.programSettings->matrixSize / config.programSettings->blockSize) - num_inner_block_cols);
@@ -442,12 +663,10 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
 
                 // select the matrix multiplication kernel that should be used for this block updated 
 #ifdef INTEL_FPGA
-                cl::Kernel k(*config.program, ("inner_update_mm" + std::to_string(current_replication)).c_str(),
-                                    &err);
+                cl::Kernel k = plan.getKernel(block_row, 1 + 3 * blocks_per_row + tbi, ("inner_update_mm" + std::to_string(current_replication)).c_str());
 #endif
 #ifdef XILINX_FPGA
-                cl::Kernel k(*config.program, ("inner_update_mm0:{inner_update_mm0_" + std::to_string(current_replication + 1) + "}").c_str(),
-                                    &err);
+                cl::Kernel k = plan.getKernel(block_row, 1 + 3 * blocks_per_row + tbi, ("inner_update_mm0:{inner_update_mm0_" + std::to_string(current_replication + 1) + "}").c_str());
 #endif
                 int block_col = static_cast<cl_uint>((config.programSettings->matrixSize / config.programSettings->blockSize) - num_inner_block_cols + tbi);
                 int block_row = static_cast<cl_uint>((config.programSettings->matrixSize / config.programSettings->blockSize) - num_inner_block_rows);
@@ -500,8 +719,7 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
             inner_queues.emplace_back();
             current_update = 0;
             for (uint rep = 0; rep < config.programSettings->kernelReplications; rep++) {
-                inner_queues.back().emplace_back(*config.context, *config.device, 0, &err);
-                ASSERT_CL(err)
+                inner_queues.back().push_back(plan.getQueue(block_row, 4 + rep));
             }
 
             }
@@ -514,12 +732,10 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
                     current_replication = (lbi * num_inner_block_cols + tbi)  % config.programSettings->kernelReplications;
 
 #ifdef INTEL_FPGA
-                    cl::Kernel k(*config.program, ("inner_update_mm" + std::to_string(current_replication)).c_str(),
-                                        &err);
+                    cl::Kernel k = plan.getKernel(block_row, 1 + 4 * blocks_per_row + (lbi-1)*(num_inner_block_cols - 1)+(tbi-1), ("inner_update_mm" + std::to_string(current_replication)).c_str());
 #endif
 #ifdef XILINX_FPGA
-                    cl::Kernel k(*config.program, ("inner_update_mm0:{inner_update_mm0_" + std::to_string(current_replication + 1) + "}").c_str(),
-                                        &err);
+                    cl::Kernel k = plan.getKernel(block_row, 1 + 4 * blocks_per_row + (lbi-1)*(num_inner_block_cols - 1)+(tbi-1), ("inner_update_mm0:{inner_update_mm0_" + std::to_string(current_replication + 1) + "}").c_str());
 #endif
 
                     int block_col = static_cast<cl_uint>((config.programSettings->matrixSize / config.programSettings->blockSize) - num_inner_block_cols + tbi);
@@ -580,12 +796,12 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
             }
 
 #ifndef NDEBUG
-            MPI_Barrier(MPI_COMM_WORLD);
+            MPI_Barrier(config.communicator);
             if (is_calulating_lu_block) std::cout << "---------------" << std::endl;
 
             // // // Execute GEFA
             // if (block_row == 0) {
-            //     MPI_Barrier(MPI_COMM_WORLD);
+            //     MPI_Barrier(config.communicator);
             //     t1 = std::chrono::high_resolution_clock::now();
             //     // Trigger the user event that will start the first tasks in the queue
             //     start_event.setStatus(CL_COMPLETE);
@@ -678,29 +894,24 @@ calculate(const hpcc_base::ExecutionSettings<linpack::LinpackProgramSettings>&co
                                      sizeof(HOST_DATA_TYPE)*config.programSettings->matrixSize*config.programSettings->matrixSize, A);
     // buffer_queue.enqueueReadBuffer(Buffer_b, CL_TRUE, 0,
     //                                  sizeof(HOST_DATA_TYPE)*config.programSettings->matrixSize, b);
+#ifndef USE_PIVOTING
     if (!config.programSettings->isDiagonallyDominant) {
         buffer_queue.enqueueReadBuffer(Buffer_pivot, CL_TRUE, 0,
                                         sizeof(cl_int)*config.programSettings->matrixSize, ipvt);
     }
+#endif
     buffer_queue.finish();
 #endif
 
     /* --- Clean up MPI communication buffers --- */
-    free(lu_block);
-    free(lu_trans_block);
-
-    for (int i =0; i < left_blocks.size(); i++) {
-        free(top_blocks[i]);
-        free(left_blocks[i]);
-    }
-
+    // The shared buffers of the blocks are freed at the end of the scope after all OpenCL buffers that use them
     MPI_Comm_free(&row_communicator);
     MPI_Comm_free(&col_communicator);
 
     std::unique_ptr<linpack::LinpackExecutionTimings> results(
                     new linpack::LinpackExecutionTimings{gefaExecutionTimes, geslExecutionTimes});
     
-    MPI_Barrier(MPI_COMM_WORLD);
+    MPI_Barrier(config.communicator);
 
     return results;
 }
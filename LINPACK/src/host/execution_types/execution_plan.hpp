@@ -0,0 +1,179 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef EXECUTION_TYPES_EXECUTION_PLAN_HPP
+#define EXECUTION_TYPES_EXECUTION_PLAN_HPP
+
+/* C++ standard library headers */
+#include <string>
+#include <vector>
+
+/* External library headers */
+#ifdef USE_DEPRECATED_HPP_HEADER
+#include "CL/cl.hpp"
+#else
+#include OPENCL_HPP_HEADER
+#endif
+
+#include "setup/fpga_setup.hpp"
+#include "memory_placement.hpp"
+
+namespace linpack {
+namespace execution {
+
+/**
+ * @brief Stores the OpenCL kernels, command queues and buffers that are used in every step of the blocked LU factorization.
+ *          The objects are created on first use and are reused in all following repetitions of the benchmark,
+ *          so only the data buffers have to be reset and the kernels have to be enqueued again for every repetition.
+ *          Objects are identified by the step of the factorization and an index within this step.
+ *          The host code has to request the objects with the same index in every repetition.
+ *
+ */
+class ExecutionPlan {
+
+private:
+
+    /**
+     * @brief Objects used in a single step of the factorization
+     *
+     */
+    struct Step {
+        std::vector<cl::Kernel> kernels;
+        std::vector<cl::CommandQueue> queues;
+        std::vector<cl::Buffer> buffers;
+    };
+
+    const cl::Context &context;
+    const cl::Device &device;
+    const cl::Program &program;
+
+    /**
+     * @brief The objects for every step of the factorization
+     *
+     */
+    std::vector<Step> steps;
+
+public:
+
+    /**
+     * @brief Construct a new empty execution plan
+     *
+     * @param context The context used to create queues and buffers
+     * @param device The device used to create queues
+     * @param program The program containing the kernels
+     * @param num_steps The total number of steps of the factorization
+     */
+    ExecutionPlan(const cl::Context &context, const cl::Device &device, const cl::Program &program, uint num_steps) :
+                    context(context), device(device), program(program), steps(num_steps) {}
+
+    /**
+     * @brief Reserve entries in a step. Objects can only be requested concurrently from multiple threads
+     *          if their entries were reserved in advance.
+     *
+     * @param step The step of the factorization
+     * @param num_kernels Number of kernels that will be requested in this step
+     * @param num_queues Number of command queues that will be requested in this step
+     * @param num_buffers Number of buffers that will be requested in this step
+     */
+    void
+    reserve(uint step, size_t num_kernels, size_t num_queues, size_t num_buffers) {
+        Step &s = steps[step];
+        if (s.kernels.size() < num_kernels) {
+            s.kernels.resize(num_kernels);
+        }
+        if (s.queues.size() < num_queues) {
+            s.queues.resize(num_queues);
+        }
+        if (s.buffers.size() < num_buffers) {
+            s.buffers.resize(num_buffers);
+        }
+    }
+
+    /**
+     * @brief Get a kernel of a step. The kernel is created in the first call and returned afterwards.
+     *          The arguments of the kernel are kept from the last repetition.
+     *
+     * @param step The step of the factorization
+     * @param index Index of the kernel within the step
+     * @param name The name of the kernel in the program
+     * @return cl::Kernel& The kernel object
+     */
+    cl::Kernel&
+    getKernel(uint step, size_t index, const std::string &name) {
+        reserve(step, index + 1, 0, 0);
+        cl::Kernel &k = steps[step].kernels[index];
+        if (k() == nullptr) {
+            int err;
+            k = cl::Kernel(program, name.c_str(), &err);
+            ASSERT_CL(err)
+        }
+        return k;
+    }
+
+    /**
+     * @brief Get a command queue of a step. The queue is created in the first call and returned afterwards.
+     *
+     * @param step The step of the factorization
+     * @param index Index of the queue within the step
+     * @return cl::CommandQueue& The command queue
+     */
+    cl::CommandQueue&
+    getQueue(uint step, size_t index) {
+        reserve(step, 0, index + 1, 0);
+        cl::CommandQueue &q = steps[step].queues[index];
+        if (q() == nullptr) {
+            int err;
+            q = cl::CommandQueue(context, device, 0, &err);
+            ASSERT_CL(err)
+        }
+        return q;
+    }
+
+    /**
+     * @brief Get a buffer of a step. The buffer is created in the first call and returned afterwards.
+     *          The flags, size and host pointer have to be the same in every call with the same index.
+     *
+     * @param step The step of the factorization
+     * @param index Index of the buffer within the step
+     * @param flags Memory flags used for the creation of the buffer
+     * @param size Size of the buffer in bytes
+     * @param host_ptr Host pointer used for the creation of the buffer
+     * @return cl::Buffer& The buffer
+     */
+    cl::Buffer&
+    getBuffer(uint step, size_t index, cl_mem_flags flags, size_t size, void* host_ptr = nullptr) {
+        reserve(step, 0, 0, index + 1);
+        cl::Buffer &b = steps[step].buffers[index];
+        if (b() == nullptr) {
+            int err;
+            b = cl::Buffer(context, flags, size, host_ptr, &err);
+            ASSERT_CL(err)
+            placement::trackBuffer(b, memory_tracker::DEFAULT_BANK);
+        }
+        return b;
+    }
+
+};
+
+}   // namespace execution
+}  // namespace linpack
+
+#endif
@@ -24,5 +24,6 @@ SOFTWARE.
 
 #include "execution_types/execution_pcie.hpp"
 #include "execution_types/execution_iec.hpp"
+#include "execution_types/execution_cpu.hpp"
 
 #endif
\ No newline at end of file
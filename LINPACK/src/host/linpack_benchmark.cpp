@@ -27,25 +27,66 @@ SOFTWARE.
 #include "linpack_benchmark.hpp"
 
 /* C++ standard library headers */
+#include <chrono>
 #include <memory>
-#include <random>
 
 /* Project's headers */
 #include "communication_types.hpp"
+#include "counter_rng.hpp"
 #include "execution_types/execution_types.hpp"
 #include "parameters.h"
+#include "torus_placement.hpp"
 
 linpack::LinpackProgramSettings::LinpackProgramSettings(cxxopts::ParseResult &results) : hpcc_base::BaseSettings(results),
     matrixSize(results["m"].as<uint>() * (1 << (results["b"].as<uint>()))), blockSize(1 << (results["b"].as<uint>())), 
-    isEmulationKernel(results.count("emulation") > 0), isDiagonallyDominant(results.count("uniform") == 0) {
+    isEmulationKernel(results.count("emulation") > 0), isDiagonallyDominant(results.count("uniform") == 0),
+    isMixedPrecision(results.count("mixed-precision") > 0), topologyFile(results["topology"].as<std::string>()),
+    isNodeAwarePlacement(results.count("node-aware") > 0), useSharedMemory(results.count("no-shared-memory") == 0),
+    isPipelinedBroadcast(results.count("pipelined-broadcast") > 0), nrhs(results["nrhs"].as<uint>()) {
+
+}
+
+linpack::LinpackProgramSettings::~LinpackProgramSettings() {
+    int isMpiFinalized;
+    MPI_Finalized(&isMpiFinalized);
+    if (!isMpiFinalized && torus_communicator != MPI_COMM_NULL) {
+        MPI_Comm_free(&torus_communicator);
+    }
+}
+
+void
+linpack::LinpackProgramSettings::setupTorus(MPI_Comm communicator) {
     int mpi_comm_rank;
     int mpi_comm_size;
-    MPI_Comm_rank(MPI_COMM_WORLD, &mpi_comm_rank);
-    MPI_Comm_size(MPI_COMM_WORLD, &mpi_comm_size);
-    // calculate the row and column of the MPI rank in the torus 
-    torus_row = (mpi_comm_rank / std::sqrt(mpi_comm_size));
-    torus_col = (mpi_comm_rank % static_cast<int>(std::sqrt(mpi_comm_size)));
+    MPI_Comm_rank(communicator, &mpi_comm_rank);
+    MPI_Comm_size(communicator, &mpi_comm_size);
     torus_width = static_cast<int>(std::sqrt(mpi_comm_size));
+    int torus_position = mpi_comm_rank;
+    // Non-square sizes are rejected by the benchmark, so the ranks are only reordered for a valid torus
+    if ((isNodeAwarePlacement || !topologyFile.empty()) && torus_width * torus_width == mpi_comm_size) {
+        // Use the host names to find the ranks that are executed on the same node
+        std::vector<char> host_names(static_cast<size_t>(mpi_comm_size) * MPI_MAX_PROCESSOR_NAME, 0);
+        std::vector<char> local_name(MPI_MAX_PROCESSOR_NAME, 0);
+        int name_length;
+        MPI_Get_processor_name(local_name.data(), &name_length);
+        MPI_Allgather(local_name.data(), MPI_MAX_PROCESSOR_NAME, MPI_CHAR, host_names.data(), MPI_MAX_PROCESSOR_NAME, MPI_CHAR, communicator);
+        std::vector<std::string> rank_hosts;
+        for (int r = 0; r < mpi_comm_size; r++) {
+            rank_hosts.push_back(std::string(&host_names[static_cast<size_t>(r) * MPI_MAX_PROCESSOR_NAME]));
+        }
+        std::vector<std::string> topology;
+        if (!topologyFile.empty()) {
+            topology = placement::readTopologyFile(topologyFile);
+        }
+        torus_position = placement::calculateTorusPositions(rank_hosts, topology, torus_width)[mpi_comm_rank];
+    }
+    // calculate the row and column of the MPI rank in the torus 
+    torus_row = torus_position / torus_width;
+    torus_col = torus_position % torus_width;
+    if (torus_communicator != MPI_COMM_NULL) {
+        MPI_Comm_free(&torus_communicator);
+    }
+    MPI_Comm_split(communicator, 0, torus_position, &torus_communicator);
 }
 
 std::map<std::string, std::string>
@@ -54,25 +95,30 @@ linpack::LinpackProgramSettings::getSettingsMap() {
         map["Matrix Size"] = std::to_string(matrixSize);
         map["Block Size"] = std::to_string(blockSize);
         map["Emulate"] = (isEmulationKernel) ? "Yes" : "No";
+        map["Mixed Precision"] = (isMixedPrecision) ? "Yes" : "No";
         map["Data Type"] = STR(HOST_DATA_TYPE);
+        map["Rank Placement"] = (!topologyFile.empty()) ? topologyFile : ((isNodeAwarePlacement) ? "Node-aware" : "MPI rank");
+        map["Shared Memory"] = (useSharedMemory) ? "Yes" : "No";
+        map["Broadcast"] = (isPipelinedBroadcast) ? "Pipelined" : "Blocking";
+        map["Right-hand Sides"] = std::to_string(nrhs);
         return map;
 }
 
-linpack::LinpackData::LinpackData(cl::Context context, size_t size) : norma(0.0), context(context) {
+linpack::LinpackData::LinpackData(cl::Context context, size_t size, size_t nrhs) : nrhs(nrhs), norma(0.0), context(context) {
 #ifdef USE_SVM
     A = reinterpret_cast<HOST_DATA_TYPE*>(
                         clSVMAlloc(context(), 0 ,
                         size * size * sizeof(HOST_DATA_TYPE), 1024));
     b = reinterpret_cast<HOST_DATA_TYPE*>(
                         clSVMAlloc(context(), 0 ,
-                        size  * sizeof(HOST_DATA_TYPE), 1024));
+                        size * nrhs * sizeof(HOST_DATA_TYPE), 1024));
     ipvt = reinterpret_cast<cl_int*>(
                         clSVMAlloc(context(), 0 ,
                         size * sizeof(cl_int), 1024));
 #else
-    posix_memalign(reinterpret_cast<void**>(&A), 4096, size * size * sizeof(HOST_DATA_TYPE));
-    posix_memalign(reinterpret_cast<void**>(&b), 4096, size * sizeof(HOST_DATA_TYPE));
-    posix_memalign(reinterpret_cast<void**>(&ipvt), 4096, size * sizeof(cl_int));
+    numa::memalign(reinterpret_cast<void**>(&A), 4096, size * size * sizeof(HOST_DATA_TYPE));
+    numa::memalign(reinterpret_cast<void**>(&b), 4096, size * nrhs * sizeof(HOST_DATA_TYPE));
+    numa::memalign(reinterpret_cast<void**>(&ipvt), 4096, size * sizeof(cl_int));
 #endif
     }
 
@@ -82,9 +128,9 @@ linpack::LinpackData::~LinpackData() {
     clSVMFree(context(), reinterpret_cast<void*>(b));
     clSVMFree(context(), reinterpret_cast<void*>(ipvt));
 #else
-    free(A);
-    free(b);
-    free(ipvt);
+    numa::free(A);
+    numa::free(b);
+    numa::free(ipvt);
 #endif
 }
 
@@ -93,6 +139,21 @@ linpack::LinpackBenchmark::LinpackBenchmark(int argc, char* argv[]) : HpccFpgaBe
     if (static_cast<int>(std::sqrt(mpi_comm_size) * std::sqrt(mpi_comm_size)) != mpi_comm_size) {
         throw std::runtime_error("ERROR: MPI communication size must be a square number!");
     }
+    if (executionSettings->programSettings->nrhs < 1) {
+        throw std::runtime_error("ERROR: At least one right-hand side is required!");
+    }
+    if (executionSettings->programSettings->communicationType == hpcc_base::CommunicationType::rdma) {
+        // The blocks are broadcast through host buffers that are shared between the ranks of a node
+        throw std::runtime_error("ERROR: The communication type RDMA is not supported. Use PCIE instead!");
+    }
+#ifdef USE_PIVOTING
+    if (executionSettings->programSettings->isMixedPrecision) {
+        throw std::runtime_error("ERROR: Mixed precision refinement is not supported with pivoting!");
+    }
+    if (executionSettings->programSettings->communicationType != hpcc_base::CommunicationType::pcie_mpi) {
+        throw std::runtime_error("ERROR: Pivoting is only supported for communication via PCIe!");
+    }
+#endif
 }
 
 void
@@ -103,7 +164,15 @@ linpack::LinpackBenchmark::addAdditionalParseOptions(cxxopts::Options &options)
         ("b", "Log2 of the block size in number of values in one dimension",
             cxxopts::value<uint>()->default_value(std::to_string(LOCAL_MEM_BLOCK_LOG)))
         ("uniform", "Generate a uniform matrix instead of a diagonally dominant. This has to be supported by the FPGA kernel!")
-        ("emulation", "Use kernel arguments for emulation. This may be necessary to simulate persistent local memory on the FPGA");
+        ("emulation", "Use kernel arguments for emulation. This may be necessary to simulate persistent local memory on the FPGA")
+        ("mixed-precision", "Refine the solution of the low precision factorization in double precision during validation (HPL-AI mode). Requires a diagonally dominant matrix.")
+        ("topology", "File that contains the host of every torus position in row-major order. The ranks are placed accordingly, so torus neighbours are physically connected",
+            cxxopts::value<std::string>()->default_value(""))
+        ("node-aware", "Place the ranks of the same node next to each other in the torus rows")
+        ("no-shared-memory", "Broadcast the blocks with MPI also between ranks on the same node")
+        ("pipelined-broadcast", "Broadcast the blocks with non-blocking MPI collectives and overlap them with the transfers to and from the FPGA (PCIe only)")
+        ("nrhs", "Number of right-hand sides that are solved with the factorized matrix",
+            cxxopts::value<uint>()->default_value(std::to_string(1)));
 }
 
 std::unique_ptr<linpack::LinpackExecutionTimings>
@@ -112,10 +181,24 @@ linpack::LinpackBenchmark::executeKernel(LinpackData &data) {
     switch (executionSettings->programSettings->communicationType) {
         case hpcc_base::CommunicationType::pcie_mpi : timings = execution::pcie::calculate(*executionSettings, data.A, data.b, data.ipvt); break;
         case hpcc_base::CommunicationType::intel_external_channels: timings = execution::iec::calculate(*executionSettings, data.A, data.b, data.ipvt); break;
+        case hpcc_base::CommunicationType::cpu_only: timings = execution::cpu::calculate(*executionSettings, data.A, data.b, data.ipvt); break;
         default: throw std::runtime_error("No calculate method implemented for communication type " + commToString(executionSettings->programSettings->communicationType));
     }
-#ifdef DISTRIBUTED_VALIDATION
-    distributed_gesl_nopvt_ref(data);
+    // Solve the system for all right-hand sides with the factorized matrix on the host.
+    // The solution is repeated like the factorization, so every repetition has its own GESL time.
+    std::vector<HOST_DATA_TYPE> rhs(data.b, data.b + executionSettings->programSettings->matrixSize * data.nrhs);
+    for (auto &t : timings->geslTimings) {
+        std::copy(rhs.begin(), rhs.end(), data.b);
+        MPI_Barrier(executionSettings->communicator);
+        auto t1 = std::chrono::high_resolution_clock::now();
+        distributed_gesl_nopvt_ref(data);
+        MPI_Barrier(executionSettings->communicator);
+        auto t2 = std::chrono::high_resolution_clock::now();
+        t = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1).count();
+    }
+#ifndef DISTRIBUTED_VALIDATION
+    // The validation solves the system again with the gathered matrix, so it needs the original right-hand side
+    std::copy(rhs.begin(), rhs.end(), data.b);
 #endif
     return timings;
 }
@@ -135,9 +218,9 @@ linpack::LinpackBenchmark::collectAndPrintResults(const linpack::LinpackExecutio
 #endif
 
     std::vector<double> global_lu_times(output.gefaTimings.size());
-    MPI_Reduce(output.gefaTimings.data(), global_lu_times.data(), output.gefaTimings.size(), MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce(output.gefaTimings.data(), global_lu_times.data(), output.gefaTimings.size(), MPI_DOUBLE, MPI_MAX, 0, executionSettings->communicator);
     std::vector<double> global_sl_times(output.geslTimings.size());
-    MPI_Reduce(output.geslTimings.data(), global_sl_times.data(), output.geslTimings.size(), MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce(output.geslTimings.data(), global_sl_times.data(), output.geslTimings.size(), MPI_DOUBLE, MPI_MAX, 0, executionSettings->communicator);
 #ifndef NDEBUG
     std::cout << "Rank " << mpi_comm_rank << ": Result collection done" << std::endl;
 #endif
@@ -147,10 +230,13 @@ linpack::LinpackBenchmark::collectAndPrintResults(const linpack::LinpackExecutio
         // Only the master rank needs to calculate and print result
         return;
     }
+    global_lu_times = discardWarmup(global_lu_times);
+    global_sl_times = discardWarmup(global_sl_times);
 
     double total_matrix_size = static_cast<double>(executionSettings->programSettings->matrixSize) * executionSettings->programSettings->torus_width;
     double gflops_lu = ((2.0e0*total_matrix_size * total_matrix_size * total_matrix_size)/ 3.0) / 1.0e9; 
-    double gflops_sl = (2.0*(total_matrix_size * total_matrix_size))/1.0e9;
+    double nrhs = static_cast<double>(executionSettings->programSettings->nrhs);
+    double gflops_sl = nrhs * (2.0*(total_matrix_size * total_matrix_size))/1.0e9;
     for (int i =0; i < global_lu_times.size(); i++) {
         double currentTime = global_lu_times[i] + global_sl_times[i];
         tmean +=  currentTime;
@@ -170,6 +256,27 @@ linpack::LinpackBenchmark::collectAndPrintResults(const linpack::LinpackExecutio
     tlumean = tlumean / global_lu_times.size();
     tslmean = tslmean / global_sl_times.size();
 
+    timings.emplace("gefa", global_lu_times);
+    timings.emplace("gesl", global_sl_times);
+    results.emplace("t_min", hpcc_base::HpccResult(tmin, "s"));
+    results.emplace("t_mean", hpcc_base::HpccResult(tmean, "s"));
+    results.emplace("gflops", hpcc_base::HpccResult((gflops_lu + gflops_sl) / tmin, "GFLOP/s"));
+
+    // Estimate the global memory traffic of the blocked LU factorization: the trailing matrix is read and written
+    // once for every block column, which sums up to 2n^3/(3b) elements
+    double block_size = executionSettings->programSettings->blockSize;
+    double lu_bytes = sizeof(HOST_DATA_TYPE) * (2.0 * total_matrix_size * total_matrix_size * total_matrix_size / (3.0 * block_size)
+                        + 2.0 * total_matrix_size * total_matrix_size);
+    results.emplace("arithmetic_intensity", hpcc_base::HpccResult(gflops_lu * 1.0e9 / lu_bytes, "FLOP/Byte"));
+    results.emplace("t_min_gefa", hpcc_base::HpccResult(lu_min, "s"));
+    results.emplace("t_mean_gefa", hpcc_base::HpccResult(tlumean, "s"));
+    results.emplace("gflops_gefa", hpcc_base::HpccResult(gflops_lu / lu_min, "GFLOP/s"));
+    results.emplace("t_min_gesl", hpcc_base::HpccResult(sl_min, "s"));
+    results.emplace("t_mean_gesl", hpcc_base::HpccResult(tslmean, "s"));
+    results.emplace("gflops_gesl", hpcc_base::HpccResult(gflops_sl / sl_min, "GFLOP/s"));
+    results.emplace("t_min_gesl_per_rhs", hpcc_base::HpccResult(sl_min / nrhs, "s"));
+    results.emplace("gesl_rhs_per_s", hpcc_base::HpccResult(nrhs / sl_min, "1/s"));
+
      std::cout << std::setw(ENTRY_SPACE)
               << "Method" << std::setw(ENTRY_SPACE)
               << "best" << std::setw(ENTRY_SPACE) << "mean"
@@ -189,26 +296,47 @@ linpack::LinpackBenchmark::collectAndPrintResults(const linpack::LinpackExecutio
               << sl_min << std::setw(ENTRY_SPACE) << tslmean
               << std::setw(ENTRY_SPACE) << (gflops_sl / sl_min)
               << std::endl;
+
+    if (nrhs > 1) {
+        std::cout << "GESL per right-hand side: " << (sl_min / nrhs) << " s, " << (nrhs / sl_min) << " right-hand sides/s" << std::endl;
+    }
+
+    std::vector<double> total_times(global_lu_times.size());
+    std::transform(global_lu_times.begin(), global_lu_times.end(), global_sl_times.begin(), total_times.begin(), std::plus<double>());
+    addStatistics("t", total_times);
+    addStatistics("t_gefa", global_lu_times);
+    addStatistics("t_gesl", global_sl_times);
 }
 
 std::unique_ptr<linpack::LinpackData>
 linpack::LinpackBenchmark::generateInputData() {
-    auto d = std::unique_ptr<linpack::LinpackData>(new linpack::LinpackData(*executionSettings->context ,executionSettings->programSettings->matrixSize));
-    std::mt19937 gen(this->mpi_comm_rank);
-    std::uniform_real_distribution<> dis(0.0, 1.0);
+    auto d = std::unique_ptr<linpack::LinpackData>(new linpack::LinpackData(*executionSettings->context ,executionSettings->programSettings->matrixSize,
+                                                                                    executionSettings->programSettings->nrhs));
     d->norma = 0.0;
     d->normb = 0.0;
     /*
     Generate a matrix by using pseudo random number in the range (0,1)
+    The values are calculated from the global position in the matrix with a counter-based RNG, so
+    the generated matrix does not depend on the number of threads or the torus width
     */
-    for (int j = 0; j < executionSettings->programSettings->matrixSize; j++) {
+    const int local_size = executionSettings->programSettings->matrixSize;
+    const int block_size = executionSettings->programSettings->blockSize;
+    const int torus_width = executionSettings->programSettings->torus_width;
+    const uint64_t global_size = static_cast<uint64_t>(local_size) * torus_width;
+    const uint64_t seed = 42;
+    HOST_DATA_TYPE norma = 0.0;
+#pragma omp parallel for reduction(max:norma)
+    for (int j = 0; j < local_size; j++) {
+        uint64_t global_j = static_cast<uint64_t>((j / block_size) * torus_width + executionSettings->programSettings->torus_row) * block_size + j % block_size;
         // fill a single column of the matrix
-        for (int i = 0; i < executionSettings->programSettings->matrixSize; i++) {
-                HOST_DATA_TYPE temp = dis(gen);
-                d->A[executionSettings->programSettings->matrixSize*j+i] = temp;
-                d->norma = (temp > d->norma) ? temp : d->norma;
+        for (int i = 0; i < local_size; i++) {
+                uint64_t global_i = static_cast<uint64_t>((i / block_size) * torus_width + executionSettings->programSettings->torus_col) * block_size + i % block_size;
+                HOST_DATA_TYPE temp = rng::uniform(seed, 0, global_j * global_size + global_i);
+                d->A[local_size*j+i] = temp;
+                norma = (temp > norma) ? temp : norma;
         }
     }
+    d->norma = norma;
 
 
     // If the matrix should be diagonally dominant, we need to exchange the sum of the rows with
@@ -216,8 +344,11 @@ linpack::LinpackBenchmark::generateInputData() {
     if (executionSettings->programSettings->isDiagonallyDominant) {
         // create a communicator to exchange the rows
         MPI_Comm row_communicator;
-        MPI_Comm_split(MPI_COMM_WORLD, executionSettings->programSettings->torus_row, 0,&row_communicator);
+        MPI_Comm_split(executionSettings->programSettings->torus_communicator, executionSettings->programSettings->torus_row, 0,&row_communicator);
         // Caclulate the sum for every row and insert in into the matrix
+        // The sums of all rows are reduced with a single collective operation
+        std::vector<HOST_DATA_TYPE> local_row_sums(executionSettings->programSettings->matrixSize);
+#pragma omp parallel for
         for (int j = 0; j < executionSettings->programSettings->matrixSize; j++) {
             // set the diagonal elements of the matrix to 0
             if (executionSettings->programSettings->torus_row == executionSettings->programSettings->torus_col) {
@@ -227,15 +358,19 @@ linpack::LinpackBenchmark::generateInputData() {
             for (int i = 0; i < executionSettings->programSettings->matrixSize; i++) {
                 local_row_sum += d->A[executionSettings->programSettings->matrixSize*j + i];
             } 
-            HOST_DATA_TYPE row_sum = 0.0;
-            MPI_Reduce(&local_row_sum, &row_sum, 1, MPI_DATA_TYPE, MPI_SUM, executionSettings->programSettings->torus_row, row_communicator);
-            // insert row sum into matrix if it contains the diagonal block
-            if (executionSettings->programSettings->torus_row == executionSettings->programSettings->torus_col) {
+            local_row_sums[j] = local_row_sum;
+        }
+        std::vector<HOST_DATA_TYPE> row_sums(executionSettings->programSettings->matrixSize);
+        MPI_Reduce(local_row_sums.data(), row_sums.data(), executionSettings->programSettings->matrixSize, MPI_DATA_TYPE, MPI_SUM, executionSettings->programSettings->torus_row, row_communicator);
+        // insert row sum into matrix if it contains the diagonal block
+        if (executionSettings->programSettings->torus_row == executionSettings->programSettings->torus_col) {
+            for (int j = 0; j < executionSettings->programSettings->matrixSize; j++) {
                 // update norm of local matrix
-                d->norma = (row_sum > d->norma) ? row_sum : d->norma;
-                d->A[executionSettings->programSettings->matrixSize*j + j] = row_sum;
+                d->norma = (row_sums[j] > d->norma) ? row_sums[j] : d->norma;
+                d->A[executionSettings->programSettings->matrixSize*j + j] = row_sums[j];
             }
         }
+        MPI_Comm_free(&row_communicator);
     }
         
     // initialize other vectors
@@ -245,23 +380,107 @@ linpack::LinpackBenchmark::generateInputData() {
     }
 
     MPI_Comm col_communicator;
-    MPI_Comm_split(MPI_COMM_WORLD, executionSettings->programSettings->torus_col, 0,&col_communicator);
+    MPI_Comm_split(executionSettings->programSettings->torus_communicator, executionSettings->programSettings->torus_col, 0,&col_communicator);
 
     // Generate vector b by accumulating the columns of the matrix.
     // This will lead to a result vector x with ones on every position
     // Every rank will have a valid part of the final b vector stored
+    // The sums of all columns are reduced with a single collective operation
+    std::vector<HOST_DATA_TYPE> local_col_sums(executionSettings->programSettings->matrixSize, 0.0);
+#pragma omp parallel for
     for (int j = 0; j < executionSettings->programSettings->matrixSize; j++) {
         HOST_DATA_TYPE local_col_sum = 0.0;
         for (int i = 0; i < executionSettings->programSettings->matrixSize; i++) {
             local_col_sum += d->A[executionSettings->programSettings->matrixSize*i+j];
         }
-        HOST_DATA_TYPE row_sum = 0.0;
-        MPI_Allreduce(&local_col_sum, &(d->b[j]), 1, MPI_DATA_TYPE, MPI_SUM, col_communicator);   
+        local_col_sums[j] = local_col_sum;
+    }
+    MPI_Allreduce(local_col_sums.data(), d->b, executionSettings->programSettings->matrixSize, MPI_DATA_TYPE, MPI_SUM, col_communicator);
+    // The input data is generated again for every soak iteration, so the communicator must not be kept
+    MPI_Comm_free(&col_communicator);
+    for (int j = 0; j < executionSettings->programSettings->matrixSize; j++) {
         d->normb = (d->b[j] > d->normb) ? d->b[j] : d->normb;   
     }
+    // The additional right-hand sides are multiples of b, so the solution of right-hand side r contains r + 1 on every position
+    for (size_t r = 1; r < d->nrhs; r++) {
+        for (int j = 0; j < executionSettings->programSettings->matrixSize; j++) {
+            d->b[r * executionSettings->programSettings->matrixSize + j] = (r + 1) * d->b[j];
+        }
+    }
     return d;
 }
 
+std::unique_ptr<linpack::LinpackData>
+linpack::LinpackBenchmark::allocateInputData() {
+    return std::unique_ptr<linpack::LinpackData>(new linpack::LinpackData(*executionSettings->context ,executionSettings->programSettings->matrixSize,
+                                                                                    executionSettings->programSettings->nrhs));
+}
+
+std::vector<hpcc_base::DataRegion>
+linpack::LinpackBenchmark::getInputDataRegions(linpack::LinpackData &data) {
+    size_t n = executionSettings->programSettings->matrixSize;
+    return {{data.A, n * n * sizeof(HOST_DATA_TYPE)}, {data.b, n * data.nrhs * sizeof(HOST_DATA_TYPE)},
+            {data.ipvt, n * sizeof(cl_int)}, {&data.norma, sizeof(HOST_DATA_TYPE)}, {&data.normb, sizeof(HOST_DATA_TYPE)}};
+}
+
+std::vector<memory_tracker::MemoryRequirement>
+linpack::LinpackBenchmark::estimateMemoryUsage() {
+    const auto &settings = *executionSettings->programSettings;
+    size_t m = settings.matrixSize;
+    size_t value_size = sizeof(HOST_DATA_TYPE);
+    std::vector<memory_tracker::MemoryRequirement> requirements = {
+        {"A", m * m * value_size, 1, false},
+        {"b", m * settings.nrhs * value_size, 2, false},
+        {"ipvt", m * sizeof(cl_int), 1, false}};
+    if (settings.communicationType != hpcc_base::CommunicationType::cpu_only) {
+        requirements.push_back({"A", m * m * value_size, 1, true});
+        requirements.push_back({"b", m * value_size, 1, true});
+        requirements.push_back({"pivot", m * sizeof(cl_int), 1, true});
+    }
+    if (settings.skipValidation) {
+        return requirements;
+    }
+#ifndef DISTRIBUTED_VALIDATION
+    size_t n = m * settings.torus_width;
+    if (settings.isMixedPrecision) {
+        // The original matrix is generated again for the refinement
+        requirements.push_back({"A original", m * m * value_size, 1, false});
+    }
+    if (mpi_comm_rank == 0) {
+        requirements.push_back({"total_a", n * n * value_size, settings.isMixedPrecision ? 2u : 1u, false});
+        requirements.push_back({"total_b", n * value_size, 2, false});
+        if (settings.isMixedPrecision) {
+            requirements.push_back({"x, r", n * sizeof(double), 2, false});
+        }
+    }
+#else
+    requirements.push_back({"A original", m * m * value_size, 1, false});
+    // Solution and residual of all right-hand sides in double precision
+    requirements.push_back({"x, r", m * settings.nrhs * sizeof(double), 2, false});
+#endif
+    return requirements;
+}
+
+void
+linpack::LinpackBenchmark::adaptSettingsToBitstream() {
+    executionSettings->programSettings->setupTorus(executionSettings->communicator);
+}
+
+std::vector<std::string>
+linpack::LinpackBenchmark::getRankScalingArguments(int ranks, bool weak) {
+    if (weak) {
+        return {};
+    }
+    const auto &settings = *executionSettings->programSettings;
+    uint total_blocks = settings.matrixSize / settings.blockSize * settings.torus_width;
+    uint width = static_cast<uint>(std::sqrt(ranks));
+    if (total_blocks % width != 0) {
+        throw std::runtime_error("The matrix with " + std::to_string(total_blocks) + " blocks can not be divided between "
+                                    + std::to_string(ranks) + " ranks");
+    }
+    return {"-m", std::to_string(total_blocks / width)};
+}
+
 bool  
 linpack::LinpackBenchmark::validateOutputAndPrintError(linpack::LinpackData &data) {
     uint n= executionSettings->programSettings->matrixSize * executionSettings->programSettings->torus_width;
@@ -269,15 +488,36 @@ linpack::LinpackBenchmark::validateOutputAndPrintError(linpack::LinpackData &dat
     double resid = 0.0;
     double normx = 0.0;
 #ifndef DISTRIBUTED_VALIDATION
+    bool refine_solution = executionSettings->programSettings->isMixedPrecision;
+    std::unique_ptr<linpack::LinpackData> ref_data;
+    // The norm of A is only considered for the residual of the refined solution
+    double norma = 1.0;
+    if (refine_solution) {
+        // The refinement requires the original matrix, which was overwritten by the LU factorization
+        ref_data = generateOrLoadInputData();
+    }
     if (mpi_comm_rank > 0) {
         for (int j = 0; j < executionSettings->programSettings->matrixSize; j++) {
             for (int i = 0; i < executionSettings->programSettings->matrixSize; i+= executionSettings->programSettings->blockSize) {
-                MPI_Send(&data.A[executionSettings->programSettings->matrixSize * j + i], executionSettings->programSettings->blockSize, MPI_DATA_TYPE, 0, 0, MPI_COMM_WORLD);
+                MPI_Send(&data.A[executionSettings->programSettings->matrixSize * j + i], executionSettings->programSettings->blockSize, MPI_DATA_TYPE, 0, 0, executionSettings->programSettings->torus_communicator);
             }
         }
         if (executionSettings->programSettings->torus_row == 0) {
             for (int i = 0; i < executionSettings->programSettings->matrixSize; i+= executionSettings->programSettings->blockSize) {
-                MPI_Send(&data.b[i], executionSettings->programSettings->blockSize, MPI_DATA_TYPE, 0, 0, MPI_COMM_WORLD);
+                MPI_Send(&data.b[i], executionSettings->programSettings->blockSize, MPI_DATA_TYPE, 0, 0, executionSettings->programSettings->torus_communicator);
+            }
+        }
+#ifdef USE_PIVOTING
+        // The pivots are only calculated on the diagonal ranks
+        if (executionSettings->programSettings->torus_row == executionSettings->programSettings->torus_col) {
+            MPI_Send(data.ipvt, executionSettings->programSettings->matrixSize, MPI_INT, 0, 2, executionSettings->programSettings->torus_communicator);
+        }
+#endif
+        if (refine_solution) {
+            for (int j = 0; j < executionSettings->programSettings->matrixSize; j++) {
+                for (int i = 0; i < executionSettings->programSettings->matrixSize; i+= executionSettings->programSettings->blockSize) {
+                    MPI_Send(&ref_data->A[executionSettings->programSettings->matrixSize * j + i], executionSettings->programSettings->blockSize, MPI_DATA_TYPE, 0, 1, executionSettings->programSettings->torus_communicator);
+                }
             }
         }
         residn = 0;
@@ -294,7 +534,7 @@ linpack::LinpackBenchmark::validateOutputAndPrintError(linpack::LinpackData &dat
                 int recvrow= (j / executionSettings->programSettings->blockSize) % executionSettings->programSettings->torus_width;
                 int recvrank = executionSettings->programSettings->torus_width * recvrow + recvcol;
                 if (recvrank > 0) {
-                    MPI_Recv(&total_a[j * executionSettings->programSettings->matrixSize * executionSettings->programSettings->torus_width + i],executionSettings->programSettings->blockSize, MPI_DATA_TYPE, recvrank, 0, MPI_COMM_WORLD,  &status);
+                    MPI_Recv(&total_a[j * executionSettings->programSettings->matrixSize * executionSettings->programSettings->torus_width + i],executionSettings->programSettings->blockSize, MPI_DATA_TYPE, recvrank, 0, executionSettings->programSettings->torus_communicator,  &status);
                 }
                 else {
                     for (int k=0; k < executionSettings->programSettings->blockSize; k++) {
@@ -308,7 +548,7 @@ linpack::LinpackBenchmark::validateOutputAndPrintError(linpack::LinpackData &dat
         for (int i = 0; i < executionSettings->programSettings->matrixSize* executionSettings->programSettings->torus_width; i+= executionSettings->programSettings->blockSize) {
             int recvcol= (i / executionSettings->programSettings->blockSize) % executionSettings->programSettings->torus_width;
             if (recvcol > 0) {
-                MPI_Recv(&total_b[i], executionSettings->programSettings->blockSize, MPI_DATA_TYPE, recvcol, 0, MPI_COMM_WORLD, &status);
+                MPI_Recv(&total_b[i], executionSettings->programSettings->blockSize, MPI_DATA_TYPE, recvcol, 0, executionSettings->programSettings->torus_communicator, &status);
             }
             else {
                 for (int k=0; k < executionSettings->programSettings->blockSize; k++) {
@@ -318,32 +558,173 @@ linpack::LinpackBenchmark::validateOutputAndPrintError(linpack::LinpackData &dat
             }
         }
         std::copy(total_b.begin(), total_b.end(), total_b_original.begin());
+#ifdef USE_PIVOTING
+        std::vector<cl_int> total_ipvt(n);
+        std::vector<cl_int> local_ipvt(executionSettings->programSettings->matrixSize);
+        for (int t = 0; t < executionSettings->programSettings->torus_width; t++) {
+            int recvrank = executionSettings->programSettings->torus_width * t + t;
+            if (recvrank > 0) {
+                MPI_Recv(local_ipvt.data(), executionSettings->programSettings->matrixSize, MPI_INT, recvrank, 2, executionSettings->programSettings->torus_communicator, &status);
+            }
+            else {
+                std::copy(data.ipvt, data.ipvt + executionSettings->programSettings->matrixSize, local_ipvt.begin());
+            }
+            // Block lb of the diagonal rank t is the global block lb * torus_width + t
+            for (int lb = 0; lb < executionSettings->programSettings->matrixSize / executionSettings->programSettings->blockSize; lb++) {
+                for (int k = 0; k < executionSettings->programSettings->blockSize; k++) {
+                    total_ipvt[(lb * executionSettings->programSettings->torus_width + t) * executionSettings->programSettings->blockSize + k] = local_ipvt[lb * executionSettings->programSettings->blockSize + k];
+                }
+            }
+        }
+        gesl_ref_block_pvt(total_a.data(), total_b.data(), total_ipvt.data(), n, n);
+#else
         gesl_ref_nopvt(total_a.data(), total_b.data(), n, n);
+#endif
 
-        for (int i = 0; i < n; i++) {
-            resid = (resid > std::abs(total_b[i] - 1)) ? resid : std::abs(total_b[i] - 1);
-            normx = (normx > std::abs(total_b_original[i])) ? normx : std::abs(total_b_original[i]);
+        if (refine_solution) {
+            // Receive the original matrix in the same order as the factorized matrix
+            std::vector<HOST_DATA_TYPE> total_a_original(total_a.size());
+            current_offset = 0;
+            for (int j = 0; j < n; j++) {
+                for (int i = 0; i < n; i+= executionSettings->programSettings->blockSize) {
+                    int recvcol= (i / executionSettings->programSettings->blockSize) % executionSettings->programSettings->torus_width;
+                    int recvrow= (j / executionSettings->programSettings->blockSize) % executionSettings->programSettings->torus_width;
+                    int recvrank = executionSettings->programSettings->torus_width * recvrow + recvcol;
+                    if (recvrank > 0) {
+                        MPI_Recv(&total_a_original[j * n + i], executionSettings->programSettings->blockSize, MPI_DATA_TYPE, recvrank, 1, executionSettings->programSettings->torus_communicator,  &status);
+                    }
+                    else {
+                        for (int k=0; k < executionSettings->programSettings->blockSize; k++) {
+                            total_a_original[j * n + i + k] = ref_data->A[current_offset + k];
+                        }
+                        current_offset += executionSettings->programSettings->blockSize;
+                    }
+                }
+            }
+            std::vector<double> x(total_b.begin(), total_b.end());
+            auto t1 = std::chrono::high_resolution_clock::now();
+            refine_nopvt_ref(total_a_original.data(), total_a.data(), total_b_original.data(), x.data(), n, n);
+            auto t2 = std::chrono::high_resolution_clock::now();
+            std::cout << "Refinement Time: " << std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1).count() << " s" << std::endl;
+
+            // Calculate the residual of the refined solution with the original matrix in double precision
+            std::vector<double> r(total_b_original.begin(), total_b_original.end());
+            norma = 0.0;
+            for (int j = 0; j < n; j++) {
+                for (int i = 0; i < n; i++) {
+                    r[i] -= static_cast<double>(total_a_original[j * n + i]) * x[j];
+                    norma = std::max(norma, static_cast<double>(std::abs(total_a_original[j * n + i])));
+                }
+            }
+            for (int i = 0; i < n; i++) {
+                resid = std::max(resid, std::abs(r[i]));
+                normx = std::max(normx, std::abs(x[i]));
+            }
+        }
+        else {
+            for (int i = 0; i < n; i++) {
+                resid = (resid > std::abs(total_b[i] - 1)) ? resid : std::abs(total_b[i] - 1);
+                normx = (normx > std::abs(total_b_original[i])) ? normx : std::abs(total_b_original[i]);
+            }
         }
     }
+    // The refined solution has to reach double precision accuracy
+    double eps = (refine_solution) ? std::numeric_limits<double>::epsilon() : std::numeric_limits<HOST_DATA_TYPE>::epsilon();
+    residn = resid / (static_cast<double>(n)*norma*normx*eps);
 #else
-    double local_resid = 0;
-    double local_normx = data.normb;
-    #pragma omp parallel for reduction(max:local_resid)
-    for (int i = 0; i < executionSettings->programSettings->matrixSize; i++) {
-        local_resid = (local_resid > std::abs(data.b[i] - 1)) ? local_resid : std::abs(data.b[i] - 1);
-    }
+    // Calculate the residual ||Ax - b|| fully distributed on the torus without gathering the matrix.
+    // The LU factorization overwrote A, so the original matrix and vector b are regenerated locally on every rank.
+    auto ref_data = generateOrLoadInputData();
+    uint matrix_size = executionSettings->programSettings->matrixSize;
+    uint block_size = executionSettings->programSettings->blockSize;
+    MPI_Comm row_communicator;
+    MPI_Comm_split(executionSettings->programSettings->torus_communicator, executionSettings->programSettings->torus_row, 0,&row_communicator);
+    MPI_Comm col_communicator;
+    MPI_Comm_split(executionSettings->programSettings->torus_communicator, executionSettings->programSettings->torus_col, 0,&col_communicator);
+
+    // The solution is kept in double precision, so it can be refined beyond the precision of the factorization
+    std::vector<double> x(data.b, data.b + matrix_size * data.nrhs);
+    std::vector<double> r(x.size());
+    // Calculate r = b - Ax for the local rows and the global max norms of the residual and x over all right-hand sides
+    auto calculate_residual = [&](double &global_resid, double &global_normx) {
+        double local_resid = 0.0;
+        double local_normx = 0.0;
+        for (size_t k = 0; k < data.nrhs; k++) {
+            const double *x_k = &x[k * matrix_size];
+            HOST_DATA_TYPE *b = &ref_data->b[k * matrix_size];
+            // The part of x that belongs to the local columns of A is stored on the diagonal rank of the torus row
+            std::vector<double> x_cols(x_k, x_k + matrix_size);
+            MPI_Bcast(x_cols.data(), matrix_size, MPI_DOUBLE, executionSettings->programSettings->torus_row, row_communicator);
+
+            // Multiply the local block of A with the local part of x. Rows are processed block-wise in parallel
+            std::vector<double> local_y(matrix_size, 0.0);
+            #pragma omp parallel for
+            for (int ib = 0; ib < matrix_size; ib += block_size) {
+                int i_end = std::min(ib + block_size, matrix_size);
+                for (int j = 0; j < matrix_size; j++) {
+                    for (int i = ib; i < i_end; i++) {
+                        local_y[i] += static_cast<double>(ref_data->A[matrix_size * j + i]) * x_cols[j];
+                    }
+                }
+            }
+            // Sum up the partial results of all ranks that contain the same rows of A
+            std::vector<double> y(matrix_size);
+            MPI_Allreduce(local_y.data(), y.data(), matrix_size, MPI_DOUBLE, MPI_SUM, col_communicator);
+
+            #pragma omp parallel for reduction(max:local_resid,local_normx)
+            for (int i = 0; i < matrix_size; i++) {
+                r[k * matrix_size + i] = static_cast<double>(b[i]) - y[i];
+                local_resid = std::max(local_resid, std::abs(r[k * matrix_size + i]));
+                local_normx = std::max(local_normx, std::abs(x_k[i]));
+            }
+        }
+        double local_norms[2] = {local_resid, local_normx};
+        double norms[2];
+        MPI_Allreduce(local_norms, norms, 2, MPI_DOUBLE, MPI_MAX, executionSettings->communicator);
+        global_resid = norms[0];
+        global_normx = norms[1];
+    };
+    double local_norma = std::abs(ref_data->norma);
+    double norma;
+    MPI_Allreduce(&local_norma, &norma, 1, MPI_DOUBLE, MPI_MAX, executionSettings->communicator);
+    calculate_residual(resid, normx);
 #ifndef NDEBUG
-    std::cout << "Rank " << mpi_comm_rank << ": resid=" << local_resid << ", normx=" << local_normx << std::endl;
+    std::cout << "Rank " << mpi_comm_rank << ": resid=" << resid << ", normx=" << normx << std::endl;
 #endif
 
-    MPI_Reduce(&local_resid, &resid, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
-    MPI_Reduce(&local_normx, &normx, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    bool refine_solution = executionSettings->programSettings->isMixedPrecision;
+    // The refined solution has to reach double precision accuracy
+    double eps = (refine_solution) ? std::numeric_limits<double>::epsilon() : std::numeric_limits<HOST_DATA_TYPE>::epsilon();
+    if (refine_solution) {
+        // Iterative refinement: the correction is solved with the factorized matrix in low precision,
+        // the residual and the solution are calculated in double precision
+        const int max_iterations = 10;
+        auto t1 = std::chrono::high_resolution_clock::now();
+        int iteration = 0;
+        for (; iteration < max_iterations && resid / (static_cast<double>(n)*norma*normx*eps) >= 1; iteration++) {
+            for (size_t k = 0; k < r.size(); k++) {
+                data.b[k] = static_cast<HOST_DATA_TYPE>(r[k]);
+            }
+            distributed_gesl_nopvt_ref(data);
+            for (size_t k = 0; k < x.size(); k++) {
+                x[k] += static_cast<double>(data.b[k]);
+            }
+            calculate_residual(resid, normx);
+        }
+        auto t2 = std::chrono::high_resolution_clock::now();
+        for (size_t k = 0; k < x.size(); k++) {
+            data.b[k] = static_cast<HOST_DATA_TYPE>(x[k]);
+        }
+        if (mpi_comm_rank == 0) {
+            std::cout << "Refinement Time: " << std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1).count() 
+                      << " s, " << iteration << " iterations" << std::endl;
+        }
+    }
+    MPI_Comm_free(&row_communicator);
+    MPI_Comm_free(&col_communicator);
+    residn = resid / (static_cast<double>(n)*norma*normx*eps);
 #endif
 
-
-    HOST_DATA_TYPE eps = std::numeric_limits<HOST_DATA_TYPE>::epsilon();
-    residn = resid / (static_cast<double>(n)*normx*eps);
-
     #ifndef NDEBUG
         if (residn > 1 &&  mpi_comm_size == 1) {
             auto ref_result = generateInputData();
@@ -405,18 +786,27 @@ linpack::LinpackBenchmark::distributed_gesl_nopvt_ref(linpack::LinpackData& data
     uint total_matrix_size = matrix_size * block_size;
     // create a communicator to exchange the rows
     MPI_Comm row_communicator;
-    MPI_Comm_split(MPI_COMM_WORLD, executionSettings->programSettings->torus_row, 0,&row_communicator);
+    MPI_Comm_split(executionSettings->programSettings->torus_communicator, executionSettings->programSettings->torus_row, 0,&row_communicator);
     MPI_Comm col_communicator;
-    MPI_Comm_split(MPI_COMM_WORLD, executionSettings->programSettings->torus_col, 0,&col_communicator);
-    std::vector<HOST_DATA_TYPE> b_tmp(matrix_size);
+    MPI_Comm_split(executionSettings->programSettings->torus_communicator, executionSettings->programSettings->torus_col, 0,&col_communicator);
+    size_t nrhs = data.nrhs;
+    std::vector<HOST_DATA_TYPE> b_tmp(matrix_size * nrhs);
     // if 0= diagonal rank, if negative= lower rank, if positive = upper rank
     int op_mode = executionSettings->programSettings->torus_col - executionSettings->programSettings->torus_row;
 
 
-    for (int k = 0; k < matrix_size; k++) {
+    for (int k = 0; k < matrix_size * nrhs; k++) {
         b_tmp[k] = data.b[k];
     }
 
+#ifdef USE_PIVOTING
+    // The row exchanges of a block are only known by the diagonal rank, so distribute them in the column.
+    // All ranks of the column hold the part of b that is affected by the exchanges.
+    for (int k = 0; k < matrix_size; k += block_size) {
+        MPI_Bcast(&data.ipvt[k], block_size, MPI_INT, executionSettings->programSettings->torus_col, col_communicator);
+    }
+#endif
+
     // solve l*y = b
     // For each row in matrix
     for (int k = 0; k < matrix_size * executionSettings->programSettings->torus_width - 1; k++) {
@@ -439,23 +829,42 @@ linpack::LinpackBenchmark::distributed_gesl_nopvt_ref(linpack::LinpackData& data
             local_k_index_row += (remaining_k % block_size);
         }
 
+#ifdef USE_PIVOTING
+        if (remaining_k / block_size == executionSettings->programSettings->torus_col) {
+            // Apply the row exchange of the current step. The exchanged row is always in the same block.
+            size_t pvt_index = local_k_index_col + data.ipvt[local_k_index_col] - k;
+            for (size_t r = 0; r < nrhs; r++) {
+                HOST_DATA_TYPE tmp = b_tmp[r * matrix_size + pvt_index];
+                b_tmp[r * matrix_size + pvt_index] = b_tmp[r * matrix_size + local_k_index_col];
+                b_tmp[r * matrix_size + local_k_index_col] = tmp;
+            }
+        }
+#endif
         int current_bcast = (k / block_size) % executionSettings->programSettings->torus_width;
-        std::vector<HOST_DATA_TYPE> tmp_scaled_b(matrix_size, 0.0);
+        // The scaled rows of all right-hand sides are stored one after another, so they can be sent with a single broadcast
+        size_t scaled_size = matrix_size - start_offset;
+        std::vector<HOST_DATA_TYPE> tmp_scaled_b(scaled_size * nrhs, 0.0);
         if ((k / block_size) % executionSettings->programSettings->torus_width == executionSettings->programSettings->torus_row) {
-            HOST_DATA_TYPE current_k;
-            current_k = (local_k_index_col < matrix_size) ? b_tmp[local_k_index_col] : 0.0;
-            MPI_Bcast(&current_k, 1, MPI_DATA_TYPE,  current_bcast, row_communicator);
+            std::vector<HOST_DATA_TYPE> current_k(nrhs);
+            for (size_t r = 0; r < nrhs; r++) {
+                current_k[r] = (local_k_index_col < matrix_size) ? b_tmp[r * matrix_size + local_k_index_col] : 0.0;
+            }
+            MPI_Bcast(current_k.data(), nrhs, MPI_DATA_TYPE,  current_bcast, row_communicator);
             // For each row below add
+            for (size_t r = 0; r < nrhs; r++) {
+                for (int i = start_offset; i < matrix_size; i++) {
+                    // add solved upper row to current row
+                    tmp_scaled_b[r * scaled_size + i - start_offset] = current_k[r] * data.A[matrix_size * local_k_index_row + i];
+                }
+            }
+        }
+        MPI_Bcast(tmp_scaled_b.data(), scaled_size * nrhs, MPI_DATA_TYPE, current_bcast, col_communicator);
+        for (size_t r = 0; r < nrhs; r++) {
             for (int i = start_offset; i < matrix_size; i++) {
                 // add solved upper row to current row
-                tmp_scaled_b[i] = current_k * data.A[matrix_size * local_k_index_row + i];
+                b_tmp[r * matrix_size + i] += tmp_scaled_b[r * scaled_size + i - start_offset];
             }
         }
-        MPI_Bcast(&tmp_scaled_b.data()[start_offset], matrix_size - start_offset, MPI_DATA_TYPE, current_bcast, col_communicator);
-        for (int i = start_offset; i < matrix_size; i++) {
-            // add solved upper row to current row
-            b_tmp[i] += tmp_scaled_b[i];
-        }
     }
 
     // now solve  u*x = y
@@ -476,31 +885,42 @@ linpack::LinpackBenchmark::distributed_gesl_nopvt_ref(linpack::LinpackData& data
             local_k_index_row += remaining_k % block_size;
         }
 
-        HOST_DATA_TYPE scale_element = (local_k_index_col < matrix_size && local_k_index_row < matrix_size) ? b_tmp[local_k_index_col] * data.A[matrix_size * local_k_index_row + local_k_index_col] : 0.0;
-        MPI_Bcast(&scale_element, 1, MPI_DATA_TYPE, executionSettings->programSettings->torus_col, col_communicator);
+        std::vector<HOST_DATA_TYPE> scale_element(nrhs);
+        for (size_t r = 0; r < nrhs; r++) {
+            scale_element[r] = (local_k_index_col < matrix_size && local_k_index_row < matrix_size) ? b_tmp[r * matrix_size + local_k_index_col] * data.A[matrix_size * local_k_index_row + local_k_index_col] : 0.0;
+        }
+        MPI_Bcast(scale_element.data(), nrhs, MPI_DATA_TYPE, executionSettings->programSettings->torus_col, col_communicator);
         if ((k / block_size) % executionSettings->programSettings->torus_width == executionSettings->programSettings->torus_col) {
-            b_tmp[local_k_index_col] = -scale_element;
+            for (size_t r = 0; r < nrhs; r++) {
+                b_tmp[r * matrix_size + local_k_index_col] = -scale_element[r];
+            }
         }
-        MPI_Bcast(&scale_element, 1, MPI_DATA_TYPE, executionSettings->programSettings->torus_row, row_communicator);
+        MPI_Bcast(scale_element.data(), nrhs, MPI_DATA_TYPE, executionSettings->programSettings->torus_row, row_communicator);
         size_t end_offset = local_k_index_col;
 
-        std::vector<HOST_DATA_TYPE> tmp_scaled_b(matrix_size, 0.0);
+        std::vector<HOST_DATA_TYPE> tmp_scaled_b(end_offset * nrhs, 0.0);
         if ((k / block_size) % executionSettings->programSettings->torus_width == executionSettings->programSettings->torus_row) {
             // For each row below add
-            for (int i = 0; i < end_offset; i++) {
-                tmp_scaled_b[i] = scale_element * data.A[matrix_size * local_k_index_row + i];
+            for (size_t r = 0; r < nrhs; r++) {
+                for (int i = 0; i < end_offset; i++) {
+                    tmp_scaled_b[r * end_offset + i] = scale_element[r] * data.A[matrix_size * local_k_index_row + i];
+                }
             }
         }
         int current_bcast = (k / block_size) % executionSettings->programSettings->torus_width;
-        MPI_Bcast(tmp_scaled_b.data(), end_offset, MPI_DATA_TYPE, current_bcast, col_communicator);
-        for (int i = 0; i < end_offset; i++) {
-            // add solved upper row to current row
-            b_tmp[i] += tmp_scaled_b[i];
+        MPI_Bcast(tmp_scaled_b.data(), end_offset * nrhs, MPI_DATA_TYPE, current_bcast, col_communicator);
+        for (size_t r = 0; r < nrhs; r++) {
+            for (int i = 0; i < end_offset; i++) {
+                // add solved upper row to current row
+                b_tmp[r * matrix_size + i] += tmp_scaled_b[r * end_offset + i];
+            }
         }
     }
-    for (int k = 0; k < matrix_size; k++) {
+    for (int k = 0; k < matrix_size * nrhs; k++) {
         data.b[k] = b_tmp[k];
     }
+    MPI_Comm_free(&row_communicator);
+    MPI_Comm_free(&col_communicator);
 #ifndef NDEBUG
     double sum = 0;
     double max = 0;
@@ -678,3 +1098,112 @@ linpack::gesl_ref_nopvt(HOST_DATA_TYPE* a, HOST_DATA_TYPE* b, unsigned n, unsign
     }
     delete [] b_tmp;
 }
+
+void
+linpack::gefa_ref_block_pvt(HOST_DATA_TYPE* a, unsigned n, unsigned lda, unsigned block_size, cl_int* ipvt) {
+    // For each diagnonal element
+    for (int k = 0; k < n; k++) {
+        // Search the pivot only within the rows of the current block
+        int block_end = (k / block_size + 1) * block_size;
+        HOST_DATA_TYPE max_val = fabs(a[k * lda + k]);
+        int pvt_index = k;
+        for (int i = k + 1; i < block_end; i++) {
+            if (max_val < fabs(a[k * lda + i])) {
+                pvt_index = i;
+                max_val = fabs(a[k * lda + i]);
+            }
+        }
+        ipvt[k] = pvt_index;
+
+        // Exchange the rows for the current and all following columns
+        if (pvt_index != k) {
+            for (int j = k; j < n; j++) {
+                HOST_DATA_TYPE tmp_val = a[j * lda + k];
+                a[j * lda + k] = a[j * lda + pvt_index];
+                a[j * lda + pvt_index] = tmp_val;
+            }
+        }
+
+        // Store negatie invers of diagonal elements to get rid of some divisions afterwards!
+        a[k * lda + k] = -1.0 / a[k * lda + k];
+        // For each element below it
+        for (int i = k + 1; i < n; i++) {
+            a[k * lda + i] *= a[k * lda + k];
+        }
+        // For each column right of current diagonal element
+        for (int j = k + 1; j < n; j++) {
+            // For each element below it
+            for (int i = k+1; i < n; i++) {
+                a[j * lda + i] += a[k * lda + i] * a[j * lda + k];
+            }
+        }
+    }
+}
+
+void
+linpack::gesl_ref_block_pvt(HOST_DATA_TYPE* a, HOST_DATA_TYPE* b, cl_int* ipvt, unsigned n, unsigned lda) {
+    auto b_tmp = new HOST_DATA_TYPE[n];
+
+    for (int k = 0; k < n; k++) {
+        b_tmp[k] = b[k];
+    }
+
+    // solve l*y = b
+    // For each row in matrix
+    for (int k = 0; k < n - 1; k++) {
+        // Apply the row exchange of the current step
+        HOST_DATA_TYPE tmp = b_tmp[ipvt[k]];
+        b_tmp[ipvt[k]] = b_tmp[k];
+        b_tmp[k] = tmp;
+        // For each row below add
+        for (int i = k + 1; i < n; i++) {
+            // add solved upper row to current row
+            b_tmp[i] += b_tmp[k] * a[lda * k + i];
+        }
+    }
+
+    // now solve  u*x = y
+    for (int k = n - 1; k >= 0; k--) {
+        HOST_DATA_TYPE scale = b_tmp[k] * a[lda * k + k];
+        b_tmp[k] = -scale;
+        for (int i = 0; i < k; i++) {
+            b_tmp[i] += scale * a[lda * k + i];
+        }
+    }
+    for (int k = 0; k < n; k++) {
+        b[k] = b_tmp[k];
+    }
+    delete [] b_tmp;
+}
+
+void
+linpack::refine_nopvt_ref(const HOST_DATA_TYPE* a, const HOST_DATA_TYPE* lu, const HOST_DATA_TYPE* b, double* x, unsigned n, unsigned lda) {
+    // Restart length and maximum number of restarts of GMRES
+    const int restart = 50;
+    const int max_iterations = 10;
+    const double tolerance = 1.0e-14;
+
+    std::vector<double> a_d(n * n);
+    std::vector<double> lu_d(n * n);
+    std::vector<double> b_d(b, b + n);
+    // Convert the matrices to double and the LU representation of gefa_ref_nopvt into a unit lower triangular L
+    // and an upper triangular U stored in the same matrix as expected by gmres_ref
+    #pragma omp parallel for
+    for (int j = 0; j < n; j++) {
+        for (int i = 0; i < n; i++) {
+            a_d[j * n + i] = static_cast<double>(a[j * lda + i]);
+            if (i > j) {
+                // gefa stores the negative multipliers
+                lu_d[j * n + i] = -static_cast<double>(lu[j * lda + i]);
+            }
+            else if (i == j) {
+                // gefa stores the negative inverse of the diagonal
+                lu_d[j * n + i] = -1.0 / static_cast<double>(lu[j * lda + i]);
+            }
+            else {
+                lu_d[j * n + i] = static_cast<double>(lu[j * lda + i]);
+            }
+        }
+    }
+    gmres_ref(n, a_d.data(), n, x, b_d.data(), lu_d.data(), n, restart, max_iterations, tolerance);
+}
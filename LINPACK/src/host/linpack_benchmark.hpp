@@ -72,23 +72,68 @@ public:
      */
     bool isEmulationKernel;
 
+    /**
+     * @brief True, if the solution of the low precision factorization should be refined with GMRES in double precision
+     *          on the host before the residual is calculated (HPL-AI mode)
+     * 
+     */
+    bool isMixedPrecision;
+
     /**
      * @brief The row position of this MPI rank in the torus
      * 
      */
-    int torus_row;
+    int torus_row = 0;
 
     /**
      * @brief The rcolumn position of this MPI rank in the torus
      * 
      */
-    int torus_col;
+    int torus_col = 0;
 
     /**
      * @brief Width of the torus in number of ranks
      * 
      */
-    int torus_width;
+    int torus_width = 1;
+
+    /**
+     * @brief Path to the file that describes the placement of the ranks in the torus. Empty, if no file is used.
+     * 
+     */
+    std::string topologyFile;
+
+    /**
+     * @brief True, if the ranks of the same node should be placed next to each other in the torus rows
+     * 
+     */
+    bool isNodeAwarePlacement;
+
+    /**
+     * @brief True, if the blocks are exchanged over shared memory between ranks on the same node
+     * 
+     */
+    bool useSharedMemory;
+
+    /**
+     * @brief True, if the blocks are broadcast with non-blocking MPI collectives in the PCIe version,
+     *          so the network transfers overlap with the transfers between host and FPGA
+     * 
+     */
+    bool isPipelinedBroadcast;
+
+    /**
+     * @brief Number of right-hand sides that are solved with the factorized matrix
+     * 
+     */
+    uint nrhs;
+
+    /**
+     * @brief Communicator that contains all ranks ordered by their position in the torus.
+     *          The rank in this communicator is torus_row * torus_width + torus_col.
+     * 
+     */
+    MPI_Comm torus_communicator = MPI_COMM_NULL;
 
     /**
      * @brief Construct a new Linpack Program Settings object
@@ -97,6 +142,24 @@ public:
      */
     LinpackProgramSettings(cxxopts::ParseResult &results);
 
+    LinpackProgramSettings(const LinpackProgramSettings&) = delete;
+    LinpackProgramSettings& operator=(const LinpackProgramSettings&) = delete;
+
+    /**
+     * @brief Destroy the Linpack Program Settings object and free the torus communicator
+     * 
+     */
+    ~LinpackProgramSettings();
+
+    /**
+     * @brief Calculate the position of this rank in the torus and create the torus communicator.
+     *          It has to be called by all ranks of the communicator.
+     * 
+     * @param communicator The communicator of the ranks that execute the benchmark
+     */
+    void
+    setupTorus(MPI_Comm communicator);
+
     /**
      * @brief Get a map of the settings. This map will be used to print the final configuration.
      * 
@@ -121,11 +184,18 @@ public:
     HOST_DATA_TYPE *A;
 
     /**
-     * @brief  The input vector the right side of the linear equation system
+     * @brief  The right-hand sides of the linear equation system stored one after another.
+     *          The first right-hand side is used for the validation of the factorization.
      * 
      */
     HOST_DATA_TYPE *b;
 
+    /**
+     * @brief Number of right-hand sides stored in b
+     * 
+     */
+    size_t nrhs;
+
     /**
      * @brief A vector that can be used to store pivoting information
      * 
@@ -155,8 +225,9 @@ public:
      * 
      * @param context The OpenCL context used to allocate memory in SVM mode
      * @param size Size of the allocated square matrix and vectors
+     * @param nrhs Number of right-hand sides
      */
-    LinpackData(cl::Context context, size_t size);
+    LinpackData(cl::Context context, size_t size, size_t nrhs = 1);
 
     /**
      * @brief Destroy the Linpack Data object. Free the allocated memory
@@ -204,9 +275,11 @@ protected:
     addAdditionalParseOptions(cxxopts::Options &options) override;
 
     /**
-     * @brief Distributed solving of l*y=b and u*x = y 
+     * @brief Distributed solving of l*y=b and u*x = y for all right-hand sides in b.
+     *          The right-hand sides are solved together, so every broadcast transfers the values of all of them.
+     *          If USE_PIVOTING is defined, the row exchanges given in ipvt of the diagonal ranks are applied to b.
      * 
-     * @param data The local data. b will contain the solution for the unknows that were handeled by this rank
+     * @param data The local data. b will contain the solutions for the unknows that were handeled by this rank
      */
     void 
     distributed_gesl_nopvt_ref(linpack::LinpackData& data);
@@ -221,6 +294,51 @@ public:
     std::unique_ptr<LinpackData>
     generateInputData() override;
 
+    /**
+     * @brief Allocate the input data without initialization to load it from the data cache
+     * 
+     * @return std::unique_ptr<LinpackData> The allocated input and output data of the benchmark
+     */
+    std::unique_ptr<LinpackData>
+    allocateInputData() override;
+
+    /**
+     * @brief Get the memory regions of the matrix, the vectors and the norms that are stored in the data cache
+     * 
+     * @param data The input data
+     * @return std::vector<hpcc_base::DataRegion> The memory regions of the input data
+     */
+    std::vector<hpcc_base::DataRegion>
+    getInputDataRegions(LinpackData &data) override;
+
+    /**
+     * @brief Estimate the memory of the matrix, the vectors and the buffers. Without distributed validation,
+     *          rank 0 additionally gathers the whole matrix for the validation.
+     * 
+     * @return std::vector<memory_tracker::MemoryRequirement> The estimated allocations of this rank
+     */
+    std::vector<memory_tracker::MemoryRequirement>
+    estimateMemoryUsage() override;
+
+    /**
+     * @brief Arrange the ranks of the communicator in the execution settings in a torus
+     * 
+     */
+    void
+    adaptSettingsToBitstream() override;
+
+    /**
+     * @brief Get the matrix size for a rank scaling. The matrix size is given per rank, so it is kept for the weak scaling
+     *          and divided by the torus width for the strong scaling.
+     * 
+     * @param ranks Number of ranks the benchmark will be executed on
+     * @param weak True for the weak scaling
+     * @return std::vector<std::string> The matrix size in blocks, if it has to be changed
+     * @throw std::runtime_error if the matrix can not be divided between the ranks
+     */
+    std::vector<std::string>
+    getRankScalingArguments(int ranks, bool weak) override;
+
     /**
      * @brief Linpack specific implementation of the kernel execution
      * 
@@ -325,6 +443,47 @@ where A is a matrix of size n*n
 */
 void gesl_ref_nopvt(HOST_DATA_TYPE* a, HOST_DATA_TYPE* b, unsigned n, unsigned lda);
 
+/**
+Gaussian elemination reference implementation with partial pivoting restricted to the rows of a block.
+The pivot is only searched within the rows of the diagonal block, like it is done by the FPGA kernels
+if USE_PIVOTING is defined. The LU representation is the same as for gefa_ref_nopvt.
+
+@param a the matrix with size of n*n
+@param n size of matrix A
+@param lda row with of the matrix. must be >=n
+@param block_size size of the blocks the pivoting is restricted to. n must be a multiple of it.
+@param ipvt array of pivoting indices of size n
+
+*/
+void gefa_ref_block_pvt(HOST_DATA_TYPE* a, unsigned n, unsigned lda, unsigned block_size, cl_int* ipvt);
+
+/**
+Solve linear equations using its LU decomposition with pivoting as calculated by gefa_ref_block_pvt
+or the FPGA kernels if USE_PIVOTING is defined.
+
+@param a the matrix a in LU representation calculated by gefa_ref_block_pvt
+@param b vector b of the given equation
+@param ipvt array of pivoting indices
+@param n size of matrix A
+@param lda row with of the matrix. must be >=n
+
+*/
+void gesl_ref_block_pvt(HOST_DATA_TYPE* a, HOST_DATA_TYPE* b, cl_int* ipvt, unsigned n, unsigned lda);
+
+/**
+Refine the solution of a linear equation system that was solved with a low precision LU decomposition
+without pivoting. The refinement uses GMRES in double precision with the LU decomposition as preconditioner.
+
+@param a the original matrix a
+@param lu the matrix a in LU representation calculated by gefa_ref_nopvt
+@param b vector b of the given equation
+@param x the solution calculated by gesl_ref_nopvt. Will contain the refined solution.
+@param n size of matrix A
+@param lda row with of the matrix. must be >=n
+
+*/
+void refine_nopvt_ref(const HOST_DATA_TYPE* a, const HOST_DATA_TYPE* lu, const HOST_DATA_TYPE* b, double* x, unsigned n, unsigned lda);
+
 } // namespace stream
 
 
@@ -0,0 +1,139 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "torus_placement.hpp"
+
+/* C++ standard library headers */
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+std::vector<std::string>
+linpack::placement::parseTopology(std::istream &in) {
+    std::vector<std::string> entries;
+    std::string line;
+    while (std::getline(in, line)) {
+        line = line.substr(0, line.find('#'));
+        std::stringstream ss(line);
+        std::string entry;
+        while (ss >> entry) {
+            entries.push_back(entry);
+        }
+    }
+    return entries;
+}
+
+std::vector<std::string>
+linpack::placement::readTopologyFile(const std::string &file_name) {
+    std::ifstream fs(file_name);
+    if (!fs.is_open()) {
+        throw std::runtime_error("Could not open topology file " + file_name);
+    }
+    return parseTopology(fs);
+}
+
+std::vector<int>
+linpack::placement::calculateTorusPositions(const std::vector<std::string> &rank_hosts, const std::vector<std::string> &topology, int torus_width) {
+    int num_ranks = static_cast<int>(rank_hosts.size());
+    if (torus_width * torus_width != num_ranks) {
+        throw std::runtime_error("The number of ranks " + std::to_string(num_ranks) + " does not match the torus width " + std::to_string(torus_width));
+    }
+
+    // All ranks of a host in ascending order. The index of a rank in this list is its node-local index
+    std::map<std::string, std::vector<int>> host_ranks;
+    std::vector<std::string> host_order;
+    for (int r = 0; r < num_ranks; r++) {
+        if (host_ranks.find(rank_hosts[r]) == host_ranks.end()) {
+            host_order.push_back(rank_hosts[r]);
+        }
+        host_ranks[rank_hosts[r]].push_back(r);
+    }
+
+    std::vector<int> positions(num_ranks, -1);
+    if (topology.empty()) {
+        // Fill the torus row by row with the ranks of one node after the other
+        int position = 0;
+        for (const auto &host : host_order) {
+            for (int r : host_ranks[host]) {
+                positions[r] = position++;
+            }
+        }
+    }
+    else {
+        if (static_cast<int>(topology.size()) != num_ranks) {
+            throw std::runtime_error("The topology contains " + std::to_string(topology.size()) + " positions but "
+                                        + std::to_string(num_ranks) + " ranks are used");
+        }
+        // Place the ranks with a given node-local index first, so the remaining ranks can fill the gaps
+        std::vector<std::string> unassigned_hosts(num_ranks);
+        for (int p = 0; p < num_ranks; p++) {
+            const std::string &entry = topology[p];
+            size_t sep = entry.rfind(':');
+            bool has_index = sep != std::string::npos && sep + 1 < entry.size()
+                                && entry.find_first_not_of("0123456789", sep + 1) == std::string::npos;
+            std::string host = has_index ? entry.substr(0, sep) : entry;
+            auto ranks = host_ranks.find(host);
+            if (ranks == host_ranks.end()) {
+                throw std::runtime_error("No rank is executed on host " + host + " given in the topology");
+            }
+            if (!has_index) {
+                unassigned_hosts[p] = host;
+                continue;
+            }
+            size_t local_index = std::stoul(entry.substr(sep + 1));
+            if (local_index >= ranks->second.size()) {
+                throw std::runtime_error("Only " + std::to_string(ranks->second.size()) + " ranks are executed on host " + host
+                                            + " but topology contains " + entry);
+            }
+            int r = ranks->second[local_index];
+            if (positions[r] >= 0) {
+                throw std::runtime_error("Rank " + entry + " is placed multiple times in the topology");
+            }
+            positions[r] = p;
+        }
+        for (int p = 0; p < num_ranks; p++) {
+            if (unassigned_hosts[p].empty()) {
+                continue;
+            }
+            const auto &ranks = host_ranks[unassigned_hosts[p]];
+            auto r = std::find_if(ranks.begin(), ranks.end(), [&positions](int rank) {return positions[rank] < 0;});
+            if (r == ranks.end()) {
+                throw std::runtime_error("The topology contains more positions for host " + unassigned_hosts[p]
+                                            + " than ranks are executed on it");
+            }
+            positions[*r] = p;
+        }
+    }
+
+    // Shift the torus in both dimensions so rank 0 is at position 0.
+    // Rank 0 collects the results, so it also has to be the root rank of the torus.
+    int row_shift = positions[0] / torus_width;
+    int col_shift = positions[0] % torus_width;
+    for (auto &p : positions) {
+        int row = (p / torus_width - row_shift + torus_width) % torus_width;
+        int col = (p % torus_width - col_shift + torus_width) % torus_width;
+        p = row * torus_width + col;
+    }
+    return positions;
+}
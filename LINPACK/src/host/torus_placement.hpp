@@ -0,0 +1,79 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef SRC_HOST_TORUS_PLACEMENT_H_
+#define SRC_HOST_TORUS_PLACEMENT_H_
+
+/* C++ standard library headers */
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace linpack {
+
+/**
+ * @brief Contains the functions that map the MPI ranks to positions in the 2D torus
+ *
+ */
+namespace placement {
+
+/**
+ * @brief Parse a topology description. The description contains one entry per torus position in row-major order.
+ *          Entries are separated by white spaces or new lines, so every line can describe a row of the torus.
+ *          An entry is either a host name or a host name followed by the node-local index of the rank e.g. node01:1.
+ *          Everything after a # is ignored until the end of the line.
+ *
+ * @param in The stream that contains the topology description
+ * @return std::vector<std::string> The entries of the torus positions in row-major order
+ */
+std::vector<std::string>
+parseTopology(std::istream &in);
+
+/**
+ * @brief Read the topology description from a file
+ *
+ * @param file_name Path to the topology file
+ * @return std::vector<std::string> The entries of the torus positions in row-major order
+ */
+std::vector<std::string>
+readTopologyFile(const std::string &file_name);
+
+/**
+ * @brief Calculate the position of every MPI rank in the torus.
+ *          If no topology is given, the ranks of the same node are placed next to each other in the torus rows,
+ *          so the communication within a row stays within a node.
+ *          Otherwise, the ranks are placed as given by the topology. Ranks of a host without a node-local index
+ *          in the topology are assigned in the order of their MPI rank.
+ *          The torus is shifted cyclically so that rank 0 is at position 0. This keeps the neighbours of all ranks.
+ *
+ * @param rank_hosts The host name of every MPI rank
+ * @param topology The entries of the torus positions in row-major order. May be empty
+ * @param torus_width The width of the torus in number of ranks
+ * @return std::vector<int> The position of every MPI rank in the torus calculated as row * torus_width + col
+ */
+std::vector<int>
+calculateTorusPositions(const std::vector<std::string> &rank_hosts, const std::vector<std::string> &topology, int torus_width);
+
+} // namespace placement
+} // namespace linpack
+
+#endif // SRC_HOST_TORUS_PLACEMENT_H_
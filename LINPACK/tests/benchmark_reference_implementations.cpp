@@ -0,0 +1,89 @@
+/*
+Microbenchmarks of the host reference implementations of LINPACK that are used for the validation.
+The benchmarks are executed for multiple matrix sizes and numbers of OpenMP threads.
+*/
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "reference_benchmark.hpp"
+#include "linpack_benchmark.hpp"
+#include "parameters.h"
+
+/**
+Generate a diagonally dominant matrix, so the LU decomposition is stable with and without pivoting
+
+@param n Width and height of the matrix
+@return The matrix in row-major order
+*/
+static std::vector<HOST_DATA_TYPE>
+generateMatrix(unsigned n) {
+    std::vector<HOST_DATA_TYPE> a(n * n);
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<HOST_DATA_TYPE> dis(-1.0, 1.0);
+    for (unsigned i = 0; i < n; i++) {
+        for (unsigned j = 0; j < n; j++) {
+            a[i * n + j] = dis(gen);
+        }
+        a[i * n + i] += static_cast<HOST_DATA_TYPE>(n);
+    }
+    return a;
+}
+
+static void
+BM_gefa_ref(benchmark::State &state) {
+    reference_benchmark::setThreads(state);
+    unsigned n = static_cast<unsigned>(state.range(0));
+    auto matrix = generateMatrix(n);
+    std::vector<HOST_DATA_TYPE> a(matrix.size());
+    std::vector<cl_int> ipvt(n);
+    for (auto _ : state) {
+        // The decomposition is calculated in place, so the input is restored before every iteration
+        state.PauseTiming();
+        std::copy(matrix.begin(), matrix.end(), a.begin());
+        state.ResumeTiming();
+        linpack::gefa_ref(a.data(), n, n, ipvt.data());
+        benchmark::DoNotOptimize(a.data());
+        benchmark::ClobberMemory();
+    }
+    state.counters["FLOP/s"] = benchmark::Counter(2.0 / 3.0 * n * n * n, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+static void
+BM_gesl_ref(benchmark::State &state) {
+    reference_benchmark::setThreads(state);
+    unsigned n = static_cast<unsigned>(state.range(0));
+    auto a = generateMatrix(n);
+    std::vector<cl_int> ipvt(n);
+    linpack::gefa_ref(a.data(), n, n, ipvt.data());
+    std::vector<HOST_DATA_TYPE> rhs(n, 1.0);
+    std::vector<HOST_DATA_TYPE> b(n);
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::copy(rhs.begin(), rhs.end(), b.begin());
+        state.ResumeTiming();
+        linpack::gesl_ref(a.data(), b.data(), ipvt.data(), n, n);
+        benchmark::DoNotOptimize(b.data());
+        benchmark::ClobberMemory();
+    }
+    state.counters["FLOP/s"] = benchmark::Counter(2.0 * n * n, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+static void
+BM_dmxpy(benchmark::State &state) {
+    reference_benchmark::setThreads(state);
+    unsigned n = static_cast<unsigned>(state.range(0));
+    auto m = generateMatrix(n);
+    std::vector<HOST_DATA_TYPE> x(n, 1.0);
+    std::vector<HOST_DATA_TYPE> y(n, 0.0);
+    for (auto _ : state) {
+        linpack::dmxpy(n, y.data(), n, n, x.data(), m.data(), false);
+        benchmark::DoNotOptimize(y.data());
+        benchmark::ClobberMemory();
+    }
+    state.counters["FLOP/s"] = benchmark::Counter(2.0 * n * n, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+REFERENCE_BENCHMARK(BM_gefa_ref, 256, 512, 1024, 2048);
+REFERENCE_BENCHMARK(BM_gesl_ref, 256, 512, 1024, 2048, 4096);
+REFERENCE_BENCHMARK(BM_dmxpy, 256, 512, 1024, 2048, 4096);
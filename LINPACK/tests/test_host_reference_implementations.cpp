@@ -87,6 +87,15 @@ TEST_F(LinpackHostTest, ReferenceSolveWithPivoting) {
 }
 
 
+TEST_F(LinpackHostTest, ReferenceSolveWithBlockPivoting) {
+    bm->getExecutionSettings().programSettings->isDiagonallyDominant = false;
+    data = bm->generateInputData();
+    linpack::gefa_ref_block_pvt(data->A, array_size, array_size, bm->getExecutionSettings().programSettings->blockSize, data->ipvt);
+    linpack::gesl_ref_block_pvt(data->A, data->b, data->ipvt, array_size, array_size);
+    EXPECT_TRUE(bm->validateOutputAndPrintError(*data));
+}
+
+
 TEST_F(LinpackHostTest, ReferenceSolveWithoutPivoting) {
     data = bm->generateInputData();
     linpack::gefa_ref_nopvt(data->A, array_size, array_size);
@@ -95,3 +104,26 @@ TEST_F(LinpackHostTest, ReferenceSolveWithoutPivoting) {
 }
 
 
+
+TEST_F(LinpackHostTest, RefinementReducesResidualOfReferenceSolve) {
+    data = bm->generateInputData();
+    std::vector<HOST_DATA_TYPE> A(data->A, data->A + array_size * array_size);
+    std::vector<HOST_DATA_TYPE> b(data->b, data->b + array_size);
+    linpack::gefa_ref_nopvt(data->A, array_size, array_size);
+    linpack::gesl_ref_nopvt(data->A, data->b, array_size, array_size);
+    std::vector<double> x(data->b, data->b + array_size);
+    linpack::refine_nopvt_ref(A.data(), data->A, b.data(), x.data(), array_size, array_size);
+    double resid = 0.0;
+    double refined_resid = 0.0;
+    for (int i=0; i < array_size; i++) {
+        double r = b[i];
+        double refined_r = b[i];
+        for (int j=0; j < array_size; j++) {
+            r -= static_cast<double>(A[array_size * j + i]) * data->b[j];
+            refined_r -= static_cast<double>(A[array_size * j + i]) * x[j];
+        }
+        resid = std::max(resid, std::abs(r));
+        refined_resid = std::max(refined_resid, std::abs(refined_r));
+    }
+    EXPECT_LT(refined_resid, resid * 1.0e-3);
+}
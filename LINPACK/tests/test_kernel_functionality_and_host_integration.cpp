@@ -46,6 +46,31 @@ TEST_P(LinpackKernelTest, FPGACorrectResultsOneRepetition) {
     }
 }
 
+/**
+ * All right-hand sides are solved with the factorized matrix
+ */
+TEST_P(LinpackKernelTest, FPGACorrectResultsMultipleRightHandSides) {
+    bm->getExecutionSettings().programSettings->nrhs = 3;
+    data = bm->generateInputData();
+    auto result = bm->executeKernel(*data);
+    for (int r = 0; r < 3; r++) {
+        for (int i = 0; i < array_size; i++) {
+            EXPECT_NEAR(data->b[r * array_size + i], r + 1.0, 1.0e-3 * (r + 1));
+        }
+    }
+    EXPECT_TRUE(bm->validateOutputAndPrintError(*data));
+}
+
+/**
+ * The mixed precision mode refines the solution to double precision accuracy with both validation schemes
+ */
+TEST_P(LinpackKernelTest, CPUMixedPrecisionIsRefined) {
+    bm->getExecutionSettings().programSettings->communicationType = hpcc_base::CommunicationType::cpu_only;
+    bm->getExecutionSettings().programSettings->isMixedPrecision = true;
+    auto result = bm->executeKernel(*data);
+    EXPECT_TRUE(bm->validateOutputAndPrintError(*data));
+}
+
 /**
  * GEFA Execution returns correct results for a single repetition
  */
@@ -72,6 +97,27 @@ TEST_P(LinpackKernelTest, DISABLED_FPGACorrectResultsGEFA) {
     EXPECT_EQ(0, errors);
 }
 
+/**
+ * The CPU backend calculates the same LU factorization as the reference implementation and passes the validation
+ */
+TEST_P(LinpackKernelTest, CPUCorrectResultsGEFA) {
+    bm->getExecutionSettings().programSettings->communicationType = hpcc_base::CommunicationType::cpu_only;
+    bm->getExecutionSettings().programSettings->numRepetitions = 2;
+    auto result = bm->executeKernel(*data);
+    EXPECT_EQ(2, result->gefaTimings.size());
+    auto data2 = bm->generateInputData();
+#ifdef USE_PIVOTING
+    std::vector<cl_int> ipvt(array_size);
+    linpack::gefa_ref_block_pvt(data2->A, array_size, array_size, bm->getExecutionSettings().programSettings->blockSize, ipvt.data());
+#else
+    linpack::gefa_ref_nopvt(data2->A, array_size, array_size);
+#endif
+    for (int i = 0; i < array_size * array_size; i++) {
+        EXPECT_NEAR(data->A[i], data2->A[i], 1.0e-3);
+    }
+    EXPECT_TRUE(bm->validateOutputAndPrintError(*data));
+}
+
 #ifdef _LAPACK_
 /**
  * Execution returns correct results for a single repetition
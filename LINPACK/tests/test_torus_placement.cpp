@@ -0,0 +1,48 @@
+
+#include <sstream>
+
+#include "gtest/gtest.h"
+#include "torus_placement.hpp"
+
+
+TEST(TorusPlacementTest, TopologyIsParsedInRowMajorOrder) {
+    std::stringstream ss("# 2x2 torus\nnode01:0 node01:1\nnode02 # second row\n  node03\n");
+    auto topology = linpack::placement::parseTopology(ss);
+    std::vector<std::string> expected = {"node01:0", "node01:1", "node02", "node03"};
+    EXPECT_EQ(topology, expected);
+}
+
+TEST(TorusPlacementTest, RanksOfSameNodeArePlacedInSameRow) {
+    // Ranks are distributed round-robin over two nodes
+    std::vector<std::string> hosts = {"node01", "node02", "node01", "node02"};
+    auto positions = linpack::placement::calculateTorusPositions(hosts, {}, 2);
+    std::vector<int> expected = {0, 2, 1, 3};
+    EXPECT_EQ(positions, expected);
+}
+
+TEST(TorusPlacementTest, RanksArePlacedAsGivenInTopology) {
+    std::vector<std::string> hosts = {"node01", "node01", "node02", "node02"};
+    auto positions = linpack::placement::calculateTorusPositions(hosts, {"node01:0", "node02:1", "node01", "node02"}, 2);
+    std::vector<int> expected = {0, 2, 3, 1};
+    EXPECT_EQ(positions, expected);
+}
+
+TEST(TorusPlacementTest, TorusIsShiftedToPlaceRankZeroAtOrigin) {
+    std::vector<std::string> hosts = {"node01", "node02", "node03", "node04"};
+    auto positions = linpack::placement::calculateTorusPositions(hosts, {"node04", "node03", "node02", "node01"}, 2);
+    // Rank 0 is moved from (1,1) to (0,0). All other ranks keep their neighbours
+    std::vector<int> expected = {0, 1, 2, 3};
+    EXPECT_EQ(positions, expected);
+}
+
+TEST(TorusPlacementTest, InvalidTopologyIsRejected) {
+    std::vector<std::string> hosts = {"node01", "node01", "node02", "node02"};
+    // Wrong number of positions
+    EXPECT_THROW(linpack::placement::calculateTorusPositions(hosts, {"node01", "node01", "node02"}, 2), std::runtime_error);
+    // Unknown host
+    EXPECT_THROW(linpack::placement::calculateTorusPositions(hosts, {"node01", "node01", "node02", "node03"}, 2), std::runtime_error);
+    // Rank placed twice
+    EXPECT_THROW(linpack::placement::calculateTorusPositions(hosts, {"node01:1", "node01:1", "node02", "node02"}, 2), std::runtime_error);
+    // More positions than ranks on a host
+    EXPECT_THROW(linpack::placement::calculateTorusPositions(hosts, {"node01", "node01", "node01", "node02"}, 2), std::runtime_error);
+}
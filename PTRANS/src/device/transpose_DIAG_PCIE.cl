@@ -138,15 +138,17 @@ store_a(__global DEVICE_DATA_TYPE *restrict A_out,
  * A -> trans(A) -> ext. ch
  *
  * @param A Buffer for matrix A
- * @param B Buffer for matrix B
- * @param A_out Buffer for result matrix
+ * @param B Buffer for matrix B. It will contain the result, if USE_INPLACE_TRANSPOSE is defined.
+ * @param A_out Buffer for result matrix. Only available, if USE_INPLACE_TRANSPOSE is not defined.
  * @param number_of_blocks The number of blocks that will be processed starting from the block offset
  */
 __attribute__((max_global_work_dim(0)))
 __kernel
 void transpose/*PY_CODE_GEN i*/(__global DEVICE_DATA_TYPE *restrict A,
                                 __global DEVICE_DATA_TYPE *restrict B,
+#ifndef USE_INPLACE_TRANSPOSE
                                 __global DEVICE_DATA_TYPE *restrict A_out,
+#endif
             const uint number_of_blocks) {
 
     // local memory double buffer for a matrix block
@@ -166,7 +168,12 @@ void transpose/*PY_CODE_GEN i*/(__global DEVICE_DATA_TYPE *restrict A,
                 // read transposed block of A from local memory buffer and add B from global memory to it
                 case 1: add_a_and_b(B, a_block, a_plus_b_block, block, current_chunk); break;
                 // Store result in global memory
+#ifdef USE_INPLACE_TRANSPOSE
+                // The block of B was completely read in the previous step, so it can be overwritten
+                case 2: store_a(B, a_plus_b_block, block, current_chunk); break;
+#else
                 case 2: store_a(A_out, a_plus_b_block, block, current_chunk); break;
+#endif
             }
         }
     }
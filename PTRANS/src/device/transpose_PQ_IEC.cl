@@ -164,15 +164,17 @@ void transpose_read/*PY_CODE_GEN i*/(__global DEVICE_DATA_TYPE *restrict A,
  *
  * where A_out, ext. ch and B are matrices of size matrixSize*matrixSize
  *
- * @param B Buffer for matrix B
- * @param A_out Output buffer for result matrix
+ * @param B Buffer for matrix B. It will contain the result, if USE_INPLACE_TRANSPOSE is defined.
+ * @param A_out Output buffer for result matrix. Only available, if USE_INPLACE_TRANSPOSE is not defined.
  * @param block_offset The first block that will be processed in the provided buffer
  * @param number_of_blocks The number of blocks that will be processed starting from the block offset
  */
 __attribute__((max_global_work_dim(0)))
 __kernel
 void transpose_write/*PY_CODE_GEN i*/(__global DEVICE_DATA_TYPE *restrict B,
+#ifndef USE_INPLACE_TRANSPOSE
             __global DEVICE_DATA_TYPE *restrict A_out,
+#endif
             const ulong offset,
             const ulong width_in_blocks,
             const ulong number_of_blocks) {
@@ -195,7 +197,12 @@ __attribute__((opencl_unroll_hint(CHANNEL_WIDTH)))
                                         block_col * BLOCK_SIZE +
                                         row * BLOCK_SIZE * width_in_blocks + 
                                         col * CHANNEL_WIDTH + unroll_count;
+#ifdef USE_INPLACE_TRANSPOSE
+                    // Every value of B is read before the result is written to the same address
+                    B[ls_address] = data.data[unroll_count] + B[ls_address];
+#else
                     A_out[ls_address] = data.data[unroll_count] + B[ls_address];
+#endif
                 }
             }
         }
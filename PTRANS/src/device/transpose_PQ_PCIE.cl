@@ -19,8 +19,8 @@
  * A -> trans(A) -> ext. ch
  *
  * @param A Buffer for matrix A
- * @param B Buffer for matrix B
- * @param A_out Buffer for result matrix
+ * @param B Buffer for matrix B. It will contain the result, if USE_INPLACE_TRANSPOSE is defined.
+ * @param A_out Buffer for result matrix. Only available, if USE_INPLACE_TRANSPOSE is not defined.
  * @param offset Offset in blocks that is used to read the current block of A. Since A is read column-wise
                 on the block level, the whole matrix A might be written to global memory and the relevant columns
                 need to be picked using this offset.
@@ -32,7 +32,9 @@ __attribute__((max_global_work_dim(0)))
 __kernel
 void transpose/*PY_CODE_GEN i*/(__global DEVICE_DATA_TYPE *restrict A,
                                 __global DEVICE_DATA_TYPE *restrict B,
+#ifndef USE_INPLACE_TRANSPOSE
                                 __global DEVICE_DATA_TYPE *restrict A_out,
+#endif
             const uint offset,
             const uint number_of_blocks,
             const uint width_in_blocks,
@@ -175,7 +177,12 @@ void transpose/*PY_CODE_GEN i*/(__global DEVICE_DATA_TYPE *restrict A,
 
                 __attribute__((opencl_unroll_hint(CHANNEL_WIDTH)))
                 for (unsigned unroll_count = 0; unroll_count < CHANNEL_WIDTH; unroll_count++) {
+#ifdef USE_INPLACE_TRANSPOSE
+                    // The block of B was completely read into a_plus_b_block, so it can be overwritten
+                    B[ls_address_row + col * CHANNEL_WIDTH + unroll_count] = a_plus_b_block[chunk][unroll_count];
+#else
                     A_out[ls_address_row + col * CHANNEL_WIDTH + unroll_count] = a_plus_b_block[chunk][unroll_count];
+#endif
                 }
             }
         }
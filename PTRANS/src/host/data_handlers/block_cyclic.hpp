@@ -0,0 +1,64 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef SRC_HOST_TRANSPOSE_HANDLERS_BLOCK_CYCLIC_HPP_
+#define SRC_HOST_TRANSPOSE_HANDLERS_BLOCK_CYCLIC_HPP_
+
+/* Project's headers */
+#include "pq.hpp"
+
+/**
+ * @brief Contains all classes and methods needed by the Transpose benchmark
+ * 
+ */
+namespace transpose {
+namespace data_handler {
+
+/**
+ * @brief 2D block-cyclic distribution of the matrix like the ScaLAPACK layout.
+ *          The matrix is split into distribution blocks of cycle size x cycle size matrix blocks, which are distributed
+ *          cyclic over the P x Q grid. A cycle size of 1 is the distribution of the PQ handler.
+ *          Every rank still stores its blocks as a single row-major local matrix, so the same kernels and
+ *          execution types as for the PQ handler are used.
+ * 
+ */
+class DistributedBlockCyclicTransposeDataHandler : public DistributedPQTransposeDataHandler {
+
+public:
+
+    /**
+     * @brief Construct a new handler for a P x Q grid with the given cycle size
+     * 
+     * @param mpi_rank Rank of this process
+     * @param mpi_size Number of MPI ranks
+     * @param cycle_size Number of matrix blocks in one dimension of a distribution block
+     * @param communicator Communicator that is used for the data exchange
+     */
+    DistributedBlockCyclicTransposeDataHandler(int mpi_rank, int mpi_size, int cycle_size, MPI_Comm communicator = MPI_COMM_WORLD) :
+                                    DistributedPQTransposeDataHandler(mpi_rank, mpi_size, cycle_size, communicator) {}
+
+};
+
+}
+}
+
+#endif
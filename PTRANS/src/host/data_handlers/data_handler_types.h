@@ -46,6 +46,12 @@ typedef enum _DataHandlerType {
      */
     pq,
 
+    /**
+     * @brief 2D block-cyclic distribution of the matrix in a PQ grid with a configurable cycle size like in ScaLAPACK
+     * 
+     */
+    block_cyclic,
+
     /**
      * @brief Automatically detect distribution scheme from kernel file name
      * 
@@ -59,6 +65,7 @@ typedef enum _DataHandlerType {
 static const std::map<const std::string, DataHandlerType> comm_to_str_map{ 
     {"DIAG", DataHandlerType::diagonal}, 
     {"PQ", DataHandlerType::pq},
+    {"CYCLIC", DataHandlerType::block_cyclic},
     {"AUTO", DataHandlerType::automatic}
     };
 
@@ -25,10 +25,10 @@ SOFTWARE.
 
 /* C++ standard library headers */
 #include <memory>
-#include <random>
 
 /* Project's headers */
 #include "handler.hpp"
+#include "counter_rng.hpp"
 
 /**
  * @brief Contains all classes and methods needed by the Transpose benchmark
@@ -60,16 +60,30 @@ private:
      */
     MPI_Datatype data_block;
 
+protected:
+
+    /**
+     * @brief Split the matrix into a fixed number of segments, so received segments can already be processed
+     *          while the remaining segments are still in flight
+     * 
+     * @param data The data that will be exchanged
+     * @return size_t Number of blocks per segment
+     */
+    size_t
+    getBlocksPerExchangeSegment(TransposeData& data) override {
+        return (data.numBlocks + ASYNC_EXCHANGE_SEGMENTS - 1) / ASYNC_EXCHANGE_SEGMENTS;
+    }
+
 public:
 
     /**
-     * @brief Generate data for transposition based on the implemented distribution scheme
+     * @brief Allocate data for transposition based on the implemented distribution scheme
      * 
      * @param settings The execution settings that contain information about the data size
-     * @return std::unique_ptr<TransposeData> The generated data
+     * @return std::unique_ptr<TransposeData> The allocated data
      */
     std::unique_ptr<TransposeData>
-    generateData(hpcc_base::ExecutionSettings<transpose::TransposeProgramSettings>& settings) override {
+    allocateData(hpcc_base::ExecutionSettings<transpose::TransposeProgramSettings>& settings) override {
         MPI_Type_contiguous(settings.programSettings->blockSize * settings.programSettings->blockSize, MPI_FLOAT, &data_block);
         MPI_Type_commit(&data_block);
         
@@ -110,24 +124,39 @@ public:
             std::cout << "Blocks per rank:                    " << blocks_if_not_diagonal << std::endl;
             std::cout << "Loopback ranks for diagonal blocks: " << num_diagonal_ranks << std::endl;
         }
-        // Height of a matrix generated for a single memory bank on a single MPI rank
-        int data_height_per_rank = blocks_per_rank * settings.programSettings->blockSize;
-
     #ifndef NDEBUG
         std::cout << "Rank " << mpi_comm_rank << ": NumBlocks = " << blocks_per_rank << std::endl;
     #endif
         
         // Allocate memory for a single device and all its memory banks
-        auto d = std::unique_ptr<transpose::TransposeData>(new transpose::TransposeData(*settings.context, settings.programSettings->blockSize, blocks_per_rank));
+        return std::unique_ptr<transpose::TransposeData>(new transpose::TransposeData(*settings.context, settings.programSettings->blockSize, blocks_per_rank,
+                                                                                        getSharedMemoryComm(settings)));
+    }
 
-        // Fill the allocated memory with pseudo random values
-        std::mt19937 gen(mpi_comm_rank);
-        std::uniform_real_distribution<> dis(-100.0, 100.0);
+    /**
+     * @brief Generate data for transposition based on the implemented distribution scheme
+     * 
+     * @param settings The execution settings that contain information about the data size
+     * @return std::unique_ptr<TransposeData> The generated data
+     */
+    std::unique_ptr<TransposeData>
+    generateData(hpcc_base::ExecutionSettings<transpose::TransposeProgramSettings>& settings) override {
+        auto d = allocateData(settings);
+
+        // Height of a matrix generated for a single memory bank on a single MPI rank
+        size_t data_height_per_rank = d->numBlocks * settings.programSettings->blockSize;
+
+        // Fill the allocated memory with pseudo random values.
+        // They only depend on the rank and the position in the local matrix, so the rows can be filled in parallel
+        const uint64_t seed = 0;
+        const uint64_t stream = 2 * static_cast<uint64_t>(mpi_comm_rank);
+#pragma omp parallel for
         for (size_t i = 0; i < data_height_per_rank; i++) {
             for (size_t j = 0; j < settings.programSettings->blockSize; j++) {
-                d->A[i * settings.programSettings->blockSize + j] = dis(gen);
-                d->B[i * settings.programSettings->blockSize + j] = dis(gen);
-                d->result[i * settings.programSettings->blockSize + j] = 0.0;
+                size_t index = i * settings.programSettings->blockSize + j;
+                d->A[index] = rng::uniform(seed, stream, index, -100.0, 100.0);
+                d->B[index] = rng::uniform(seed, stream + 1, index, -100.0, 100.0);
+                d->result[index] = 0.0;
             }
         }
         
@@ -146,11 +175,18 @@ public:
     #ifndef NDEBUG
         // std::cout << "Start data exchange " << mpi_comm_rank << std::endl;
     #endif
+        int pair_rank = getExchangePartner();
+        if (data.exchangeBlocks < data.numBlocks) {
+            // The exchange buffer can not hold the whole matrix
+            exchangeDataInRing(data, pair_rank);
+            return;
+        }
+        if (pair_rank >= 0 && data.isSharedWith(pair_rank)) {
+            exchangeDataShared(data, pair_rank);
+            return;
+        }
         // Only need to exchange data, if rank has a partner
-        if (mpi_comm_rank < mpi_comm_size - num_diagonal_ranks) {
-
-            int first_upper_half_rank = (mpi_comm_size - num_diagonal_ranks)/2;
-            int pair_rank = (mpi_comm_rank >= first_upper_half_rank) ? mpi_comm_rank - first_upper_half_rank : mpi_comm_rank + first_upper_half_rank;
+        if (pair_rank >= 0) {
 
             // To re-calculate the matrix transposition locally on this host, we need to 
             // exchange matrix A for every kernel replication
@@ -167,7 +203,7 @@ public:
             size_t offset = 0;
             while (remaining_data_size > 0) {
                 int next_chunk = (remaining_data_size > std::numeric_limits<int>::max()) ? std::numeric_limits<int>::max(): remaining_data_size;
-                MPI_Sendrecv(&data.A[offset], next_chunk, data_block, pair_rank, 0, &data.exchange[offset], next_chunk, data_block, pair_rank, 0, MPI_COMM_WORLD, &status);
+                MPI_Sendrecv(&data.A[offset], next_chunk, data_block, pair_rank, 0, &data.exchange[offset], next_chunk, data_block, pair_rank, 0, communicator, &status);
 
                 remaining_data_size -= next_chunk;
                 offset += static_cast<size_t>(next_chunk) * static_cast<size_t>(data.blockSize * data.blockSize);
@@ -183,20 +219,24 @@ public:
     #endif
     }
 
+    int
+    getExchangePartner() override {
+        if (mpi_comm_rank >= mpi_comm_size - num_diagonal_ranks) {
+            // Diagonal ranks do not need to exchange data
+            return -1;
+        }
+        int first_upper_half_rank = (mpi_comm_size - num_diagonal_ranks)/2;
+        return (mpi_comm_rank >= first_upper_half_rank) ? mpi_comm_rank - first_upper_half_rank : mpi_comm_rank + first_upper_half_rank;
+    }
+
     void 
     reference_transpose(TransposeData& data) {
-        size_t block_offset = data.blockSize * data.blockSize;
-        for (size_t b = 0; b < data.numBlocks; b++) {
-            for (size_t i = 0; i < data.blockSize; i++) {
-                for (size_t j = 0; j < data.blockSize; j++) {
-                    data.A[b * block_offset + j * data.blockSize + i] -= (data.result[b * block_offset + i * data.blockSize + j] 
-                                                                                - data.B[b * block_offset + i * data.blockSize + j]);
-                }
-            }
-        }
+        // Every block is transposed independently
+        transposeAndSubtract(data.A, data.B, data.result, data.blockSize, data.numBlocks);
     }
 
-    DistributedDiagonalTransposeDataHandler(int mpi_rank, int mpi_size): TransposeDataHandler(mpi_rank, mpi_size) {
+    DistributedDiagonalTransposeDataHandler(int mpi_rank, int mpi_size, MPI_Comm communicator = MPI_COMM_WORLD):
+                                                    TransposeDataHandler(mpi_rank, mpi_size, communicator) {
         if (mpi_rank >= mpi_size) {
             throw std::runtime_error("MPI rank must be smaller the MPI world size!");
         }
@@ -25,6 +25,13 @@ SOFTWARE.
 
 /* C++ standard library headers */
 #include <memory>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+
+/* External library headers */
+#include "mpi.h"
 
 /* Project's headers */
 #include "../transpose_data.hpp"
@@ -35,6 +42,105 @@ SOFTWARE.
  */
 namespace transpose {
 namespace data_handler {
+
+/**
+ * @brief Maximum number of segments the exchange buffer is split into by exchangeDataInRing()
+ * 
+ */
+const size_t EXCHANGE_RING_SLOTS = 4;
+
+/**
+ * @brief Number of segments the matrix is split into by the asynchronous exchange, if the data distribution has no natural segment size
+ * 
+ */
+const size_t ASYNC_EXCHANGE_SEGMENTS = 8;
+
+/**
+ * @brief Width of the square tiles used by transposeAndSubtract()
+ * 
+ */
+const size_t REFERENCE_TILE_WIDTH = 32;
+
+/**
+ * @brief Calculate A = A - (result - B)^T for one or more matrices stored consecutively in row-major order.
+ *          The matrices are processed in tiles that are transposed in a small local buffer, so the accesses to the
+ *          matrices are contiguous and the tile stays in the cache. The tiles are distributed over the OpenMP threads.
+ * 
+ * @param a The matrices A that will be overwritten with the result. They have the transposed shape of B.
+ * @param b The matrices B
+ * @param result The matrices calculated by the kernel
+ * @param height Height of a single matrix B
+ * @param width Width of a single matrix B
+ * @param count Number of matrices that are transposed independently
+ */
+inline void
+transposeAndSubtract(HOST_DATA_TYPE* a, const HOST_DATA_TYPE* b, const HOST_DATA_TYPE* result, size_t height, size_t width, size_t count) {
+    const size_t row_tiles = (height + REFERENCE_TILE_WIDTH - 1) / REFERENCE_TILE_WIDTH;
+    const size_t col_tiles = (width + REFERENCE_TILE_WIDTH - 1) / REFERENCE_TILE_WIDTH;
+    const size_t matrix_size = height * width;
+#pragma omp parallel for collapse(3) schedule(static)
+    for (size_t m = 0; m < count; m++) {
+        for (size_t ti = 0; ti < row_tiles; ti++) {
+            for (size_t tj = 0; tj < col_tiles; tj++) {
+                HOST_DATA_TYPE tile[REFERENCE_TILE_WIDTH * REFERENCE_TILE_WIDTH];
+                HOST_DATA_TYPE* a_m = a + m * matrix_size;
+                const HOST_DATA_TYPE* b_m = b + m * matrix_size;
+                const HOST_DATA_TYPE* result_m = result + m * matrix_size;
+                const size_t i0 = ti * REFERENCE_TILE_WIDTH;
+                const size_t j0 = tj * REFERENCE_TILE_WIDTH;
+                const size_t i_size = std::min(REFERENCE_TILE_WIDTH, height - i0);
+                const size_t j_size = std::min(REFERENCE_TILE_WIDTH, width - j0);
+                for (size_t i = 0; i < i_size; i++) {
+                    for (size_t j = 0; j < j_size; j++) {
+                        tile[j * REFERENCE_TILE_WIDTH + i] = result_m[(i0 + i) * width + j0 + j] - b_m[(i0 + i) * width + j0 + j];
+                    }
+                }
+                for (size_t j = 0; j < j_size; j++) {
+                    HOST_DATA_TYPE* a_row = a_m + (j0 + j) * height + i0;
+#pragma omp simd
+                    for (size_t i = 0; i < i_size; i++) {
+                        a_row[i] -= tile[j * REFERENCE_TILE_WIDTH + i];
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Calculate A = A - (result - B)^T for one or more square matrices stored consecutively in row-major order.
+ * 
+ * @param a The matrices A that will be overwritten with the result
+ * @param b The matrices B
+ * @param result The matrices calculated by the kernel
+ * @param width Width of a single matrix
+ * @param count Number of matrices that are transposed independently
+ */
+inline void
+transposeAndSubtract(HOST_DATA_TYPE* a, const HOST_DATA_TYPE* b, const HOST_DATA_TYPE* result, size_t width, size_t count) {
+    transposeAndSubtract(a, b, result, width, width, count);
+}
+
+/**
+ * @brief A contiguous part of the local matrix A that is exchanged as a single message
+ *          in the asynchronous data exchange
+ * 
+ */
+struct ExchangeSegment {
+
+    /**
+     * @brief Offset of the first value of the segment in the matrix
+     * 
+     */
+    size_t offset;
+
+    /**
+     * @brief Number of values in the segment
+     * 
+     */
+    size_t size;
+};
+
 /**
  * @brief The parallel matrix transposition is designed to support different kinds of data distribution.
  *          This abstract class provides the necessary methods that need to be implemented for every data distribution scheme.
@@ -45,8 +151,139 @@ namespace data_handler {
  */
 class TransposeDataHandler {
 
+private:
+
+    /**
+     * @brief Rank the data is exchanged with in the currently active asynchronous exchange
+     * 
+     */
+    int async_partner = -1;
+
+    /**
+     * @brief Segments of the currently active asynchronous exchange
+     * 
+     */
+    std::vector<ExchangeSegment> async_segments;
+
+    /**
+     * @brief Receive requests for every segment of the currently active asynchronous exchange
+     * 
+     */
+    std::vector<MPI_Request> async_recv_requests;
+
+    /**
+     * @brief Send requests for every segment of the currently active asynchronous exchange
+     * 
+     */
+    std::vector<MPI_Request> async_send_requests;
+
+    /**
+     * @brief Indices of the segments that were received but not yet reported by pollExchangeData()
+     * 
+     */
+    std::vector<int> async_unreported;
+
+    /**
+     * @brief Number of segments of the currently active asynchronous exchange that were reported as received by MPI
+     * 
+     */
+    size_t async_received = 0;
+
+    /**
+     * @brief True, if the currently active asynchronous exchange directly accesses the matrix of the partner in shared memory
+     * 
+     */
+    bool async_shared = false;
+
 protected:
 
+    /**
+     * @brief Get the number of matrix blocks that are exchanged in a single segment by the asynchronous exchange.
+     *          The default implementation exchanges the whole matrix in a single segment.
+     * 
+     * @param data The data that will be exchanged
+     * @return size_t Number of blocks per segment
+     */
+    virtual size_t
+    getBlocksPerExchangeSegment(TransposeData& data) {
+        return data.numBlocks;
+    }
+
+    /**
+     * @brief Swap the local matrix A with the partner rank using the exchange buffer as a ring of segments.
+     *          This is used if the exchange buffer is smaller than the matrix, like for USE_INPLACE_TRANSPOSE.
+     *          A received segment is copied to A as soon as the segment of A at the same position was sent.
+     *          Afterwards, data.A contains the matrix of the partner like after exchangeData().
+     * 
+     * @param data The data that will be exchanged
+     * @param partner The rank the data is exchanged with. No data is exchanged, if it is negative.
+     */
+    void
+    exchangeDataInRing(TransposeData& data, int partner) {
+        if (partner < 0 || data.numBlocks == 0) {
+            return;
+        }
+        if (data.isSharedWith(partner)) {
+            // No exchange buffer is required, if the matrix of the partner can be used directly
+            exchangeDataShared(data, partner);
+            return;
+        }
+        size_t block_values = static_cast<size_t>(data.blockSize) * data.blockSize;
+        size_t total_values = block_values * data.numBlocks;
+        size_t slots = std::min(EXCHANGE_RING_SLOTS, data.exchangeBlocks);
+        // Segments must not exceed the maximum message size of MPI
+        size_t slot_values = std::min(data.exchangeBlocks / slots * block_values, static_cast<size_t>(std::numeric_limits<int>::max()));
+        size_t segments = (total_values + slot_values - 1) / slot_values;
+        std::vector<MPI_Request> recv_requests(slots);
+        std::vector<MPI_Request> send_requests(slots);
+        // Messages between two ranks are not overtaking, so the segments are received in the order they are posted
+        auto post_segment = [&](size_t segment) {
+            size_t offset = segment * slot_values;
+            int size = std::min(slot_values, total_values - offset);
+            MPI_Irecv(&data.exchange[(segment % slots) * slot_values], size, MPI_FLOAT, partner, 0, communicator, &recv_requests[segment % slots]);
+            MPI_Isend(&data.A[offset], size, MPI_FLOAT, partner, 0, communicator, &send_requests[segment % slots]);
+        };
+        for (size_t segment = 0; segment < std::min(slots, segments); segment++) {
+            post_segment(segment);
+        }
+        for (size_t segment = 0; segment < segments; segment++) {
+            size_t offset = segment * slot_values;
+            MPI_Wait(&recv_requests[segment % slots], MPI_STATUS_IGNORE);
+            MPI_Wait(&send_requests[segment % slots], MPI_STATUS_IGNORE);
+            std::copy(&data.exchange[(segment % slots) * slot_values], &data.exchange[(segment % slots) * slot_values] + std::min(slot_values, total_values - offset), 
+                        &data.A[offset]);
+            if (segment + slots < segments) {
+                post_segment(segment + slots);
+            }
+        }
+    }
+
+    /**
+     * @brief Swap the local matrix A with a partner on the same node without copying it.
+     *          A is allocated in shared memory, so both ranks just use the matrix of the other rank afterwards.
+     *          Afterwards, data.A contains the matrix of the partner like after exchangeData().
+     * 
+     * @param data The data that will be exchanged. A has to be shared with the partner.
+     * @param partner The rank the data is exchanged with. It has to call this method at the same time.
+     */
+    void
+    exchangeDataShared(TransposeData& data, int partner) {
+        // Both ranks must have finished the modification of their matrices before they are swapped
+        data.sharedA->fence(partner, communicator);
+        data.A = data.getSharedA(partner);
+    }
+
+    /**
+     * @brief Get the communicator that is used to allocate the matrix A in shared memory
+     * 
+     * @param settings The execution settings
+     * @return MPI_Comm The communicator of the handler, if shared memory should be used. MPI_COMM_NULL otherwise.
+     */
+    MPI_Comm
+    getSharedMemoryComm(hpcc_base::ExecutionSettings<transpose::TransposeProgramSettings>& settings) {
+        return (settings.programSettings->useSharedMemory && mpi_comm_size > 1) ? communicator : MPI_COMM_NULL;
+    }
+
     /**
      * @brief Rank in the MPI communication world
      * 
@@ -59,6 +296,12 @@ protected:
      */
     int mpi_comm_size = 1;
 
+    /**
+     * @brief Communicator that is used for the data exchange. The rank and size are given for this communicator.
+     * 
+     */
+    MPI_Comm communicator = MPI_COMM_WORLD;
+
 public:
 
     /**
@@ -70,6 +313,16 @@ public:
     virtual std::unique_ptr<TransposeData>
     generateData(hpcc_base::ExecutionSettings<transpose::TransposeProgramSettings>& settings) = 0;
 
+    /**
+     * @brief Allocate the data for transposition based on the implemented distribution scheme without initializing it.
+     *          This also initializes the internal state of the handler like generateData().
+     * 
+     * @param settings The execution settings that contain information about the data size
+     * @return std::unique_ptr<TransposeData> The allocated data
+     */
+    virtual std::unique_ptr<TransposeData>
+    allocateData(hpcc_base::ExecutionSettings<transpose::TransposeProgramSettings>& settings) = 0;
+
     /**
      * @brief Exchange the data blocks for verification
      * 
@@ -82,11 +335,168 @@ public:
     virtual void
     reference_transpose(TransposeData& data) = 0;
 
+    /**
+     * @brief Get the MPI rank the local matrix A is exchanged with in exchangeData().
+     *          It can be used by execution types that implement their own data exchange
+     *          but the generateData() method has to be called before.
+     * 
+     * @return int The rank of the exchange partner or -1, if no exchange is required for this rank
+     */
+    virtual int
+    getExchangePartner() = 0;
+
+    /**
+     * @brief Check, if the data can be exchanged with beginExchangeData(). This requires a single exchange partner
+     *          and an exchange buffer for the whole matrix, if A is not shared with the partner.
+     * 
+     * @param data The data that will be exchanged
+     * @return true if the asynchronous exchange can be used
+     */
+    virtual bool
+    isAsynchronousExchangeSupported(TransposeData& data) {
+        int partner = getExchangePartner();
+        return partner < 0 || data.isSharedWith(partner) || data.exchangeBlocks >= data.numBlocks;
+    }
+
+    /**
+     * @brief Start the asynchronous exchange of the data blocks. The matrix is split into segments 
+     *          that are sent and received independently with non-blocking MPI calls. Received segments
+     *          are stored in the buffer returned by getReceiveBuffer() and can be used as soon as they are
+     *          reported by pollExchangeData(). data.A must not be modified until completeExchangeData() is called.
+     * 
+     * @param data The data that was generated locally and will be exchanged with other MPI ranks
+     */
+    virtual void
+    beginExchangeData(TransposeData& data) {
+        if (!async_recv_requests.empty()) {
+            throw std::runtime_error("Asynchronous data exchange is already active!");
+        }
+        async_partner = getExchangePartner();
+        if (async_partner >= 0 && !data.isSharedWith(async_partner) && data.exchangeBlocks < data.numBlocks) {
+            throw std::runtime_error("Asynchronous data exchange requires an exchange buffer for the whole matrix!");
+        }
+        async_segments.clear();
+        async_unreported.clear();
+        async_received = 0;
+        size_t block_values = static_cast<size_t>(data.blockSize) * data.blockSize;
+        size_t total_values = block_values * data.numBlocks;
+        // Segments must not exceed the maximum message size of MPI
+        size_t segment_values = std::max(static_cast<size_t>(1), std::min(getBlocksPerExchangeSegment(data),
+                                                static_cast<size_t>(std::numeric_limits<int>::max()) / block_values)) * block_values;
+        for (size_t offset = 0; offset < total_values; offset += segment_values) {
+            async_segments.push_back({offset, std::min(segment_values, total_values - offset)});
+        }
+        async_shared = async_partner >= 0 && data.isSharedWith(async_partner);
+        if (async_shared) {
+            // The matrix of the partner can be read directly as soon as the partner started the exchange
+            data.sharedA->fence(async_partner, communicator);
+        }
+        if (async_partner < 0 || async_shared) {
+            // Nothing to exchange, the local data or the data of the partner can be used directly
+            for (int i = 0; i < async_segments.size(); i++) {
+                async_unreported.push_back(i);
+            }
+            return;
+        }
+        async_recv_requests.resize(async_segments.size());
+        async_send_requests.resize(async_segments.size());
+        for (int i = 0; i < async_segments.size(); i++) {
+            MPI_Irecv(&data.exchange[async_segments[i].offset], async_segments[i].size, MPI_FLOAT, async_partner, i, communicator, &async_recv_requests[i]);
+        }
+        for (int i = 0; i < async_segments.size(); i++) {
+            MPI_Isend(&data.A[async_segments[i].offset], async_segments[i].size, MPI_FLOAT, async_partner, i, communicator, &async_send_requests[i]);
+        }
+    }
+
+    /**
+     * @brief Check for segments that were received since the last call in the active asynchronous exchange
+     * 
+     * @param received Indices of the segments that were received since the last call will be appended to this vector
+     * @return true if all segments are received
+     * @return false if there are still segments in flight
+     */
+    virtual bool
+    pollExchangeData(std::vector<int>& received) {
+        received.insert(received.end(), async_unreported.begin(), async_unreported.end());
+        async_unreported.clear();
+        if (async_recv_requests.empty()) {
+            return true;
+        }
+        std::vector<int> indices(async_recv_requests.size());
+        int count;
+        // MPI_Testsome sets completed requests to MPI_REQUEST_NULL, so every segment is only reported once
+        MPI_Testsome(async_recv_requests.size(), async_recv_requests.data(), &count, indices.data(), MPI_STATUSES_IGNORE);
+        if (count == MPI_UNDEFINED) {
+            // All requests are already completed
+            return true;
+        }
+        received.insert(received.end(), indices.begin(), indices.begin() + count);
+        async_received += count;
+        return async_received == async_recv_requests.size();
+    }
+
+    /**
+     * @brief Wait until the active asynchronous exchange is completed. 
+     *          Afterwards, the exchanged data will be stored in data.A like after a call to exchangeData().
+     * 
+     * @param data The data that was passed to beginExchangeData()
+     */
+    virtual void
+    completeExchangeData(TransposeData& data) {
+        async_unreported.clear();
+        if (async_shared) {
+            // The partner may still read the local matrix until it completes the exchange
+            exchangeDataShared(data, async_partner);
+            async_shared = false;
+            return;
+        }
+        if (async_recv_requests.empty()) {
+            return;
+        }
+        MPI_Waitall(async_recv_requests.size(), async_recv_requests.data(), MPI_STATUSES_IGNORE);
+        MPI_Waitall(async_send_requests.size(), async_send_requests.data(), MPI_STATUSES_IGNORE);
+        async_recv_requests.clear();
+        async_send_requests.clear();
+
+        // Exchange window pointers
+        HOST_DATA_TYPE* tmp = data.exchange;
+        data.exchange = data.A;
+        data.A = tmp;
+    }
+
+    /**
+     * @brief Get the segments the matrix is split into by the active asynchronous exchange
+     * 
+     * @return const std::vector<ExchangeSegment>& The segments in the order of their indices
+     */
+    const std::vector<ExchangeSegment>&
+    getExchangeSegments() const {
+        return async_segments;
+    }
+
+    /**
+     * @brief Get the buffer that contains the received segments during an active asynchronous exchange
+     * 
+     * @param data The data that was passed to beginExchangeData()
+     * @return HOST_DATA_TYPE* Pointer to the buffer. It is only valid until completeExchangeData() is called.
+     */
+    HOST_DATA_TYPE*
+    getReceiveBuffer(TransposeData& data) const {
+        if (async_shared) {
+            return data.getSharedA(async_partner);
+        }
+        return (async_partner < 0) ? data.A : data.exchange;
+    }
+
     /**
      * @brief Construct a new Transpose Data Handler object and initialize the MPI rank and MPI size variables if MPI is used
      * 
+     * @param mpi_comm_rank Rank of this process in the communicator
+     * @param mpi_comm_size Number of ranks in the communicator
+     * @param communicator Communicator that is used for the data exchange
      */
-    TransposeDataHandler(int mpi_comm_rank, int mpi_comm_size) : mpi_comm_rank(mpi_comm_rank), mpi_comm_size(mpi_comm_size) {}
+    TransposeDataHandler(int mpi_comm_rank, int mpi_comm_size, MPI_Comm communicator = MPI_COMM_WORLD) : mpi_comm_rank(mpi_comm_rank),
+                                                                    mpi_comm_size(mpi_comm_size), communicator(communicator) {}
 
 };
 
@@ -25,9 +25,13 @@ SOFTWARE.
 
 /* C++ standard library headers */
 #include <memory>
+#include <vector>
+#include <string>
+#include <cmath>
 
 /* Project's headers */
 #include "handler.hpp"
+#include "counter_rng.hpp"
 
 /**
  * @brief Contains all classes and methods needed by the Transpose benchmark
@@ -38,55 +42,250 @@ namespace data_handler {
 
 class DistributedPQTransposeDataHandler : public TransposeDataHandler {
 
+protected:
+
+    /**
+     * @brief Number of matrix blocks in one dimension that are assigned to the same rank before the distribution
+     *          continues with the next rank of the grid
+     * 
+     */
+    int cycle_size;
+
 private:
 
     /**
-     * @brief Number of diagonal ranks that will sent the blcoks to themselves
+     * @brief Width of the local matrix in blocks
      * 
      */
     int width_per_rank;
 
+    /**
+     * @brief Height of the local matrix in blocks
+     * 
+     */
+    int height_per_rank;
+
+    /**
+     * @brief Row of the rank in the P x Q grid
+     * 
+     */
     int pq_row;
 
+    /**
+     * @brief Column of the rank in the P x Q grid
+     * 
+     */
     int pq_col;
 
+    /**
+     * @brief Number of columns Q of the grid
+     * 
+     */
     int pq_width;
 
+    /**
+     * @brief Number of rows P of the grid
+     * 
+     */
+    int pq_height;
+
     MPI_Datatype data_block;
 
+    /**
+     * @brief Local indices of the blocks of A that are sent to every rank, if P != Q
+     * 
+     */
+    std::vector<std::vector<int>> send_blocks;
+
+    /**
+     * @brief Local indices of the blocks of the transposed layout that are received from every rank, if P != Q
+     * 
+     */
+    std::vector<std::vector<int>> recv_blocks;
+
+    /**
+     * @brief Data types that select the blocks in send_blocks for every rank
+     * 
+     */
+    std::vector<MPI_Datatype> send_types;
+
+    /**
+     * @brief Data types that select the blocks in recv_blocks for every rank
+     * 
+     */
+    std::vector<MPI_Datatype> recv_types;
+
+    /**
+     * @brief True, if A is currently stored in the transposed layout, i.e. exchangeData() was called an odd number of times
+     * 
+     */
+    bool transposed_layout = false;
+
+    /**
+     * @brief Create the exchange pattern for a rectangular grid.
+     *          Matrix blocks are distributed block-cyclic with the cycle size c, so the block (i,j) is stored on the rank in
+     *          grid row (i / c) mod P and grid column (j / c) mod Q.
+     *          The rank that calculates the block (j,i) of the result needs block (i,j) of A, which repeats with a period of c * LCM(P,Q) blocks
+     *          in both dimensions. Every rank exchanges blocks with (P / GCD(P,Q)) * (Q / GCD(P,Q)) ranks.
+     *          The received blocks are stored in a transposed layout with width height_per_rank, so the kernels can use the local
+     *          blocks like for P = Q.
+     * 
+     * @param width_in_blocks Width of the global matrix in blocks
+     * @param block_size Width of a single matrix block
+     */
+    void
+    createRectangularExchangePattern(int width_in_blocks, int block_size) {
+        for (auto& t : send_types) {
+            if (t != MPI_DATATYPE_NULL) {
+                MPI_Type_free(&t);
+            }
+        }
+        for (auto& t : recv_types) {
+            if (t != MPI_DATATYPE_NULL) {
+                MPI_Type_free(&t);
+            }
+        }
+        send_blocks.assign(mpi_comm_size, std::vector<int>());
+        recv_blocks.assign(mpi_comm_size, std::vector<int>());
+        send_types.assign(mpi_comm_size, MPI_DATATYPE_NULL);
+        recv_types.assign(mpi_comm_size, MPI_DATATYPE_NULL);
+        transposed_layout = false;
+        if (pq_height == pq_width) {
+            // The exchange with a single partner is used instead
+            return;
+        }
+        // Both sides iterate over the global blocks in the same order, so the blocks of a message match
+        for (int i = 0; i < width_in_blocks; i++) {
+            int owner_row = (i / cycle_size) % pq_height;
+            int target_col = (i / cycle_size) % pq_width;
+            if (owner_row != pq_row && target_col != pq_col) {
+                continue;
+            }
+            for (int j = 0; j < width_in_blocks; j++) {
+                int owner = owner_row * pq_width + (j / cycle_size) % pq_width;
+                int target = ((j / cycle_size) % pq_height) * pq_width + target_col;
+                if (owner == mpi_comm_rank) {
+                    send_blocks[target].push_back(localIndex(i, pq_height) * width_per_rank + localIndex(j, pq_width));
+                }
+                if (target == mpi_comm_rank) {
+                    recv_blocks[owner].push_back(localIndex(i, pq_width) * height_per_rank + localIndex(j, pq_height));
+                }
+            }
+        }
+        // The matrix blocks are stored strided in the row-major local matrices
+        MPI_Datatype local_block;
+        MPI_Datatype transposed_block;
+        MPI_Type_vector(block_size, block_size, width_per_rank * block_size, MPI_FLOAT, &local_block);
+        MPI_Type_vector(block_size, block_size, height_per_rank * block_size, MPI_FLOAT, &transposed_block);
+        std::vector<MPI_Aint> displacements;
+        for (int r = 0; r < mpi_comm_size; r++) {
+            if (!send_blocks[r].empty()) {
+                displacements.clear();
+                for (int b : send_blocks[r]) {
+                    displacements.push_back(static_cast<MPI_Aint>((static_cast<size_t>(b / width_per_rank) * width_per_rank * block_size 
+                                                + b % width_per_rank) * block_size * sizeof(HOST_DATA_TYPE)));
+                }
+                MPI_Type_create_hindexed_block(displacements.size(), 1, displacements.data(), local_block, &send_types[r]);
+                MPI_Type_commit(&send_types[r]);
+            }
+            if (!recv_blocks[r].empty()) {
+                displacements.clear();
+                for (int b : recv_blocks[r]) {
+                    displacements.push_back(static_cast<MPI_Aint>((static_cast<size_t>(b / height_per_rank) * height_per_rank * block_size 
+                                                + b % height_per_rank) * block_size * sizeof(HOST_DATA_TYPE)));
+                }
+                MPI_Type_create_hindexed_block(displacements.size(), 1, displacements.data(), transposed_block, &recv_types[r]);
+                MPI_Type_commit(&recv_types[r]);
+            }
+        }
+        MPI_Type_free(&local_block);
+        MPI_Type_free(&transposed_block);
+    }
+
+protected:
+
+    /**
+     * @brief Calculate the local index of a global block row or column
+     * 
+     * @param global_index Index of the block row or column in the global matrix
+     * @param grid_size Number of ranks in this dimension of the grid
+     * @return int The index of the block row or column in the local matrix
+     */
+    int
+    localIndex(int global_index, int grid_size) const {
+        return (global_index / (cycle_size * grid_size)) * cycle_size + global_index % cycle_size;
+    }
+
+    /**
+     * @brief Exchange the matrix in block rows, so received rows can already be processed
+     *          while the remaining rows are still in flight
+     * 
+     * @param data The data that will be exchanged
+     * @return size_t Number of blocks in a block row of the local matrix
+     */
+    size_t
+    getBlocksPerExchangeSegment(TransposeData& data) override {
+        return width_per_rank;
+    }
+
 public:
 
     /**
-     * @brief Generate data for transposition based on the implemented distribution scheme
+     * @brief Allocate data for transposition based on the implemented distribution scheme
      * 
      * @param settings The execution settings that contain information about the data size
-     * @return std::unique_ptr<TransposeData> The generated data
+     * @return std::unique_ptr<TransposeData> The allocated data
      */
     std::unique_ptr<TransposeData>
-    generateData(hpcc_base::ExecutionSettings<transpose::TransposeProgramSettings>& settings) override {
+    allocateData(hpcc_base::ExecutionSettings<transpose::TransposeProgramSettings>& settings) override {
         int width_in_blocks = settings.programSettings->matrixSize / settings.programSettings->blockSize;
 
         // A data block is strided!
         MPI_Type_contiguous(settings.programSettings->blockSize * settings.programSettings->blockSize, MPI_FLOAT, &data_block);
         MPI_Type_commit(&data_block);
 
+        if (width_in_blocks % (cycle_size * pq_width) != 0 || width_in_blocks % (cycle_size * pq_height) != 0) {
+            throw std::runtime_error("Matrix width in blocks (" + std::to_string(width_in_blocks) + ") has to be divisible by P = " + std::to_string(pq_height) 
+                                        + " and Q = " + std::to_string(pq_width) + " times the cycle size " + std::to_string(cycle_size) + "!");
+        }
+
         width_per_rank = width_in_blocks / pq_width;
+        height_per_rank = width_in_blocks / pq_height;
         pq_row = mpi_comm_rank / pq_width;
         pq_col = mpi_comm_rank % pq_width;
 
-        int blocks_per_rank = width_per_rank * width_per_rank;
+        createRectangularExchangePattern(width_in_blocks, settings.programSettings->blockSize);
+
+        int blocks_per_rank = width_per_rank * height_per_rank;
         
-        // Allocate memory for a single device and all its memory banks
-        auto d = std::unique_ptr<transpose::TransposeData>(new transpose::TransposeData(*settings.context, settings.programSettings->blockSize, blocks_per_rank));
+        // Allocate memory for a single device and all its memory banks.
+        // For P != Q, the blocks are rearranged during the exchange, so A can not be shared with the partners
+        MPI_Comm shared_comm = (pq_height == pq_width) ? getSharedMemoryComm(settings) : MPI_COMM_NULL;
+        return std::unique_ptr<transpose::TransposeData>(new transpose::TransposeData(*settings.context, settings.programSettings->blockSize, blocks_per_rank, shared_comm));
+    }
 
-        // Fill the allocated memory with pseudo random values
-        std::mt19937 gen(mpi_comm_rank);
-        std::uniform_real_distribution<> dis(-100.0, 100.0);
+    /**
+     * @brief Generate data for transposition based on the implemented distribution scheme
+     * 
+     * @param settings The execution settings that contain information about the data size
+     * @return std::unique_ptr<TransposeData> The generated data
+     */
+    std::unique_ptr<TransposeData>
+    generateData(hpcc_base::ExecutionSettings<transpose::TransposeProgramSettings>& settings) override {
+        auto d = allocateData(settings);
+        size_t blocks_per_rank = d->numBlocks;
+
+        // Fill the allocated memory with pseudo random values.
+        // They only depend on the rank and the position in the local matrix, so the rows can be filled in parallel
+        const uint64_t seed = 0;
+        const uint64_t stream = 2 * static_cast<uint64_t>(mpi_comm_rank);
+#pragma omp parallel for
         for (size_t i = 0; i < blocks_per_rank * settings.programSettings->blockSize; i++) {
             for (size_t j = 0; j < settings.programSettings->blockSize; j++) {
-                d->A[i * settings.programSettings->blockSize + j] = dis(gen);
-                d->B[i * settings.programSettings->blockSize + j] = dis(gen);
-                d->result[i * settings.programSettings->blockSize + j] = 0.0;
+                size_t index = i * settings.programSettings->blockSize + j;
+                d->A[index] = rng::uniform(seed, stream, index, -100.0, 100.0);
+                d->B[index] = rng::uniform(seed, stream + 1, index, -100.0, 100.0);
+                d->result[index] = 0.0;
             }
         }
         
@@ -102,54 +301,174 @@ public:
     void
     exchangeData(TransposeData& data) override {
 
-        if (pq_col != pq_row) {
-
-            int pair_rank = pq_width * pq_col + pq_row;
-
-            // To re-calculate the matrix transposition locally on this host, we need to 
-            // exchange matrix A for every kernel replication
-            // The order of the matrix blocks does not change during the exchange, because they are distributed diagonally 
-            // and will be handled in the order below:
-            //
-            // . . 1 3
-            // . . . 2
-            // 1 . . .
-            // 3 2 . .
-            MPI_Status status;        
-
-            size_t remaining_data_size = data.numBlocks;
-            size_t offset = 0;
-            while (remaining_data_size > 0) {
-                int next_chunk = (remaining_data_size > std::numeric_limits<int>::max()) ? std::numeric_limits<int>::max(): remaining_data_size;
-                MPI_Sendrecv(&data.A[offset], next_chunk, data_block, pair_rank, 0, &data.exchange[offset], next_chunk, data_block, pair_rank, 0, MPI_COMM_WORLD, &status);
-
-                remaining_data_size -= next_chunk;
-                offset += static_cast<size_t>(next_chunk) * static_cast<size_t>(data.blockSize * data.blockSize);
+        if (pq_height != pq_width) {
+            if (data.exchangeBlocks < data.numBlocks) {
+                throw std::runtime_error("The data exchange for P != Q requires an exchange buffer for the whole matrix!");
             }
-            
-            // Exchange window pointers
+            // Every rank sends the blocks in its local layout and receives the blocks for the transposed layout from
+            // multiple ranks. The exchange in the other direction restores the original layout.
+            std::vector<int> send_counts(mpi_comm_size, 0);
+            std::vector<int> recv_counts(mpi_comm_size, 0);
+            std::vector<int> displacements(mpi_comm_size, 0);
+            std::vector<MPI_Datatype> used_send_types(transposed_layout ? recv_types : send_types);
+            std::vector<MPI_Datatype> used_recv_types(transposed_layout ? send_types : recv_types);
+            for (int r = 0; r < mpi_comm_size; r++) {
+                send_counts[r] = (used_send_types[r] != MPI_DATATYPE_NULL) ? 1 : 0;
+                recv_counts[r] = (used_recv_types[r] != MPI_DATATYPE_NULL) ? 1 : 0;
+                used_send_types[r] = (send_counts[r] > 0) ? used_send_types[r] : MPI_FLOAT;
+                used_recv_types[r] = (recv_counts[r] > 0) ? used_recv_types[r] : MPI_FLOAT;
+            }
+            MPI_Alltoallw(data.A, send_counts.data(), displacements.data(), used_send_types.data(),
+                            data.exchange, recv_counts.data(), displacements.data(), used_recv_types.data(), communicator);
             HOST_DATA_TYPE* tmp = data.exchange;
             data.exchange = data.A;
             data.A = tmp;
+            transposed_layout = !transposed_layout;
+            return;
+        }
+
+        if (data.exchangeBlocks < data.numBlocks) {
+            exchangeDataInRing(data, getExchangePartner());
+            return;
         }
 
+        // The matrix is exchanged in block rows using non-blocking MPI calls.
+        // The order of the matrix blocks does not change during the exchange, so the
+        // received data can be directly used after the pointers are swapped
+        beginExchangeData(data);
+        completeExchangeData(data);
+    }
+
+    /**
+     * @brief Check, if the data can be exchanged with beginExchangeData().
+     *          For P != Q, the blocks are exchanged with multiple ranks, so only exchangeData() can be used.
+     * 
+     * @param data The data that will be exchanged
+     * @return true if the asynchronous exchange can be used
+     */
+    bool
+    isAsynchronousExchangeSupported(TransposeData& data) override {
+        return pq_height == pq_width && TransposeDataHandler::isAsynchronousExchangeSupported(data);
+    }
+
+    /**
+     * @brief Get the MPI rank the local matrix A is exchanged with.
+     *          Only available for P = Q, because the blocks are exchanged with multiple ranks otherwise.
+     * 
+     * @return int The rank of the exchange partner or -1, if no exchange is required for this rank
+     */
+    int
+    getExchangePartner() override {
+        if (pq_height != pq_width) {
+            throw std::runtime_error("There is no single exchange partner for P != Q!");
+        }
+        if (pq_col == pq_row) {
+            // Ranks on the diagonal of the grid do not need to exchange data
+            return -1;
+        }
+        return pq_width * pq_col + pq_row;
     }
 
     void 
     reference_transpose(TransposeData& data) {
-        for (size_t i = 0; i < width_per_rank * data.blockSize; i++) {
-            for (size_t j = 0; j < width_per_rank * data.blockSize; j++) {
-                data.A[j * width_per_rank * data.blockSize + i] -= (data.result[i * width_per_rank * data.blockSize + j] - data.B[i * width_per_rank * data.blockSize + j]);
-            }
-        }
+        transposeAndSubtract(data.A, data.B, data.result, height_per_rank * data.blockSize, width_per_rank * data.blockSize, 1);
+    }
+
+    /**
+     * @brief Get the local indices of the blocks of A that are sent to a rank if P != Q.
+     *          The handler has to be initialized with allocateData() before.
+     * 
+     * @param rank The receiving rank
+     * @return const std::vector<int>& The block indices in the order they are sent
+     */
+    const std::vector<int>&
+    getSendBlocks(int rank) const {
+        return send_blocks[rank];
+    }
+
+    /**
+     * @brief Get the indices in the transposed local layout of the blocks that are received from a rank if P != Q.
+     *          The handler has to be initialized with allocateData() before.
+     * 
+     * @param rank The sending rank
+     * @return const std::vector<int>& The block indices in the order they are received
+     */
+    const std::vector<int>&
+    getReceiveBlocks(int rank) const {
+        return recv_blocks[rank];
+    }
+
+    /**
+     * @brief Get the number of rows P of the grid
+     * 
+     * @return int P
+     */
+    int
+    getP() const {
+        return pq_height;
     }
 
-    DistributedPQTransposeDataHandler(int mpi_rank, int mpi_size) : TransposeDataHandler(mpi_rank, mpi_size) {
-        int sqrt_size = std::sqrt(mpi_size);
-        if (sqrt_size * sqrt_size != mpi_size) {
-            throw std::runtime_error("Number of MPI ranks must have an integer as square root since P = Q has to hold!");
+    /**
+     * @brief Get the number of columns Q of the grid
+     * 
+     * @return int Q
+     */
+    int
+    getQ() const {
+        return pq_width;
+    }
+
+    /**
+     * @brief Get the width of the local matrix in blocks.
+     *          After exchangeData(), A is stored transposed with width getHeightPerRank().
+     * 
+     * @return int The width
+     */
+    int
+    getWidthPerRank() const {
+        return width_per_rank;
+    }
+
+    /**
+     * @brief Get the height of the local matrix in blocks
+     * 
+     * @return int The height
+     */
+    int
+    getHeightPerRank() const {
+        return height_per_rank;
+    }
+
+    /**
+     * @brief Get the number of matrix blocks in one dimension that are assigned to the same rank
+     * 
+     * @return int The cycle size in blocks
+     */
+    int
+    getCycleSize() const {
+        return cycle_size;
+    }
+
+    /**
+     * @brief Construct a new handler for a P x Q grid. 
+     *          P is chosen as the largest divisor of the number of ranks that is not larger than its square root, so P <= Q holds.
+     * 
+     * @param mpi_rank Rank of this process
+     * @param mpi_size Number of MPI ranks
+     * @param cycle_size Number of matrix blocks in one dimension that are assigned to the same rank
+     * @param communicator Communicator that is used for the data exchange
+     */
+    DistributedPQTransposeDataHandler(int mpi_rank, int mpi_size, int cycle_size = 1, MPI_Comm communicator = MPI_COMM_WORLD) :
+                                                                                        TransposeDataHandler(mpi_rank, mpi_size, communicator),
+                                                                                        cycle_size(cycle_size) {
+        if (cycle_size < 1) {
+            throw std::runtime_error("The cycle size has to be at least 1!");
+        }
+        pq_height = std::sqrt(mpi_size);
+        while (mpi_size % pq_height != 0) {
+            pq_height--;
         }
-        pq_width = std::sqrt(mpi_size);
+        pq_width = mpi_size / pq_height;
     }
 
 };
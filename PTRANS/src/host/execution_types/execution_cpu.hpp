@@ -35,6 +35,7 @@ SOFTWARE.
 
 /* Project's headers */
 #include "data_handlers/handler.hpp"
+#include "data_handlers/pq.hpp"
 
 namespace transpose
 {
@@ -62,14 +63,12 @@ namespace transpose
                     throw std::runtime_error("Block size for CPU hardcoded to " + std::to_string(BLOCK_SIZE) + ". Recompile to use different block sizes!");
                 }
 
-                ulong local_matrix_width = std::sqrt(data.numBlocks);
-
                 for (int repetition = 0; repetition < config.programSettings->numRepetitions; repetition++)
                 {
 
                     std::chrono::duration<double> transferTime(0);
 
-                    MPI_Barrier(MPI_COMM_WORLD);
+                    MPI_Barrier(config.communicator);
 
                     auto startCalculation = std::chrono::high_resolution_clock::now();
 
@@ -85,14 +84,21 @@ namespace transpose
                                 }
                                 break;
                         case transpose::data_handler::DataHandlerType::pq: 
+                        case transpose::data_handler::DataHandlerType::block_cyclic: 
+                                {
+                                // The local matrix is rectangular for P != Q and A is stored transposed after the exchange
+                                auto& pq_handler = dynamic_cast<transpose::data_handler::DistributedPQTransposeDataHandler&>(handler);
+                                ulong local_matrix_width = pq_handler.getWidthPerRank();
+                                ulong local_matrix_height = pq_handler.getHeightPerRank();
                                 #pragma omp parallel for 
-                                for (ulong yoffset=0; yoffset < BLOCK_SIZE * local_matrix_width; yoffset += BLOCK_SIZE) {
+                                for (ulong yoffset=0; yoffset < BLOCK_SIZE * local_matrix_height; yoffset += BLOCK_SIZE) {
                                     for (ulong xoffset=0; xoffset < BLOCK_SIZE * local_matrix_width; xoffset += BLOCK_SIZE) {
-                                        ulong toffset = xoffset * BLOCK_SIZE * local_matrix_width + yoffset;
+                                        ulong toffset = xoffset * BLOCK_SIZE * local_matrix_height + yoffset;
                                         ulong offset = yoffset * BLOCK_SIZE * local_matrix_width + xoffset;
-                                        mkl_somatadd('R', 'T', 'N', BLOCK_SIZE, BLOCK_SIZE, 1.0, &data.A[toffset], BLOCK_SIZE * local_matrix_width, 1.0, &data.B[offset], BLOCK_SIZE * local_matrix_width, &data.result[offset], BLOCK_SIZE * local_matrix_width);
+                                        mkl_somatadd('R', 'T', 'N', BLOCK_SIZE, BLOCK_SIZE, 1.0, &data.A[toffset], BLOCK_SIZE * local_matrix_height, 1.0, &data.B[offset], BLOCK_SIZE * local_matrix_width, &data.result[offset], BLOCK_SIZE * local_matrix_width);
                                     }
                                 }
+                                }
                                 break;
                         default: throw std::runtime_error("Given data handler is not supported by CPU implementation: " + transpose::data_handler::handlerToString(config.programSettings->dataHandlerIdentifier));
                     }
@@ -101,7 +107,7 @@ namespace transpose
                     auto endCalculation = std::chrono::high_resolution_clock::now();
 #ifndef NDEBUG
                     int mpi_rank;
-                    MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+                    MPI_Comm_rank(config.communicator, &mpi_rank);
                     std::cout << "Rank " << mpi_rank << ": "
                           << "Done i=" << repetition << std::endl;
 #endif
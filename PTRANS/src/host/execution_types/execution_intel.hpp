@@ -77,30 +77,37 @@ static  std::unique_ptr<transpose::TransposeExecutionTimings>
 
                 bufferSizeList.push_back(buffer_size);
 
-                int memory_bank_info_a = 0;
-                int memory_bank_info_b = 0;
-                int memory_bank_info_out = 0;
+                int default_bank_a = -1;
+                int default_bank_b = -1;
+                int default_bank_out = -1;
 #ifdef INTEL_FPGA
                 if (!config.programSettings->useMemoryInterleaving) {
                         // Define the memory bank the buffers will be placed in
                         if (config.programSettings->distributeBuffers) {
-                                memory_bank_info_a = ((((r * 3) % 7) + 1) << 16);
-                                memory_bank_info_b = ((((r * 3 + 1) % 7) + 1) << 16);
-                                memory_bank_info_out = ((((r * 3 + 2) % 7) + 1) << 16);
+                                default_bank_a = (r * 3) % 7;
+                                default_bank_b = (r * 3 + 1) % 7;
+                                default_bank_out = (r * 3 + 2) % 7;
                         }
                         else {
-                                memory_bank_info_a = ((r + 1) << 16);
-                                memory_bank_info_b = ((r + 1) << 16);
-                                memory_bank_info_out = ((r + 1) << 16);
+                                default_bank_a = r;
+                                default_bank_b = r;
+                                default_bank_out = r;
                         }
                 }
 #endif
-                cl::Buffer bufferA(*config.context, CL_MEM_READ_ONLY | memory_bank_info_a,
-                                buffer_size* sizeof(HOST_DATA_TYPE));
-                cl::Buffer bufferB(*config.context, CL_MEM_READ_ONLY | memory_bank_info_b,
-                                buffer_size * sizeof(HOST_DATA_TYPE));
-                cl::Buffer bufferA_out(*config.context, CL_MEM_WRITE_ONLY | memory_bank_info_out,
-                                buffer_size * sizeof(HOST_DATA_TYPE));
+                cl::Buffer bufferA = placement::createBuffer(*config.context, CL_MEM_READ_ONLY,
+                                buffer_size* sizeof(HOST_DATA_TYPE), config.programSettings->memoryBanks.bank(r, 0, 3, default_bank_a));
+#ifdef USE_INPLACE_TRANSPOSE
+                // The kernel writes the result into the buffer of B
+                cl::Buffer bufferB = placement::createBuffer(*config.context, CL_MEM_READ_WRITE,
+                                buffer_size * sizeof(HOST_DATA_TYPE), config.programSettings->memoryBanks.bank(r, 1, 3, default_bank_b));
+                cl::Buffer bufferA_out = bufferB;
+#else
+                cl::Buffer bufferB = placement::createBuffer(*config.context, CL_MEM_READ_ONLY,
+                                buffer_size * sizeof(HOST_DATA_TYPE), config.programSettings->memoryBanks.bank(r, 1, 3, default_bank_b));
+                cl::Buffer bufferA_out = placement::createBuffer(*config.context, CL_MEM_WRITE_ONLY,
+                                buffer_size * sizeof(HOST_DATA_TYPE), config.programSettings->memoryBanks.bank(r, 2, 3, default_bank_out));
+#endif
 
                 // TODO the kernel name may need to be changed for Xilinx support
                 cl::Kernel transposeReadKernel(*config.program, (READ_KERNEL_NAME + std::to_string(r)).c_str(), &err);
@@ -123,25 +130,28 @@ static  std::unique_ptr<transpose::TransposeExecutionTimings>
                 ASSERT_CL(err)   
                 err = transposeWriteKernel.setArg(0, bufferB);
                 ASSERT_CL(err)
+#ifndef USE_INPLACE_TRANSPOSE
                 err = transposeWriteKernel.setArg(1, bufferA_out);
                 ASSERT_CL(err)
+#endif
         
         #endif
                 // TODO If SVM, the start index might be different because all replcations 
                 // access the same buffer!
-                if (config.programSettings->dataHandlerIdentifier == transpose::data_handler::DataHandlerType::pq) {
-                        err = transposeWriteKernel.setArg(2, static_cast<cl_ulong>(std::sqrt(data.numBlocks)));
+                if (config.programSettings->dataHandlerIdentifier == transpose::data_handler::DataHandlerType::pq ||
+                        config.programSettings->dataHandlerIdentifier == transpose::data_handler::DataHandlerType::block_cyclic) {
+                        err = transposeWriteKernel.setArg(1 + KERNEL_OUTPUT_ARGS, static_cast<cl_ulong>(std::sqrt(data.numBlocks)));
                         ASSERT_CL(err) 
                         err = transposeReadKernel.setArg(1, static_cast<cl_ulong>(std::sqrt(data.numBlocks)));
                         ASSERT_CL(err) 
                 }
                 else {
-                        err = transposeWriteKernel.setArg(2, static_cast<cl_ulong>(0));
+                        err = transposeWriteKernel.setArg(1 + KERNEL_OUTPUT_ARGS, static_cast<cl_ulong>(0));
                         ASSERT_CL(err) 
                         err = transposeReadKernel.setArg(1, static_cast<cl_ulong>(0));
                         ASSERT_CL(err) 
                 }
-                err = transposeWriteKernel.setArg(3, static_cast<cl_ulong>(blocks_per_replication));
+                err = transposeWriteKernel.setArg(2 + KERNEL_OUTPUT_ARGS, static_cast<cl_ulong>(blocks_per_replication));
                 ASSERT_CL(err) 
                 err = transposeReadKernel.setArg(2, static_cast<cl_ulong>(blocks_per_replication));
                 ASSERT_CL(err)     
@@ -201,7 +211,7 @@ static  std::unique_ptr<transpose::TransposeExecutionTimings>
                     std::chrono::duration_cast<std::chrono::duration<double>>
                             (endTransfer - startTransfer);
 
-            MPI_Barrier(MPI_COMM_WORLD);
+            MPI_Barrier(config.communicator);
 
             auto startCalculation = std::chrono::high_resolution_clock::now();
 #ifdef HOST_EMULATION_REORDER
@@ -230,7 +240,7 @@ static  std::unique_ptr<transpose::TransposeExecutionTimings>
             auto endCalculation = std::chrono::high_resolution_clock::now();
 #ifndef NDEBUG
                 int mpi_rank;
-                MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+                MPI_Comm_rank(config.communicator, &mpi_rank);
                 std::cout << "Rank " << mpi_rank << ": " << "Done i=" << repetition << std::endl;
 #endif
             std::chrono::duration<double> calculationTime =
@@ -46,7 +46,8 @@ static  std::unique_ptr<transpose::TransposeExecutionTimings>
     calculate(const hpcc_base::ExecutionSettings<transpose::TransposeProgramSettings>& config, transpose::TransposeData& data) {
         int err;
 
-        if (config.programSettings->dataHandlerIdentifier != transpose::data_handler::DataHandlerType::pq) {
+        if (config.programSettings->dataHandlerIdentifier != transpose::data_handler::DataHandlerType::pq &&
+                config.programSettings->dataHandlerIdentifier != transpose::data_handler::DataHandlerType::block_cyclic) {
                 throw std::runtime_error("Used data handler not supported by execution handler!");
         }
 
@@ -54,6 +55,14 @@ static  std::unique_ptr<transpose::TransposeExecutionTimings>
                 throw new std::runtime_error("SVM not supported in the host implementation of this communication method");
 #endif
 
+        int mpi_size;
+        MPI_Comm_size(config.communicator, &mpi_size);
+        int pq_width = std::sqrt(mpi_size);
+        if (pq_width * pq_width != mpi_size) {
+                // The external channels connect every FPGA with a single transpose partner
+                throw std::runtime_error("Number of MPI ranks must have an integer as square root since P = Q has to hold for the external channels!");
+        }
+
         std::vector<size_t> bufferSizeList;
         std::vector<size_t> bufferStartList;
         std::vector<size_t> bufferOffsetList;
@@ -90,35 +99,42 @@ static  std::unique_ptr<transpose::TransposeExecutionTimings>
 
                 total_offset += blocks_per_replication;
 
-                int memory_bank_info_a = 0;
-                int memory_bank_info_b = 0;
-                int memory_bank_info_out = 0;
+                int default_bank_a = -1;
+                int default_bank_b = -1;
+                int default_bank_out = -1;
 #ifdef INTEL_FPGA
                 if (!config.programSettings->useMemoryInterleaving) {
                         // Define the memory bank the buffers will be placed in
                         if (config.programSettings->distributeBuffers) {
-                                memory_bank_info_a = ((((r * 3) % 7) + 1) << 16);
-                                memory_bank_info_b = ((((r * 3 + 1) % 7) + 1) << 16);
-                                memory_bank_info_out = ((((r * 3 + 2) % 7) + 1) << 16);
+                                default_bank_a = (r * 3) % 7;
+                                default_bank_b = (r * 3 + 1) % 7;
+                                default_bank_out = (r * 3 + 2) % 7;
                         }
                         else {
-                                memory_bank_info_a = ((r + 1) << 16);
-                                memory_bank_info_b = ((r + 1) << 16);
-                                memory_bank_info_out = ((r + 1) << 16);
+                                default_bank_a = r;
+                                default_bank_b = r;
+                                default_bank_out = r;
                         }
                 }
 #endif
 #ifdef USE_BUFFER_WRITE_RECT_FOR_A
-                cl::Buffer bufferA(*config.context, CL_MEM_READ_ONLY | memory_bank_info_a,
-                                buffer_size * sizeof(HOST_DATA_TYPE));
+                cl::Buffer bufferA = placement::createBuffer(*config.context, CL_MEM_READ_ONLY,
+                                buffer_size * sizeof(HOST_DATA_TYPE), config.programSettings->memoryBanks.bank(r, 0, 3, default_bank_a));
 #else
-                cl::Buffer bufferA(*config.context, CL_MEM_READ_ONLY | memory_bank_info_a,
-                                data.numBlocks * data.blockSize * data.blockSize * sizeof(HOST_DATA_TYPE));
+                cl::Buffer bufferA = placement::createBuffer(*config.context, CL_MEM_READ_ONLY,
+                                data.numBlocks * data.blockSize * data.blockSize * sizeof(HOST_DATA_TYPE), config.programSettings->memoryBanks.bank(r, 0, 3, default_bank_a));
+#endif
+#ifdef USE_INPLACE_TRANSPOSE
+                // The kernel writes the result into the buffer of B
+                cl::Buffer bufferB = placement::createBuffer(*config.context, CL_MEM_READ_WRITE,
+                                buffer_size * sizeof(HOST_DATA_TYPE), config.programSettings->memoryBanks.bank(r, 1, 3, default_bank_b));
+                cl::Buffer bufferA_out = bufferB;
+#else
+                cl::Buffer bufferB = placement::createBuffer(*config.context, CL_MEM_READ_ONLY,
+                                buffer_size * sizeof(HOST_DATA_TYPE), config.programSettings->memoryBanks.bank(r, 1, 3, default_bank_b));
+                cl::Buffer bufferA_out = placement::createBuffer(*config.context, CL_MEM_WRITE_ONLY,
+                                buffer_size * sizeof(HOST_DATA_TYPE), config.programSettings->memoryBanks.bank(r, 2, 3, default_bank_out));
 #endif
-                cl::Buffer bufferB(*config.context, CL_MEM_READ_ONLY | memory_bank_info_b,
-                                buffer_size * sizeof(HOST_DATA_TYPE));
-                cl::Buffer bufferA_out(*config.context, CL_MEM_WRITE_ONLY | memory_bank_info_out,
-                                buffer_size * sizeof(HOST_DATA_TYPE));
 
                 // TODO the kernel name may need to be changed for Xilinx support
                 cl::Kernel transposeReadKernel(*config.program, (READ_KERNEL_NAME + std::to_string(r)).c_str(), &err);
@@ -130,15 +146,17 @@ static  std::unique_ptr<transpose::TransposeExecutionTimings>
                 ASSERT_CL(err)   
                 err = transposeWriteKernel.setArg(0, bufferB);
                 ASSERT_CL(err)
+#ifndef USE_INPLACE_TRANSPOSE
                 err = transposeWriteKernel.setArg(1, bufferA_out);
                 ASSERT_CL(err)
+#endif
 
                 // Row offset in blocks 
-                err = transposeWriteKernel.setArg(2, static_cast<cl_ulong>(0));
+                err = transposeWriteKernel.setArg(1 + KERNEL_OUTPUT_ARGS, static_cast<cl_ulong>(0));
                 ASSERT_CL(err)
         
                 // Width of the whole local matrix in blocks
-                err = transposeWriteKernel.setArg(3, static_cast<cl_ulong>(local_matrix_width));
+                err = transposeWriteKernel.setArg(2 + KERNEL_OUTPUT_ARGS, static_cast<cl_ulong>(local_matrix_width));
                 ASSERT_CL(err) 
 #ifndef USE_BUFFER_WRITE_RECT_FOR_A
                 // Row offset in blocks
@@ -159,7 +177,7 @@ static  std::unique_ptr<transpose::TransposeExecutionTimings>
                 ASSERT_CL(err) 
 
                 // total number of blocks that are processed in this replication
-                err = transposeWriteKernel.setArg(4, static_cast<cl_ulong>(blocks_per_replication));
+                err = transposeWriteKernel.setArg(3 + KERNEL_OUTPUT_ARGS, static_cast<cl_ulong>(blocks_per_replication));
                 ASSERT_CL(err) 
                 err = transposeReadKernel.setArg(4, static_cast<cl_ulong>(blocks_per_replication));
                 ASSERT_CL(err)     
@@ -229,7 +247,7 @@ static  std::unique_ptr<transpose::TransposeExecutionTimings>
                     std::chrono::duration_cast<std::chrono::duration<double>>
                             (endTransfer - startTransfer);
 
-            MPI_Barrier(MPI_COMM_WORLD);
+            MPI_Barrier(config.communicator);
 
             auto startCalculation = std::chrono::high_resolution_clock::now();
 #ifdef HOST_EMULATION_REORDER
@@ -241,7 +259,7 @@ static  std::unique_ptr<transpose::TransposeExecutionTimings>
                 readCommandQueueList[r].finish();
 #ifndef NDEBUG
                 int mpi_rank;
-                MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+                MPI_Comm_rank(config.communicator, &mpi_rank);
                 std::cout << "Rank " << mpi_rank << ": " << "Read done r=" << r << ", i=" << repetition << std::endl;
 #endif
             }
@@ -252,7 +270,7 @@ static  std::unique_ptr<transpose::TransposeExecutionTimings>
                 writeCommandQueueList[r].finish();
 #ifndef NDEBUG
                 int mpi_rank;
-                MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+                MPI_Comm_rank(config.communicator, &mpi_rank);
                 std::cout << "Rank " << mpi_rank << ": " << "Write done r=" << r << ", i=" << repetition << std::endl;
 #endif
             }
@@ -265,13 +283,13 @@ static  std::unique_ptr<transpose::TransposeExecutionTimings>
                 writeCommandQueueList[r].finish();
 #ifndef NDEBUG
                 int mpi_rank;
-                MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+                MPI_Comm_rank(config.communicator, &mpi_rank);
                 std::cout << "Rank " << mpi_rank << ": " << "Write done r=" << r << ", i=" << repetition << std::endl;
 #endif
                 readCommandQueueList[r].finish();
 #ifndef NDEBUG
                 mpi_rank;
-                MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+                MPI_Comm_rank(config.communicator, &mpi_rank);
                 std::cout << "Rank " << mpi_rank << ": " << "Read done r=" << r << ", i=" << repetition << std::endl;
 #endif
             }
@@ -279,7 +297,7 @@ static  std::unique_ptr<transpose::TransposeExecutionTimings>
             auto endCalculation = std::chrono::high_resolution_clock::now();
 #ifndef NDEBUG
                 int mpi_rank;
-                MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+                MPI_Comm_rank(config.communicator, &mpi_rank);
                 std::cout << "Rank " << mpi_rank << ": " << "Done i=" << repetition << std::endl;
 #endif
             std::chrono::duration<double> calculationTime =
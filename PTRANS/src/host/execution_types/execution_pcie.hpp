@@ -26,12 +26,15 @@ SOFTWARE.
 #include <memory>
 #include <vector>
 #include <chrono>
+#include <climits>
+#include <algorithm>
 
 /* External library headers */
 #include "mpi.h"
 
 /* Project's headers */
 #include "data_handlers/handler.hpp"
+#include "async_execution.hpp"
 
 namespace transpose
 {
@@ -40,6 +43,198 @@ namespace transpose
         namespace pcie
         {
 
+            /**
+ * @brief Exchange the matrix A that is stored on the device with the exchange partner of the rank.
+ *          The buffers are split into chunks that are read from the device, sent over MPI and written back to the
+ *          device independently. This allows to overlap the PCIe transfers with the MPI communication.
+ *          The received data is written back to the same buffers on the device, data.A is not modified
+ *          but data.exchange is used as receive buffer.
+ *          If A is shared with a partner on the same node, the chunks are written to the device directly from A of the
+ *          partner and only empty messages are sent to signal that a chunk was read.
+ * 
+ * @param config The program configuration
+ * @param data data object that contains all required data for the execution on the FPGA
+ * @param partner The MPI rank to exchange the data with. If it is negative, the data is just copied over the host
+ *                  to keep the measured calculation comparable between the ranks.
+ * @param bufferListA Device buffers that contain the matrix A of every kernel replication
+ * @param bufferSizeList Number of values in the buffers of every kernel replication
+ * @param readQueueList Command queues used to read chunks from the device
+ * @param writeQueueList Command queues used to write chunks to the device
+ * @param writeEvents Will contain the events of all writes for every kernel replication.
+ *                     The kernels have to wait for these events.
+ */
+            static void
+            exchangeDataPipelined(const hpcc_base::ExecutionSettings<transpose::TransposeProgramSettings> &config, transpose::TransposeData &data, int partner,
+                                    std::vector<cl::Buffer> &bufferListA, std::vector<size_t> &bufferSizeList,
+                                    std::vector<cl::CommandQueue> &readQueueList, std::vector<cl::CommandQueue> &writeQueueList,
+                                    std::vector<std::vector<cl::Event>> &writeEvents)
+            {
+                struct Chunk {
+                    size_t host_offset;
+                    size_t device_offset;
+                    size_t size;
+                    int replication;
+                };
+
+                size_t chunk_values = static_cast<size_t>(config.programSettings->pcieChunkSize) * data.blockSize * data.blockSize;
+
+                // Split the buffers of all replications into chunks
+                std::vector<Chunk> chunks;
+                size_t bufferOffset = 0;
+                for (int r = 0; r < bufferSizeList.size(); r++) {
+                    for (size_t offset = 0; offset < bufferSizeList[r]; offset += chunk_values) {
+                        chunks.push_back({bufferOffset + offset, offset, std::min(chunk_values, bufferSizeList[r] - offset), r});
+                    }
+                    bufferOffset += bufferSizeList[r];
+                }
+
+                if (partner >= 0 && chunk_values > INT_MAX) {
+                    throw std::runtime_error("PCIe chunk size too large for a single MPI message! Reduce the PCIe chunk size.");
+                }
+
+                // Every chunk is read from the device, sent to the partner and the received chunk is written back.
+                // The graph starts every operation as soon as its dependencies are met. The partner uses the same chunk layout,
+                // so the chunk index can be used as tag
+                async_execution::ExecutionGraph graph;
+                std::vector<async_execution::ExecutionGraph::Node> receives;
+                bool shared = partner >= 0 && data.isSharedWith(partner);
+                HOST_DATA_TYPE* partner_a = shared ? data.getSharedA(partner) : nullptr;
+                if (partner >= 0) {
+                    // Post all receives first
+                    for (int c = 0; c < chunks.size(); c++) {
+                        Chunk chunk = chunks[c];
+                        receives.push_back(graph.addCommunication([&data, chunk, partner, c, shared]() {
+                            MPI_Request request;
+                            if (shared) {
+                                MPI_Irecv(nullptr, 0, MPI_FLOAT, partner, c, config.communicator, &request);
+                            }
+                            else {
+                                MPI_Irecv(&data.exchange[chunk.host_offset], chunk.size, MPI_FLOAT, partner, c, config.communicator, &request);
+                            }
+                            return request;
+                        }));
+                    }
+                }
+                std::vector<async_execution::ExecutionGraph::Node> writes;
+                for (int c = 0; c < chunks.size(); c++) {
+                    Chunk chunk = chunks[c];
+                    cl::CommandQueue &readQueue = readQueueList[chunk.replication];
+                    cl::CommandQueue &writeQueue = writeQueueList[chunk.replication];
+                    cl::Buffer &buffer = bufferListA[chunk.replication];
+                    auto read = graph.addDeviceOperation([&data, &readQueue, &buffer, chunk](const std::vector<cl::Event>&) {
+                        cl::Event readEvent;
+                        ASSERT_CL(readQueue.enqueueReadBuffer(buffer, CL_FALSE, chunk.device_offset * sizeof(HOST_DATA_TYPE),
+                                    chunk.size * sizeof(HOST_DATA_TYPE), &data.A[chunk.host_offset], nullptr, &readEvent))
+                        readQueue.flush();
+                        return readEvent;
+                    });
+                    // Without a partner, every chunk is written back as soon as it was read
+                    HOST_DATA_TYPE* source = &data.A[chunk.host_offset];
+                    async_execution::ExecutionGraph::Node write_dependency = read;
+                    if (partner >= 0) {
+                        graph.addCommunication([&data, chunk, partner, c, shared]() {
+                            MPI_Request request;
+                            if (shared) {
+                                // Make the chunk visible to the partner before it is signaled
+                                data.sharedA->synchronize();
+                                MPI_Isend(nullptr, 0, MPI_FLOAT, partner, c, config.communicator, &request);
+                            }
+                            else {
+                                MPI_Isend(&data.A[chunk.host_offset], chunk.size, MPI_FLOAT, partner, c, config.communicator, &request);
+                            }
+                            return request;
+                        }, {read});
+                        source = shared ? &partner_a[chunk.host_offset] : &data.exchange[chunk.host_offset];
+                        write_dependency = receives[c];
+                    }
+                    writes.push_back(graph.addDeviceOperation([&writeQueue, &buffer, &data, chunk, source, shared](const std::vector<cl::Event> &waitList) {
+                        cl::Event writeEvent;
+                        if (shared) {
+                            data.sharedA->synchronize();
+                        }
+                        ASSERT_CL(writeQueue.enqueueWriteBuffer(buffer, CL_FALSE, chunk.device_offset * sizeof(HOST_DATA_TYPE),
+                                chunk.size * sizeof(HOST_DATA_TYPE), source, waitList.empty() ? nullptr : &waitList, &writeEvent))
+                        writeQueue.flush();
+                        return writeEvent;
+                    }, {write_dependency}));
+                }
+
+                // Returns when all chunks are sent and received. The writes may still be executed on the device.
+                graph.run();
+
+                writeEvents.clear();
+                writeEvents.resize(bufferSizeList.size());
+                for (int c = 0; c < chunks.size(); c++) {
+                    writeEvents[chunks[c].replication].push_back(graph.event(writes[c]));
+                }
+                if (shared) {
+                    // The partner reads the chunks from the local A, so it must not be modified until all writes of the partner are done
+                    for (auto &events : writeEvents) {
+                        if (!events.empty()) {
+                            cl::Event::waitForEvents(events);
+                        }
+                    }
+                    data.sharedA->fence(partner, config.communicator);
+                }
+            }
+
+            /**
+ * @brief Exchange the matrix A with the asynchronous exchange of the data handler and write every received segment
+ *          to the device as soon as it arrived. This overlaps the PCIe transfers with the MPI communication of the
+ *          remaining segments. Afterwards, data.A contains the matrix of the partner like after exchangeData().
+ * 
+ * @param handler data handler instance that is used to exchange the data. The asynchronous exchange has to be supported.
+ * @param data data object that contains all required data for the execution on the FPGA
+ * @param bufferListA Device buffers that contain the matrix A of every kernel replication
+ * @param bufferStartList Offset of the first value of every device buffer in data.A
+ * @param bufferSizeList Number of values in the buffers of every kernel replication
+ * @param writeQueueList Command queues used to write the segments to the device
+ * @param writeEvents Will contain the events of all writes for every kernel replication.
+ *                     The kernels have to wait for these events.
+ */
+            static void
+            exchangeDataAsync(transpose::data_handler::TransposeDataHandler &handler, transpose::TransposeData &data,
+                                std::vector<cl::Buffer> &bufferListA, const std::vector<size_t> &bufferStartList, const std::vector<size_t> &bufferSizeList,
+                                std::vector<cl::CommandQueue> &writeQueueList, std::vector<std::vector<cl::Event>> &writeEvents)
+            {
+                handler.beginExchangeData(data);
+                const std::vector<transpose::data_handler::ExchangeSegment> &segments = handler.getExchangeSegments();
+                HOST_DATA_TYPE* receiveBuffer = handler.getReceiveBuffer(data);
+
+                writeEvents.clear();
+                writeEvents.resize(bufferListA.size());
+                std::vector<int> received;
+                bool finished = false;
+                while (!finished) {
+                    finished = handler.pollExchangeData(received);
+                    for (int i : received) {
+                        size_t segment_begin = segments[i].offset;
+                        size_t segment_end = segments[i].offset + segments[i].size;
+                        for (int r = 0; r < bufferListA.size(); r++) {
+                            // Only write the part of the segment that is contained in the buffer of the replication
+                            size_t begin = std::max(segment_begin, bufferStartList[r]);
+                            size_t end = std::min(segment_end, bufferStartList[r] + bufferSizeList[r]);
+                            if (begin >= end) {
+                                continue;
+                            }
+                            writeEvents[r].emplace_back();
+                            ASSERT_CL(writeQueueList[r].enqueueWriteBuffer(bufferListA[r], CL_FALSE, (begin - bufferStartList[r]) * sizeof(HOST_DATA_TYPE),
+                                        (end - begin) * sizeof(HOST_DATA_TYPE), &receiveBuffer[begin], nullptr, &writeEvents[r].back()))
+                            writeQueueList[r].flush();
+                        }
+                    }
+                    received.clear();
+                }
+
+                // The receive buffer may be modified by the partner, if A is shared, after the exchange is completed
+                for (auto &events : writeEvents) {
+                    if (!events.empty()) {
+                        cl::Event::waitForEvents(events);
+                    }
+                }
+                handler.completeExchangeData(data);
+            }
+
             /**
  * @brief Transpose and add the matrices using the OpenCL kernel using a diagonal distribution and PCIe+MPI over the host for communication
  * 
@@ -61,11 +256,19 @@ namespace transpose
                 }
 
                 std::vector<size_t> bufferSizeList;
+                std::vector<size_t> bufferStartList;
                 std::vector<cl::Buffer> bufferListA;
                 std::vector<cl::Buffer> bufferListB;
                 std::vector<cl::Buffer> bufferListA_out;
                 std::vector<cl::Kernel> transposeKernelList;
                 std::vector<cl::CommandQueue> transCommandQueueList;
+                std::vector<cl::CommandQueue> readCommandQueueList;
+                std::vector<cl::CommandQueue> writeCommandQueueList;
+
+                bool pipelined = config.programSettings->pcieChunkSize > 0;
+                if (pipelined && data.exchangeBlocks < data.numBlocks) {
+                    throw std::runtime_error("The pipelined data exchange requires an exchange buffer for the whole matrix. Disable USE_INPLACE_TRANSPOSE to use it!");
+                }
 
                 size_t local_matrix_width = std::sqrt(data.numBlocks);
 
@@ -88,38 +291,52 @@ namespace transpose
 
                     size_t buffer_size = data.blockSize * (data.blockSize * blocks_per_replication);
 
+                    bufferStartList.push_back(bufferSizeList.empty() ? 0 : bufferStartList.back() + bufferSizeList.back());
                     bufferSizeList.push_back(buffer_size);
 
-                    int memory_bank_info_a = 0;
-                    int memory_bank_info_b = 0;
-                    int memory_bank_info_out = 0;
+                    int default_bank_a = -1;
+                    int default_bank_b = -1;
+                    int default_bank_out = -1;
 #ifdef INTEL_FPGA
                     if (!config.programSettings->useMemoryInterleaving)
                     {
                         // Define the memory bank the buffers will be placed in
                         if (config.programSettings->distributeBuffers)
                         {
-                            memory_bank_info_a = ((((r * 3) % 7) + 1) << 16);
-                            memory_bank_info_b = ((((r * 3 + 1) % 7) + 1) << 16);
-                            memory_bank_info_out = ((((r * 3 + 2) % 7) + 1) << 16);
+                            default_bank_a = (r * 3) % 7;
+                            default_bank_b = (r * 3 + 1) % 7;
+                            default_bank_out = (r * 3 + 2) % 7;
                         }
                         else
                         {
-                            memory_bank_info_a = ((r + 1) << 16);
-                            memory_bank_info_b = ((r + 1) << 16);
-                            memory_bank_info_out = ((r + 1) << 16);
+                            default_bank_a = r;
+                            default_bank_b = r;
+                            default_bank_out = r;
                         }
                     }
 #endif
-                    cl::Buffer bufferA(*config.context, CL_MEM_READ_ONLY | memory_bank_info_a,
-                               buffer_size * sizeof(HOST_DATA_TYPE));
-                    cl::Buffer bufferB(*config.context, CL_MEM_READ_ONLY | memory_bank_info_b,
-                               buffer_size * sizeof(HOST_DATA_TYPE));
-                    cl::Buffer bufferA_out(*config.context, CL_MEM_WRITE_ONLY | memory_bank_info_out,
-                                   buffer_size * sizeof(HOST_DATA_TYPE));
-
-                    // TODO the kernel name may need to be changed for Xilinx support
+                    cl::Buffer bufferA = placement::createBuffer(*config.context, CL_MEM_READ_ONLY,
+                               buffer_size * sizeof(HOST_DATA_TYPE), config.programSettings->memoryBanks.bank(r, 0, 3, default_bank_a));
+#ifdef USE_INPLACE_TRANSPOSE
+                    // The kernel writes the result into the buffer of B
+                    cl::Buffer bufferB = placement::createBuffer(*config.context, CL_MEM_READ_WRITE,
+                               buffer_size * sizeof(HOST_DATA_TYPE), config.programSettings->memoryBanks.bank(r, 1, 3, default_bank_b));
+                    cl::Buffer bufferA_out = bufferB;
+#else
+                    cl::Buffer bufferB = placement::createBuffer(*config.context, CL_MEM_READ_ONLY,
+                               buffer_size * sizeof(HOST_DATA_TYPE), config.programSettings->memoryBanks.bank(r, 1, 3, default_bank_b));
+                    cl::Buffer bufferA_out = placement::createBuffer(*config.context, CL_MEM_WRITE_ONLY,
+                                   buffer_size * sizeof(HOST_DATA_TYPE), config.programSettings->memoryBanks.bank(r, 2, 3, default_bank_out));
+#endif
+
+#ifdef INTEL_FPGA
                     cl::Kernel transposeKernel(*config.program, ("transpose" + std::to_string(r)).c_str(), &err);
+#endif
+#ifdef XILINX_FPGA
+                    // The replications are compute units of a single kernel. Their buffers are placed in the
+                    // banks given by the link settings on the first use, if no bank is selected with the memory bank map
+                    cl::Kernel transposeKernel(*config.program, ("transpose0:{transpose0_" + std::to_string(r + 1) + "}").c_str(), &err);
+#endif
                     ASSERT_CL(err)
 
 
@@ -127,15 +344,26 @@ namespace transpose
                     ASSERT_CL(err)
                     err = transposeKernel.setArg(1, bufferB);
                     ASSERT_CL(err)
+#ifndef USE_INPLACE_TRANSPOSE
                     err = transposeKernel.setArg(2, bufferA_out);
                     ASSERT_CL(err)
-                    err = transposeKernel.setArg(3, static_cast<cl_uint>(blocks_per_replication));
+#endif
+                    err = transposeKernel.setArg(2 + KERNEL_OUTPUT_ARGS, static_cast<cl_uint>(blocks_per_replication));
                     ASSERT_CL(err)
 
                     cl::CommandQueue transQueue(*config.context, *config.device, 0, &err);
                     ASSERT_CL(err)
 
                     transCommandQueueList.push_back(transQueue);
+                    if (pipelined) {
+                        // Use separate queues for reads and writes, so they can overlap with each other
+                        cl::CommandQueue readQueue(*config.context, *config.device, 0, &err);
+                        ASSERT_CL(err)
+                        cl::CommandQueue writeQueue(*config.context, *config.device, 0, &err);
+                        ASSERT_CL(err)
+                        readCommandQueueList.push_back(readQueue);
+                        writeCommandQueueList.push_back(writeQueue);
+                    }
                     bufferListA.push_back(bufferA);
                     bufferListB.push_back(bufferB);
                     bufferListA_out.push_back(bufferA_out);
@@ -148,7 +376,7 @@ namespace transpose
                 for (int repetition = 0; repetition < config.programSettings->numRepetitions; repetition++)
                 {
 
-                    MPI_Barrier(MPI_COMM_WORLD);
+                    MPI_Barrier(config.communicator);
 
                     auto startTransfer = std::chrono::high_resolution_clock::now();
                     size_t bufferOffset = 0;
@@ -166,31 +394,47 @@ namespace transpose
                     std::chrono::duration<double> transferTime =
                         std::chrono::duration_cast<std::chrono::duration<double>>(endTransfer - startTransfer);
 
-                    MPI_Barrier(MPI_COMM_WORLD);
+                    MPI_Barrier(config.communicator);
 
                     auto startCalculation = std::chrono::high_resolution_clock::now();
-                    bufferOffset = 0;
-                    for (int r = 0; r < transposeKernelList.size(); r++)
-                    {
-                        transCommandQueueList[r].enqueueReadBuffer(bufferListA[r], CL_TRUE, 0,
-                                               bufferSizeList[r] * sizeof(HOST_DATA_TYPE), &data.A[bufferOffset]);
-                        bufferOffset += bufferSizeList[r];
+                    std::vector<std::vector<cl::Event>> writeEvents(transposeKernelList.size());
+                    if (pipelined) {
+                        // Exchange A data chunk-wise and overlap PCIe transfers with MPI
+                        exchangeDataPipelined(config, data, handler.getExchangePartner(), bufferListA, bufferSizeList,
+                                                readCommandQueueList, writeCommandQueueList, writeEvents);
                     }
-
-                    // Exchange A data via PCIe and MPI
-                    handler.exchangeData(data);
-
-                    bufferOffset = 0;
-                    for (int r = 0; r < transposeKernelList.size(); r++)
-                    {
-                        transCommandQueueList[r].enqueueWriteBuffer(bufferListA[r], CL_FALSE, 0,
+                    else {
+                        bufferOffset = 0;
+                        for (int r = 0; r < transposeKernelList.size(); r++)
+                        {
+                            transCommandQueueList[r].enqueueReadBuffer(bufferListA[r], CL_TRUE, 0,
                                                 bufferSizeList[r] * sizeof(HOST_DATA_TYPE), &data.A[bufferOffset]);
-                        bufferOffset += bufferSizeList[r];
+                            bufferOffset += bufferSizeList[r];
+                        }
+
+                        if (handler.isAsynchronousExchangeSupported(data)) {
+                            // Exchange A data via MPI and write the received segments to the device while the remaining segments are in flight
+                            exchangeDataAsync(handler, data, bufferListA, bufferStartList, bufferSizeList, transCommandQueueList, writeEvents);
+                        }
+                        else {
+                            // Exchange A data via PCIe and MPI
+                            handler.exchangeData(data);
+
+                            bufferOffset = 0;
+                            for (int r = 0; r < transposeKernelList.size(); r++)
+                            {
+                                transCommandQueueList[r].enqueueWriteBuffer(bufferListA[r], CL_FALSE, 0,
+                                                        bufferSizeList[r] * sizeof(HOST_DATA_TYPE), &data.A[bufferOffset]);
+                                bufferOffset += bufferSizeList[r];
+                            }
+                        }
                     }
 
                     for (int r = 0; r < transposeKernelList.size(); r++)
                     {
-                        transCommandQueueList[r].enqueueNDRangeKernel(transposeKernelList[r], cl::NullRange, cl::NDRange(1));
+                        // In the pipelined mode, the kernel has to wait for the writes on the separate queues
+                        transCommandQueueList[r].enqueueNDRangeKernel(transposeKernelList[r], cl::NullRange, cl::NDRange(1), cl::NullRange,
+                                                                        writeEvents[r].empty() ? nullptr : &writeEvents[r]);
                     }
                     for (int r = 0; r < transposeKernelList.size(); r++)
                     {
@@ -200,7 +444,7 @@ namespace transpose
                     auto endCalculation = std::chrono::high_resolution_clock::now();
 #ifndef NDEBUG
                     int mpi_rank;
-                    MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+                    MPI_Comm_rank(config.communicator, &mpi_rank);
                     std::cout << "Rank " << mpi_rank << ": "
                           << "Done i=" << repetition << std::endl;
 #endif
@@ -209,7 +453,10 @@ namespace transpose
                     calculationTimings.push_back(calculationTime.count());
 
                     // Transfer back data for next repetition!
-                    handler.exchangeData(data);
+                    // Not required for the pipelined exchange, since it does not modify data.A
+                    if (!pipelined) {
+                        handler.exchangeData(data);
+                    }
 
                     bufferOffset = 0;
                     startTransfer = std::chrono::high_resolution_clock::now();
@@ -30,6 +30,8 @@ SOFTWARE.
 /* Project's headers */
 #include "transpose_benchmark.hpp"
 #include "data_handlers/data_handler_types.h"
+#include "data_handlers/pq.hpp"
+#include "execution_types/execution_pcie.hpp"
 
 namespace transpose {
 namespace fpga_execution {
@@ -47,7 +49,8 @@ static  std::unique_ptr<transpose::TransposeExecutionTimings>
     calculate(const hpcc_base::ExecutionSettings<transpose::TransposeProgramSettings>& config, transpose::TransposeData& data, transpose::data_handler::TransposeDataHandler &handler) {
         int err;
 
-        if (config.programSettings->dataHandlerIdentifier != transpose::data_handler::DataHandlerType::pq) {
+        if (config.programSettings->dataHandlerIdentifier != transpose::data_handler::DataHandlerType::pq &&
+                config.programSettings->dataHandlerIdentifier != transpose::data_handler::DataHandlerType::block_cyclic) {
                 throw std::runtime_error("Used data handler not supported by execution handler!");
         }
 #ifdef USE_SVM
@@ -63,7 +66,10 @@ static  std::unique_ptr<transpose::TransposeExecutionTimings>
         std::vector<cl::Kernel> transposeKernelList;
         std::vector<cl::CommandQueue> transCommandQueueList;
 
-        size_t local_matrix_width = std::sqrt(data.numBlocks);
+        // The local matrix is rectangular for P != Q. A is stored transposed after the exchange.
+        auto& pq_handler = dynamic_cast<transpose::data_handler::DistributedPQTransposeDataHandler&>(handler);
+        size_t local_matrix_width = pq_handler.getWidthPerRank();
+        size_t local_matrix_height = pq_handler.getHeightPerRank();
         size_t local_matrix_width_bytes = local_matrix_width * data.blockSize * sizeof(HOST_DATA_TYPE);
 
         size_t total_offset = 0;
@@ -72,8 +78,8 @@ static  std::unique_ptr<transpose::TransposeExecutionTimings>
         for (int r = 0; r < config.programSettings->kernelReplications; r++) {
 
                 // Calculate how many blocks the current kernel replication will need to process.
-                size_t blocks_per_replication = (local_matrix_width / config.programSettings->kernelReplications * local_matrix_width);
-                size_t blocks_remainder = local_matrix_width % config.programSettings->kernelReplications;
+                size_t blocks_per_replication = (local_matrix_height / config.programSettings->kernelReplications * local_matrix_width);
+                size_t blocks_remainder = local_matrix_height % config.programSettings->kernelReplications;
                 if (blocks_remainder > r) {
                         // Catch the case, that the number of blocks is not divisible by the number of kernel replications
                         blocks_per_replication += local_matrix_width;
@@ -88,35 +94,42 @@ static  std::unique_ptr<transpose::TransposeExecutionTimings>
 
                 total_offset += blocks_per_replication;
 
-                int memory_bank_info_a = 0;
-                int memory_bank_info_b = 0;
-                int memory_bank_info_out = 0;
+                int default_bank_a = -1;
+                int default_bank_b = -1;
+                int default_bank_out = -1;
 #ifdef INTEL_FPGA
                 if (!config.programSettings->useMemoryInterleaving) {
                         // Define the memory bank the buffers will be placed in
                         if (config.programSettings->distributeBuffers) {
-                                memory_bank_info_a = ((((r * 3) % 7) + 1) << 16);
-                                memory_bank_info_b = ((((r * 3 + 1) % 7) + 1) << 16);
-                                memory_bank_info_out = ((((r * 3 + 2) % 7) + 1) << 16);
+                                default_bank_a = (r * 3) % 7;
+                                default_bank_b = (r * 3 + 1) % 7;
+                                default_bank_out = (r * 3 + 2) % 7;
                         }
                         else {
-                                memory_bank_info_a = ((r + 1) << 16);
-                                memory_bank_info_b = ((r + 1) << 16);
-                                memory_bank_info_out = ((r + 1) << 16);
+                                default_bank_a = r;
+                                default_bank_b = r;
+                                default_bank_out = r;
                         }
                 }
 #endif
 #ifdef USE_BUFFER_WRITE_RECT_FOR_A
-                cl::Buffer bufferA(*config.context, CL_MEM_READ_ONLY | memory_bank_info_a,
-                                buffer_size * sizeof(HOST_DATA_TYPE));
+                cl::Buffer bufferA = placement::createBuffer(*config.context, CL_MEM_READ_ONLY,
+                                buffer_size * sizeof(HOST_DATA_TYPE), config.programSettings->memoryBanks.bank(r, 0, 3, default_bank_a));
 #else
-                cl::Buffer bufferA(*config.context, CL_MEM_READ_ONLY | memory_bank_info_a,
-                                data.numBlocks * data.blockSize * data.blockSize * sizeof(HOST_DATA_TYPE));
+                cl::Buffer bufferA = placement::createBuffer(*config.context, CL_MEM_READ_ONLY,
+                                data.numBlocks * data.blockSize * data.blockSize * sizeof(HOST_DATA_TYPE), config.programSettings->memoryBanks.bank(r, 0, 3, default_bank_a));
+#endif
+#ifdef USE_INPLACE_TRANSPOSE
+                // The kernel writes the result into the buffer of B
+                cl::Buffer bufferB = placement::createBuffer(*config.context, CL_MEM_READ_WRITE,
+                                buffer_size * sizeof(HOST_DATA_TYPE), config.programSettings->memoryBanks.bank(r, 1, 3, default_bank_b));
+                cl::Buffer bufferA_out = bufferB;
+#else
+                cl::Buffer bufferB = placement::createBuffer(*config.context, CL_MEM_READ_ONLY,
+                                buffer_size * sizeof(HOST_DATA_TYPE), config.programSettings->memoryBanks.bank(r, 1, 3, default_bank_b));
+                cl::Buffer bufferA_out = placement::createBuffer(*config.context, CL_MEM_WRITE_ONLY,
+                                buffer_size * sizeof(HOST_DATA_TYPE), config.programSettings->memoryBanks.bank(r, 2, 3, default_bank_out));
 #endif
-                cl::Buffer bufferB(*config.context, CL_MEM_READ_ONLY | memory_bank_info_b,
-                                buffer_size * sizeof(HOST_DATA_TYPE));
-                cl::Buffer bufferA_out(*config.context, CL_MEM_WRITE_ONLY | memory_bank_info_out,
-                                buffer_size * sizeof(HOST_DATA_TYPE));
 
 #ifdef INTEL_FPGA
                 cl::Kernel transposeKernel(*config.program, ("transpose" + std::to_string(r)).c_str(), &err);
@@ -133,21 +146,23 @@ static  std::unique_ptr<transpose::TransposeExecutionTimings>
                 ASSERT_CL(err)
                 err = transposeKernel.setArg(1, bufferB);
                 ASSERT_CL(err)
+#ifndef USE_INPLACE_TRANSPOSE
                 err = transposeKernel.setArg(2, bufferA_out);
                 ASSERT_CL(err)
-                err = transposeKernel.setArg(4, static_cast<cl_uint>(blocks_per_replication));
+#endif
+                err = transposeKernel.setArg(3 + KERNEL_OUTPUT_ARGS, static_cast<cl_uint>(blocks_per_replication));
                 ASSERT_CL(err)
-                err = transposeKernel.setArg(5, static_cast<cl_uint>(local_matrix_width));
+                err = transposeKernel.setArg(4 + KERNEL_OUTPUT_ARGS, static_cast<cl_uint>(local_matrix_width));
                 ASSERT_CL(err)
 #ifndef USE_BUFFER_WRITE_RECT_FOR_A
-                err = transposeKernel.setArg(6, static_cast<cl_uint>(local_matrix_width));
+                err = transposeKernel.setArg(5 + KERNEL_OUTPUT_ARGS, static_cast<cl_uint>(local_matrix_height));
                 ASSERT_CL(err) 
-                err = transposeKernel.setArg(3, static_cast<cl_uint>(bufferStartList[r]));
+                err = transposeKernel.setArg(2 + KERNEL_OUTPUT_ARGS, static_cast<cl_uint>(bufferStartList[r]));
                 ASSERT_CL(err)
 #else
-                err = transposeKernel.setArg(6, static_cast<cl_uint>((bufferSizeList[r]) / (local_matrix_width * data.blockSize * data.blockSize)));
+                err = transposeKernel.setArg(5 + KERNEL_OUTPUT_ARGS, static_cast<cl_uint>((bufferSizeList[r]) / (local_matrix_width * data.blockSize * data.blockSize)));
                 ASSERT_CL(err) 
-                err = transposeKernel.setArg(3, static_cast<cl_uint>(0));
+                err = transposeKernel.setArg(2 + KERNEL_OUTPUT_ARGS, static_cast<cl_uint>(0));
                 ASSERT_CL(err)
 #endif
  
@@ -196,7 +211,7 @@ static  std::unique_ptr<transpose::TransposeExecutionTimings>
                                                 hostOffset, 
                                                 rectShape,
                                                 (bufferSizeList[r]) / (local_matrix_width * data.blockSize) * sizeof(HOST_DATA_TYPE), 0,
-                                                local_matrix_width* data.blockSize*sizeof(HOST_DATA_TYPE), 0,
+                                                local_matrix_height* data.blockSize*sizeof(HOST_DATA_TYPE), 0,
                                                 data.A);
 #else
                 transCommandQueueList[r].enqueueWriteBuffer(bufferListA[r], CL_FALSE, 0,
@@ -213,7 +228,7 @@ static  std::unique_ptr<transpose::TransposeExecutionTimings>
                     std::chrono::duration_cast<std::chrono::duration<double>>
                             (endTransfer - startTransfer);
 
-            MPI_Barrier(MPI_COMM_WORLD);
+            MPI_Barrier(config.communicator);
 
             auto startCalculation = std::chrono::high_resolution_clock::now();
 
@@ -243,20 +258,35 @@ static  std::unique_ptr<transpose::TransposeExecutionTimings>
                                                 hostOffset, 
                                                 rectShape,
                                                 (bufferSizeList[r]) / (local_matrix_width * data.blockSize) * sizeof(HOST_DATA_TYPE), 0,
-                                                local_matrix_width* data.blockSize*sizeof(HOST_DATA_TYPE), 0,
+                                                local_matrix_height* data.blockSize*sizeof(HOST_DATA_TYPE), 0,
                                                 data.A);
 #else
                 transCommandQueueList[r].enqueueReadBuffer(bufferListA[r], CL_FALSE, 0,
                                         data.numBlocks * data.blockSize * data.blockSize * sizeof(HOST_DATA_TYPE), data.A);
 #endif
         }
+        for (int r = 0; r < transposeKernelList.size(); r++)
+        {
+                // The matrix has to be completely read from the device before it is sent
+                transCommandQueueList[r].finish();
+        }
 
+        std::vector<std::vector<cl::Event>> copy_events(transposeKernelList.size());
 
+#ifndef USE_BUFFER_WRITE_RECT_FOR_A
+        if (handler.isAsynchronousExchangeSupported(data)) {
+                // Every replication holds the whole matrix A. The received block rows are written to the
+                // device while the remaining block rows are still in flight
+                std::vector<size_t> deviceStartList(transposeKernelList.size(), 0);
+                std::vector<size_t> deviceSizeList(transposeKernelList.size(), data.numBlocks * data.blockSize * data.blockSize);
+                fpga_execution::pcie::exchangeDataAsync(handler, data, bufferListA, deviceStartList, deviceSizeList, transCommandQueueList, copy_events);
+        }
+        else
+#endif
+        {
         // Exchange A data via PCIe and MPI
         handler.exchangeData(data);
 
-        std::vector<std::vector<cl::Event>> copy_events(transposeKernelList.size());
-
         for (int r = 0; r < transposeKernelList.size(); r++)
         {
                 copy_events[r].emplace_back();
@@ -284,13 +314,14 @@ static  std::unique_ptr<transpose::TransposeExecutionTimings>
                                                 hostOffset, 
                                                 rectShape,
                                                 (bufferSizeList[r]) / (local_matrix_width * data.blockSize) * sizeof(HOST_DATA_TYPE), 0,
-                                                local_matrix_width* data.blockSize*sizeof(HOST_DATA_TYPE), 0,
+                                                local_matrix_height* data.blockSize*sizeof(HOST_DATA_TYPE), 0,
                                                 data.A);
 #else
                 transCommandQueueList[r].enqueueWriteBuffer(bufferListA[r], CL_FALSE, 0,
                                         data.numBlocks * data.blockSize * data.blockSize * sizeof(HOST_DATA_TYPE), data.A, NULL, &copy_events[r][0]);
 #endif
         }
+        }
 #ifndef NDEBUG
         for (int r = 0; r < transposeKernelList.size(); r++)
         {
@@ -309,7 +340,7 @@ static  std::unique_ptr<transpose::TransposeExecutionTimings>
             auto endCalculation = std::chrono::high_resolution_clock::now();
 #ifndef NDEBUG
                 int mpi_rank;
-                MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+                MPI_Comm_rank(config.communicator, &mpi_rank);
                 std::cout << "Rank " << mpi_rank << ": " << "Done i=" << repetition << std::endl;
                 std::cout << "Kernel execution time: " << std::chrono::duration_cast<std::chrono::duration<double>>(endCalculation - startKernelCalculation).count() 
                         << "s (" << ((config.programSettings->matrixSize * config.programSettings->matrixSize * sizeof(HOST_DATA_TYPE) * 3) 
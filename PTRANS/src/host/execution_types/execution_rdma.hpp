@@ -0,0 +1,231 @@
+/*
+Copyright (c) 2019 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef SRC_HOST_RDMA_EXECUTION_H_
+#define SRC_HOST_RDMA_EXECUTION_H_
+
+/* C++ standard library headers */
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include <chrono>
+#include <climits>
+
+/* External library headers */
+#include "mpi.h"
+
+/* Project's headers */
+#include "data_handlers/handler.hpp"
+#include "rdma_buffer.hpp"
+
+namespace transpose
+{
+    namespace fpga_execution
+    {
+        namespace rdma
+        {
+
+            /**
+ * @brief Transpose and add the matrices using the OpenCL kernel using a diagonal distribution and MPI directly on the
+ *          device memory for communication. Matrix A is written to a P2P buffer that is sent by MPI from the PCIe BAR
+ *          of the device into the P2P buffer of the partner, which is used as input of the kernel. The host copy of A
+ *          is not modified.
+ * 
+ * @param config The progrma configuration
+ * @param data data object that contains all required data for the execution on the FPGA
+ * @param handler data handler instance that is used to determine the exchange partner
+ * @return std::unique_ptr<transpose::TransposeExecutionTimings> The measured execution times 
+ */
+            static std::unique_ptr<transpose::TransposeExecutionTimings>
+            calculate(const hpcc_base::ExecutionSettings<transpose::TransposeProgramSettings> &config, transpose::TransposeData &data, transpose::data_handler::TransposeDataHandler &handler)
+            {
+                int err;
+
+                if (config.programSettings->dataHandlerIdentifier != transpose::data_handler::DataHandlerType::diagonal) {
+                        throw std::runtime_error("Used data handler not supported by execution handler!");
+                }
+
+                int partner = handler.getExchangePartner();
+
+                std::vector<size_t> bufferSizeList;
+                std::vector<std::unique_ptr<::rdma::P2PBuffer>> sendBufferListA;
+                std::vector<std::unique_ptr<::rdma::P2PBuffer>> receiveBufferListA;
+                std::vector<cl::Buffer> bufferListB;
+                std::vector<cl::Buffer> bufferListA_out;
+                std::vector<cl::Kernel> transposeKernelList;
+                std::vector<cl::CommandQueue> transCommandQueueList;
+
+                // Setup the kernels depending on the number of kernel replications
+                for (int r = 0; r < config.programSettings->kernelReplications; r++)
+                {
+
+                    // Calculate how many blocks the current kernel replication will need to process.
+                    size_t blocks_per_replication = data.numBlocks / config.programSettings->kernelReplications;
+                    size_t blocks_remainder = data.numBlocks % config.programSettings->kernelReplications;
+                    if (blocks_remainder > r)
+                    {
+                        // Catch the case, that the number of blocks is not divisible by the number of kernel replications
+                        blocks_per_replication += 1;
+                    }
+                    if (blocks_per_replication < 1)
+                    {
+                        continue;
+                    }
+
+                    size_t buffer_size = data.blockSize * (data.blockSize * blocks_per_replication);
+
+                    bufferSizeList.push_back(buffer_size);
+
+                    // The P2P buffers are placed by the runtime, so only B and the output can be placed in memory banks
+                    sendBufferListA.emplace_back(new ::rdma::P2PBuffer(*config.context, *config.device, buffer_size * sizeof(HOST_DATA_TYPE)));
+                    if (partner >= 0) {
+                        receiveBufferListA.emplace_back(new ::rdma::P2PBuffer(*config.context, *config.device, buffer_size * sizeof(HOST_DATA_TYPE)));
+                    }
+#ifdef USE_INPLACE_TRANSPOSE
+                    // The kernel writes the result into the buffer of B
+                    cl::Buffer bufferB = placement::createBuffer(*config.context, CL_MEM_READ_WRITE,
+                               buffer_size * sizeof(HOST_DATA_TYPE), config.programSettings->memoryBanks.bank(r, 1, 3, -1));
+                    cl::Buffer bufferA_out = bufferB;
+#else
+                    cl::Buffer bufferB = placement::createBuffer(*config.context, CL_MEM_READ_ONLY,
+                               buffer_size * sizeof(HOST_DATA_TYPE), config.programSettings->memoryBanks.bank(r, 1, 3, -1));
+                    cl::Buffer bufferA_out = placement::createBuffer(*config.context, CL_MEM_WRITE_ONLY,
+                                   buffer_size * sizeof(HOST_DATA_TYPE), config.programSettings->memoryBanks.bank(r, 2, 3, -1));
+#endif
+
+#ifdef INTEL_FPGA
+                    cl::Kernel transposeKernel(*config.program, ("transpose" + std::to_string(r)).c_str(), &err);
+#endif
+#ifdef XILINX_FPGA
+                    cl::Kernel transposeKernel(*config.program, ("transpose0:{transpose0_" + std::to_string(r + 1) + "}").c_str(), &err);
+#endif
+                    ASSERT_CL(err)
+
+                    // Ranks without partner transpose their own matrix A
+                    err = transposeKernel.setArg(0, (partner >= 0) ? receiveBufferListA.back()->getBuffer() : sendBufferListA.back()->getBuffer());
+                    ASSERT_CL(err)
+                    err = transposeKernel.setArg(1, bufferB);
+                    ASSERT_CL(err)
+#ifndef USE_INPLACE_TRANSPOSE
+                    err = transposeKernel.setArg(2, bufferA_out);
+                    ASSERT_CL(err)
+#endif
+                    err = transposeKernel.setArg(2 + KERNEL_OUTPUT_ARGS, static_cast<cl_uint>(blocks_per_replication));
+                    ASSERT_CL(err)
+
+                    cl::CommandQueue transQueue(*config.context, *config.device, 0, &err);
+                    ASSERT_CL(err)
+
+                    transCommandQueueList.push_back(transQueue);
+                    bufferListB.push_back(bufferB);
+                    bufferListA_out.push_back(bufferA_out);
+                    transposeKernelList.push_back(transposeKernel);
+                }
+
+                std::vector<double> transferTimings;
+                std::vector<double> calculationTimings;
+
+                for (int repetition = 0; repetition < config.programSettings->numRepetitions; repetition++)
+                {
+
+                    MPI_Barrier(config.communicator);
+
+                    auto startTransfer = std::chrono::high_resolution_clock::now();
+                    size_t bufferOffset = 0;
+
+                    for (int r = 0; r < transposeKernelList.size(); r++)
+                    {
+                        transCommandQueueList[r].enqueueWriteBuffer(bufferListB[r], CL_TRUE, 0,
+                                              bufferSizeList[r] * sizeof(HOST_DATA_TYPE), &data.B[bufferOffset]);
+                        // A is written directly to the mapped device memory
+                        std::copy(&data.A[bufferOffset], &data.A[bufferOffset] + bufferSizeList[r], sendBufferListA[r]->data<HOST_DATA_TYPE>());
+                        bufferOffset += bufferSizeList[r];
+                    }
+
+                    auto endTransfer = std::chrono::high_resolution_clock::now();
+                    std::chrono::duration<double> transferTime =
+                        std::chrono::duration_cast<std::chrono::duration<double>>(endTransfer - startTransfer);
+
+                    MPI_Barrier(config.communicator);
+
+                    auto startCalculation = std::chrono::high_resolution_clock::now();
+                    if (partner >= 0) {
+                        // Exchange A directly between the device memories of the partners.
+                        // The partner uses the same buffer layout, so the chunks match on both sides
+                        for (int r = 0; r < transposeKernelList.size(); r++)
+                        {
+                            HOST_DATA_TYPE* send_ptr = sendBufferListA[r]->data<HOST_DATA_TYPE>();
+                            HOST_DATA_TYPE* recv_ptr = receiveBufferListA[r]->data<HOST_DATA_TYPE>();
+                            for (size_t offset = 0; offset < bufferSizeList[r]; offset += INT_MAX) {
+                                int next_chunk = static_cast<int>(std::min(static_cast<size_t>(INT_MAX), bufferSizeList[r] - offset));
+                                MPI_Sendrecv(&send_ptr[offset], next_chunk, MPI_FLOAT, partner, r, &recv_ptr[offset], next_chunk, MPI_FLOAT, partner, r,
+                                                config.communicator, MPI_STATUS_IGNORE);
+                            }
+                        }
+                    }
+
+                    for (int r = 0; r < transposeKernelList.size(); r++)
+                    {
+                        transCommandQueueList[r].enqueueNDRangeKernel(transposeKernelList[r], cl::NullRange, cl::NDRange(1));
+                    }
+                    for (int r = 0; r < transposeKernelList.size(); r++)
+                    {
+                        transCommandQueueList[r].finish();
+                    }
+
+                    auto endCalculation = std::chrono::high_resolution_clock::now();
+#ifndef NDEBUG
+                    int mpi_rank;
+                    MPI_Comm_rank(config.communicator, &mpi_rank);
+                    std::cout << "Rank " << mpi_rank << ": "
+                          << "Done i=" << repetition << std::endl;
+#endif
+                    std::chrono::duration<double> calculationTime =
+                        std::chrono::duration_cast<std::chrono::duration<double>>(endCalculation - startCalculation);
+                    calculationTimings.push_back(calculationTime.count());
+
+                    bufferOffset = 0;
+                    startTransfer = std::chrono::high_resolution_clock::now();
+
+                    for (int r = 0; r < transposeKernelList.size(); r++)
+                    {
+                        transCommandQueueList[r].enqueueReadBuffer(bufferListA_out[r], CL_TRUE, 0,
+                                               bufferSizeList[r] * sizeof(HOST_DATA_TYPE), &data.result[bufferOffset]);
+                        bufferOffset += bufferSizeList[r];
+                    }
+
+                    endTransfer = std::chrono::high_resolution_clock::now();
+                    transferTime +=
+                        std::chrono::duration_cast<std::chrono::duration<double>>(endTransfer - startTransfer);
+                    transferTimings.push_back(transferTime.count());
+                }
+
+                std::unique_ptr<transpose::TransposeExecutionTimings> result(new transpose::TransposeExecutionTimings{
+                    transferTimings,
+                    calculationTimings});
+                return result;
+            }
+
+        } // namespace rdma
+    }
+}
+
+#endif // SRC_HOST_RDMA_EXECUTION_H_
@@ -27,6 +27,7 @@ SOFTWARE.
 #include "transpose_benchmark.hpp"
 
 /* C++ standard library headers */
+#include <cmath>
 #include <memory>
 #include <random>
 
@@ -35,20 +36,20 @@ SOFTWARE.
 #include "execution_types/execution_intel_pq.hpp"
 #include "execution_types/execution_pcie.hpp"
 #include "execution_types/execution_pcie_pq.hpp"
+#include "execution_types/execution_rdma.hpp"
 #include "execution_types/execution_cpu.hpp"
 #include "communication_types.hpp"
 
 #include "data_handlers/data_handler_types.h"
 #include "data_handlers/diagonal.hpp"
 #include "data_handlers/pq.hpp"
+#include "data_handlers/block_cyclic.hpp"
 
 #include "parameters.h"
 
 
 transpose::TransposeBenchmark::TransposeBenchmark(int argc, char* argv[]) : HpccFpgaBenchmark(argc, argv) {
-    if (setupBenchmark(argc, argv)) {
-        setTransposeDataHandler(executionSettings->programSettings->dataHandlerIdentifier);
-    }
+    setupBenchmark(argc, argv);
 }
 
 void
@@ -60,7 +61,12 @@ transpose::TransposeBenchmark::addAdditionalParseOptions(cxxopts::Options &optio
             cxxopts::value<uint>()->default_value(std::to_string(BLOCK_SIZE)))
         ("distribute-buffers", "Distribute buffers over memory banks. This will use three memory banks instead of one for a single kernel replication, but kernel replications may interfere. This is an Intel only attribute, since buffer placement is decided at compile time for Xilinx FPGAs.")
         ("handler", "Specify the used data handler that distributes the data over devices and memory banks",
-            cxxopts::value<std::string>()->default_value(DEFAULT_DIST_TYPE));
+            cxxopts::value<std::string>()->default_value(DEFAULT_DIST_TYPE))
+        ("pcie-chunk-size", "Number of matrix blocks that are exchanged as one chunk with the PCIe communication type. Chunks are read from the device, sent over MPI and written back to the device in a pipelined fashion. 0 disables the pipelining.",
+            cxxopts::value<uint>()->default_value("0"))
+        ("no-shared-memory", "Always exchange the matrix over MPI. By default, ranks on the same node directly access the matrix of their exchange partner in shared memory.")
+        ("cycle-size", "Number of matrix blocks in one dimension of a distribution block of the CYCLIC data handler",
+            cxxopts::value<uint>()->default_value("1"));
 }
 
 std::unique_ptr<transpose::TransposeExecutionTimings>
@@ -80,6 +86,7 @@ transpose::TransposeBenchmark::executeKernel(TransposeData &data) {
                                 else {
                                     return transpose::fpga_execution::pcie_pq::calculate(*executionSettings, data, *dataHandler);
                                 } break;
+        case hpcc_base::CommunicationType::rdma : return transpose::fpga_execution::rdma::calculate(*executionSettings, data, *dataHandler); break;
 #ifdef MKL_FOUND
         case hpcc_base::CommunicationType::cpu_only : return transpose::fpga_execution::cpu::calculate(*executionSettings, data, *dataHandler); break;
 #endif
@@ -98,12 +105,14 @@ transpose::TransposeBenchmark::collectAndPrintResults(const transpose::Transpose
 #ifdef _USE_MPI_
         // Copy the object variable to a local variable to make it accessible to the lambda function
         int mpi_size = mpi_comm_size;
-        MPI_Reduce(output.calculationTimings.data(), max_measures.data(), number_measurements, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
-        MPI_Reduce(output.transferTimings.data(), max_transfers.data(), number_measurements, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+        MPI_Reduce(output.calculationTimings.data(), max_measures.data(), number_measurements, MPI_DOUBLE, MPI_MAX, 0, executionSettings->communicator);
+        MPI_Reduce(output.transferTimings.data(), max_transfers.data(), number_measurements, MPI_DOUBLE, MPI_MAX, 0, executionSettings->communicator);
 #else
         std::copy(output.calculationTimings.begin(), output.calculationTimings.end(), max_measures.begin());
         std::copy(output.transferTimings.begin(), output.transferTimings.end(), max_transfers.begin());
 #endif
+    max_measures = discardWarmup(max_measures);
+    max_transfers = discardWarmup(max_transfers);
 
     double avgCalculationTime = accumulate(max_measures.begin(), max_measures.end(), 0.0)
                                 / max_measures.size();
@@ -124,6 +133,19 @@ transpose::TransposeBenchmark::collectAndPrintResults(const transpose::Transpose
 
 
     if (mpi_comm_rank == 0) {
+        timings.emplace("transfer", max_transfers);
+        timings.emplace("calculation", max_measures);
+        results.emplace("avg_transfer_time", hpcc_base::HpccResult(avgTransferTime, "s"));
+        results.emplace("min_transfer_time", hpcc_base::HpccResult(minTransferTime, "s"));
+        results.emplace("avg_calc_time", hpcc_base::HpccResult(avgCalculationTime, "s"));
+        results.emplace("min_calc_time", hpcc_base::HpccResult(minCalculationTime, "s"));
+        results.emplace("avg_calc_flops", hpcc_base::HpccResult(avgCalcFLOPS, "FLOP/s"));
+        results.emplace("max_calc_flops", hpcc_base::HpccResult(maxCalcFLOPS, "FLOP/s"));
+        results.emplace("avg_mem_bandwidth", hpcc_base::HpccResult(avgMemBandwidth, "B/s"));
+        results.emplace("max_mem_bandwidth", hpcc_base::HpccResult(maxMemBandwidth, "B/s"));
+        results.emplace("avg_transfer_bandwidth", hpcc_base::HpccResult(avgTransferBandwidth, "B/s"));
+        results.emplace("max_transfer_bandwidth", hpcc_base::HpccResult(maxTransferBandwidth, "B/s"));
+
         std::cout << "       total [s]     transfer [s]  calc [s]      calc FLOPS    Mem [B/s]     PCIe [B/s]" << std::endl;
         std::cout << "avg:   " << (avgTransferTime + avgCalculationTime)
                 << "   " << avgTransferTime
@@ -139,6 +161,8 @@ transpose::TransposeBenchmark::collectAndPrintResults(const transpose::Transpose
                 << "   " << maxMemBandwidth
                 << "   " << maxTransferBandwidth
                 << std::endl;
+        addStatistics("transfer_time", max_transfers);
+        addStatistics("calc_time", max_measures);
     }
 }
 
@@ -147,6 +171,54 @@ transpose::TransposeBenchmark::generateInputData() {
     return dataHandler->generateData(*executionSettings);
 }
 
+std::vector<memory_tracker::MemoryRequirement>
+transpose::TransposeBenchmark::estimateMemoryUsage() {
+    const auto &settings = *executionSettings->programSettings;
+    size_t matrix_bytes = static_cast<size_t>(settings.matrixSize) * settings.matrixSize * sizeof(HOST_DATA_TYPE);
+    size_t local_bytes = (matrix_bytes + mpi_comm_size - 1) / mpi_comm_size;
+    // The exchange buffer holds at most all local blocks
+    std::vector<memory_tracker::MemoryRequirement> requirements = {{"A, B, result, exchange", local_bytes, 4, false}};
+    if (settings.communicationType != hpcc_base::CommunicationType::cpu_only) {
+        requirements.push_back({"A, B, A_out", local_bytes, 3, true});
+    }
+    return requirements;
+}
+
+void
+transpose::TransposeBenchmark::adaptSettingsToBitstream() {
+    setTransposeDataHandler(executionSettings->programSettings->dataHandlerIdentifier);
+}
+
+std::vector<std::string>
+transpose::TransposeBenchmark::getRankScalingArguments(int ranks, bool weak) {
+    if (!weak) {
+        return {};
+    }
+    const auto &settings = *executionSettings->programSettings;
+    // Keep the number of matrix values per rank of the execution on all ranks
+    double blocks = static_cast<double>(settings.matrixSize / settings.blockSize) * std::sqrt(static_cast<double>(ranks) / mpi_comm_size);
+    uint scaled_blocks = static_cast<uint>(std::round(blocks));
+    if (scaled_blocks == 0 || std::abs(blocks - scaled_blocks) > 1.0e-6) {
+        throw std::runtime_error("The matrix size of " + std::to_string(settings.matrixSize / settings.blockSize)
+                                    + " blocks can not be scaled to " + std::to_string(ranks) + " ranks");
+    }
+    return {"-m", std::to_string(scaled_blocks)};
+}
+
+std::unique_ptr<transpose::TransposeData>
+transpose::TransposeBenchmark::allocateInputData() {
+    auto d = dataHandler->allocateData(*executionSettings);
+    // The result is not part of the cache, so it has to be reset here
+    std::fill(d->result, d->result + d->blockSize * d->blockSize * d->numBlocks, 0.0);
+    return d;
+}
+
+std::vector<hpcc_base::DataRegion>
+transpose::TransposeBenchmark::getInputDataRegions(transpose::TransposeData &data) {
+    size_t size = data.blockSize * data.blockSize * data.numBlocks * sizeof(HOST_DATA_TYPE);
+    return {{data.A, size}, {data.B, size}};
+}
+
 bool  
 transpose::TransposeBenchmark::validateOutputAndPrintError(transpose::TransposeData &data) {
 
@@ -156,12 +228,13 @@ transpose::TransposeBenchmark::validateOutputAndPrintError(transpose::TransposeD
     dataHandler->reference_transpose(data);
 
     double max_error = 0.0;
+#pragma omp parallel for reduction(max:max_error)
     for (size_t i = 0; i < executionSettings->programSettings->blockSize * executionSettings->programSettings->blockSize * data.numBlocks; i++) {
         max_error = std::max(fabs(data.A[i]), max_error);
     }
 
     double global_max_error = 0;
-    MPI_Reduce(&max_error, &global_max_error, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&max_error, &global_max_error, 1, MPI_DOUBLE, MPI_MAX, 0, executionSettings->communicator);
 
     if (mpi_comm_rank == 0) {
         std::cout << "Maximum error: " << global_max_error << " < " << 100 * std::numeric_limits<HOST_DATA_TYPE>::epsilon() <<  std::endl;
@@ -174,8 +247,10 @@ transpose::TransposeBenchmark::validateOutputAndPrintError(transpose::TransposeD
 void
 transpose::TransposeBenchmark::setTransposeDataHandler(transpose::data_handler::DataHandlerType dataHandlerIdentifier) {
     switch (dataHandlerIdentifier) {
-        case transpose::data_handler::DataHandlerType::diagonal: dataHandler = std::unique_ptr<transpose::data_handler::TransposeDataHandler>(new transpose::data_handler::DistributedDiagonalTransposeDataHandler(mpi_comm_rank, mpi_comm_size)); break;
-        case transpose::data_handler::DataHandlerType::pq: dataHandler = std::unique_ptr<transpose::data_handler::TransposeDataHandler>(new transpose::data_handler::DistributedPQTransposeDataHandler(mpi_comm_rank, mpi_comm_size)); break;
+        case transpose::data_handler::DataHandlerType::diagonal: dataHandler = std::unique_ptr<transpose::data_handler::TransposeDataHandler>(new transpose::data_handler::DistributedDiagonalTransposeDataHandler(mpi_comm_rank, mpi_comm_size, executionSettings->communicator)); break;
+        case transpose::data_handler::DataHandlerType::pq: dataHandler = std::unique_ptr<transpose::data_handler::TransposeDataHandler>(new transpose::data_handler::DistributedPQTransposeDataHandler(mpi_comm_rank, mpi_comm_size, 1, executionSettings->communicator)); break;
+        case transpose::data_handler::DataHandlerType::block_cyclic: dataHandler = std::unique_ptr<transpose::data_handler::TransposeDataHandler>(new transpose::data_handler::DistributedBlockCyclicTransposeDataHandler(mpi_comm_rank, mpi_comm_size,
+                                                                                                        executionSettings->programSettings->cycleSize, executionSettings->communicator)); break;
         default: throw std::runtime_error("Could not match selected data handler: " + transpose::data_handler::handlerToString(dataHandlerIdentifier));
     }
         
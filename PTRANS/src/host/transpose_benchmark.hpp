@@ -70,6 +70,51 @@ public:
     std::unique_ptr<TransposeData>
     generateInputData() override;
 
+    /**
+     * @brief Estimate the memory of the local matrix blocks on the host and on the device.
+     *          The matrix is assumed to be evenly distributed over all ranks.
+     * 
+     * @return std::vector<memory_tracker::MemoryRequirement> The estimated allocations of this rank
+     */
+    std::vector<memory_tracker::MemoryRequirement>
+    estimateMemoryUsage() override;
+
+    /**
+     * @brief Create the data handler of the settings for the communicator in the execution settings
+     * 
+     */
+    void
+    adaptSettingsToBitstream() override;
+
+    /**
+     * @brief Get the matrix size for a rank scaling. The matrix size is the total size, so it is kept for the strong scaling
+     *          and scaled with the square root of the number of ranks for the weak scaling.
+     * 
+     * @param ranks Number of ranks the benchmark will be executed on
+     * @param weak True for the weak scaling
+     * @return std::vector<std::string> The matrix size in blocks, if it has to be changed
+     * @throw std::runtime_error if the matrix size per rank can not be kept
+     */
+    std::vector<std::string>
+    getRankScalingArguments(int ranks, bool weak) override;
+
+    /**
+     * @brief Allocate the input data with the used data handler without initialization to load it from the data cache
+     * 
+     * @return std::unique_ptr<TransposeData> The allocated input and output data of the benchmark
+     */
+    std::unique_ptr<TransposeData>
+    allocateInputData() override;
+
+    /**
+     * @brief Get the memory regions of the matrices A and B that are stored in the data cache
+     * 
+     * @param data The input data
+     * @return std::vector<hpcc_base::DataRegion> The memory regions of the input data
+     */
+    std::vector<hpcc_base::DataRegion>
+    getInputDataRegions(TransposeData &data) override;
+
     /**
      * @brief Set the data handler object by calling the function with the matching template argument
      * 
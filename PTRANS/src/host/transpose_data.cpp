@@ -1,4 +1,5 @@
 #include <cmath>
+#include <algorithm>
 
 #include "transpose_data.hpp"
 #include "data_handlers/data_handler_types.h"
@@ -7,7 +8,8 @@
 transpose::TransposeProgramSettings::TransposeProgramSettings(cxxopts::ParseResult &results) : hpcc_base::BaseSettings(results),
     matrixSize(results["m"].as<uint>() * results["b"].as<uint>()),
     blockSize(results["b"].as<uint>()), dataHandlerIdentifier(transpose::data_handler::stringToHandler(results["handler"].as<std::string>())),
-    distributeBuffers(results["distribute-buffers"].count() > 0) {
+    distributeBuffers(results["distribute-buffers"].count() > 0), pcieChunkSize(results["pcie-chunk-size"].as<uint>()),
+    useSharedMemory(results.count("no-shared-memory") == 0), cycleSize(results["cycle-size"].as<uint>()) {
 
         // auto detect data distribution type if required
         if (dataHandlerIdentifier == transpose::data_handler::DataHandlerType::automatic) {
@@ -26,19 +28,32 @@ transpose::TransposeProgramSettings::TransposeProgramSettings(cxxopts::ParseResu
 std::map<std::string, std::string>
 transpose::TransposeProgramSettings::getSettingsMap() {
         auto map = hpcc_base::BaseSettings::getSettingsMap();
-        int mpi_size;
-#ifdef _USE_MPI_
-        MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
-#endif
+        int mpi_size = std::max(mpiRanks, 1);
         map["Matrix Size"] = std::to_string(matrixSize * static_cast<int>(std::sqrt(mpi_size)));
         map["Block Size"] = std::to_string(blockSize);
         map["Dist. Buffers"] = distributeBuffers ? "Yes" : "No";
         map["Data Handler"] = transpose::data_handler::handlerToString(dataHandlerIdentifier);
+        map["PCIe Chunk Size"] = (pcieChunkSize > 0) ? std::to_string(pcieChunkSize) + " blocks" : "No pipelining";
+        map["Shared Memory"] = useSharedMemory ? "Yes" : "No";
+        if (dataHandlerIdentifier == transpose::data_handler::DataHandlerType::block_cyclic) {
+            map["Cycle Size"] = std::to_string(cycleSize) + " blocks";
+        }
         return map;
 }
 
-transpose::TransposeData::TransposeData(cl::Context context, uint block_size, uint y_size) : context(context), 
-                                                                                numBlocks(y_size), blockSize(block_size) {
+transpose::TransposeData::TransposeData(cl::Context context, uint block_size, uint y_size, MPI_Comm shared_comm) : context(context), 
+                                                                                numBlocks(y_size), blockSize(block_size),
+#ifdef USE_INPLACE_TRANSPOSE
+                                                                                exchangeBlocks(std::min(static_cast<size_t>(y_size), static_cast<size_t>(INPLACE_EXCHANGE_BLOCKS))) {
+#else
+                                                                                exchangeBlocks(y_size) {
+#endif
+#ifndef USE_SVM
+    if (shared_comm != MPI_COMM_NULL) {
+        // All ranks of the node have to take part in the allocation, even if they do not store any blocks
+        sharedA.reset(new shared_memory::NodeSharedBuffer(shared_comm, sizeof(HOST_DATA_TYPE) * block_size * block_size * y_size));
+    }
+#endif
     if (numBlocks * blockSize > 0) {
 #ifdef USE_SVM
         A = reinterpret_cast<HOST_DATA_TYPE*>(
@@ -52,16 +67,21 @@ transpose::TransposeData::TransposeData(cl::Context context, uint block_size, ui
                             block_size * block_size * y_size * sizeof(HOST_DATA_TYPE), 1024));
         exchange = reinterpret_cast<HOST_DATA_TYPE*>(
                             clSVMAlloc(context(), 0 ,
-                            block_size * block_size * y_size * sizeof(HOST_DATA_TYPE), 1024));
+                            block_size * block_size * exchangeBlocks * sizeof(HOST_DATA_TYPE), 1024));
 #else
-        posix_memalign(reinterpret_cast<void **>(&A), 64,
-                    sizeof(HOST_DATA_TYPE) * block_size * block_size * y_size);
-        posix_memalign(reinterpret_cast<void **>(&B), 64,
-                    sizeof(HOST_DATA_TYPE) * block_size * block_size * y_size);
-        posix_memalign(reinterpret_cast<void **>(&result), 64,
+        if (sharedA) {
+            A = sharedA->data<HOST_DATA_TYPE>();
+        }
+        else {
+            numa::memalign(reinterpret_cast<void **>(&A), 64,
+                        sizeof(HOST_DATA_TYPE) * block_size * block_size * y_size);
+        }
+        numa::memalign(reinterpret_cast<void **>(&B), 64,
                     sizeof(HOST_DATA_TYPE) * block_size * block_size * y_size);
-        posix_memalign(reinterpret_cast<void **>(&exchange), 64,
+        numa::memalign(reinterpret_cast<void **>(&result), 64,
                     sizeof(HOST_DATA_TYPE) * block_size * block_size * y_size);
+        numa::memalign(reinterpret_cast<void **>(&exchange), 64,
+                    sizeof(HOST_DATA_TYPE) * block_size * block_size * exchangeBlocks);
 #endif
     }
 }
@@ -74,10 +94,17 @@ transpose::TransposeData::~TransposeData() {
         clSVMFree(context(), reinterpret_cast<void*>(result));});
         clSVMFree(context(), reinterpret_cast<void*>(exchange));});
 #else
-        free(A);
-        free(B);
-        free(result);
-        free(exchange);
+        if (sharedA) {
+            // A and the exchange buffer are swapped by an exchange over MPI and A may point to the segment
+            // of the partner after an exchange over shared memory. Only the buffer outside of the shared memory is freed.
+            numa::free(sharedA->isLocalSegment(exchange) ? A : exchange);
+        }
+        else {
+            numa::free(A);
+            numa::free(exchange);
+        }
+        numa::free(B);
+        numa::free(result);
 #endif
     }
 }
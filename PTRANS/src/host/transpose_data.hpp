@@ -28,6 +28,7 @@ SOFTWARE.
 
 /* Project's headers */
 #include "hpcc_benchmark.hpp"
+#include "shared_memory.hpp"
 #include "data_handlers/data_handler_types.h"
 
 
@@ -37,6 +38,17 @@ SOFTWARE.
  */
 namespace transpose {
 
+/**
+ * @brief Number of output buffer arguments of the transpose kernels. The in-place kernels write the result into the
+ *          buffer of B, so the following kernel arguments are shifted.
+ * 
+ */
+#ifdef USE_INPLACE_TRANSPOSE
+const int KERNEL_OUTPUT_ARGS = 0;
+#else
+const int KERNEL_OUTPUT_ARGS = 1;
+#endif
+
 /**
  * @brief The Transpose specific program settings
  * 
@@ -68,6 +80,24 @@ public:
      */
     bool distributeBuffers;
 
+    /**
+     * @brief Number of matrix blocks that are transferred as one chunk in the pipelined PCIe data exchange.
+     *          If 0, the data exchange of the PCIe communication type is not pipelined.
+     */
+    uint pcieChunkSize;
+
+    /**
+     * @brief If true, the matrix A is exchanged over shared memory with exchange partners on the same node
+     * 
+     */
+    bool useSharedMemory;
+
+    /**
+     * @brief Number of matrix blocks in one dimension of a distribution block of the block-cyclic data handler
+     * 
+     */
+    uint cycleSize;
+
     /**
      * @brief Construct a new Transpose Program Settings object
      * 
@@ -110,7 +140,8 @@ public:
     HOST_DATA_TYPE* result;
 
     /**
-     * @brief Data buffer used during data exchange of matrices
+     * @brief Data buffer used during data exchange of matrices.
+     *          If USE_INPLACE_TRANSPOSE is defined, it only contains a ring of exchangeBlocks blocks.
      * 
      */
     HOST_DATA_TYPE* exchange;
@@ -128,6 +159,19 @@ public:
      */
     const size_t blockSize;
 
+    /**
+     * @brief Number of matrix blocks that are stored in the exchange buffer
+     * 
+     */
+    const size_t exchangeBlocks;
+
+    /**
+     * @brief Shared memory that contains A of all ranks on the same node. It is only used, if A is exchanged over shared memory.
+     *          In this case, data.A points to the segment of the exchange partner after an odd number of exchanges.
+     * 
+     */
+    std::unique_ptr<shared_memory::NodeSharedBuffer> sharedA;
+
     /**
      * @brief The context that is used to allocate memory in SVM mode
      * 
@@ -140,8 +184,35 @@ public:
      * @param context Context that is used to allocate memory for SVM
      * @param block_size size of the quadratic blocks that are stored within this object
      * @param y_size number of blocks that are stored within this object per replication
+     * @param shared_comm If not MPI_COMM_NULL, A is allocated in shared memory of all ranks of this communicator
+     *                      on the same node. This is a collective operation of the communicator. Not supported with SVM.
+     */
+    TransposeData(cl::Context context, uint block_size, uint size_y, MPI_Comm shared_comm = MPI_COMM_NULL);
+
+    /**
+     * @brief Check, if the matrix A can be exchanged with a rank over shared memory
+     * 
+     * @param rank The MPI rank of the exchange partner
+     * @return true if A of the rank can be accessed directly
+     */
+    bool
+    isSharedWith(int rank) const {
+        return sharedA && sharedA->isShared(rank);
+    }
+
+    /**
+     * @brief Get the current matrix A of an exchange partner on the same node.
+     *          Both ranks have to exchange their matrices the same number of times, so A of the partner can
+     *          be derived from the local A.
+     * 
+     * @param rank The MPI rank of the exchange partner
+     * @return HOST_DATA_TYPE* Pointer to the matrix A of the partner
      */
-    TransposeData(cl::Context context, uint block_size, uint size_y);
+    HOST_DATA_TYPE*
+    getSharedA(int rank) {
+        HOST_DATA_TYPE* local = sharedA->data<HOST_DATA_TYPE>();
+        return (A == local) ? sharedA->data<HOST_DATA_TYPE>(rank, 0) : local;
+    }
 
     /**
      * @brief Destroy the Transpose Data object. Free the allocated memory
@@ -0,0 +1,36 @@
+/*
+Microbenchmarks of the host reference transpose of PTRANS that is used for the validation by all data handlers.
+The size argument is the width of the square matrix. The benchmarks are executed for multiple numbers of OpenMP threads.
+*/
+#include <random>
+#include <vector>
+
+#include "reference_benchmark.hpp"
+#include "data_handlers/handler.hpp"
+#include "parameters.h"
+
+static void
+BM_reference_transpose(benchmark::State &state) {
+    reference_benchmark::setThreads(state);
+    size_t n = static_cast<size_t>(state.range(0));
+    std::vector<HOST_DATA_TYPE> a(n * n);
+    std::vector<HOST_DATA_TYPE> b(n * n);
+    std::vector<HOST_DATA_TYPE> result(n * n);
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<HOST_DATA_TYPE> dis(-1.0, 1.0);
+    for (size_t i = 0; i < n * n; i++) {
+        a[i] = dis(gen);
+        b[i] = dis(gen);
+        result[i] = dis(gen);
+    }
+    for (auto _ : state) {
+        // This is the transpose executed by the reference_transpose() of the PQ data handler on a single rank
+        transpose::data_handler::transposeAndSubtract(a.data(), b.data(), result.data(), n, n, 1);
+        benchmark::DoNotOptimize(a.data());
+        benchmark::ClobberMemory();
+    }
+    // A is read and written, B and the result are read
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * 4 * n * n * sizeof(HOST_DATA_TYPE));
+}
+
+REFERENCE_BENCHMARK(BM_reference_transpose, 1024, 4096, 8192, 16384);
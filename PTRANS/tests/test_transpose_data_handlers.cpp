@@ -7,6 +7,8 @@
 #include "gmock/gmock-matchers.h"
 #include "transpose_benchmark.hpp"
 #include "data_handlers/diagonal.hpp"
+#include "data_handlers/pq.hpp"
+#include "data_handlers/block_cyclic.hpp"
 
 
 struct TransposeHandlersTest : testing::Test {
@@ -225,3 +227,301 @@ TEST_F(TransposeHandlersTest, GenerateInputDataInRangeDistDiagMultipleBlocks) {
 }
 
 
+/**
+ * Check if a single rank does not need to exchange data with another rank
+ */
+TEST_F(TransposeHandlersTest, DistDiagNoExchangePartnerForSingleRank) {
+    auto handler = transpose::data_handler::DistributedDiagonalTransposeDataHandler(0,1);
+    bm->getExecutionSettings().programSettings->blockSize = 4;
+    bm->getExecutionSettings().programSettings->matrixSize = 4;
+    handler.generateData(bm->getExecutionSettings());
+    EXPECT_EQ(handler.getExchangePartner(), -1);
+}
+
+/**
+ * Check if the asynchronous exchange of the PQ handler splits the matrix into block rows
+ */
+TEST_F(TransposeHandlersTest, PQAsyncExchangeUsesBlockRowSegments) {
+    auto handler = transpose::data_handler::DistributedPQTransposeDataHandler(0,1);
+    bm->getExecutionSettings().programSettings->blockSize = 4;
+    bm->getExecutionSettings().programSettings->matrixSize = 4*2;
+    auto data = handler.generateData(bm->getExecutionSettings());
+    HOST_DATA_TYPE* original_A = data->A;
+    handler.beginExchangeData(*data);
+    auto segments = handler.getExchangeSegments();
+    ASSERT_EQ(segments.size(), 2);
+    EXPECT_EQ(segments[0].offset, 0);
+    EXPECT_EQ(segments[0].size, 2 * 4 * 4);
+    EXPECT_EQ(segments[1].offset, 2 * 4 * 4);
+    std::vector<int> received;
+    EXPECT_TRUE(handler.pollExchangeData(received));
+    EXPECT_EQ(received.size(), 2);
+    // Rank is on the diagonal, so the local data is used
+    EXPECT_EQ(handler.getReceiveBuffer(*data), original_A);
+    handler.completeExchangeData(*data);
+    EXPECT_EQ(data->A, original_A);
+}
+
+/**
+ * Handler that gives access to the ring exchange for testing
+ */
+class RingExchangeTestHandler : public transpose::data_handler::DistributedDiagonalTransposeDataHandler {
+public:
+    RingExchangeTestHandler() : transpose::data_handler::DistributedDiagonalTransposeDataHandler(0, 1) {}
+
+    void
+    exchangeWithSelf(transpose::TransposeData& data) {
+        exchangeDataInRing(data, 0);
+    }
+};
+
+/**
+ * Check if the exchange over a ring of segments keeps the order of the matrix blocks
+ */
+TEST_F(TransposeHandlersTest, RingExchangeWithSelfKeepsMatrix) {
+    RingExchangeTestHandler handler;
+    bm->getExecutionSettings().programSettings->blockSize = 4;
+    bm->getExecutionSettings().programSettings->matrixSize = 4 * 5;
+    auto data = handler.generateData(bm->getExecutionSettings());
+    std::vector<HOST_DATA_TYPE> original(data->A, data->A + data->numBlocks * 4 * 4);
+    HOST_DATA_TYPE* original_A = data->A;
+    handler.exchangeWithSelf(*data);
+    EXPECT_EQ(data->A, original_A);
+    EXPECT_EQ(std::vector<HOST_DATA_TYPE>(data->A, data->A + data->numBlocks * 4 * 4), original);
+}
+
+/**
+ * Check if the exchange over shared memory keeps the matrix and does not copy it
+ */
+TEST_F(TransposeHandlersTest, SharedMemoryExchangeWithSelfKeepsMatrix) {
+    RingExchangeTestHandler handler;
+    transpose::TransposeData data(*bm->getExecutionSettings().context, 4, 5, MPI_COMM_WORLD);
+    for (int i = 0; i < 5 * 4 * 4; i++) {
+        data.A[i] = static_cast<HOST_DATA_TYPE>(i);
+    }
+    ASSERT_TRUE(data.isSharedWith(0));
+    HOST_DATA_TYPE* original_A = data.A;
+    handler.exchangeWithSelf(data);
+    EXPECT_EQ(data.A, original_A);
+    for (int i = 0; i < 5 * 4 * 4; i++) {
+        EXPECT_FLOAT_EQ(data.A[i], static_cast<HOST_DATA_TYPE>(i));
+    }
+}
+
+/**
+ * Handler that uses the own rank as exchange partner to test the asynchronous exchange
+ */
+class AsyncExchangeTestHandler : public transpose::data_handler::DistributedDiagonalTransposeDataHandler {
+public:
+    AsyncExchangeTestHandler() : transpose::data_handler::DistributedDiagonalTransposeDataHandler(0, 1) {}
+
+    int
+    getExchangePartner() override {
+        return 0;
+    }
+};
+
+/**
+ * Check if the asynchronous exchange reports every segment exactly once and keeps the matrix
+ */
+TEST_F(TransposeHandlersTest, AsyncExchangeWithSelfReportsEverySegmentOnce) {
+    AsyncExchangeTestHandler handler;
+    bm->getExecutionSettings().programSettings->blockSize = 2;
+    bm->getExecutionSettings().programSettings->matrixSize = 2 * 4;
+    auto data = handler.generateData(bm->getExecutionSettings());
+    ASSERT_TRUE(handler.isAsynchronousExchangeSupported(*data));
+    std::vector<HOST_DATA_TYPE> original(data->A, data->A + data->numBlocks * 2 * 2);
+    handler.beginExchangeData(*data);
+    EXPECT_EQ(handler.getExchangeSegments().size(), transpose::data_handler::ASYNC_EXCHANGE_SEGMENTS);
+    std::vector<int> received;
+    while (!handler.pollExchangeData(received)) {}
+    std::sort(received.begin(), received.end());
+    ASSERT_EQ(received.size(), handler.getExchangeSegments().size());
+    for (int i = 0; i < received.size(); i++) {
+        EXPECT_EQ(received[i], i);
+    }
+    std::vector<int> after_completion;
+    EXPECT_TRUE(handler.pollExchangeData(after_completion));
+    EXPECT_TRUE(after_completion.empty());
+    handler.completeExchangeData(*data);
+    EXPECT_EQ(std::vector<HOST_DATA_TYPE>(data->A, data->A + data->numBlocks * 2 * 2), original);
+}
+
+/**
+ * Check if the PQ handler selects a grid with P <= Q that is as square as possible
+ */
+TEST_F(TransposeHandlersTest, PQGridIsCreatedForNonSquareRankCounts) {
+    for (auto grid : std::vector<std::vector<int>>{{1, 1, 1}, {6, 2, 3}, {8, 2, 4}, {9, 3, 3}, {32, 4, 8}, {7, 1, 7}}) {
+        auto handler = transpose::data_handler::DistributedPQTransposeDataHandler(0, grid[0]);
+        EXPECT_EQ(handler.getP(), grid[1]);
+        EXPECT_EQ(handler.getQ(), grid[2]);
+    }
+}
+
+/**
+ * Check if the allocation fails, if the matrix can not be distributed over the grid
+ */
+TEST_F(TransposeHandlersTest, PQAllocationFailsIfWidthNotDivisibleByGrid) {
+    auto handler = transpose::data_handler::DistributedPQTransposeDataHandler(0, 6);
+    bm->getExecutionSettings().programSettings->blockSize = 2;
+    bm->getExecutionSettings().programSettings->matrixSize = 2 * 4;
+    EXPECT_THROW(handler.allocateData(bm->getExecutionSettings()), std::runtime_error);
+}
+
+/**
+ * Simulate the exchange of a 2x3 grid and check if every rank receives the blocks of A it needs for the local transposition
+ */
+TEST_F(TransposeHandlersTest, PQRectangularExchangePatternIsCorrect) {
+    const int mpi_size = 6;
+    const int P = 2;
+    const int Q = 3;
+    const int width_in_blocks = 12;
+    bm->getExecutionSettings().programSettings->blockSize = 1;
+    bm->getExecutionSettings().programSettings->matrixSize = width_in_blocks;
+    std::vector<std::unique_ptr<transpose::data_handler::DistributedPQTransposeDataHandler>> handlers;
+    for (int r = 0; r < mpi_size; r++) {
+        handlers.emplace_back(new transpose::data_handler::DistributedPQTransposeDataHandler(r, mpi_size));
+        auto data = handlers[r]->allocateData(bm->getExecutionSettings());
+        EXPECT_EQ(data->numBlocks, (width_in_blocks / P) * (width_in_blocks / Q));
+        EXPECT_EQ(handlers[r]->getHeightPerRank(), width_in_blocks / P);
+        EXPECT_EQ(handlers[r]->getWidthPerRank(), width_in_blocks / Q);
+    }
+    // Local matrices that contain the global index of every block
+    std::vector<std::vector<int>> local_a(mpi_size, std::vector<int>((width_in_blocks / P) * (width_in_blocks / Q)));
+    std::vector<std::vector<int>> exchanged_a(mpi_size, std::vector<int>(local_a[0].size(), -1));
+    for (int i = 0; i < width_in_blocks; i++) {
+        for (int j = 0; j < width_in_blocks; j++) {
+            local_a[(i % P) * Q + j % Q][(i / P) * (width_in_blocks / Q) + j / Q] = i * width_in_blocks + j;
+        }
+    }
+    for (int src = 0; src < mpi_size; src++) {
+        for (int dst = 0; dst < mpi_size; dst++) {
+            auto& send = handlers[src]->getSendBlocks(dst);
+            auto& recv = handlers[dst]->getReceiveBlocks(src);
+            ASSERT_EQ(send.size(), recv.size());
+            for (size_t b = 0; b < send.size(); b++) {
+                exchanged_a[dst][recv[b]] = local_a[src][send[b]];
+            }
+        }
+    }
+    for (int r = 0; r < mpi_size; r++) {
+        int p = r / Q;
+        int q = r % Q;
+        // The transposed layout of A has the width of the local matrix height
+        for (int row = 0; row < width_in_blocks / Q; row++) {
+            for (int col = 0; col < width_in_blocks / P; col++) {
+                EXPECT_EQ(exchanged_a[r][row * (width_in_blocks / P) + col], (row * Q + q) * width_in_blocks + col * P + p);
+            }
+        }
+    }
+}
+
+/**
+ * Check if the allocation fails, if the matrix can not be split into distribution blocks of the cycle size for the grid
+ */
+TEST_F(TransposeHandlersTest, BlockCyclicAllocationFailsIfWidthNotDivisibleByCycle) {
+    auto handler = transpose::data_handler::DistributedBlockCyclicTransposeDataHandler(0, 4, 2);
+    bm->getExecutionSettings().programSettings->blockSize = 1;
+    bm->getExecutionSettings().programSettings->matrixSize = 6;
+    EXPECT_THROW(handler.allocateData(bm->getExecutionSettings()), std::runtime_error);
+    bm->getExecutionSettings().programSettings->matrixSize = 8;
+    EXPECT_NO_THROW(handler.allocateData(bm->getExecutionSettings()));
+    EXPECT_THROW(transpose::data_handler::DistributedBlockCyclicTransposeDataHandler(0, 4, 0), std::runtime_error);
+}
+
+/**
+ * Simulate the exchange of a 2x3 grid with a cycle size of 2 and check if every rank receives the blocks of A it needs for the local transposition
+ */
+TEST_F(TransposeHandlersTest, BlockCyclicRectangularExchangePatternIsCorrect) {
+    const int mpi_size = 6;
+    const int P = 2;
+    const int Q = 3;
+    const int c = 2;
+    const int width_in_blocks = 12;
+    bm->getExecutionSettings().programSettings->blockSize = 1;
+    bm->getExecutionSettings().programSettings->matrixSize = width_in_blocks;
+    std::vector<std::unique_ptr<transpose::data_handler::DistributedBlockCyclicTransposeDataHandler>> handlers;
+    for (int r = 0; r < mpi_size; r++) {
+        handlers.emplace_back(new transpose::data_handler::DistributedBlockCyclicTransposeDataHandler(r, mpi_size, c));
+        auto data = handlers[r]->allocateData(bm->getExecutionSettings());
+        EXPECT_EQ(data->numBlocks, (width_in_blocks / P) * (width_in_blocks / Q));
+    }
+    // Local index of a global block row or column in a grid dimension of the given size
+    auto local = [c](int global, int grid) {
+        return (global / (c * grid)) * c + global % c;
+    };
+    // Local matrices that contain the global index of every block
+    std::vector<std::vector<int>> local_a(mpi_size, std::vector<int>((width_in_blocks / P) * (width_in_blocks / Q)));
+    std::vector<std::vector<int>> exchanged_a(mpi_size, std::vector<int>(local_a[0].size(), -1));
+    for (int i = 0; i < width_in_blocks; i++) {
+        for (int j = 0; j < width_in_blocks; j++) {
+            local_a[((i / c) % P) * Q + (j / c) % Q][local(i, P) * (width_in_blocks / Q) + local(j, Q)] = i * width_in_blocks + j;
+        }
+    }
+    for (int src = 0; src < mpi_size; src++) {
+        for (int dst = 0; dst < mpi_size; dst++) {
+            auto& send = handlers[src]->getSendBlocks(dst);
+            auto& recv = handlers[dst]->getReceiveBlocks(src);
+            ASSERT_EQ(send.size(), recv.size());
+            for (size_t b = 0; b < send.size(); b++) {
+                exchanged_a[dst][recv[b]] = local_a[src][send[b]];
+            }
+        }
+    }
+    // The rank that calculates the result block (j,i) has to hold block (i,j) of A in the transposed layout
+    for (int i = 0; i < width_in_blocks; i++) {
+        for (int j = 0; j < width_in_blocks; j++) {
+            int r = ((j / c) % P) * Q + (i / c) % Q;
+            EXPECT_EQ(exchanged_a[r][local(i, Q) * (width_in_blocks / P) + local(j, P)], i * width_in_blocks + j);
+        }
+    }
+}
+
+/**
+ * Check if the reference transpose also works for rectangular matrices
+ */
+TEST(TransposeReferenceTest, TiledTransposeMatchesNaiveImplementationForRectangularMatrices) {
+    const size_t height = 5;
+    const size_t width = transpose::data_handler::REFERENCE_TILE_WIDTH + 9;
+    std::vector<HOST_DATA_TYPE> a(height * width), b(height * width), result(height * width);
+    for (size_t i = 0; i < a.size(); i++) {
+        a[i] = static_cast<HOST_DATA_TYPE>(i % 13);
+        b[i] = static_cast<HOST_DATA_TYPE>(i % 7);
+        result[i] = static_cast<HOST_DATA_TYPE>(i % 3);
+    }
+    std::vector<HOST_DATA_TYPE> expected(a);
+    for (size_t i = 0; i < height; i++) {
+        for (size_t j = 0; j < width; j++) {
+            expected[j * height + i] -= (result[i * width + j] - b[i * width + j]);
+        }
+    }
+    transpose::data_handler::transposeAndSubtract(a.data(), b.data(), result.data(), height, width, 1);
+    EXPECT_EQ(a, expected);
+}
+
+/**
+ * Check if the tiled reference transpose matches the naive implementation also for widths that are not a multiple of the tile width
+ */
+TEST(TransposeReferenceTest, TiledTransposeMatchesNaiveImplementation) {
+    const size_t tile = transpose::data_handler::REFERENCE_TILE_WIDTH;
+    for (size_t width : {static_cast<size_t>(1), static_cast<size_t>(7), tile, 2 * tile + 3}) {
+        const size_t count = 3;
+        const size_t size = width * width * count;
+        std::vector<HOST_DATA_TYPE> a(size), b(size), result(size);
+        for (size_t i = 0; i < size; i++) {
+            a[i] = static_cast<HOST_DATA_TYPE>(i % 17);
+            b[i] = static_cast<HOST_DATA_TYPE>(i % 5);
+            result[i] = static_cast<HOST_DATA_TYPE>(i % 11);
+        }
+        std::vector<HOST_DATA_TYPE> expected(a);
+        for (size_t m = 0; m < count; m++) {
+            for (size_t i = 0; i < width; i++) {
+                for (size_t j = 0; j < width; j++) {
+                    expected[m * width * width + j * width + i] -= (result[m * width * width + i * width + j] - b[m * width * width + i * width + j]);
+                }
+            }
+        }
+        transpose::data_handler::transposeAndSubtract(a.data(), b.data(), result.data(), width, count);
+        EXPECT_EQ(a, expected);
+    }
+}
@@ -22,6 +22,10 @@ SOFTWARE.
 
 #include "parameters.h"
 
+// Every replication of the accessMemory kernel gets its own counter slot
+#define KERNEL_COUNTER_SLOTS /*PY_CODE_GEN num_replications*/
+#include "kernel_counters.h"
+
 /*
 Constant used to update the pseudo random number
 */
@@ -53,6 +57,7 @@ to the kernel.
 @param m  the size of the data array
 @param data_chunk  the chunk size that has to be updated by the kernel
 @param kernel_number Number of the kernel that defines the offset of the data chunk to the total data array
+@param kernel_counters Only with USE_KERNEL_COUNTERS: Buffer the device side counters are accumulated in
 */
 __attribute__((max_global_work_dim(0),uses_global_work_offset(0)))
 __kernel
@@ -61,7 +66,10 @@ void accessMemory_/*PY_CODE_GEN i*/(__global /*PY_CODE_GEN kernel_param_attribut
                         const DEVICE_DATA_TYPE_UNSIGNED m,
                         const DEVICE_DATA_TYPE_UNSIGNED data_chunk,
                         const uint num_cache_operations,
-                        const uint kernel_number) {
+                        const uint kernel_number
+                        KERNEL_COUNTERS_ARG) {
+
+    KERNEL_COUNTERS_START(/*PY_CODE_GEN i*/)
 
     // Initiate the pseudo random number generators
     DEVICE_DATA_TYPE_UNSIGNED ran_initials[CONCURRENT_GEN/BLOCK_SIZE][BLOCK_SIZE];
@@ -120,6 +128,13 @@ void accessMemory_/*PY_CODE_GEN i*/(__global /*PY_CODE_GEN kernel_param_attribut
         DEVICE_DATA_TYPE_UNSIGNED local_address_buffer[BUFFER_SIZE];
         DEVICE_DATA_TYPE_UNSIGNED loaded_data_buffer[BUFFER_SIZE];
 
+#if defined(INTEL_FPGA) && defined(HPCC_FPGA_RA_INTEL_USE_PRAGMA_IVDEP)
+        // The inner loop is unrolled, so one iteration of the outer loop is started per cycle
+        KERNEL_COUNTERS_ACTIVE(1)
+#else
+        KERNEL_COUNTERS_ACTIVE(2 * BUFFER_SIZE)
+#endif
+
 #ifdef INTEL_FPGA
 #ifdef HPCC_FPGA_RA_INTEL_USE_PRAGMA_IVDEP
         __attribute__((opencl_unroll_hint(2*BUFFER_SIZE)))
@@ -188,6 +203,68 @@ void accessMemory_/*PY_CODE_GEN i*/(__global /*PY_CODE_GEN kernel_param_attribut
             }
         }
     }
+    KERNEL_COUNTERS_END(/*PY_CODE_GEN i*/)
+}
+
+/*
+Kernel that generates a part of the pseudo random update sequence for the distributed execution.
+The updates are not applied to the data array, but written to global memory, so the host can
+forward them to the rank that owns the updated address.
+Every RNG calculates a contiguous part of the sequence. The state of the RNGs is stored back
+after the execution, so the next part of the sequence can be generated with the next kernel execution.
+
+@param updates The array the generated updates are written to. Value i of RNG r is stored at i * CONCURRENT_GEN + r
+@param random_state The current values of the RNGs. They are updated by the kernel
+@param updates_per_rng The number of updates that are generated by every RNG
+*/
+__attribute__((max_global_work_dim(0),uses_global_work_offset(0)))
+__kernel
+void generateUpdates_/*PY_CODE_GEN i*/(__global /*PY_CODE_GEN kernel_param_attributes[i]*/ DEVICE_DATA_TYPE_UNSIGNED * restrict updates,
+                        __global /*PY_CODE_GEN kernel_param_attributes[i]*/ DEVICE_DATA_TYPE_UNSIGNED * restrict random_state,
+                        const DEVICE_DATA_TYPE_UNSIGNED updates_per_rng) {
+
+    DEVICE_DATA_TYPE_UNSIGNED ran[CONCURRENT_GEN];
+    __attribute__((opencl_unroll_hint(CONCURRENT_GEN)))
+    for (int r = 0; r < CONCURRENT_GEN; r++) {
+        ran[r] = random_state[r];
+    }
+
+    for (DEVICE_DATA_TYPE_UNSIGNED i = 0; i < updates_per_rng; i++) {
+        __attribute__((opencl_unroll_hint(CONCURRENT_GEN)))
+        for (int r = 0; r < CONCURRENT_GEN; r++) {
+            DEVICE_DATA_TYPE_UNSIGNED v = ((DEVICE_DATA_TYPE) ran[r] < 0) ? POLY : 0UL;
+            ran[r] = (ran[r] << 1) ^ v;
+            updates[i * CONCURRENT_GEN + r] = ran[r];
+        }
+    }
+
+    __attribute__((opencl_unroll_hint(CONCURRENT_GEN)))
+    for (int r = 0; r < CONCURRENT_GEN; r++) {
+        random_state[r] = ran[r];
+    }
+}
+
+/*
+Kernel that applies updates that were received from other ranks to the local part of the data array
+in the distributed execution. All updates have to target the data chunk of this kernel.
+
+@param data The local chunk of the data array that will be updated
+@param updates The updates that will be applied to the data array
+@param update_count The number of updates in the update array
+@param data_chunk The size of the data chunk. It has to be a power of two.
+*/
+__attribute__((max_global_work_dim(0),uses_global_work_offset(0)))
+__kernel
+void applyUpdates_/*PY_CODE_GEN i*/(__global /*PY_CODE_GEN kernel_param_attributes[i]*/ DEVICE_DATA_TYPE_UNSIGNED  volatile * restrict data,
+                        __global /*PY_CODE_GEN kernel_param_attributes[i]*/ const DEVICE_DATA_TYPE_UNSIGNED * restrict updates,
+                        const DEVICE_DATA_TYPE_UNSIGNED update_count,
+                        const DEVICE_DATA_TYPE_UNSIGNED data_chunk) {
+
+    for (DEVICE_DATA_TYPE_UNSIGNED i = 0; i < update_count; i++) {
+        DEVICE_DATA_TYPE_UNSIGNED random_number = updates[i];
+        DEVICE_DATA_TYPE_UNSIGNED local_address = (random_number >> 3) & (data_chunk - 1);
+        data[local_address] ^= random_number;
+    }
 }
 
 // PY_CODE_GEN block_end
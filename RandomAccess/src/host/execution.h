@@ -43,6 +43,17 @@ namespace bm_execution {
 std::unique_ptr<random_access::RandomAccessExecutionTimings>
 calculate(hpcc_base::ExecutionSettings<random_access::RandomAccessProgramSettings> const& config, HOST_DATA_TYPE * data, int mpi_rank, int mpi_size);
 
+/**
+ * @brief This method will execute the random updates on the CPU using OpenMP and measure the execution time.
+ *          It is used as baseline with the communication type CPU and does not require a bitstream.
+ * 
+ * @param config The ExecutionSettings with the program settings
+ * @param data The data that is used as input and output of the random accesses
+ * @return std::unique_ptr<random_access::RandomAccessExecutionTimings> The measured runtimes of the updates
+ */
+std::unique_ptr<random_access::RandomAccessExecutionTimings>
+calculate_cpu(hpcc_base::ExecutionSettings<random_access::RandomAccessProgramSettings> const& config, HOST_DATA_TYPE * data, int mpi_rank, int mpi_size);
+
 }  // namespace bm_execution
 
 #endif  // SRC_HOST_EXECUTION_H_
@@ -0,0 +1,128 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* Related header files */
+#include "execution.h"
+
+/* C++ standard library headers */
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace bm_execution {
+
+    /*
+    Apply the update stream that is generated with the configured update pattern on the CPU.
+    Only the application of the updates is measured, the generation is excluded from the time.
+    */
+    std::unique_ptr<random_access::RandomAccessExecutionTimings>
+    calculate_cpu_pattern(hpcc_base::ExecutionSettings<random_access::RandomAccessProgramSettings> const& config, HOST_DATA_TYPE * data, int mpi_rank) {
+        auto generator = random_access::createUpdateGenerator(*config.programSettings, mpi_rank);
+        std::vector<HOST_DATA_TYPE> updates(std::min(static_cast<HOST_DATA_TYPE>(PATTERN_UPDATE_CHUNK_SIZE), generator->size()));
+        std::vector<HOST_DATA_TYPE> initial_data(data, data + config.programSettings->dataSize);
+        const HOST_DATA_TYPE address_mask = config.programSettings->dataSize - 1;
+
+        std::vector<double> executionTimes;
+        for (int i = 0; i < config.programSettings->numRepetitions; i++) {
+            std::copy(initial_data.begin(), initial_data.end(), data);
+            generator->reset();
+            double execution_time = 0.0;
+            size_t count;
+            while ((count = generator->generate(updates.data(), updates.size())) > 0) {
+                auto t1 = std::chrono::high_resolution_clock::now();
+#pragma omp parallel for
+                for (size_t u = 0; u < count; u++) {
+#pragma omp atomic
+                    data[(updates[u] >> 3) & address_mask] ^= updates[u];
+                }
+                std::chrono::duration<double> timespan = std::chrono::duration_cast<std::chrono::duration<double>>(
+                                                            std::chrono::high_resolution_clock::now() - t1);
+                execution_time += timespan.count();
+            }
+            executionTimes.push_back(execution_time);
+        }
+
+        return std::unique_ptr<random_access::RandomAccessExecutionTimings>(new random_access::RandomAccessExecutionTimings{executionTimes, {},
+                                                                    generator->size()});
+    }
+
+    /*
+    Execute the random updates with OpenMP on the CPU
+     @copydoc bm_execution::calculate_cpu()
+    */
+    std::unique_ptr<random_access::RandomAccessExecutionTimings>
+    calculate_cpu(hpcc_base::ExecutionSettings<random_access::RandomAccessProgramSettings> const& config, HOST_DATA_TYPE * data, int mpi_rank, int mpi_size) {
+        if (config.programSettings->distributed) {
+            std::cerr << "ERROR: The distributed random access is not supported by the CPU execution!" << std::endl;
+            return std::unique_ptr<random_access::RandomAccessExecutionTimings>(nullptr);
+        }
+        if (config.programSettings->updatePattern != random_access::UpdatePattern::hpcc) {
+            return calculate_cpu_pattern(config, data, mpi_rank);
+        }
+
+        // The update sequence is split into one chunk per RNG like on the FPGA and the chunks are processed in parallel
+        HOST_DATA_TYPE global_size = config.programSettings->dataSize * mpi_size;
+        HOST_DATA_TYPE local_offset = config.programSettings->dataSize * mpi_rank;
+        HOST_DATA_TYPE total_updates = 4L * global_size;
+        HOST_DATA_TYPE num_chunks = std::min(static_cast<HOST_DATA_TYPE>(config.programSettings->numRngs), total_updates);
+        HOST_DATA_TYPE updates_per_chunk = (total_updates + num_chunks - 1) / num_chunks;
+        std::vector<HOST_DATA_TYPE> start_values(num_chunks);
+        random_access::calculateRandomStartValues(start_values.data(), num_chunks, updates_per_chunk);
+
+        // Every repetition starts with the initial data like the FPGA execution, which copies the data to the device
+        std::vector<HOST_DATA_TYPE> initial_data(data, data + config.programSettings->dataSize);
+
+        std::vector<double> executionTimes;
+        for (int i = 0; i < config.programSettings->numRepetitions; i++) {
+            std::copy(initial_data.begin(), initial_data.end(), data);
+            auto t1 = std::chrono::high_resolution_clock::now();
+#pragma omp parallel for schedule(dynamic)
+            for (HOST_DATA_TYPE c = 0; c < num_chunks; c++) {
+                HOST_DATA_TYPE temp = start_values[c];
+                HOST_DATA_TYPE chunk_end = std::min(total_updates, (c + 1) * updates_per_chunk);
+                for (HOST_DATA_TYPE u = c * updates_per_chunk; u < chunk_end; u++) {
+                    HOST_DATA_TYPE_SIGNED v = 0;
+                    if (((HOST_DATA_TYPE_SIGNED)temp) < 0) {
+                        v = POLY;
+                    }
+                    temp = (temp << 1) ^ v;
+                    HOST_DATA_TYPE address = ((temp >> 3) & (global_size - 1)) - local_offset;
+                    // Only the updates to the local part of the array are applied
+                    if (address < config.programSettings->dataSize) {
+#pragma omp atomic
+                        data[address] ^= temp;
+                    }
+                }
+            }
+            auto t2 = std::chrono::high_resolution_clock::now();
+            std::chrono::duration<double> timespan =
+                    std::chrono::duration_cast<std::chrono::duration<double>>
+                            (t2 - t1);
+            executionTimes.push_back(timespan.count());
+        }
+
+        return std::unique_ptr<random_access::RandomAccessExecutionTimings>(new random_access::RandomAccessExecutionTimings{executionTimes, {}, 4 * config.programSettings->dataSize});
+    }
+
+}  // namespace bm_execution
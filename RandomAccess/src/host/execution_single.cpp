@@ -24,8 +24,10 @@ SOFTWARE.
 #include "execution.h"
 
 /* C++ standard library headers */
+#include <algorithm>
 #include <chrono>
 #include <fstream>
+#include <iostream>
 #include <memory>
 #include <vector>
 
@@ -34,14 +36,30 @@ SOFTWARE.
 #include "CL/cl_ext_intelfpga.h"
 #endif
 
+/* Project's headers */
+#include "kernel_counters.hpp"
+
 namespace bm_execution {
 
+    std::unique_ptr<random_access::RandomAccessExecutionTimings>
+    calculate_distributed(hpcc_base::ExecutionSettings<random_access::RandomAccessProgramSettings> const& config, HOST_DATA_TYPE * data, int mpi_rank, int mpi_size);
+
+    std::unique_ptr<random_access::RandomAccessExecutionTimings>
+    calculate_pattern(hpcc_base::ExecutionSettings<random_access::RandomAccessProgramSettings> const& config, HOST_DATA_TYPE * data, int mpi_rank, int mpi_size);
+
     /*
     Implementation for the single kernel.
      @copydoc bm_execution::calculate()
     */
     std::unique_ptr<random_access::RandomAccessExecutionTimings>
     calculate(hpcc_base::ExecutionSettings<random_access::RandomAccessProgramSettings> const& config, HOST_DATA_TYPE * data, int mpi_rank, int mpi_size) {
+        if (config.programSettings->distributed) {
+            return calculate_distributed(config, data, mpi_rank, mpi_size);
+        }
+        if (config.programSettings->updatePattern != random_access::UpdatePattern::hpcc) {
+            return calculate_pattern(config, data, mpi_rank, mpi_size);
+        }
+
         // int used to check for OpenCL errors
         int err;
 
@@ -54,36 +72,21 @@ namespace bm_execution {
         HOST_DATA_TYPE* random_inits;
         posix_memalign(reinterpret_cast<void**>(&random_inits), 4096, sizeof(HOST_DATA_TYPE)*config.programSettings->numRngs);
         HOST_DATA_TYPE chunk = config.programSettings->dataSize * mpi_size * 4 / std::min(static_cast<size_t>(config.programSettings->numRngs), config.programSettings->dataSize * 4 * mpi_size);
-        HOST_DATA_TYPE ran = 1;
-        random_inits[0] = ran;
-        for (HOST_DATA_TYPE r=0; r < config.programSettings->numRngs - 1; r++) {
-            for (HOST_DATA_TYPE run = 0; run < chunk; run++) {
-                HOST_DATA_TYPE_SIGNED v = 0;
-                if (((HOST_DATA_TYPE_SIGNED) ran) < 0) {
-                    v = POLY;
-                }
-                ran = (ran << 1) ^v;
-            }
-            random_inits[r + 1] = ran;
-        }
+        random_access::calculateRandomStartValues(random_inits, config.programSettings->numRngs, chunk);
 
 
         /* --- Prepare kernels --- */
 
         for (int r=0; r < config.programSettings->kernelReplications; r++) {
-            compute_queue.push_back(cl::CommandQueue(*config.context, *config.device, 0, &err));
+            compute_queue.push_back(cl::CommandQueue(*config.context, *config.device, profiling::PROFILING_QUEUE_PROPERTIES, &err));
             ASSERT_CL(err);
-            int memory_bank_info = 0;
-#ifdef INTEL_FPGA
-#ifdef USE_HBM
-            memory_bank_info = CL_MEM_HETEROGENEOUS_INTELFPGA;
-#else
-            memory_bank_info = ((r + 1) << 16);
+            int default_bank = -1;
+#if defined(INTEL_FPGA) && !defined(USE_HBM)
+            default_bank = r;
 #endif
-#endif
-            Buffer_data.push_back(cl::Buffer(*config.context,
-                        CL_MEM_READ_WRITE | memory_bank_info,
-                        sizeof(HOST_DATA_TYPE)*(config.programSettings->dataSize / config.programSettings->kernelReplications)));
+            Buffer_data.push_back(placement::createBuffer(*config.context, CL_MEM_READ_WRITE,
+                        sizeof(HOST_DATA_TYPE)*(config.programSettings->dataSize / config.programSettings->kernelReplications),
+                        config.programSettings->memoryBanks.bank(r, 0, 1, default_bank)));
 
             Buffer_randoms.emplace_back(*config.context,
                         CL_MEM_READ_ONLY,
@@ -125,10 +128,25 @@ namespace bm_execution {
             ASSERT_CL(err);
         }
 
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+        std::vector<std::string> counter_names;
+        for (int r = 0; r < config.programSettings->kernelReplications; r++) {
+            counter_names.push_back(RANDOM_ACCESS_KERNEL + std::to_string(r));
+        }
+        kernel_counters::KernelCounters counters(*config.context, counter_names);
+        for (int r = 0; r < config.programSettings->kernelReplications; r++) {
+            counters.setKernelArg(accesskernel[r], 6);
+        }
+#endif
+
         /* --- Execute actual benchmark kernels --- */
 
         std::vector<double> executionTimes;
+        profiling::EventProfiler profiler;
         for (int i = 0; i < config.programSettings->numRepetitions; i++) {
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+            counters.reset(compute_queue[0]);
+#endif
             std::chrono::time_point<std::chrono::high_resolution_clock> t1;
 #pragma omp parallel default(shared)
             {
@@ -149,15 +167,24 @@ namespace bm_execution {
                                     NULL, NULL);
                     ASSERT_CL(err)
 #else
+                    if (config.programSettings->residentData && i > 0) {
+                        // The table of the last repetition is kept on the device
+                        continue;
+                    }
+                    cl::Event write_data_event;
+                    cl::Event write_randoms_event;
                     err = compute_queue[r].enqueueWriteBuffer(Buffer_data[r], CL_TRUE, 0,
                                                         sizeof(HOST_DATA_TYPE) *
                                                         (config.programSettings->dataSize / config.programSettings->kernelReplications),
-                                                        &data[r * (config.programSettings->dataSize / config.programSettings->kernelReplications)]);
+                                                        &data[r * (config.programSettings->dataSize / config.programSettings->kernelReplications)],
+                                                        NULL, &write_data_event);
                     ASSERT_CL(err)
                     err = compute_queue[r].enqueueWriteBuffer(Buffer_randoms[r], CL_TRUE, 0,
                                                         sizeof(HOST_DATA_TYPE) * config.programSettings->numRngs,
-                                                        random_inits);
+                                                        random_inits, NULL, &write_randoms_event);
                     ASSERT_CL(err)
+                    profiler.record("write_data", r, write_data_event);
+                    profiler.record("write_randoms", r, write_randoms_event);
 #endif
                 }
 #pragma omp master
@@ -168,7 +195,9 @@ namespace bm_execution {
 #pragma omp barrier
 #pragma omp for nowait
                 for (int r = 0; r < config.programSettings->kernelReplications; r++) {
-                    compute_queue[r].enqueueNDRangeKernel(accesskernel[r], cl::NullRange, cl::NDRange(1));
+                    cl::Event kernel_event;
+                    compute_queue[r].enqueueNDRangeKernel(accesskernel[r], cl::NullRange, cl::NDRange(1), cl::NullRange, NULL, &kernel_event);
+                    profiler.record("kernel", r, kernel_event);
                 }
 #pragma omp for
                 for (int r = 0; r < config.programSettings->kernelReplications; r++) {
@@ -183,8 +212,26 @@ namespace bm_execution {
                     executionTimes.push_back(timespan.count());
                 }
             }
+            profiler.collect(i);
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+            counters.read(compute_queue[0]);
+            counters.print(i);
+#endif
         }
 
+#ifndef USE_SVM
+        if (config.programSettings->residentData && config.programSettings->numRepetitions % 2 == 0) {
+            // Every repetition applied the same updates to the resident table, so an even number of repetitions restored it.
+            // Apply the updates once more, so the result can be validated like the result of a single repetition.
+            for (int r = 0; r < config.programSettings->kernelReplications; r++) {
+                ASSERT_CL(compute_queue[r].enqueueNDRangeKernel(accesskernel[r], cl::NullRange, cl::NDRange(1), cl::NullRange))
+            }
+            for (int r = 0; r < config.programSettings->kernelReplications; r++) {
+                compute_queue[r].finish();
+            }
+        }
+#endif
+
         /* --- Read back results from Device --- */
         for (int r=0; r < config.programSettings->kernelReplications; r++) {
 #ifdef USE_SVM
@@ -204,7 +251,352 @@ namespace bm_execution {
 
         free(random_inits);
 
-        return std::unique_ptr<random_access::RandomAccessExecutionTimings>(new random_access::RandomAccessExecutionTimings{executionTimes});
+        return std::unique_ptr<random_access::RandomAccessExecutionTimings>(new random_access::RandomAccessExecutionTimings{executionTimes, profiler.timings,
+                                                                    4 * config.programSettings->dataSize});
+    }
+
+    /*
+    Distributed execution with updates between the ranks.
+    Every rank only generates its part of the pseudo random sequence in rounds of the size of the look-ahead.
+    The updates of a round are read back to the host, sorted by the rank that owns the updated address and
+    exchanged in batches with random_access::UpdateBuckets. The received updates are sorted by the kernel replication that holds the address
+    and are applied to the data array on the device.
+     @copydoc bm_execution::calculate()
+    */
+    std::unique_ptr<random_access::RandomAccessExecutionTimings>
+    calculate_distributed(hpcc_base::ExecutionSettings<random_access::RandomAccessProgramSettings> const& config, HOST_DATA_TYPE * data, int mpi_rank, int mpi_size) {
+#ifdef USE_SVM
+        std::cerr << "ERROR: The distributed execution is not supported with SVM!" << std::endl;
+        return std::unique_ptr<random_access::RandomAccessExecutionTimings>(nullptr);
+#else
+        int err;
+        const int replications = config.programSettings->kernelReplications;
+        const size_t data_chunk = config.programSettings->dataSize / replications;
+        const size_t rank_updates = 4 * config.programSettings->dataSize;
+        const size_t lookahead = std::min(config.programSettings->lookahead, rank_updates);
+        const size_t num_rngs = 1UL << HPCC_FPGA_RA_RNG_COUNT_LOG;
+        const size_t replication_updates = lookahead / replications;
+        const size_t updates_per_rng = replication_updates / num_rngs;
+        const size_t rounds = rank_updates / lookahead;
+        if (updates_per_rng == 0) {
+            std::cerr << "ERROR: The data array is too small to generate updates with all RNGs!" << std::endl;
+            return std::unique_ptr<random_access::RandomAccessExecutionTimings>(nullptr);
+        }
+
+        // RNG g of replication r generates a contiguous part of the updates of this rank
+        std::vector<HOST_DATA_TYPE> random_inits(replications * num_rngs);
+        HOST_DATA_TYPE rng_distance = rank_updates / (replications * num_rngs);
+#pragma omp parallel for
+        for (size_t g = 0; g < random_inits.size(); g++) {
+            random_inits[g] = random_access::starts(mpi_rank * rank_updates + g * rng_distance);
+        }
+
+        std::vector<cl::CommandQueue> compute_queue;
+        std::vector<cl::Buffer> Buffer_data;
+        std::vector<cl::Buffer> Buffer_state;
+        std::vector<cl::Buffer> Buffer_generated;
+        std::vector<cl::Buffer> Buffer_received;
+        std::vector<size_t> received_capacity;
+        std::vector<int> bank_of_replication;
+        std::vector<cl::Kernel> generate_kernel;
+        std::vector<cl::Kernel> apply_kernel;
+
+        for (int r=0; r < replications; r++) {
+            compute_queue.push_back(cl::CommandQueue(*config.context, *config.device, profiling::PROFILING_QUEUE_PROPERTIES, &err));
+            ASSERT_CL(err);
+            int default_bank = -1;
+#if defined(INTEL_FPGA) && !defined(USE_HBM)
+            default_bank = r;
+#endif
+            int bank = config.programSettings->memoryBanks.bank(r, 0, 1, default_bank);
+            Buffer_data.push_back(placement::createBuffer(*config.context, CL_MEM_READ_WRITE,
+                        sizeof(HOST_DATA_TYPE) * data_chunk, bank, &err));
+            ASSERT_CL(err);
+            Buffer_state.push_back(placement::createBuffer(*config.context, CL_MEM_READ_WRITE,
+                        sizeof(HOST_DATA_TYPE) * num_rngs, bank, &err));
+            ASSERT_CL(err);
+            Buffer_generated.push_back(placement::createBuffer(*config.context, CL_MEM_WRITE_ONLY,
+                        sizeof(HOST_DATA_TYPE) * replication_updates, bank, &err));
+            ASSERT_CL(err);
+            // The number of received updates varies between the rounds, so the buffer is enlarged if required
+            received_capacity.push_back(2 * replication_updates);
+            bank_of_replication.push_back(bank);
+            Buffer_received.push_back(placement::createBuffer(*config.context, CL_MEM_READ_ONLY,
+                        sizeof(HOST_DATA_TYPE) * received_capacity[r], bank, &err));
+            ASSERT_CL(err);
+#ifdef INTEL_FPGA
+            generate_kernel.push_back(cl::Kernel(*config.program, (GENERATE_UPDATES_KERNEL + std::to_string(r)).c_str(), &err));
+            ASSERT_CL(err);
+            apply_kernel.push_back(cl::Kernel(*config.program, (APPLY_UPDATES_KERNEL + std::to_string(r)).c_str(), &err));
+            ASSERT_CL(err);
+#endif
+#ifdef XILINX_FPGA
+            generate_kernel.push_back(cl::Kernel(*config.program,
+                        (std::string(GENERATE_UPDATES_KERNEL) + "0:{" + GENERATE_UPDATES_KERNEL + "0_" + std::to_string(r + 1) + "}").c_str(), &err));
+            ASSERT_CL(err);
+            apply_kernel.push_back(cl::Kernel(*config.program,
+                        (std::string(APPLY_UPDATES_KERNEL) + "0:{" + APPLY_UPDATES_KERNEL + "0_" + std::to_string(r + 1) + "}").c_str(), &err));
+            ASSERT_CL(err);
+#endif
+            err = generate_kernel[r].setArg(0, Buffer_generated[r]);
+            ASSERT_CL(err);
+            err = generate_kernel[r].setArg(1, Buffer_state[r]);
+            ASSERT_CL(err);
+            err = generate_kernel[r].setArg(2, HOST_DATA_TYPE(updates_per_rng));
+            ASSERT_CL(err);
+            err = apply_kernel[r].setArg(0, Buffer_data[r]);
+            ASSERT_CL(err);
+            err = apply_kernel[r].setArg(1, Buffer_received[r]);
+            ASSERT_CL(err);
+            err = apply_kernel[r].setArg(3, HOST_DATA_TYPE(data_chunk));
+            ASSERT_CL(err);
+        }
+
+        // Host buffers for the updates of a single round
+        std::vector<HOST_DATA_TYPE> generated(lookahead);
+        std::vector<HOST_DATA_TYPE> received;
+        std::vector<HOST_DATA_TYPE> sorted;
+#ifdef _USE_MPI_
+        random_access::UpdateBuckets buckets(mpi_size, config.programSettings->dataSize, config.programSettings->bucketSize,
+                                                config.programSettings->bucketExchange, config.communicator);
+#else
+        random_access::UpdateBuckets buckets(mpi_size, config.programSettings->dataSize, config.programSettings->bucketSize,
+                                                config.programSettings->bucketExchange);
+#endif
+        std::vector<size_t> replication_counts(replications);
+        std::vector<size_t> replication_displs(replications);
+
+        /* --- Execute actual benchmark kernels --- */
+
+        std::vector<double> executionTimes;
+        profiling::EventProfiler profiler;
+        for (int i = 0; i < config.programSettings->numRepetitions; i++) {
+            for (int r = 0; r < replications; r++) {
+                cl::Event write_data_event;
+                err = compute_queue[r].enqueueWriteBuffer(Buffer_data[r], CL_TRUE, 0, sizeof(HOST_DATA_TYPE) * data_chunk,
+                                                    &data[r * data_chunk], NULL, &write_data_event);
+                ASSERT_CL(err)
+                err = compute_queue[r].enqueueWriteBuffer(Buffer_state[r], CL_TRUE, 0, sizeof(HOST_DATA_TYPE) * num_rngs,
+                                                    &random_inits[r * num_rngs]);
+                ASSERT_CL(err)
+                profiler.record("write_data", r, write_data_event);
+            }
+#ifdef _USE_MPI_
+            MPI_Barrier(config.communicator);
+#endif
+            auto t1 = std::chrono::high_resolution_clock::now();
+            for (size_t round = 0; round < rounds; round++) {
+                // Generate the next updates of this rank on the device
+                for (int r = 0; r < replications; r++) {
+                    cl::Event generate_event;
+                    cl::Event read_event;
+                    ASSERT_CL(compute_queue[r].enqueueNDRangeKernel(generate_kernel[r], cl::NullRange, cl::NDRange(1), cl::NullRange, NULL, &generate_event))
+                    ASSERT_CL(compute_queue[r].enqueueReadBuffer(Buffer_generated[r], CL_FALSE, 0, sizeof(HOST_DATA_TYPE) * replication_updates,
+                                                    &generated[r * replication_updates], NULL, &read_event))
+                    profiler.record("generate", r, generate_event);
+                    profiler.record("read_updates", r, read_event);
+                }
+                // This also guarantees that the updates of the last round were written to the device, so the host buffers can be reused
+                for (int r = 0; r < replications; r++) {
+                    compute_queue[r].finish();
+                }
+
+                // Send the updates to the rank that owns the updated address in batches of the bucket size
+                received.clear();
+                size_t sent = 0;
+                bool pending = true;
+                while (pending) {
+                    sent += buckets.insert(&generated[sent], generated.size() - sent);
+                    pending = buckets.exchange(sent < generated.size(), [&received](const HOST_DATA_TYPE* updates, size_t count) {
+                        received.insert(received.end(), updates, updates + count);
+                    });
+                }
+
+                // Sort the received updates by the kernel replication that holds the updated address
+                std::fill(replication_counts.begin(), replication_counts.end(), 0);
+                for (HOST_DATA_TYPE u : received) {
+                    replication_counts[((u >> 3) & (config.programSettings->dataSize - 1)) / data_chunk]++;
+                }
+                replication_displs[0] = 0;
+                for (int r = 1; r < replications; r++) {
+                    replication_displs[r] = replication_displs[r - 1] + replication_counts[r - 1];
+                }
+                sorted.resize(received.size());
+                std::vector<size_t> positions(replication_displs);
+                for (HOST_DATA_TYPE u : received) {
+                    sorted[positions[((u >> 3) & (config.programSettings->dataSize - 1)) / data_chunk]++] = u;
+                }
+
+                // Apply the received updates on the device
+                for (int r = 0; r < replications; r++) {
+                    if (replication_counts[r] == 0) {
+                        continue;
+                    }
+                    if (replication_counts[r] > received_capacity[r]) {
+                        received_capacity[r] = 2 * replication_counts[r];
+                        Buffer_received[r] = placement::createBuffer(*config.context, CL_MEM_READ_ONLY,
+                                                sizeof(HOST_DATA_TYPE) * received_capacity[r], bank_of_replication[r], &err);
+                        ASSERT_CL(err);
+                        err = apply_kernel[r].setArg(1, Buffer_received[r]);
+                        ASSERT_CL(err);
+                    }
+                    cl::Event write_event;
+                    cl::Event apply_event;
+                    ASSERT_CL(compute_queue[r].enqueueWriteBuffer(Buffer_received[r], CL_FALSE, 0, sizeof(HOST_DATA_TYPE) * replication_counts[r],
+                                                    &sorted[replication_displs[r]], NULL, &write_event))
+                    err = apply_kernel[r].setArg(2, HOST_DATA_TYPE(replication_counts[r]));
+                    ASSERT_CL(err);
+                    ASSERT_CL(compute_queue[r].enqueueNDRangeKernel(apply_kernel[r], cl::NullRange, cl::NDRange(1), cl::NullRange, NULL, &apply_event))
+                    profiler.record("write_updates", r, write_event);
+                    profiler.record("apply", r, apply_event);
+                }
+            }
+            for (int r = 0; r < replications; r++) {
+                compute_queue[r].finish();
+            }
+            auto t2 = std::chrono::high_resolution_clock::now();
+            std::chrono::duration<double> timespan = std::chrono::duration_cast<std::chrono::duration<double>>(t2 - t1);
+            executionTimes.push_back(timespan.count());
+            profiler.collect(i);
+        }
+
+        /* --- Read back results from Device --- */
+        for (int r = 0; r < replications; r++) {
+            err = compute_queue[r].enqueueReadBuffer(Buffer_data[r], CL_TRUE, 0, sizeof(HOST_DATA_TYPE) * data_chunk, &data[r * data_chunk]);
+            ASSERT_CL(err)
+        }
+
+        return std::unique_ptr<random_access::RandomAccessExecutionTimings>(new random_access::RandomAccessExecutionTimings{executionTimes, profiler.timings, rank_updates});
+#endif
+    }
+
+    /*
+    Execution with an update stream that is generated on the host with the configured update pattern.
+    The updates are generated in chunks, sorted by the kernel replication that holds the updated address
+    and applied to the data array by the applyUpdates kernels. Only the transfer of the updates to the device and
+    their application are measured, the generation on the host is excluded from the time.
+     @copydoc bm_execution::calculate()
+    */
+    std::unique_ptr<random_access::RandomAccessExecutionTimings>
+    calculate_pattern(hpcc_base::ExecutionSettings<random_access::RandomAccessProgramSettings> const& config, HOST_DATA_TYPE * data, int mpi_rank, int mpi_size) {
+#ifdef USE_SVM
+        std::cerr << "ERROR: The update patterns are not supported with SVM!" << std::endl;
+        return std::unique_ptr<random_access::RandomAccessExecutionTimings>(nullptr);
+#else
+        int err;
+        const int replications = config.programSettings->kernelReplications;
+        const size_t data_chunk = config.programSettings->dataSize / replications;
+        auto generator = random_access::createUpdateGenerator(*config.programSettings, mpi_rank);
+        const size_t chunk_size = std::min(static_cast<HOST_DATA_TYPE>(PATTERN_UPDATE_CHUNK_SIZE), generator->size());
+
+        std::vector<cl::CommandQueue> compute_queue;
+        std::vector<cl::Buffer> Buffer_data;
+        std::vector<cl::Buffer> Buffer_updates;
+        std::vector<cl::Kernel> apply_kernel;
+
+        for (int r=0; r < replications; r++) {
+            compute_queue.push_back(cl::CommandQueue(*config.context, *config.device, profiling::PROFILING_QUEUE_PROPERTIES, &err));
+            ASSERT_CL(err);
+            int default_bank = -1;
+#if defined(INTEL_FPGA) && !defined(USE_HBM)
+            default_bank = r;
+#endif
+            int bank = config.programSettings->memoryBanks.bank(r, 0, 1, default_bank);
+            Buffer_data.push_back(placement::createBuffer(*config.context, CL_MEM_READ_WRITE,
+                        sizeof(HOST_DATA_TYPE) * data_chunk, bank, &err));
+            ASSERT_CL(err);
+            // The updates of a chunk may all hit the same replication, e.g. for a small hot set
+            Buffer_updates.push_back(placement::createBuffer(*config.context, CL_MEM_READ_ONLY,
+                        sizeof(HOST_DATA_TYPE) * chunk_size, bank, &err));
+            ASSERT_CL(err);
+#ifdef INTEL_FPGA
+            apply_kernel.push_back(cl::Kernel(*config.program, (APPLY_UPDATES_KERNEL + std::to_string(r)).c_str(), &err));
+            ASSERT_CL(err);
+#endif
+#ifdef XILINX_FPGA
+            apply_kernel.push_back(cl::Kernel(*config.program,
+                        (std::string(APPLY_UPDATES_KERNEL) + "0:{" + APPLY_UPDATES_KERNEL + "0_" + std::to_string(r + 1) + "}").c_str(), &err));
+            ASSERT_CL(err);
+#endif
+            err = apply_kernel[r].setArg(0, Buffer_data[r]);
+            ASSERT_CL(err);
+            err = apply_kernel[r].setArg(1, Buffer_updates[r]);
+            ASSERT_CL(err);
+            err = apply_kernel[r].setArg(3, HOST_DATA_TYPE(data_chunk));
+            ASSERT_CL(err);
+        }
+
+        std::vector<HOST_DATA_TYPE> generated(chunk_size);
+        std::vector<HOST_DATA_TYPE> sorted(chunk_size);
+        std::vector<size_t> replication_counts(replications);
+        std::vector<size_t> replication_displs(replications);
+
+        /* --- Execute actual benchmark kernels --- */
+
+        std::vector<double> executionTimes;
+        profiling::EventProfiler profiler;
+        for (int i = 0; i < config.programSettings->numRepetitions; i++) {
+            for (int r = 0; r < replications; r++) {
+                cl::Event write_data_event;
+                err = compute_queue[r].enqueueWriteBuffer(Buffer_data[r], CL_TRUE, 0, sizeof(HOST_DATA_TYPE) * data_chunk,
+                                                    &data[r * data_chunk], NULL, &write_data_event);
+                ASSERT_CL(err)
+                profiler.record("write_data", r, write_data_event);
+            }
+            generator->reset();
+            double execution_time = 0.0;
+            size_t count;
+            while ((count = generator->generate(generated.data(), chunk_size)) > 0) {
+                // Sort the updates of the chunk by the kernel replication that holds the updated address
+                std::fill(replication_counts.begin(), replication_counts.end(), 0);
+                for (size_t u = 0; u < count; u++) {
+                    replication_counts[((generated[u] >> 3) & (config.programSettings->dataSize - 1)) / data_chunk]++;
+                }
+                replication_displs[0] = 0;
+                for (int r = 1; r < replications; r++) {
+                    replication_displs[r] = replication_displs[r - 1] + replication_counts[r - 1];
+                }
+                std::vector<size_t> positions(replication_displs);
+                for (size_t u = 0; u < count; u++) {
+                    sorted[positions[((generated[u] >> 3) & (config.programSettings->dataSize - 1)) / data_chunk]++] = generated[u];
+                }
+
+                auto t1 = std::chrono::high_resolution_clock::now();
+                for (int r = 0; r < replications; r++) {
+                    if (replication_counts[r] == 0) {
+                        continue;
+                    }
+                    cl::Event write_event;
+                    cl::Event apply_event;
+                    ASSERT_CL(compute_queue[r].enqueueWriteBuffer(Buffer_updates[r], CL_FALSE, 0, sizeof(HOST_DATA_TYPE) * replication_counts[r],
+                                                    &sorted[replication_displs[r]], NULL, &write_event))
+                    err = apply_kernel[r].setArg(2, HOST_DATA_TYPE(replication_counts[r]));
+                    ASSERT_CL(err);
+                    ASSERT_CL(compute_queue[r].enqueueNDRangeKernel(apply_kernel[r], cl::NullRange, cl::NDRange(1), cl::NullRange, NULL, &apply_event))
+                    profiler.record("write_updates", r, write_event);
+                    profiler.record("apply", r, apply_event);
+                }
+                // The host buffers are reused for the next chunk, so all transfers have to be finished
+                for (int r = 0; r < replications; r++) {
+                    compute_queue[r].finish();
+                }
+                std::chrono::duration<double> timespan = std::chrono::duration_cast<std::chrono::duration<double>>(
+                                                            std::chrono::high_resolution_clock::now() - t1);
+                execution_time += timespan.count();
+            }
+            executionTimes.push_back(execution_time);
+            profiler.collect(i);
+        }
+
+        /* --- Read back results from Device --- */
+        for (int r = 0; r < replications; r++) {
+            err = compute_queue[r].enqueueReadBuffer(Buffer_data[r], CL_TRUE, 0, sizeof(HOST_DATA_TYPE) * data_chunk, &data[r * data_chunk]);
+            ASSERT_CL(err)
+        }
+
+        return std::unique_ptr<random_access::RandomAccessExecutionTimings>(new random_access::RandomAccessExecutionTimings{executionTimes, profiler.timings,
+                                                                    generator->size()});
+#endif
     }
 
 }  // namespace bm_execution
@@ -27,6 +27,7 @@ SOFTWARE.
 #include "random_access_benchmark.hpp"
 
 /* C++ standard library headers */
+#include <algorithm>
 #include <memory>
 #include <random>
 
@@ -34,25 +35,96 @@ SOFTWARE.
 #include "execution.h"
 #include "parameters.h"
 
+HOST_DATA_TYPE
+random_access::starts(HOST_DATA_TYPE n) {
+    if (n == 0) {
+        return 1;
+    }
+    // m2[i] contains the value of the sequence at position 2*i
+    HOST_DATA_TYPE m2[BIT_SIZE];
+    HOST_DATA_TYPE temp = 1;
+    for (int i = 0; i < BIT_SIZE; i++) {
+        m2[i] = temp;
+        temp = (temp << 1) ^ (((HOST_DATA_TYPE_SIGNED) temp < 0) ? POLY : 0);
+        temp = (temp << 1) ^ (((HOST_DATA_TYPE_SIGNED) temp < 0) ? POLY : 0);
+    }
+    int i;
+    for (i = BIT_SIZE - 2; i >= 0; i--) {
+        if ((n >> i) & 1) {
+            break;
+        }
+    }
+    // Double the position for every remaining bit of n by squaring in GF(2)
+    // and do an additional single step for set bits
+    HOST_DATA_TYPE ran = 2;
+    while (i > 0) {
+        temp = 0;
+        for (int j = 0; j < BIT_SIZE; j++) {
+            if ((ran >> j) & 1) {
+                temp ^= m2[j];
+            }
+        }
+        ran = temp;
+        i -= 1;
+        if ((n >> i) & 1) {
+            ran = (ran << 1) ^ (((HOST_DATA_TYPE_SIGNED) ran < 0) ? POLY : 0);
+        }
+    }
+    return ran;
+}
+
+void
+random_access::calculateRandomStartValues(HOST_DATA_TYPE* values, size_t count, HOST_DATA_TYPE distance) {
+#pragma omp parallel for
+    for (size_t r = 0; r < count; r++) {
+        values[r] = starts(r * distance);
+    }
+}
+
+std::unique_ptr<random_access::UpdateGenerator>
+random_access::createUpdateGenerator(const RandomAccessProgramSettings &settings, int mpi_rank) {
+    return std::unique_ptr<UpdateGenerator>(new UpdateGenerator(settings.updatePattern, settings.dataSize, settings.zipfExponent,
+                                                settings.patternWindow, settings.traceFile, static_cast<unsigned>(mpi_rank) + 1));
+}
+
 random_access::RandomAccessProgramSettings::RandomAccessProgramSettings(cxxopts::ParseResult &results) : hpcc_base::BaseSettings(results),
     dataSize((1UL << results["d"].as<size_t>())),
     kernelReplications(results["r"].as<uint>()),
-    numRngs((1UL << results["g"].as<uint>())) {
+    numRngs((1UL << results["g"].as<uint>())), distributed(results.count("distributed") > 0),
+    residentData(results.count("resident") > 0),
+    lookahead(results["lookahead"].as<size_t>()), bucketSize(results["bucket-size"].as<size_t>()),
+    bucketExchange(retrieveBucketExchangeType(results["bucket-exchange"].as<std::string>())),
+    updatePattern(retrieveUpdatePattern(results["update-pattern"].as<std::string>())),
+    zipfExponent(results["zipf-exponent"].as<double>()), patternWindow(results["window"].as<size_t>()),
+    traceFile(results["trace-file"].as<std::string>()) {
 
 }
 
 std::map<std::string, std::string>
 random_access::RandomAccessProgramSettings::getSettingsMap() {
-    int mpi_size = 1;
-#ifdef _USE_MPI_
-     MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
-#endif
+    int mpi_size = std::max(mpiRanks, 1);
     auto map = hpcc_base::BaseSettings::getSettingsMap();
     std::stringstream ss;
     ss << dataSize << " (" << static_cast<double>(dataSize * sizeof(HOST_DATA_TYPE) * mpi_size) << " Byte )";
     map["Array Size"] = ss.str();
     map["Kernel Replications"] = std::to_string(kernelReplications);
     map["#RNGs"] = std::to_string(numRngs);
+    map["Resident Data"] = (residentData) ? "Yes" : "No";
+    map["Distributed"] = (distributed) ? "Yes, look-ahead " + std::to_string(lookahead) + ", " + bucketExchangeTypeToString(bucketExchange)
+                                            + " buckets of " + std::to_string(bucketSize) : "No";
+    std::string pattern = updatePatternToString(updatePattern);
+    if (updatePattern == UpdatePattern::zipf) {
+        std::stringstream zs;
+        zs << pattern << ", exponent " << zipfExponent;
+        pattern = zs.str();
+    }
+    else if (updatePattern == UpdatePattern::window) {
+        pattern += ", " + std::to_string(patternWindow) + " addresses";
+    }
+    else if (updatePattern == UpdatePattern::trace) {
+        pattern += ", " + traceFile;
+    }
+    map["Update Pattern"] = pattern;
     return map;
 }
 
@@ -62,7 +134,7 @@ random_access::RandomAccessData::RandomAccessData(cl::Context& context, size_t s
                         clSVMAlloc(context(), 0 ,
                         size * sizeof(HOST_DATA_TYPE), 1024));
 #else
-    posix_memalign(reinterpret_cast<void**>(&data), 4096, size * sizeof(HOST_DATA_TYPE));
+    numa::memalign(reinterpret_cast<void**>(&data), 4096, size * sizeof(HOST_DATA_TYPE));
 #endif
 }
 
@@ -70,7 +142,7 @@ random_access::RandomAccessData::~RandomAccessData() {
 #ifdef USE_SVM
     clSVMFree(context(), reinterpret_cast<void*>(data));
 #else
-    free(data);
+    numa::free(data);
 #endif
 }
 
@@ -84,11 +156,30 @@ random_access::RandomAccessBenchmark::addAdditionalParseOptions(cxxopts::Options
         ("d", "Log2 of the size of the data array",
             cxxopts::value<size_t>()->default_value(std::to_string(DEFAULT_ARRAY_LENGTH_LOG)))
         ("g", "Log2 of the number of random number generators",
-            cxxopts::value<uint>()->default_value(std::to_string(HPCC_FPGA_RA_RNG_COUNT_LOG)));
+            cxxopts::value<uint>()->default_value(std::to_string(HPCC_FPGA_RA_RNG_COUNT_LOG)))
+        ("resident", "Copy the data array to the device only once and keep it there between the repetitions")
+        ("distributed", "Every rank only generates its part of the updates and sends them to the rank that owns the updated address")
+        ("lookahead", "Number of updates that are generated by a rank before they are sent to the other ranks in the distributed execution",
+            cxxopts::value<size_t>()->default_value("1024"))
+        ("bucket-size", "Maximum number of updates that are sent to a single rank in one batch in the distributed execution",
+            cxxopts::value<size_t>()->default_value("1024"))
+        ("bucket-exchange", "MPI communication used to exchange the updates in the distributed execution: alltoallv, persistent",
+            cxxopts::value<std::string>()->default_value("alltoallv"))
+        ("update-pattern", "Distribution of the updated addresses: hpcc, zipf, window, trace. All patterns except hpcc are generated on the host",
+            cxxopts::value<std::string>()->default_value("hpcc"))
+        ("zipf-exponent", "Exponent of the Zipf distribution of the zipf update pattern",
+            cxxopts::value<double>()->default_value("0.99"))
+        ("window", "Number of addresses in the window of the window update pattern",
+            cxxopts::value<size_t>()->default_value("4096"))
+        ("trace-file", "File with the updated addresses of the trace update pattern as binary 64 bit unsigned integers",
+            cxxopts::value<std::string>()->default_value(""));
 }
 
 std::unique_ptr<random_access::RandomAccessExecutionTimings>
 random_access::RandomAccessBenchmark::executeKernel(RandomAccessData &data) {
+    if (executionSettings->programSettings->communicationType == hpcc_base::CommunicationType::cpu_only) {
+        return bm_execution::calculate_cpu(*executionSettings, data.data, mpi_comm_rank, mpi_comm_size);
+    }
     return bm_execution::calculate(*executionSettings, data.data, mpi_comm_rank, mpi_comm_size);
 }
 
@@ -99,11 +190,12 @@ random_access::RandomAccessBenchmark::collectAndPrintResults(const random_access
 #ifdef _USE_MPI_
     // Copy the object variable to a local variable to make it accessible to the lambda function
     int mpi_size = mpi_comm_size;
-    MPI_Reduce(output.times.data(),avgTimings.data(),output.times.size(), MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(output.times.data(),avgTimings.data(),output.times.size(), MPI_DOUBLE, MPI_SUM, 0, executionSettings->communicator);
     std::for_each(avgTimings.begin(),avgTimings.end(), [mpi_size](double& x) {x /= mpi_size;});
 #else
     std::copy(output.times.begin(), output.times.end(), avgTimings.begin());
 #endif
+    avgTimings = discardWarmup(avgTimings);
     if (mpi_comm_rank == 0) {
         std::cout << std::setw(ENTRY_SPACE)
                 << "best" << std::setw(ENTRY_SPACE) << "mean"
@@ -112,19 +204,28 @@ random_access::RandomAccessBenchmark::collectAndPrintResults(const random_access
         // Calculate performance for kernel execution
         double tmean = 0;
         double tmin = std::numeric_limits<double>::max();
-        double gups = static_cast<double>(4 * executionSettings->programSettings->dataSize * mpi_comm_size) / 1000000000;
+        double gups = static_cast<double>(output.updateCount * mpi_comm_size) / 1000000000;
         for (double currentTime : avgTimings) {
             tmean +=  currentTime;
             if (currentTime < tmin) {
                 tmin = currentTime;
             }
         }
-        tmean = tmean / output.times.size();
+        tmean = tmean / avgTimings.size();
+
+        timings.emplace("execution", avgTimings);
+        for (const auto& t : profiling::toTimingsMap(output.deviceTimings)) {
+            timings.emplace("device_" + t.first, discardWarmup(t.second));
+        }
+        results.emplace("t_min", hpcc_base::HpccResult(tmin, "s"));
+        results.emplace("t_mean", hpcc_base::HpccResult(tmean, "s"));
+        results.emplace("guops", hpcc_base::HpccResult(gups / tmin, "GUOP/s"));
 
         std::cout << std::setw(ENTRY_SPACE)
                 << tmin << std::setw(ENTRY_SPACE) << tmean
                 << std::setw(ENTRY_SPACE) << gups / tmin
                 << std::endl;
+        addStatistics("t", avgTimings);
     }
 }
 
@@ -142,6 +243,36 @@ random_access::RandomAccessBenchmark::checkInputParameters() {
         std::cerr << "ERROR: Data chunk size for each kernel replication is not a power of 2!" << std::endl;
         validationResult = false;
     }
+    size_t lookahead = executionSettings->programSettings->lookahead;
+    size_t min_lookahead = executionSettings->programSettings->kernelReplications * (1UL << HPCC_FPGA_RA_RNG_COUNT_LOG);
+    if (executionSettings->programSettings->distributed && ((lookahead & (lookahead - 1)) || lookahead < min_lookahead)) {
+        // Every RNG of every kernel replication has to generate the same number of updates per round
+        std::cerr << "ERROR: The look-ahead has to be a power of 2 and at least " << min_lookahead << "!" << std::endl;
+        validationResult = false;
+    }
+    if (executionSettings->programSettings->distributed && executionSettings->programSettings->bucketSize == 0) {
+        std::cerr << "ERROR: The bucket size has to be at least 1!" << std::endl;
+        validationResult = false;
+    }
+    const auto &settings = *executionSettings->programSettings;
+    if (settings.updatePattern != UpdatePattern::hpcc) {
+        if (settings.distributed) {
+            std::cerr << "ERROR: The update pattern " << updatePatternToString(settings.updatePattern) << " can not be used with the distributed execution!" << std::endl;
+            validationResult = false;
+        }
+        if (settings.updatePattern == UpdatePattern::zipf && settings.zipfExponent <= 0.0) {
+            std::cerr << "ERROR: The exponent of the Zipf distribution has to be greater than 0!" << std::endl;
+            validationResult = false;
+        }
+        if (settings.updatePattern == UpdatePattern::window && (settings.patternWindow == 0 || settings.patternWindow > settings.dataSize)) {
+            std::cerr << "ERROR: The window has to contain between 1 and " << settings.dataSize << " addresses!" << std::endl;
+            validationResult = false;
+        }
+        if (settings.updatePattern == UpdatePattern::trace && settings.traceFile.empty()) {
+            std::cerr << "ERROR: The trace update pattern requires a trace file!" << std::endl;
+            validationResult = false;
+        }
+    }
     return validationResult;
 }
 
@@ -154,58 +285,113 @@ random_access::RandomAccessBenchmark::generateInputData() {
     return d;
 }
 
+std::vector<memory_tracker::MemoryRequirement>
+random_access::RandomAccessBenchmark::estimateMemoryUsage() {
+    const auto &settings = *executionSettings->programSettings;
+    size_t data_bytes = settings.dataSize * sizeof(HOST_DATA_TYPE);
+    // The number of updates in a trace file is not known before reading it, so the full chunk size is assumed
+    size_t chunk_bytes = ((settings.updatePattern == UpdatePattern::trace) ? PATTERN_UPDATE_CHUNK_SIZE
+                            : std::min(PATTERN_UPDATE_CHUNK_SIZE, 4 * settings.dataSize)) * sizeof(HOST_DATA_TYPE);
+    bool pattern = settings.updatePattern != UpdatePattern::hpcc;
+    std::vector<memory_tracker::MemoryRequirement> requirements = {{"Data", data_bytes, 1, false}};
+    if (pattern) {
+        requirements.push_back({"Update chunk", chunk_bytes, 1, false});
+    }
+    if (settings.communicationType != hpcc_base::CommunicationType::cpu_only) {
+        requirements.push_back({"Data", data_bytes / settings.kernelReplications, settings.kernelReplications, true});
+        if (pattern) {
+            requirements.push_back({"Update chunk", chunk_bytes, settings.kernelReplications, true});
+        }
+    }
+    return requirements;
+}
+
+std::vector<std::string>
+random_access::RandomAccessBenchmark::getRankScalingArguments(int ranks, bool weak) {
+    if (weak) {
+        return {};
+    }
+    size_t total_size = executionSettings->programSettings->dataSize * mpi_comm_size;
+    size_t rank_size = total_size / ranks;
+    if (total_size % ranks != 0 || (rank_size & (rank_size - 1)) != 0) {
+        throw std::runtime_error("The data array with " + std::to_string(total_size) + " items can not be divided between "
+                                    + std::to_string(ranks) + " ranks");
+    }
+    size_t log_size = 0;
+    while ((static_cast<size_t>(1) << log_size) < rank_size) {
+        log_size++;
+    }
+    return {"-d", std::to_string(log_size)};
+}
+
 bool  
 random_access::RandomAccessBenchmark::validateOutputAndPrintError(random_access::RandomAccessData &data) {
 
-    HOST_DATA_TYPE* rawdata;
-    if (mpi_comm_size > 1) {
-#ifdef _USE_MPI_
-        if (mpi_comm_rank == 0) {
-            rawdata = new HOST_DATA_TYPE[executionSettings->programSettings->dataSize * mpi_comm_size];
+    // Every rank replays all pseudo random updates again, but only applies the updates to its local part
+    // of the data array. This should lead to the initial values in the data array, because XOR is a involutory function.
+    // The pseudo random sequence is split into chunks that are replayed in parallel with OpenMP,
+    // starting from the same kind of start values that are used for the kernel.
+    HOST_DATA_TYPE global_size = executionSettings->programSettings->dataSize * mpi_comm_size;
+    HOST_DATA_TYPE local_offset = executionSettings->programSettings->dataSize * mpi_comm_rank;
+    HOST_DATA_TYPE* local_data = data.data;
+    if (executionSettings->programSettings->updatePattern != UpdatePattern::hpcc) {
+        // The host generated update stream of this rank is replayed with the same seed. It only contains local addresses.
+        auto generator = createUpdateGenerator(*executionSettings->programSettings, mpi_comm_rank);
+        std::vector<HOST_DATA_TYPE> updates(std::min(static_cast<HOST_DATA_TYPE>(PATTERN_UPDATE_CHUNK_SIZE), generator->size()));
+        size_t count;
+        while ((count = generator->generate(updates.data(), updates.size())) > 0) {
+            for (size_t i = 0; i < count; i++) {
+                local_data[(updates[i] >> 3) & (executionSettings->programSettings->dataSize - 1)] ^= updates[i];
+            }
         }
-        MPI_Gather(data.data, executionSettings->programSettings->dataSize, MPI_LONG, 
-                rawdata, executionSettings->programSettings->dataSize, MPI_LONG, 0, MPI_COMM_WORLD);
-#endif
     }
     else {
-        rawdata = data.data;
-    }
-
-
-    if (mpi_comm_rank == 0) {
+        HOST_DATA_TYPE total_updates = 4L * global_size;
+        HOST_DATA_TYPE num_chunks = std::min(static_cast<HOST_DATA_TYPE>(VALIDATION_CHUNKS), total_updates);
+        HOST_DATA_TYPE updates_per_chunk = (total_updates + num_chunks - 1) / num_chunks;
+        std::vector<HOST_DATA_TYPE> start_values(num_chunks);
+        calculateRandomStartValues(start_values.data(), num_chunks, updates_per_chunk);
 
-        // Serially execute all pseudo random updates again
-        // This should lead to the initial values in the data array, because XOR is a involutory function
-        HOST_DATA_TYPE temp = 1;
-        for (HOST_DATA_TYPE i=0; i < 4L*executionSettings->programSettings->dataSize * mpi_comm_size; i++) {
-            HOST_DATA_TYPE_SIGNED v = 0;
-            if (((HOST_DATA_TYPE_SIGNED)temp) < 0) {
-                v = POLY;
+#pragma omp parallel for schedule(dynamic)
+        for (HOST_DATA_TYPE c = 0; c < num_chunks; c++) {
+            HOST_DATA_TYPE temp = start_values[c];
+            HOST_DATA_TYPE chunk_end = std::min(total_updates, (c + 1) * updates_per_chunk);
+            for (HOST_DATA_TYPE i = c * updates_per_chunk; i < chunk_end; i++) {
+                HOST_DATA_TYPE_SIGNED v = 0;
+                if (((HOST_DATA_TYPE_SIGNED)temp) < 0) {
+                    v = POLY;
+                }
+                temp = (temp << 1) ^ v;
+                HOST_DATA_TYPE address = ((temp >> 3) & (global_size - 1)) - local_offset;
+                // Address is only in range, if the update hits the local part of the array
+                if (address < executionSettings->programSettings->dataSize) {
+#pragma omp atomic
+                    local_data[address] ^= temp;
+                }
             }
-            temp = (temp << 1) ^ v;
-            rawdata[(temp >> 3) & (executionSettings->programSettings->dataSize * mpi_comm_size - 1)] ^= temp;
         }
+    }
 
-        double errors = 0;
+    double errors = 0;
 #pragma omp parallel for reduction(+:errors)
-        for (HOST_DATA_TYPE i=0; i< executionSettings->programSettings->dataSize * mpi_comm_size; i++) {
-            if (rawdata[i] != i) {
-                // If the array at index i does not contain i, it differs from the initial value and is counted as an error
-                errors++;
-            }
+    for (HOST_DATA_TYPE i=0; i< executionSettings->programSettings->dataSize; i++) {
+        if (local_data[i] != local_offset + i) {
+            // If the array at index i does not contain i, it differs from the initial value and is counted as an error
+            errors++;
         }
+    }
 
+    double total_errors = errors;
+#ifdef _USE_MPI_
+    MPI_Reduce(&errors, &total_errors, 1, MPI_DOUBLE, MPI_SUM, 0, executionSettings->communicator);
+#endif
+
+    if (mpi_comm_rank == 0) {
         // The overall error is calculated in percent of the overall array size
-        double error_ratio = static_cast<double>(errors) / (executionSettings->programSettings->dataSize * mpi_comm_size);
+        double error_ratio = static_cast<double>(total_errors) / global_size;
         std::cout  << "Error: " << error_ratio * 100 
                     << "%" << std::endl;
 
-#ifdef _USE_MPI_
-        if (mpi_comm_rank == 0 && mpi_comm_size > 1) {
-            delete [] rawdata;
-        }
-#endif
-
         return error_ratio < 0.01;
     }
 
@@ -29,7 +29,10 @@ SOFTWARE.
 
 /* Project's headers */
 #include "hpcc_benchmark.hpp"
+#include "profiling.hpp"
 #include "parameters.h"
+#include "update_buckets.hpp"
+#include "update_generator.hpp"
 
 /**
  * @brief Contains all classes and methods needed by the RandomAccess benchmark
@@ -62,6 +65,63 @@ public:
      */
     uint numRngs;
 
+    /**
+     * @brief If true, every rank only generates its part of the updates and forwards the updates
+     *          to the rank that owns the updated address over PCIe and MPI
+     * 
+     */
+    bool distributed;
+
+    /**
+     * @brief If true, the data array is only copied to the device before the first repetition and stays there
+     *          for all following repetitions
+     * 
+     */
+    bool residentData;
+
+    /**
+     * @brief Maximum number of updates that are generated by a rank before they are forwarded to the other ranks
+     *          in the distributed execution. The HPCC rules allow a look-ahead of up to 1024 updates.
+     * 
+     */
+    size_t lookahead;
+
+    /**
+     * @brief Maximum number of updates that are sent to a single rank in one batch in the distributed execution
+     * 
+     */
+    size_t bucketSize;
+
+    /**
+     * @brief The MPI communication used to exchange the update buckets in the distributed execution
+     * 
+     */
+    BucketExchangeType bucketExchange;
+
+    /**
+     * @brief The distribution of the updated addresses. All patterns except hpcc are generated on the host.
+     * 
+     */
+    UpdatePattern updatePattern;
+
+    /**
+     * @brief Exponent of the Zipf distribution used by the zipf update pattern
+     * 
+     */
+    double zipfExponent;
+
+    /**
+     * @brief Number of addresses in the window of the window update pattern
+     * 
+     */
+    size_t patternWindow;
+
+    /**
+     * @brief Path to the file with the addresses of the trace update pattern
+     * 
+     */
+    std::string traceFile;
+
     /**
      * @brief Construct a new random access Program Settings object
      * 
@@ -126,8 +186,55 @@ public:
      */
     std::vector<double> times;
 
+    /**
+     * @brief Device-side timings of the kernel executions and buffer transfers of all replications
+     *          measured with OpenCL event profiling
+     * 
+     */
+    std::vector<profiling::DeviceTiming> deviceTimings;
+
+    /**
+     * @brief Number of updates applied by every rank in a single repetition
+     * 
+     */
+    HOST_DATA_TYPE updateCount;
+
 };
 
+/**
+ * @brief Calculate the value of the pseudo random number sequence used for the updates at a given position
+ *          without stepping through the whole sequence. The jump-ahead is done in O(log(n)) using the
+ *          same approach as HPCC_starts() in the HPCC reference implementation.
+ * 
+ * @param n Position in the sequence. Position 0 returns the initial value 1.
+ * @return HOST_DATA_TYPE The value of the sequence at position n
+ */
+HOST_DATA_TYPE
+starts(HOST_DATA_TYPE n);
+
+/**
+ * @brief Calculate values of the pseudo random number sequence used for the updates at equidistant positions.
+ *          They are used as start values for the random number generators that create different parts of the sequence.
+ * 
+ * @param values Array the start values will be written to
+ * @param count Number of start values that should be calculated
+ * @param distance Number of values in the sequence between two start values
+ */
+void
+calculateRandomStartValues(HOST_DATA_TYPE* values, size_t count, HOST_DATA_TYPE distance);
+
+/**
+ * @brief Create the generator for the update stream of a rank with the update pattern given in the settings.
+ *          The same rank always gets the same stream, so it can be replayed for the validation.
+ * 
+ * @param settings The program settings with the update pattern
+ * @param mpi_rank Rank that applies the updates to its local part of the data array
+ * @return std::unique_ptr<UpdateGenerator> The generator of the update stream
+ * @throws std::runtime_error if the update pattern is hpcc or the trace file can not be opened
+ */
+std::unique_ptr<UpdateGenerator>
+createUpdateGenerator(const RandomAccessProgramSettings &settings, int mpi_rank);
+
 /**
  * @brief Implementation of the random access benchmark
  * 
@@ -154,6 +261,26 @@ public:
     std::unique_ptr<RandomAccessData>
     generateInputData() override;
 
+    /**
+     * @brief Estimate the memory of the data array and the update chunks of the host generated update streams
+     * 
+     * @return std::vector<memory_tracker::MemoryRequirement> The estimated allocations of this rank
+     */
+    std::vector<memory_tracker::MemoryRequirement>
+    estimateMemoryUsage() override;
+
+    /**
+     * @brief Get the data size for a rank scaling. The data size is given per rank, so it is kept for the weak scaling
+     *          and the total data array is divided between the ranks for the strong scaling.
+     * 
+     * @param ranks Number of ranks the benchmark will be executed on
+     * @param weak True for the weak scaling
+     * @return std::vector<std::string> The log2 of the data size, if it has to be changed
+     * @throw std::runtime_error if the data array can not be divided in parts with a power of two size
+     */
+    std::vector<std::string>
+    getRankScalingArguments(int ranks, bool weak) override;
+
     /**
      * @brief RandomAccess specific implementation of the kernel execution
      * 
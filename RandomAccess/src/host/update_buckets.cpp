@@ -0,0 +1,147 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+/* Related header files */
+#include "update_buckets.hpp"
+
+/* C++ standard library headers */
+#include <algorithm>
+#include <stdexcept>
+
+random_access::BucketExchangeType
+random_access::retrieveBucketExchangeType(const std::string &name) {
+    if (name == "alltoallv") {
+        return BucketExchangeType::alltoallv;
+    }
+    if (name == "persistent") {
+        return BucketExchangeType::persistent;
+    }
+    throw std::runtime_error("Unknown bucket exchange type: " + name + ". Use 'alltoallv' or 'persistent'!");
+}
+
+std::string
+random_access::bucketExchangeTypeToString(BucketExchangeType type) {
+    switch (type) {
+        case BucketExchangeType::alltoallv: return "alltoallv";
+        case BucketExchangeType::persistent: return "persistent";
+    }
+    return "UNKNOWN";
+}
+
+random_access::UpdateBuckets::UpdateBuckets(int num_destinations, HOST_DATA_TYPE destination_size, size_t bucket_size, BucketExchangeType type
+#ifdef _USE_MPI_
+        , MPI_Comm communicator
+#endif
+        ) :
+        num_destinations(num_destinations), address_mask(destination_size * num_destinations - 1), destination_shift(0),
+        bucket_size(bucket_size), bucket_stride(bucket_size + HEADER_SIZE), type(type),
+        fill_level(num_destinations, 0),
+        send_buckets(num_destinations * bucket_stride),
+        recv_buckets(num_destinations * bucket_stride)
+#ifdef _USE_MPI_
+        , communicator(communicator)
+#endif
+        {
+    if (bucket_size == 0) {
+        throw std::runtime_error("The bucket size has to be at least 1!");
+    }
+    if ((destination_size == 0) || (destination_size & (destination_size - 1))) {
+        throw std::runtime_error("The data size per rank has to be a power of two!");
+    }
+    while ((static_cast<HOST_DATA_TYPE>(1) << destination_shift) < destination_size) {
+        destination_shift++;
+    }
+#ifdef _USE_MPI_
+    send_counts.resize(num_destinations);
+    recv_counts.resize(num_destinations);
+    displacements.resize(num_destinations);
+    for (int d = 0; d < num_destinations; d++) {
+        displacements[d] = static_cast<int>(d * bucket_stride);
+    }
+    if (type == BucketExchangeType::persistent) {
+        // Every rank receives exactly one complete bucket from every other rank per exchange
+        requests.resize(2 * num_destinations);
+        for (int d = 0; d < num_destinations; d++) {
+            MPI_Recv_init(&recv_buckets[d * bucket_stride], static_cast<int>(bucket_stride), MPI_UINT64_T, d, 0,
+                            communicator, &requests[d]);
+            MPI_Send_init(&send_buckets[d * bucket_stride], static_cast<int>(bucket_stride), MPI_UINT64_T, d, 0,
+                            communicator, &requests[num_destinations + d]);
+        }
+    }
+#endif
+}
+
+random_access::UpdateBuckets::~UpdateBuckets() {
+#ifdef _USE_MPI_
+    for (auto &r : requests) {
+        MPI_Request_free(&r);
+    }
+#endif
+}
+
+size_t
+random_access::UpdateBuckets::insert(const HOST_DATA_TYPE* updates, size_t count) {
+    HOST_DATA_TYPE* buckets = send_buckets.data() + HEADER_SIZE;
+    for (size_t i = 0; i < count; i++) {
+        int d = destination(updates[i]);
+        if (fill_level[d] == bucket_size) {
+            return i;
+        }
+        buckets[d * bucket_stride + fill_level[d]++] = updates[i];
+    }
+    return count;
+}
+
+bool
+random_access::UpdateBuckets::exchange(bool more_updates, const UpdateHandler &handler) {
+    for (int d = 0; d < num_destinations; d++) {
+        send_buckets[d * bucket_stride] = fill_level[d];
+        send_buckets[d * bucket_stride + 1] = more_updates ? 1 : 0;
+    }
+#ifdef _USE_MPI_
+    if (type == BucketExchangeType::persistent) {
+        MPI_Startall(static_cast<int>(requests.size()), requests.data());
+        MPI_Waitall(static_cast<int>(requests.size()), requests.data(), MPI_STATUSES_IGNORE);
+    }
+    else {
+        for (int d = 0; d < num_destinations; d++) {
+            send_counts[d] = static_cast<int>(fill_level[d] + HEADER_SIZE);
+        }
+        MPI_Alltoall(send_counts.data(), 1, MPI_INT, recv_counts.data(), 1, MPI_INT, communicator);
+        MPI_Alltoallv(send_buckets.data(), send_counts.data(), displacements.data(), MPI_UINT64_T,
+                        recv_buckets.data(), recv_counts.data(), displacements.data(), MPI_UINT64_T, communicator);
+    }
+#else
+    recv_buckets.swap(send_buckets);
+#endif
+    bool more = false;
+    for (int s = 0; s < num_destinations; s++) {
+        const HOST_DATA_TYPE* bucket = &recv_buckets[s * bucket_stride];
+        more = more || (bucket[1] != 0);
+        if (bucket[0] > 0) {
+            handler(bucket + HEADER_SIZE, static_cast<size_t>(bucket[0]));
+        }
+    }
+    std::fill(fill_level.begin(), fill_level.end(), 0);
+    return more;
+}
@@ -0,0 +1,201 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef SRC_HOST_UPDATE_BUCKETS_H_
+#define SRC_HOST_UPDATE_BUCKETS_H_
+
+/* C++ standard library headers */
+#include <functional>
+#include <string>
+#include <vector>
+
+/* External library headers */
+#ifdef _USE_MPI_
+#include "mpi.h"
+#endif
+
+/* Project's headers */
+#include "parameters.h"
+
+namespace random_access {
+
+/**
+ * @brief The MPI communication that is used to exchange the buckets between the ranks
+ * 
+ */
+enum class BucketExchangeType {
+    /**
+     * @brief The number of updates is exchanged with MPI_Alltoall and only the filled part of the buckets is sent with MPI_Alltoallv
+     * 
+     */
+    alltoallv,
+    /**
+     * @brief The complete buckets are sent to all ranks with persistent MPI_Isend and MPI_Irecv requests
+     * 
+     */
+    persistent
+};
+
+/**
+ * @brief Convert the name of a bucket exchange type as it is given in the command line to the enum
+ * 
+ * @param name Either "alltoallv" or "persistent"
+ * @return BucketExchangeType The matching exchange type
+ * @throws std::runtime_error if the name is unknown
+ */
+BucketExchangeType
+retrieveBucketExchangeType(const std::string &name);
+
+/**
+ * @brief Convert the bucket exchange type to its name
+ * 
+ * @param type The exchange type
+ * @return std::string The name of the exchange type
+ */
+std::string
+bucketExchangeTypeToString(BucketExchangeType type);
+
+/**
+ * @brief Sorts a stream of updates into fixed-size buckets, one for every destination rank, and exchanges the buckets
+ *          between all ranks in batches.
+ *          The destination of an update is the rank that owns the updated address, so the data array is expected
+ *          to be distributed in contiguous chunks of the same size over the ranks.
+ *          All buckets are stored in a single array with a header of two values in front of every bucket, that contain
+ *          the number of updates and if the sending rank has more updates. The buckets are sent directly from this array.
+ * 
+ */
+class UpdateBuckets {
+
+public:
+
+    /**
+     * @brief Signature of the function that is called with the received updates of every source rank
+     * 
+     */
+    using UpdateHandler = std::function<void(const HOST_DATA_TYPE* updates, size_t count)>;
+
+    /**
+     * @brief Construct a new Update Buckets object
+     *          In the persistent mode, this is a collective operation.
+     * 
+     * @param num_destinations Number of ranks the updates are distributed over. Has to match the size of the communicator, if MPI is used.
+     * @param destination_size Number of data items owned by every rank. Has to be a power of two.
+     * @param bucket_size Maximum number of updates that are sent to a single rank in one batch
+     * @param type The MPI communication that is used to exchange the buckets
+     * @param communicator The communicator of the ranks the updates are distributed over
+     */
+#ifdef _USE_MPI_
+    UpdateBuckets(int num_destinations, HOST_DATA_TYPE destination_size, size_t bucket_size, BucketExchangeType type,
+                    MPI_Comm communicator = MPI_COMM_WORLD);
+#else
+    UpdateBuckets(int num_destinations, HOST_DATA_TYPE destination_size, size_t bucket_size, BucketExchangeType type);
+#endif
+
+    /**
+     * @brief Destroy the Update Buckets object and free the persistent requests
+     * 
+     */
+    ~UpdateBuckets();
+
+    UpdateBuckets(const UpdateBuckets&) = delete;
+    UpdateBuckets& operator=(const UpdateBuckets&) = delete;
+
+    /**
+     * @brief Sort updates into the buckets until the bucket of one destination is full
+     * 
+     * @param updates Pointer to the updates
+     * @param count Number of updates
+     * @return size_t Number of updates that were added to the buckets. Smaller than count, if a bucket is full.
+     */
+    size_t
+    insert(const HOST_DATA_TYPE* updates, size_t count);
+
+    /**
+     * @brief Exchange the buckets with all other ranks and empty them.
+     *          This is a collective operation, so all ranks have to call it the same number of times.
+     *          The return value can be used to continue the exchange until all ranks added all of their updates.
+     * 
+     * @param more_updates True, if this rank still has updates that did not fit into the buckets
+     * @param handler Function that is called with the received updates of every source rank
+     * @return true, if at least one rank has more updates
+     */
+    bool
+    exchange(bool more_updates, const UpdateHandler &handler);
+
+    /**
+     * @brief Get the destination rank of an update
+     * 
+     * @param update The update
+     * @return int The rank that owns the updated address
+     */
+    int
+    destination(HOST_DATA_TYPE update) const {
+        return static_cast<int>(((update >> 3) & address_mask) >> destination_shift);
+    }
+
+private:
+
+    /**
+     * @brief Number of values in the header of every bucket
+     * 
+     */
+    static const size_t HEADER_SIZE = 2;
+
+    int num_destinations;
+    HOST_DATA_TYPE address_mask;
+    int destination_shift;
+    size_t bucket_size;
+    size_t bucket_stride;
+    BucketExchangeType type;
+
+    /**
+     * @brief Number of updates in every bucket. Kept separately from the headers to keep it in the cache.
+     * 
+     */
+    std::vector<size_t> fill_level;
+
+    /**
+     * @brief The buckets to send, including their headers
+     * 
+     */
+    std::vector<HOST_DATA_TYPE> send_buckets;
+
+    /**
+     * @brief The received buckets, including their headers
+     * 
+     */
+    std::vector<HOST_DATA_TYPE> recv_buckets;
+
+#ifdef _USE_MPI_
+    MPI_Comm communicator;
+    std::vector<MPI_Request> requests;
+    std::vector<int> send_counts;
+    std::vector<int> recv_counts;
+    std::vector<int> displacements;
+#endif
+
+};
+
+}  // namespace random_access
+
+#endif  // SRC_HOST_UPDATE_BUCKETS_H_
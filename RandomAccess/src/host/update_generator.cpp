@@ -0,0 +1,199 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+/* Related header files */
+#include "update_generator.hpp"
+
+/* C++ standard library headers */
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Multiplier that spreads the indices of the Zipf distribution over the table, so the hot addresses are not adjacent
+ * 
+ */
+const HOST_DATA_TYPE ZIPF_SCRAMBLE_MULTIPLIER = 0x9E3779B97F4A7C15UL;
+
+/**
+ * @brief log(1 + x) / x with a Taylor series for small x to avoid the cancellation
+ */
+double
+helper1(double x) {
+    return (std::abs(x) > 1e-8) ? std::log1p(x) / x : 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+}
+
+/**
+ * @brief (exp(x) - 1) / x with a Taylor series for small x to avoid the cancellation
+ */
+double
+helper2(double x) {
+    return (std::abs(x) > 1e-8) ? std::expm1(x) / x : 1.0 + x * 0.5 * (1.0 + x / 3.0 * (1.0 + 0.25 * x));
+}
+
+}  // namespace
+
+random_access::UpdatePattern
+random_access::retrieveUpdatePattern(const std::string &name) {
+    if (name == "hpcc") {
+        return UpdatePattern::hpcc;
+    }
+    if (name == "zipf") {
+        return UpdatePattern::zipf;
+    }
+    if (name == "window") {
+        return UpdatePattern::window;
+    }
+    if (name == "trace") {
+        return UpdatePattern::trace;
+    }
+    throw std::runtime_error("Unknown update pattern: " + name + ". Use 'hpcc', 'zipf', 'window' or 'trace'!");
+}
+
+std::string
+random_access::updatePatternToString(UpdatePattern pattern) {
+    switch (pattern) {
+        case UpdatePattern::hpcc: return "hpcc";
+        case UpdatePattern::zipf: return "zipf";
+        case UpdatePattern::window: return "window";
+        case UpdatePattern::trace: return "trace";
+    }
+    return "UNKNOWN";
+}
+
+random_access::UpdateGenerator::UpdateGenerator(UpdatePattern pattern, HOST_DATA_TYPE data_size, double zipf_exponent,
+                                HOST_DATA_TYPE window_size, const std::string &trace_file, unsigned seed) :
+        pattern(pattern), data_size(data_size), window_size(window_size), seed(seed), trace_file(trace_file),
+        total_updates(4 * data_size), position(0), rng(seed), zipf_exponent(zipf_exponent) {
+    if ((data_size == 0) || (data_size & (data_size - 1))) {
+        throw std::runtime_error("The table size has to be a power of two!");
+    }
+    switch (pattern) {
+        case UpdatePattern::hpcc:
+            throw std::runtime_error("The HPCC update sequence is generated on the device!");
+        case UpdatePattern::zipf:
+            if (zipf_exponent <= 0.0) {
+                throw std::runtime_error("The exponent of the Zipf distribution has to be greater than 0!");
+            }
+            h_integral_x1 = hIntegral(1.5) - 1.0;
+            h_integral_n = hIntegral(static_cast<double>(data_size) + 0.5);
+            zipf_s = 2.0 - hIntegralInverse(hIntegral(2.5) - h(2.0));
+            break;
+        case UpdatePattern::window:
+            if (window_size == 0 || window_size > data_size) {
+                throw std::runtime_error("The window size has to be between 1 and the table size!");
+            }
+            break;
+        case UpdatePattern::trace:
+            trace.open(trace_file, std::ios::binary | std::ios::ate);
+            if (!trace.is_open()) {
+                throw std::runtime_error("The trace file could not be opened: " + trace_file);
+            }
+            total_updates = static_cast<HOST_DATA_TYPE>(trace.tellg()) / sizeof(uint64_t);
+            if (total_updates == 0) {
+                throw std::runtime_error("The trace file does not contain any addresses: " + trace_file);
+            }
+            trace.seekg(0);
+            break;
+    }
+}
+
+void
+random_access::UpdateGenerator::reset() {
+    position = 0;
+    rng.seed(seed);
+    if (pattern == UpdatePattern::trace) {
+        trace.clear();
+        trace.seekg(0);
+    }
+}
+
+size_t
+random_access::UpdateGenerator::generate(HOST_DATA_TYPE* updates, size_t count) {
+    count = static_cast<size_t>(std::min(static_cast<HOST_DATA_TYPE>(count), total_updates - position));
+    std::vector<uint64_t> addresses;
+    if (pattern == UpdatePattern::trace) {
+        addresses.resize(count);
+        trace.read(reinterpret_cast<char*>(addresses.data()), count * sizeof(uint64_t));
+        if (static_cast<size_t>(trace.gcount()) != count * sizeof(uint64_t)) {
+            throw std::runtime_error("The trace file could not be read: " + trace_file);
+        }
+    }
+    // The bits that do not encode the address are filled with random bits.
+    // The random numbers are drawn update by update, so the stream does not depend on the number of generated updates per call
+    const HOST_DATA_TYPE address_bits = (data_size << 3) - 1;
+    for (size_t i = 0; i < count; i++) {
+        HOST_DATA_TYPE address = (pattern == UpdatePattern::trace) ? (static_cast<HOST_DATA_TYPE>(addresses[i]) & (data_size - 1))
+                                                                    : nextAddress(position + i);
+        HOST_DATA_TYPE random_bits = rng();
+        updates[i] = (random_bits & ~address_bits) | (address << 3) | (random_bits & 7);
+    }
+    position += count;
+    return count;
+}
+
+HOST_DATA_TYPE
+random_access::UpdateGenerator::nextAddress(HOST_DATA_TYPE index) {
+    if (pattern == UpdatePattern::zipf) {
+        return ((zipfSample() - 1) * ZIPF_SCRAMBLE_MULTIPLIER) & (data_size - 1);
+    }
+    // The window moves on to the next part of the table after every window size updates
+    HOST_DATA_TYPE base = ((index / window_size) * window_size) & (data_size - 1);
+    return (base + rng() % window_size) & (data_size - 1);
+}
+
+HOST_DATA_TYPE
+random_access::UpdateGenerator::zipfSample() {
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    const double n = static_cast<double>(data_size);
+    while (true) {
+        double u = h_integral_n + uniform(rng) * (h_integral_x1 - h_integral_n);
+        double x = hIntegralInverse(u);
+        double k = std::floor(x + 0.5);
+        k = std::max(1.0, std::min(n, k));
+        if (k - x <= zipf_s || u >= hIntegral(k + 0.5) - h(k)) {
+            return static_cast<HOST_DATA_TYPE>(k);
+        }
+    }
+}
+
+double
+random_access::UpdateGenerator::h(double x) const {
+    return std::exp(-zipf_exponent * std::log(x));
+}
+
+double
+random_access::UpdateGenerator::hIntegral(double x) const {
+    double log_x = std::log(x);
+    return helper2((1.0 - zipf_exponent) * log_x) * log_x;
+}
+
+double
+random_access::UpdateGenerator::hIntegralInverse(double x) const {
+    double t = std::max(-1.0, x * (1.0 - zipf_exponent));
+    return std::exp(helper1(t) * x);
+}
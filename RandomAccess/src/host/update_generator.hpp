@@ -0,0 +1,187 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+#ifndef SRC_HOST_UPDATE_GENERATOR_H_
+#define SRC_HOST_UPDATE_GENERATOR_H_
+
+/* C++ standard library headers */
+#include <fstream>
+#include <random>
+#include <string>
+
+/* Project's headers */
+#include "parameters.h"
+
+namespace random_access {
+
+/**
+ * @brief The distribution of the addresses in the update stream
+ * 
+ */
+enum class UpdatePattern {
+    /**
+     * @brief The uniformly distributed pseudo random sequence of HPCC that is generated on the device
+     * 
+     */
+    hpcc,
+    /**
+     * @brief Zipf distributed addresses, so a small hot set of the table receives most of the updates
+     * 
+     */
+    zipf,
+    /**
+     * @brief Uniformly distributed addresses within a window of the table that moves on after every window size updates
+     * 
+     */
+    window,
+    /**
+     * @brief Addresses that are read from a trace file
+     * 
+     */
+    trace
+};
+
+/**
+ * @brief Convert the name of an update pattern as it is given in the command line to the enum
+ * 
+ * @param name Either "hpcc", "zipf", "window" or "trace"
+ * @return UpdatePattern The matching pattern
+ * @throws std::runtime_error if the name is unknown
+ */
+UpdatePattern
+retrieveUpdatePattern(const std::string &name);
+
+/**
+ * @brief Convert the update pattern to its name
+ * 
+ * @param pattern The update pattern
+ * @return std::string The name of the pattern
+ */
+std::string
+updatePatternToString(UpdatePattern pattern);
+
+/**
+ * @brief Generates a stream of updates with a configurable locality on the host.
+ *          The updates are encoded like the updates of the HPCC sequence: bits 3 and above contain the updated address,
+ *          the whole update is XORed to the table. The bits above the address are random.
+ *          The stream is deterministic for a given seed, so it can be replayed for the validation with reset().
+ * 
+ */
+class UpdateGenerator {
+
+public:
+
+    /**
+     * @brief Construct a new Update Generator object
+     * 
+     * @param pattern The distribution of the addresses. Must not be UpdatePattern::hpcc.
+     * @param data_size Size of the updated table. Has to be a power of two.
+     * @param zipf_exponent Exponent of the Zipf distribution. The probability of the k-th most frequent address is proportional to 1/k^exponent
+     * @param window_size Number of addresses in the window of the window pattern
+     * @param trace_file Path to the trace file. It contains the addresses as binary 64 bit unsigned integers. They are taken modulo the table size.
+     * @param seed Seed of the random number generator
+     * @throws std::runtime_error if the parameters are invalid or the trace file can not be opened
+     */
+    UpdateGenerator(UpdatePattern pattern, HOST_DATA_TYPE data_size, double zipf_exponent, HOST_DATA_TYPE window_size,
+                    const std::string &trace_file, unsigned seed);
+
+    /**
+     * @brief Number of updates in the stream. 4 times the table size like in HPCC or the number of addresses in the trace file.
+     * 
+     * @return HOST_DATA_TYPE The number of updates
+     */
+    HOST_DATA_TYPE
+    size() const {
+        return total_updates;
+    }
+
+    /**
+     * @brief Generate the next updates of the stream
+     * 
+     * @param updates Array the updates are written to
+     * @param count Maximum number of generated updates
+     * @return size_t Number of generated updates. Smaller than count at the end of the stream.
+     */
+    size_t
+    generate(HOST_DATA_TYPE* updates, size_t count);
+
+    /**
+     * @brief Restart the stream from the beginning
+     * 
+     */
+    void
+    reset();
+
+private:
+
+    UpdatePattern pattern;
+    HOST_DATA_TYPE data_size;
+    HOST_DATA_TYPE window_size;
+    unsigned seed;
+    std::string trace_file;
+    HOST_DATA_TYPE total_updates;
+    HOST_DATA_TYPE position;
+    std::mt19937_64 rng;
+    std::ifstream trace;
+
+    /**
+     * @brief Precomputed values of the rejection-inversion sampling of the Zipf distribution
+     * 
+     */
+    double zipf_exponent;
+    double h_integral_x1;
+    double h_integral_n;
+    double zipf_s;
+
+    /**
+     * @brief Draw an index from the Zipf distribution using rejection-inversion sampling
+     *          as proposed by Hörmann and Derflinger. It does not require a table of probabilities.
+     * 
+     * @return HOST_DATA_TYPE The index between 1 and the table size
+     */
+    HOST_DATA_TYPE
+    zipfSample();
+
+    double
+    h(double x) const;
+
+    double
+    hIntegral(double x) const;
+
+    double
+    hIntegralInverse(double x) const;
+
+    /**
+     * @brief Calculate the address of the next update
+     * 
+     * @param index Position of the update in the stream
+     * @return HOST_DATA_TYPE The address
+     */
+    HOST_DATA_TYPE
+    nextAddress(HOST_DATA_TYPE index);
+
+};
+
+}  // namespace random_access
+
+#endif  // SRC_HOST_UPDATE_GENERATOR_H_
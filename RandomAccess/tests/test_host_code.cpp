@@ -1,6 +1,11 @@
 //
 // Created by Marius Meyer on 04.12.19
 //
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <numeric>
+
 #include "gtest/gtest.h"
 #include "parameters.h"
 #include "random_access_benchmark.hpp"
@@ -56,3 +61,172 @@ TEST_F(RandomAccessHostCodeTest, ResultValidationWorksForWrongUpdates) {
     bool success = bm->validateOutputAndPrintError( *data);
     EXPECT_FALSE(success);
 }
+
+/**
+ * Check if the jump-ahead calculates the same values as stepping through the pseudo random sequence
+ */
+TEST_F(RandomAccessHostCodeTest, JumpAheadMatchesSequence) {
+    HOST_DATA_TYPE ran = 1;
+    for (HOST_DATA_TYPE n = 0; n < 1000; n++) {
+        EXPECT_EQ(random_access::starts(n), ran);
+        HOST_DATA_TYPE_SIGNED v = 0;
+        if (((HOST_DATA_TYPE_SIGNED) ran) < 0) {
+            v = POLY;
+        }
+        ran = (ran << 1) ^ v;
+    }
+}
+
+/**
+ * Check if the start values are placed at the given distance in the pseudo random sequence
+ */
+TEST_F(RandomAccessHostCodeTest, StartValuesHaveCorrectDistance) {
+    HOST_DATA_TYPE values[4];
+    random_access::calculateRandomStartValues(values, 4, 100);
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(values[i], random_access::starts(i * 100));
+    }
+    EXPECT_EQ(values[0], 1);
+}
+
+/**
+ * Check if the update buckets stop accepting updates when the bucket of one destination is full
+ */
+TEST(UpdateBucketsTest, InsertStopsAtFullBucket) {
+    random_access::UpdateBuckets buckets(1, 1024, 4, random_access::BucketExchangeType::alltoallv);
+    std::vector<HOST_DATA_TYPE> updates(10, 8);
+    EXPECT_EQ(buckets.insert(updates.data(), updates.size()), 4);
+    EXPECT_EQ(buckets.insert(updates.data(), updates.size()), 0);
+}
+
+/**
+ * Check if all updates are received exactly once and in order when they are exchanged in multiple batches
+ */
+TEST(UpdateBucketsTest, AllUpdatesAreReceivedInBatches) {
+    for (auto type : {random_access::BucketExchangeType::alltoallv, random_access::BucketExchangeType::persistent}) {
+        random_access::UpdateBuckets buckets(1, 1024, 7, type);
+        std::vector<HOST_DATA_TYPE> updates(100);
+        for (HOST_DATA_TYPE i = 0; i < updates.size(); i++) {
+            updates[i] = random_access::starts(i);
+        }
+        std::vector<HOST_DATA_TYPE> received;
+        size_t sent = 0;
+        int exchanges = 0;
+        bool pending = true;
+        while (pending) {
+            sent += buckets.insert(&updates[sent], updates.size() - sent);
+            pending = buckets.exchange(sent < updates.size(), [&received](const HOST_DATA_TYPE* u, size_t count) {
+                received.insert(received.end(), u, u + count);
+            });
+            exchanges++;
+        }
+        EXPECT_EQ(received, updates);
+        EXPECT_EQ(exchanges, 15);
+    }
+}
+
+/**
+ * Check if an unknown bucket exchange type is rejected
+ */
+TEST(UpdateBucketsTest, UnknownExchangeTypeThrows) {
+    EXPECT_THROW(random_access::retrieveBucketExchangeType("allgather"), std::runtime_error);
+    EXPECT_EQ(random_access::retrieveBucketExchangeType("persistent"), random_access::BucketExchangeType::persistent);
+}
+
+/**
+ * Check if the update patterns that are generated on the host are rejected for the distributed execution
+ */
+TEST_F(RandomAccessHostCodeTest, UpdatePatternWithDistributedIsDetected) {
+    bm->getExecutionSettings().programSettings->updatePattern = random_access::UpdatePattern::zipf;
+    EXPECT_TRUE(bm->checkInputParameters());
+    bm->getExecutionSettings().programSettings->distributed = true;
+    EXPECT_FALSE(bm->checkInputParameters());
+}
+
+/**
+ * Check if the validation replays the update stream of the update patterns
+ */
+TEST_F(RandomAccessHostCodeTest, ResultValidationWorksForUpdatePattern) {
+    bm->getExecutionSettings().programSettings->updatePattern = random_access::UpdatePattern::window;
+    bm->getExecutionSettings().programSettings->patternWindow = 64;
+    auto data = bm->generateInputData();
+    // do random accesses
+    bm->validateOutputAndPrintError(*data);
+    // check correctness of random accesses
+    EXPECT_TRUE(bm->validateOutputAndPrintError(*data));
+}
+
+/**
+ * Check if an unknown update pattern is rejected
+ */
+TEST(UpdateGeneratorTest, UnknownPatternThrows) {
+    EXPECT_THROW(random_access::retrieveUpdatePattern("sequential"), std::runtime_error);
+    EXPECT_EQ(random_access::retrieveUpdatePattern("zipf"), random_access::UpdatePattern::zipf);
+}
+
+/**
+ * Check if the generated addresses are in the table and the stream is the same after a reset
+ */
+TEST(UpdateGeneratorTest, ResetReplaysAddressesInRange) {
+    for (auto pattern : {random_access::UpdatePattern::zipf, random_access::UpdatePattern::window}) {
+        random_access::UpdateGenerator generator(pattern, 1024, 0.99, 64, "", 1);
+        EXPECT_EQ(generator.size(), 4096UL);
+        std::vector<HOST_DATA_TYPE> first(generator.size());
+        std::vector<HOST_DATA_TYPE> second(generator.size());
+        EXPECT_EQ(generator.generate(first.data(), 1000), 1000UL);
+        EXPECT_EQ(generator.generate(&first[1000], first.size()), first.size() - 1000);
+        EXPECT_EQ(generator.generate(first.data(), first.size()), 0UL);
+        generator.reset();
+        EXPECT_EQ(generator.generate(second.data(), second.size()), second.size());
+        EXPECT_EQ(first, second);
+    }
+}
+
+/**
+ * Check if most updates of the Zipf distribution hit a small set of addresses
+ */
+TEST(UpdateGeneratorTest, ZipfUpdatesHitHotSet) {
+    random_access::UpdateGenerator generator(random_access::UpdatePattern::zipf, 1024, 0.99, 1, "", 1);
+    std::vector<HOST_DATA_TYPE> updates(generator.size());
+    generator.generate(updates.data(), updates.size());
+    std::vector<size_t> hits(1024);
+    for (HOST_DATA_TYPE u : updates) {
+        hits[(u >> 3) & 1023]++;
+    }
+    std::sort(hits.rbegin(), hits.rend());
+    size_t hot_updates = std::accumulate(hits.begin(), hits.begin() + 32, 0UL);
+    EXPECT_GT(hot_updates, updates.size() / 3);
+}
+
+/**
+ * Check if the updates of the window pattern stay in the current window
+ */
+TEST(UpdateGeneratorTest, WindowUpdatesStayInWindow) {
+    random_access::UpdateGenerator generator(random_access::UpdatePattern::window, 1024, 0.99, 64, "", 1);
+    std::vector<HOST_DATA_TYPE> updates(generator.size());
+    generator.generate(updates.data(), updates.size());
+    for (size_t i = 0; i < updates.size(); i++) {
+        HOST_DATA_TYPE address = (updates[i] >> 3) & 1023;
+        EXPECT_EQ(address / 64, (i / 64) % 16);
+    }
+}
+
+/**
+ * Check if the addresses of the trace file are used modulo the table size
+ */
+TEST(UpdateGeneratorTest, TraceAddressesAreUsed) {
+    std::vector<uint64_t> addresses = {1, 2, 1025, 7};
+    {
+        std::ofstream f("ra_test_trace.bin", std::ios::binary);
+        f.write(reinterpret_cast<const char*>(addresses.data()), addresses.size() * sizeof(uint64_t));
+    }
+    random_access::UpdateGenerator generator(random_access::UpdatePattern::trace, 1024, 0.99, 1, "ra_test_trace.bin", 1);
+    std::remove("ra_test_trace.bin");
+    EXPECT_EQ(generator.size(), 4UL);
+    std::vector<HOST_DATA_TYPE> updates(4);
+    EXPECT_EQ(generator.generate(updates.data(), updates.size()), 4UL);
+    std::vector<HOST_DATA_TYPE> expected = {1, 2, 1, 7};
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ((updates[i] >> 3) & 1023, expected[i]);
+    }
+}
@@ -49,3 +49,71 @@ TEST_F(RandomAccessKernelTest, FPGAErrorBelow1Percent) {
     bool success = bm->validateOutputAndPrintError(*data);
     EXPECT_TRUE(success);
 }
+
+/**
+ * Distributed execution that forwards the updates over the host returns correct results
+ */
+TEST_F(RandomAccessKernelTest, FPGADistributedErrorBelow1Percent) {
+    bm->getExecutionSettings().programSettings->distributed = true;
+    auto result = bm->executeKernel(*data);
+    bool success = bm->validateOutputAndPrintError(*data);
+    EXPECT_TRUE(success);
+}
+
+/**
+ * Execution with the host generated Zipf update pattern returns correct results
+ */
+TEST_F(RandomAccessKernelTest, FPGAZipfPatternErrorBelow1Percent) {
+    bm->getExecutionSettings().programSettings->updatePattern = random_access::UpdatePattern::zipf;
+    auto result = bm->executeKernel(*data);
+    EXPECT_EQ(result->updateCount, 4 * bm->getExecutionSettings().programSettings->dataSize);
+    bool success = bm->validateOutputAndPrintError(*data);
+    EXPECT_TRUE(success);
+}
+
+/**
+ * Execution with the CPU backend and the window update pattern returns correct results
+ */
+TEST_F(RandomAccessKernelTest, CPUWindowPatternNoErrors) {
+    bm->getExecutionSettings().programSettings->communicationType = hpcc_base::CommunicationType::cpu_only;
+    bm->getExecutionSettings().programSettings->updatePattern = random_access::UpdatePattern::window;
+    bm->getExecutionSettings().programSettings->patternWindow = 16;
+    auto result = bm->executeKernel(*data);
+    bool success = bm->validateOutputAndPrintError(*data);
+    EXPECT_TRUE(success);
+}
+
+/**
+ * Execution with the resident data array returns correct results for an even number of repetitions
+ */
+TEST_F(RandomAccessKernelTest, FPGAResidentDataErrorBelow1Percent2Rep) {
+    bm->getExecutionSettings().programSettings->residentData = true;
+    bm->getExecutionSettings().programSettings->numRepetitions = 2;
+    auto result = bm->executeKernel(*data);
+    EXPECT_EQ(result->times.size(), 2);
+    bool success = bm->validateOutputAndPrintError(*data);
+    EXPECT_TRUE(success);
+}
+
+/**
+ * Execution with the resident data array returns correct results for an odd number of repetitions
+ */
+TEST_F(RandomAccessKernelTest, FPGAResidentDataErrorBelow1Percent3Rep) {
+    bm->getExecutionSettings().programSettings->residentData = true;
+    bm->getExecutionSettings().programSettings->numRepetitions = 3;
+    auto result = bm->executeKernel(*data);
+    bool success = bm->validateOutputAndPrintError(*data);
+    EXPECT_TRUE(success);
+}
+
+/**
+ * Execution with the CPU backend returns the correct number of measurements and correct results
+ */
+TEST_F(RandomAccessKernelTest, CPUNoErrorsFor3Rep) {
+    bm->getExecutionSettings().programSettings->communicationType = hpcc_base::CommunicationType::cpu_only;
+    bm->getExecutionSettings().programSettings->numRepetitions = 3;
+    auto result = bm->executeKernel(*data);
+    EXPECT_EQ(result->times.size(), 3);
+    bool success = bm->validateOutputAndPrintError(*data);
+    EXPECT_TRUE(success);
+}
@@ -1,12 +1,36 @@
 
 global_memory_name = "HBM"
 
+def memory_bank(replication, buffer, buffers_per_replication, num_global_memory_banks):
+    """
+    Get the memory bank of a buffer from the map given in the global variable memory_banks.
+    It uses the same format as the --memory-banks option of the host code, so both can be
+    given the same map e.g. with -p "memory_banks='rr:32'" in KERNEL_CODE_GENERATION_PARAMETERS.
+    If no map is given, all buffers of replication i are placed in bank i.
+
+    @param replication Index of the kernel replication
+    @param buffer Index of the buffer within the replication
+    @param buffers_per_replication Number of buffers every replication uses
+    @param num_global_memory_banks Number of global memory banks that should be used for generation
+
+    @return Index of the memory bank
+    """
+    banks = globals().get("memory_banks", "")
+    if banks.startswith("rr:"):
+        return (replication * buffers_per_replication + buffer) % int(banks[3:])
+    if banks:
+        replications = [[int(b) for b in r.split(":")] for r in banks.split(",")]
+        replication_banks = replications[replication % len(replications)]
+        return replication_banks[buffer % len(replication_banks)]
+    return replication % num_global_memory_banks
+
 def generate_attributes(num_replications, num_global_memory_banks=32):
     """
     Generates the kernel attributes for the global memory. They specify in which 
     global memory the buffer is located. The buffers will be placed using a 
     round robin scheme using the available global memory banks and the number of
     replications that should be generated (e.g. if a global memory contains multiple banks)
+    or using the map given in memory_banks.
 
     @param num_replications Number okernel replications
     @param num_global_memory_banks Number of global memory banks that should be used for generation
@@ -15,5 +39,5 @@ def generate_attributes(num_replications, num_global_memory_banks=32):
     """
     global_memory_names = [ "%s%d" % (global_memory_name, i) for i in range(num_global_memory_banks)]
     return [ "__attribute__((buffer_location(\"%s\")))" 
-            % (global_memory_names[i % num_global_memory_banks])
+            % (global_memory_names[memory_bank(i, 0, 3, num_global_memory_banks) % num_global_memory_banks])
             for i in range(num_replications)]
\ No newline at end of file
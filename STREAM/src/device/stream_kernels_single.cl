@@ -4,9 +4,19 @@ They can be selected using the operation_type switch.
 
 KERNEL_NUMBER will be replaced by the build script with the ID of the current replication.
  That means the kernels will be named copy_0, copy_1, ... up to the number of given replications.
+
+If USE_FUSED_KERNEL is defined, the kernels fused_0, fused_1, ... are added. They execute copy, scale, add and triad
+for a given number of repetitions in a single launch.
+
+If USE_ACCESS_PATTERN_KERNEL is defined, the kernels pattern_0, pattern_1, ... are added. They copy an array
+with blocked strided accesses or indexed gather or scatter accesses.
 */
 #include "parameters.h"
 
+// Every kernel replication gets its own counter slot
+#define KERNEL_COUNTER_SLOTS /*PY_CODE_GEN num_replications*/
+#include "kernel_counters.h"
+
 #if DATA_TYPE_SIZE == 8
 #pragma OPENCL EXTENSION cl_khr_fp64 : enable
 #endif
@@ -30,7 +40,9 @@ void calc_/*PY_CODE_GEN i*/(__global /*PY_CODE_GEN kernel_param_attributes[i]*/
           __global /*PY_CODE_GEN kernel_param_attributes[i]*/ DEVICE_ARRAY_DATA_TYPE *restrict out,
           const DEVICE_SCALAR_DATA_TYPE scalar,
           const uint array_size,
-          const uint operation_type) {
+          const uint operation_type
+          KERNEL_COUNTERS_ARG) {
+    KERNEL_COUNTERS_START(/*PY_CODE_GEN i*/)
 #ifndef INNER_LOOP_BUFFERS
         DEVICE_ARRAY_DATA_TYPE buffer1[BUFFER_SIZE];
 #endif
@@ -57,6 +69,7 @@ void calc_/*PY_CODE_GEN i*/(__global /*PY_CODE_GEN kernel_param_attributes[i]*/
             // Registers used to store the values for all unrolled
             // load operations from global memory
             DEVICE_ARRAY_DATA_TYPE chunk[UNROLL_COUNT];
+            KERNEL_COUNTERS_ACTIVE(1)
 
             // Load values from global memory into the registers
             // The number of values is defined by UNROLL_COUNT
@@ -82,6 +95,7 @@ void calc_/*PY_CODE_GEN i*/(__global /*PY_CODE_GEN kernel_param_attributes[i]*/
                 // Registers used to store the values for all unrolled
                 // load operations from global memory
                 DEVICE_ARRAY_DATA_TYPE chunk[UNROLL_COUNT];
+                KERNEL_COUNTERS_ACTIVE(1)
 
                 // Load values from global memory into the registers
                 // The number of values is defined by UNROLL_COUNT
@@ -109,6 +123,7 @@ void calc_/*PY_CODE_GEN i*/(__global /*PY_CODE_GEN kernel_param_attributes[i]*/
             // Registers used to store the values for all unrolled
             // load operations from local memory
             DEVICE_ARRAY_DATA_TYPE chunk[UNROLL_COUNT];
+            KERNEL_COUNTERS_ACTIVE(1)
 
             // Load values from local memory into the registers
             // The number of values is defined by UNROLL_COUNT
@@ -124,6 +139,193 @@ void calc_/*PY_CODE_GEN i*/(__global /*PY_CODE_GEN kernel_param_attributes[i]*/
             }             
     	}
     }
+    KERNEL_COUNTERS_END(/*PY_CODE_GEN i*/)
 }
 
 // PY_CODE_GEN block_end
+
+#ifdef USE_FUSED_KERNEL
+
+#ifdef INTEL_FPGA
+#pragma OPENCL EXTENSION cl_intel_channels : enable
+
+// Without buffering, a read always returns the current cycle count of the timer
+channel ulong ch_fused_timer[/*PY_CODE_GEN num_replications*/] __attribute__((depth(0)));
+
+/**
+Free running cycle counter for every replication of the fused kernel
+ */
+__kernel
+__attribute__((max_global_work_dim(0)))
+__attribute__((autorun))
+__attribute__((num_compute_units(/*PY_CODE_GEN num_replications*/)))
+void fused_timer() {
+    ulong cycles = 0;
+    while (1) {
+        write_channel_nb_intel(ch_fused_timer[get_compute_id(0)], cycles);
+        cycles++;
+    }
+}
+
+// Store the current cycle count of the timer of a replication
+#define FUSED_TIMESTAMP(slot, dst) \
+    mem_fence(CLK_CHANNEL_MEM_FENCE | CLK_GLOBAL_MEM_FENCE); \
+    dst = read_channel_intel(ch_fused_timer[slot]); \
+    mem_fence(CLK_CHANNEL_MEM_FENCE | CLK_GLOBAL_MEM_FENCE);
+#else
+// There is no free running counter available, so no timestamps are taken
+#define FUSED_TIMESTAMP(slot, dst) mem_fence(CLK_GLOBAL_MEM_FENCE);
+#endif
+
+/**
+Execute one STREAM operation on the whole array of a replication within the fused kernel.
+Calculates out = scalar * in1 + in2, if use_in2 is true and out = scalar * in1 otherwise.
+*/
+void fused_operation(__global const DEVICE_ARRAY_DATA_TYPE *restrict in1,
+          __global const DEVICE_ARRAY_DATA_TYPE *restrict in2,
+          __global DEVICE_ARRAY_DATA_TYPE *restrict out,
+          const DEVICE_SCALAR_DATA_TYPE scalar,
+          const uint number_elements,
+          const bool use_in2) {
+#ifdef INTEL_FPGA
+#if (BUFFER_SIZE > UNROLL_COUNT)
+#pragma disable_loop_pipelining
+#endif
+#endif
+    for(uint i = 0;i<number_elements;i += BUFFER_SIZE){
+        DEVICE_ARRAY_DATA_TYPE buffer1[BUFFER_SIZE];
+#ifdef INTEL_FPGA
+#pragma nofusion
+#endif
+        for (uint k = 0;k<BUFFER_SIZE; k += UNROLL_COUNT) {
+            __attribute__((opencl_unroll_hint(UNROLL_COUNT)))
+            for (uint u = 0; u < UNROLL_COUNT; u++) {
+                buffer1[k + u] = scalar * in1[i + k + u];
+            }
+        }
+        if (use_in2) {
+#ifdef INTEL_FPGA
+#pragma nofusion
+#endif
+            for (uint k = 0;k<BUFFER_SIZE; k += UNROLL_COUNT) {
+                __attribute__((opencl_unroll_hint(UNROLL_COUNT)))
+                for (uint u = 0; u < UNROLL_COUNT; u++) {
+                    buffer1[k + u] += in2[i + k + u];
+                }
+            }
+        }
+#ifdef INTEL_FPGA
+#pragma nofusion
+#endif
+        for (uint k = 0;k<BUFFER_SIZE; k += UNROLL_COUNT) {
+            __attribute__((opencl_unroll_hint(UNROLL_COUNT)))
+            for (uint u = 0; u < UNROLL_COUNT; u++) {
+                out[i + k + u] = buffer1[k + u];
+            }
+        }
+    }
+}
+
+// PY_CODE_GEN block_start [replace(local_variables=locals()) for i in range(num_replications)]
+/**
+Execute copy, scale, add and triad on the arrays for the given number of repetitions.
+Before the first and after every operation, the cycle count is stored in timestamps, so
+FUSED_TIMESTAMPS_PER_REPETITION values are stored per repetition.
+*/
+__kernel
+__attribute__((uses_global_work_offset(0)))
+__attribute__((max_global_work_dim(0)))
+void fused_/*PY_CODE_GEN i*/(__global /*PY_CODE_GEN kernel_param_attributes[i]*/ DEVICE_ARRAY_DATA_TYPE *restrict a,
+          __global /*PY_CODE_GEN kernel_param_attributes[i]*/ DEVICE_ARRAY_DATA_TYPE *restrict b,
+          __global /*PY_CODE_GEN kernel_param_attributes[i]*/ DEVICE_ARRAY_DATA_TYPE *restrict c,
+          const DEVICE_SCALAR_DATA_TYPE scalar,
+          const uint array_size,
+          const uint repetitions,
+          __global ulong *restrict timestamps) {
+    uint number_elements = array_size / VECTOR_COUNT;
+#ifdef INTEL_FPGA
+#pragma disable_loop_pipelining
+#endif
+    for (uint r = 0; r < repetitions; r++) {
+        __global ulong *restrict ts = &timestamps[r * FUSED_TIMESTAMPS_PER_REPETITION];
+        FUSED_TIMESTAMP(/*PY_CODE_GEN i*/, ts[0])
+        fused_operation(a, a, c, (DEVICE_SCALAR_DATA_TYPE) 1, number_elements, false);
+        FUSED_TIMESTAMP(/*PY_CODE_GEN i*/, ts[1])
+        fused_operation(c, c, b, scalar, number_elements, false);
+        FUSED_TIMESTAMP(/*PY_CODE_GEN i*/, ts[2])
+        fused_operation(a, b, c, (DEVICE_SCALAR_DATA_TYPE) 1, number_elements, true);
+        FUSED_TIMESTAMP(/*PY_CODE_GEN i*/, ts[3])
+        fused_operation(c, b, a, scalar, number_elements, true);
+        FUSED_TIMESTAMP(/*PY_CODE_GEN i*/, ts[4])
+    }
+}
+
+// PY_CODE_GEN block_end
+
+#endif
+
+#ifdef USE_ACCESS_PATTERN_KERNEL
+
+// PY_CODE_GEN block_start [replace(local_variables=locals()) for i in range(num_replications)]
+/**
+Copy the values from in to out with the given access pattern. Every value is accessed exactly once:
+
+ - BLOCKED_STRIDED_PATTERN_TYPE: The array is divided into blocks of block_size values. The blocks are copied in the
+        order 0, stride, 2 * stride, ..., then 1, stride + 1, ... . With a block size of 1, this is a constant stride.
+ - GATHER_PATTERN_TYPE: out[k] = in[indices[k]]
+ - SCATTER_PATTERN_TYPE: out[indices[k]] = in[k]
+
+For the indexed patterns, indices has to be a permutation of the array indices. array_size has to be a multiple of block_size.
+*/
+__kernel
+__attribute__((uses_global_work_offset(0)))
+__attribute__((max_global_work_dim(0)))
+void pattern_/*PY_CODE_GEN i*/(__global /*PY_CODE_GEN kernel_param_attributes[i]*/ const DEVICE_SCALAR_DATA_TYPE *restrict in,
+          __global /*PY_CODE_GEN kernel_param_attributes[i]*/ DEVICE_SCALAR_DATA_TYPE *restrict out,
+          __global /*PY_CODE_GEN kernel_param_attributes[i]*/ const uint *restrict indices,
+          const uint array_size,
+          const uint stride,
+          const uint block_size,
+          const uint pattern_type) {
+    if (pattern_type == BLOCKED_STRIDED_PATTERN_TYPE) {
+        uint num_blocks = array_size / block_size;
+        uint block = 0;
+        uint offset = 0;
+        uint start_block = 0;
+        // The nested traversal is flattened into a single loop, so it can be pipelined
+#ifdef INTEL_FPGA
+#pragma ivdep
+#endif
+        for (uint k = 0; k < array_size; k++) {
+            uint index = block * block_size + offset;
+            out[index] = in[index];
+            offset++;
+            if (offset == block_size) {
+                offset = 0;
+                block += stride;
+                if (block >= num_blocks) {
+                    start_block++;
+                    block = start_block;
+                }
+            }
+        }
+    }
+    else if (pattern_type == GATHER_PATTERN_TYPE) {
+        for (uint k = 0; k < array_size; k++) {
+            out[k] = in[indices[k]];
+        }
+    }
+    else {
+        // The indices are a permutation, so the writes never depend on each other
+#ifdef INTEL_FPGA
+#pragma ivdep
+#endif
+        for (uint k = 0; k < array_size; k++) {
+            out[indices[k]] = in[k];
+        }
+    }
+}
+
+// PY_CODE_GEN block_end
+
+#endif
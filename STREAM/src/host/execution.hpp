@@ -41,6 +41,12 @@ SOFTWARE.
 #define SCALE_KEY "Scale"
 #define ADD_KEY "Add"
 #define TRIAD_KEY "Triad"
+#define STREAMING_KEY "Streaming"
+#define FUSED_KEY "Fused"
+#define STRIDED_KEY "Strided"
+#define BLOCKED_KEY "Blocked"
+#define GATHER_KEY "Gather"
+#define SCATTER_KEY "Scatter"
 
 namespace bm_execution {
 
@@ -50,23 +56,51 @@ namespace bm_execution {
             {COPY_KEY, 2.0},
             {SCALE_KEY, 2.0},
             {ADD_KEY, 3.0},
-            {TRIAD_KEY, 3.0}
+            {TRIAD_KEY, 3.0},
+            {STREAMING_KEY, 6.0},
+            {FUSED_KEY, 10.0},
+            // Only the copied values are counted for the access patterns, not the index array
+            {STRIDED_KEY, 2.0},
+            {BLOCKED_KEY, 2.0},
+            {GATHER_KEY, 2.0},
+            {SCATTER_KEY, 2.0}
     };
 
     /**
      * @brief This method will prepare and execute the FPGA kernel and measure the execution time
      * 
+     * @tparam T The data type of the arrays. It has to match the data type of the kernels in the bitstream.
+     *          Instantiated for half_float::half, cl_float and cl_double.
      * @param config The ExecutionSettings with the OpenCL objects and program settings
      * @param A The array A of the stream benchmark
      * @param B The array B of the stream benchmark
      * @param C The array C of the stream benchmark
      * @return std::unique_ptr<stream::StreamExecutionTimings> The measured timings for all stream operations
      */
+    template<typename T>
     std::unique_ptr<stream::StreamExecutionTimings>
     calculate(const hpcc_base::ExecutionSettings<stream::StreamProgramSettings>& config,
-              HOST_DATA_TYPE* A,
-              HOST_DATA_TYPE* B,
-              HOST_DATA_TYPE* C);
+              T* A,
+              T* B,
+              T* C);
+
+    /**
+     * @brief This method will execute the stream operations on the CPU using OpenMP and measure the execution time.
+     *          It is used as baseline with the communication type CPU and does not require a bitstream.
+     * 
+     * @tparam T The data type of the arrays. Instantiated for half_float::half, cl_float and cl_double.
+     * @param config The ExecutionSettings with the program settings
+     * @param A The array A of the stream benchmark
+     * @param B The array B of the stream benchmark
+     * @param C The array C of the stream benchmark
+     * @return std::unique_ptr<stream::StreamExecutionTimings> The measured timings for all stream operations
+     */
+    template<typename T>
+    std::unique_ptr<stream::StreamExecutionTimings>
+    calculate_cpu(const hpcc_base::ExecutionSettings<stream::StreamProgramSettings>& config,
+              T* A,
+              T* B,
+              T* C);
 
 }  // namespace bm_execution
 
@@ -0,0 +1,118 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* Related header files */
+#include "execution.hpp"
+
+/* C++ standard library headers */
+#include <chrono>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace bm_execution {
+
+    /*
+    Execute the stream operations with OpenMP on the CPU
+     @copydoc bm_execution::calculate_cpu()
+    */
+    template<typename T>
+    std::unique_ptr<stream::StreamExecutionTimings>
+    calculate_cpu(const hpcc_base::ExecutionSettings<stream::StreamProgramSettings>& config,
+              T* A,
+              T* B,
+              T* C) {
+        const long array_size = config.programSettings->streamArraySize;
+        const T scalar = static_cast<T>(3.0);
+        const T test_scalar = static_cast<T>(2.0);
+
+        // Same modification of A as done by the test kernel on the FPGA, so the validation stays unchanged
+        #pragma omp parallel for schedule(static)
+        for (long j = 0; j < array_size; j++) {
+            A[j] = test_scalar * A[j];
+        }
+
+        std::map<std::string, std::vector<double>> timingMap;
+        timingMap.insert({COPY_KEY, std::vector<double>()});
+        timingMap.insert({SCALE_KEY, std::vector<double>()});
+        timingMap.insert({ADD_KEY, std::vector<double>()});
+        timingMap.insert({TRIAD_KEY, std::vector<double>()});
+
+        for (uint r = 0; r < config.programSettings->numRepetitions; r++) {
+            auto startExecution = std::chrono::high_resolution_clock::now();
+            #pragma omp parallel for schedule(static)
+            for (long j = 0; j < array_size; j++) {
+                C[j] = A[j];
+            }
+            auto endExecution = std::chrono::high_resolution_clock::now();
+            timingMap[COPY_KEY].push_back(std::chrono::duration_cast<std::chrono::duration<double>>
+                    (endExecution - startExecution).count());
+
+            startExecution = std::chrono::high_resolution_clock::now();
+            #pragma omp parallel for schedule(static)
+            for (long j = 0; j < array_size; j++) {
+                B[j] = scalar * C[j];
+            }
+            endExecution = std::chrono::high_resolution_clock::now();
+            timingMap[SCALE_KEY].push_back(std::chrono::duration_cast<std::chrono::duration<double>>
+                    (endExecution - startExecution).count());
+
+            startExecution = std::chrono::high_resolution_clock::now();
+            #pragma omp parallel for schedule(static)
+            for (long j = 0; j < array_size; j++) {
+                C[j] = A[j] + B[j];
+            }
+            endExecution = std::chrono::high_resolution_clock::now();
+            timingMap[ADD_KEY].push_back(std::chrono::duration_cast<std::chrono::duration<double>>
+                    (endExecution - startExecution).count());
+
+            startExecution = std::chrono::high_resolution_clock::now();
+            #pragma omp parallel for schedule(static)
+            for (long j = 0; j < array_size; j++) {
+                A[j] = B[j] + scalar * C[j];
+            }
+            endExecution = std::chrono::high_resolution_clock::now();
+            timingMap[TRIAD_KEY].push_back(std::chrono::duration_cast<std::chrono::duration<double>>
+                    (endExecution - startExecution).count());
+        }
+
+        std::unique_ptr<stream::StreamExecutionTimings> result(new stream::StreamExecutionTimings{
+                timingMap,
+                config.programSettings->streamArraySize,
+                {}
+        });
+        return result;
+    }
+
+    template std::unique_ptr<stream::StreamExecutionTimings>
+    calculate_cpu<half_float::half>(const hpcc_base::ExecutionSettings<stream::StreamProgramSettings>& config,
+              half_float::half* A, half_float::half* B, half_float::half* C);
+
+    template std::unique_ptr<stream::StreamExecutionTimings>
+    calculate_cpu<cl_float>(const hpcc_base::ExecutionSettings<stream::StreamProgramSettings>& config,
+              cl_float* A, cl_float* B, cl_float* C);
+
+    template std::unique_ptr<stream::StreamExecutionTimings>
+    calculate_cpu<cl_double>(const hpcc_base::ExecutionSettings<stream::StreamProgramSettings>& config,
+              cl_double* A, cl_double* B, cl_double* C);
+
+}  // namespace bm_execution
@@ -27,6 +27,11 @@ SOFTWARE.
 #include <memory>
 #include <vector>
 #include <chrono>
+#include <utility>
+#include <algorithm>
+#include <exception>
+#include <numeric>
+#include <random>
 
 /* External library headers */
 #include "CL/opencl.h"
@@ -35,13 +40,16 @@ SOFTWARE.
 #include "CL/cl_ext_intelfpga.h"
 #endif
 /* Project's headers */
+#include "kernel_counters.hpp"
 
 namespace bm_execution {
 
+    template<typename T>
     void initialize_buffers(const hpcc_base::ExecutionSettings<stream::StreamProgramSettings> &config, unsigned int data_per_kernel,
                             std::vector<cl::Buffer> &Buffers_A, std::vector<cl::Buffer> &Buffers_B,
                             std::vector<cl::Buffer> &Buffers_C);
 
+    template<typename T>
     bool initialize_queues_and_kernels(const hpcc_base::ExecutionSettings<stream::StreamProgramSettings> &config,
                                        unsigned int data_per_kernel, const std::vector<cl::Buffer> &Buffers_A,
                                        const std::vector<cl::Buffer> &Buffers_B,
@@ -51,6 +59,7 @@ namespace bm_execution {
                                        std::vector<cl::Kernel> &triad_kernels,
                                        std::vector<cl::CommandQueue> &command_queues);
 
+    template<typename T>
     bool initialize_queues_and_kernels_single(const hpcc_base::ExecutionSettings<stream::StreamProgramSettings> &config,
                                        unsigned int data_per_kernel, const std::vector<cl::Buffer> &Buffers_A,
                                        const std::vector<cl::Buffer> &Buffers_B,
@@ -58,20 +67,191 @@ namespace bm_execution {
                                        std::vector<cl::Kernel> &test_kernels, std::vector<cl::Kernel> &copy_kernels,
                                        std::vector<cl::Kernel> &scale_kernels, std::vector<cl::Kernel> &add_kernels,
                                        std::vector<cl::Kernel> &triad_kernels,
-                                       HOST_DATA_TYPE* A,
-                                       HOST_DATA_TYPE* B,
-                                       HOST_DATA_TYPE* C,
+                                       T* A,
+                                       T* B,
+                                       T* C,
                                        std::vector<cl::CommandQueue> &command_queues);
 
+    template<typename T>
+    std::unique_ptr<stream::StreamExecutionTimings>
+    calculate_streaming(const hpcc_base::ExecutionSettings<stream::StreamProgramSettings>& config,
+            T* A,
+            T* B,
+            T* C);
+
+    template<typename T>
+    std::unique_ptr<stream::StreamExecutionTimings>
+    calculate_multi_device(const hpcc_base::ExecutionSettings<stream::StreamProgramSettings>& config,
+            T* A,
+            T* B,
+            T* C);
+
+    template<typename T>
+    std::unique_ptr<stream::StreamExecutionTimings>
+    calculate_fused(const hpcc_base::ExecutionSettings<stream::StreamProgramSettings>& config,
+            T* A,
+            T* B,
+            T* C);
+
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+    /**
+    Create the device side counters and set them as argument of the given kernels.
+    Only the single kernel is instrumented, so the counters of a repetition are accumulated over all four operations.
+
+    @param config The execution settings
+    @param kernels The kernels of all operations. Every list contains one kernel per replication
+    @return The counters or nullptr, if the single kernel is not used
+    */
+    std::unique_ptr<kernel_counters::KernelCounters>
+    initialize_kernel_counters(const hpcc_base::ExecutionSettings<stream::StreamProgramSettings> &config,
+                                const std::vector<std::vector<cl::Kernel>*> &kernels) {
+        if (!config.programSettings->useSingleKernel) {
+            return std::unique_ptr<kernel_counters::KernelCounters>(nullptr);
+        }
+        std::vector<std::string> names;
+        for (int i = 0; i < config.programSettings->kernelReplications; i++) {
+            names.push_back("calc_" + std::to_string(i));
+        }
+        std::unique_ptr<kernel_counters::KernelCounters> counters(new kernel_counters::KernelCounters(*config.context, names));
+        for (auto k : kernels) {
+            for (auto &kernel : *k) {
+                // The counter buffer follows the operation type
+                counters->setKernelArg(kernel, 6);
+            }
+        }
+        return counters;
+    }
+#endif
+
+#ifdef USE_ACCESS_PATTERN_KERNEL
+    /**
+    Measure the bandwidth of the access patterns of the pattern kernel.
+    Array A of every replication is copied to an additional buffer with every pattern, so the arrays of the
+    four operations are not modified. The indices for gather and scatter are a random permutation.
+
+    @param config The execution settings
+    @param data_per_kernel Number of values processed by every replication
+    @param Buffers_A The device buffers of array A that contain the values of A
+    @param command_queues The queues of the replications
+    @param A Array A on the host to validate the copied values
+    @param timingMap The measured times of all patterns are added to this map
+    @param profiler The kernel executions are recorded in this profiler
+    @return true if the copied values of all patterns match array A
+    */
+    template<typename T>
+    bool
+    measure_access_patterns(const hpcc_base::ExecutionSettings<stream::StreamProgramSettings> &config, unsigned data_per_kernel,
+                            const std::vector<cl::Buffer> &Buffers_A, std::vector<cl::CommandQueue> &command_queues, const T* A,
+                            std::map<std::string, std::vector<double>> &timingMap, profiling::EventProfiler &profiler) {
+        const auto &settings = *config.programSettings;
+        if (data_per_kernel % settings.patternBlockSize != 0) {
+            std::cerr << "ERROR: The array size of every replication (" << data_per_kernel
+                      << ") has to be a multiple of the block size of the access patterns!" << std::endl;
+            return false;
+        }
+        std::vector<cl_uint> indices(data_per_kernel);
+        std::iota(indices.begin(), indices.end(), 0);
+        std::mt19937 gen(7);
+        std::shuffle(indices.begin(), indices.end(), gen);
+
+        int err;
+        std::vector<cl::Buffer> out_buffers;
+        std::vector<cl::Buffer> index_buffers;
+        std::vector<cl::Kernel> pattern_kernels;
+        for (int i = 0; i < settings.kernelReplications; i++) {
+#ifdef INTEL_FPGA
+            cl::Kernel patternkernel(*config.program, ("pattern_" + std::to_string(i)).c_str(), &err);
+#endif
+#ifdef XILINX_FPGA
+            cl::Kernel patternkernel(*config.program, ("pattern_0:{pattern_0_" + std::to_string(i+1) + "}").c_str(), &err);
+#endif
+            ASSERT_CL(err);
+            out_buffers.push_back(cl::Buffer(*config.context, CL_MEM_READ_WRITE, sizeof(T) * data_per_kernel, nullptr, &err));
+            ASSERT_CL(err);
+            index_buffers.push_back(cl::Buffer(*config.context, CL_MEM_READ_ONLY, sizeof(cl_uint) * data_per_kernel, nullptr, &err));
+            ASSERT_CL(err);
+            placement::trackBuffer(out_buffers.back(), memory_tracker::DEFAULT_BANK);
+            placement::trackBuffer(index_buffers.back(), memory_tracker::DEFAULT_BANK);
+            ASSERT_CL(command_queues[i].enqueueWriteBuffer(index_buffers[i], CL_FALSE, 0, sizeof(cl_uint) * data_per_kernel, indices.data()));
+            ASSERT_CL(patternkernel.setArg(0, Buffers_A[i]));
+            ASSERT_CL(patternkernel.setArg(1, out_buffers[i]));
+            ASSERT_CL(patternkernel.setArg(2, index_buffers[i]));
+            ASSERT_CL(patternkernel.setArg(3, data_per_kernel));
+            ASSERT_CL(patternkernel.setArg(4, settings.patternStride));
+            pattern_kernels.push_back(patternkernel);
+        }
+
+        // Pattern type and block size of every measured pattern
+        const std::vector<std::pair<std::string, std::pair<cl_uint, cl_uint>>> patterns = {
+            {STRIDED_KEY, {BLOCKED_STRIDED_PATTERN_TYPE, 1}},
+            {BLOCKED_KEY, {BLOCKED_STRIDED_PATTERN_TYPE, settings.patternBlockSize}},
+            {GATHER_KEY, {GATHER_PATTERN_TYPE, 1}},
+            {SCATTER_KEY, {SCATTER_PATTERN_TYPE, 1}}
+        };
+        std::vector<T> copied(data_per_kernel);
+        size_t errors = 0;
+        for (const auto &p : patterns) {
+            timingMap.insert({p.first, std::vector<double>()});
+            for (int i = 0; i < settings.kernelReplications; i++) {
+                ASSERT_CL(pattern_kernels[i].setArg(5, p.second.second));
+                ASSERT_CL(pattern_kernels[i].setArg(6, p.second.first));
+            }
+            for (uint r = 0; r < settings.numRepetitions; r++) {
+                cl::UserEvent start_event(*config.context, &err);
+                ASSERT_CL(err);
+                std::vector<cl::Event> start_events({start_event});
+                std::vector<cl::Event> pattern_events(settings.kernelReplications);
+                for (int i = 0; i < settings.kernelReplications; i++) {
+                    ASSERT_CL(command_queues[i].enqueueNDRangeKernel(pattern_kernels[i], cl::NullRange, cl::NDRange(1), cl::NDRange(1), &start_events, &pattern_events[i]));
+                }
+                auto startExecution = std::chrono::high_resolution_clock::now();
+                start_event.setStatus(CL_COMPLETE);
+                cl::Event::waitForEvents(pattern_events);
+                std::chrono::duration<double> duration = std::chrono::high_resolution_clock::now() - startExecution;
+                timingMap[p.first].push_back(duration.count());
+                for (int i = 0; i < settings.kernelReplications; i++) {
+                    profiler.record(p.first, i, pattern_events[i]);
+                }
+                profiler.collect(r);
+            }
+            // Every pattern copies all values once, so the output has to match the input
+            for (int i = 0; i < settings.kernelReplications; i++) {
+                ASSERT_CL(command_queues[i].enqueueReadBuffer(out_buffers[i], CL_TRUE, 0, sizeof(T) * data_per_kernel, copied.data()));
+                for (unsigned k = 0; k < data_per_kernel; k++) {
+                    errors += (copied[k] != A[data_per_kernel * i + k]) ? 1 : 0;
+                }
+            }
+            if (errors > 0) {
+                std::cerr << "ERROR: " << errors << " values copied with the access pattern " << p.first << " are wrong!" << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+#endif
+
 /*
     Implementation for the single kernel.
      @copydoc bm_execution::calculate()
     */
+    template<typename T>
     std::unique_ptr<stream::StreamExecutionTimings>
     calculate(const hpcc_base::ExecutionSettings<stream::StreamProgramSettings>& config,
-            HOST_DATA_TYPE* A,
-            HOST_DATA_TYPE* B,
-            HOST_DATA_TYPE* C) {
+            T* A,
+            T* B,
+            T* C) {
+
+        if (config.devices.size() > 1) {
+            return calculate_multi_device(config, A, B, C);
+        }
+
+        if (config.programSettings->streamingChunks > 0) {
+            return calculate_streaming(config, A, B, C);
+        }
+
+        if (config.programSettings->fusedRepetitions > 0) {
+            return calculate_fused(config, A, B, C);
+        }
 
         unsigned data_per_kernel = config.programSettings->streamArraySize/config.programSettings->kernelReplications;
 
@@ -88,7 +268,7 @@ namespace bm_execution {
         //
         // Setup buffers
         //
-        initialize_buffers(config, data_per_kernel, Buffers_A, Buffers_B, Buffers_C);
+        initialize_buffers<T>(config, data_per_kernel, Buffers_A, Buffers_B, Buffers_C);
 
         //
         // Setup kernels
@@ -100,7 +280,7 @@ namespace bm_execution {
                                           add_kernels, triad_kernels, A, B, C, command_queues);
         }
         else {
-            success = initialize_queues_and_kernels(config, data_per_kernel, Buffers_A, Buffers_B, Buffers_C, test_kernels,
+            success = initialize_queues_and_kernels<T>(config, data_per_kernel, Buffers_A, Buffers_B, Buffers_C, test_kernels,
                                           copy_kernels, scale_kernels,
                                           add_kernels, triad_kernels, command_queues);
         }
@@ -108,6 +288,10 @@ namespace bm_execution {
             return std::unique_ptr<stream::StreamExecutionTimings>(nullptr);
         }
 
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+        auto counters = initialize_kernel_counters(config, {&test_kernels, &copy_kernels, &scale_kernels, &add_kernels, &triad_kernels});
+#endif
+
         //
         // Setup counters for runtime measurement
         //
@@ -130,11 +314,11 @@ namespace bm_execution {
             ASSERT_CL(clEnqueueSVMMap(command_queues[i](), CL_FALSE,
                                 CL_MAP_READ | CL_MAP_WRITE,
                                 reinterpret_cast<void *>(A),
-                                sizeof(HOST_DATA_TYPE) * data_per_kernel, 0,
+                                sizeof(T) * data_per_kernel, 0,
                                 NULL, NULL));
 
 #else
-            ASSERT_CL(command_queues[i].enqueueWriteBuffer(Buffers_A[i], CL_FALSE, 0, sizeof(HOST_DATA_TYPE)*data_per_kernel, &A[data_per_kernel*i]));
+            ASSERT_CL(command_queues[i].enqueueWriteBuffer(Buffers_A[i], CL_FALSE, 0, sizeof(T)*data_per_kernel, &A[data_per_kernel*i]));
 #endif
         }
         for (int i=0; i<config.programSettings->kernelReplications; i++) {
@@ -166,7 +350,7 @@ namespace bm_execution {
                         NULL, NULL));
 
 #else
-            ASSERT_CL(command_queues[i].enqueueReadBuffer(Buffers_A[i], CL_FALSE, 0, sizeof(HOST_DATA_TYPE)*data_per_kernel, &A[data_per_kernel*i]));
+            ASSERT_CL(command_queues[i].enqueueReadBuffer(Buffers_A[i], CL_FALSE, 0, sizeof(T)*data_per_kernel, &A[data_per_kernel*i]));
 #endif
         }
         for (int i=0; i<config.programSettings->kernelReplications; i++) {
@@ -177,8 +361,14 @@ namespace bm_execution {
         //
         // Do actual benchmark measurements
         //
+        profiling::EventProfiler profiler;
         for (uint r = 0; r < config.programSettings->numRepetitions; r++) {
 
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+            if (counters) {
+                counters->reset(command_queues[0]);
+            }
+#endif
 
             startExecution = std::chrono::high_resolution_clock::now();
 
@@ -187,28 +377,32 @@ namespace bm_execution {
                 clEnqueueSVMMap(command_queues[i](), CL_FALSE,
                             CL_MAP_READ | CL_MAP_WRITE,
                             reinterpret_cast<void *>(&A[data_per_kernel * i]),
-                            sizeof(HOST_DATA_TYPE) * data_per_kernel, 0,
+                            sizeof(T) * data_per_kernel, 0,
                             NULL, NULL);
                 clEnqueueSVMMap(command_queues[i](), CL_FALSE,
                             CL_MAP_READ | CL_MAP_WRITE,
                             reinterpret_cast<void *>(&B[data_per_kernel * i]),
-                            sizeof(HOST_DATA_TYPE) * data_per_kernel, 0,
+                            sizeof(T) * data_per_kernel, 0,
                             NULL, NULL);
                 clEnqueueSVMMap(command_queues[i](), CL_FALSE,
                             CL_MAP_READ | CL_MAP_WRITE,
                             reinterpret_cast<void *>(&C[data_per_kernel * i]),
-                            sizeof(HOST_DATA_TYPE) * data_per_kernel, 0,
+                            sizeof(T) * data_per_kernel, 0,
                             NULL, NULL);
 #else
+                cl::Event write_events[3];
                 command_queues[i].enqueueWriteBuffer(Buffers_A[i], CL_FALSE, 0,
-                                                        sizeof(HOST_DATA_TYPE) * data_per_kernel,
-                                                        &A[data_per_kernel * i]);
+                                                        sizeof(T) * data_per_kernel,
+                                                        &A[data_per_kernel * i], NULL, &write_events[0]);
                 command_queues[i].enqueueWriteBuffer(Buffers_B[i], CL_FALSE, 0,
-                                                        sizeof(HOST_DATA_TYPE) * data_per_kernel,
-                                                        &B[data_per_kernel * i]);
+                                                        sizeof(T) * data_per_kernel,
+                                                        &B[data_per_kernel * i], NULL, &write_events[1]);
                 command_queues[i].enqueueWriteBuffer(Buffers_C[i], CL_FALSE, 0,
-                                                        sizeof(HOST_DATA_TYPE) * data_per_kernel,
-                                                        &C[data_per_kernel * i]);
+                                                        sizeof(T) * data_per_kernel,
+                                                        &C[data_per_kernel * i], NULL, &write_events[2]);
+                for (const auto& e : write_events) {
+                    profiler.record(PCIE_WRITE_KEY, i, e);
+                }
 #endif
             }
 
@@ -308,15 +502,19 @@ namespace bm_execution {
                             reinterpret_cast<void *>(&C[data_per_kernel * i]), 0,
                             NULL, NULL);
 #else
+                cl::Event read_events[3];
                 command_queues[i].enqueueReadBuffer(Buffers_A[i], CL_FALSE, 0,
-                                                    sizeof(HOST_DATA_TYPE) * data_per_kernel,
-                                                    &A[data_per_kernel * i]);
+                                                    sizeof(T) * data_per_kernel,
+                                                    &A[data_per_kernel * i], NULL, &read_events[0]);
                 command_queues[i].enqueueReadBuffer(Buffers_B[i], CL_FALSE, 0,
-                                                    sizeof(HOST_DATA_TYPE) * data_per_kernel,
-                                                    &B[data_per_kernel * i]);
+                                                    sizeof(T) * data_per_kernel,
+                                                    &B[data_per_kernel * i], NULL, &read_events[1]);
                 command_queues[i].enqueueReadBuffer(Buffers_C[i], CL_FALSE, 0,
-                                                    sizeof(HOST_DATA_TYPE) * data_per_kernel,
-                                                    &C[data_per_kernel * i]);
+                                                    sizeof(T) * data_per_kernel,
+                                                    &C[data_per_kernel * i], NULL, &read_events[2]);
+                for (const auto& e : read_events) {
+                    profiler.record(PCIE_READ_KEY, i, e);
+                }
 #endif
             }
 
@@ -329,15 +527,489 @@ namespace bm_execution {
                     (endExecution - startExecution);
             timingMap[PCIE_READ_KEY].push_back(duration.count());
 
+            for (int i = 0; i < config.programSettings->kernelReplications; i++) {
+                profiler.record(COPY_KEY, i, copy_events[i]);
+                profiler.record(SCALE_KEY, i, scale_events[i]);
+                profiler.record(ADD_KEY, i, add_events[i]);
+                profiler.record(TRIAD_KEY, i, triad_events[i]);
+            }
+            profiler.collect(r);
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+            if (counters) {
+                counters->read(command_queues[0]);
+                counters->print(r);
+            }
+#endif
+        }
+
+#ifdef USE_ACCESS_PATTERN_KERNEL
+        if (config.programSettings->useAccessPatterns) {
+#ifdef USE_SVM
+            std::cerr << "ERROR: The access patterns are not supported with SVM!" << std::endl;
+            return std::unique_ptr<stream::StreamExecutionTimings>(nullptr);
+#else
+            if (!measure_access_patterns(config, data_per_kernel, Buffers_A, command_queues, A, timingMap, profiler)) {
+                return std::unique_ptr<stream::StreamExecutionTimings>(nullptr);
+            }
+#endif
+        }
+#endif
+
+        std::unique_ptr<stream::StreamExecutionTimings> result(new stream::StreamExecutionTimings{
+                timingMap,
+                config.programSettings->streamArraySize,
+                profiler.timings
+        });
+        return result;
+    }
+
+/*
+    Implementation for multiple devices per rank.
+    The arrays are split into equally sized parts and every device executes the benchmark on its part concurrently.
+    The aggregated time of an operation is the time of the slowest device in the same repetition.
+     @copydoc bm_execution::calculate()
+    */
+    template<typename T>
+    std::unique_ptr<stream::StreamExecutionTimings>
+    calculate_multi_device(const hpcc_base::ExecutionSettings<stream::StreamProgramSettings>& config,
+            T* A,
+            T* B,
+            T* C) {
+#ifdef USE_SVM
+        throw std::runtime_error("Multiple devices per rank are not supported in SVM mode!");
+#endif
+        size_t num_devices = config.devices.size();
+        if (config.programSettings->streamArraySize % (num_devices * config.programSettings->kernelReplications) != 0) {
+            throw std::runtime_error("Array size must be divisible by the number of devices and kernel replications!");
+        }
+        uint data_per_device = config.programSettings->streamArraySize / num_devices;
+
+        // Create the execution settings for every device with the part of the array that is processed by it
+        std::vector<std::unique_ptr<hpcc_base::ExecutionSettings<stream::StreamProgramSettings>>> device_configs;
+        for (size_t d = 0; d < num_devices; d++) {
+            std::unique_ptr<stream::StreamProgramSettings> settings(new stream::StreamProgramSettings(*config.programSettings));
+            settings->streamArraySize = data_per_device;
+            device_configs.emplace_back(new hpcc_base::ExecutionSettings<stream::StreamProgramSettings>(std::move(settings),
+                                        std::unique_ptr<cl::Device>(new cl::Device(config.devices[d])),
+                                        std::unique_ptr<cl::Context>(new cl::Context(config.contexts[d])),
+                                        std::unique_ptr<cl::Program>(new cl::Program(config.programs[d]))));
+        }
+
+        std::vector<std::unique_ptr<stream::StreamExecutionTimings>> device_results(num_devices);
+        std::vector<std::exception_ptr> errors(num_devices);
+#pragma omp parallel for num_threads(num_devices) schedule(static, 1)
+        for (int d = 0; d < static_cast<int>(num_devices); d++) {
+            try {
+                device_results[d] = calculate(*device_configs[d], A + d * data_per_device,
+                                              B + d * data_per_device, C + d * data_per_device);
+            }
+            catch (...) {
+                errors[d] = std::current_exception();
+            }
+        }
+        for (const auto &e : errors) {
+            if (e) {
+                std::rethrow_exception(e);
+            }
+        }
+
+        std::unique_ptr<stream::StreamExecutionTimings> result(new stream::StreamExecutionTimings{
+                device_results[0]->timings,
+                config.programSettings->streamArraySize,
+                {}
+        });
+        for (size_t d = 0; d < num_devices; d++) {
+            for (auto &t : result->timings) {
+                const auto &device_times = device_results[d]->timings[t.first];
+                for (size_t r = 0; r < t.second.size(); r++) {
+                    t.second[r] = std::max(t.second[r], device_times[r]);
+                }
+            }
+            // Replications of the following devices are numbered consecutively
+            for (auto dt : device_results[d]->deviceTimings) {
+                dt.replication += d * config.programSettings->kernelReplications;
+                result->deviceTimings.push_back(dt);
+            }
+            result->perDeviceTimings.push_back(device_results[d]->timings);
+        }
+        return result;
+    }
+
+/*
+    Implementation of the streaming mode.
+    The array of every kernel replication is split into chunks. Two sets of device buffers are used alternately,
+    so the transfers of a chunk to and from the device can overlap with the kernel execution on the previous chunk.
+     @copydoc bm_execution::calculate()
+    */
+    template<typename T>
+    std::unique_ptr<stream::StreamExecutionTimings>
+    calculate_streaming(const hpcc_base::ExecutionSettings<stream::StreamProgramSettings>& config,
+            T* A,
+            T* B,
+            T* C) {
+#ifdef USE_SVM
+        std::cerr << "ERROR: The streaming mode is not supported with SVM!" << std::endl;
+        return std::unique_ptr<stream::StreamExecutionTimings>(nullptr);
+#else
+        unsigned data_per_kernel = config.programSettings->streamArraySize/config.programSettings->kernelReplications;
+        unsigned num_chunks = config.programSettings->streamingChunks;
+        if (data_per_kernel % num_chunks != 0) {
+            std::cerr << "ERROR: The array size of every replication (" << data_per_kernel
+                      << ") has to be a multiple of the number of streaming chunks!" << std::endl;
+            return std::unique_ptr<stream::StreamExecutionTimings>(nullptr);
+        }
+        unsigned chunk_size = data_per_kernel / num_chunks;
+        const uint num_slots = 2;
+
+        //
+        // Setup buffers, kernels and compute queues for every slot
+        //
+        std::vector<std::vector<cl::Buffer>> Buffers_A(num_slots);
+        std::vector<std::vector<cl::Buffer>> Buffers_B(num_slots);
+        std::vector<std::vector<cl::Buffer>> Buffers_C(num_slots);
+        std::vector<std::vector<cl::Kernel>> test_kernels(num_slots);
+        std::vector<std::vector<cl::Kernel>> copy_kernels(num_slots);
+        std::vector<std::vector<cl::Kernel>> scale_kernels(num_slots);
+        std::vector<std::vector<cl::Kernel>> add_kernels(num_slots);
+        std::vector<std::vector<cl::Kernel>> triad_kernels(num_slots);
+        std::vector<std::vector<cl::CommandQueue>> compute_queues(num_slots);
+        for (uint slot = 0; slot < num_slots; slot++) {
+            initialize_buffers<T>(config, chunk_size, Buffers_A[slot], Buffers_B[slot], Buffers_C[slot]);
+            bool success = false;
+            if (config.programSettings->useSingleKernel) {
+                success = initialize_queues_and_kernels_single(config, chunk_size, Buffers_A[slot], Buffers_B[slot], Buffers_C[slot],
+                                            test_kernels[slot], copy_kernels[slot], scale_kernels[slot],
+                                            add_kernels[slot], triad_kernels[slot], A, B, C, compute_queues[slot]);
+            }
+            else {
+                success = initialize_queues_and_kernels<T>(config, chunk_size, Buffers_A[slot], Buffers_B[slot], Buffers_C[slot],
+                                            test_kernels[slot], copy_kernels[slot], scale_kernels[slot],
+                                            add_kernels[slot], triad_kernels[slot], compute_queues[slot]);
+            }
+            if (!success) {
+                return std::unique_ptr<stream::StreamExecutionTimings>(nullptr);
+            }
+        }
+
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+        std::vector<std::vector<cl::Kernel>*> counter_kernels;
+        for (uint slot = 0; slot < num_slots; slot++) {
+            counter_kernels.insert(counter_kernels.end(), {&test_kernels[slot], &copy_kernels[slot], &scale_kernels[slot],
+                                                            &add_kernels[slot], &triad_kernels[slot]});
+        }
+        auto counters = initialize_kernel_counters(config, counter_kernels);
+#endif
+
+        // Separate queues for the transfers in both directions, so they can overlap with the kernel execution
+        std::vector<cl::CommandQueue> write_queues;
+        std::vector<cl::CommandQueue> read_queues;
+        for (int i = 0; i < config.programSettings->kernelReplications; i++) {
+            write_queues.push_back(cl::CommandQueue(*config.context, *config.device, profiling::PROFILING_QUEUE_PROPERTIES));
+            read_queues.push_back(cl::CommandQueue(*config.context, *config.device, profiling::PROFILING_QUEUE_PROPERTIES));
+        }
+
+        // Last read of every slot and replication. The buffers of a slot must not be overwritten before it is completed.
+        std::vector<std::vector<cl::Event>> slot_free_events(config.programSettings->kernelReplications, std::vector<cl::Event>(num_slots));
+
+        profiling::EventProfiler profiler;
+
+        // Write a chunk of a replication to the device, execute the given kernels on it in order and read it back
+        auto enqueue_chunk = [&](uint i, uint c, const std::vector<std::pair<std::string, const std::vector<std::vector<cl::Kernel>>*>> &kernels, bool record) {
+            uint slot = c % num_slots;
+            size_t offset = static_cast<size_t>(data_per_kernel) * i + static_cast<size_t>(chunk_size) * c;
+            std::vector<cl::Event> slot_free;
+            if (slot_free_events[i][slot]() != nullptr) {
+                slot_free.push_back(slot_free_events[i][slot]);
+            }
+            std::vector<cl::Event> write_events(3);
+            ASSERT_CL(write_queues[i].enqueueWriteBuffer(Buffers_A[slot][i], CL_FALSE, 0, sizeof(T) * chunk_size, &A[offset], &slot_free, &write_events[0]));
+            ASSERT_CL(write_queues[i].enqueueWriteBuffer(Buffers_B[slot][i], CL_FALSE, 0, sizeof(T) * chunk_size, &B[offset], &slot_free, &write_events[1]));
+            ASSERT_CL(write_queues[i].enqueueWriteBuffer(Buffers_C[slot][i], CL_FALSE, 0, sizeof(T) * chunk_size, &C[offset], &slot_free, &write_events[2]));
+
+            std::vector<cl::Event> kernel_events(kernels.size());
+            for (size_t k = 0; k < kernels.size(); k++) {
+                // The compute queue is in order, so only the first kernel has to wait for the transfers
+                ASSERT_CL(compute_queues[slot][i].enqueueNDRangeKernel((*kernels[k].second)[slot][i], cl::NullRange, cl::NDRange(1), cl::NDRange(1),
+                                                        (k == 0) ? &write_events : nullptr, &kernel_events[k]));
+            }
+
+            std::vector<cl::Event> kernels_done({kernel_events.back()});
+            std::vector<cl::Event> read_events(3);
+            ASSERT_CL(read_queues[i].enqueueReadBuffer(Buffers_A[slot][i], CL_FALSE, 0, sizeof(T) * chunk_size, &A[offset], &kernels_done, &read_events[0]));
+            ASSERT_CL(read_queues[i].enqueueReadBuffer(Buffers_B[slot][i], CL_FALSE, 0, sizeof(T) * chunk_size, &B[offset], &kernels_done, &read_events[1]));
+            ASSERT_CL(read_queues[i].enqueueReadBuffer(Buffers_C[slot][i], CL_FALSE, 0, sizeof(T) * chunk_size, &C[offset], &kernels_done, &read_events[2]));
+            // The read queue is in order, so the last read completes the chunk
+            slot_free_events[i][slot] = read_events.back();
+
+            if (record) {
+                for (const auto& e : write_events) {
+                    profiler.record(PCIE_WRITE_KEY, i, e);
+                }
+                for (size_t k = 0; k < kernels.size(); k++) {
+                    profiler.record(kernels[k].first, i, kernel_events[k]);
+                }
+                for (const auto& e : read_events) {
+                    profiler.record(PCIE_READ_KEY, i, e);
+                }
+            }
+        };
+
+        //
+        // Do first test execution. It is not measured, but modifies the data like in the regular mode.
+        //
+        for (uint c = 0; c < num_chunks; c++) {
+            for (uint i = 0; i < config.programSettings->kernelReplications; i++) {
+                enqueue_chunk(i, c, {{"test", &test_kernels}}, false);
+            }
+        }
+        for (int i = 0; i < config.programSettings->kernelReplications; i++) {
+            ASSERT_CL(read_queues[i].finish());
+        }
+
+        //
+        // Do actual benchmark measurements
+        //
+        std::map<std::string, std::vector<double>> timingMap;
+        timingMap.insert({STREAMING_KEY, std::vector<double>()});
+        for (uint r = 0; r < config.programSettings->numRepetitions; r++) {
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+            if (counters) {
+                counters->reset(read_queues[0]);
+            }
+#endif
+            auto startExecution = std::chrono::high_resolution_clock::now();
+            for (uint c = 0; c < num_chunks; c++) {
+                for (uint i = 0; i < config.programSettings->kernelReplications; i++) {
+                    enqueue_chunk(i, c, {{COPY_KEY, &copy_kernels}, {SCALE_KEY, &scale_kernels},
+                                            {ADD_KEY, &add_kernels}, {TRIAD_KEY, &triad_kernels}}, true);
+                }
+            }
+            for (int i = 0; i < config.programSettings->kernelReplications; i++) {
+                ASSERT_CL(read_queues[i].finish());
+            }
+            auto endExecution = std::chrono::high_resolution_clock::now();
+            std::chrono::duration<double> duration = std::chrono::duration_cast<std::chrono::duration<double>>
+                    (endExecution - startExecution);
+            timingMap[STREAMING_KEY].push_back(duration.count());
+            profiler.collect(r);
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+            if (counters) {
+                counters->read(read_queues[0]);
+                counters->print(r);
+            }
+#endif
         }
 
         std::unique_ptr<stream::StreamExecutionTimings> result(new stream::StreamExecutionTimings{
                 timingMap,
-                config.programSettings->streamArraySize
+                config.programSettings->streamArraySize,
+                profiler.timings
         });
         return result;
+#endif
     }
 
+/*
+    Implementation of the fused mode.
+    A single launch of the fused kernel executes all four operations for multiple repetitions, so the measurement
+    does not contain the launch overhead of the individual operations. The operations are timed with the cycle counter
+    of the device. It is converted to seconds using the duration of the launch measured with OpenCL event profiling.
+    If the device does not provide a cycle counter, only the total time of all four operations is measured.
+     @copydoc bm_execution::calculate()
+    */
+    template<typename T>
+    std::unique_ptr<stream::StreamExecutionTimings>
+    calculate_fused(const hpcc_base::ExecutionSettings<stream::StreamProgramSettings>& config,
+            T* A,
+            T* B,
+            T* C) {
+#if defined(USE_SVM) || !defined(USE_FUSED_KERNEL)
+        std::cerr << "ERROR: The fused mode is not supported with SVM or kernels without USE_FUSED_KERNEL!" << std::endl;
+        return std::unique_ptr<stream::StreamExecutionTimings>(nullptr);
+#else
+        unsigned data_per_kernel = config.programSettings->streamArraySize/config.programSettings->kernelReplications;
+        uint repetitions_per_launch = config.programSettings->fusedRepetitions;
+        uint num_repetitions = config.programSettings->numRepetitions;
+
+        std::vector<cl::Buffer> Buffers_A;
+        std::vector<cl::Buffer> Buffers_B;
+        std::vector<cl::Buffer> Buffers_C;
+        std::vector<cl::Kernel> test_kernels;
+        std::vector<cl::Kernel> copy_kernels;
+        std::vector<cl::Kernel> scale_kernels;
+        std::vector<cl::Kernel> add_kernels;
+        std::vector<cl::Kernel> triad_kernels;
+        std::vector<cl::CommandQueue> command_queues;
+        initialize_buffers<T>(config, data_per_kernel, Buffers_A, Buffers_B, Buffers_C);
+        // Only the test kernels are used to modify the data like in the regular mode
+        if (!initialize_queues_and_kernels_single(config, data_per_kernel, Buffers_A, Buffers_B, Buffers_C, test_kernels,
+                                          copy_kernels, scale_kernels, add_kernels, triad_kernels, A, B, C, command_queues)) {
+            return std::unique_ptr<stream::StreamExecutionTimings>(nullptr);
+        }
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+        auto counters = initialize_kernel_counters(config, {&test_kernels});
+#endif
+
+        int err;
+        std::vector<cl::Kernel> fused_kernels;
+        std::vector<cl::Buffer> timestamp_buffers;
+        for (int i = 0; i < config.programSettings->kernelReplications; i++) {
+#ifdef INTEL_FPGA
+            cl::Kernel fusedkernel(*config.program, ("fused_" + std::to_string(i)).c_str(), &err);
+#endif
+#ifdef XILINX_FPGA
+            cl::Kernel fusedkernel(*config.program, ("fused_0:{fused_0_" + std::to_string(i+1) + "}").c_str(), &err);
+#endif
+            ASSERT_CL(err);
+            timestamp_buffers.push_back(cl::Buffer(*config.context, CL_MEM_READ_WRITE,
+                                        sizeof(cl_ulong) * FUSED_TIMESTAMPS_PER_REPETITION * repetitions_per_launch, nullptr, &err));
+            ASSERT_CL(err);
+            ASSERT_CL(fusedkernel.setArg(0, Buffers_A[i]));
+            ASSERT_CL(fusedkernel.setArg(1, Buffers_B[i]));
+            ASSERT_CL(fusedkernel.setArg(2, Buffers_C[i]));
+            ASSERT_CL(fusedkernel.setArg(3, static_cast<T>(3.0)));
+            ASSERT_CL(fusedkernel.setArg(4, data_per_kernel));
+            ASSERT_CL(fusedkernel.setArg(6, timestamp_buffers[i]));
+            fused_kernels.push_back(fusedkernel);
+        }
+
+        //
+        // Do first test execution. It is not measured, but modifies the data like in the regular mode.
+        //
+        for (int i = 0; i < config.programSettings->kernelReplications; i++) {
+            ASSERT_CL(command_queues[i].enqueueWriteBuffer(Buffers_A[i], CL_FALSE, 0, sizeof(T)*data_per_kernel, &A[data_per_kernel*i]));
+            ASSERT_CL(command_queues[i].enqueueNDRangeKernel(test_kernels[i], cl::NullRange, cl::NDRange(1)));
+            ASSERT_CL(command_queues[i].enqueueReadBuffer(Buffers_A[i], CL_FALSE, 0, sizeof(T)*data_per_kernel, &A[data_per_kernel*i]));
+        }
+        for (int i = 0; i < config.programSettings->kernelReplications; i++) {
+            ASSERT_CL(command_queues[i].finish());
+        }
+
+        //
+        // Do actual benchmark measurements
+        //
+        std::map<std::string, std::vector<double>> timingMap;
+        timingMap.insert({FUSED_KEY, std::vector<double>()});
+#ifdef INTEL_FPGA
+        const std::vector<std::string> operation_keys = {COPY_KEY, SCALE_KEY, ADD_KEY, TRIAD_KEY};
+        for (const auto &key : operation_keys) {
+            timingMap.insert({key, std::vector<double>()});
+        }
+        std::vector<std::vector<cl_ulong>> timestamps(config.programSettings->kernelReplications,
+                                        std::vector<cl_ulong>(FUSED_TIMESTAMPS_PER_REPETITION * repetitions_per_launch));
+#endif
+        profiling::EventProfiler profiler;
+        uint launch = 0;
+        for (uint r = 0; r < num_repetitions; r += repetitions_per_launch) {
+            // The last launch executes the remaining repetitions
+            uint launch_repetitions = std::min(repetitions_per_launch, num_repetitions - r);
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+            if (counters) {
+                counters->reset(command_queues[0]);
+            }
+#endif
+            std::vector<cl::Event> write_events(3 * config.programSettings->kernelReplications);
+            for (int i = 0; i < config.programSettings->kernelReplications; i++) {
+                ASSERT_CL(command_queues[i].enqueueWriteBuffer(Buffers_A[i], CL_FALSE, 0, sizeof(T) * data_per_kernel, &A[data_per_kernel * i], nullptr, &write_events[3 * i]));
+                ASSERT_CL(command_queues[i].enqueueWriteBuffer(Buffers_B[i], CL_FALSE, 0, sizeof(T) * data_per_kernel, &B[data_per_kernel * i], nullptr, &write_events[3 * i + 1]));
+                ASSERT_CL(command_queues[i].enqueueWriteBuffer(Buffers_C[i], CL_FALSE, 0, sizeof(T) * data_per_kernel, &C[data_per_kernel * i], nullptr, &write_events[3 * i + 2]));
+                ASSERT_CL(fused_kernels[i].setArg(5, launch_repetitions));
+            }
+            for (int i = 0; i < config.programSettings->kernelReplications; i++) {
+                ASSERT_CL(command_queues[i].finish());
+            }
+
+            // Start the kernels of all replications at the same time
+            cl::UserEvent start_event(*config.context, &err);
+            ASSERT_CL(err);
+            std::vector<cl::Event> start_events({start_event});
+            std::vector<cl::Event> fused_events(config.programSettings->kernelReplications);
+            for (int i = 0; i < config.programSettings->kernelReplications; i++) {
+                ASSERT_CL(command_queues[i].enqueueNDRangeKernel(fused_kernels[i], cl::NullRange, cl::NDRange(1), cl::NDRange(1), &start_events, &fused_events[i]));
+            }
+#ifndef INTEL_FPGA
+            auto startExecution = std::chrono::high_resolution_clock::now();
+#endif
+            start_event.setStatus(CL_COMPLETE);
+            cl::Event::waitForEvents(fused_events);
+#ifndef INTEL_FPGA
+            std::chrono::duration<double> duration = std::chrono::high_resolution_clock::now() - startExecution;
+#endif
+
+            std::vector<cl::Event> read_events(3 * config.programSettings->kernelReplications);
+            for (int i = 0; i < config.programSettings->kernelReplications; i++) {
+                ASSERT_CL(command_queues[i].enqueueReadBuffer(Buffers_A[i], CL_FALSE, 0, sizeof(T) * data_per_kernel, &A[data_per_kernel * i], nullptr, &read_events[3 * i]));
+                ASSERT_CL(command_queues[i].enqueueReadBuffer(Buffers_B[i], CL_FALSE, 0, sizeof(T) * data_per_kernel, &B[data_per_kernel * i], nullptr, &read_events[3 * i + 1]));
+                ASSERT_CL(command_queues[i].enqueueReadBuffer(Buffers_C[i], CL_FALSE, 0, sizeof(T) * data_per_kernel, &C[data_per_kernel * i], nullptr, &read_events[3 * i + 2]));
+#ifdef INTEL_FPGA
+                ASSERT_CL(command_queues[i].enqueueReadBuffer(timestamp_buffers[i], CL_FALSE, 0,
+                                        sizeof(cl_ulong) * FUSED_TIMESTAMPS_PER_REPETITION * launch_repetitions, timestamps[i].data()));
+#endif
+            }
+            for (int i = 0; i < config.programSettings->kernelReplications; i++) {
+                ASSERT_CL(command_queues[i].finish());
+            }
+
+#ifdef INTEL_FPGA
+            // Seconds per cycle of every replication. The launch overhead is contained in the event duration, but not
+            // in the cycle count, so the clock frequency is slightly underestimated for short launches.
+            std::vector<double> cycle_time(config.programSettings->kernelReplications);
+            for (int i = 0; i < config.programSettings->kernelReplications; i++) {
+                cl_ulong start, end;
+                ASSERT_CL(fused_events[i].getProfilingInfo(CL_PROFILING_COMMAND_START, &start));
+                ASSERT_CL(fused_events[i].getProfilingInfo(CL_PROFILING_COMMAND_END, &end));
+                cl_ulong cycles = timestamps[i][FUSED_TIMESTAMPS_PER_REPETITION * launch_repetitions - 1] - timestamps[i][0];
+                cycle_time[i] = (cycles > 0) ? static_cast<double>(end - start) * 1.0e-9 / cycles : 0.0;
+            }
+            // The replications work concurrently, so the slowest replication defines the time of an operation
+            auto elapsed = [&](uint rep, uint first, uint last) {
+                double t = 0.0;
+                for (int i = 0; i < config.programSettings->kernelReplications; i++) {
+                    const cl_ulong* ts = &timestamps[i][FUSED_TIMESTAMPS_PER_REPETITION * rep];
+                    t = std::max(t, static_cast<double>(ts[last] - ts[first]) * cycle_time[i]);
+                }
+                return t;
+            };
+            for (uint rep = 0; rep < launch_repetitions; rep++) {
+                for (size_t op = 0; op < operation_keys.size(); op++) {
+                    timingMap[operation_keys[op]].push_back(elapsed(rep, op, op + 1));
+                }
+                timingMap[FUSED_KEY].push_back(elapsed(rep, 0, FUSED_TIMESTAMPS_PER_REPETITION - 1));
+            }
+#else
+            // Without timestamps, the launch time is evenly distributed to the repetitions of the launch
+            for (uint rep = 0; rep < launch_repetitions; rep++) {
+                timingMap[FUSED_KEY].push_back(duration.count() / launch_repetitions);
+            }
+#endif
+
+            for (int i = 0; i < config.programSettings->kernelReplications; i++) {
+                for (int t = 0; t < 3; t++) {
+                    profiler.record(PCIE_WRITE_KEY, i, write_events[3 * i + t]);
+                    profiler.record(PCIE_READ_KEY, i, read_events[3 * i + t]);
+                }
+                profiler.record(FUSED_KEY, i, fused_events[i]);
+            }
+            profiler.collect(launch);
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+            if (counters) {
+                counters->read(command_queues[0]);
+                counters->print(launch);
+            }
+#endif
+            launch++;
+        }
+
+        std::unique_ptr<stream::StreamExecutionTimings> result(new stream::StreamExecutionTimings{
+                timingMap,
+                config.programSettings->streamArraySize,
+                profiler.timings
+        });
+        return result;
+#endif
+    }
+
+    template<typename T>
     bool initialize_queues_and_kernels(const hpcc_base::ExecutionSettings<stream::StreamProgramSettings> &config,
                                        unsigned int data_per_kernel, const std::vector<cl::Buffer> &Buffers_A,
                                        const std::vector<cl::Buffer> &Buffers_B,
@@ -360,8 +1032,8 @@ namespace bm_execution {
             cl::Kernel triadkernel(*config.program, ("triad_" + std::to_string(i)).c_str(), &err);
             ASSERT_CL(err);
 
-            HOST_DATA_TYPE scalar = static_cast<HOST_DATA_TYPE>(3.0);
-            HOST_DATA_TYPE test_scalar = static_cast<HOST_DATA_TYPE>(2.0);
+            T scalar = static_cast<T>(3.0);
+            T test_scalar = static_cast<T>(2.0);
             //prepare kernels
             err = testkernel.setArg(0, Buffers_A[i]);
             ASSERT_CL(err);
@@ -408,7 +1080,7 @@ namespace bm_execution {
             err = triadkernel.setArg(4, data_per_kernel);
             ASSERT_CL(err);
 
-            command_queues.push_back(cl::CommandQueue(*config.context));
+            command_queues.push_back(cl::CommandQueue(*config.context, *config.device, profiling::PROFILING_QUEUE_PROPERTIES));
             test_kernels.push_back(testkernel);
             copy_kernels.push_back(copykernel);
             scale_kernels.push_back(scalekernel);
@@ -419,6 +1091,7 @@ namespace bm_execution {
         return true;
     }
 
+    template<typename T>
     bool initialize_queues_and_kernels_single(const hpcc_base::ExecutionSettings<stream::StreamProgramSettings> &config,
                                        unsigned int data_per_kernel, const std::vector<cl::Buffer> &Buffers_A,
                                        const std::vector<cl::Buffer> &Buffers_B,
@@ -426,9 +1099,9 @@ namespace bm_execution {
                                        std::vector<cl::Kernel> &test_kernels, std::vector<cl::Kernel> &copy_kernels,
                                        std::vector<cl::Kernel> &scale_kernels, std::vector<cl::Kernel> &add_kernels,
                                        std::vector<cl::Kernel> &triad_kernels,
-                                       HOST_DATA_TYPE* A,
-                                       HOST_DATA_TYPE* B,
-                                       HOST_DATA_TYPE* C,
+                                       T* A,
+                                       T* B,
+                                       T* C,
                                        std::vector<cl::CommandQueue> &command_queues) {
         int err;
         for (int i=0; i < config.programSettings->kernelReplications; i++) {
@@ -458,8 +1131,8 @@ namespace bm_execution {
             cl::Kernel triadkernel(*config.program, ("calc_0:{calc_0_" + std::to_string(i+1) + "}").c_str(), &err);
             ASSERT_CL(err);
 #endif
-            HOST_DATA_TYPE scalar = static_cast<HOST_DATA_TYPE>(3.0);
-            HOST_DATA_TYPE test_scalar = static_cast<HOST_DATA_TYPE>(2.0);
+            T scalar = static_cast<T>(3.0);
+            T test_scalar = static_cast<T>(2.0);
             //prepare kernels
 #ifdef USE_SVM
             err = clSetKernelArgSVMPointer(testkernel(), 0,
@@ -505,7 +1178,7 @@ namespace bm_execution {
             err = copykernel.setArg(2, Buffers_C[i]);
             ASSERT_CL(err);
 #endif
-            err = copykernel.setArg(3, static_cast<HOST_DATA_TYPE>(1.0));
+            err = copykernel.setArg(3, static_cast<T>(1.0));
             ASSERT_CL(err);
             err = copykernel.setArg(4, data_per_kernel);
             ASSERT_CL(err);
@@ -555,7 +1228,7 @@ namespace bm_execution {
             err = addkernel.setArg(2, Buffers_C[i]);
             ASSERT_CL(err);
 #endif
-            err = addkernel.setArg(3, static_cast<HOST_DATA_TYPE>(1.0));
+            err = addkernel.setArg(3, static_cast<T>(1.0));
             ASSERT_CL(err);
             err = addkernel.setArg(4, data_per_kernel);
             ASSERT_CL(err);
@@ -587,7 +1260,7 @@ namespace bm_execution {
             err = triadkernel.setArg(5, TRIAD_KERNEL_TYPE);
             ASSERT_CL(err);
 
-            command_queues.push_back(cl::CommandQueue(*config.context));
+            command_queues.push_back(cl::CommandQueue(*config.context, *config.device, profiling::PROFILING_QUEUE_PROPERTIES));
             test_kernels.push_back(testkernel);
             copy_kernels.push_back(copykernel);
             scale_kernels.push_back(scalekernel);
@@ -598,6 +1271,7 @@ namespace bm_execution {
         return true;
     }
 
+    template<typename T>
     void initialize_buffers(const hpcc_base::ExecutionSettings<stream::StreamProgramSettings> &config, unsigned int data_per_kernel,
                             std::vector<cl::Buffer> &Buffers_A, std::vector<cl::Buffer> &Buffers_B,
                             std::vector<cl::Buffer> &Buffers_C) {
@@ -611,35 +1285,48 @@ namespace bm_execution {
         if (!config.programSettings->useMemoryInterleaving) {
             //Create Buffers for input and output
             for (int i=0; i < config.programSettings->kernelReplications; i++) {
+                // Default placement if no bank map is given. For boards with HBM, the selection of memory banks is done in the kernel code.
+                int default_bank[3] = {-1, -1, -1};
 #if defined(INTEL_FPGA) && !defined(USE_HBM)
                 if (config.programSettings->useSingleKernel) {
-                    //Create Buffers for input and output
-                    Buffers_A.push_back(cl::Buffer(*config.context, mem_bits | ((i + 1) << 16), sizeof(HOST_DATA_TYPE)*data_per_kernel));
-                    Buffers_B.push_back(cl::Buffer(*config.context, mem_bits | ((i + 1) << 16), sizeof(HOST_DATA_TYPE)*data_per_kernel));
-                    Buffers_C.push_back(cl::Buffer(*config.context, mem_bits | ((i + 1) << 16), sizeof(HOST_DATA_TYPE)*data_per_kernel));
+                    default_bank[0] = default_bank[1] = default_bank[2] = i;
                 }
                 else {
-                    //Create Buffers for input and output
-                    Buffers_A.push_back(cl::Buffer(*config.context, mem_bits | CL_CHANNEL_1_INTELFPGA, sizeof(HOST_DATA_TYPE)*data_per_kernel));
-                    Buffers_B.push_back(cl::Buffer(*config.context, mem_bits | CL_CHANNEL_3_INTELFPGA, sizeof(HOST_DATA_TYPE)*data_per_kernel));
-                    Buffers_C.push_back(cl::Buffer(*config.context, mem_bits | CL_CHANNEL_2_INTELFPGA, sizeof(HOST_DATA_TYPE)*data_per_kernel));
+                    default_bank[0] = 0;
+                    default_bank[1] = 2;
+                    default_bank[2] = 1;
                 }
 #endif
-#if defined(XILINX_FPGA) || defined(USE_HBM)
-                Buffers_A.push_back(cl::Buffer(*config.context, mem_bits, sizeof(HOST_DATA_TYPE)*data_per_kernel));
-                Buffers_B.push_back(cl::Buffer(*config.context, mem_bits, sizeof(HOST_DATA_TYPE)*data_per_kernel));
-                Buffers_C.push_back(cl::Buffer(*config.context, mem_bits, sizeof(HOST_DATA_TYPE)*data_per_kernel));
-#endif
+                // Place the buffers of every replication in the memory banks given by the bank map e.g. distinct HBM pseudo-channels
+                const placement::BankMap &banks = config.programSettings->memoryBanks;
+                Buffers_A.push_back(placement::createBuffer(*config.context, mem_bits, sizeof(T)*data_per_kernel, banks.bank(i, 0, 3, default_bank[0])));
+                Buffers_B.push_back(placement::createBuffer(*config.context, mem_bits, sizeof(T)*data_per_kernel, banks.bank(i, 1, 3, default_bank[1])));
+                Buffers_C.push_back(placement::createBuffer(*config.context, mem_bits, sizeof(T)*data_per_kernel, banks.bank(i, 2, 3, default_bank[2])));
             }
 
         } else {
             for (int i=0; i < config.programSettings->kernelReplications; i++) {
                 //Create Buffers for input and output
-                Buffers_A.push_back(cl::Buffer(*config.context, mem_bits, sizeof(HOST_DATA_TYPE)*data_per_kernel));
-                Buffers_B.push_back(cl::Buffer(*config.context, mem_bits, sizeof(HOST_DATA_TYPE)*data_per_kernel));
-                Buffers_C.push_back(cl::Buffer(*config.context, mem_bits, sizeof(HOST_DATA_TYPE)*data_per_kernel));
+                Buffers_A.push_back(cl::Buffer(*config.context, mem_bits, sizeof(T)*data_per_kernel));
+                Buffers_B.push_back(cl::Buffer(*config.context, mem_bits, sizeof(T)*data_per_kernel));
+                Buffers_C.push_back(cl::Buffer(*config.context, mem_bits, sizeof(T)*data_per_kernel));
+                placement::trackBuffer(Buffers_A.back(), memory_tracker::DEFAULT_BANK);
+                placement::trackBuffer(Buffers_B.back(), memory_tracker::DEFAULT_BANK);
+                placement::trackBuffer(Buffers_C.back(), memory_tracker::DEFAULT_BANK);
             }
         }
     }
 
+    template std::unique_ptr<stream::StreamExecutionTimings>
+    calculate<half_float::half>(const hpcc_base::ExecutionSettings<stream::StreamProgramSettings>& config,
+            half_float::half* A, half_float::half* B, half_float::half* C);
+
+    template std::unique_ptr<stream::StreamExecutionTimings>
+    calculate<cl_float>(const hpcc_base::ExecutionSettings<stream::StreamProgramSettings>& config,
+            cl_float* A, cl_float* B, cl_float* C);
+
+    template std::unique_ptr<stream::StreamExecutionTimings>
+    calculate<cl_double>(const hpcc_base::ExecutionSettings<stream::StreamProgramSettings>& config,
+            cl_double* A, cl_double* B, cl_double* C);
+
 }  // namespace bm_execution
@@ -0,0 +1,164 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* Related header files */
+#include "pcie_benchmark.hpp"
+
+/* C++ standard library headers */
+#include <chrono>
+#include <memory>
+#include <vector>
+
+/* Project's headers */
+#include "kernel_counters.hpp"
+
+namespace bm_execution {
+
+    /**
+    Measure the time from the call of the given function until all given queues are finished.
+
+    @param queues The queues used by the enqueued commands
+    @param enqueue Function that enqueues the commands
+    @return The measured time in seconds
+    */
+    template<typename F>
+    double
+    time_until_finished(std::vector<cl::CommandQueue> &queues, F enqueue) {
+        auto start = std::chrono::high_resolution_clock::now();
+        enqueue();
+        for (auto &q : queues) {
+            ASSERT_CL(q.finish())
+        }
+        std::chrono::duration<double> duration = std::chrono::high_resolution_clock::now() - start;
+        return duration.count();
+    }
+
+    std::unique_ptr<stream::PcieExecutionTimings>
+    calculate_pcie(const hpcc_base::ExecutionSettings<stream::PcieProgramSettings>& config, stream::PcieData &data) {
+        const auto &settings = *config.programSettings;
+        int err;
+
+        // Writes go to the first buffer, reads come from the second one, so both directions can be used at the same time
+        cl::Buffer write_buffer(*config.context, CL_MEM_READ_WRITE, data.size, nullptr, &err);
+        ASSERT_CL(err)
+        cl::Buffer read_buffer(*config.context, CL_MEM_READ_WRITE, data.size, nullptr, &err);
+        ASSERT_CL(err)
+        std::vector<cl::CommandQueue> queues;
+        for (int i = 0; i < 2; i++) {
+            queues.push_back(cl::CommandQueue(*config.context, *config.device, 0, &err));
+            ASSERT_CL(err)
+        }
+        ASSERT_CL(queues[0].enqueueWriteBuffer(read_buffer, CL_TRUE, 0, data.size, data.source))
+
+        std::unique_ptr<stream::PcieExecutionTimings> result(new stream::PcieExecutionTimings());
+        for (size_t size = settings.minTransferSize; size <= settings.maxTransferSize; size *= 2) {
+            result->transferSizes.push_back(size);
+        }
+        const std::vector<std::pair<std::string, std::pair<char*, char*>>> host_buffers = {
+            {"", {data.source, data.destination}},
+            {PCIE_SWEEP_PINNED_SUFFIX, {data.pinnedSource, data.pinnedDestination}}
+        };
+        for (const auto &h : host_buffers) {
+            result->transferTimings[PCIE_SWEEP_WRITE_KEY + h.first].resize(result->transferSizes.size());
+            result->transferTimings[PCIE_SWEEP_READ_KEY + h.first].resize(result->transferSizes.size());
+            result->transferTimings[PCIE_SWEEP_BIDIRECTIONAL_KEY + h.first].resize(result->transferSizes.size());
+        }
+
+        for (size_t s = 0; s < result->transferSizes.size(); s++) {
+            size_t size = result->transferSizes[s];
+            for (uint r = 0; r < settings.numRepetitions; r++) {
+                for (const auto &h : host_buffers) {
+                    char* src = h.second.first;
+                    char* dst = h.second.second;
+                    result->transferTimings[PCIE_SWEEP_WRITE_KEY + h.first][s].push_back(time_until_finished(queues, [&]() {
+                        ASSERT_CL(queues[0].enqueueWriteBuffer(write_buffer, CL_FALSE, 0, size, src))
+                    }));
+                    result->transferTimings[PCIE_SWEEP_READ_KEY + h.first][s].push_back(time_until_finished(queues, [&]() {
+                        ASSERT_CL(queues[1].enqueueReadBuffer(read_buffer, CL_FALSE, 0, size, dst))
+                    }));
+                    result->transferTimings[PCIE_SWEEP_BIDIRECTIONAL_KEY + h.first][s].push_back(time_until_finished(queues, [&]() {
+                        ASSERT_CL(queues[0].enqueueWriteBuffer(write_buffer, CL_FALSE, 0, size, src))
+                        ASSERT_CL(queues[1].enqueueReadBuffer(read_buffer, CL_FALSE, 0, size, dst))
+                    }));
+                }
+            }
+        }
+
+        // The pinned destination contains the data read last from the device. Read back the written data into the
+        // pageable destination, so both directions are validated
+        ASSERT_CL(queues[0].enqueueReadBuffer(write_buffer, CL_TRUE, 0, data.size, data.destination))
+
+        // The calc kernels are launched without work, so only the launch overhead is measured.
+        // Every queue uses its own kernel replication, so the launches can be executed concurrently
+        hpcc_base::DataType data_type = hpcc_base::detectDataType(*config.program, hpcc_base::retrieveDataType(STR(DEVICE_SCALAR_DATA_TYPE)));
+        std::vector<char> zero_scalar(hpcc_base::dataTypeSize(data_type), 0);
+        std::vector<cl::Kernel> kernels;
+        std::vector<cl::CommandQueue> launch_queues;
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+        std::vector<std::string> counter_names;
+        for (int i = 0; i < settings.kernelReplications; i++) {
+            counter_names.push_back("calc_" + std::to_string(i));
+        }
+        kernel_counters::KernelCounters counters(*config.context, counter_names);
+#endif
+        for (int i = 0; i < settings.kernelReplications; i++) {
+#ifdef INTEL_FPGA
+            cl::Kernel kernel(*config.program, ("calc_" + std::to_string(i)).c_str(), &err);
+#endif
+#ifdef XILINX_FPGA
+            cl::Kernel kernel(*config.program, ("calc_0:{calc_0_" + std::to_string(i+1) + "}").c_str(), &err);
+#endif
+            ASSERT_CL(err)
+            ASSERT_CL(kernel.setArg(0, read_buffer))
+            ASSERT_CL(kernel.setArg(1, read_buffer))
+            ASSERT_CL(kernel.setArg(2, write_buffer))
+            ASSERT_CL(kernel.setArg(3, zero_scalar.size(), zero_scalar.data()))
+            ASSERT_CL(kernel.setArg(4, 0u))
+            ASSERT_CL(kernel.setArg(5, COPY_KERNEL_TYPE))
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+            counters.setKernelArg(kernel, 6);
+#endif
+            kernels.push_back(kernel);
+            launch_queues.push_back(cl::CommandQueue(*config.context, *config.device, 0, &err));
+            ASSERT_CL(err)
+        }
+
+        for (int q = 1; q <= settings.kernelReplications; q++) {
+            std::vector<cl::CommandQueue> used_queues(launch_queues.begin(), launch_queues.begin() + q);
+            std::vector<double> latencies;
+            for (uint r = 0; r < settings.numRepetitions; r++) {
+                double total_time = 0.0;
+                for (uint l = 0; l < settings.kernelLaunches; l++) {
+                    total_time += time_until_finished(used_queues, [&]() {
+                        for (int k = 0; k < q; k++) {
+                            ASSERT_CL(used_queues[k].enqueueNDRangeKernel(kernels[k], cl::NullRange, cl::NDRange(1)))
+                        }
+                    });
+                }
+                latencies.push_back(total_time / settings.kernelLaunches);
+            }
+            result->launchLatencies.push_back(latencies);
+        }
+        return result;
+    }
+
+}  // namespace bm_execution
@@ -0,0 +1,243 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "pcie_benchmark.hpp"
+
+/* C++ standard library headers */
+#include <algorithm>
+#include <iomanip>
+#include <memory>
+#include <numeric>
+
+/* Project's headers */
+#include "parameters.h"
+
+namespace {
+
+/**
+ * @brief Value of a byte of the transferred pattern
+ *
+ * @param i index of the byte
+ * @return char the expected value
+ */
+inline char
+patternValue(size_t i) {
+    return static_cast<char>(i % 251);
+}
+
+}  // namespace
+
+stream::PcieProgramSettings::PcieProgramSettings(cxxopts::ParseResult &results) : hpcc_base::BaseSettings(results),
+    minTransferSize(results["min-size"].as<size_t>()),
+    maxTransferSize(results["max-size"].as<size_t>()),
+    kernelLaunches(results["launches"].as<uint>()) {
+
+}
+
+std::map<std::string, std::string>
+stream::PcieProgramSettings::getSettingsMap() {
+        auto map = hpcc_base::BaseSettings::getSettingsMap();
+        map["Transfer Sizes"] = std::to_string(minTransferSize) + " - " + std::to_string(maxTransferSize) + " Byte";
+        map["Kernel Launches"] = std::to_string(kernelLaunches) + " per queue, 1 - " + std::to_string(kernelReplications) + " queues";
+        return map;
+}
+
+stream::PcieData::PcieData(const cl::Context &_context, const cl::Device &_device, size_t _size) : context(_context),
+                mapQueue(_context, _device), size(_size) {
+    numa::memalign(reinterpret_cast<void**>(&source), 4096, size);
+    numa::memalign(reinterpret_cast<void**>(&destination), 4096, size);
+    int err;
+    // The runtime allocates the memory of these buffers in pinned host memory, so the mapped pointers
+    // can be used for DMA transfers without an additional copy
+    pinnedSourceBuffer = cl::Buffer(context, CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR, size, nullptr, &err);
+    ASSERT_CL(err)
+    pinnedDestinationBuffer = cl::Buffer(context, CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR, size, nullptr, &err);
+    ASSERT_CL(err)
+    pinnedSource = reinterpret_cast<char*>(mapQueue.enqueueMapBuffer(pinnedSourceBuffer, CL_TRUE, CL_MAP_READ | CL_MAP_WRITE, 0, size, nullptr, nullptr, &err));
+    ASSERT_CL(err)
+    pinnedDestination = reinterpret_cast<char*>(mapQueue.enqueueMapBuffer(pinnedDestinationBuffer, CL_TRUE, CL_MAP_READ | CL_MAP_WRITE, 0, size, nullptr, nullptr, &err));
+    ASSERT_CL(err)
+}
+
+stream::PcieData::~PcieData() {
+    mapQueue.enqueueUnmapMemObject(pinnedSourceBuffer, pinnedSource);
+    mapQueue.enqueueUnmapMemObject(pinnedDestinationBuffer, pinnedDestination);
+    mapQueue.finish();
+    numa::free(source);
+    numa::free(destination);
+}
+
+stream::PcieBenchmark::PcieBenchmark(int argc, char* argv[]) : HpccFpgaBenchmark(argc, argv) {
+    setupBenchmark(argc, argv);
+}
+
+void
+stream::PcieBenchmark::addAdditionalParseOptions(cxxopts::Options &options) {
+        options.add_options()
+            ("min-size", "Size of the smallest transfer in bytes",
+             cxxopts::value<size_t>()->default_value("4096"))
+            ("max-size", "Size of the largest transfer in bytes. The transfer size is doubled starting from the smallest size until this size is reached",
+             cxxopts::value<size_t>()->default_value("1073741824"))
+            ("launches", "Number of empty kernel launches per queue and repetition. The launch latency is measured for 1 up to the number of used kernel replications concurrently used queues",
+             cxxopts::value<uint>()->default_value("100"));
+}
+
+bool
+stream::PcieBenchmark::checkInputParameters() {
+    bool validationResult = true;
+    auto &settings = *executionSettings->programSettings;
+    if (settings.communicationType == hpcc_base::CommunicationType::cpu_only) {
+        std::cerr << "ERROR: The PCIe microbenchmark measures the transfers to a device and can not be executed with the communication type CPU!" << std::endl;
+        validationResult = false;
+    }
+    if (settings.minTransferSize == 0 || settings.minTransferSize > settings.maxTransferSize) {
+        std::cerr << "ERROR: The smallest transfer size has to be greater than 0 and must not exceed the largest transfer size!" << std::endl;
+        validationResult = false;
+    }
+    if (settings.kernelLaunches == 0) {
+        std::cerr << "ERROR: At least one kernel launch is required to measure the launch latency!" << std::endl;
+        validationResult = false;
+    }
+    return validationResult;
+}
+
+std::unique_ptr<stream::PcieData>
+stream::PcieBenchmark::generateInputData() {
+    auto d = std::unique_ptr<stream::PcieData>(new stream::PcieData(*executionSettings->context, *executionSettings->device,
+                                                executionSettings->programSettings->maxTransferSize));
+#pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < d->size; i++) {
+        d->source[i] = patternValue(i);
+        d->pinnedSource[i] = patternValue(i);
+        d->destination[i] = 0;
+        d->pinnedDestination[i] = 0;
+    }
+    return d;
+}
+
+std::unique_ptr<stream::PcieExecutionTimings>
+stream::PcieBenchmark::executeKernel(PcieData &data) {
+    return bm_execution::calculate_pcie(*executionSettings, data);
+}
+
+bool
+stream::PcieBenchmark::validateOutputAndPrintError(PcieData &data) {
+    size_t errors = 0;
+#pragma omp parallel for schedule(static) reduction(+:errors)
+    for (size_t i = 0; i < data.size; i++) {
+        errors += (data.destination[i] != patternValue(i)) ? 1 : 0;
+        errors += (data.pinnedDestination[i] != patternValue(i)) ? 1 : 0;
+    }
+#ifdef _USE_MPI_
+    size_t total_errors = 0;
+    MPI_Reduce(&errors, &total_errors, 1, MPI_UNSIGNED_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    errors = total_errors;
+#endif
+    if (mpi_comm_rank == 0) {
+        if (errors > 0) {
+            std::cerr << "ERROR: " << errors << " bytes read back from the devices differ from the written data!" << std::endl;
+            return false;
+        }
+        std::cout << "All bytes read back from the devices match the written data" << std::endl;
+    }
+    return true;
+}
+
+void
+stream::PcieBenchmark::collectAndPrintResults(const stream::PcieExecutionTimings &output) {
+    // Average the measurements of all ranks like done in STREAM
+    auto average = [this](const std::vector<double> &values) {
+        std::vector<double> avg_measures(values.size());
+#ifdef _USE_MPI_
+        int mpi_size = mpi_comm_size;
+        MPI_Reduce(values.data(), avg_measures.data(), values.size(), MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+        std::for_each(avg_measures.begin(),avg_measures.end(), [mpi_size](double& x) {x /= mpi_size;});
+#else
+        std::copy(values.begin(), values.end(), avg_measures.begin());
+#endif
+        return discardWarmup(avg_measures);
+    };
+
+    if (mpi_comm_rank == 0) {
+        std::cout << "Best transfer rates in MB/s:" << std::endl;
+        std::cout << std::setw(ENTRY_SPACE) << "Size Byte";
+        for (const auto &t : output.transferTimings) {
+            std::cout << std::setw(ENTRY_SPACE + 10) << t.first;
+        }
+        std::cout << std::endl;
+    }
+    for (size_t s = 0; s < output.transferSizes.size(); s++) {
+        size_t size = output.transferSizes[s];
+        if (mpi_comm_rank == 0) {
+            std::cout << std::setw(ENTRY_SPACE) << size;
+        }
+        for (const auto &t : output.transferTimings) {
+            auto times = average(t.second[s]);
+            if (mpi_comm_rank == 0) {
+                // Bidirectional transfers move the data in both directions at the same time
+                double bytes = static_cast<double>(size) * ((t.first.find(PCIE_SWEEP_BIDIRECTIONAL_KEY) == 0) ? 2.0 : 1.0);
+                double minTime = *std::min_element(times.begin(), times.end());
+                double avgTime = std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+                double bestRate = bytes / minTime * 1.0e-6 * mpi_comm_size;
+                std::string name = t.first + "_" + std::to_string(size);
+                timings.emplace(name, times);
+                results.emplace(name + "_best_rate", hpcc_base::HpccResult(bestRate, "MB/s"));
+                results.emplace(name + "_avg_t", hpcc_base::HpccResult(avgTime, "s"));
+                results.emplace(name + "_min_t", hpcc_base::HpccResult(minTime, "s"));
+                std::cout << std::setw(ENTRY_SPACE + 10) << bestRate;
+            }
+        }
+        if (mpi_comm_rank == 0) {
+            std::cout << std::endl;
+        }
+    }
+
+    if (mpi_comm_rank == 0) {
+        std::cout << std::endl << "Empty kernel launch latency:" << std::endl;
+        std::cout << std::setw(ENTRY_SPACE) << "Queues";
+        std::cout << std::setw(ENTRY_SPACE) << "Avg time s";
+        std::cout << std::setw(ENTRY_SPACE) << "Min time";
+        std::cout << std::setw(ENTRY_SPACE) << "Max time";
+        std::cout << std::setw(ENTRY_SPACE) << "Launches/s" << std::endl;
+    }
+    for (size_t q = 0; q < output.launchLatencies.size(); q++) {
+        auto times = average(output.launchLatencies[q]);
+        if (mpi_comm_rank == 0) {
+            double minTime = *std::min_element(times.begin(), times.end());
+            double avgTime = std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+            double maxTime = *std::max_element(times.begin(), times.end());
+            // All queues launch their kernels concurrently
+            double launchRate = static_cast<double>(q + 1) / minTime;
+            std::string name = "launch_latency_" + std::to_string(q + 1);
+            timings.emplace(name, times);
+            results.emplace(name + "_avg_t", hpcc_base::HpccResult(avgTime, "s"));
+            results.emplace(name + "_min_t", hpcc_base::HpccResult(minTime, "s"));
+            results.emplace(name + "_max_t", hpcc_base::HpccResult(maxTime, "s"));
+            results.emplace(name + "_rate", hpcc_base::HpccResult(launchRate, "1/s"));
+            std::cout << std::setw(ENTRY_SPACE) << (q + 1);
+            std::cout << std::setw(ENTRY_SPACE) << avgTime;
+            std::cout << std::setw(ENTRY_SPACE) << minTime;
+            std::cout << std::setw(ENTRY_SPACE) << maxTime;
+            std::cout << std::setw(ENTRY_SPACE) << launchRate << std::endl;
+        }
+    }
+}
@@ -0,0 +1,282 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef SRC_HOST_PCIE_BENCHMARK_H_
+#define SRC_HOST_PCIE_BENCHMARK_H_
+
+/* C++ standard library headers */
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/* Project's headers */
+#include "hpcc_benchmark.hpp"
+#include "parameters.h"
+
+// Map keys for the transfer timings
+#define PCIE_SWEEP_READ_KEY "PCI read"
+#define PCIE_SWEEP_WRITE_KEY "PCI write"
+#define PCIE_SWEEP_BIDIRECTIONAL_KEY "PCI bidirectional"
+#define PCIE_SWEEP_PINNED_SUFFIX " pinned"
+
+/**
+ * @brief Contains the PCIe and kernel launch microbenchmark. It uses the STREAM single kernel bitstream,
+ *          so it can be executed on every device STREAM is built for.
+ *
+ */
+namespace stream {
+
+/**
+ * @brief The settings of the PCIe microbenchmark
+ *
+ */
+class PcieProgramSettings : public hpcc_base::BaseSettings {
+
+public:
+    /**
+     * @brief Size of the smallest transfer in bytes
+     *
+     */
+    size_t minTransferSize;
+
+    /**
+     * @brief Size of the largest transfer in bytes. The size is doubled from the smallest size until this size is reached.
+     *
+     */
+    size_t maxTransferSize;
+
+    /**
+     * @brief Number of empty kernel launches per queue and repetition used to measure the launch latency
+     *
+     */
+    uint kernelLaunches;
+
+    /**
+     * @brief Construct a new Pcie Program Settings object
+     *
+     * @param results the result map from parsing the program input parameters
+     */
+    PcieProgramSettings(cxxopts::ParseResult &results);
+
+    /**
+     * @brief Get a map of the settings. This map will be used to print the final configuration.
+     *
+     * @return a map of program parameters. keys are the name of the parameter.
+     */
+    std::map<std::string, std::string> getSettingsMap() override;
+
+};
+
+/**
+ * @brief The host buffers the transfers are executed with. Every buffer has the size of the largest transfer.
+ *
+ */
+class PcieData {
+
+public:
+    /**
+     * @brief The context the pinned buffers are allocated in
+     *
+     */
+    cl::Context context;
+
+    /**
+     * @brief Queue that is used to map the pinned buffers
+     *
+     */
+    cl::CommandQueue mapQueue;
+
+    /**
+     * @brief Size of every host buffer in bytes
+     *
+     */
+    size_t size;
+
+    /**
+     * @brief Pageable host buffer that is written to the device
+     *
+     */
+    char *source;
+
+    /**
+     * @brief Pageable host buffer the device buffer is read into
+     *
+     */
+    char *destination;
+
+    /**
+     * @brief Buffers allocated with CL_MEM_ALLOC_HOST_PTR that back the pinned host pointers
+     *
+     */
+    cl::Buffer pinnedSourceBuffer;
+    cl::Buffer pinnedDestinationBuffer;
+
+    /**
+     * @brief Mapped pinned host buffer that is written to the device
+     *
+     */
+    char *pinnedSource;
+
+    /**
+     * @brief Mapped pinned host buffer the device buffer is read into
+     *
+     */
+    char *pinnedDestination;
+
+    /**
+     * @brief Construct a new Pcie Data object and map the pinned buffers
+     *
+     * @param _context the context used to allocate the pinned buffers
+     * @param _device the device of the context
+     * @param _size the size of every buffer in bytes
+     */
+    PcieData(const cl::Context &_context, const cl::Device &_device, size_t _size);
+
+    PcieData(const PcieData&) = delete;
+    PcieData& operator=(const PcieData&) = delete;
+
+    /**
+     * @brief Destroy the Pcie Data object and unmap the pinned buffers
+     *
+     */
+    ~PcieData();
+
+};
+
+/**
+ * @brief Measured timings of the transfer sweep and the kernel launches
+ *
+ */
+class PcieExecutionTimings {
+public:
+    /**
+     * @brief The sizes of all measured transfers in bytes
+     *
+     */
+    std::vector<size_t> transferSizes;
+
+    /**
+     * @brief Transfer times for every transfer type. The outer vector contains one entry per transfer size,
+     *          the inner vector one time per repetition in seconds.
+     *
+     */
+    std::map<std::string, std::vector<std::vector<double>>> transferTimings;
+
+    /**
+     * @brief Average time from the enqueue to the completion of an empty kernel. The outer vector contains
+     *          one entry for every number of concurrently used queues starting with a single queue,
+     *          the inner vector one time per repetition in seconds.
+     *
+     */
+    std::vector<std::vector<double>> launchLatencies;
+};
+
+/**
+ * @brief Implementation of the PCIe and kernel launch microbenchmark
+ *
+ */
+class PcieBenchmark : public hpcc_base::HpccFpgaBenchmark<PcieProgramSettings, PcieData, PcieExecutionTimings> {
+
+protected:
+
+    /**
+     * @brief Additional input parameters of the microbenchmark
+     *
+     * @param options
+     */
+    void
+    addAdditionalParseOptions(cxxopts::Options &options) override;
+
+public:
+
+    /**
+     * @brief Allocate the host buffers and fill the source buffers with a pattern
+     *
+     * @return std::unique_ptr<PcieData>
+     */
+    std::unique_ptr<PcieData>
+    generateInputData() override;
+
+    /**
+     * @brief Execute the transfer sweep and the kernel launches
+     *
+     * @param data
+     * @return std::unique_ptr<PcieExecutionTimings>
+     */
+    std::unique_ptr<PcieExecutionTimings>
+    executeKernel(PcieData &data) override;
+
+    /**
+     * @brief Check that the data read back from the device matches the written data
+     *
+     * @param data
+     * @return true
+     * @return false
+     */
+    bool
+    validateOutputAndPrintError(PcieData &data) override;
+
+    /**
+     * @brief Print the bandwidth of every transfer size and the launch latency for every number of queues
+     *
+     * @param output
+     */
+    void
+    collectAndPrintResults(const PcieExecutionTimings &output) override;
+
+    /**
+     * @brief Check the transfer sizes and that a device is used
+     *
+     * @return true if the sizes are valid
+     * @return false otherwise
+     */
+    bool
+    checkInputParameters() override;
+
+    /**
+     * @brief Construct a new Pcie Benchmark object
+     *
+     * @param argc the number of program input parameters
+     * @param argv the program input parameters as array of strings
+     */
+    PcieBenchmark(int argc, char* argv[]);
+
+};
+
+} // namespace stream
+
+namespace bm_execution {
+
+    /**
+     * @brief Measure the transfer times for all sizes and the latency of empty launches of the calc kernels
+     *
+     * @param config The ExecutionSettings with the OpenCL objects and program settings
+     * @param data The host buffers. The destination buffers contain the data read back last from the device afterwards.
+     * @return std::unique_ptr<stream::PcieExecutionTimings> The measured timings
+     */
+    std::unique_ptr<stream::PcieExecutionTimings>
+    calculate_pcie(const hpcc_base::ExecutionSettings<stream::PcieProgramSettings>& config, stream::PcieData &data);
+
+}  // namespace bm_execution
+
+#endif // SRC_HOST_PCIE_BENCHMARK_H_
@@ -27,66 +27,176 @@ SOFTWARE.
 #include "stream_benchmark.hpp"
 
 /* C++ standard library headers */
+#include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <random>
 
 /* Project's headers */
 #include "execution.hpp"
+#include "half_conversion.hpp"
 #include "parameters.h"
 
+namespace {
+
+/**
+ * @brief Number of half precision values that are converted at once in the validation
+ *
+ */
+const ssize_t VALIDATION_CHUNK_SIZE = 4096;
+
+/**
+ * @brief Calculate the sum of the absolute differences between the values of an array and the expected value
+ *
+ * @param values The array
+ * @param expected The expected value of all elements
+ * @param size Number of elements
+ * @return double The sum of the absolute errors
+ */
+template<typename T>
+double
+absoluteErrorSum(const T* values, T expected, ssize_t size) {
+    double sum = 0.0;
+#pragma omp parallel for schedule(static) reduction(+:sum)
+    for (ssize_t j = 0; j < size; j++) {
+        sum += std::abs(values[j] - expected);
+    }
+    return sum;
+}
+
+/**
+ * @brief Half precision values are converted to single precision in chunks with the SIMD conversion of the host,
+ *          because the arithmetic on half precision values is emulated in software
+ *
+ */
+template<>
+double
+absoluteErrorSum<half_float::half>(const half_float::half* values, half_float::half expected, ssize_t size) {
+    const float expected_f = static_cast<float>(expected);
+    double sum = 0.0;
+#pragma omp parallel for schedule(static) reduction(+:sum)
+    for (ssize_t c = 0; c < size; c += VALIDATION_CHUNK_SIZE) {
+        float chunk[VALIDATION_CHUNK_SIZE];
+        ssize_t count = std::min(VALIDATION_CHUNK_SIZE, size - c);
+        half_conversion::halfToFloat(reinterpret_cast<const uint16_t*>(values + c), chunk, count);
+        for (ssize_t j = 0; j < count; j++) {
+            sum += std::abs(chunk[j] - expected_f);
+        }
+    }
+    return sum;
+}
+
+/**
+ * @brief Count the elements of an array whose relative error exceeds epsilon
+ *
+ * @param values The array
+ * @param expected The expected value of all elements
+ * @param epsilon The allowed relative error
+ * @param size Number of elements
+ * @return int Number of wrong elements
+ */
+template<typename T>
+int
+countErrors(const T* values, T expected, double epsilon, ssize_t size) {
+    int errors = 0;
+#pragma omp parallel for schedule(static) reduction(+:errors)
+    for (ssize_t j = 0; j < size; j++) {
+        if (std::abs(values[j]/expected-1.0) > epsilon) {
+            errors++;
+        }
+    }
+    return errors;
+}
+
+template<>
+int
+countErrors<half_float::half>(const half_float::half* values, half_float::half expected, double epsilon, ssize_t size) {
+    const float expected_f = static_cast<float>(expected);
+    int errors = 0;
+#pragma omp parallel for schedule(static) reduction(+:errors)
+    for (ssize_t c = 0; c < size; c += VALIDATION_CHUNK_SIZE) {
+        float chunk[VALIDATION_CHUNK_SIZE];
+        ssize_t count = std::min(VALIDATION_CHUNK_SIZE, size - c);
+        half_conversion::halfToFloat(reinterpret_cast<const uint16_t*>(values + c), chunk, count);
+        for (ssize_t j = 0; j < count; j++) {
+            if (std::abs(chunk[j]/expected_f-1.0) > epsilon) {
+                errors++;
+            }
+        }
+    }
+    return errors;
+}
+
+}  // namespace
+
 stream::StreamProgramSettings::StreamProgramSettings(cxxopts::ParseResult &results) : hpcc_base::BaseSettings(results),
     streamArraySize(results["s"].as<uint>()),
     kernelReplications(results["r"].as<uint>()),
-    useSingleKernel(!static_cast<bool>(results.count("multi-kernel"))) {
+    useSingleKernel(!static_cast<bool>(results.count("multi-kernel"))),
+    streamingChunks(results["streaming"].as<uint>()),
+    fusedRepetitions(results["fused"].as<uint>()),
+    useAccessPatterns(static_cast<bool>(results.count("access-patterns"))),
+    patternStride(results["stride"].as<uint>()),
+    patternBlockSize(results["block-size"].as<uint>()),
+    dataType(hpcc_base::retrieveDataType(results["data-type"].as<std::string>())) {
 
 }
 
 std::map<std::string, std::string>
 stream::StreamProgramSettings::getSettingsMap() {
         auto map = hpcc_base::BaseSettings::getSettingsMap();
-        map["Data Type"] = STR(HOST_DATA_TYPE);
+        map["Data Type"] = hpcc_base::dataTypeToString(dataType);
         std::stringstream ss;
-        ss << streamArraySize << " (" << static_cast<double>(streamArraySize * sizeof(HOST_DATA_TYPE)) << " Byte )";
+        ss << streamArraySize;
+        if (dataType != hpcc_base::DataType::automatic) {
+            ss << " (" << static_cast<double>(streamArraySize * hpcc_base::dataTypeSize(dataType)) << " Byte )";
+        }
         map["Array Size"] = ss.str();
         map["Kernel Replications"] = std::to_string(kernelReplications);
         map["Kernel Type"] = (useSingleKernel ? "Single" : "Separate");
+        map["Streaming Chunks"] = (streamingChunks > 0) ? std::to_string(streamingChunks) : "Disabled";
+        map["Fused Kernel"] = (fusedRepetitions > 0) ? std::to_string(fusedRepetitions) + " repetitions per launch" : "Disabled";
+        map["Access Patterns"] = useAccessPatterns ? "Stride " + std::to_string(patternStride) + ", blocks of "
+                                    + std::to_string(patternBlockSize) + " values" : "Disabled";
         return map;
 }
 
-stream::StreamData::StreamData(const cl::Context& _context, size_t size) : context(_context) {
+template<typename T>
+stream::TypedStreamData<T>::TypedStreamData(const cl::Context& _context, hpcc_base::DataType _dataType, size_t size) : StreamData(_context, _dataType) {
 #ifdef INTEL_FPGA
 #ifdef USE_SVM
-    A = reinterpret_cast<HOST_DATA_TYPE*>(
+    A = reinterpret_cast<T*>(
                             clSVMAlloc(context(), 0 ,
-                            size * sizeof(HOST_DATA_TYPE), 1024));
-    B = reinterpret_cast<HOST_DATA_TYPE*>(
+                            size * sizeof(T), 1024));
+    B = reinterpret_cast<T*>(
                             clSVMAlloc(context(), 0 ,
-                            size * sizeof(HOST_DATA_TYPE), 1024));
-    C = reinterpret_cast<HOST_DATA_TYPE*>(
+                            size * sizeof(T), 1024));
+    C = reinterpret_cast<T*>(
                             clSVMAlloc(context(), 0 ,
-                            size * sizeof(HOST_DATA_TYPE), 1024));
+                            size * sizeof(T), 1024));
 #else
-    posix_memalign(reinterpret_cast<void**>(&A), 64, size * sizeof(HOST_DATA_TYPE));
-    posix_memalign(reinterpret_cast<void**>(&B), 64, size * sizeof(HOST_DATA_TYPE));
-    posix_memalign(reinterpret_cast<void**>(&C), 64, size * sizeof(HOST_DATA_TYPE));
+    numa::memalign(reinterpret_cast<void**>(&A), 64, size * sizeof(T));
+    numa::memalign(reinterpret_cast<void**>(&B), 64, size * sizeof(T));
+    numa::memalign(reinterpret_cast<void**>(&C), 64, size * sizeof(T));
 #endif
 #endif
 #ifdef XILINX_FPGA
-    posix_memalign(reinterpret_cast<void**>(&A), 4096, size * sizeof(HOST_DATA_TYPE));
-    posix_memalign(reinterpret_cast<void**>(&B), 4096, size * sizeof(HOST_DATA_TYPE));
-    posix_memalign(reinterpret_cast<void**>(&C), 4096, size * sizeof(HOST_DATA_TYPE));
+    numa::memalign(reinterpret_cast<void**>(&A), 4096, size * sizeof(T));
+    numa::memalign(reinterpret_cast<void**>(&B), 4096, size * sizeof(T));
+    numa::memalign(reinterpret_cast<void**>(&C), 4096, size * sizeof(T));
 #endif
 }
 
-stream::StreamData::~StreamData() {
+template<typename T>
+stream::TypedStreamData<T>::~TypedStreamData() {
 #ifdef USE_SVM
     clSVMFree(context(), reinterpret_cast<void*>(A));
     clSVMFree(context(), reinterpret_cast<void*>(B));
     clSVMFree(context(), reinterpret_cast<void*>(C));
 #else
-    free(A);
-    free(B);
-    free(C);
+    numa::free(A);
+    numa::free(B);
+    numa::free(C);
 #endif
 }
 
@@ -99,11 +209,97 @@ stream::StreamBenchmark::addAdditionalParseOptions(cxxopts::Options &options) {
         options.add_options()
             ("s", "Size of the data arrays",
              cxxopts::value<uint>()->default_value(std::to_string(DEFAULT_ARRAY_LENGTH)))
-            ("multi-kernel", "Use the legacy multi kernel implementation");
+            ("multi-kernel", "Use the legacy multi kernel implementation")
+            ("streaming", "Split the arrays of every replication into the given number of chunks and overlap the PCIe transfers with the kernel execution. 0 disables the streaming mode",
+             cxxopts::value<uint>()->default_value("0"))
+            ("fused", "Execute all four operations in a single launch of the fused kernel and measure them with device side timestamps. The value is the number of repetitions executed per launch. 0 disables the fused mode",
+             cxxopts::value<uint>()->default_value("0")->implicit_value("1"))
+            ("access-patterns", "Additionally measure the bandwidth of strided, blocked strided, gather and scatter accesses")
+            ("stride", "Distance between two accessed values or blocks in the strided access patterns",
+             cxxopts::value<uint>()->default_value("16"))
+            ("block-size", "Number of consecutive values in a block of the blocked strided access pattern",
+             cxxopts::value<uint>()->default_value("64"))
+            ("data-type", "Data type of the arrays. Valid values: HALF, FLOAT, DOUBLE or AUTO to use the data type of the kernels in the bitstream",
+             cxxopts::value<std::string>()->default_value("AUTO"));
+}
+
+bool
+stream::StreamBenchmark::checkInputParameters() {
+    bool validationResult = true;
+    auto &settings = *executionSettings->programSettings;
+    if (settings.fusedRepetitions > 0) {
+#ifndef USE_FUSED_KERNEL
+        std::cerr << "ERROR: The fused mode requires kernels that are built with USE_FUSED_KERNEL!" << std::endl;
+        validationResult = false;
+#endif
+        if (!settings.useSingleKernel) {
+            std::cerr << "ERROR: The fused mode can not be combined with the multi kernel implementation!" << std::endl;
+            validationResult = false;
+        }
+        if (settings.streamingChunks > 0) {
+            std::cerr << "ERROR: The fused mode can not be combined with the streaming mode!" << std::endl;
+            validationResult = false;
+        }
+        if (settings.communicationType == hpcc_base::CommunicationType::cpu_only) {
+            std::cerr << "ERROR: The fused mode measures the kernels on the device and can not be executed with the communication type CPU!" << std::endl;
+            validationResult = false;
+        }
+    }
+    if (settings.useAccessPatterns) {
+#ifndef USE_ACCESS_PATTERN_KERNEL
+        std::cerr << "ERROR: The access patterns require kernels that are built with USE_ACCESS_PATTERN_KERNEL!" << std::endl;
+        validationResult = false;
+#endif
+        if (!settings.useSingleKernel || settings.streamingChunks > 0 || settings.fusedRepetitions > 0
+                || settings.communicationType == hpcc_base::CommunicationType::cpu_only) {
+            std::cerr << "ERROR: The access patterns can only be measured with the single kernel on the device without streaming or fused mode!" << std::endl;
+            validationResult = false;
+        }
+        if (settings.patternStride == 0 || settings.patternBlockSize == 0) {
+            std::cerr << "ERROR: The stride and block size of the access patterns have to be greater than 0!" << std::endl;
+            validationResult = false;
+        }
+    }
+    return validationResult;
+}
+
+void
+stream::StreamBenchmark::adaptSettingsToBitstream() {
+    auto &settings = *executionSettings->programSettings;
+    hpcc_base::DataType detected = hpcc_base::DataType::automatic;
+    if (executionSettings->program) {
+        detected = hpcc_base::detectDataType(*executionSettings->program, hpcc_base::DataType::automatic);
+    }
+    if (settings.dataType == hpcc_base::DataType::automatic) {
+        settings.dataType = (detected != hpcc_base::DataType::automatic) ? detected : hpcc_base::retrieveDataType(STR(DEVICE_SCALAR_DATA_TYPE));
+    }
+    else if (detected != hpcc_base::DataType::automatic && detected != settings.dataType
+                && settings.communicationType != hpcc_base::CommunicationType::cpu_only) {
+        // Only the CPU execution can use a different data type than the kernels
+        throw std::runtime_error("The data type " + hpcc_base::dataTypeToString(settings.dataType) + " does not match the data type "
+                                    + hpcc_base::dataTypeToString(detected) + " of the kernels!");
+    }
 }
 
 std::unique_ptr<stream::StreamExecutionTimings>
 stream::StreamBenchmark::executeKernel(StreamData &data) {
+    switch (data.dataType) {
+        case hpcc_base::DataType::half_precision: return executeTypedKernel(data.as<half_float::half>());
+        case hpcc_base::DataType::single_precision: return executeTypedKernel(data.as<cl_float>());
+        case hpcc_base::DataType::double_precision: return executeTypedKernel(data.as<cl_double>());
+        default: throw std::runtime_error("Data type " + hpcc_base::dataTypeToString(data.dataType) + " is not supported by the benchmark!");
+    }
+}
+
+template<typename T>
+std::unique_ptr<stream::StreamExecutionTimings>
+stream::StreamBenchmark::executeTypedKernel(TypedStreamData<T> &data) {
+    if (executionSettings->programSettings->communicationType == hpcc_base::CommunicationType::cpu_only) {
+        return bm_execution::calculate_cpu(*executionSettings,
+              data.A,
+              data.B,
+              data.C);
+    }
     return bm_execution::calculate(*executionSettings,
               data.A,
               data.B,
@@ -127,10 +323,14 @@ stream::StreamBenchmark::collectAndPrintResults(const stream::StreamExecutionTim
 #else
         std::copy(v.second.begin(), v.second.end(), avg_measures.begin());
 #endif
-        totalTimingsMap.insert({v.first,avg_measures});
+        totalTimingsMap.insert({v.first,discardWarmup(avg_measures)});
     }
 
     if (mpi_comm_rank == 0) {
+        for (const auto& t : profiling::toTimingsMap(output.deviceTimings)) {
+            timings.emplace("device_" + t.first, discardWarmup(t.second));
+        }
+
         std::cout << std::setw(ENTRY_SPACE) << "Function";
         std::cout << std::setw(ENTRY_SPACE) << "Best Rate MB/s";
         std::cout << std::setw(ENTRY_SPACE) << "Avg time s";
@@ -142,46 +342,123 @@ stream::StreamBenchmark::collectAndPrintResults(const stream::StreamExecutionTim
             double avgTime = accumulate(v.second.begin(), v.second.end(), 0.0)
                             / v.second.size();
             double maxTime = *max_element(v.second.begin(), v.second.end());
+            double bestRate = (static_cast<double>(hpcc_base::dataTypeSize(executionSettings->programSettings->dataType)) * output.arraySize * bm_execution::multiplicatorMap[v.first] / minTime) * 1.0e-6 * mpi_comm_size;
+
+            timings.emplace(v.first, v.second);
+            results.emplace(v.first + "_best_rate", hpcc_base::HpccResult(bestRate, "MB/s"));
+            results.emplace(v.first + "_avg_t", hpcc_base::HpccResult(avgTime, "s"));
+            results.emplace(v.first + "_min_t", hpcc_base::HpccResult(minTime, "s"));
+            results.emplace(v.first + "_max_t", hpcc_base::HpccResult(maxTime, "s"));
 
             std::cout << std::setw(ENTRY_SPACE) << v.first;
             std::cout << std::setw(ENTRY_SPACE)
-            << (static_cast<double>(sizeof(HOST_DATA_TYPE)) * output.arraySize * bm_execution::multiplicatorMap[v.first] / minTime) * 1.0e-6 * mpi_comm_size
+            << bestRate
                     << std::setw(ENTRY_SPACE) << avgTime
                     << std::setw(ENTRY_SPACE) << minTime
                     << std::setw(ENTRY_SPACE) << maxTime << std::endl;
         }
+        std::cout << std::endl;
+        for (auto v : totalTimingsMap) {
+            addStatistics(v.first + "_t", v.second);
+        }
+    }
+
+    // Bandwidth of the individual devices of a rank, if the work was shared between multiple devices
+    for (size_t d = 0; d < output.perDeviceTimings.size(); d++) {
+        uint device_array_size = output.arraySize / output.perDeviceTimings.size();
+        if (mpi_comm_rank == 0) {
+            std::cout << "Device " << d << ":" << std::endl;
+        }
+        for (auto v : output.perDeviceTimings[d]) {
+            std::vector<double> avg_measures(v.second.size());
+#ifdef _USE_MPI_
+            int mpi_size = mpi_comm_size;
+            MPI_Reduce(v.second.data(), avg_measures.data(), v.second.size(), MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+            std::for_each(avg_measures.begin(),avg_measures.end(), [mpi_size](double& x) {x /= mpi_size;});
+#else
+            std::copy(v.second.begin(), v.second.end(), avg_measures.begin());
+#endif
+            avg_measures = discardWarmup(avg_measures);
+            if (mpi_comm_rank == 0) {
+                double minTime = *min_element(avg_measures.begin(), avg_measures.end());
+                double bestRate = (static_cast<double>(hpcc_base::dataTypeSize(executionSettings->programSettings->dataType)) * device_array_size * bm_execution::multiplicatorMap[v.first] / minTime) * 1.0e-6 * mpi_comm_size;
+                results.emplace(v.first + "_best_rate_device" + std::to_string(d), hpcc_base::HpccResult(bestRate, "MB/s"));
+                std::cout << std::setw(ENTRY_SPACE) << v.first << std::setw(ENTRY_SPACE) << bestRate << std::endl;
+            }
+        }
     }
 }
 
 std::unique_ptr<stream::StreamData>
 stream::StreamBenchmark::generateInputData() {
-    auto d = std::unique_ptr<stream::StreamData>(new StreamData(*executionSettings->context, executionSettings->programSettings->streamArraySize));
+    switch (executionSettings->programSettings->dataType) {
+        case hpcc_base::DataType::half_precision: return generateTypedInputData<half_float::half>();
+        case hpcc_base::DataType::single_precision: return generateTypedInputData<cl_float>();
+        case hpcc_base::DataType::double_precision: return generateTypedInputData<cl_double>();
+        default: throw std::runtime_error("Data type " + hpcc_base::dataTypeToString(executionSettings->programSettings->dataType) + " is not supported by the benchmark!");
+    }
+}
+
+std::vector<memory_tracker::MemoryRequirement>
+stream::StreamBenchmark::estimateMemoryUsage() {
+    const auto &settings = *executionSettings->programSettings;
+    size_t array_bytes = static_cast<size_t>(settings.streamArraySize) * hpcc_base::dataTypeSize(settings.dataType);
+    std::vector<memory_tracker::MemoryRequirement> requirements = {{"A, B, C", array_bytes, 3, false}};
+    if (settings.communicationType != hpcc_base::CommunicationType::cpu_only) {
+        size_t buffer_bytes = array_bytes / settings.kernelReplications;
+        requirements.push_back({"A, B, C", buffer_bytes, 3 * settings.kernelReplications, true});
+        if (settings.useAccessPatterns) {
+            size_t index_bytes = static_cast<size_t>(settings.streamArraySize / settings.kernelReplications) * sizeof(cl_uint);
+            requirements.push_back({"Pattern output", buffer_bytes, settings.kernelReplications, true});
+            requirements.push_back({"Pattern indices", index_bytes, settings.kernelReplications, true});
+        }
+    }
+    return requirements;
+}
+
+template<typename T>
+std::unique_ptr<stream::StreamData>
+stream::StreamBenchmark::generateTypedInputData() {
+    auto d = std::unique_ptr<stream::TypedStreamData<T>>(new TypedStreamData<T>(*executionSettings->context, executionSettings->programSettings->dataType,
+                                                            executionSettings->programSettings->streamArraySize));
+    // The memory pages are touched first by the same threads that are used for the validation
+#pragma omp parallel for schedule(static)
     for (int i=0; i< executionSettings->programSettings->streamArraySize; i++) {
-        d->A[i] = 1.0;
-        d->B[i] = 2.0;
-        d->C[i] = 0.0;
+        d->A[i] = static_cast<T>(1.0);
+        d->B[i] = static_cast<T>(2.0);
+        d->C[i] = static_cast<T>(0.0);
     }
 
-    return d;
+    return std::unique_ptr<stream::StreamData>(std::move(d));
 }
 
-bool  
+bool
 stream::StreamBenchmark::validateOutputAndPrintError(stream::StreamData &data) {
-    HOST_DATA_TYPE aj,bj,cj,scalar;
+    switch (data.dataType) {
+        case hpcc_base::DataType::half_precision: return validateTypedOutputAndPrintError(data.as<half_float::half>());
+        case hpcc_base::DataType::single_precision: return validateTypedOutputAndPrintError(data.as<cl_float>());
+        case hpcc_base::DataType::double_precision: return validateTypedOutputAndPrintError(data.as<cl_double>());
+        default: throw std::runtime_error("Data type " + hpcc_base::dataTypeToString(data.dataType) + " is not supported by the benchmark!");
+    }
+}
+
+template<typename T>
+bool  
+stream::StreamBenchmark::validateTypedOutputAndPrintError(stream::TypedStreamData<T> &data) {
+    T aj,bj,cj,scalar;
     double aSumErr,bSumErr,cSumErr;
     double aAvgErr,bAvgErr,cAvgErr;
     double epsilon;
-    ssize_t	j;
     int	k,ierr,err;
 
     /* reproduce initialization */
-    aj = static_cast<HOST_DATA_TYPE>(1.0);
-    bj = static_cast<HOST_DATA_TYPE>(2.0);
-    cj = static_cast<HOST_DATA_TYPE>(0.0);
+    aj = static_cast<T>(1.0);
+    bj = static_cast<T>(2.0);
+    cj = static_cast<T>(0.0);
     /* a[] is modified during timing check */
-    aj = static_cast<HOST_DATA_TYPE>(2.0) * aj;
+    aj = static_cast<T>(2.0) * aj;
     /* now execute timing loop */
-    scalar = static_cast<HOST_DATA_TYPE>(3.0);
+    scalar = static_cast<T>(3.0);
     for (k=0; k<executionSettings->programSettings->numRepetitions; k++)
     {
         cj = aj;
@@ -191,14 +468,9 @@ stream::StreamBenchmark::validateOutputAndPrintError(stream::StreamData &data) {
     }
 
     /* accumulate deltas between observed and expected results */
-    aSumErr = 0.0;
-    bSumErr = 0.0;
-    cSumErr = 0.0;
-    for (j=0; j< executionSettings->programSettings->streamArraySize; j++) {
-        aSumErr += std::abs(data.A[j] - aj);
-        bSumErr += std::abs(data.B[j] - bj);
-        cSumErr += std::abs(data.C[j] - cj);
-    }
+    aSumErr = absoluteErrorSum(data.A, aj, executionSettings->programSettings->streamArraySize);
+    bSumErr = absoluteErrorSum(data.B, bj, executionSettings->programSettings->streamArraySize);
+    cSumErr = absoluteErrorSum(data.C, cj, executionSettings->programSettings->streamArraySize);
     aAvgErr = aSumErr / executionSettings->programSettings->streamArraySize;
     bAvgErr = bSumErr / executionSettings->programSettings->streamArraySize;
     cAvgErr = cSumErr / executionSettings->programSettings->streamArraySize;
@@ -208,54 +480,39 @@ stream::StreamBenchmark::validateOutputAndPrintError(stream::StreamData &data) {
     double totalBAvgErr = 0.0;
     double totalCAvgErr = 0.0;
     MPI_Reduce(&aAvgErr, &totalAAvgErr, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
-    MPI_Reduce(&bAvgErr, &totalAAvgErr, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
-    MPI_Reduce(&cAvgErr, &totalAAvgErr, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&bAvgErr, &totalBAvgErr, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(&cAvgErr, &totalCAvgErr, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
     aAvgErr = totalAAvgErr / mpi_comm_size;
     bAvgErr = totalBAvgErr / mpi_comm_size;
-    bAvgErr = totalBAvgErr / mpi_comm_size;
+    cAvgErr = totalCAvgErr / mpi_comm_size;
 #endif
 
     if (mpi_comm_rank == 0) {
 
-        epsilon = std::numeric_limits<HOST_DATA_TYPE>::epsilon();
+        epsilon = std::numeric_limits<T>::epsilon();
 
         err = 0;
         if (abs(aAvgErr/aj) > epsilon) {
             err++;
             printf ("Failed Validation on array a[], AvgRelAbsErr > epsilon (%e)\n",epsilon);
-            printf ("     Expected Value: %e, AvgAbsErr: %e, AvgRelAbsErr: %e\n",aj,aAvgErr,abs(aAvgErr)/aj);
-            ierr = 0;
-            for (j=0; j<executionSettings->programSettings->streamArraySize; j++) {
-                if (abs(data.A[j]/aj-1.0) > epsilon) {
-                    ierr++;
-                }
-            }
+            printf ("     Expected Value: %e, AvgAbsErr: %e, AvgRelAbsErr: %e\n",static_cast<double>(aj),aAvgErr,abs(aAvgErr)/aj);
+            ierr = countErrors(data.A, aj, epsilon, executionSettings->programSettings->streamArraySize);
             printf("     For array a[], %d errors were found.\n",ierr);
         }
         if (abs(bAvgErr/bj) > epsilon) {
             err++;
             printf ("Failed Validation on array b[], AvgRelAbsErr > epsilon (%e)\n",epsilon);
-            printf ("     Expected Value: %e, AvgAbsErr: %e, AvgRelAbsErr: %e\n",bj,bAvgErr,abs(bAvgErr)/bj);
+            printf ("     Expected Value: %e, AvgAbsErr: %e, AvgRelAbsErr: %e\n",static_cast<double>(bj),bAvgErr,abs(bAvgErr)/bj);
             printf ("     AvgRelAbsErr > Epsilon (%e)\n",epsilon);
-            ierr = 0;
-            for (j=0; j<executionSettings->programSettings->streamArraySize; j++) {
-                if (abs(data.B[j]/bj-1.0) > epsilon) {
-                    ierr++;
-                }
-            }
+            ierr = countErrors(data.B, bj, epsilon, executionSettings->programSettings->streamArraySize);
             printf("     For array b[], %d errors were found.\n",ierr);
         }
         if (abs(cAvgErr/cj) > epsilon) {
             err++;
             printf ("Failed Validation on array c[], AvgRelAbsErr > epsilon (%e)\n",epsilon);
-            printf ("     Expected Value: %e, AvgAbsErr: %e, AvgRelAbsErr: %e\n",cj,cAvgErr,abs(cAvgErr)/cj);
+            printf ("     Expected Value: %e, AvgAbsErr: %e, AvgRelAbsErr: %e\n",static_cast<double>(cj),cAvgErr,abs(cAvgErr)/cj);
             printf ("     AvgRelAbsErr > Epsilon (%e)\n",epsilon);
-            ierr = 0;
-            for (j=0; j<executionSettings->programSettings->streamArraySize; j++) {
-                if (abs(data.C[j]/cj-1.0) > epsilon) {
-                    ierr++;
-                }
-            }
+            ierr = countErrors(data.C, cj, epsilon, executionSettings->programSettings->streamArraySize);
             printf("     For array c[], %d errors were found.\n",ierr);
         }
         if (err == 0) {
@@ -265,4 +522,8 @@ stream::StreamBenchmark::validateOutputAndPrintError(stream::StreamData &data) {
         return false;
     }
     return true;
-}
\ No newline at end of file
+}
+
+template class stream::TypedStreamData<half_float::half>;
+template class stream::TypedStreamData<cl_float>;
+template class stream::TypedStreamData<cl_double>;
@@ -29,6 +29,7 @@ SOFTWARE.
 
 /* Project's headers */
 #include "hpcc_benchmark.hpp"
+#include "profiling.hpp"
 #include "parameters.h"
 
 #include "half.hpp"
@@ -64,6 +65,45 @@ public:
      */
     bool useSingleKernel;
 
+    /**
+     * @brief Number of chunks the array of every kernel replication is split into in streaming mode.
+     *          If 0, the streaming mode is disabled.
+     * 
+     */
+    uint streamingChunks;
+
+    /**
+     * @brief Number of repetitions that are executed by a single launch of the fused kernel.
+     *          If 0, the fused mode is disabled.
+     * 
+     */
+    uint fusedRepetitions;
+
+    /**
+     * @brief Indicator if the bandwidth of strided and indexed accesses is measured after the four operations
+     * 
+     */
+    bool useAccessPatterns;
+
+    /**
+     * @brief Distance between two accessed elements or blocks for the strided access patterns
+     * 
+     */
+    uint patternStride;
+
+    /**
+     * @brief Number of consecutive values that are accessed in the blocked strided access pattern
+     * 
+     */
+    uint patternBlockSize;
+
+    /**
+     * @brief The data type of the arrays. If it is automatic, the data type is detected from the bitstream
+     *          during the setup of the benchmark.
+     * 
+     */
+    hpcc_base::DataType dataType;
+
     /**
      * @brief Construct a new Stream Program Settings object
      * 
@@ -80,53 +120,109 @@ public:
 
 };
 
+template<typename T>
+class TypedStreamData;
+
 /**
- * @brief Data class cotnaining the data the kernel is exeucted with
+ * @brief Data class cotnaining the data the kernel is exeucted with.
+ *          The arrays are stored by TypedStreamData for the data type that is used in the execution.
  * 
  */
 class StreamData {
 
 public:
     /**
-     * @brief The input array A of the benchmark
+     * @brief The data type of the arrays
      * 
      */
-    HOST_DATA_TYPE *A;
+    hpcc_base::DataType dataType;
 
     /**
-     * @brief The input array B of the benchmark
+     * @brief The context that is used to allocate memory in SVM mode
      * 
      */
-    HOST_DATA_TYPE *B;
+    cl::Context context;
 
     /**
-     * @brief The input array C of the benchmark
+     * @brief Construct a new Stream Data object
      * 
+     * @param _context the context that will be used to allocate SVM memory
+     * @param _dataType the data type of the arrays
      */
-    HOST_DATA_TYPE *C;
+    StreamData(const cl::Context& _context, hpcc_base::DataType _dataType) : dataType(_dataType), context(_context) {}
 
     /**
-     * @brief The context that is used to allocate memory in SVM mode
+     * @brief Destroy the Stream Data object
      * 
      */
-    cl::Context context;
+    virtual ~StreamData() {}
 
     /**
-     * @brief Construct a new Stream Data object
+     * @brief Access the arrays with their data type
+     * 
+     * @tparam T The data type of the arrays
+     * @return TypedStreamData<T>& The data with the typed arrays. Will throw a runtime error if the arrays have a different type.
+     */
+    template<typename T>
+    TypedStreamData<T>&
+    as();
+
+};
+
+/**
+ * @brief The arrays of the stream benchmark for a specific data type
+ * 
+ * @tparam T The data type of the arrays. Instantiated for half_float::half, cl_float and cl_double.
+ */
+template<typename T>
+class TypedStreamData : public StreamData {
+
+public:
+    /**
+     * @brief The input array A of the benchmark
+     * 
+     */
+    T *A;
+
+    /**
+     * @brief The input array B of the benchmark
+     * 
+     */
+    T *B;
+
+    /**
+     * @brief The input array C of the benchmark
+     * 
+     */
+    T *C;
+
+    /**
+     * @brief Construct a new Typed Stream Data object
      * 
      * @param _context the context that will be used to allocate SVM memory
+     * @param _dataType the data type of the arrays. Has to match T.
      * @param size the size of the data arrays in number of values
      */
-    StreamData(const cl::Context& _context, size_t size);
+    TypedStreamData(const cl::Context& _context, hpcc_base::DataType _dataType, size_t size);
 
     /**
-     * @brief Destroy the Stream Data object
+     * @brief Destroy the Typed Stream Data object
      * 
      */
-    ~StreamData();
+    ~TypedStreamData() override;
 
 };
 
+template<typename T>
+TypedStreamData<T>&
+StreamData::as() {
+    auto typed = dynamic_cast<TypedStreamData<T>*>(this);
+    if (typed == nullptr) {
+        throw std::runtime_error("The stream arrays are not stored with the requested data type!");
+    }
+    return *typed;
+}
+
 /**
  * @brief Measured execution timing from the kernel execution
  * 
@@ -144,6 +240,21 @@ public:
      * 
      */
     uint arraySize;
+
+    /**
+     * @brief Device-side timings of the kernel executions and buffer transfers of all replications
+     *          measured with OpenCL event profiling
+     * 
+     */
+    std::vector<profiling::DeviceTiming> deviceTimings;
+
+    /**
+     * @brief The timings of every used device, if multiple devices per rank are used.
+     *          The timings map contains the aggregated timings of all devices in this case.
+     *          Empty, if a single device is used.
+     * 
+     */
+    std::vector<std::map<std::string,std::vector<double>>> perDeviceTimings;
 };
 
 /**
@@ -162,6 +273,49 @@ protected:
     void
     addAdditionalParseOptions(cxxopts::Options &options) override;
 
+    /**
+     * @brief Detect the data type of the arrays from the kernel arguments, if it is not given by the user.
+     *          If the bitstream does not contain the argument types, the data type of the build is used.
+     * 
+     */
+    void
+    adaptSettingsToBitstream() override;
+
+private:
+
+    /**
+     * @brief Generate the input data for a specific data type
+     * 
+     * @tparam T The data type of the arrays
+     * @return std::unique_ptr<StreamData> The generated data
+     */
+    template<typename T>
+    std::unique_ptr<StreamData>
+    generateTypedInputData();
+
+    /**
+     * @brief Execute the kernels for a specific data type
+     * 
+     * @tparam T The data type of the arrays
+     * @param data The arrays used in the execution
+     * @return std::unique_ptr<StreamExecutionTimings> The measured timings
+     */
+    template<typename T>
+    std::unique_ptr<StreamExecutionTimings>
+    executeTypedKernel(TypedStreamData<T> &data);
+
+    /**
+     * @brief Validate the arrays of a specific data type. The machine epsilon of the data type is used as error bound.
+     * 
+     * @tparam T The data type of the arrays
+     * @param data The arrays after the execution
+     * @return true If the validation is a success
+     * @return false otherwise
+     */
+    template<typename T>
+    bool
+    validateTypedOutputAndPrintError(TypedStreamData<T> &data);
+
 public:
 
     /**
@@ -172,6 +326,14 @@ public:
     std::unique_ptr<StreamData>
     generateInputData() override;
 
+    /**
+     * @brief Estimate the memory of the three arrays on the host and on the device
+     * 
+     * @return std::vector<memory_tracker::MemoryRequirement> The estimated allocations of this rank
+     */
+    std::vector<memory_tracker::MemoryRequirement>
+    estimateMemoryUsage() override;
+
     /**
      * @brief Stream specific implementation of the kernel execution
      * 
@@ -199,6 +361,23 @@ public:
     void
     collectAndPrintResults(const StreamExecutionTimings &output) override;
 
+    /**
+     * @brief Check that the fused mode and the access patterns are only combined with the single kernel on the device
+     *
+     * @return true if the settings are valid
+     * @return false otherwise
+     */
+    bool
+    checkInputParameters() override;
+
+    /**
+     * @brief The arrays are split between all devices of a rank
+     * 
+     * @return true 
+     */
+    bool
+    supportsMultipleDevices() override { return true;}
+
     /**
      * @brief Construct a new Stream Benchmark object
      * 
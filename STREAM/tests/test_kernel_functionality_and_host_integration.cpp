@@ -5,6 +5,7 @@
 #include "parameters.h"
 #include "test_program_settings.h"
 #include "stream_benchmark.hpp"
+#include "execution.hpp"
 
 
 struct StreamKernelTest :public  ::testing::Test {
@@ -20,6 +21,14 @@ struct StreamKernelTest :public  ::testing::Test {
         data = bm->generateInputData();
    }
 
+    /**
+     * The arrays with the data type of the kernels
+     */
+    stream::TypedStreamData<HOST_DATA_TYPE>&
+    arrays() {
+        return data->as<HOST_DATA_TYPE>();
+    }
+
 
 };
 
@@ -31,9 +40,9 @@ TEST_F(StreamKernelTest, FPGACorrectResultsOneRepetition) {
     bm->getExecutionSettings().programSettings->numRepetitions = 1;
     auto result = bm->executeKernel(*data);
     for (int i = 0; i < bm->getExecutionSettings().programSettings->streamArraySize; i++) {
-        EXPECT_FLOAT_EQ(data->A[i], 30.0);
-        EXPECT_FLOAT_EQ(data->B[i], 6.0);
-        EXPECT_FLOAT_EQ(data->C[i], 8.0);
+        EXPECT_FLOAT_EQ(arrays().A[i], 30.0);
+        EXPECT_FLOAT_EQ(arrays().B[i], 6.0);
+        EXPECT_FLOAT_EQ(arrays().C[i], 8.0);
     }
 }
 
@@ -44,8 +53,143 @@ TEST_F(StreamKernelTest, FPGACorrectResultsThreeRepetition) {
     bm->getExecutionSettings().programSettings->numRepetitions = 3;
     auto result = bm->executeKernel(*data);
     for (int i = 0; i < bm->getExecutionSettings().programSettings->streamArraySize; i++) {
-        EXPECT_FLOAT_EQ(data->A[i], 6750.0);
-        EXPECT_FLOAT_EQ(data->B[i], 1350.0);
-        EXPECT_FLOAT_EQ(data->C[i], 1800.0);
+        EXPECT_FLOAT_EQ(arrays().A[i], 6750.0);
+        EXPECT_FLOAT_EQ(arrays().B[i], 1350.0);
+        EXPECT_FLOAT_EQ(arrays().C[i], 1800.0);
+    }
+}
+
+/**
+ * Execution returns correct results for a single repetition in streaming mode
+ */
+TEST_F(StreamKernelTest, FPGACorrectResultsStreamingMode) {
+    bm->getExecutionSettings().programSettings->streamArraySize *= 4;
+    bm->getExecutionSettings().programSettings->streamingChunks = 4;
+    bm->getExecutionSettings().programSettings->numRepetitions = 1;
+    data = bm->generateInputData();
+    auto result = bm->executeKernel(*data);
+    for (int i = 0; i < bm->getExecutionSettings().programSettings->streamArraySize; i++) {
+        EXPECT_FLOAT_EQ(arrays().A[i], 30.0);
+        EXPECT_FLOAT_EQ(arrays().B[i], 6.0);
+        EXPECT_FLOAT_EQ(arrays().C[i], 8.0);
+    }
+}
+
+#ifdef USE_FUSED_KERNEL
+/**
+ * Execution returns correct results for three repetitions in fused mode, if the last launch executes less repetitions
+ */
+TEST_F(StreamKernelTest, FPGACorrectResultsFusedMode) {
+    bm->getExecutionSettings().programSettings->fusedRepetitions = 2;
+    bm->getExecutionSettings().programSettings->numRepetitions = 3;
+    auto result = bm->executeKernel(*data);
+    EXPECT_EQ(result->timings[FUSED_KEY].size(), 3);
+    for (int i = 0; i < bm->getExecutionSettings().programSettings->streamArraySize; i++) {
+        EXPECT_FLOAT_EQ(arrays().A[i], 6750.0);
+        EXPECT_FLOAT_EQ(arrays().B[i], 1350.0);
+        EXPECT_FLOAT_EQ(arrays().C[i], 1800.0);
     }
 }
+#endif
+
+#ifdef USE_ACCESS_PATTERN_KERNEL
+/**
+ * The access patterns are measured next to the four operations and do not modify the arrays
+ */
+TEST_F(StreamKernelTest, FPGAAccessPatternsAreMeasured) {
+    bm->getExecutionSettings().programSettings->useAccessPatterns = true;
+    bm->getExecutionSettings().programSettings->patternStride = 4;
+    bm->getExecutionSettings().programSettings->patternBlockSize = 16;
+    bm->getExecutionSettings().programSettings->numRepetitions = 1;
+    auto result = bm->executeKernel(*data);
+    ASSERT_TRUE(result);
+    for (const auto &key : {STRIDED_KEY, BLOCKED_KEY, GATHER_KEY, SCATTER_KEY}) {
+        EXPECT_EQ(result->timings[key].size(), 1);
+    }
+    for (int i = 0; i < bm->getExecutionSettings().programSettings->streamArraySize; i++) {
+        EXPECT_FLOAT_EQ(arrays().A[i], 30.0);
+        EXPECT_FLOAT_EQ(arrays().B[i], 6.0);
+        EXPECT_FLOAT_EQ(arrays().C[i], 8.0);
+    }
+}
+#endif
+
+/**
+ * Execution returns correct results if the arrays are shared between two devices.
+ * The same device is used twice to emulate a second device.
+ */
+TEST_F(StreamKernelTest, FPGACorrectResultsMultipleDevices) {
+    auto &settings = bm->getExecutionSettings();
+    settings.addDevice(settings.devices[0], settings.contexts[0], settings.programs[0]);
+    settings.programSettings->streamArraySize *= 2;
+    settings.programSettings->numRepetitions = 1;
+    data = bm->generateInputData();
+    auto result = bm->executeKernel(*data);
+    EXPECT_EQ(result->arraySize, settings.programSettings->streamArraySize);
+    EXPECT_EQ(result->perDeviceTimings.size(), 2);
+    for (int i = 0; i < settings.programSettings->streamArraySize; i++) {
+        EXPECT_FLOAT_EQ(arrays().A[i], 30.0);
+        EXPECT_FLOAT_EQ(arrays().B[i], 6.0);
+        EXPECT_FLOAT_EQ(arrays().C[i], 8.0);
+    }
+}
+
+/**
+ * Execution with the CPU backend returns the same results as the FPGA for three repetitions
+ */
+TEST_F(StreamKernelTest, CPUCorrectResultsThreeRepetition) {
+    bm->getExecutionSettings().programSettings->communicationType = hpcc_base::CommunicationType::cpu_only;
+    bm->getExecutionSettings().programSettings->numRepetitions = 3;
+    auto result = bm->executeKernel(*data);
+    EXPECT_EQ(result->timings["Triad"].size(), 3);
+    for (int i = 0; i < bm->getExecutionSettings().programSettings->streamArraySize; i++) {
+        EXPECT_FLOAT_EQ(arrays().A[i], 6750.0);
+        EXPECT_FLOAT_EQ(arrays().B[i], 1350.0);
+        EXPECT_FLOAT_EQ(arrays().C[i], 1800.0);
+    }
+}
+
+/**
+ * The data type of the arrays is detected from the bitstream and matches the data type of the build
+ */
+TEST_F(StreamKernelTest, DataTypeIsDetectedFromBitstream) {
+    auto data_type = bm->getExecutionSettings().programSettings->dataType;
+    EXPECT_NE(data_type, hpcc_base::DataType::automatic);
+    EXPECT_EQ(hpcc_base::dataTypeSize(data_type), sizeof(HOST_DATA_TYPE));
+    EXPECT_EQ(data->dataType, data_type);
+}
+
+/**
+ * The CPU backend can be executed with all data types from the same build and validates the results
+ */
+TEST_F(StreamKernelTest, CPUCorrectResultsForAllDataTypes) {
+    bm->getExecutionSettings().programSettings->communicationType = hpcc_base::CommunicationType::cpu_only;
+    bm->getExecutionSettings().programSettings->numRepetitions = 1;
+    for (auto data_type : {hpcc_base::DataType::half_precision, hpcc_base::DataType::single_precision, hpcc_base::DataType::double_precision}) {
+        bm->getExecutionSettings().programSettings->dataType = data_type;
+        data = bm->generateInputData();
+        EXPECT_EQ(data->dataType, data_type);
+        auto result = bm->executeKernel(*data);
+        ASSERT_NE(result, nullptr);
+        EXPECT_TRUE(bm->validateOutputAndPrintError(*data));
+    }
+    auto &doubles = data->as<cl_double>();
+    for (int i = 0; i < bm->getExecutionSettings().programSettings->streamArraySize; i++) {
+        EXPECT_DOUBLE_EQ(doubles.A[i], 30.0);
+        EXPECT_DOUBLE_EQ(doubles.B[i], 6.0);
+        EXPECT_DOUBLE_EQ(doubles.C[i], 8.0);
+    }
+    EXPECT_THROW(data->as<cl_float>(), std::runtime_error);
+}
+
+/**
+ * The soak mode restores the input data before every iteration, so the output of the last iteration is valid
+ */
+TEST_F(StreamKernelTest, CPUSoakWithMultipleIterationsIsValidated) {
+    bm->getExecutionSettings().programSettings->communicationType = hpcc_base::CommunicationType::cpu_only;
+    bm->getExecutionSettings().programSettings->numRepetitions = 1;
+    bm->getExecutionSettings().programSettings->soakDuration = 1;
+    EXPECT_TRUE(bm->executeBenchmark());
+    EXPECT_GE(bm->getResults().at("soak_iterations").value, 2.0);
+    bm->getExecutionSettings().programSettings->soakDuration = 0;
+}
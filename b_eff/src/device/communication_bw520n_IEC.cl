@@ -26,6 +26,10 @@ SOFTWARE.
  * - they use different channels for sending and receiving data
  * - "send" sends first a message and then receives,  "recv" does it the other way around
  *
+ * In the ping-pong mode, the "send" kernel of the initiating rank sends a message and waits until the answer was
+ * forwarded by the "recv" kernel. The other rank forwards the received messages back to the initiator.
+ * The initiator counts the clock cycles of every round trip with a loop of non-blocking channel operations.
+ *
  * The kernels are hardcoded to work with the Bittware 520N board that offers
  * 4 external channels.
  * The file might need to be adapted for the use with other boards!
@@ -65,11 +69,17 @@ channel message_part ch_exchange/*PY_CODE_GEN 2*r+2*/;
  *
  * @param data_size Size of the used message
  * @param repetitions Number of times the message will be sent and received
+ * @param ping_pong If not 0, a message is only sent after the previous message was answered
+ * @param initiator If not 0, the kernel sends the first message in the ping-pong mode. Otherwise it answers the received messages.
+ * @param latency_cycles Number of clock cycles of every round trip in the ping-pong mode, if the kernel is the initiator
  */
 __kernel
 __attribute__ ((max_global_work_dim(0)))
 void send/*PY_CODE_GEN  r*/(const unsigned data_size,
-        const unsigned repetitions) {
+        const unsigned repetitions,
+        const unsigned ping_pong,
+        const unsigned initiator,
+        __global ulong* restrict latency_cycles) {
     const unsigned send_iterations = ((1 << data_size) +  2 * ITEMS_PER_CHANNEL - 1) / (2 * ITEMS_PER_CHANNEL);
     message_part send_part1;
     message_part send_part2;
@@ -81,6 +91,56 @@ void send/*PY_CODE_GEN  r*/(const unsigned data_size,
         send_part2.values[d] = data_size & 255;
     }
 
+    if (ping_pong) {
+        for (unsigned i=0; i < repetitions; i++) {
+            if (!initiator) {
+                // Wait for the message of the initiator before it is sent back
+                send_part1 = read_channel_intel(ch_exchange/*PY_CODE_GEN 2*r+1*/);
+                send_part2 = read_channel_intel(ch_exchange/*PY_CODE_GEN 2*r+2*/);
+            }
+            message_part answer_part1 = send_part1;
+            message_part answer_part2 = send_part2;
+            unsigned sent1 = 0;
+            unsigned sent2 = 0;
+            bool received1 = !initiator;
+            bool received2 = !initiator;
+            ulong cycles = 0;
+            // All channel operations are non-blocking, so every loop iteration takes a single clock cycle
+            // and the number of iterations is the duration of the round trip
+            while (sent1 < send_iterations || sent2 < send_iterations || !received1 || !received2) {
+                if (sent1 < send_iterations && write_channel_nb_intel(ch_out_/*PY_CODE_GEN  2*r+1*/, send_part1)) {
+                    sent1++;
+                }
+                if (sent2 < send_iterations && write_channel_nb_intel(ch_out_/*PY_CODE_GEN  2*r+2*/, send_part2)) {
+                    sent2++;
+                }
+                if (!received1) {
+                    bool valid;
+                    message_part part = read_channel_nb_intel(ch_exchange/*PY_CODE_GEN 2*r+1*/, &valid);
+                    if (valid) {
+                        answer_part1 = part;
+                        received1 = true;
+                    }
+                }
+                if (!received2) {
+                    bool valid;
+                    message_part part = read_channel_nb_intel(ch_exchange/*PY_CODE_GEN 2*r+2*/, &valid);
+                    if (valid) {
+                        answer_part2 = part;
+                        received2 = true;
+                    }
+                }
+                cycles++;
+            }
+            send_part1 = answer_part1;
+            send_part2 = answer_part2;
+            if (initiator) {
+                latency_cycles[i] = cycles;
+            }
+        }
+        return;
+    }
+
     // Sent a message multiple times over the external channels
     for (unsigned i=0; i < repetitions; i++) {
         // Send a single message sent over two channels split into multiple chunks
@@ -103,12 +163,14 @@ void send/*PY_CODE_GEN  r*/(const unsigned data_size,
  *
  * @param data_size Size of the used message
  * @param repetitions Number of times the message will be sent and received
+ * @param ping_pong If not 0, every received message is forwarded to the send kernel, also in the emulation
  */
 __kernel
 __attribute__ ((max_global_work_dim(0)))
 void recv/*PY_CODE_GEN  r*/(__global DEVICE_DATA_TYPE* validation_buffer,
             const unsigned data_size,
-            const unsigned repetitions) {
+            const unsigned repetitions,
+            const unsigned ping_pong) {
     const unsigned send_iterations = ((1 << data_size) +  2 * ITEMS_PER_CHANNEL - 1) / (2 * ITEMS_PER_CHANNEL);
     message_part recv_part1;
     message_part recv_part2;
@@ -120,12 +182,15 @@ void recv/*PY_CODE_GEN  r*/(__global DEVICE_DATA_TYPE* validation_buffer,
             recv_part1 = read_channel_intel(ch_in_/*PY_CODE_GEN  2*r+1*/);
             recv_part2 = read_channel_intel(ch_in_/*PY_CODE_GEN  2*r+2*/);
         }
-#ifndef EMULATE
         // Introduce data dependency between loop iterations to prevent coalescing of loop
         // by sending the data to the send kernel
-        write_channel_intel(ch_exchange/*PY_CODE_GEN 2*r+1*/, recv_part1);
-        write_channel_intel(ch_exchange/*PY_CODE_GEN 2*r+2*/, recv_part2);
+#ifdef EMULATE
+        if (ping_pong)
 #endif
+        {
+            write_channel_intel(ch_exchange/*PY_CODE_GEN 2*r+1*/, recv_part1);
+            write_channel_intel(ch_exchange/*PY_CODE_GEN 2*r+2*/, recv_part2);
+        }
     }
 
     // Store the last received data chunks in global memory for later validation
@@ -22,4 +22,5 @@ SOFTWARE.
 
 #include "execution_types/execution_cpu.hpp"
 #include "execution_types/execution_pcie.hpp"
+#include "execution_types/execution_rdma.hpp"
 #include "execution_types/execution_iec.hpp"
\ No newline at end of file
@@ -34,6 +34,40 @@ SOFTWARE.
 
 namespace network::execution_types::cpu {
 
+    /**
+     * @brief Exchange ping-pong messages with the partner rank over MPI and measure the one-way latency on the host.
+     *          The initiator measures the round trip time of every message and stores half of it as latency.
+     * 
+     * @param buffer The host buffer that is used to send and receive the messages
+     * @param size_in_bytes Size of a message
+     * @param looplength Number of round trips
+     * @param rank Rank of the current process
+     * @param partner Rank of the ping-pong partner
+     * @param latencies The measured one-way latencies are appended to this vector by the initiator
+     * @param communicator Communicator of the ranks that execute the benchmark
+     */
+    void
+    pingPong(cl::vector<HOST_DATA_TYPE> &buffer, cl_uint size_in_bytes, cl_uint looplength, int rank, int partner, std::vector<double> &latencies, MPI_Comm communicator) {
+        bool initiator = network::isPingPongInitiator(rank, partner);
+        for (int l = 0; l < looplength; l++) {
+            if (partner == rank) {
+                auto start = std::chrono::high_resolution_clock::now();
+                MPI_Sendrecv(buffer.data(), size_in_bytes, MPI_CHAR, rank, 1, buffer.data(), size_in_bytes, MPI_CHAR, rank, 1, communicator, MPI_STATUS_IGNORE);
+                latencies.push_back(std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count() / 2.0);
+            }
+            else if (initiator) {
+                auto start = std::chrono::high_resolution_clock::now();
+                MPI_Send(buffer.data(), size_in_bytes, MPI_CHAR, partner, 1, communicator);
+                MPI_Recv(buffer.data(), size_in_bytes, MPI_CHAR, partner, 1, communicator, MPI_STATUS_IGNORE);
+                latencies.push_back(std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count() / 2.0);
+            }
+            else {
+                MPI_Recv(buffer.data(), size_in_bytes, MPI_CHAR, partner, 1, communicator, MPI_STATUS_IGNORE);
+                MPI_Send(buffer.data(), size_in_bytes, MPI_CHAR, partner, 1, communicator);
+            }
+        }
+    }
+
     /*
     Implementation for the single kernel.
      @copydoc bm_execution::calculate()
@@ -50,12 +84,16 @@ namespace network::execution_types::cpu {
         cl_uint size_in_bytes = std::max(static_cast<int>(validationData.size()), (1 << messageSize));
 
         int current_rank;
-        MPI_Comm_rank(MPI_COMM_WORLD, & current_rank);
+        MPI_Comm_rank(config.communicator, & current_rank);
 
         int current_size;
-        MPI_Comm_size(MPI_COMM_WORLD, & current_size);
+        MPI_Comm_size(config.communicator, & current_size);
+
+        network::CommunicationPattern pattern = config.programSettings->pattern;
+        cl_uint buffer_size = network::getMessageBufferSize(pattern, size_in_bytes, current_size);
 
         std::vector<double> calculationTimings;
+        std::vector<double> latencies;
         for (uint r =0; r < config.programSettings->numRepetitions; r++) {
             sendQueues.clear();
             dummyBuffers.clear();
@@ -63,39 +101,49 @@ namespace network::execution_types::cpu {
             // Create all kernels and buffers. The kernel pairs are generated twice to utilize all channels
             for (int r = 0; r < config.programSettings->kernelReplications; r++) {
 
-                dummyBuffers.push_back(cl::Buffer(*config.context, CL_MEM_READ_WRITE, sizeof(HOST_DATA_TYPE) * size_in_bytes,0,&err));
+                dummyBuffers.push_back(cl::Buffer(*config.context, CL_MEM_READ_WRITE, sizeof(HOST_DATA_TYPE) * buffer_size,0,&err));
                 ASSERT_CL(err)
 
-                dummyBufferContents.emplace_back(size_in_bytes, static_cast<HOST_DATA_TYPE>(messageSize & (255)));
+                dummyBufferContents.emplace_back(buffer_size, static_cast<HOST_DATA_TYPE>(messageSize & (255)));
 
                 cl::CommandQueue sendQueue(*config.context, *config.device, 0, &err);
                 ASSERT_CL(err)
 
-                sendQueue.enqueueWriteBuffer(dummyBuffers.back(), CL_TRUE, 0, sizeof(HOST_DATA_TYPE) * size_in_bytes, dummyBufferContents.back().data());
+                sendQueue.enqueueWriteBuffer(dummyBuffers.back(), CL_TRUE, 0, sizeof(HOST_DATA_TYPE) * buffer_size, dummyBufferContents.back().data());
 
                 sendQueues.push_back(sendQueue);
 
             }
             double calculationTime = 0.0;
             for (int i = 0; i < config.programSettings->kernelReplications; i++) {
-                MPI_Barrier(MPI_COMM_WORLD);
+                MPI_Barrier(config.communicator);
+                bool collective = network::isCollectivePattern(pattern);
+                int partner = collective ? current_rank : network::getCommunicationPartner(current_rank, current_size, i, pattern);
                 auto startCalculation = std::chrono::high_resolution_clock::now();
-                for (int l = 0; l < looplength; l++) {
-                        MPI_Sendrecv(dummyBufferContents[i].data(), size_in_bytes, MPI_CHAR, (current_rank - 1 + 2 * ((current_rank + i) % 2) + current_size) % current_size, 0, 
-                                        dummyBufferContents[i].data(), size_in_bytes, MPI_CHAR, (current_rank - 1 + 2 * ((current_rank + i) % 2)  + current_size) % current_size, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+                if (config.programSettings->latencyMode) {
+                    pingPong(dummyBufferContents[i], size_in_bytes, looplength, current_rank, partner, latencies, config.communicator);
+                }
+                else if (collective) {
+                    for (int l = 0; l < looplength; l++) {
+                        network::exchangeCollective(pattern, dummyBufferContents[i].data(), size_in_bytes, config.communicator);
+                    }
+                }
+                else for (int l = 0; l < looplength; l++) {
+                        MPI_Sendrecv(dummyBufferContents[i].data(), size_in_bytes, MPI_CHAR, partner, 0, 
+                                        dummyBufferContents[i].data(), size_in_bytes, MPI_CHAR, partner, 0, config.communicator, MPI_STATUS_IGNORE);
                 }
                 auto endCalculation = std::chrono::high_resolution_clock::now();
                 calculationTime += std::chrono::duration_cast<std::chrono::duration<double>>(endCalculation - startCalculation).count();
                 #ifndef NDEBUG
                         int current_rank;
-                        MPI_Comm_rank(MPI_COMM_WORLD, & current_rank);
+                        MPI_Comm_rank(config.communicator, & current_rank);
                         std::cout << "Rank " << current_rank << ": Enqueued " << r << "," << i << std::endl;
                 #endif
             }
             calculationTimings.push_back(calculationTime);
 #ifndef NDEBUG
         int current_rank;
-        MPI_Comm_rank(MPI_COMM_WORLD, & current_rank);
+        MPI_Comm_rank(config.communicator, & current_rank);
         std::cout << "Rank " << current_rank << ": Done " << r << std::endl;
 #endif
         }
@@ -110,6 +158,7 @@ namespace network::execution_types::cpu {
                 messageSize,
                 calculationTimings
         });
+        result->latencies = latencies;
         return result;
     }
 
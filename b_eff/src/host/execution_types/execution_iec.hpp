@@ -26,6 +26,8 @@ SOFTWARE.
 #include <memory>
 #include <vector>
 #include <chrono>
+#include <algorithm>
+#include <stdexcept>
 
 /* External library headers */
 #include "CL/cl_ext_intelfpga.h"
@@ -35,6 +37,41 @@ SOFTWARE.
 
 namespace network::execution_types::iec {
 
+    /**
+     * @brief Read the clock cycles of all round trips of the ping-pong from the device and convert them to one-way latencies.
+     *          The clock frequency of the kernel is derived from the profiled execution time of the send kernel, which
+     *          counts the cycles during nearly its whole execution. This avoids the limited resolution of the host timer
+     *          for single messages.
+     * 
+     * @param sendQueues The queues of the send kernels with profiling enabled
+     * @param sendEvents The events of the send kernel executions
+     * @param latencyBuffers The buffers of all replications that contain the cycles of every round trip
+     * @param initiators Contains true for the replications that initiated the ping-pong
+     * @param looplength Number of round trips
+     * @param latencies The one-way latencies in seconds are appended to this vector
+     */
+    void
+    readLatencies(std::vector<cl::CommandQueue> &sendQueues, std::vector<cl::Event> &sendEvents, std::vector<cl::Buffer> &latencyBuffers,
+                    const std::vector<bool> &initiators, cl_uint looplength, std::vector<double> &latencies) {
+        for (int i = 0; i < sendQueues.size(); i++) {
+            if (!initiators[i] || looplength == 0) {
+                continue;
+            }
+            std::vector<cl_ulong> cycles(looplength);
+            ASSERT_CL(sendQueues[i].enqueueReadBuffer(latencyBuffers[i], CL_TRUE, 0, sizeof(cl_ulong) * looplength, cycles.data()))
+            cl_ulong start = sendEvents[i].getProfilingInfo<CL_PROFILING_COMMAND_START>();
+            cl_ulong end = sendEvents[i].getProfilingInfo<CL_PROFILING_COMMAND_END>();
+            cl_ulong total_cycles = 0;
+            for (auto c : cycles) {
+                total_cycles += c;
+            }
+            double seconds_per_cycle = (total_cycles > 0) ? static_cast<double>(end - start) * 1.0e-9 / total_cycles : 0.0;
+            for (auto c : cycles) {
+                latencies.push_back(c * seconds_per_cycle / 2.0);
+            }
+        }
+    }
+
     /*
     Implementation for the single kernel.
      @copydoc bm_execution::calculate()
@@ -49,10 +86,32 @@ namespace network::execution_types::iec {
         std::vector<cl::CommandQueue> sendQueues;
         std::vector<cl::CommandQueue> recvQueues;
         std::vector<cl::Buffer> validationBuffers;
+        std::vector<cl::Buffer> latencyBuffers;
+        std::vector<bool> initiators;
+
+        bool ping_pong = config.programSettings->latencyMode;
+#ifdef HOST_EMULATION_REORDER
+        if (ping_pong) {
+            throw std::runtime_error("The latency mode can not be used with HOST_EMULATION_REORDER, because the ping-pong requires concurrent kernels!");
+        }
+#endif
+        if (config.programSettings->pattern != network::CommunicationPattern::ring) {
+            throw std::runtime_error("The external channels only support the communication pattern " + network::patternToString(network::CommunicationPattern::ring) + "!");
+        }
+        int current_rank;
+        MPI_Comm_rank(config.communicator, & current_rank);
+        int current_size;
+        MPI_Comm_size(config.communicator, & current_size);
 
         // Create all kernels and buffers. The kernel pairs are generated twice to utilize all channels
         for (int r = 0; r < config.programSettings->kernelReplications; r++) {
 
+            // The same pairing as for the host-based communication types is expected for the external channels
+            bool initiator = network::isPingPongInitiator(current_rank, network::getCommunicationPartner(current_rank, current_size, r));
+            initiators.push_back(initiator);
+            latencyBuffers.push_back(cl::Buffer(*config.context, CL_MEM_WRITE_ONLY, sizeof(cl_ulong) * std::max(looplength, 1u),0,&err));
+            ASSERT_CL(err)
+
             validationBuffers.push_back(cl::Buffer(*config.context, CL_MEM_WRITE_ONLY, sizeof(HOST_DATA_TYPE) * validationData.size(),0,&err));
             ASSERT_CL(err)
 
@@ -63,6 +122,12 @@ namespace network::execution_types::iec {
             ASSERT_CL(err)
             err = sendKernel.setArg(1, looplength);
             ASSERT_CL(err)
+            err = sendKernel.setArg(2, static_cast<cl_uint>(ping_pong));
+            ASSERT_CL(err)
+            err = sendKernel.setArg(3, static_cast<cl_uint>(initiator));
+            ASSERT_CL(err)
+            err = sendKernel.setArg(4, latencyBuffers[r]);
+            ASSERT_CL(err)
 
             cl::Kernel recvKernel(*config.program, (RECV_KERNEL_NAME + std::to_string(r)).c_str(), &err);
             ASSERT_CL(err)
@@ -72,8 +137,11 @@ namespace network::execution_types::iec {
             ASSERT_CL(err)
             err = recvKernel.setArg(2, looplength);
             ASSERT_CL(err)
+            err = recvKernel.setArg(3, static_cast<cl_uint>(ping_pong));
+            ASSERT_CL(err)
 
-            cl::CommandQueue sendQueue(*config.context, *config.device, 0, &err);
+            // The send kernel execution time is used to convert the measured clock cycles of the ping-pong to seconds
+            cl::CommandQueue sendQueue(*config.context, *config.device, ping_pong ? CL_QUEUE_PROFILING_ENABLE : 0, &err);
             ASSERT_CL(err)
             cl::CommandQueue recvQueue(*config.context, *config.device, 0, &err);
             ASSERT_CL(err)
@@ -86,8 +154,9 @@ namespace network::execution_types::iec {
         }
 
         std::vector<double> calculationTimings;
+        std::vector<double> latencies;
         for (uint r =0; r < config.programSettings->numRepetitions; r++) {
-            MPI_Barrier(MPI_COMM_WORLD);
+            MPI_Barrier(config.communicator);
             auto startCalculation = std::chrono::high_resolution_clock::now();
 #ifdef HOST_EMULATION_REORDER
             std::cout << "Reordering kernel execution for Intel emulation!" << std::endl;
@@ -95,7 +164,7 @@ namespace network::execution_types::iec {
                 sendQueues[i].enqueueNDRangeKernel(sendKernels[i], cl::NullRange, cl::NDRange(1));
                 #ifndef NDEBUG
                         int current_rank;
-                        MPI_Comm_rank(MPI_COMM_WORLD, & current_rank);
+                        MPI_Comm_rank(config.communicator, & current_rank);
                         std::cout << "Rank " << current_rank << ": Send Enqueued " << r << "," << i << std::endl;
                 #endif
             }
@@ -103,7 +172,7 @@ namespace network::execution_types::iec {
                 sendQueues[i].finish();
                 #ifndef NDEBUG
                         int current_rank;
-                        MPI_Comm_rank(MPI_COMM_WORLD, & current_rank);
+                        MPI_Comm_rank(config.communicator, & current_rank);
                         std::cout << "Rank " << current_rank << ": Send done " << r << "," << i << std::endl;
                 #endif
             } 
@@ -111,7 +180,7 @@ namespace network::execution_types::iec {
                 recvQueues[i].enqueueNDRangeKernel(recvKernels[i], cl::NullRange, cl::NDRange(1));
                 #ifndef NDEBUG
                         int current_rank;
-                        MPI_Comm_rank(MPI_COMM_WORLD, & current_rank);
+                        MPI_Comm_rank(config.communicator, & current_rank);
                         std::cout << "Rank " << current_rank << ": Recv Enqueued " << r << "," << i << std::endl;
                 #endif
             }
@@ -119,17 +188,18 @@ namespace network::execution_types::iec {
                 recvQueues[i].finish();
                 #ifndef NDEBUG
                         int current_rank;
-                        MPI_Comm_rank(MPI_COMM_WORLD, & current_rank);
+                        MPI_Comm_rank(config.communicator, & current_rank);
                         std::cout << "Rank " << current_rank << ": Recv done " << r << "," << i << std::endl;
                 #endif
             }      
 #else
+            std::vector<cl::Event> sendEvents(config.programSettings->kernelReplications);
             for (int i = 0; i < config.programSettings->kernelReplications; i++) {
-                sendQueues[i].enqueueNDRangeKernel(sendKernels[i], cl::NullRange, cl::NDRange(1));
+                sendQueues[i].enqueueNDRangeKernel(sendKernels[i], cl::NullRange, cl::NDRange(1), cl::NullRange, nullptr, &sendEvents[i]);
                 recvQueues[i].enqueueNDRangeKernel(recvKernels[i], cl::NullRange, cl::NDRange(1));
                 #ifndef NDEBUG
                         int current_rank;
-                        MPI_Comm_rank(MPI_COMM_WORLD, & current_rank);
+                        MPI_Comm_rank(config.communicator, & current_rank);
                         std::cout << "Rank " << current_rank << ": Enqueued " << r << "," << i << std::endl;
                 #endif
             }
@@ -137,12 +207,12 @@ namespace network::execution_types::iec {
                 sendQueues[i].finish();
                 #ifndef NDEBUG
                         int current_rank;
-                        MPI_Comm_rank(MPI_COMM_WORLD, & current_rank);
+                        MPI_Comm_rank(config.communicator, & current_rank);
                         std::cout << "Rank " << current_rank << ": Send done " << r << "," << i << std::endl;
                 #endif
                 recvQueues[i].finish();
                 #ifndef NDEBUG
-                        MPI_Comm_rank(MPI_COMM_WORLD, & current_rank);
+                        MPI_Comm_rank(config.communicator, & current_rank);
                         std::cout << "Rank " << current_rank << ": Recv done " << r << "," << i << std::endl;
                 #endif
             }
@@ -152,9 +222,14 @@ namespace network::execution_types::iec {
                     std::chrono::duration_cast<std::chrono::duration<double>>
                             (endCalculation - startCalculation);
             calculationTimings.push_back(calculationTime.count());
+#ifndef HOST_EMULATION_REORDER
+            if (ping_pong) {
+                readLatencies(sendQueues, sendEvents, latencyBuffers, initiators, looplength, latencies);
+            }
+#endif
 #ifndef NDEBUG
         int current_rank;
-        MPI_Comm_rank(MPI_COMM_WORLD, & current_rank);
+        MPI_Comm_rank(config.communicator, & current_rank);
         std::cout << "Rank " << current_rank << ": Done " << r << std::endl;
 #endif
         }
@@ -169,6 +244,7 @@ namespace network::execution_types::iec {
                 messageSize,
                 calculationTimings
         });
+        result->latencies = latencies;
         return result;
     }
 
@@ -26,66 +26,339 @@ SOFTWARE.
 #include <memory>
 #include <vector>
 #include <chrono>
+#include <algorithm>
 
 /* External library headers */
 #include "mpi.h"
 
 /* Project's headers */
+#include "rdma_buffer.hpp"
 
 namespace network::execution_types::pcie {
 
+    /**
+     * @brief Contains the command queues, device buffers and host buffers used by the PCIe execution for every
+     *          kernel replication. The resources are allocated once and reused for all repetitions and message sizes,
+     *          so allocations do not influence the measurement of small messages.
+     * 
+     */
+    class PcieResourcePool {
+
+    public:
+
+        /**
+         * @brief Command queue for every kernel replication
+         * 
+         */
+        std::vector<cl::CommandQueue> sendQueues;
+
+        /**
+         * @brief Device buffer for every kernel replication
+         * 
+         */
+        std::vector<cl::Buffer> dummyBuffers;
+
+        /**
+         * @brief Host buffer for every kernel replication that is used to send and receive the messages
+         * 
+         */
+        std::vector<cl::vector<HOST_DATA_TYPE>> dummyBufferContents;
+
+        /**
+         * @brief Second device buffer for every kernel replication that is used to receive messages in the zero-copy mode.
+         *          The device buffers are allocated with CL_MEM_ALLOC_HOST_PTR in this mode, so they can be mapped without copies.
+         * 
+         */
+        std::vector<cl::Buffer> receiveBuffers;
+
+        /**
+         * @brief Second host buffer for every kernel replication that is used to receive messages in the concurrent mode.
+         *          Sent and received messages need separate buffers, because the transfers are non-blocking.
+         * 
+         */
+        std::vector<cl::vector<HOST_DATA_TYPE>> receiveBufferContents;
+
+        /**
+         * @brief Mapped P2P buffers for every kernel replication that are used to send and receive the messages
+         *          with the RDMA communication type. The queues are still allocated, the other buffers stay empty.
+         * 
+         */
+        std::vector<std::unique_ptr<::rdma::P2PBuffer>> p2pBuffers;
+
+        /**
+         * @brief Second mapped P2P buffer for every kernel replication that is used to receive messages with the RDMA communication type
+         * 
+         */
+        std::vector<std::unique_ptr<::rdma::P2PBuffer>> p2pReceiveBuffers;
+
+        /**
+         * @brief Make sure, the pool contains resources for all kernel replications that can hold at least the given
+         *          number of values. Resources are only allocated, if the existing ones are too small.
+         * 
+         * @param config The execution settings
+         * @param size_in_bytes Required number of values in the buffers
+         */
+        void
+        reserve(hpcc_base::ExecutionSettings<network::NetworkProgramSettings> const& config, cl_uint size_in_bytes) {
+            int err;
+            for (int r = 0; r < config.programSettings->kernelReplications; r++) {
+                if (r >= sendQueues.size()) {
+                    cl::CommandQueue sendQueue(*config.context, *config.device, 0, &err);
+                    ASSERT_CL(err)
+                    sendQueues.push_back(sendQueue);
+                    dummyBuffers.emplace_back();
+                    dummyBufferContents.emplace_back();
+                }
+                if (config.programSettings->communicationType == hpcc_base::CommunicationType::rdma) {
+                    if (r >= p2pBuffers.size()) {
+                        p2pBuffers.emplace_back();
+                        p2pReceiveBuffers.emplace_back();
+                    }
+                    size_t size = sizeof(HOST_DATA_TYPE) * size_in_bytes;
+                    if (!p2pBuffers[r] || p2pBuffers[r]->getSize() < size) {
+                        p2pBuffers[r].reset(new ::rdma::P2PBuffer(*config.context, *config.device, size));
+                        p2pReceiveBuffers[r].reset(new ::rdma::P2PBuffer(*config.context, *config.device, size));
+                    }
+                    continue;
+                }
+                if (dummyBufferContents[r].size() < size_in_bytes) {
+                    cl_mem_flags flags = CL_MEM_READ_WRITE | (config.programSettings->pcieZeroCopy ? CL_MEM_ALLOC_HOST_PTR : 0);
+                    dummyBuffers[r] = cl::Buffer(*config.context, flags, sizeof(HOST_DATA_TYPE) * size_in_bytes,0,&err);
+                    ASSERT_CL(err)
+                    if (config.programSettings->pcieZeroCopy) {
+                        if (r >= receiveBuffers.size()) {
+                            receiveBuffers.emplace_back();
+                        }
+                        receiveBuffers[r] = cl::Buffer(*config.context, flags, sizeof(HOST_DATA_TYPE) * size_in_bytes,0,&err);
+                        ASSERT_CL(err)
+                    }
+                    dummyBufferContents[r].resize(size_in_bytes);
+                }
+                if (config.programSettings->pcieConcurrent) {
+                    if (r >= receiveBufferContents.size()) {
+                        receiveBufferContents.emplace_back();
+                    }
+                    if (receiveBufferContents[r].size() < size_in_bytes) {
+                        receiveBufferContents[r].resize(size_in_bytes);
+                    }
+                }
+            }
+        }
+    };
+
+    /**
+     * @brief Exchange messages with the partner rank directly from the mapped device buffers of a kernel replication.
+     *          The message is sent from the mapped buffer that contains the last received message and received into the
+     *          second mapped buffer. Maps and unmaps of the next iteration are enqueued before the host waits for them,
+     *          so they can be overlapped by the OpenCL runtime. After the exchange, pool.dummyBuffers contains the last received message.
+     * 
+     * @param config The execution settings
+     * @param pool The resource pool that contains the buffers allocated for zero-copy
+     * @param replication The kernel replication that is used for the exchange
+     * @param size_in_bytes Size of a message
+     * @param looplength Number of messages that are exchanged
+     * @param partner Rank of the exchange partner
+     */
+    void
+    exchangeZeroCopy(hpcc_base::ExecutionSettings<network::NetworkProgramSettings> const& config, PcieResourcePool &pool,
+                        int replication, cl_uint size_in_bytes, cl_uint looplength, int partner) {
+        int err;
+        cl::CommandQueue &queue = pool.sendQueues[replication];
+        size_t size = sizeof(HOST_DATA_TYPE) * size_in_bytes;
+        cl::Event recvMapEvent;
+        auto send_ptr = reinterpret_cast<HOST_DATA_TYPE*>(queue.enqueueMapBuffer(pool.dummyBuffers[replication], CL_TRUE, CL_MAP_READ, 0, size, nullptr, nullptr, &err));
+        ASSERT_CL(err)
+        auto recv_ptr = reinterpret_cast<HOST_DATA_TYPE*>(queue.enqueueMapBuffer(pool.receiveBuffers[replication], CL_FALSE, CL_MAP_WRITE_INVALIDATE_REGION, 0, size, nullptr, &recvMapEvent, &err));
+        ASSERT_CL(err)
+        for (int l = 0; l < looplength; l++) {
+            MPI_Request requests[2];
+            MPI_Isend(send_ptr, size_in_bytes, MPI_CHAR, partner, 0, config.communicator, &requests[0]);
+            ASSERT_CL(recvMapEvent.wait())
+            MPI_Irecv(recv_ptr, size_in_bytes, MPI_CHAR, partner, 0, config.communicator, &requests[1]);
+            MPI_Waitall(2, requests, MPI_STATUSES_IGNORE);
+
+            // Write the received message to the device and use it as next message to send
+            ASSERT_CL(queue.enqueueUnmapMemObject(pool.dummyBuffers[replication], send_ptr))
+            ASSERT_CL(queue.enqueueUnmapMemObject(pool.receiveBuffers[replication], recv_ptr))
+            std::swap(pool.dummyBuffers[replication], pool.receiveBuffers[replication]);
+            if (l < looplength - 1) {
+                cl::Event sendMapEvent;
+                send_ptr = reinterpret_cast<HOST_DATA_TYPE*>(queue.enqueueMapBuffer(pool.dummyBuffers[replication], CL_FALSE, CL_MAP_READ, 0, size, nullptr, &sendMapEvent, &err));
+                ASSERT_CL(err)
+                recv_ptr = reinterpret_cast<HOST_DATA_TYPE*>(queue.enqueueMapBuffer(pool.receiveBuffers[replication], CL_FALSE, CL_MAP_WRITE_INVALIDATE_REGION, 0, size, nullptr, &recvMapEvent, &err));
+                ASSERT_CL(err)
+                ASSERT_CL(sendMapEvent.wait())
+            }
+        }
+        if (looplength == 0) {
+            ASSERT_CL(queue.enqueueUnmapMemObject(pool.dummyBuffers[replication], send_ptr))
+            ASSERT_CL(queue.enqueueUnmapMemObject(pool.receiveBuffers[replication], recv_ptr))
+        }
+        ASSERT_CL(queue.finish())
+    }
+
+    /**
+     * @brief Exchange messages of all kernel replications concurrently with their partner ranks.
+     *          In every iteration, the messages of all replications are read from the device with non-blocking reads,
+     *          sent with MPI_Isend as soon as the read of the replication is completed, and written back to the device
+     *          with non-blocking writes after all messages are received. The kernel replication is used as message tag,
+     *          because the replications of a rank may have the same partner.
+     * 
+     * @param pool The resource pool that contains the buffers allocated for the concurrent exchange
+     * @param size_in_bytes Size of a message
+     * @param looplength Number of messages that are exchanged by every replication
+     * @param partners Rank of the exchange partner for every kernel replication
+     * @param communicator Communicator of the ranks that execute the benchmark
+     */
+    void
+    exchangeConcurrent(PcieResourcePool &pool, cl_uint size_in_bytes, cl_uint looplength, const std::vector<int> &partners, MPI_Comm communicator) {
+        size_t replications = partners.size();
+        size_t size = sizeof(HOST_DATA_TYPE) * size_in_bytes;
+        for (int l = 0; l < looplength; l++) {
+            std::vector<cl::Event> readEvents(replications);
+            std::vector<MPI_Request> requests(2 * replications);
+            for (size_t i = 0; i < replications; i++) {
+                ASSERT_CL(pool.sendQueues[i].enqueueReadBuffer(pool.dummyBuffers[i], CL_FALSE, 0, size, pool.dummyBufferContents[i].data(), nullptr, &readEvents[i]))
+                MPI_Irecv(pool.receiveBufferContents[i].data(), size_in_bytes, MPI_CHAR, partners[i], i, communicator, &requests[replications + i]);
+            }
+            for (size_t i = 0; i < replications; i++) {
+                ASSERT_CL(readEvents[i].wait())
+                MPI_Isend(pool.dummyBufferContents[i].data(), size_in_bytes, MPI_CHAR, partners[i], i, communicator, &requests[i]);
+            }
+            MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+            for (size_t i = 0; i < replications; i++) {
+                ASSERT_CL(pool.sendQueues[i].enqueueWriteBuffer(pool.dummyBuffers[i], CL_FALSE, 0, size, pool.receiveBufferContents[i].data()))
+            }
+            for (size_t i = 0; i < replications; i++) {
+                ASSERT_CL(pool.sendQueues[i].finish())
+            }
+        }
+    }
+
+    /**
+     * @brief Exchange ping-pong messages with the partner rank over PCIe and MPI and measure the one-way latency on the host.
+     *          Every message is read from the device, sent to the partner and written back to the device by the receiver.
+     *          The initiator measures the round trip time of every message including the PCIe transfers and stores half of it as latency.
+     * 
+     * @param pool The resource pool that contains the buffers
+     * @param replication The kernel replication that is used for the exchange
+     * @param size_in_bytes Size of a message
+     * @param looplength Number of round trips
+     * @param rank Rank of the current process
+     * @param partner Rank of the ping-pong partner
+     * @param latencies The measured one-way latencies are appended to this vector by the initiator
+     * @param communicator Communicator of the ranks that execute the benchmark
+     */
+    void
+    pingPong(PcieResourcePool &pool, int replication, cl_uint size_in_bytes, cl_uint looplength, int rank, int partner, std::vector<double> &latencies, MPI_Comm communicator) {
+        cl::CommandQueue &queue = pool.sendQueues[replication];
+        cl::Buffer &buffer = pool.dummyBuffers[replication];
+        HOST_DATA_TYPE* host_buffer = pool.dummyBufferContents[replication].data();
+        size_t size = sizeof(HOST_DATA_TYPE) * size_in_bytes;
+        bool initiator = network::isPingPongInitiator(rank, partner);
+        for (int l = 0; l < looplength; l++) {
+            if (initiator) {
+                auto start = std::chrono::high_resolution_clock::now();
+                ASSERT_CL(queue.enqueueReadBuffer(buffer, CL_TRUE, 0, size, host_buffer))
+                if (partner == rank) {
+                    MPI_Sendrecv_replace(host_buffer, size_in_bytes, MPI_CHAR, rank, 1, rank, 1, communicator, MPI_STATUS_IGNORE);
+                }
+                else {
+                    MPI_Send(host_buffer, size_in_bytes, MPI_CHAR, partner, 1, communicator);
+                    MPI_Recv(host_buffer, size_in_bytes, MPI_CHAR, partner, 1, communicator, MPI_STATUS_IGNORE);
+                }
+                ASSERT_CL(queue.enqueueWriteBuffer(buffer, CL_TRUE, 0, size, host_buffer))
+                latencies.push_back(std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count() / 2.0);
+            }
+            else {
+                MPI_Recv(host_buffer, size_in_bytes, MPI_CHAR, partner, 1, communicator, MPI_STATUS_IGNORE);
+                ASSERT_CL(queue.enqueueWriteBuffer(buffer, CL_TRUE, 0, size, host_buffer))
+                ASSERT_CL(queue.enqueueReadBuffer(buffer, CL_TRUE, 0, size, host_buffer))
+                MPI_Send(host_buffer, size_in_bytes, MPI_CHAR, partner, 1, communicator);
+            }
+        }
+    }
+
     /*
     Implementation for the single kernel.
+    Uses the given resource pool for all buffers and queues.
      @copydoc bm_execution::calculate()
     */
     std::shared_ptr<network::ExecutionTimings>
     calculate(hpcc_base::ExecutionSettings<network::NetworkProgramSettings> const& config, cl_uint messageSize, cl_uint looplength,
-                cl::vector<HOST_DATA_TYPE> &validationData) {
+                cl::vector<HOST_DATA_TYPE> &validationData, PcieResourcePool &pool) {
 
         int err;
-        std::vector<cl::CommandQueue> sendQueues;
-        std::vector<cl::Buffer> dummyBuffers;
-        std::vector<cl::vector<HOST_DATA_TYPE>> dummyBufferContents;
+        std::vector<cl::CommandQueue> &sendQueues = pool.sendQueues;
+        std::vector<cl::Buffer> &dummyBuffers = pool.dummyBuffers;
+        std::vector<cl::vector<HOST_DATA_TYPE>> &dummyBufferContents = pool.dummyBufferContents;
 
         cl_uint size_in_bytes = std::max(static_cast<int>(validationData.size()), (1 << messageSize));
 
         int current_rank;
-        MPI_Comm_rank(MPI_COMM_WORLD, & current_rank);
+        MPI_Comm_rank(config.communicator, & current_rank);
 
         int current_size;
-        MPI_Comm_size(MPI_COMM_WORLD, & current_size);
+        MPI_Comm_size(config.communicator, & current_size);
+
+        // The collective patterns exchange the whole buffer, which contains a message for every rank for all-to-all
+        network::CommunicationPattern pattern = config.programSettings->pattern;
+        bool collective = network::isCollectivePattern(pattern);
+        cl_uint buffer_size = network::getMessageBufferSize(pattern, size_in_bytes, current_size);
+
+        pool.reserve(config, buffer_size);
 
         std::vector<double> calculationTimings;
+        std::vector<double> latencies;
         for (uint r =0; r < config.programSettings->numRepetitions; r++) {
-            sendQueues.clear();
-            dummyBuffers.clear();
-            dummyBufferContents.clear();
-            // Create all kernels and buffers. The kernel pairs are generated twice to utilize all channels
+            // Initialize the buffers of all replications with the expected value
             for (int r = 0; r < config.programSettings->kernelReplications; r++) {
 
-                dummyBuffers.push_back(cl::Buffer(*config.context, CL_MEM_READ_WRITE, sizeof(HOST_DATA_TYPE) * size_in_bytes,0,&err));
-                ASSERT_CL(err)
-
-                dummyBufferContents.emplace_back(size_in_bytes, static_cast<HOST_DATA_TYPE>(messageSize & (255)));
-
-                cl::CommandQueue sendQueue(*config.context, *config.device, 0, &err);
-                ASSERT_CL(err)
-
-                sendQueue.enqueueWriteBuffer(dummyBuffers.back(), CL_TRUE, 0, sizeof(HOST_DATA_TYPE) * size_in_bytes, dummyBufferContents.back().data());
+                std::fill(dummyBufferContents[r].begin(), dummyBufferContents[r].begin() + buffer_size, static_cast<HOST_DATA_TYPE>(messageSize & (255)));
 
-                sendQueues.push_back(sendQueue);
+                sendQueues[r].enqueueWriteBuffer(dummyBuffers[r], CL_TRUE, 0, sizeof(HOST_DATA_TYPE) * buffer_size, dummyBufferContents[r].data());
 
             }
             double calculationTime = 0.0;
-            for (int i = 0; i < config.programSettings->kernelReplications; i++) {
-                MPI_Barrier(MPI_COMM_WORLD);
+            if (config.programSettings->pcieConcurrent) {
+                // All replications are measured together
+                std::vector<int> partners;
+                for (int i = 0; i < config.programSettings->kernelReplications; i++) {
+                    partners.push_back(network::getCommunicationPartner(current_rank, current_size, i, pattern));
+                }
+                MPI_Barrier(config.communicator);
                 auto startCalculation = std::chrono::high_resolution_clock::now();
-                for (int l = 0; l < looplength; l++) {
+                exchangeConcurrent(pool, size_in_bytes, looplength, partners, config.communicator);
+                auto endCalculation = std::chrono::high_resolution_clock::now();
+                calculationTime = std::chrono::duration_cast<std::chrono::duration<double>>(endCalculation - startCalculation).count();
+            }
+            else for (int i = 0; i < config.programSettings->kernelReplications; i++) {
+                int partner = collective ? current_rank : network::getCommunicationPartner(current_rank, current_size, i, pattern);
+                MPI_Barrier(config.communicator);
+                auto startCalculation = std::chrono::high_resolution_clock::now();
+                if (config.programSettings->latencyMode) {
+                    // The latency is always measured with copies to host buffers
+                    pingPong(pool, i, size_in_bytes, looplength, current_rank, partner, latencies, config.communicator);
+                }
+                else if (collective) {
+                    // Collectives are always executed on host buffers, since the result has to be written back to the device
+                    for (int l = 0; l < looplength; l++) {
+                        sendQueues[i].enqueueReadBuffer(dummyBuffers[i], CL_TRUE, 0, sizeof(HOST_DATA_TYPE) * buffer_size, dummyBufferContents[i].data());
+
+                        network::exchangeCollective(pattern, dummyBufferContents[i].data(), size_in_bytes, config.communicator);
+
+                        sendQueues[i].enqueueWriteBuffer(dummyBuffers[i], CL_TRUE, 0, sizeof(HOST_DATA_TYPE) * buffer_size, dummyBufferContents[i].data());
+                    }
+                }
+                else if (config.programSettings->pcieZeroCopy) {
+                    exchangeZeroCopy(config, pool, i, size_in_bytes, looplength, partner);
+                }
+                else for (int l = 0; l < looplength; l++) {
 
                         sendQueues[i].enqueueReadBuffer(dummyBuffers[i], CL_TRUE, 0, sizeof(HOST_DATA_TYPE) * size_in_bytes, dummyBufferContents[i].data());
 
-                        MPI_Sendrecv(dummyBufferContents[i].data(), size_in_bytes, MPI_CHAR, (current_rank - 1 + 2 * ((current_rank + i) % 2) + current_size) % current_size, 0, 
-                                        dummyBufferContents[i].data(), size_in_bytes, MPI_CHAR, (current_rank - 1 + 2 * ((current_rank + i) % 2)  + current_size) % current_size, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+                        MPI_Sendrecv(dummyBufferContents[i].data(), size_in_bytes, MPI_CHAR, partner, 0, 
+                                        dummyBufferContents[i].data(), size_in_bytes, MPI_CHAR, partner, 0, config.communicator, MPI_STATUS_IGNORE);
 
                         sendQueues[i].enqueueWriteBuffer(dummyBuffers[i], CL_TRUE, 0, sizeof(HOST_DATA_TYPE) * size_in_bytes, dummyBufferContents[i].data());
 
@@ -94,14 +367,14 @@ namespace network::execution_types::pcie {
                 calculationTime += std::chrono::duration_cast<std::chrono::duration<double>>(endCalculation - startCalculation).count();
                 #ifndef NDEBUG
                         int current_rank;
-                        MPI_Comm_rank(MPI_COMM_WORLD, & current_rank);
+                        MPI_Comm_rank(config.communicator, & current_rank);
                         std::cout << "Rank " << current_rank << ": Enqueued " << r << "," << i << std::endl;
                 #endif
             }
             calculationTimings.push_back(calculationTime);
 #ifndef NDEBUG
         int current_rank;
-        MPI_Comm_rank(MPI_COMM_WORLD, & current_rank);
+        MPI_Comm_rank(config.communicator, & current_rank);
         std::cout << "Rank " << current_rank << ": Done " << r << std::endl;
 #endif
         }
@@ -116,9 +389,22 @@ namespace network::execution_types::pcie {
                 messageSize,
                 calculationTimings
         });
+        result->latencies = latencies;
         return result;
     }
 
+    /*
+    Implementation for the single kernel.
+    All resources are allocated for this call only.
+     @copydoc bm_execution::calculate()
+    */
+    std::shared_ptr<network::ExecutionTimings>
+    calculate(hpcc_base::ExecutionSettings<network::NetworkProgramSettings> const& config, cl_uint messageSize, cl_uint looplength,
+                cl::vector<HOST_DATA_TYPE> &validationData) {
+        PcieResourcePool pool;
+        return calculate(config, messageSize, looplength, validationData, pool);
+    }
+
 }  // namespace bm_execution
 
 #endif
@@ -0,0 +1,204 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef SRC_HOST_EXECUTION_TYPES_EXECUTION_RDMA_HPP
+#define SRC_HOST_EXECUTION_TYPES_EXECUTION_RDMA_HPP
+
+/* C++ standard library headers */
+#include <memory>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+
+/* External library headers */
+#include "mpi.h"
+
+/* Project's headers */
+#include "execution_types/execution_pcie.hpp"
+
+namespace network::execution_types::rdma {
+
+    /**
+     * @brief Exchange messages with the partner rank directly between the mapped P2P buffers of a kernel replication.
+     *          The MPI library reads and writes the device memory in the PCIe BAR, so no copies to host memory are involved.
+     *          After the exchange, pool.p2pBuffers contains the last received message.
+     * 
+     * @param pool The resource pool that contains the P2P buffers
+     * @param replication The kernel replication that is used for the exchange
+     * @param size_in_bytes Size of a message
+     * @param looplength Number of messages that are exchanged
+     * @param partner Rank of the exchange partner
+     * @param communicator Communicator of the ranks that execute the benchmark
+     */
+    void
+    exchange(pcie::PcieResourcePool &pool, int replication, cl_uint size_in_bytes, cl_uint looplength, int partner, MPI_Comm communicator) {
+        for (int l = 0; l < looplength; l++) {
+            MPI_Sendrecv(pool.p2pBuffers[replication]->data<HOST_DATA_TYPE>(), size_in_bytes, MPI_CHAR, partner, 0,
+                            pool.p2pReceiveBuffers[replication]->data<HOST_DATA_TYPE>(), size_in_bytes, MPI_CHAR, partner, 0, communicator, MPI_STATUS_IGNORE);
+            // The received message is sent in the next iteration
+            std::swap(pool.p2pBuffers[replication], pool.p2pReceiveBuffers[replication]);
+        }
+    }
+
+    /**
+     * @brief Exchange messages of all kernel replications concurrently with their partner ranks using non-blocking MPI operations
+     *          on the mapped P2P buffers. The kernel replication is used as message tag, because the replications of a rank may have the same partner.
+     * 
+     * @param pool The resource pool that contains the P2P buffers
+     * @param size_in_bytes Size of a message
+     * @param looplength Number of messages that are exchanged by every replication
+     * @param partners Rank of the exchange partner for every kernel replication
+     * @param communicator Communicator of the ranks that execute the benchmark
+     */
+    void
+    exchangeConcurrent(pcie::PcieResourcePool &pool, cl_uint size_in_bytes, cl_uint looplength, const std::vector<int> &partners, MPI_Comm communicator) {
+        size_t replications = partners.size();
+        for (int l = 0; l < looplength; l++) {
+            std::vector<MPI_Request> requests(2 * replications);
+            for (size_t i = 0; i < replications; i++) {
+                MPI_Irecv(pool.p2pReceiveBuffers[i]->data<HOST_DATA_TYPE>(), size_in_bytes, MPI_CHAR, partners[i], i, communicator, &requests[replications + i]);
+                MPI_Isend(pool.p2pBuffers[i]->data<HOST_DATA_TYPE>(), size_in_bytes, MPI_CHAR, partners[i], i, communicator, &requests[i]);
+            }
+            MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+            for (size_t i = 0; i < replications; i++) {
+                std::swap(pool.p2pBuffers[i], pool.p2pReceiveBuffers[i]);
+            }
+        }
+    }
+
+    /**
+     * @brief Exchange ping-pong messages with the partner rank directly from device memory and measure the one-way latency on the host.
+     *          In contrast to the PCIe execution, the round trip does not contain explicit transfers between host and device.
+     * 
+     * @param pool The resource pool that contains the P2P buffers
+     * @param replication The kernel replication that is used for the exchange
+     * @param size_in_bytes Size of a message
+     * @param looplength Number of round trips
+     * @param rank Rank of the current process
+     * @param partner Rank of the ping-pong partner
+     * @param latencies The measured one-way latencies are appended to this vector by the initiator
+     * @param communicator Communicator of the ranks that execute the benchmark
+     */
+    void
+    pingPong(pcie::PcieResourcePool &pool, int replication, cl_uint size_in_bytes, cl_uint looplength, int rank, int partner, std::vector<double> &latencies, MPI_Comm communicator) {
+        HOST_DATA_TYPE* device_buffer = pool.p2pBuffers[replication]->data<HOST_DATA_TYPE>();
+        bool initiator = network::isPingPongInitiator(rank, partner);
+        for (int l = 0; l < looplength; l++) {
+            if (initiator) {
+                auto start = std::chrono::high_resolution_clock::now();
+                if (partner == rank) {
+                    MPI_Sendrecv_replace(device_buffer, size_in_bytes, MPI_CHAR, rank, 1, rank, 1, communicator, MPI_STATUS_IGNORE);
+                }
+                else {
+                    MPI_Send(device_buffer, size_in_bytes, MPI_CHAR, partner, 1, communicator);
+                    MPI_Recv(device_buffer, size_in_bytes, MPI_CHAR, partner, 1, communicator, MPI_STATUS_IGNORE);
+                }
+                latencies.push_back(std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count() / 2.0);
+            }
+            else {
+                MPI_Recv(device_buffer, size_in_bytes, MPI_CHAR, partner, 1, communicator, MPI_STATUS_IGNORE);
+                MPI_Send(device_buffer, size_in_bytes, MPI_CHAR, partner, 1, communicator);
+            }
+        }
+    }
+
+    /*
+    Implementation for the single kernel.
+    The messages are sent by MPI directly from the P2P buffers of the given resource pool.
+     @copydoc bm_execution::calculate()
+    */
+    std::shared_ptr<network::ExecutionTimings>
+    calculate(hpcc_base::ExecutionSettings<network::NetworkProgramSettings> const& config, cl_uint messageSize, cl_uint looplength,
+                cl::vector<HOST_DATA_TYPE> &validationData, pcie::PcieResourcePool &pool) {
+
+        cl_uint size_in_bytes = std::max(static_cast<int>(validationData.size()), (1 << messageSize));
+
+        int current_rank;
+        MPI_Comm_rank(config.communicator, & current_rank);
+
+        int current_size;
+        MPI_Comm_size(config.communicator, & current_size);
+
+        network::CommunicationPattern pattern = config.programSettings->pattern;
+        bool collective = network::isCollectivePattern(pattern);
+        cl_uint buffer_size = network::getMessageBufferSize(pattern, size_in_bytes, current_size);
+
+        pool.reserve(config, buffer_size);
+
+        std::vector<double> calculationTimings;
+        std::vector<double> latencies;
+        for (uint r =0; r < config.programSettings->numRepetitions; r++) {
+            // Initialize the device memory of all replications with the expected value through the mapped pointers
+            for (int r = 0; r < config.programSettings->kernelReplications; r++) {
+                HOST_DATA_TYPE* device_buffer = pool.p2pBuffers[r]->data<HOST_DATA_TYPE>();
+                std::fill(device_buffer, device_buffer + buffer_size, static_cast<HOST_DATA_TYPE>(messageSize & (255)));
+            }
+            double calculationTime = 0.0;
+            if (config.programSettings->pcieConcurrent) {
+                std::vector<int> partners;
+                for (int i = 0; i < config.programSettings->kernelReplications; i++) {
+                    partners.push_back(network::getCommunicationPartner(current_rank, current_size, i, pattern));
+                }
+                MPI_Barrier(config.communicator);
+                auto startCalculation = std::chrono::high_resolution_clock::now();
+                exchangeConcurrent(pool, size_in_bytes, looplength, partners, config.communicator);
+                auto endCalculation = std::chrono::high_resolution_clock::now();
+                calculationTime = std::chrono::duration_cast<std::chrono::duration<double>>(endCalculation - startCalculation).count();
+            }
+            else for (int i = 0; i < config.programSettings->kernelReplications; i++) {
+                int partner = collective ? current_rank : network::getCommunicationPartner(current_rank, current_size, i, pattern);
+                MPI_Barrier(config.communicator);
+                auto startCalculation = std::chrono::high_resolution_clock::now();
+                if (config.programSettings->latencyMode) {
+                    pingPong(pool, i, size_in_bytes, looplength, current_rank, partner, latencies, config.communicator);
+                }
+                else if (collective) {
+                    // The collectives are executed in place on the device memory
+                    for (int l = 0; l < looplength; l++) {
+                        network::exchangeCollective(pattern, pool.p2pBuffers[i]->data<HOST_DATA_TYPE>(), size_in_bytes, config.communicator);
+                    }
+                }
+                else {
+                    exchange(pool, i, size_in_bytes, looplength, partner, config.communicator);
+                }
+                auto endCalculation = std::chrono::high_resolution_clock::now();
+                calculationTime += std::chrono::duration_cast<std::chrono::duration<double>>(endCalculation - startCalculation).count();
+            }
+            calculationTimings.push_back(calculationTime);
+        }
+        // The buffers stay mapped, so the validation data is copied from the mapped device memory
+        size_t replication_size = validationData.size() / config.programSettings->kernelReplications;
+        for (int r = 0; r < config.programSettings->kernelReplications; r++) {
+            HOST_DATA_TYPE* device_buffer = pool.p2pBuffers[r]->data<HOST_DATA_TYPE>();
+            std::copy(device_buffer, device_buffer + replication_size, &validationData.data()[r * replication_size]);
+        }
+        std::shared_ptr<network::ExecutionTimings> result(new network::ExecutionTimings{
+                looplength,
+                messageSize,
+                calculationTimings
+        });
+        result->latencies = latencies;
+        return result;
+    }
+
+}  // namespace network::execution_types::rdma
+
+#endif
@@ -27,16 +27,24 @@ SOFTWARE.
 #include "network_benchmark.hpp"
 
 /* C++ standard library headers */
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <memory>
 #include <random>
 
 /* Project's headers */
 #include "execution_types/execution.hpp"
 #include "parameters.h"
+#include "counter_rng.hpp"
 
 network::NetworkProgramSettings::NetworkProgramSettings(cxxopts::ParseResult &results) : hpcc_base::BaseSettings(results),
     maxLoopLength(results["u"].as<uint>()), minLoopLength(results["l"].as<uint>()), maxMessageSize(results["m"].as<uint>()), 
-    minMessageSize(results["min-size"].as<uint>()), llOffset(results["o"].as<uint>()), llDecrease(results["d"].as<uint>()) {
+    minMessageSize(results["min-size"].as<uint>()), llOffset(results["o"].as<uint>()), llDecrease(results["d"].as<uint>()),
+    pcieZeroCopy(results["pcie-zero-copy"].count() > 0), 
+    pcieConcurrent(results["pcie-concurrent"].count() > 0), latencyMode(results["latency"].count() > 0),
+    pattern(network::retrieveCommunicationPattern(results["pattern"].as<std::string>())),
+    calibrationTarget(results["calibrate"].as<uint>()) {
 
 }
 
@@ -45,9 +53,94 @@ network::NetworkProgramSettings::getSettingsMap() {
         auto map = hpcc_base::BaseSettings::getSettingsMap();
         map["Loop Length"] = std::to_string(minLoopLength) + " - " + std::to_string(maxLoopLength);
         map["Message Sizes"] =  "2^" + std::to_string(minMessageSize) + " - 2^" + std::to_string(maxMessageSize) + " Bytes";
+        map["PCIe Zero-Copy"] = pcieZeroCopy ? "Yes" : "No";
+        map["PCIe Concurrent Replications"] = pcieConcurrent ? "Yes" : "No";
+        map["Mode"] = latencyMode ? "Ping-Pong Latency" : "Bandwidth";
+        map["Pattern"] = network::patternToString(pattern);
+        map["Loop Length Calibration"] = (calibrationTarget > 0) ? std::to_string(calibrationTarget) + " ms" : "No";
         return map;
 }
 
+std::string
+network::patternToString(network::CommunicationPattern p) {
+    for (auto& entry : pattern_to_str_map) {
+        if (entry.second == p) {
+            return entry.first;
+        }
+    }
+    throw std::runtime_error("Communication pattern could not be converted to string!");
+}
+
+network::CommunicationPattern
+network::retrieveCommunicationPattern(std::string pattern_name) {
+    auto result = pattern_to_str_map.find(pattern_name);
+    if (result != pattern_to_str_map.end()) {
+        return result->second;
+    }
+    throw std::runtime_error("Communication pattern could not be converted from string: " + pattern_name);
+}
+
+bool
+network::isCollectivePattern(network::CommunicationPattern p) {
+    return p == CommunicationPattern::all_to_all || p == CommunicationPattern::allreduce;
+}
+
+int
+network::getCommunicationPartner(int rank, int size, int replication, network::CommunicationPattern pattern) {
+    switch (pattern) {
+        case CommunicationPattern::ring: return (rank - 1 + 2 * ((rank + replication) % 2) + size) % size;
+        case CommunicationPattern::random_pairs: {
+            // Fisher-Yates shuffle with a counter-based generator, so all ranks calculate the same permutation
+            std::vector<int> permutation(size);
+            for (int i = 0; i < size; i++) {
+                permutation[i] = i;
+            }
+            for (int i = size - 1; i > 0; i--) {
+                int j = std::min(static_cast<int>(rng::uniform(0, replication, i) * (i + 1)), i);
+                std::swap(permutation[i], permutation[j]);
+            }
+            int position = std::find(permutation.begin(), permutation.end(), rank) - permutation.begin();
+            int partner_position = position ^ 1;
+            return (partner_position < size) ? permutation[partner_position] : rank;
+        }
+        case CommunicationPattern::bisection: {
+            int half = size / 2;
+            if (rank < half) {
+                return rank + half;
+            }
+            return (rank < 2 * half) ? rank - half : rank;
+        }
+        default: throw std::runtime_error("No communication partner defined for collective pattern: " + patternToString(pattern));
+    }
+}
+
+cl_uint
+network::getMessageBufferSize(network::CommunicationPattern pattern, cl_uint size_in_bytes, int size) {
+    return (pattern == CommunicationPattern::all_to_all) ? size_in_bytes * size : size_in_bytes;
+}
+
+double
+network::getSentBytesPerMessage(network::CommunicationPattern pattern, cl_uint size_in_bytes, int size) {
+    return static_cast<double>(getMessageBufferSize(pattern, size_in_bytes, size));
+}
+
+void
+network::exchangeCollective(network::CommunicationPattern pattern, HOST_DATA_TYPE* buffer, cl_uint size_in_bytes, MPI_Comm communicator) {
+    switch (pattern) {
+        case CommunicationPattern::all_to_all: 
+            MPI_Alltoall(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, buffer, size_in_bytes, MPI_CHAR, communicator); break;
+        // All ranks send the same values, so the maximum keeps the message unchanged for the validation
+        case CommunicationPattern::allreduce: 
+            MPI_Allreduce(MPI_IN_PLACE, buffer, size_in_bytes, MPI_SIGNED_CHAR, MPI_MAX, communicator); break;
+        default: throw std::runtime_error("Communication pattern is not a collective: " + patternToString(pattern));
+    }
+}
+
+bool
+network::isPingPongInitiator(int rank, int partner) {
+    return rank <= partner;
+}
+
 network::NetworkData::NetworkDataItem::NetworkDataItem(unsigned int _messageSize, unsigned int _loopLength) : messageSize(_messageSize), loopLength(_loopLength), 
                                                                             validationBuffer(CHANNEL_WIDTH * 2 * 2, 0) {
                                                                                 // TODO: fix the validation buffer size to use the variable number of kernel replications and channels
@@ -86,68 +179,101 @@ network::NetworkBenchmark::addAdditionalParseOptions(cxxopts::Options &options)
         ("o", "Offset used before reducing repetitions",
             cxxopts::value<uint>()->default_value(std::to_string(DEFAULT_LOOP_LENGTH_OFFSET)))
         ("d", "Number os steps the repetitions are decreased to its minimum",
-            cxxopts::value<uint>()->default_value(std::to_string(DEFAULT_LOOP_LENGTH_DECREASE)));
+            cxxopts::value<uint>()->default_value(std::to_string(DEFAULT_LOOP_LENGTH_DECREASE)))
+        ("pcie-zero-copy", "Send messages directly from mapped host-pinned buffers with the PCIe communication type instead of copying them to a host buffer")
+        ("pcie-concurrent", "Exchange the messages of all kernel replications concurrently with the PCIe communication type instead of one replication after another")
+        ("latency", "Measure the one-way latency with ping-pong messages between pairs of ranks instead of the bandwidth")
+        ("pattern", "Communication pattern. Valid values: RING, RANDOM, BISECTION, ALLTOALL, ALLREDUCE",
+            cxxopts::value<std::string>()->default_value("RING"))
+        ("calibrate", "Calibrate the loop length of every message size, so a repetition takes the given time in ms. 0 disables the calibration",
+            cxxopts::value<uint>()->default_value(std::to_string(0)));
 }
 
 std::unique_ptr<network::NetworkExecutionTimings>
 network::NetworkBenchmark::executeKernel(NetworkData &data) {
     // Get the number of processes
     int world_size;
-    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+    MPI_Comm_size(executionSettings->communicator, &world_size);
 
     // Get the rank of the process
     int world_rank;
-    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+    MPI_Comm_rank(executionSettings->communicator, &world_rank);
 
     std::vector<std::shared_ptr<network::ExecutionTimings>> timing_results;
 
+    // Allocate the resources for the PCIe and RDMA execution once for the largest message size
+    // and reuse them for all runs
+    execution_types::pcie::PcieResourcePool pciePool;
+    if (executionSettings->programSettings->communicationType == hpcc_base::CommunicationType::pcie_mpi
+            || executionSettings->programSettings->communicationType == hpcc_base::CommunicationType::rdma) {
+        cl_uint max_size = 0;
+        for (auto& run : data.items) {
+            max_size = std::max(max_size, getMessageBufferSize(executionSettings->programSettings->pattern,
+                                    static_cast<cl_uint>(std::max(static_cast<int>(run.validationBuffer.size()), (1 << run.messageSize))), world_size));
+        }
+        pciePool.reserve(*executionSettings, max_size);
+    }
+
+    if (executionSettings->programSettings->calibrationTarget > 0) {
+        calibrateLoopLengths(data, pciePool);
+    }
+
     for (auto& run : data.items) {
         if (world_rank == 0) {
             std::cout << "Measure for " << (1 << run.messageSize) << " Byte" << std::endl;
         }
-        std::shared_ptr<network::ExecutionTimings> timing;
-        switch (executionSettings->programSettings->communicationType) {
-            case hpcc_base::CommunicationType::cpu_only: timing = execution_types::cpu::calculate(*executionSettings, run.messageSize, run.loopLength, run.validationBuffer); break;
-            case hpcc_base::CommunicationType::pcie_mpi: timing = execution_types::pcie::calculate(*executionSettings, run.messageSize, run.loopLength, run.validationBuffer); break;
-            case hpcc_base::CommunicationType::intel_external_channels: timing = execution_types::iec::calculate(*executionSettings, run.messageSize, run.loopLength, run.validationBuffer); break;
-            default: throw std::runtime_error("Selected Communication type not supported: " + hpcc_base::commToString(executionSettings->programSettings->communicationType));
+        std::shared_ptr<network::ExecutionTimings> timing = executeRun(run, run.loopLength, pciePool);
+        if (!timing->latencies.empty()) {
+            // Every repetition contains looplength latencies per replication
+            size_t per_repetition = timing->latencies.size() / executionSettings->programSettings->numRepetitions;
+            size_t warmup = std::min(static_cast<size_t>(executionSettings->programSettings->warmupRepetitions) * per_repetition,
+                                        timing->latencies.size() - 1);
+            timing->latencyStatistics = statistics::computeStatistics(std::vector<double>(timing->latencies.begin() + warmup, timing->latencies.end()));
+            timing->hasLatencies = true;
         }
         timing_results.push_back(timing);
     }
 
     std::unique_ptr<network::NetworkExecutionTimings> collected_results = std::unique_ptr<network::NetworkExecutionTimings> (new network::NetworkExecutionTimings());
-    if (world_rank > 0) {
-        for (const auto& t : timing_results) {
-            MPI_Send(&(t->messageSize),
-                     1,
-                     MPI_UNSIGNED, 0, 0, MPI_COMM_WORLD);
-            MPI_Send(&(t->looplength),
-                     1,
-                     MPI_UNSIGNED, 0, 1, MPI_COMM_WORLD);
-            MPI_Send(&(t->calculationTimings.front()),
-                     executionSettings->programSettings->numRepetitions,
-                     MPI_DOUBLE, 0,  2, MPI_COMM_WORLD);
-        }
-    } else {
-        std::cout << "Collect results over MPI.";
+    // Pack the message size, loop length and all timings of every run into a single buffer,
+    // so the results of all ranks can be collected with a single gather operation.
+    // All ranks do the same runs, so the size of the packed data is the same for every rank.
+    // The latencies are packed as a flag followed by their minimum, median and 99th percentile.
+    size_t values_per_run = 2 + executionSettings->programSettings->numRepetitions + 4;
+    std::vector<double> packed_results;
+    packed_results.reserve(values_per_run * timing_results.size());
+    for (const auto& t : timing_results) {
+        packed_results.push_back(t->messageSize);
+        packed_results.push_back(t->looplength);
+        packed_results.insert(packed_results.end(), t->calculationTimings.begin(), t->calculationTimings.end());
+        packed_results.push_back(t->hasLatencies ? 1.0 : 0.0);
+        packed_results.push_back(t->latencyStatistics.min);
+        packed_results.push_back(t->latencyStatistics.median);
+        packed_results.push_back(t->latencyStatistics.p99);
+    }
+    std::vector<double> gathered_results;
+    if (world_rank == 0) {
+        std::cout << "Collect results over MPI...";
+        gathered_results.resize(packed_results.size() * world_size);
+    }
+    MPI_Gather(packed_results.data(), packed_results.size(), MPI_DOUBLE, 
+                gathered_results.data(), packed_results.size(), MPI_DOUBLE, 0, executionSettings->communicator);
+
+    if (world_rank == 0) {
         int k = 0;
         for (auto& run : data.items) {
             std::vector<std::shared_ptr<network::ExecutionTimings>> tmp_timings;
-            std::cout << ".";
             for (int i=1; i < world_size; i++) {
+                const double* rank_run = &gathered_results[i * packed_results.size() + k * values_per_run];
+                const double* rank_latencies = rank_run + values_per_run - 4;
                 auto execution_result = std::shared_ptr<network::ExecutionTimings>( new network::ExecutionTimings {
-                    0,0,std::vector<double>(executionSettings->programSettings->numRepetitions)
+                    static_cast<cl_uint>(rank_run[1]), static_cast<cl_uint>(rank_run[0]),
+                    std::vector<double>(rank_run + 2, rank_latencies)
                 });
-                MPI_Status status;
-                MPI_Recv(&(execution_result->messageSize),
-                         1,
-                         MPI_UNSIGNED, i, 0, MPI_COMM_WORLD, &status);
-                MPI_Recv(&(execution_result->looplength),
-                         1,
-                         MPI_UNSIGNED, i, 1, MPI_COMM_WORLD, &status);
-                MPI_Recv(&(execution_result->calculationTimings.front()),
-                         executionSettings->programSettings->numRepetitions,
-                         MPI_DOUBLE, i, 2, MPI_COMM_WORLD, &status);
+                execution_result->hasLatencies = rank_latencies[0] > 0.0;
+                execution_result->latencyStatistics.min = rank_latencies[1];
+                execution_result->latencyStatistics.median = rank_latencies[2];
+                execution_result->latencyStatistics.p99 = rank_latencies[3];
                 tmp_timings.push_back(execution_result);
                 if (execution_result->messageSize != run.messageSize) {
                     std::cerr << "Wrong message size: " << execution_result->messageSize << " != " << run.messageSize << " from rank " << i << std::endl;
@@ -164,10 +290,62 @@ network::NetworkBenchmark::executeKernel(NetworkData &data) {
         return collected_results;
 }
 
+std::shared_ptr<network::ExecutionTimings>
+network::NetworkBenchmark::executeRun(NetworkData::NetworkDataItem &run, cl_uint looplength, execution_types::pcie::PcieResourcePool &pciePool) {
+    switch (executionSettings->programSettings->communicationType) {
+        case hpcc_base::CommunicationType::cpu_only: return execution_types::cpu::calculate(*executionSettings, run.messageSize, looplength, run.validationBuffer);
+        case hpcc_base::CommunicationType::pcie_mpi: return execution_types::pcie::calculate(*executionSettings, run.messageSize, looplength, run.validationBuffer, pciePool);
+        case hpcc_base::CommunicationType::rdma: return execution_types::rdma::calculate(*executionSettings, run.messageSize, looplength, run.validationBuffer, pciePool);
+        case hpcc_base::CommunicationType::intel_external_channels: return execution_types::iec::calculate(*executionSettings, run.messageSize, looplength, run.validationBuffer);
+        default: throw std::runtime_error("Selected Communication type not supported: " + hpcc_base::commToString(executionSettings->programSettings->communicationType));
+    }
+}
+
+void
+network::NetworkBenchmark::calibrateLoopLengths(NetworkData &data, execution_types::pcie::PcieResourcePool &pciePool) {
+    double target = executionSettings->programSettings->calibrationTarget * 1.0e-3;
+    if (mpi_comm_rank == 0) {
+        std::cout << "Calibrate loop lengths for " << executionSettings->programSettings->calibrationTarget << " ms per repetition...";
+    }
+    // Execute a single repetition with a reduced loop length for every message size
+    uint measured_repetitions = executionSettings->programSettings->numRepetitions;
+    executionSettings->programSettings->numRepetitions = 1;
+    std::vector<double> message_times;
+    try {
+        for (auto& run : data.items) {
+            cl_uint probe_looplength = std::max(run.loopLength / CALIBRATION_PROBE_DIVISOR, 1u);
+            auto timing = executeRun(run, probe_looplength, pciePool);
+            message_times.push_back(timing->calculationTimings[0] / probe_looplength);
+        }
+    }
+    catch (...) {
+        executionSettings->programSettings->numRepetitions = measured_repetitions;
+        throw;
+    }
+    executionSettings->programSettings->numRepetitions = measured_repetitions;
+
+    // All ranks have to use the same loop lengths, so the slowest rank defines the time per message
+    MPI_Allreduce(MPI_IN_PLACE, message_times.data(), message_times.size(), MPI_DOUBLE, MPI_MAX, executionSettings->communicator);
+
+    for (size_t i = 0; i < data.items.size(); i++) {
+        double looplength = (message_times[i] > 0.0) ? std::ceil(target / message_times[i]) : static_cast<double>(data.items[i].loopLength);
+        looplength = std::min(looplength, static_cast<double>(std::numeric_limits<cl_uint>::max()));
+        data.items[i].loopLength = std::max(static_cast<uint>(looplength), executionSettings->programSettings->minLoopLength);
+    }
+    if (mpi_comm_rank == 0) {
+        std::cout << " done!" << std::endl;
+    }
+}
+
 void
 network::NetworkBenchmark::collectAndPrintResults(const network::NetworkExecutionTimings &output) {
     std::vector<double> maxBandwidths;
 
+    if (executionSettings->programSettings->latencyMode) {
+        collectAndPrintLatencies(output);
+        return;
+    }
+
     if (mpi_comm_rank == 0) {
         std::cout << std::setw(ENTRY_SPACE) << "MSize" << "   "
                 << std::setw(ENTRY_SPACE) << "looplength" << "   "
@@ -178,9 +356,12 @@ network::NetworkBenchmark::collectAndPrintResults(const network::NetworkExecutio
             totalMaxMinCalculationTime.push_back(0.0);
         }
         int i = 0;
+        // Timings of all repetitions for every message size. The statistics are printed after the table.
+        std::map<std::string, std::vector<double>> repetitionTimes;
         for (const auto& msgSizeResults : output.timings) {
             for (const auto& r : *msgSizeResults.second) {
-                double localMinCalculationTime = *min_element(r->calculationTimings.begin(), r->calculationTimings.end());
+                std::vector<double> measured = discardWarmup(r->calculationTimings);
+                double localMinCalculationTime = *min_element(measured.begin(), measured.end());
                 totalMaxMinCalculationTime[i] = std::max(totalMaxMinCalculationTime[i], localMinCalculationTime);
             }
             i++;
@@ -189,27 +370,132 @@ network::NetworkBenchmark::collectAndPrintResults(const network::NetworkExecutio
         for (const auto& msgSizeResults : output.timings) {
             int looplength = msgSizeResults.second->at(0)->looplength;
             // The total sent data in bytes will be:
-            // #Nodes * message_size * looplength * 2
+            // #Nodes * sent_bytes_per_message * looplength * 2
             // the * 2 is because we have two kernels per bitstream that will send and receive simultaneously.
+            // The sent bytes per message are the message size except for all-to-all, where a message is sent to every rank.
             // This will be divided by half of the maximum of the minimum measured runtime over all ranks.
-            double maxCalcBW = static_cast<double>(msgSizeResults.second->size() * 2 * (1 << msgSizeResults.first) * looplength)
+            double sentBytes = getSentBytesPerMessage(executionSettings->programSettings->pattern, 1 << msgSizeResults.first, msgSizeResults.second->size());
+            double maxCalcBW = static_cast<double>(msgSizeResults.second->size() * 2) * sentBytes * looplength
                                                                 / (totalMaxMinCalculationTime[i]);
 
             maxBandwidths.push_back(maxCalcBW);
 
+            std::string msg_key = std::to_string(1 << msgSizeResults.first);
+            // Time of every repetition is the time of the slowest rank
+            std::vector<double> max_times;
+            for (const auto& r : *msgSizeResults.second) {
+                std::vector<double> measured = discardWarmup(r->calculationTimings);
+                timings[msg_key].insert(timings[msg_key].end(), measured.begin(), measured.end());
+                max_times.resize(measured.size(), 0.0);
+                for (size_t rep = 0; rep < measured.size(); rep++) {
+                    max_times[rep] = std::max(max_times[rep], measured[rep]);
+                }
+            }
+            results.emplace("max_bandwidth_" + msg_key, hpcc_base::HpccResult(maxCalcBW, "B/s"));
+
             std::cout << std::setw(ENTRY_SPACE) << (1 << msgSizeResults.first) << "   "
                     << std::setw(ENTRY_SPACE) << looplength << "   "
                     << std::setw(ENTRY_SPACE) << totalMaxMinCalculationTime[i] << "   "
                     << std::setw(ENTRY_SPACE)  << maxCalcBW
                     << std::endl;
+            repetitionTimes.emplace(msg_key, max_times);
             i++;
         }
 
 
         double b_eff = accumulate(maxBandwidths.begin(), maxBandwidths.end(), 0.0) / static_cast<double>(maxBandwidths.size());
 
+        results.emplace("b_eff", hpcc_base::HpccResult(b_eff, "B/s"));
+
         std::cout << std::endl << "b_eff = " << b_eff << " B/s" << std::endl;
+
+        std::cout << std::endl;
+        for (const auto& t : repetitionTimes) {
+            addStatistics("t_" + t.first, t.second);
+        }
+    }
+}
+
+void
+network::NetworkBenchmark::collectAndPrintLatencies(const network::NetworkExecutionTimings &output) {
+    if (mpi_comm_rank > 0) {
+        return;
+    }
+    std::cout << std::setw(ENTRY_SPACE) << "MSize" << "   "
+            << std::setw(ENTRY_SPACE) << "looplength" << "   "
+            << std::setw(ENTRY_SPACE) << "min" << "   "
+            << std::setw(ENTRY_SPACE) << "median" << "   "
+            << std::setw(ENTRY_SPACE) << "p99" << std::endl;
+    for (const auto& msgSizeResults : output.timings) {
+        // The fastest message over all rank pairs is reported as minimum.
+        // The median and 99th percentile are taken from the slowest pair
+        double min_latency = std::numeric_limits<double>::max();
+        double median_latency = 0.0;
+        double p99_latency = 0.0;
+        bool measured = false;
+        for (const auto& r : *msgSizeResults.second) {
+            if (!r->hasLatencies) {
+                continue;
+            }
+            measured = true;
+            min_latency = std::min(min_latency, r->latencyStatistics.min);
+            median_latency = std::max(median_latency, r->latencyStatistics.median);
+            p99_latency = std::max(p99_latency, r->latencyStatistics.p99);
+        }
+        if (!measured) {
+            continue;
+        }
+        std::string msg_key = std::to_string(1 << msgSizeResults.first);
+        results.emplace("latency_min_" + msg_key, hpcc_base::HpccResult(min_latency, "s"));
+        results.emplace("latency_median_" + msg_key, hpcc_base::HpccResult(median_latency, "s"));
+        results.emplace("latency_p99_" + msg_key, hpcc_base::HpccResult(p99_latency, "s"));
+        std::cout << std::setw(ENTRY_SPACE) << (1 << msgSizeResults.first) << "   "
+                << std::setw(ENTRY_SPACE) << msgSizeResults.second->at(0)->looplength << "   "
+                << std::setw(ENTRY_SPACE) << min_latency << "   "
+                << std::setw(ENTRY_SPACE) << median_latency << "   "
+                << std::setw(ENTRY_SPACE) << p99_latency << std::endl;
+    }
+}
+
+bool
+network::NetworkBenchmark::checkInputParameters() {
+    bool validationResult = true;
+    auto pattern = executionSettings->programSettings->pattern;
+    if (executionSettings->programSettings->latencyMode && isCollectivePattern(pattern)) {
+        std::cerr << "ERROR: The latency mode requires pairs of ranks and can not be used with the pattern " << patternToString(pattern) << "!" << std::endl;
+        validationResult = false;
+    }
+    if (executionSettings->programSettings->communicationType == hpcc_base::CommunicationType::intel_external_channels
+            && pattern != CommunicationPattern::ring) {
+        // The partners of the external channels are defined by the cabling of the boards
+        std::cerr << "ERROR: The external channels only support the pattern " << patternToString(CommunicationPattern::ring) 
+                  << ". Use the communication types CPU or PCIE for other patterns!" << std::endl;
+        validationResult = false;
+    }
+    if (executionSettings->programSettings->pcieConcurrent && (executionSettings->programSettings->latencyMode 
+            || executionSettings->programSettings->pcieZeroCopy || isCollectivePattern(pattern))) {
+        std::cerr << "ERROR: The concurrent PCIe replications can not be combined with the latency mode, zero-copy or collective patterns!" << std::endl;
+        validationResult = false;
+    }
+    if (executionSettings->programSettings->communicationType == hpcc_base::CommunicationType::rdma) {
+        if (!::rdma::isSupported()) {
+            std::cerr << "ERROR: The communication type RDMA requires a runtime with P2P buffer support. Use the communication type PCIE instead!" << std::endl;
+            validationResult = false;
+        }
+        if (executionSettings->programSettings->pcieZeroCopy) {
+            std::cerr << "ERROR: The communication type RDMA always sends from device memory and can not be combined with zero-copy!" << std::endl;
+            validationResult = false;
+        }
+    }
+    return validationResult;
+}
+
+std::vector<std::string>
+network::NetworkBenchmark::getRankScalingArguments(int ranks, bool weak) {
+    if (!weak) {
+        throw std::runtime_error("The messages are sent by every rank, so the strong scaling is not supported");
     }
+    return {};
 }
 
 std::unique_ptr<network::NetworkData>
@@ -26,6 +26,8 @@ SOFTWARE.
 /* C++ standard library headers */
 #include <complex>
 #include <memory>
+#include <map>
+#include <string>
 
 /* Project's headers */
 #include "hpcc_benchmark.hpp"
@@ -37,6 +39,78 @@ SOFTWARE.
  */
 namespace network {
 
+    /**
+     * @brief The communication patterns that can be used to exchange the messages between the ranks
+     * 
+     */
+    enum class CommunicationPattern {
+
+        /**
+         * @brief Exchange messages with both neighbors in a ring. Every kernel replication is paired with one of the neighbors.
+         * 
+         */
+        ring,
+
+        /**
+         * @brief Exchange messages between random pairs of ranks. The pairs are drawn independently for every kernel replication.
+         * 
+         */
+        random_pairs,
+
+        /**
+         * @brief Exchange messages between the two halves of the ranks, so all messages cross the bisection of the network
+         * 
+         */
+        bisection,
+
+        /**
+         * @brief Every rank sends a message of the given size to every rank with MPI_Alltoall
+         * 
+         */
+        all_to_all,
+
+        /**
+         * @brief All ranks reduce a message of the given size with MPI_Allreduce
+         * 
+         */
+        allreduce
+    };
+
+    static const std::map<const std::string, CommunicationPattern> pattern_to_str_map{
+        {"RING", CommunicationPattern::ring},
+        {"RANDOM", CommunicationPattern::random_pairs},
+        {"BISECTION", CommunicationPattern::bisection},
+        {"ALLTOALL", CommunicationPattern::all_to_all},
+        {"ALLREDUCE", CommunicationPattern::allreduce}
+    };
+
+    /**
+     * @brief Serializes a communication pattern into a string. The resulting string can be used with retrieveCommunicationPattern to get back the enum.
+     * 
+     * @param p the communication pattern that should be converted into a string
+     * @return std::string String representation of the communication pattern
+     */
+    std::string
+    patternToString(CommunicationPattern p);
+
+    /**
+     * @brief Deserializes a string into a communication pattern
+     * 
+     * @param pattern_name String serialization of the communication pattern
+     * @return CommunicationPattern the communication pattern. Will throw a runtime error if the string is no valid pattern
+     */
+    CommunicationPattern
+    retrieveCommunicationPattern(std::string pattern_name);
+
+    /**
+     * @brief Check if a communication pattern is a collective operation over all ranks instead of an exchange between pairs of ranks
+     * 
+     * @param p the communication pattern
+     * @return true if the messages are exchanged with a collective MPI operation
+     */
+    bool
+    isCollectivePattern(CommunicationPattern p);
+
     /**
      * @brief This data struct is part of the CollectedResultMap.
      *         It is used to store the measurement results for a single rank
@@ -62,6 +136,26 @@ namespace network {
          * 
          */
         std::vector<double> calculationTimings;
+
+        /**
+         * @brief The one-way latencies of all ping-pong iterations of all repetitions in seconds.
+         *          Only measured in the latency mode by the rank that initiates the ping-pong.
+         * 
+         */
+        std::vector<double> latencies;
+
+        /**
+         * @brief True, if latencyStatistics contains the statistics of the measured latencies of a rank
+         * 
+         */
+        bool hasLatencies;
+
+        /**
+         * @brief Statistics over the measured latencies without the warm-up repetitions. 
+         *          In contrast to the latencies, they are also available for the results collected from other ranks.
+         * 
+         */
+        statistics::Statistics latencyStatistics;
     };
 
     /**
@@ -113,6 +207,39 @@ public:
      */
     uint llDecrease;
 
+    /**
+     * @brief If true, the PCIe communication type sends the messages directly from mapped, host-pinned buffers
+     *          instead of copying them into a separate host buffer
+     * 
+     */
+    bool pcieZeroCopy;
+
+    /**
+     * @brief If true, the PCIe communication type exchanges the messages of all kernel replications concurrently 
+     *          with non-blocking transfers instead of measuring the replications one after another
+     * 
+     */
+    bool pcieConcurrent;
+
+    /**
+     * @brief If true, the one-way latency is measured with ping-pong messages between pairs of ranks instead of the bandwidth
+     * 
+     */
+    bool latencyMode;
+
+    /**
+     * @brief The pattern that is used to exchange the messages between the ranks
+     * 
+     */
+    CommunicationPattern pattern;
+
+    /**
+     * @brief Targeted measurement time per message size in milliseconds that is used to calibrate the loop lengths.
+     *          The calibration is disabled, if it is 0.
+     * 
+     */
+    uint calibrationTarget;
+
     /**
      * @brief Construct a new Network Program Settings object
      * 
@@ -129,6 +256,69 @@ public:
 
 };
 
+/**
+ * @brief Get the rank a kernel replication exchanges messages with. 
+ *          For the ring pattern, neighboring ranks are paired and the pairs are shifted by one for every second replication, so the replications
+ *          communicate with both neighbors in a ring.
+ *          For random pairs, the ranks are shuffled with the same seed on all ranks and consecutive ranks of the permutation are paired.
+ *          For the bisection, rank i of the first half is paired with rank i of the second half.
+ *          If the number of ranks is odd, one rank may be paired with itself.
+ * 
+ * @param rank The rank of the current process
+ * @param size The number of ranks
+ * @param replication The kernel replication
+ * @param pattern The used communication pattern. Must not be a collective pattern.
+ * @return int The rank of the communication partner
+ */
+int
+getCommunicationPartner(int rank, int size, int replication, CommunicationPattern pattern = CommunicationPattern::ring);
+
+/**
+ * @brief Get the number of values that have to be allocated for the message buffers of a communication pattern
+ * 
+ * @param pattern The used communication pattern
+ * @param size_in_bytes Size of a message
+ * @param size The number of ranks
+ * @return cl_uint The required buffer size. All-to-all needs a message for every rank, all other patterns a single message.
+ */
+cl_uint
+getMessageBufferSize(CommunicationPattern pattern, cl_uint size_in_bytes, int size);
+
+/**
+ * @brief Get the number of bytes a single rank sends per exchanged message in a communication pattern.
+ *          This is used to calculate the bandwidth and is the message size for the pairwise patterns and the allreduce,
+ *          and the message size times the number of ranks for all-to-all.
+ * 
+ * @param pattern The used communication pattern
+ * @param size_in_bytes Size of a message
+ * @param size The number of ranks
+ * @return double The number of sent bytes
+ */
+double
+getSentBytesPerMessage(CommunicationPattern pattern, cl_uint size_in_bytes, int size);
+
+/**
+ * @brief Execute a single collective exchange of a message with all ranks in place
+ * 
+ * @param pattern The used communication pattern. Must be a collective pattern.
+ * @param buffer The buffer that contains the message. It has to hold getMessageBufferSize() values and is overwritten with the result.
+ * @param size_in_bytes Size of a message
+ * @param communicator Communicator of the ranks that take part in the collective
+ */
+void
+exchangeCollective(CommunicationPattern pattern, HOST_DATA_TYPE* buffer, cl_uint size_in_bytes, MPI_Comm communicator);
+
+/**
+ * @brief Check if a rank initiates the ping-pong with its communication partner in the latency mode.
+ *          The lower rank of a pair initiates the ping-pong. A rank that is paired with itself sends and receives its own messages.
+ * 
+ * @param rank The rank of the current process
+ * @param partner The rank of the communication partner
+ * @return true if the rank sends the first message
+ */
+bool
+isPingPongInitiator(int rank, int partner);
+
 /**
  * @brief Data class for the network benchmark
  * 
@@ -209,6 +399,10 @@ public:
 
 };
 
+namespace execution_types::pcie {
+    class PcieResourcePool;
+}
+
 /**
  * @brief Implementation of the Network benchmark
  * 
@@ -225,8 +419,45 @@ protected:
     void
     addAdditionalParseOptions(cxxopts::Options &options) override;
 
+    /**
+     * @brief Print the one-way latencies of the latency mode and add them to the results
+     * 
+     * @param output Measured latencies of all ranks
+     */
+    void
+    collectAndPrintLatencies(const NetworkExecutionTimings &output);
+
+    /**
+     * @brief Execute a single run of the benchmark with the selected communication type
+     * 
+     * @param run The data item of the run
+     * @param looplength The number of messages that are sent
+     * @param pciePool The resources that are reused by the PCIe communication type
+     * @return std::shared_ptr<network::ExecutionTimings> The measured timings of the run
+     */
+    std::shared_ptr<network::ExecutionTimings>
+    executeRun(NetworkData::NetworkDataItem &run, cl_uint looplength, execution_types::pcie::PcieResourcePool &pciePool);
+
 public:
 
+    /**
+     * @brief The loop length of the calibration probe is the initial loop length of a run divided by this value
+     * 
+     */
+    static const uint CALIBRATION_PROBE_DIVISOR = 16;
+
+    /**
+     * @brief Adjust the loop lengths of all runs, so every repetition takes approximately the calibration target time.
+     *          A single repetition with a shorter loop length is executed as probe for every message size.
+     *          The slowest probe of all ranks is used for the calculation, which is agreed on with a single collective operation.
+     *          The loop lengths will not be smaller than the minimum loop length.
+     * 
+     * @param data The input and output data of the benchmark. The loop lengths of the items will be modified.
+     * @param pciePool The resources that are reused by the PCIe communication type
+     */
+    void
+    calibrateLoopLengths(NetworkData &data, execution_types::pcie::PcieResourcePool &pciePool);
+
     /**
      * @brief Network specific implementation of the data generation
      * 
@@ -261,6 +492,25 @@ public:
     void
     collectAndPrintResults(const NetworkExecutionTimings &output) override;
 
+    /**
+     * @brief Check if the selected communication pattern can be used with the communication type and mode
+     * 
+     * @return true if the validation is successful, false otherwise
+     */
+    bool
+    checkInputParameters() override;
+
+    /**
+     * @brief Get the arguments for a rank scaling. The message sizes are defined per rank, so only the weak scaling is supported.
+     * 
+     * @param ranks Number of ranks the benchmark will be executed on
+     * @param weak True for the weak scaling
+     * @return std::vector<std::string> No additional arguments, because the settings are kept
+     * @throw std::runtime_error for the strong scaling
+     */
+    std::vector<std::string>
+    getRankScalingArguments(int ranks, bool weak) override;
+
     /**
      * @brief Construct a new Network Benchmark object. This construtor will directly setup
      *          The benchmark suing the given input parameters and the setupBenchmark() method
@@ -5,6 +5,7 @@
 
 #include "gtest/gtest.h"
 #include "network_benchmark.hpp"
+#include "rdma_buffer.hpp"
 #include "parameters.h"
 #include "mpi.h"
 #include "test_program_settings.h"
@@ -297,6 +298,132 @@ TEST_P(NetworkKernelTest, ValidationDataWrongTwoMessageSizesAfterExecution) {
 }
 
 
+/**
+ * Tests if the ping-pong latency is measured for every round trip in the latency mode
+ */
+TEST_P(NetworkKernelTest, LatenciesAreMeasuredInLatencyMode) {
+#ifdef HOST_EMULATION_REORDER
+    if (bm->getExecutionSettings().programSettings->communicationType == hpcc_base::CommunicationType::intel_external_channels) {
+        // The ping-pong requires the concurrent execution of the send and receive kernels
+        GTEST_SKIP();
+    }
+#endif
+    bm->getExecutionSettings().programSettings->latencyMode = true;
+    const unsigned looplength = 4;
+    data->items.clear();
+    data->items.push_back(network::NetworkData::NetworkDataItem(0, looplength));
+    auto result = bm->executeKernel(*data);
+    auto timing = result->timings.find(0)->second->back();
+    EXPECT_EQ(looplength * bm->getExecutionSettings().programSettings->kernelReplications, timing->latencies.size());
+    EXPECT_TRUE(timing->hasLatencies);
+    EXPECT_LE(timing->latencyStatistics.min, timing->latencyStatistics.median);
+    EXPECT_LE(timing->latencyStatistics.median, timing->latencyStatistics.p99);
+    EXPECT_TRUE(bm->validateOutputAndPrintError(*data));
+}
+
+/**
+ * Tests if the ranks are paired consistently and the lower rank initiates the ping-pong
+ */
+TEST(NetworkPartnerTest, PartnersArePairedConsistently) {
+    for (int size : {1, 2, 4, 8}) {
+        for (int replication = 0; replication < 2; replication++) {
+            for (int rank = 0; rank < size; rank++) {
+                int partner = network::getCommunicationPartner(rank, size, replication);
+                EXPECT_EQ(rank, network::getCommunicationPartner(partner, size, replication));
+                if (partner != rank) {
+                    EXPECT_NE(network::isPingPongInitiator(rank, partner), network::isPingPongInitiator(partner, rank));
+                }
+            }
+        }
+    }
+    EXPECT_TRUE(network::isPingPongInitiator(0, 0));
+}
+
+
+/**
+ * Tests if the random pairs and the bisection pair every rank consistently
+ */
+TEST(NetworkPartnerTest, PairwisePatternsArePairedConsistently) {
+    for (auto pattern : {network::CommunicationPattern::random_pairs, network::CommunicationPattern::bisection}) {
+        for (int size : {1, 2, 3, 4, 7, 8}) {
+            for (int replication = 0; replication < 2; replication++) {
+                int self_paired = 0;
+                for (int rank = 0; rank < size; rank++) {
+                    int partner = network::getCommunicationPartner(rank, size, replication, pattern);
+                    EXPECT_LT(partner, size);
+                    EXPECT_EQ(rank, network::getCommunicationPartner(partner, size, replication, pattern));
+                    self_paired += (partner == rank) ? 1 : 0;
+                }
+                EXPECT_EQ(size % 2, self_paired);
+            }
+        }
+    }
+    // The bisection pairs ranks of both halves
+    EXPECT_EQ(4, network::getCommunicationPartner(0, 8, 0, network::CommunicationPattern::bisection));
+    EXPECT_EQ(3, network::getCommunicationPartner(7, 8, 1, network::CommunicationPattern::bisection));
+}
+
+/**
+ * Tests if the collective patterns exchange the messages and keep the validation data intact
+ */
+TEST_P(NetworkKernelTest, CollectivePatternsAreExecutedCorrectly) {
+    if (bm->getExecutionSettings().programSettings->communicationType == hpcc_base::CommunicationType::intel_external_channels) {
+        // The external channels only support the ring pattern
+        GTEST_SKIP();
+    }
+    for (auto pattern : {network::CommunicationPattern::all_to_all, network::CommunicationPattern::allreduce}) {
+        bm->getExecutionSettings().programSettings->pattern = pattern;
+        const unsigned looplength = 4;
+        data->items.clear();
+        data->items.push_back(network::NetworkData::NetworkDataItem(3, looplength));
+        auto result = bm->executeKernel(*data);
+        EXPECT_EQ(bm->getExecutionSettings().programSettings->numRepetitions, result->timings.find(3)->second->back()->calculationTimings.size());
+        EXPECT_TRUE(bm->validateOutputAndPrintError(*data));
+    }
+}
+
+
+/**
+ * Tests if the calibrated loop lengths are used for the measurement
+ */
+TEST_P(NetworkKernelTest, CalibratedLoopLengthIsUsedForMeasurement) {
+    bm->getExecutionSettings().programSettings->calibrationTarget = 1;
+    bm->getExecutionSettings().programSettings->minLoopLength = 2;
+    data->items.clear();
+    data->items.push_back(network::NetworkData::NetworkDataItem(0, 32));
+    auto result = bm->executeKernel(*data);
+    EXPECT_LE(2u, data->items[0].loopLength);
+    EXPECT_EQ(data->items[0].loopLength, result->timings.find(0)->second->back()->looplength);
+    EXPECT_EQ(bm->getExecutionSettings().programSettings->numRepetitions, result->timings.find(0)->second->back()->calculationTimings.size());
+    EXPECT_TRUE(bm->validateOutputAndPrintError(*data));
+}
+
+
+/**
+ * Tests if the replications exchange correct data when they are executed concurrently with PCIe
+ */
+TEST_P(NetworkKernelTest, ConcurrentPcieReplicationsExchangeCorrectData) {
+    if (bm->getExecutionSettings().programSettings->communicationType != hpcc_base::CommunicationType::pcie_mpi) {
+        // The concurrent execution is only implemented for PCIe
+        GTEST_SKIP();
+    }
+    bm->getExecutionSettings().programSettings->pcieConcurrent = true;
+    const unsigned looplength = 4;
+    data->items.clear();
+    data->items.push_back(network::NetworkData::NetworkDataItem(10, looplength));
+    auto result = bm->executeKernel(*data);
+    EXPECT_EQ(bm->getExecutionSettings().programSettings->numRepetitions, result->timings.find(10)->second->back()->calculationTimings.size());
+    EXPECT_TRUE(bm->validateOutputAndPrintError(*data));
+}
+
+TEST_P(NetworkKernelTest, RdmaIsRejectedWithoutP2PSupport) {
+    if (rdma::isSupported()) {
+        GTEST_SKIP();
+    }
+    bm->getExecutionSettings().programSettings->communicationType = hpcc_base::CommunicationType::rdma;
+    EXPECT_FALSE(bm->checkInputParameters());
+}
+
 
 INSTANTIATE_TEST_CASE_P(
         NetworkKernelParametrizedTests,
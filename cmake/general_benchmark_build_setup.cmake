@@ -3,6 +3,9 @@ INCLUDE (CheckTypeSize)
 
 set (CMAKE_CXX_STANDARD 11)
 
+# Has to be set before the dependencies are downloaded, because it requires an additional dependency
+set(USE_REFERENCE_BENCHMARKS No CACHE BOOL "Build microbenchmarks of the host reference implementations that are used for the validation")
+
 # Download build dependencies
 add_subdirectory(${CMAKE_SOURCE_DIR}/../extern ${CMAKE_BINARY_DIR}/extern)
 
@@ -31,6 +34,7 @@ set(USE_MPI ${USE_MPI} CACHE BOOL "Compile the host code with MPI support. This
 set(USE_SVM No CACHE BOOL "Use SVM pointers instead of creating buffers on the board and transferring the data there before execution.")
 set(USE_HBM No CACHE BOOL "Use host code specific to HBM FPGAs")
 set(USE_CUSTOM_KERNEL_TARGETS No CACHE BOOL "Enable build targets for custom kernels")
+set(USE_KERNEL_COUNTERS No CACHE BOOL "Instrument the kernels with cycle and stall counters that are read and printed by the host. Only supported for Intel FPGA")
 set(USE_DEPRECATED_HPP_HEADER ${header_default} CACHE BOOL "Flag that indicates if the old C++ wrapper header should be used (cl.hpp) or the newer version (cl2.hpp or opencl.hpp)")
 set(HPCC_FPGA_CONFIG ${HPCC_FPGA_CONFIG} CACHE FILEPATH "Configuration file that is used to overwrite the default configuration")
 set(NUM_REPLICATIONS 4 CACHE STRING "Number of times the kernels will be replicated")
@@ -114,6 +118,10 @@ if (NOT VITIS_FOUND AND NOT INTELFPGAOPENCL_FOUND)
     message(ERROR "Xilinx Vitis or Intel FPGA OpenCL SDK required!")
 endif()
 
+if (USE_KERNEL_COUNTERS AND NOT INTELFPGAOPENCL_FOUND)
+    message(WARNING "Kernel counters are only supported for Intel FPGA. The Xilinx kernels will not be instrumented!")
+endif()
+
 if (NOT Python3_Interpreter_FOUND)
     message(WARNING "Python 3 interpreter could not be found! It might be necessary to generate the final kernel source code!")
 endif()
@@ -137,6 +145,11 @@ if (COMMUNICATION_TYPE_SUPPORT_ENABLED)
     add_definitions(-DCOMMUNICATION_TYPE_SUPPORT_ENABLED)
 endif()
 
+# Benchmarks without communication between FPGAs use this default to run on the FPGA unless --comm-type CPU is given
+if (DEFINED DEFAULT_COMM_TYPE)
+    add_definitions(-DDEFAULT_COMM_TYPE="${DEFAULT_COMM_TYPE}")
+endif()
+
 # Set OpenCL version that should be used
 set(HPCC_FPGA_OPENCL_VERSION 200 CACHE STRING "OpenCL version that should be used for the host code compilation")
 mark_as_advanced(HPCC_FPGA_OPENCL_VERSION)
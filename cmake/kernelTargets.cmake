@@ -1,5 +1,5 @@
 
-set(COMPILER_INCLUDES "-I${CMAKE_BINARY_DIR}/src/common/" "-I${CMAKE_CURRENT_SOURCE_DIR}")
+set(COMPILER_INCLUDES "-I${CMAKE_BINARY_DIR}/src/common/" "-I${CMAKE_CURRENT_SOURCE_DIR}" "-I${CMAKE_SOURCE_DIR}/../shared/device")
 
 set(Vitis_EMULATION_CONFIG_UTIL $ENV{XILINX_VITIS}/bin/emconfigutil)
 
@@ -69,7 +69,7 @@ function(generate_kernel_targets_xilinx)
 
         if (KERNEL_REPLICATION_ENABLED)
                 add_custom_command(OUTPUT ${source_f}
-                        COMMAND ${Python3_EXECUTABLE} ${CODE_GENERATOR} -o ${source_f} -p num_replications=1 -p num_total_replications=${NUM_REPLICATIONS} ${base_file}
+                        COMMAND ${Python3_EXECUTABLE} ${CODE_GENERATOR} -o ${source_f} -p num_replications=1 -p num_total_replications=${NUM_REPLICATIONS} ${KERNEL_CODE_GENERATION_PARAMETERS} ${base_file}
                         MAIN_DEPENDENCY ${base_file}
                 )
         else()
@@ -143,6 +143,9 @@ function(generate_kernel_targets_intel)
                 if (INTEL_CODE_GENERATION_SETTINGS)
                         list(APPEND codegen_parameters -p "\"use_file('${INTEL_CODE_GENERATION_SETTINGS}')\"")
                 endif()
+                if (KERNEL_CODE_GENERATION_PARAMETERS)
+                        list(APPEND codegen_parameters ${KERNEL_CODE_GENERATION_PARAMETERS})
+                endif()
                 add_custom_command(OUTPUT ${source_f}
                         COMMAND ${Python3_EXECUTABLE} ${CODE_GENERATOR} -o ${source_f} ${codegen_parameters} ${base_file}
                         MAIN_DEPENDENCY ${base_file}
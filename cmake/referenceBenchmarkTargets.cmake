@@ -0,0 +1,25 @@
+# Microbenchmarks of the host reference implementations.
+# They are only built if USE_REFERENCE_BENCHMARKS is enabled. The benchmarks define REFERENCE_BENCHMARK_SOURCES,
+# HOST_EXE_NAME and LIB_NAME like for the unit tests.
+if (USE_REFERENCE_BENCHMARKS)
+include_directories(${CMAKE_BINARY_DIR}/src/common ${CMAKE_SOURCE_DIR}/../shared/tests)
+
+if (INTELFPGAOPENCL_FOUND)
+    include_directories(SYSTEM ${IntelFPGAOpenCL_INCLUDE_DIRS})
+    add_executable(${HOST_EXE_NAME}_reference_benchmark_intel ${REFERENCE_BENCHMARK_SOURCES})
+    target_link_libraries(${HOST_EXE_NAME}_reference_benchmark_intel benchmark::benchmark_main ${LIB_NAME}_intel ${IntelFPGAOpenCL_LIBRARIES} "${OpenMP_CXX_FLAGS}")
+    target_compile_definitions(${HOST_EXE_NAME}_reference_benchmark_intel PRIVATE -DINTEL_FPGA)
+    target_compile_options(${HOST_EXE_NAME}_reference_benchmark_intel PRIVATE "${OpenMP_CXX_FLAGS}")
+    # Only check that the benchmarks can be executed
+    add_test(NAME test_reference_benchmark_intel COMMAND $<TARGET_FILE:${HOST_EXE_NAME}_reference_benchmark_intel> --benchmark_min_time=0.001 WORKING_DIRECTORY ${EXECUTABLE_OUTPUT_PATH})
+endif()
+
+if (Vitis_FOUND)
+    include_directories(SYSTEM ${Vitis_INCLUDE_DIRS})
+    add_executable(${HOST_EXE_NAME}_reference_benchmark_xilinx ${REFERENCE_BENCHMARK_SOURCES})
+    target_link_libraries(${HOST_EXE_NAME}_reference_benchmark_xilinx benchmark::benchmark_main ${LIB_NAME}_xilinx ${Vitis_LIBRARIES} "${OpenMP_CXX_FLAGS}")
+    target_compile_definitions(${HOST_EXE_NAME}_reference_benchmark_xilinx PRIVATE -DXILINX_FPGA)
+    target_compile_options(${HOST_EXE_NAME}_reference_benchmark_xilinx PRIVATE "${OpenMP_CXX_FLAGS}")
+    add_test(NAME test_reference_benchmark_xilinx COMMAND $<TARGET_FILE:${HOST_EXE_NAME}_reference_benchmark_xilinx> --benchmark_min_time=0.001 WORKING_DIRECTORY ${EXECUTABLE_OUTPUT_PATH})
+endif()
+endif()
@@ -0,0 +1,126 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/*
+Device side counters that are used to find out, if a kernel is limited by global memory or by channels.
+
+Every instrumented kernel gets a slot in a small counter buffer in global memory that is given as last kernel argument.
+A slot contains KERNEL_COUNTERS_PER_KERNEL values that are accumulated over all executions of the kernel:
+
+ - KERNEL_COUNTER_CYCLES: Clock cycles between the start and the end of the kernel
+ - KERNEL_COUNTER_ACTIVE: Iterations of the pipelined loops. With an II of 1, this equals the number of cycles without stalls
+ - KERNEL_COUNTER_CHANNEL_STALLS: Cycles in which a channel read or write could not be completed
+
+The remaining cycles are spent waiting for global memory or in the ramp up of the pipelines.
+The clock cycles are counted by an autorun kernel with one compute unit per slot, so KERNEL_COUNTER_SLOTS
+has to be defined before this file is included.
+
+If USE_KERNEL_COUNTERS is not defined, all macros expand to the uninstrumented code.
+The counters are only available for Intel FPGA, because they rely on autorun kernels and non-blocking channels.
+*/
+#ifndef SHARED_DEVICE_KERNEL_COUNTERS_H_
+#define SHARED_DEVICE_KERNEL_COUNTERS_H_
+
+#define KERNEL_COUNTER_CYCLES 0
+#define KERNEL_COUNTER_ACTIVE 1
+#define KERNEL_COUNTER_CHANNEL_STALLS 2
+#define KERNEL_COUNTERS_PER_KERNEL 3
+
+#if defined(USE_KERNEL_COUNTERS) && defined(INTEL_FPGA)
+
+#ifndef KERNEL_COUNTER_SLOTS
+#error "KERNEL_COUNTER_SLOTS has to be defined before kernel_counters.h is included"
+#endif
+
+#pragma OPENCL EXTENSION cl_intel_channels : enable
+
+// Without buffering, a read always returns the current cycle count of the timer
+channel ulong ch_kernel_counter_timer[KERNEL_COUNTER_SLOTS] __attribute__((depth(0)));
+
+/**
+Free running cycle counter for every counter slot
+ */
+__kernel
+__attribute__((max_global_work_dim(0)))
+__attribute__((autorun))
+__attribute__((num_compute_units(KERNEL_COUNTER_SLOTS)))
+void kernel_counter_timer() {
+    ulong cycles = 0;
+    while (1) {
+        write_channel_nb_intel(ch_kernel_counter_timer[get_compute_id(0)], cycles);
+        cycles++;
+    }
+}
+
+// Additional kernel argument for the counter buffer
+#define KERNEL_COUNTERS_ARG , __global ulong* restrict kernel_counters
+
+// Start counting. Has to be called once at the beginning of the kernel
+#define KERNEL_COUNTERS_START(slot) \
+    ulong kernel_counters_active = 0; \
+    ulong kernel_counters_channel_stalls = 0; \
+    ulong kernel_counters_start = read_channel_intel(ch_kernel_counter_timer[slot]); \
+    mem_fence(CLK_CHANNEL_MEM_FENCE | CLK_GLOBAL_MEM_FENCE);
+
+// Read the current cycle count into a variable e.g. to measure a loop nest that is not pipelined
+#define KERNEL_COUNTERS_TIMESTAMP(slot, var) \
+    mem_fence(CLK_CHANNEL_MEM_FENCE | CLK_GLOBAL_MEM_FENCE); \
+    ulong var = read_channel_intel(ch_kernel_counter_timer[slot]); \
+    mem_fence(CLK_CHANNEL_MEM_FENCE | CLK_GLOBAL_MEM_FENCE);
+
+// Add active cycles
+#define KERNEL_COUNTERS_ACTIVE(count) kernel_counters_active += (count);
+
+// Stop counting and accumulate the counters in the counter buffer. Has to be called once at the end of the kernel
+#define KERNEL_COUNTERS_END(slot) \
+    mem_fence(CLK_CHANNEL_MEM_FENCE | CLK_GLOBAL_MEM_FENCE); \
+    ulong kernel_counters_end = read_channel_intel(ch_kernel_counter_timer[slot]); \
+    kernel_counters[(slot) * KERNEL_COUNTERS_PER_KERNEL + KERNEL_COUNTER_CYCLES] += kernel_counters_end - kernel_counters_start; \
+    kernel_counters[(slot) * KERNEL_COUNTERS_PER_KERNEL + KERNEL_COUNTER_ACTIVE] += kernel_counters_active; \
+    kernel_counters[(slot) * KERNEL_COUNTERS_PER_KERNEL + KERNEL_COUNTER_CHANNEL_STALLS] += kernel_counters_channel_stalls;
+
+// Blocking channel accesses that count the cycles in which the access stalls
+#define KERNEL_COUNTERS_WRITE_CHANNEL(ch, value) \
+    while (!write_channel_nb_intel(ch, value)) { kernel_counters_channel_stalls++; }
+
+#define KERNEL_COUNTERS_READ_CHANNEL(var, ch) \
+    { \
+        bool kernel_counters_valid = false; \
+        while (!kernel_counters_valid) { \
+            var = read_channel_nb_intel(ch, &kernel_counters_valid); \
+            kernel_counters_channel_stalls += kernel_counters_valid ? 0 : 1; \
+        } \
+    }
+
+#else
+
+#define KERNEL_COUNTERS_ARG
+#define KERNEL_COUNTERS_START(slot)
+#define KERNEL_COUNTERS_TIMESTAMP(slot, var)
+#define KERNEL_COUNTERS_ACTIVE(count)
+#define KERNEL_COUNTERS_END(slot)
+#define KERNEL_COUNTERS_WRITE_CHANNEL(ch, value) write_channel_intel(ch, value);
+#define KERNEL_COUNTERS_READ_CHANNEL(var, ch) var = read_channel_intel(ch);
+
+#endif
+
+#endif // SHARED_DEVICE_KERNEL_COUNTERS_H_
@@ -0,0 +1,328 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef HPCC_BASE_ASYNC_EXECUTION_H_
+#define HPCC_BASE_ASYNC_EXECUTION_H_
+
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* External libraries */
+#ifdef USE_DEPRECATED_HPP_HEADER
+#include "CL/cl.hpp"
+#else
+#include OPENCL_HPP_HEADER
+#endif
+#ifdef _USE_MPI_
+#include "mpi.h"
+#endif
+
+/* Project's headers */
+#include "setup/fpga_setup.hpp"
+
+/**
+ * @brief Contains an asynchronous execution layer that drives OpenCL commands, MPI requests and host operations
+ *          as a dependency graph. The backends only describe the operations of their pipeline and the dependencies
+ *          between them. The graph starts every operation as soon as its dependencies allow it, so the
+ *          operations overlap as much as possible.
+ *
+ */
+namespace async_execution {
+
+/**
+ * @brief A dependency graph of asynchronous operations.
+ *          OpenCL operations are enqueued as soon as all their dependencies are enqueued. The events of the
+ *          OpenCL dependencies are given as wait list, so the runtime resolves them on the device.
+ *          MPI and host operations are started as soon as all their dependencies are completed.
+ *          Dependencies always have to be added before the operations that depend on them.
+ *
+ */
+class ExecutionGraph {
+
+public:
+
+    /**
+     * @brief Identifier of an operation within the graph
+     *
+     */
+    typedef size_t Node;
+
+    /**
+     * @brief Enqueues an OpenCL command with the given wait list and returns its event.
+     *          The command queue should be flushed, so the command is submitted to the device.
+     *
+     */
+    typedef std::function<cl::Event(const std::vector<cl::Event>&)> DeviceOperation;
+
+#ifdef _USE_MPI_
+    /**
+     * @brief Starts a non-blocking MPI operation and returns its request
+     *
+     */
+    typedef std::function<MPI_Request()> CommunicationOperation;
+#endif
+
+    /**
+     * @brief A blocking operation that is executed on the host
+     *
+     */
+    typedef std::function<void()> HostOperation;
+
+private:
+
+    enum class OperationType {
+        device,
+#ifdef _USE_MPI_
+        communication,
+#endif
+        host
+    };
+
+    struct Operation {
+        OperationType type;
+        std::vector<Node> dependencies;
+        DeviceOperation device;
+#ifdef _USE_MPI_
+        CommunicationOperation communication;
+        MPI_Request request;
+#endif
+        HostOperation host;
+        cl::Event event;
+        bool started;
+        bool completed;
+    };
+
+    std::vector<Operation> operations;
+
+    Node
+    addOperation(Operation op) {
+        for (Node d : op.dependencies) {
+            if (d >= operations.size()) {
+                throw std::runtime_error("Dependency " + std::to_string(d) + " has to be added to the graph before its dependent operations!");
+            }
+        }
+        op.started = false;
+        op.completed = false;
+        operations.push_back(op);
+        return operations.size() - 1;
+    }
+
+    bool
+    canStart(const Operation &op) const {
+        for (Node d : op.dependencies) {
+            const Operation &dep = operations[d];
+            if (dep.completed) {
+                continue;
+            }
+            // OpenCL operations only have to wait until the OpenCL dependencies are enqueued
+            if (op.type == OperationType::device && dep.type == OperationType::device && dep.started) {
+                continue;
+            }
+            return false;
+        }
+        return true;
+    }
+
+    void
+    start(Operation &op) {
+        switch (op.type) {
+            case OperationType::device: {
+                std::vector<cl::Event> wait_list;
+                for (Node d : op.dependencies) {
+                    if (operations[d].type == OperationType::device) {
+                        wait_list.push_back(operations[d].event);
+                    }
+                }
+                op.event = op.device(wait_list);
+                break;
+            }
+#ifdef _USE_MPI_
+            case OperationType::communication:
+                op.request = op.communication();
+                break;
+#endif
+            case OperationType::host:
+                op.host();
+                op.completed = true;
+                break;
+        }
+        op.started = true;
+    }
+
+    bool
+    updateCompletion(Operation &op) {
+        if (op.type == OperationType::device) {
+            cl_int status;
+            ASSERT_CL(op.event.getInfo(CL_EVENT_COMMAND_EXECUTION_STATUS, &status))
+            if (status < 0) {
+                throw std::runtime_error("OpenCL operation of the execution graph failed with status " + std::to_string(status));
+            }
+            op.completed = (status == CL_COMPLETE);
+        }
+#ifdef _USE_MPI_
+        else if (op.type == OperationType::communication) {
+            int flag = 0;
+            MPI_Test(&op.request, &flag, MPI_STATUS_IGNORE);
+            op.completed = (flag != 0);
+        }
+#endif
+        return op.completed;
+    }
+
+public:
+
+    /**
+     * @brief Add an OpenCL command to the graph
+     *
+     * @param op Function that enqueues the command
+     * @param dependencies Operations that have to be completed before the command is executed
+     * @return Node The identifier of the operation
+     */
+    Node
+    addDeviceOperation(DeviceOperation op, const std::vector<Node> &dependencies = {}) {
+        Operation o;
+        o.type = OperationType::device;
+        o.device = op;
+        o.dependencies = dependencies;
+        return addOperation(o);
+    }
+
+#ifdef _USE_MPI_
+    /**
+     * @brief Add a non-blocking MPI operation to the graph
+     *
+     * @param op Function that starts the operation
+     * @param dependencies Operations that have to be completed before the operation is started
+     * @return Node The identifier of the operation
+     */
+    Node
+    addCommunication(CommunicationOperation op, const std::vector<Node> &dependencies = {}) {
+        Operation o;
+        o.type = OperationType::communication;
+        o.communication = op;
+        o.dependencies = dependencies;
+        return addOperation(o);
+    }
+#endif
+
+    /**
+     * @brief Add a blocking host operation to the graph
+     *
+     * @param op The operation
+     * @param dependencies Operations that have to be completed before the operation is executed
+     * @return Node The identifier of the operation
+     */
+    Node
+    addHostOperation(HostOperation op, const std::vector<Node> &dependencies = {}) {
+        Operation o;
+        o.type = OperationType::host;
+        o.host = op;
+        o.dependencies = dependencies;
+        return addOperation(o);
+    }
+
+    /**
+     * @brief Drive the graph until all operations are started and all MPI and host operations are completed.
+     *          OpenCL commands may still be executed on the device when this function returns.
+     *          Use event() to make later commands depend on them or wait() to wait for them.
+     *
+     */
+    void
+    run() {
+        bool finished = false;
+        while (!finished) {
+            finished = true;
+            bool progress = false;
+            for (auto &op : operations) {
+                if (!op.started && canStart(op)) {
+                    start(op);
+                    progress = true;
+                }
+                if (op.started && !op.completed) {
+                    progress |= updateCompletion(op);
+                }
+                if (!op.started || (!op.completed && op.type != OperationType::device)) {
+                    finished = false;
+                }
+            }
+            if (!finished && !progress) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    /**
+     * @brief Drive the graph until all operations are completed including the OpenCL commands
+     *
+     */
+    void
+    wait() {
+        run();
+        for (auto &op : operations) {
+            if (!op.completed) {
+                ASSERT_CL(op.event.wait())
+                op.completed = true;
+            }
+        }
+    }
+
+    /**
+     * @brief Get the event of an OpenCL operation that was already enqueued
+     *
+     * @param node The identifier of the operation
+     * @return const cl::Event& The event of the command
+     */
+    const cl::Event&
+    event(Node node) const {
+        const Operation &op = operations.at(node);
+        if (op.type != OperationType::device || !op.started) {
+            throw std::runtime_error("Operation " + std::to_string(node) + " is no OpenCL command that is already enqueued!");
+        }
+        return op.event;
+    }
+
+    /**
+     * @brief Check if an operation is completed. The state is updated by run() and wait().
+     *
+     * @param node The identifier of the operation
+     * @return true if the operation is completed
+     */
+    bool
+    isCompleted(Node node) const {
+        return operations.at(node).completed;
+    }
+
+    /**
+     * @brief Get the number of operations in the graph
+     *
+     */
+    size_t
+    size() const {
+        return operations.size();
+    }
+};
+
+} // namespace async_execution
+
+#endif
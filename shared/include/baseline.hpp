@@ -0,0 +1,251 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef HPCC_BASE_BASELINE_H_
+#define HPCC_BASE_BASELINE_H_
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+#include "statistics.hpp"
+
+/**
+ * @brief Contains the comparison of the results of a run with the JSON dump of an earlier run,
+ *          that is used to detect performance regressions
+ *
+ */
+namespace baseline {
+
+/**
+ * @brief The coefficient of variation of both runs is multiplied with this factor to get the variation
+ *          that is still accepted for a metric
+ *
+ */
+const double VARIATION_FACTOR = 3.0;
+
+/**
+ * @brief Keys of the settings map that do not change the measurement and may differ from the baseline
+ *
+ */
+const std::vector<std::string> IGNORED_SETTINGS = {"Baseline", "Trace File"};
+
+/**
+ * @brief Comparison of a single metric with the baseline
+ *
+ */
+struct MetricComparison {
+
+    /**
+     * @brief Name of the metric e.g. gflops
+     *
+     */
+    std::string name;
+
+    /**
+     * @brief Unit of the metric
+     *
+     */
+    std::string unit;
+
+    /**
+     * @brief Value of the metric in the baseline
+     *
+     */
+    double baseline;
+
+    /**
+     * @brief Value of the metric in the current run. NaN, if the metric is missing in the current run
+     *
+     */
+    double value;
+
+    /**
+     * @brief Relative change of the value compared to the baseline. Positive values are improvements.
+     *
+     */
+    double change;
+
+    /**
+     * @brief Accepted relative degradation of the metric
+     *
+     */
+    double tolerance;
+
+    /**
+     * @brief True, if the metric did not degrade by more than the tolerance
+     *
+     */
+    bool passed;
+};
+
+/**
+ * @brief Check, if higher values of a metric with the given unit are better.
+ *          Rates like GFLOP/s, B/s or GFLOP/s/W are higher-is-better, times, energies and all other units lower-is-better.
+ *
+ * @param unit The unit of the metric
+ * @return true if the metric is a rate
+ */
+inline bool
+isHigherBetter(const std::string &unit) {
+    return unit.find('/') != std::string::npos;
+}
+
+/**
+ * @brief Check, if a metric is compared with the baseline. Metrics without a unit like the scaling efficiency
+ *          and the standard deviation and coefficient of variation, that describe the variation itself, are skipped.
+ *
+ * @param name Name of the metric
+ * @param unit Unit of the metric
+ * @return true if the metric is compared
+ */
+inline bool
+isCompared(const std::string &name, const std::string &unit) {
+    auto ends_with = [&name](const std::string &suffix) {
+        return name.size() >= suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+    return !unit.empty() && !ends_with("_stddev") && !ends_with("_cv");
+}
+
+/**
+ * @brief Get the highest coefficient of variation of all measurement series of a run
+ *
+ * @param timings The timings of the JSON dump. Every key contains the measurements of all repetitions as array.
+ *          Series with less than two measurements are skipped.
+ * @return double The highest coefficient of variation or 0, if no series contains multiple measurements
+ */
+inline double
+maxVariation(const nlohmann::json &timings) {
+    double cv = 0.0;
+    for (const auto &t : timings) {
+        std::vector<double> values;
+        for (const auto &v : t) {
+            if (v.is_number()) {
+                values.push_back(v.get<double>());
+            }
+        }
+        if (values.size() > 1) {
+            cv = std::max(cv, statistics::computeStatistics(values).cv);
+        }
+    }
+    return cv;
+}
+
+/**
+ * @brief Get the settings that differ between the current run and the baseline
+ *
+ * @param current The settings map of the current run as JSON object
+ * @param reference The settings map of the baseline
+ * @return std::vector<std::string> Names of all settings that differ or are only contained in one of the runs
+ */
+inline std::vector<std::string>
+settingsDifferences(const nlohmann::json &current, const nlohmann::json &reference) {
+    std::vector<std::string> differences;
+    auto ignored = [](const std::string &key) {
+        return std::find(IGNORED_SETTINGS.begin(), IGNORED_SETTINGS.end(), key) != IGNORED_SETTINGS.end();
+    };
+    for (auto it = current.begin(); it != current.end(); ++it) {
+        if (!ignored(it.key()) && (!reference.contains(it.key()) || reference[it.key()] != it.value())) {
+            differences.push_back(it.key());
+        }
+    }
+    for (auto it = reference.begin(); it != reference.end(); ++it) {
+        if (!ignored(it.key()) && !current.contains(it.key())) {
+            differences.push_back(it.key());
+        }
+    }
+    return differences;
+}
+
+/**
+ * @brief Compare all metrics of the baseline with the current run.
+ *          The accepted degradation of a metric is the larger value of the tolerance and the combined variation of both runs
+ *          multiplied with VARIATION_FACTOR. Metrics that are only contained in the current run are not compared.
+ *
+ * @param current The results of the current run as JSON object with a value and unit for every metric
+ * @param reference The results of the baseline in the same format
+ * @param tolerance Accepted relative degradation e.g. 0.05 for 5%
+ * @param variation Combined coefficient of variation of both runs
+ * @return std::vector<MetricComparison> The comparison of every compared metric of the baseline
+ */
+inline std::vector<MetricComparison>
+compareResults(const nlohmann::json &current, const nlohmann::json &reference, double tolerance, double variation) {
+    std::vector<MetricComparison> comparisons;
+    double accepted = std::max(tolerance, VARIATION_FACTOR * variation);
+    for (auto it = reference.begin(); it != reference.end(); ++it) {
+        std::string unit = it.value().value("unit", "");
+        if (!isCompared(it.key(), unit) || !it.value().contains("value") || !it.value()["value"].is_number()) {
+            continue;
+        }
+        MetricComparison c = {it.key(), unit, it.value()["value"].get<double>(),
+                                std::numeric_limits<double>::quiet_NaN(), 0.0, accepted, false};
+        if (current.contains(it.key()) && current[it.key()].contains("value") && current[it.key()]["value"].is_number()) {
+            c.value = current[it.key()]["value"].get<double>();
+            if (c.baseline != 0.0) {
+                c.change = (c.value - c.baseline) / std::abs(c.baseline);
+            }
+            else if (c.value != 0.0) {
+                c.change = std::numeric_limits<double>::infinity();
+            }
+            if (!isHigherBetter(unit)) {
+                c.change = -c.change;
+            }
+            c.passed = c.change >= -accepted;
+        }
+        comparisons.push_back(c);
+    }
+    return comparisons;
+}
+
+/**
+ * @brief Load the JSON dump of an earlier run
+ *
+ * @param path Path to a file created with --dump-json
+ * @return nlohmann::json The content of the file
+ * @throw std::runtime_error if the file can not be read or does not contain the results
+ */
+inline nlohmann::json
+loadBaseline(const std::string &path) {
+    std::ifstream fs(path);
+    if (!fs.is_open()) {
+        throw std::runtime_error("Baseline file could not be opened: " + path);
+    }
+    nlohmann::json j;
+    try {
+        fs >> j;
+    }
+    catch (const nlohmann::json::exception &e) {
+        throw std::runtime_error("Baseline file could not be parsed: " + path + ": " + e.what());
+    }
+    if (!j.is_object() || !j.contains("results") || !j["results"].is_object()) {
+        throw std::runtime_error("Baseline file does not contain results: " + path);
+    }
+    return j;
+}
+
+} // namespace baseline
+
+#endif
@@ -22,7 +22,10 @@ SOFTWARE.
 #ifndef HPCC_BASE_COMMUNICATION_TYPES_H_
 #define HPCC_BASE_COMMUNICATION_TYPES_H_
 
+#ifndef DEFAULT_COMM_TYPE
+// Can be overwritten by benchmarks that do not encode the communication type in the kernel file name
 #define DEFAULT_COMM_TYPE "AUTO"
+#endif
 
 #include <map>
 
@@ -47,7 +50,15 @@ typedef enum _CommunicationType {
     pcie_mpi,
 
     /**
-     * @brief Communcation using the Streaming Message Interface
+     * @brief Send the data via MPI directly from device buffers that are mapped to the PCIe BAR of the FPGA.
+     *          Uses the same bitstreams as pcie_mpi, but requires a peer-to-peer capable device and MPI library.
+     * 
+     */
+    rdma,
+
+    /**
+     * @brief Communcation using the Streaming Message Interface.
+     *          Reserved for a future backend, the benchmark setup fails if it is selected.
      * 
      */
     smi,
@@ -75,6 +86,7 @@ typedef enum _CommunicationType {
 static const std::map<const std::string, CommunicationType> comm_to_str_map{ 
     {"IEC", CommunicationType::intel_external_channels}, 
     {"PCIE", CommunicationType::pcie_mpi},
+    {"RDMA", CommunicationType::rdma},
 	{"SMI", CommunicationType::smi},
     {"CPU", CommunicationType::cpu_only},
     {"UNSUPPORTED", CommunicationType::unsupported},
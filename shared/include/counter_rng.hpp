@@ -0,0 +1,93 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef HPCC_BASE_COUNTER_RNG_H_
+#define HPCC_BASE_COUNTER_RNG_H_
+
+#include <array>
+#include <cstdint>
+
+/**
+ * @brief Contains a counter-based pseudo random number generator (Philox4x32-10 by Salmon et al.).
+ *          Every random number is a pure function of a key and a counter. So the input data can be generated in
+ *          parallel and in any order and the generated values do not depend on the number of threads or ranks.
+ *
+ */
+namespace rng {
+
+/**
+ * @brief Calculate a block of 4 random 32 bit integers with ten rounds of Philox4x32
+ *
+ * @param counter The counter, e.g. the index of the generated element
+ * @param key The key, e.g. the seed of the data set
+ * @return std::array<uint32_t, 4> The random bits for the counter
+ */
+inline std::array<uint32_t, 4>
+philox4x32(std::array<uint32_t, 4> counter, std::array<uint32_t, 2> key) {
+    const uint64_t multiplier0 = 0xD2511F53u;
+    const uint64_t multiplier1 = 0xCD9E8D57u;
+    for (int round = 0; round < 10; round++) {
+        uint64_t product0 = multiplier0 * counter[0];
+        uint64_t product1 = multiplier1 * counter[2];
+        counter = {{static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ key[0], static_cast<uint32_t>(product1),
+                    static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ key[1], static_cast<uint32_t>(product0)}};
+        key[0] += 0x9E3779B9u;
+        key[1] += 0xBB67AE85u;
+    }
+    return counter;
+}
+
+/**
+ * @brief Get a uniformly distributed random number in [0,1) for an element of a data set.
+ *          The number only depends on the given parameters.
+ *
+ * @param seed Seed of the data set
+ * @param stream Identifies the array of the data set, e.g. 0 for matrix A and 1 for matrix B
+ * @param index Global index of the element in the array
+ * @return double A random number in [0,1) with 53 random bits
+ */
+inline double
+uniform(uint64_t seed, uint64_t stream, uint64_t index) {
+    auto bits = philox4x32({{static_cast<uint32_t>(index), static_cast<uint32_t>(index >> 32),
+                            static_cast<uint32_t>(stream), static_cast<uint32_t>(stream >> 32)}},
+                            {{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)}});
+    uint64_t mantissa = ((static_cast<uint64_t>(bits[0]) << 32) | bits[1]) >> 11;
+    return static_cast<double>(mantissa) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * @brief Get a uniformly distributed random number in [min,max) for an element of a data set
+ *
+ * @param seed Seed of the data set
+ * @param stream Identifies the array of the data set
+ * @param index Global index of the element in the array
+ * @param min Lower bound of the range
+ * @param max Upper bound of the range
+ * @return double A random number in [min,max)
+ */
+inline double
+uniform(uint64_t seed, uint64_t stream, uint64_t index, double min, double max) {
+    return min + (max - min) * uniform(seed, stream, index);
+}
+
+} // namespace rng
+
+#endif
@@ -0,0 +1,170 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef HPCC_BASE_DATA_TYPES_H_
+#define HPCC_BASE_DATA_TYPES_H_
+
+#include <algorithm>
+#include <cctype>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/* External libraries */
+#ifdef USE_DEPRECATED_HPP_HEADER
+#include "CL/cl.hpp"
+#else
+#include OPENCL_HPP_HEADER
+#endif
+
+namespace hpcc_base {
+
+/**
+ * @brief This enumeration contains the floating point types that can be selected at runtime by benchmarks
+ *          that implement their host code for multiple data types
+ * 
+ */
+typedef enum _DataType {
+
+    /**
+     * @brief Half precision floating point values
+     * 
+     */
+    half_precision,
+
+    /**
+     * @brief Single precision floating point values
+     * 
+     */
+    single_precision,
+
+    /**
+     * @brief Double precision floating point values
+     * 
+     */
+    double_precision,
+
+    /**
+     * @brief Detect the data type from the kernel arguments of the bitstream
+     * 
+     */
+    automatic
+
+} DataType;
+
+static const std::map<const std::string, DataType> data_type_to_str_map{
+    {"HALF", DataType::half_precision},
+    {"FLOAT", DataType::single_precision},
+    {"DOUBLE", DataType::double_precision},
+    {"AUTO", DataType::automatic}
+    };
+
+/**
+ * @brief Serializes a enum of type DataType into a string. The resulting string can be used with the function retrieveDataType to get back the enum.
+ * 
+ * @param t the data type that should be converted into a string
+ * @return std::string String representation of the data type
+ */
+static std::string dataTypeToString(DataType t) {
+    for (auto& entry : data_type_to_str_map) {
+        if (entry.second == t) {
+            return entry.first;
+        }
+    }
+    throw std::runtime_error("Data type could not be converted to string!");
+}
+
+/**
+ * @brief Deserializes a string into a enum of type DataType. The name is not case sensitive,
+ *          so also the names of the OpenCL scalar types can be used.
+ * 
+ * @param type_name String serialization of the data type
+ * @return DataType the data type. Will throw a runtime error if the name is unknown
+ */
+static DataType retrieveDataType(std::string type_name) {
+    std::transform(type_name.begin(), type_name.end(), type_name.begin(), [](unsigned char c) { return std::toupper(c); });
+    auto result = data_type_to_str_map.find(type_name);
+    if (result != data_type_to_str_map.end()) {
+        return result->second;
+    }
+    throw std::runtime_error("Data type could not be converted from string: " + type_name);
+}
+
+/**
+ * @brief Get the size of a single value of the data type
+ * 
+ * @param t the data type
+ * @return size_t the size of a value in bytes
+ */
+static size_t dataTypeSize(DataType t) {
+    switch (t) {
+        case DataType::half_precision: return 2;
+        case DataType::single_precision: return 4;
+        case DataType::double_precision: return 8;
+        default: throw std::runtime_error("The size of the data type " + dataTypeToString(t) + " is unknown!");
+    }
+}
+
+/**
+ * @brief Detect the data type of the kernels in a program from the type names of their pointer arguments.
+ *          Vector types like float16 are reduced to their scalar type. The first pointer argument
+ *          with a floating point type is used.
+ *          The type names are only available if the bitstream contains the argument information.
+ * 
+ * @param program The program that contains the kernels of the benchmark
+ * @param fallback The data type that is returned, if the type can not be detected
+ * @return DataType the data type of the kernels or the fallback
+ */
+static DataType detectDataType(cl::Program program, DataType fallback) {
+    std::vector<cl::Kernel> kernels;
+    if (program.createKernels(&kernels) != CL_SUCCESS) {
+        return fallback;
+    }
+    for (auto &kernel : kernels) {
+        cl_uint num_args = kernel.getInfo<CL_KERNEL_NUM_ARGS>();
+        for (cl_uint i = 0; i < num_args; i++) {
+            cl_int err;
+            std::string type_name = kernel.getArgInfo<CL_KERNEL_ARG_TYPE_NAME>(i, &err);
+            if (err != CL_SUCCESS) {
+                // All arguments of the bitstream come without type information
+                return fallback;
+            }
+            // The returned string may contain the terminating null character
+            type_name = type_name.c_str();
+            if (type_name.empty() || type_name.back() != '*') {
+                continue;
+            }
+            // Remove the pointer and the vector width, e.g. float16* -> float
+            std::string scalar_name = type_name.substr(0, type_name.find_first_of("0123456789*"));
+            std::transform(scalar_name.begin(), scalar_name.end(), scalar_name.begin(), [](unsigned char c) { return std::toupper(c); });
+            auto result = data_type_to_str_map.find(scalar_name);
+            if (result != data_type_to_str_map.end() && result->second != DataType::automatic) {
+                return result->second;
+            }
+        }
+    }
+    return fallback;
+}
+
+}
+
+#endif
@@ -0,0 +1,276 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef HPCC_BASE_HALF_CONVERSION_H_
+#define HPCC_BASE_HALF_CONVERSION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HALF_CONVERSION_X86
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Contains the bulk conversion between half and single precision values on the host.
+ *          The half precision values are given by their 16 bit representation, so the functions can be used with
+ *          half_float::half of the benchmarks and do not depend on half.hpp.
+ *          The SIMD implementation is selected at runtime: AVX-512 converts 16, F16C 8 values per instruction.
+ *          All implementations round to the nearest even value like half.hpp with the default rounding style.
+ *
+ */
+namespace half_conversion {
+
+/**
+ * @brief Convert a single half precision value to single precision
+ *
+ * @param h The 16 bit representation of the half precision value
+ * @return float The value in single precision
+ */
+inline float
+halfToFloatScalar(uint16_t h) {
+    uint32_t sign = static_cast<uint32_t>(h & 0x8000) << 16;
+    uint32_t exponent = (h >> 10) & 0x1F;
+    uint32_t mantissa = h & 0x3FF;
+    uint32_t bits;
+    if (exponent == 0x1F) {
+        // Infinity and NaN
+        bits = sign | 0x7F800000 | (mantissa << 13);
+    }
+    else if (exponent != 0) {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    }
+    else if (mantissa == 0) {
+        bits = sign;
+    }
+    else {
+        // Normalize the subnormal half precision value
+        exponent = 113;
+        while ((mantissa & 0x400) == 0) {
+            mantissa <<= 1;
+            exponent--;
+        }
+        bits = sign | (exponent << 23) | ((mantissa & 0x3FF) << 13);
+    }
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+/**
+ * @brief Convert a single precision value to half precision with rounding to the nearest even value
+ *
+ * @param f The value in single precision
+ * @return uint16_t The 16 bit representation of the half precision value
+ */
+inline uint16_t
+floatToHalfScalar(float f) {
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+    uint32_t exponent = (bits >> 23) & 0xFF;
+    uint32_t mantissa = bits & 0x7FFFFF;
+    if (exponent == 0xFF) {
+        // Infinity stays infinity, NaN stays a quiet NaN
+        return sign | 0x7C00 | ((mantissa != 0) ? (0x200 | (mantissa >> 13)) : 0);
+    }
+    int half_exponent = static_cast<int>(exponent) - 112;
+    if (half_exponent >= 0x1F) {
+        return sign | 0x7C00;
+    }
+    if (half_exponent <= 0) {
+        if (half_exponent < -10) {
+            // Too small for a subnormal half precision value. Also covers zero.
+            return sign;
+        }
+        // Subnormal half precision value: shift in the implicit bit and round the removed bits
+        mantissa |= 0x800000;
+        uint32_t shift = static_cast<uint32_t>(14 - half_exponent);
+        uint32_t result = mantissa >> shift;
+        uint32_t remainder = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (result & 1))) {
+            result++;
+        }
+        return sign | static_cast<uint16_t>(result);
+    }
+    uint32_t result = (static_cast<uint32_t>(half_exponent) << 10) | (mantissa >> 13);
+    uint32_t remainder = mantissa & 0x1FFF;
+    // A carry into the exponent correctly rounds up to the next power of two or infinity
+    if (remainder > 0x1000 || (remainder == 0x1000 && (result & 1))) {
+        result++;
+    }
+    return sign | static_cast<uint16_t>(result);
+}
+
+#ifdef HALF_CONVERSION_X86
+/**
+ * @brief Convert half to single precision with F16C, 8 values per instruction
+ */
+__attribute__((target("avx,f16c"))) inline void
+halfToFloatF16C(const uint16_t* src, float* dst, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i))));
+    }
+    for (; i < count; i++) {
+        dst[i] = halfToFloatScalar(src[i]);
+    }
+}
+
+/**
+ * @brief Convert single to half precision with F16C, 8 values per instruction
+ */
+__attribute__((target("avx,f16c"))) inline void
+floatToHalfF16C(const float* src, uint16_t* dst, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+    }
+    for (; i < count; i++) {
+        dst[i] = floatToHalfScalar(src[i]);
+    }
+}
+
+/**
+ * @brief Convert half to single precision with AVX-512, 16 values per instruction
+ */
+__attribute__((target("avx512f"))) inline void
+halfToFloatAVX512(const uint16_t* src, float* dst, size_t count) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        // The masked conversions avoid a false maybe-uninitialized warning of GCC for the unmasked intrinsics
+        _mm512_storeu_ps(dst + i, _mm512_maskz_cvtph_ps(0xFFFF, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i))));
+    }
+    halfToFloatF16C(src + i, dst + i, count - i);
+}
+
+/**
+ * @brief Convert single to half precision with AVX-512, 16 values per instruction
+ */
+__attribute__((target("avx512f"))) inline void
+floatToHalfAVX512(const float* src, uint16_t* dst, size_t count) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm512_maskz_cvtps_ph(0xFFFF, _mm512_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+    }
+    floatToHalfF16C(src + i, dst + i, count - i);
+}
+#endif
+
+/**
+ * @brief Function used for the conversion of half to single precision
+ *
+ */
+typedef void (*half_to_float_t)(const uint16_t*, float*, size_t);
+
+/**
+ * @brief Function used for the conversion of single to half precision
+ *
+ */
+typedef void (*float_to_half_t)(const float*, uint16_t*, size_t);
+
+/**
+ * @brief Convert half to single precision without SIMD instructions
+ */
+inline void
+halfToFloatFallback(const uint16_t* src, float* dst, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = halfToFloatScalar(src[i]);
+    }
+}
+
+/**
+ * @brief Convert single to half precision without SIMD instructions
+ */
+inline void
+floatToHalfFallback(const float* src, uint16_t* dst, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        dst[i] = floatToHalfScalar(src[i]);
+    }
+}
+
+/**
+ * @brief Select the fastest conversion from half to single precision that is supported by the CPU
+ */
+inline half_to_float_t
+selectHalfToFloat() {
+#ifdef HALF_CONVERSION_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return halfToFloatAVX512;
+    }
+    // All CPUs that support AVX2 also support F16C
+    if (__builtin_cpu_supports("avx2")) {
+        return halfToFloatF16C;
+    }
+#endif
+    return halfToFloatFallback;
+}
+
+/**
+ * @brief Select the fastest conversion from single to half precision that is supported by the CPU
+ */
+inline float_to_half_t
+selectFloatToHalf() {
+#ifdef HALF_CONVERSION_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return floatToHalfAVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return floatToHalfF16C;
+    }
+#endif
+    return floatToHalfFallback;
+}
+
+/**
+ * @brief Convert an array of half precision values to single precision
+ *
+ * @param src The 16 bit representations of the half precision values
+ * @param dst The converted values
+ * @param count Number of values
+ */
+inline void
+halfToFloat(const uint16_t* src, float* dst, size_t count) {
+    static const half_to_float_t convert = selectHalfToFloat();
+    convert(src, dst, count);
+}
+
+/**
+ * @brief Convert an array of single precision values to half precision with rounding to the nearest even value
+ *
+ * @param src The values in single precision
+ * @param dst The 16 bit representations of the converted values
+ * @param count Number of values
+ */
+inline void
+floatToHalf(const float* src, uint16_t* dst, size_t count) {
+    static const float_to_half_t convert = selectFloatToHalf();
+    convert(src, dst, count);
+}
+
+} // namespace half_conversion
+
+#endif
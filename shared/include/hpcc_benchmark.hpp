@@ -23,6 +23,21 @@ SOFTWARE.
 #define SHARED_HPCC_BENCHMARK_HPP_
 
 #include <memory>
+#include <fstream>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <functional>
+#include <algorithm>
+#include <vector>
+#include <cstring>
+
+/* POSIX headers used to memory-map cached input data */
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 /* External library headers */
 #ifdef USE_DEPRECATED_HPP_HEADER
@@ -37,14 +52,26 @@ SOFTWARE.
 /* Project's headers */
 #include "setup/fpga_setup.hpp"
 #include "cxxopts.hpp"
+#include "nlohmann/json.hpp"
 #include "parameters.h"
 #include "communication_types.hpp"
+#include "data_types.hpp"
+#include "numa_allocation.hpp"
+#include "memory_placement.hpp"
+#include "statistics.hpp"
+#include "power_measurement.hpp"
+#include "soak.hpp"
+#include "baseline.hpp"
+#include "tracing.hpp"
+#include "memory_tracker.hpp"
 
 #define STR_EXPAND(tok) #tok
 #define STR(tok) STR_EXPAND(tok)
 
 #define ENTRY_SPACE 15
 
+using json = nlohmann::json;
+
 /**
  * @brief Contains all classes and functions that are used as basis
  *          for all benchmarks.
@@ -68,6 +95,13 @@ public:
      */
     uint numRepetitions;
 
+    /**
+     * @brief Number of additional repetitions that are executed before the measured repetitions.
+     *          Their measurements are discarded.
+     * 
+     */
+    uint warmupRepetitions;
+
     /**
      * @brief Boolean showing if memory interleaving is used that is 
      *          triggered from the host side (Intel specific)
@@ -96,6 +130,98 @@ public:
      */
     int defaultDevice;
 
+    /**
+     * @brief Number of devices that are used by every rank. 
+     *          The devices are selected consecutively starting from the default device
+     * 
+     */
+    uint devicesPerRank;
+
+    /**
+     * @brief Skip the reconfiguration of the FPGA, if it is already configured with the given kernel file
+     * 
+     */
+    bool reuseBitstream;
+
+    /**
+     * @brief Definition of a parameter sweep that is executed within the same process.
+     *          Empty, if a single configuration is executed
+     * 
+     */
+    std::string sweep;
+
+    /**
+     * @brief True, if the benchmark is executed for 1 up to the given number of kernel replications within the same process
+     * 
+     */
+    bool scaleReplications;
+
+    /**
+     * @brief Name of the result that is used to calculate the parallel efficiency of the replication scaling.
+     *          Empty, if the first result given as a rate is used
+     * 
+     */
+    std::string scalingMetric;
+
+    /**
+     * @brief Type of the rank scaling that executes the benchmark on sub-communicators of 1, 4, 16, ... ranks.
+     *          STRONG, WEAK or BOTH. Empty, if the rank scaling is disabled
+     * 
+     */
+    std::string scaleRanks;
+
+    /**
+     * @brief Name of the source that is used to sample the board power during the kernel execution.
+     *          Empty, if the power is not measured
+     * 
+     */
+    std::string powerSource;
+
+    /**
+     * @brief Time between two power samples in milliseconds
+     * 
+     */
+    uint powerInterval;
+
+    /**
+     * @brief Wall-clock duration of the soak mode in seconds. The kernel execution is repeated until the duration is reached.
+     *          0, if the soak mode is disabled
+     * 
+     */
+    uint soakDuration;
+
+    /**
+     * @brief Path to the CSV or Prometheus textfile the soak samples are written to. Empty, if the samples are only printed
+     * 
+     */
+    std::string soakFile;
+
+    /**
+     * @brief Name of the result that is monitored in the soak mode. Empty, if the first result given as a rate is used
+     * 
+     */
+    std::string soakMetric;
+
+    /**
+     * @brief Allowed drop of the monitored result in percent compared to the first soak iteration
+     * 
+     */
+    double soakThreshold;
+
+    /**
+     * @brief Name of the source that is used to read the board temperature in the soak mode.
+     *          Empty, if the temperature is not measured
+     * 
+     */
+    std::string temperatureSource;
+
+    /**
+     * @brief Path to the file the timeline of the host, MPI and device activity is written to in the Chrome trace format.
+     *          Empty, if no trace should be recorded
+     * 
+     */
+    std::string traceFile;
+
     /**
      * @brief Path to the kernel file that is used for execution
      * 
@@ -114,18 +240,81 @@ public:
      */
     bool testOnly;
 
+    /**
+     * @brief Only estimate the host and device memory of the given configuration and compare it to the available memory.
+     *          No data is generated and the kernel is not executed.
+     * 
+     */
+    bool dryRunMemory;
+
     /**
      * @brief Type of inter-FPGA communication used
      * 
      */
     CommunicationType communicationType;
 
+    /**
+     * @brief Path to the file the configuration and measurement results will be dumped to in JSON format.
+     *          Empty, if no dump should be created
+     * 
+     */
+    std::string dumpfilePath;
+
+    /**
+     * @brief Path to the JSON dump of an earlier run the results are compared to.
+     *          Empty, if the results should not be compared
+     * 
+     */
+    std::string baselineFile;
+
+    /**
+     * @brief Accepted degradation of a metric compared to the baseline in percent
+     * 
+     */
+    double baselineTolerance;
+
+    /**
+     * @brief Directory that is used to store generated input data and load it in later runs with the same configuration.
+     *          Empty, if the input data should always be generated
+     * 
+     */
+    std::string dataCachePath;
+
+    /**
+     * @brief NUMA node the host buffers of the benchmark data are bound to. 
+     *          -1 will use the node of the selected device, if it can be detected. Other negative values disable the binding.
+     * 
+     */
+    int numaNode;
+
+    /**
+     * @brief Size of the huge pages in MiB that are used for the host buffers of the benchmark data.
+     *          0, if normal pages are used.
+     * 
+     */
+    uint hugepageSize;
+
+    /**
+     * @brief Map from the buffers of the kernel replications to the memory banks of the device e.g. HBM pseudo-channels.
+     *          Empty, if the runtime decides about the placement
+     * 
+     */
+    placement::BankMap memoryBanks;
+
+    /**
+     * @brief Number of ranks of the communicator the benchmark is executed on.
+     *          It is smaller than the size of MPI_COMM_WORLD in a rank scaling. 0, if MPI is not used
+     *
+     */
+    int mpiRanks = 0;
+
     /**
      * @brief Construct a new Base Settings object
      * 
      * @param results The resulting map from parsing the program input parameters
      */
     BaseSettings(cxxopts::ParseResult &results) : numRepetitions(results["n"].as<uint>()),
+            warmupRepetitions(results["warmup"].as<uint>()),
 #ifdef INTEL_FPGA
             useMemoryInterleaving(static_cast<bool>(results.count("i"))), 
 #else
@@ -134,9 +323,25 @@ public:
             skipValidation(static_cast<bool>(results.count("skip-validation"))), 
             defaultPlatform(results["platform"].as<int>()),
             defaultDevice(results["device"].as<int>()),
+            devicesPerRank(results["devices-per-rank"].as<uint>()),
+            reuseBitstream(static_cast<bool>(results.count("reuse-bitstream"))),
+            sweep(results["sweep"].as<std::string>()),
+            scaleReplications(static_cast<bool>(results.count("scale-replications"))),
+            scalingMetric(results["scaling-metric"].as<std::string>()),
+            scaleRanks(results["scale-ranks"].as<std::string>()),
+            powerSource(results["power-source"].as<std::string>()),
+            powerInterval(results["power-interval"].as<uint>()),
+            soakDuration(results["soak"].as<uint>()),
+            soakFile(results["soak-file"].as<std::string>()),
+            soakMetric(results["soak-metric"].as<std::string>()),
+            soakThreshold(results["soak-threshold"].as<double>()),
+            temperatureSource(results["temperature-source"].as<std::string>()),
+            traceFile(results["trace"].as<std::string>()),
             kernelFileName(results["f"].as<std::string>()),
 #ifdef NUM_REPLICATIONS
-            kernelReplications(results.count("r") > 0 ? results["r"].as<uint>() : NUM_REPLICATIONS),
+            // The default of the option is used, so the constructor does not depend on the replications of a specific
+            // benchmark when multiple benchmarks are linked into the suite
+            kernelReplications(results["r"].as<uint>()),
 #else
             kernelReplications(results.count("r") > 0 ? results["r"].as<uint>() : 1),
 #endif
@@ -145,158 +350,1414 @@ public:
 #else
             communicationType(retrieveCommunicationType("UNSUPPORTED", results["f"].as<std::string>())),
 #endif
-            testOnly(static_cast<bool>(results.count("test"))) {}
+            testOnly(static_cast<bool>(results.count("test"))),
+            dryRunMemory(static_cast<bool>(results.count("dry-run-memory"))),
+            dumpfilePath(results["dump-json"].as<std::string>()),
+            baselineFile(results["baseline"].as<std::string>()),
+            baselineTolerance(results["baseline-tolerance"].as<double>()),
+            dataCachePath(results["data-cache"].as<std::string>()),
+            numaNode(results["numa-node"].as<int>()),
+            hugepageSize(results["hugepages"].as<uint>()),
+            memoryBanks(results["memory-banks"].as<std::string>()) {
+#ifdef _USE_MPI_
+        MPI_Comm_size(MPI_COMM_WORLD, &mpiRanks);
+#endif
+    }
+
+    /**
+     * @brief Get a map of the settings. This map will be used to print the final configuration.
+     *          Derived classes should override it to add additional configuration options
+     * 
+     * @return std::map<std::string,std::string> 
+     */
+    virtual std::map<std::string,std::string> getSettingsMap() {
+    std::string str_mpi_ranks = "None";
+    if (mpiRanks > 0) {
+        str_mpi_ranks = std::to_string(mpiRanks);
+    }
+        return {{"Repetitions", std::to_string(numRepetitions)}, {"Warm-up Repetitions", std::to_string(warmupRepetitions)},
+                {"Kernel Replications", std::to_string(kernelReplications)}, 
+                {"Kernel File", kernelFileName}, {"MPI Ranks", str_mpi_ranks}, {"Test Mode", testOnly ? "Yes" : "No"},
+                {"Memory Dry Run", dryRunMemory ? "Yes" : "No"},
+                {"Communication Type", commToString(communicationType)},
+                {"NUMA Node", (numaNode >= 0) ? std::to_string(numaNode) : "None"},
+                {"Hugepages", (hugepageSize > 0) ? std::to_string(hugepageSize) + " MiB" : "No"},
+                {"Memory Banks", memoryBanks.toString()},
+                {"Devices per Rank", std::to_string(devicesPerRank)},
+                {"Reuse Bitstream", reuseBitstream ? "Yes" : "No"},
+                {"Sweep", sweep.empty() ? "None" : sweep},
+                {"Replication Scaling", scaleReplications ? "Yes" : "No"},
+                {"Rank Scaling", scaleRanks.empty() ? "No" : scaleRanks},
+                {"Power Source", powerSource.empty() ? "None" : powerSource + " (" + std::to_string(powerInterval) + " ms)"},
+                {"Soak Duration", (soakDuration > 0) ? std::to_string(soakDuration) + " s" : "No"},
+                {"Trace File", traceFile.empty() ? "None" : traceFile},
+                {"Baseline", baselineFile.empty() ? "None" : baselineFile}};
+    }
+
+};
+
+
+/**
+ * @brief A single derived result of a benchmark execution like a bandwidth or a FLOP rate
+ *          together with its unit. It is used to dump the results in a machine-readable format.
+ * 
+ */
+class HpccResult {
+
+public:
+
+    /**
+     * @brief The value of the result
+     * 
+     */
+    double value;
+
+    /**
+     * @brief The unit of the value e.g. GFLOP/s or s. Empty for values without unit
+     * 
+     */
+    std::string unit;
+
+    /**
+     * @brief Construct a new Hpcc Result object
+     * 
+     * @param value_ The value of the result
+     * @param unit_ The unit of the value
+     */
+    HpccResult(double value_, std::string unit_) : value(value_), unit(unit_) {}
+
+    /**
+     * @brief Convert the result to a JSON object with the keys "value" and "unit"
+     * 
+     * @return json The result as JSON object
+     */
+    json
+    toJson() const {
+        json j;
+        j["value"] = value;
+        j["unit"] = unit;
+        return j;
+    }
+
+};
+
+/**
+ * @brief A contiguous memory region that is part of the input data of a benchmark.
+ *          It is used to store and load the input data from the data cache.
+ * 
+ */
+struct DataRegion {
+
+    /**
+     * @brief Pointer to the first byte of the region
+     * 
+     */
+    void* ptr;
+
+    /**
+     * @brief Size of the region in bytes
+     * 
+     */
+    size_t size;
+};
+
+/**
+ * @brief Parse the definition of a parameter sweep
+ * 
+ * @param sweep The sweep in the format option=values. The values can be given as comma separated list e.g. s=1024,2048
+ *              or as range start:end:step e.g. s=1024:4096:1024. If the step starts with x, the values are multiplied 
+ *              instead e.g. s=1024:8192:x2. The end of a range is included.
+ * @return std::pair<std::string, std::vector<std::string>> The name of the option and all values in the order they are executed
+ */
+inline std::pair<std::string, std::vector<std::string>>
+parseSweep(const std::string &sweep) {
+    size_t pos = sweep.find('=');
+    if (pos == std::string::npos || pos == 0 || pos == sweep.size() - 1) {
+        throw std::runtime_error("Invalid sweep definition, expected option=values: " + sweep);
+    }
+    std::string option = sweep.substr(0, pos);
+    std::string values_str = sweep.substr(pos + 1);
+    std::vector<std::string> values;
+    if (values_str.find(':') == std::string::npos) {
+        std::stringstream ss(values_str);
+        std::string value;
+        while (std::getline(ss, value, ',')) {
+            if (!value.empty()) {
+                values.push_back(value);
+            }
+        }
+    }
+    else {
+        long long start, end, step;
+        bool multiply = false;
+        char sep1 = 0, sep2 = 0;
+        std::stringstream ss(values_str);
+        ss >> start >> sep1 >> end >> sep2;
+        if (ss.peek() == 'x') {
+            multiply = true;
+            ss.get();
+        }
+        ss >> step;
+        if (ss.fail() || !ss.eof() || sep1 != ':' || sep2 != ':' || (multiply ? (step < 2 || start < 1) : step < 1)) {
+            throw std::runtime_error("Invalid sweep range, expected start:end:step or start:end:xfactor: " + values_str);
+        }
+        for (long long v = start; v <= end; v = multiply ? v * step : v + step) {
+            values.push_back(std::to_string(v));
+        }
+    }
+    if (values.empty()) {
+        throw std::runtime_error("Sweep does not contain any values: " + sweep);
+    }
+    return {option, values};
+}
+
+/**
+ * @brief Calculate the parallel efficiency of a replication count compared to a single replication
+ *
+ * @param value The throughput measured with the given number of replications
+ * @param reference The throughput measured with a single replication
+ * @param replications The number of used replications
+ * @return double 1.0 for perfect linear scaling
+ */
+inline double
+parallelEfficiency(double value, double reference, unsigned replications) {
+    return value / (reference * replications);
+}
+
+/**
+ * @brief Check if all points of a rank scaling are validated on this rank.
+ *          A rank only validates the points it takes part in, so the other points are ignored.
+ *
+ * @param participated True for every point the rank was part of the sub-communicator
+ * @param validated The validation result of every point on this rank
+ * @return true if all points the rank took part in are validated
+ */
+inline bool
+rankScalingValidated(const std::vector<bool> &participated, const std::vector<bool> &validated) {
+    for (size_t i = 0; i < validated.size(); i++) {
+        if (participated[i] && !validated[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Settings class that is containing the program settings together with
+ *          additional information about the OpenCL runtime
+ * 
+ * @tparam TSettings The program settings class that should be used (Must derive from BaseSettings)
+ */
+template <class TSettings>
+class ExecutionSettings {
+public:
+
+    /**
+     * @brief Pointer to the additional program settings
+     * 
+     */
+    std::unique_ptr<TSettings> programSettings;
+
+    /**
+     * @brief The OpenCL device that should be used for execution
+     * 
+     */
+    std::unique_ptr<cl::Device> device;
+
+    /**
+     * @brief The OpenCL context that should be used for execution
+     * 
+     */
+    std::unique_ptr<cl::Context> context;
+
+    /**
+     * @brief The OpenCL program that contains the benchmark kernel
+     * 
+     */
+    std::unique_ptr<cl::Program> program;
+
+    /**
+     * @brief All OpenCL devices used by this rank. The first device is the same as device.
+     *          Empty, if no device was selected in test mode.
+     * 
+     */
+    std::vector<cl::Device> devices;
+
+    /**
+     * @brief The OpenCL contexts of all used devices in the same order as devices
+     * 
+     */
+    std::vector<cl::Context> contexts;
+
+    /**
+     * @brief The OpenCL programs of all used devices in the same order as devices
+     * 
+     */
+    std::vector<cl::Program> programs;
+
+#ifdef _USE_MPI_
+    /**
+     * @brief Communicator of the ranks that execute the benchmark. It is MPI_COMM_WORLD, unless the benchmark
+     *          is executed on a sub-communicator in a rank scaling. All communication of the benchmark uses this communicator.
+     * 
+     */
+    MPI_Comm communicator = MPI_COMM_WORLD;
+#endif
+
+    /**
+     * @brief Construct a new Execution Settings object
+     * 
+     * @param programSettings_ Pointer to an existing program settings object that is derived from BaseSettings
+     * @param device_ Used OpenCL device
+     * @param context_ Used OpenCL context
+     * @param program_ Used OpenCL program
+     */
+    ExecutionSettings(std::unique_ptr<TSettings> programSettings_, std::unique_ptr<cl::Device> device_, 
+                        std::unique_ptr<cl::Context> context_, std::unique_ptr<cl::Program> program_): 
+                                    programSettings(std::move(programSettings_)), device(std::move(device_)), 
+                                    context(std::move(context_)), program(std::move(program_)) {
+        if (device && context && program) {
+            addDevice(*device, *context, *program);
+        }
+    }
+
+    /**
+     * @brief Add a device that is used by this rank in addition to the first device
+     * 
+     * @param device_ The OpenCL device
+     * @param context_ The context created for the device
+     * @param program_ The program containing the benchmark kernel for the device
+     */
+    void
+    addDevice(const cl::Device &device_, const cl::Context &context_, const cl::Program &program_) {
+        devices.push_back(device_);
+        contexts.push_back(context_);
+        programs.push_back(program_);
+    }
+
+    /**
+     * @brief Get the settings map of the program settings with the number of ranks of the used communicator
+     * 
+     * @return std::map<std::string,std::string> The settings map
+     */
+    std::map<std::string,std::string>
+    getSettingsMap() const {
+        return programSettings->getSettingsMap();
+    }
+
+    /**
+     * @brief Destroy the Execution Settings object. Used to specify the order the contained objects are destroyed 
+     *         to prevent segmentation faults during exit.
+     * 
+     */
+    ~ExecutionSettings() {
+        programs.clear();
+        contexts.clear();
+        devices.clear();
+        program = nullptr;
+        context = nullptr;
+        device = nullptr;
+        programSettings = nullptr;
+    }
+
+};
+
+/**
+ * @brief Base benchmark class. Every benchmark should be derived from this class and implement its abstract methods.
+ * 
+ * @tparam TSettings Class used to represent the program settings of the benchmark
+ * @tparam TData Class used to represent the benchmark input and output data
+ * @tparam TOutput Class representing the measurements like timings etc
+ */
+template <class TSettings, class TData, class TOutput>
+class HpccFpgaBenchmark {
+
+private:
+
+    /**
+     * @brief This flag is set by the setupBenchmark() routine after successful setting up the benchmark.
+     *          It is used to prevent undefined behavior in the case executeBenchmark() is called without
+     *          a complete setup.
+     * 
+     */
+    bool benchmark_setup_succeeded = false;
+
+    /**
+     * @brief Copy of the program arguments given to setupBenchmark(). 
+     *          They are parsed again with the changed option for every point of a parameter sweep.
+     * 
+     */
+    std::vector<std::string> programArguments;
+
+    /**
+     * @brief Options that can not be changed in a parameter sweep, because they are used to set up the device
+     * 
+     */
+    const std::vector<std::string> nonSweepableOptions = {"f", "file", "device", "platform", "devices-per-rank", 
+                                                            "reuse-bitstream", "sweep", "soak", "test", "dry-run-memory",
+                                                            "scale-replications", "scale-ranks", "baseline", "h", "help"};
+
+    /**
+     * @brief Print the estimated memory of the current configuration and compare it to the memory of the host and the devices.
+     *          The estimate of the rank with the highest requirement is used.
+     * 
+     * @return true if the estimate fits into the available memory or no estimate is available
+     */
+    bool
+    executeMemoryDryRun() {
+        auto requirements = estimateMemoryUsage();
+        // Host memory, device memory and largest single device buffer
+        unsigned long required[3] = {memory_tracker::totalBytes(requirements, false),
+                                    memory_tracker::totalBytes(requirements, true), 0};
+        for (const auto &r : requirements) {
+            required[2] = std::max(required[2], static_cast<unsigned long>(r.device ? r.bytes : 0));
+        }
+        unsigned long available[3] = {memory_tracker::physicalMemorySize(), 0, 0};
+        if (executionSettings->device) {
+            available[1] = executionSettings->device->getInfo<CL_DEVICE_GLOBAL_MEM_SIZE>();
+            available[2] = executionSettings->device->getInfo<CL_DEVICE_MAX_MEM_ALLOC_SIZE>();
+        }
+        bool has_estimate = !requirements.empty();
+#ifdef _USE_MPI_
+        unsigned long max_required[3];
+        MPI_Allreduce(required, max_required, 3, MPI_UNSIGNED_LONG, MPI_MAX, executionSettings->communicator);
+        std::copy(max_required, max_required + 3, required);
+        // The smallest memory of all ranks is used. Ranks on the same node share the host memory, which is not considered here.
+        unsigned long min_available[3];
+        MPI_Allreduce(available, min_available, 3, MPI_UNSIGNED_LONG, MPI_MIN, executionSettings->communicator);
+        std::copy(min_available, min_available + 3, available);
+#endif
+        // Unknown limits are given as 0 and not checked
+        bool fits = true;
+        for (int i = 0; i < 3; i++) {
+            fits = fits && (available[i] == 0 || required[i] <= available[i]);
+        }
+        if (mpi_comm_rank != 0) {
+            return !has_estimate || fits;
+        }
+        std::cout << HLINE << "MEMORY DRY RUN: SKIP DATA GENERATION, EXECUTION, AND VALIDATION!" << std::endl << HLINE;
+        if (!has_estimate) {
+            std::cout << "No memory estimate available for this benchmark" << std::endl;
+            return true;
+        }
+        std::cout << "Estimated memory per rank:" << std::endl;
+        for (const auto &r : requirements) {
+            std::cout << std::setw(ENTRY_SPACE) << r.name << std::setw(8) << (r.device ? "Device" : "Host")
+                      << std::setw(ENTRY_SPACE) << memory_tracker::formatBytes(static_cast<double>(r.bytes * r.count));
+            if (r.count > 1) {
+                std::cout << " (" << r.count << " x " << memory_tracker::formatBytes(static_cast<double>(r.bytes)) << ")";
+            }
+            std::cout << std::endl;
+        }
+        const std::vector<std::string> names = {"Host memory", "Device memory", "Largest device buffer"};
+        for (int i = 0; i < 3; i++) {
+            std::cout << std::setw(ENTRY_SPACE) << names[i] << ": " << memory_tracker::formatBytes(static_cast<double>(required[i]))
+                      << " of " << ((available[i] > 0) ? memory_tracker::formatBytes(static_cast<double>(available[i])) : "unknown") << std::endl;
+            if (available[i] > 0 && required[i] > available[i]) {
+                std::cerr << "ERROR: " << names[i] << " of the configuration exceeds the available memory!" << std::endl;
+            }
+        }
+        if (fits) {
+            std::cout << "The configuration fits into the available memory" << std::endl;
+        }
+        return fits;
+    }
+
+    /**
+     * @brief Print the peak resident set size of the host and the peak memory recorded by the memory tracker.
+     *          The highest value of all ranks is printed. The device memory is additionally given per bank for rank 0.
+     * 
+     */
+    void
+    printMemoryUsage() {
+        auto &tracker = memory_tracker::getTracker();
+        auto banks = tracker.getPeakDeviceBytes();
+        unsigned long usage[3] = {memory_tracker::peakResidentSetSize(), tracker.getPeakHostBytes(),
+                                    tracker.getPeakTotalDeviceBytes()};
+#ifdef _USE_MPI_
+        unsigned long max_usage[3];
+        MPI_Reduce(usage, max_usage, 3, MPI_UNSIGNED_LONG, MPI_MAX, 0, executionSettings->communicator);
+        std::copy(max_usage, max_usage + 3, usage);
+#endif
+        if (mpi_comm_rank != 0) {
+            return;
+        }
+        std::cout << "Peak Host RSS: " << memory_tracker::formatBytes(static_cast<double>(usage[0]))
+                  << ", Tracked Host Memory: " << memory_tracker::formatBytes(static_cast<double>(usage[1]))
+                  << ", Device Memory: " << memory_tracker::formatBytes(static_cast<double>(usage[2])) << std::endl;
+        json json_banks;
+        for (const auto &b : banks) {
+            std::string name = (b.first == memory_tracker::DEFAULT_BANK) ? "default" : std::to_string(b.first);
+            json_banks[name] = b.second;
+            std::cout << std::setw(ENTRY_SPACE) << ("Bank " + name) << ": " << memory_tracker::formatBytes(static_cast<double>(b.second)) << std::endl;
+        }
+        memoryUsage = {{"host_peak_rss", usage[0]}, {"host_tracked_peak", usage[1]}, {"device_peak", usage[2]},
+                        {"device_peak_per_bank", json_banks}};
+    }
+
+    /**
+     * @brief Create the power sampler for the configured power source. The power of all devices of the rank is summed up.
+     * 
+     * @return std::unique_ptr<power::PowerSampler> The power sampler or nullptr, if power is not measured
+     */
+    std::unique_ptr<power::PowerSampler>
+    createPowerSampler() {
+        const std::string &name = executionSettings->programSettings->powerSource;
+        if (name.empty()) {
+            return std::unique_ptr<power::PowerSampler>(nullptr);
+        }
+        std::vector<power::PowerSource> sources;
+        for (const auto &device : executionSettings->devices) {
+            sources.push_back(power::createPowerSource(name, device));
+        }
+        return std::unique_ptr<power::PowerSampler>(new power::PowerSampler([sources]() {
+                double sum = 0.0;
+                for (const auto &source : sources) {
+                    sum += source();
+                }
+                return sum;
+            }, std::chrono::milliseconds(executionSettings->programSettings->powerInterval)));
+    }
+
+    /**
+     * @brief Add the power and energy of all ranks to the results and calculate the performance per watt
+     *          for all results that are given as a rate e.g. GFLOP/s or B/s
+     * 
+     * @param measurement The power measurement of this rank over the kernel execution
+     */
+    void
+    addPowerResults(const power::PowerMeasurement &measurement) {
+        double total_power = measurement.averagePower;
+        double total_energy = measurement.energy;
+#ifdef _USE_MPI_
+        double local[2] = {measurement.averagePower, measurement.energy};
+        double global[2] = {0.0, 0.0};
+        MPI_Reduce(local, global, 2, MPI_DOUBLE, MPI_SUM, 0, executionSettings->communicator);
+        total_power = global[0];
+        total_energy = global[1];
+#endif
+        if (mpi_comm_rank > 0) {
+            return;
+        }
+        if (measurement.samples == 0 || total_power <= 0.0) {
+            std::cerr << "WARNING: No power samples were taken during the kernel execution. "
+                      << "Decrease the sampling interval with --power-interval." << std::endl;
+            return;
+        }
+        double energy_per_repetition = total_energy / executionSettings->programSettings->numRepetitions;
+        std::vector<std::pair<std::string, HpccResult>> rates;
+        for (const auto &r : results) {
+            const std::string &unit = r.second.unit;
+            if (unit.size() > 2 && unit.compare(unit.size() - 2, 2, "/s") == 0) {
+                rates.emplace_back(r.first + "_per_watt", HpccResult(r.second.value / total_power, unit + "/W"));
+            }
+        }
+        results.emplace("power_avg", HpccResult(total_power, "W"));
+        results.emplace("energy", HpccResult(total_energy, "J"));
+        results.emplace("energy_per_repetition", HpccResult(energy_per_repetition, "J"));
+        std::cout << "Power: " << total_power << " W, Energy: " << total_energy << " J, Energy per Repetition: "
+                  << energy_per_repetition << " J" << std::endl;
+        for (const auto &r : rates) {
+            std::cout << std::setw(ENTRY_SPACE) << r.first << ": " << r.second.value << " " << r.second.unit << std::endl;
+            results.insert(r);
+        }
+    }
+
+    /**
+     * @brief Execute a single configuration of the benchmark with the current execution settings.
+     *          This includes the initialization of the input data, exectuon of the kernel, validation and printing the result
+     * 
+     * @return true If the validation is a success
+     * @return false If the validation fails or an execution error occured
+     */
+    bool
+    executeConfiguration() {
+        if (mpi_comm_rank == 0) {
+            std::cout << HLINE << "Start benchmark using the given configuration. Generating data..." << std::endl
+                    << HLINE;
+        }
+        // The warm-up repetitions are executed and validated together with the measured repetitions.
+        // Their measurements are removed with discardWarmup() in collectAndPrintResults().
+        uint measured_repetitions = executionSettings->programSettings->numRepetitions;
+        executionSettings->programSettings->numRepetitions += executionSettings->programSettings->warmupRepetitions;
+       try {
+            const std::string &trace_file = executionSettings->programSettings->traceFile;
+            if (!trace_file.empty()) {
+                tracing::getTracer().start();
+            }
+            auto gen_start = std::chrono::high_resolution_clock::now();
+            std::unique_ptr<TData> data;
+            {
+                tracing::ScopedSpan span("Data generation");
+                data = generateOrLoadInputData();
+            }
+            std::chrono::duration<double> gen_time = std::chrono::high_resolution_clock::now() - gen_start;
+            
+#ifdef _USE_MPI_
+            MPI_Barrier(executionSettings->communicator);
+#endif
+
+            if (mpi_comm_rank == 0) {
+                std::cout << "Generation Time: " << gen_time.count() << " s"  << std::endl;
+                std::cout << HLINE << "Execute benchmark kernel..." << std::endl
+                        << HLINE;
+            }
+
+            bool validateSuccess = false;
+            std::unique_ptr<power::PowerSampler> sampler = createPowerSampler();
+            power::PowerMeasurement power_measurement = {0.0, 0.0, 0.0, 0.0, 0};
+            auto exe_start = std::chrono::high_resolution_clock::now();
+            if (sampler) {
+                sampler->start();
+            }
+            std::unique_ptr<TOutput> output;
+            {
+                tracing::ScopedSpan span("Kernel execution");
+                output = executeKernel(*data);
+            }
+            if (sampler) {
+                power_measurement = sampler->stop();
+            }
+
+#ifdef _USE_MPI_
+        MPI_Barrier(executionSettings->communicator);
+#endif
+
+            std::chrono::duration<double> exe_time = std::chrono::high_resolution_clock::now() - exe_start;
+
+            if (mpi_comm_rank == 0) {
+                std::cout << "Execution Time: " << exe_time.count() << " s"  << std::endl;
+                std::cout << HLINE << "Validate output..." << std::endl
+                        << HLINE;
+            }
+
+            if (!executionSettings->programSettings->skipValidation) {
+                auto eval_start = std::chrono::high_resolution_clock::now();
+                tracing::ScopedSpan span("Validation");
+                validateSuccess = validateOutputAndPrintError(*data);
+                std::chrono::duration<double> eval_time = std::chrono::high_resolution_clock::now() - eval_start;
+
+                if (mpi_comm_rank == 0) {
+                    std::cout << "Validation Time: " << eval_time.count() << " s" << std::endl;
+                }
+            }
+            collectAndPrintResults(*output);
+            if (sampler) {
+                addPowerResults(power_measurement);
+            }
+            printMemoryUsage();
+            if (!trace_file.empty()) {
+                tracing::getTracer().stop();
+                tracing::getTracer().write(trace_file);
+                if (mpi_comm_rank == 0) {
+                    std::cout << "Trace written to " << trace_file << std::endl;
+                }
+            }
+            executionSettings->programSettings->numRepetitions = measured_repetitions;
+
+            if (mpi_comm_rank == 0) {
+                if (!validateSuccess) {
+                    std::cerr << "ERROR: VALIDATION OF OUTPUT DATA FAILED!" << std::endl;
+                }
+                else {
+                    std::cout << "Validation: SUCCESS!" << std::endl;
+                }
+                if (!executionSettings->programSettings->dumpfilePath.empty()) {
+                    dumpConfigurationAndResults(executionSettings->programSettings->dumpfilePath, validateSuccess);
+                }
+            }
+
+            return validateSuccess;
+       }
+       catch (const std::exception& e) {
+            executionSettings->programSettings->numRepetitions = measured_repetitions;
+            tracing::getTracer().stop();
+            std::cerr << "An error occured while executing the benchmark: " << std::endl;
+            std::cerr << "\t" << e.what() << std::endl;
+            return false;
+       }
+    }
+
+    /**
+     * @brief Parse the program arguments again with additional arguments that change the options of a sweep point
+     *          and use the result as new program settings. The device, context and program of the initial setup are reused.
+     * 
+     * @param arguments The additional arguments that are appended to the initial program arguments
+     * @param name Name of the point that is added to the file name of the dump e.g. the option and value
+     * @param dump_path The dump file path of the initial settings
+     * @param numa_node The NUMA node of the initial settings
+     * @throw std::exception if the arguments can not be parsed
+     */
+    void
+    applySweepPoint(const std::vector<std::string> &arguments, const std::string &name, const std::string &dump_path, int numa_node) {
+        std::vector<std::string> args = programArguments;
+        args.insert(args.end(), arguments.begin(), arguments.end());
+        std::vector<std::vector<char>> arg_storage;
+        std::vector<char*> tmp_argv;
+        for (const auto &a : args) {
+            arg_storage.emplace_back(a.begin(), a.end());
+            arg_storage.back().push_back('\0');
+        }
+        for (auto &a : arg_storage) {
+            tmp_argv.push_back(a.data());
+        }
+        tmp_argv.push_back(nullptr);
+
+        std::unique_ptr<TSettings> settings = parseProgramParameters(static_cast<int>(args.size()), tmp_argv.data());
+        settings->numaNode = numa_node;
+#ifdef _USE_MPI_
+        MPI_Comm_size(executionSettings->communicator, &settings->mpiRanks);
+#endif
+        settings->memoryBanks.setTopology(settings->kernelFileName);
+        if (!dump_path.empty()) {
+            // Every point gets its own dump file with the name of the point added to the file name
+            size_t ext = dump_path.find_last_of('.');
+            if (ext == std::string::npos || dump_path.find_last_of('/') > ext || ext == 0) {
+                ext = dump_path.size();
+            }
+            settings->dumpfilePath = dump_path.substr(0, ext) + "_" + name + dump_path.substr(ext);
+        }
+        executionSettings->programSettings = std::move(settings);
+        adaptSettingsToBitstream();
+    }
+
+    /**
+     * @brief Check the input parameters of the current sweep point and execute it
+     * 
+     * @param title Title of the point that is printed before the configuration
+     * @return true If the validation of the point is a success
+     * @return false If the input parameter check or the validation fails
+     */
+    bool
+    executeSweepPoint(const std::string &title) {
+        timings.clear();
+        results.clear();
+
+        int check_succeeded = 1;
+        if (mpi_comm_rank == 0) {
+            std::cout << HLINE << title << std::endl;
+            check_succeeded = checkInputParameters();
+            if (check_succeeded) {
+                printFinalConfiguration();
+            }
+        }
+#ifdef _USE_MPI_
+        MPI_Bcast(&check_succeeded, 1, MPI_INT, 0, executionSettings->communicator);
+#endif
+        if (!check_succeeded) {
+            if (mpi_comm_rank == 0) {
+                std::cerr << "ERROR: Input parameter check failed for " << title << "!" << std::endl;
+            }
+            return false;
+        }
+        return executeConfiguration();
+    }
+
+    /**
+     * @brief Get the name of the first result that is given as a rate.
+     *          Most benchmarks report their throughput in a unit per second, so it is used as default monitored result.
+     * 
+     * @return std::string The name of the result or an empty string, if no rate is reported
+     */
+    std::string
+    findRateResult() const {
+        for (const auto &r : results) {
+            const std::string &u = r.second.unit;
+            if (u.size() > 2 && u.compare(u.size() - 2, 2, "/s") == 0) {
+                return r.first;
+            }
+        }
+        return "";
+    }
+
+    /**
+     * @brief Execute all points of the parameter sweep given in the program settings.
+     *          For every point, the program arguments are parsed again with the changed option.
+     *          The device, context and program of the initial setup are reused.
+     * 
+     * @return true If the validation of all points is a success
+     * @return false If the validation of a point fails or an error occured
+     */
+    bool
+    executeSweep() {
+        std::pair<std::string, std::vector<std::string>> sweep;
+        std::string option;
+        try {
+            sweep = parseSweep(executionSettings->programSettings->sweep);
+            // The option can also be given with leading dashes
+            option = sweep.first.substr(std::min(sweep.first.find_first_not_of('-'), sweep.first.size()));
+        }
+        catch (const std::exception& e) {
+            std::cerr << "An error occured while parsing the sweep: " << e.what() << std::endl;
+            return false;
+        }
+        if (option.empty() || std::find(nonSweepableOptions.begin(), nonSweepableOptions.end(), option) != nonSweepableOptions.end()) {
+            std::cerr << "ERROR: The option " << option << " can not be changed in a sweep!" << std::endl;
+            return false;
+        }
+        std::string dump_path = executionSettings->programSettings->dumpfilePath;
+        int numa_node = executionSettings->programSettings->numaNode;
+        std::vector<bool> validated;
+        for (const auto &value : sweep.second) {
+            try {
+                applySweepPoint({(option.size() == 1 ? "-" : "--") + option, value}, option + "_" + value, dump_path, numa_node);
+            }
+            catch (const std::exception& e) {
+                std::cerr << "An error occured while parsing the sweep point " << option << "=" << value << ": " << e.what() << std::endl;
+                return false;
+            }
+            validated.push_back(executeSweepPoint("Sweep point " + std::to_string(validated.size() + 1) + "/" + std::to_string(sweep.second.size())
+                                                    + ": " + option + "=" + value));
+        }
+
+        if (mpi_comm_rank == 0) {
+            std::cout << HLINE << "Sweep summary:" << std::endl;
+            std::cout << std::setw(ENTRY_SPACE) << option << std::setw(ENTRY_SPACE) << "Validation" << std::endl;
+            for (size_t i = 0; i < validated.size(); i++) {
+                std::cout << std::setw(ENTRY_SPACE) << sweep.second[i] << std::setw(ENTRY_SPACE) << (validated[i] ? "SUCCESS" : "FAILED") << std::endl;
+            }
+        }
+        return std::find(validated.begin(), validated.end(), false) == validated.end();
+    }
+
+    /**
+     * @brief Execute the benchmark for 1 up to the number of kernel replications given in the program settings.
+     *          The benchmarks split their data over the used replications, so the total amount of work stays the same.
+     *          The monitored result of every replication count is compared to the one of a single replication
+     *          to calculate the speedup and parallel efficiency.
+     * 
+     * @return true If the validation of all replication counts is a success
+     * @return false If a validation fails, the monitored result is not available or an error occured
+     */
+    bool
+    executeReplicationScaling() {
+#ifndef NUM_REPLICATIONS
+        std::cerr << "ERROR: The replication scaling is not supported, because the benchmark does not use kernel replications!" << std::endl;
+        return false;
+#else
+        uint max_replications = executionSettings->programSettings->kernelReplications;
+        std::string metric = executionSettings->programSettings->scalingMetric;
+        std::string dump_path = executionSettings->programSettings->dumpfilePath;
+        int numa_node = executionSettings->programSettings->numaNode;
+        std::string unit;
+        bool metric_found = false;
+        std::vector<bool> validated;
+        std::vector<double> values;
+        for (uint r = 1; r <= max_replications; r++) {
+            try {
+                applySweepPoint({"-r", std::to_string(r)}, "r_" + std::to_string(r), dump_path, numa_node);
+            }
+            catch (const std::exception& e) {
+                std::cerr << "An error occured while parsing the replication scaling point r=" << r << ": " << e.what() << std::endl;
+                return false;
+            }
+            validated.push_back(executeSweepPoint("Replication scaling " + std::to_string(r) + "/" + std::to_string(max_replications)));
+            double value = std::numeric_limits<double>::quiet_NaN();
+            if (mpi_comm_rank == 0) {
+                if (metric.empty()) {
+                    metric = findRateResult();
+                }
+                auto result = results.find(metric);
+                if (result != results.end()) {
+                    value = result->second.value;
+                    unit = result->second.unit;
+                    metric_found = true;
+                }
+            }
+            values.push_back(value);
+        }
+
+        if (mpi_comm_rank == 0) {
+            if (!metric_found) {
+                std::cerr << "ERROR: The monitored result " << (metric.empty() ? "of the replication scaling" : metric)
+                          << " is not reported by the benchmark!" << std::endl;
+                return false;
+            }
+            std::cout << HLINE << "Replication scaling of " << metric << ":" << std::endl;
+            std::cout << std::setw(ENTRY_SPACE) << "Replications" << std::setw(ENTRY_SPACE) << unit
+                      << std::setw(ENTRY_SPACE) << "Speedup" << std::setw(ENTRY_SPACE) << "Efficiency"
+                      << std::setw(ENTRY_SPACE) << "Validation" << std::endl;
+            for (size_t i = 0; i < values.size(); i++) {
+                unsigned replications = static_cast<unsigned>(i + 1);
+                double efficiency = parallelEfficiency(values[i], values[0], replications);
+                results.emplace("scaling_" + std::to_string(replications) + "_" + metric, HpccResult(values[i], unit));
+                results.emplace("scaling_" + std::to_string(replications) + "_efficiency", HpccResult(efficiency, ""));
+                std::cout << std::setw(ENTRY_SPACE) << replications << std::setw(ENTRY_SPACE) << values[i]
+                          << std::setw(ENTRY_SPACE) << values[i] / values[0] << std::setw(ENTRY_SPACE) << efficiency
+                          << std::setw(ENTRY_SPACE) << (validated[i] ? "SUCCESS" : "FAILED") << std::endl;
+            }
+        }
+        return (metric_found || mpi_comm_rank != 0) && std::find(validated.begin(), validated.end(), false) == validated.end();
+#endif
+    }
+
+    /**
+     * @brief Execute the benchmark on nested sub-communicators of 1, 4, 16, ... ranks of MPI_COMM_WORLD for the scalings given in the program settings.
+     *          Only the ranks of the sub-communicator execute a point, the other ranks wait until it is completed.
+     *          The problem size of every point is adapted by getRankScalingArguments. The monitored result of every point
+     *          is compared to the one of a single rank to calculate the parallel efficiency.
+     * 
+     * @return true If the validation of all points is a success
+     * @return false If a validation fails, the monitored result is not available or an error occured
+     */
+    bool
+    executeRankScaling() {
+#ifndef _USE_MPI_
+        std::cerr << "ERROR: The rank scaling requires MPI!" << std::endl;
+        return false;
+#else
+        std::string type = executionSettings->programSettings->scaleRanks;
+        std::vector<bool> weak_scalings;
+        if (type == "STRONG" || type == "BOTH") {
+            weak_scalings.push_back(false);
+        }
+        if (type == "WEAK" || type == "BOTH") {
+            weak_scalings.push_back(true);
+        }
+        if (weak_scalings.empty()) {
+            if (mpi_comm_rank == 0) {
+                std::cerr << "ERROR: Unknown rank scaling " << type << ". Valid values are STRONG, WEAK and BOTH!" << std::endl;
+            }
+            return false;
+        }
+        int world_rank;
+        int world_size;
+        MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+        MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+        std::vector<int> rank_counts;
+        for (int n = 1; n <= world_size; n *= 4) {
+            rank_counts.push_back(n);
+        }
+        // The arguments are derived from the initial settings, so they have to be calculated before the first point is parsed
+        std::vector<std::vector<std::vector<std::string>>> arguments;
+        try {
+            for (bool weak : weak_scalings) {
+                arguments.emplace_back();
+                for (int n : rank_counts) {
+                    arguments.back().push_back(getRankScalingArguments(n, weak));
+                }
+            }
+        }
+        catch (const std::exception& e) {
+            if (mpi_comm_rank == 0) {
+                std::cerr << "ERROR: " << e.what() << "!" << std::endl;
+            }
+            return false;
+        }
+
+        std::string metric = executionSettings->programSettings->scalingMetric;
+        std::string dump_path = executionSettings->programSettings->dumpfilePath;
+        int numa_node = executionSettings->programSettings->numaNode;
+        std::string unit;
+        bool metric_found = false;
+        bool all_validated = true;
+        std::map<std::string, HpccResult> scaling_results;
+        for (size_t s = 0; s < weak_scalings.size(); s++) {
+            std::string scaling = weak_scalings[s] ? "weak" : "strong";
+            std::vector<bool> participated;
+            std::vector<bool> validated;
+            std::vector<double> values;
+            for (size_t i = 0; i < rank_counts.size(); i++) {
+                int n = rank_counts[i];
+                MPI_Comm sub_communicator;
+                MPI_Comm_split(MPI_COMM_WORLD, (world_rank < n) ? 0 : MPI_UNDEFINED, world_rank, &sub_communicator);
+                // The communicator is freed after the point, so the participation is stored before
+                bool in_point = sub_communicator != MPI_COMM_NULL;
+                bool point_validated = false;
+                double value = std::numeric_limits<double>::quiet_NaN();
+                if (in_point) {
+                    executionSettings->communicator = sub_communicator;
+                    MPI_Comm_rank(sub_communicator, &mpi_comm_rank);
+                    MPI_Comm_size(sub_communicator, &mpi_comm_size);
+                    try {
+                        applySweepPoint(arguments[s][i], scaling + "_ranks_" + std::to_string(n), dump_path, numa_node);
+                        point_validated = executeSweepPoint("Rank scaling " + scaling + " " + std::to_string(i + 1) + "/"
+                                                                + std::to_string(rank_counts.size()) + ": " + std::to_string(n) + " ranks");
+                    }
+                    catch (const std::exception& e) {
+                        std::cerr << "An error occured while executing the rank scaling point with " << n << " ranks: " << e.what() << std::endl;
+                    }
+                    if (mpi_comm_rank == 0) {
+                        if (metric.empty()) {
+                            metric = findRateResult();
+                        }
+                        auto result = results.find(metric);
+                        if (result != results.end()) {
+                            value = result->second.value;
+                            unit = result->second.unit;
+                            metric_found = true;
+                        }
+                    }
+                    executionSettings->communicator = MPI_COMM_WORLD;
+                    MPI_Comm_free(&sub_communicator);
+                    mpi_comm_rank = world_rank;
+                    mpi_comm_size = world_size;
+                }
+                MPI_Barrier(MPI_COMM_WORLD);
+                participated.push_back(in_point);
+                validated.push_back(point_validated);
+                values.push_back(value);
+            }
+            if (world_rank == 0) {
+                std::cout << HLINE << "Rank scaling " << scaling << " of " << metric << ":" << std::endl;
+                std::cout << std::setw(ENTRY_SPACE) << "Ranks" << std::setw(ENTRY_SPACE) << unit
+                          << std::setw(ENTRY_SPACE) << "Efficiency" << std::setw(ENTRY_SPACE) << "Validation" << std::endl;
+                for (size_t i = 0; i < values.size(); i++) {
+                    std::string n = std::to_string(rank_counts[i]);
+                    double efficiency = parallelEfficiency(values[i], values[0], rank_counts[i]);
+                    std::cout << std::setw(ENTRY_SPACE) << n << std::setw(ENTRY_SPACE) << values[i]
+                              << std::setw(ENTRY_SPACE) << efficiency << std::setw(ENTRY_SPACE) << (validated[i] ? "SUCCESS" : "FAILED") << std::endl;
+                    scaling_results.emplace(scaling + "_scaling_" + n + "_" + metric, HpccResult(values[i], unit));
+                    scaling_results.emplace(scaling + "_scaling_" + n + "_efficiency", HpccResult(efficiency, ""));
+                }
+            }
+            // Only the first ranks execute all points, so the validation is collected on every rank
+            int local_validated = rankScalingValidated(participated, validated) ? 1 : 0;
+            int global_validated = 0;
+            MPI_Allreduce(&local_validated, &global_validated, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+            all_validated = all_validated && global_validated;
+        }
+        // Restore the initial settings on all ranks, so they are valid for MPI_COMM_WORLD again
+        applySweepPoint({}, "", "", numa_node);
+        results = scaling_results;
+        if (world_rank == 0 && !metric_found) {
+            std::cerr << "ERROR: The monitored result " << (metric.empty() ? "of the rank scaling" : metric)
+                      << " is not reported by the benchmark!" << std::endl;
+            return false;
+        }
+        return all_validated;
+#endif
+    }
+
+    /**
+     * @brief Repeat the data generation and kernel execution until the soak duration is reached.
+     *          The kernels of some benchmarks modify their input, so it is generated or loaded again before every iteration
+     *          and every iteration starts from the same initial values.
+     *          After every iteration, the monitored result, the board temperature and power are printed and written to the soak file.
+     *          An iteration is reported as degraded, if the monitored result drops below the threshold relative to the first iteration.
+     *          The output data of the last iteration is validated.
+     * 
+     * @return true If the validation is a success
+     * @return false If the validation fails, the monitored result is not available or an error occured
+     */
+    bool
+    executeSoak() {
+        auto &settings = *executionSettings->programSettings;
+        uint measured_repetitions = settings.numRepetitions;
+        settings.numRepetitions += settings.warmupRepetitions;
+        try {
+            if (mpi_comm_rank == 0) {
+                std::cout << HLINE << "Start soak run for " << settings.soakDuration << " s. Generating data..." << std::endl
+                        << HLINE;
+            }
+            std::unique_ptr<TData> data = generateOrLoadInputData();
+            std::vector<power::TemperatureSource> temperature_sources;
+            if (!settings.temperatureSource.empty()) {
+                for (const auto &device : executionSettings->devices) {
+                    temperature_sources.push_back(power::createTemperatureSource(settings.temperatureSource, device));
+                }
+            }
+            std::unique_ptr<power::PowerSampler> sampler = createPowerSampler();
+#ifdef _USE_MPI_
+            MPI_Barrier(executionSettings->communicator);
+#endif
+
+            std::unique_ptr<soak::SoakWriter> writer;
+            std::string metric = settings.soakMetric;
+            std::string unit;
+            double reference = 0.0;
+            std::vector<double> values;
+            uint degraded_iterations = 0;
+            bool metric_found = true;
+            int keep_running = 1;
+            auto soak_start = std::chrono::high_resolution_clock::now();
+            for (unsigned iteration = 0; keep_running; iteration++) {
+                if (iteration > 0) {
+                    // Release the modified data first, so the memory is not required twice
+                    data.reset();
+                    data = generateOrLoadInputData();
+#ifdef _USE_MPI_
+                    MPI_Barrier(executionSettings->communicator);
+#endif
+                }
+                if (sampler) {
+                    sampler->start();
+                }
+                std::unique_ptr<TOutput> output = executeKernel(*data);
+                double power = std::numeric_limits<double>::quiet_NaN();
+                if (sampler) {
+                    power = sampler->stop().averagePower;
+                }
+                double temperature = std::numeric_limits<double>::quiet_NaN();
+                for (const auto &source : temperature_sources) {
+                    double t = source();
+                    temperature = std::isnan(temperature) ? t : std::max(temperature, t);
+                }
+#ifdef _USE_MPI_
+                if (sampler) {
+                    double total_power = 0.0;
+                    MPI_Reduce(&power, &total_power, 1, MPI_DOUBLE, MPI_SUM, 0, executionSettings->communicator);
+                    power = total_power;
+                }
+                if (!temperature_sources.empty()) {
+                    double max_temperature = 0.0;
+                    MPI_Reduce(&temperature, &max_temperature, 1, MPI_DOUBLE, MPI_MAX, 0, executionSettings->communicator);
+                    temperature = max_temperature;
+                }
+#endif
+                timings.clear();
+                results.clear();
+                collectAndPrintResults(*output);
+
+                if (mpi_comm_rank == 0) {
+                    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - soak_start;
+                    if (iteration == 0) {
+                        if (metric.empty()) {
+                            metric = findRateResult();
+                        }
+                        metric_found = results.count(metric) > 0;
+                        if (metric_found) {
+                            unit = results.at(metric).unit;
+                            reference = results.at(metric).value;
+                            if (!settings.soakFile.empty()) {
+                                writer = std::unique_ptr<soak::SoakWriter>(new soak::SoakWriter(settings.soakFile, metric, unit));
+                            }
+                        }
+                        else {
+                            std::cerr << "ERROR: The monitored result " << (metric.empty() ? "of the soak mode" : metric)
+                                      << " is not reported by the benchmark!" << std::endl;
+                        }
+                    }
+                    if (metric_found) {
+                        double value = results.at(metric).value;
+                        bool degraded = soak::isDegraded(value, reference, settings.soakThreshold);
+                        degraded_iterations += degraded ? 1 : 0;
+                        values.push_back(value);
+                        std::cout << "Soak iteration " << iteration << ": " << elapsed.count() << " s, " << metric << "=" << value << " " << unit;
+                        if (!std::isnan(temperature)) {
+                            std::cout << ", " << temperature << " C";
+                        }
+                        if (!std::isnan(power)) {
+                            std::cout << ", " << power << " W";
+                        }
+                        std::cout << std::endl;
+                        if (degraded) {
+                            std::cerr << "WARNING: " << metric << " dropped by " << 100.0 * (1.0 - value / reference)
+                                      << "% compared to the first soak iteration!" << std::endl;
+                        }
+                        if (writer) {
+                            writer->write({iteration, elapsed.count(), value, temperature, power, degraded});
+                        }
+                    }
+                    keep_running = (metric_found && elapsed.count() < settings.soakDuration) ? 1 : 0;
+                }
+#ifdef _USE_MPI_
+                MPI_Bcast(&keep_running, 1, MPI_INT, 0, executionSettings->communicator);
+#endif
+            }
+
+            bool validateSuccess = false;
+            if (!settings.skipValidation) {
+                validateSuccess = validateOutputAndPrintError(*data);
+            }
+            settings.numRepetitions = measured_repetitions;
+
+            if (mpi_comm_rank == 0) {
+                if (!metric_found) {
+                    return false;
+                }
+                results.emplace("soak_iterations", HpccResult(values.size(), ""));
+                results.emplace("soak_degraded_iterations", HpccResult(degraded_iterations, ""));
+                results.emplace("soak_" + metric + "_min", HpccResult(*std::min_element(values.begin(), values.end()), unit));
+                results.emplace("soak_" + metric + "_max", HpccResult(*std::max_element(values.begin(), values.end()), unit));
+                std::cout << HLINE << "Soak summary: " << values.size() << " iterations, " << degraded_iterations 
+                          << " degraded by more than " << settings.soakThreshold << "%" << std::endl;
+                if (!validateSuccess) {
+                    std::cerr << "ERROR: VALIDATION OF OUTPUT DATA FAILED!" << std::endl;
+                }
+                else {
+                    std::cout << "Validation: SUCCESS!" << std::endl;
+                }
+                if (!settings.dumpfilePath.empty()) {
+                    dumpConfigurationAndResults(settings.dumpfilePath, validateSuccess);
+                }
+            }
+            return validateSuccess;
+        }
+        catch (const std::exception& e) {
+            settings.numRepetitions = measured_repetitions;
+            std::cerr << "An error occured while executing the soak run: " << std::endl;
+            std::cerr << "\t" << e.what() << std::endl;
+            return false;
+        }
+    }
+
+protected:
+
+    /**
+     * @brief The used execution settings that will be generated by setupBenchmark().
+     *        It should be laos used by all other methods to read the current benchmark settings.
+     * 
+     */
+    std::unique_ptr<ExecutionSettings<TSettings>> executionSettings;
 
     /**
-     * @brief Get a map of the settings. This map will be used to print the final configuration.
-     *          Derived classes should override it to add additional configuration options
+     * @brief Add additional options to the program parameter parser
      * 
-     * @return std::map<std::string,std::string> 
+     * @param options The options object that will be used to parse the input parameters
      */
-    virtual std::map<std::string,std::string> getSettingsMap() {
-    int mpi_size = 0;
-#ifdef _USE_MPI_
-     MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
-#endif
-    std::string str_mpi_ranks = "None";
-    if (mpi_size > 0) {
-        str_mpi_ranks = std::to_string(mpi_size);
-    }
-        return {{"Repetitions", std::to_string(numRepetitions)}, {"Kernel Replications", std::to_string(kernelReplications)}, 
-                {"Kernel File", kernelFileName}, {"MPI Ranks", str_mpi_ranks}, {"Test Mode", testOnly ? "Yes" : "No"},
-                {"Communication Type", commToString(communicationType)}};
-    }
-
-};
+    virtual void
+    addAdditionalParseOptions(cxxopts::Options &options) = 0;
 
 
-/**
- * @brief Settings class that is containing the program settings together with
- *          additional information about the OpenCL runtime
- * 
- * @tparam TSettings The program settings class that should be used (Must derive from BaseSettings)
- */
-template <class TSettings>
-class ExecutionSettings {
-public:
+    /**
+     * @brief The communication rank of a MPI setup
+     * 
+     */
+    int mpi_comm_rank = 0;
 
     /**
-     * @brief Pointer to the additional program settings
+     * @brief The size of the MPI communication world
      * 
      */
-    std::unique_ptr<TSettings> programSettings;
+    int mpi_comm_size = 1;
 
     /**
-     * @brief The OpenCL device that should be used for execution
+     * @brief This flag indicates if MPI was initialized before the object was constructed.
+     *          In this case, no finalization will be done by the destuctor of the object.
      * 
      */
-    std::unique_ptr<cl::Device> device;
+    bool mpi_external_init = true;
 
     /**
-     * @brief The OpenCL context that should be used for execution
+     * @brief Raw measurements of all repetitions in seconds. The key is the name of the measured operation.
+     *          It should be filled by collectAndPrintResults() on rank 0 and will be contained in the JSON dump.
      * 
      */
-    std::unique_ptr<cl::Context> context;
+    std::map<std::string, std::vector<double>> timings;
 
     /**
-     * @brief The OpenCL program that contains the benchmark kernel
+     * @brief Derived results of the benchmark like bandwidths or FLOP rates. The key is the name of the metric.
+     *          It should be filled by collectAndPrintResults() on rank 0 and will be contained in the JSON dump.
      * 
      */
-    std::unique_ptr<cl::Program> program;
+    std::map<std::string, HpccResult> results;
 
     /**
-     * @brief Construct a new Execution Settings object
+     * @brief Memory usage of the last execution as printed by printMemoryUsage(). It will be contained in the JSON dump.
      * 
-     * @param programSettings_ Pointer to an existing program settings object that is derived from BaseSettings
-     * @param device_ Used OpenCL device
-     * @param context_ Used OpenCL context
-     * @param program_ Used OpenCL program
      */
-    ExecutionSettings(std::unique_ptr<TSettings> programSettings_, std::unique_ptr<cl::Device> device_, 
-                        std::unique_ptr<cl::Context> context_, std::unique_ptr<cl::Program> program_): 
-                                    programSettings(std::move(programSettings_)), device(std::move(device_)), 
-                                    context(std::move(context_)), program(std::move(program_)) {}
+    json memoryUsage;
 
     /**
-     * @brief Destroy the Execution Settings object. Used to specify the order the contained objects are destroyed 
-     *         to prevent segmentation faults during exit.
+     * @brief Remove the measurements of the warm-up repetitions from the measurements of all executed repetitions
      * 
+     * @param values Measurements of all executed repetitions
+     * @return std::vector<double> The measurements of the measured repetitions
      */
-    ~ExecutionSettings() {
-        program = nullptr;
-        context = nullptr;
-        device = nullptr;
-        programSettings = nullptr;
+    std::vector<double>
+    discardWarmup(const std::vector<double> &values) {
+        return statistics::discardWarmup(values, executionSettings->programSettings->warmupRepetitions);
     }
 
-};
-
-/**
- * @brief Base benchmark class. Every benchmark should be derived from this class and implement its abstract methods.
- * 
- * @tparam TSettings Class used to represent the program settings of the benchmark
- * @tparam TData Class used to represent the benchmark input and output data
- * @tparam TOutput Class representing the measurements like timings etc
- */
-template <class TSettings, class TData, class TOutput>
-class HpccFpgaBenchmark {
+    /**
+     * @brief Add the median, standard deviation, the 95th and 99th percentile and the coefficient of variation of the 
+     *          measurements to the results and print them. A warning is printed if the variation of the measurements is high.
+     *          It should be called by collectAndPrintResults() on rank 0 after the warm-up is discarded.
+     * 
+     * @param name Prefix of the result names e.g. t will create the results t_median, t_stddev, t_p95, t_p99 and t_cv
+     * @param values The measurements in seconds
+     * @return statistics::Statistics The statistics of the measurements
+     */
+    statistics::Statistics
+    addStatistics(const std::string &name, const std::vector<double> &values) {
+        statistics::Statistics stats = statistics::computeStatistics(values);
+        results.emplace(name + "_median", HpccResult(stats.median, "s"));
+        results.emplace(name + "_stddev", HpccResult(stats.stddev, "s"));
+        results.emplace(name + "_p95", HpccResult(stats.p95, "s"));
+        results.emplace(name + "_p99", HpccResult(stats.p99, "s"));
+        results.emplace(name + "_cv", HpccResult(stats.cv, ""));
+        std::cout << std::setw(ENTRY_SPACE) << name << " median: " << stats.median << " s, stddev: " << stats.stddev 
+                  << " s, p95: " << stats.p95 << " s, p99: " << stats.p99 << " s, CV: " << stats.cv * 100.0 << " %" << std::endl;
+        if (stats.cv > statistics::CV_WARNING_THRESHOLD) {
+            std::cerr << "WARNING: High variation of the measurements of " << name << " (CV " << stats.cv * 100.0 
+                      << " %). Consider to use more repetitions or warm-up repetitions with --warmup." << std::endl;
+        }
+        return stats;
+    }
 
-private:
+public:
 
     /**
-     * @brief This flag is set by the setupBenchmark() routine after successful setting up the benchmark.
-     *          It is used to prevent undefined behavior in the case executeBenchmark() is called without
-     *          a complete setup.
+     * @brief Allocate and initiate the input data for the kernel
      * 
+     * @return std::unique_ptr<TData> A data class containing the initialized data
      */
-    bool benchmark_setup_succeeded = false;
-
-protected:
+    virtual std::unique_ptr<TData>
+    generateInputData() = 0;
 
     /**
-     * @brief The used execution settings that will be generated by setupBenchmark().
-     *        It should be laos used by all other methods to read the current benchmark settings.
+     * @brief Allocate the input data for the kernel without initializing it.
+     *          Benchmarks that support the data cache have to override this method together with getInputDataRegions().
+     *          The data will be initialized from the cache afterwards.
      * 
+     * @return std::unique_ptr<TData> A data class containing the allocated data or nullptr, if the data cache is not supported
      */
-    std::unique_ptr<ExecutionSettings<TSettings>> executionSettings;
+    virtual std::unique_ptr<TData>
+    allocateInputData() { return nullptr; }
 
     /**
-     * @brief Add additional options to the program parameter parser
+     * @brief Get all memory regions of the input data that have to be stored to restore the data from the data cache.
      * 
-     * @param options The options object that will be used to parse the input parameters
+     * @param data The input data
+     * @return std::vector<DataRegion> The regions in the order they will be stored in the cache file
      */
-    virtual void
-    addAdditionalParseOptions(cxxopts::Options &options) = 0;
+    virtual std::vector<DataRegion>
+    getInputDataRegions(TData &data) { return {}; }
 
+    /**
+     * @brief Estimate the host and device memory that is allocated by this rank for the current settings.
+     *          It is used by the memory dry run and must not allocate the data.
+     *          Benchmarks should list at least the large allocations of the data generation, kernel execution and validation.
+     * 
+     * @return std::vector<memory_tracker::MemoryRequirement> The estimated allocations. Empty, if no estimate is available.
+     */
+    virtual std::vector<memory_tracker::MemoryRequirement>
+    estimateMemoryUsage() { return {}; }
 
     /**
-     * @brief The communication rank of a MPI setup
+     * @brief Get the program arguments that adapt the problem size of the current settings to the number of ranks in a rank scaling.
+     *          The arguments are appended to the initial program arguments. Benchmarks have to override this method,
+     *          if they only communicate over the communicator in the execution settings and support the rank scaling.
      * 
+     * @param ranks Number of ranks the benchmark will be executed on
+     * @param weak True for the weak scaling that keeps the problem size per rank, false for the strong scaling that keeps the total problem size
+     * @return std::vector<std::string> The additional arguments. Empty, if no option has to be changed.
+     * @throw std::runtime_error if the scaling is not supported for the number of ranks
      */
-    int mpi_comm_rank = 0;
+    virtual std::vector<std::string>
+    getRankScalingArguments(int ranks, bool weak) {
+        throw std::runtime_error("The rank scaling is not supported by the benchmark");
+    }
 
     /**
-     * @brief The size of the MPI communication world
+     * @brief Get the path of the data cache file of this rank for the current configuration.
+     *          The file name is derived from the settings of the benchmark, so changes in the configuration will
+     *          lead to a new file.
      * 
+     * @return std::string Path to the cache file
      */
-    int mpi_comm_size = 1;
+    std::string
+    getInputDataCacheFile() {
+        std::stringstream settings;
+        for (const auto &entry : executionSettings->getSettingsMap()) {
+            settings << entry.first << "=" << entry.second << ";";
+        }
+        std::stringstream file_name;
+        file_name << executionSettings->programSettings->dataCachePath << "/hpcc_data_"
+                    << std::hex << std::hash<std::string>()(settings.str()) << std::dec << "_rank" << mpi_comm_rank << ".dat";
+        return file_name.str();
+    }
 
     /**
-     * @brief This flag indicates if MPI was initialized before the object was constructed.
-     *          In this case, no finalization will be done by the destuctor of the object.
+     * @brief Load the input data from a cache file by memory-mapping the file and
+     *          copying its content into the given memory regions
      * 
+     * @param file_path Path to the cache file
+     * @param regions The memory regions the data will be copied to
+     * @return true if the data was loaded successfully
+     * @return false if the file does not exist or does not match the size of the regions
      */
-    bool mpi_external_init = true;
+    bool
+    loadInputDataFromCache(const std::string &file_path, const std::vector<DataRegion> &regions) {
+        size_t total_size = 0;
+        for (const auto &r : regions) {
+            total_size += r.size;
+        }
+        int fd = open(file_path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) != 0 || static_cast<size_t>(file_stat.st_size) != total_size || total_size == 0) {
+            close(fd);
+            return false;
+        }
+        void* mapped = mmap(nullptr, total_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED) {
+            return false;
+        }
+        madvise(mapped, total_size, MADV_SEQUENTIAL);
+        size_t offset = 0;
+        for (const auto &r : regions) {
+            std::memcpy(r.ptr, reinterpret_cast<char*>(mapped) + offset, r.size);
+            offset += r.size;
+        }
+        munmap(mapped, total_size);
+        return true;
+    }
 
-public:
+    /**
+     * @brief Store the given memory regions of the input data in a cache file
+     * 
+     * @param file_path Path to the cache file. An existing file will be overwritten.
+     * @param regions The memory regions that will be stored
+     */
+    void
+    storeInputDataToCache(const std::string &file_path, const std::vector<DataRegion> &regions) {
+        std::ofstream fs(file_path, std::ofstream::out | std::ofstream::binary);
+        if (!fs.is_open()) {
+            std::cerr << "WARNING: Could not open " << file_path << " to store the input data!" << std::endl;
+            return;
+        }
+        for (const auto &r : regions) {
+            fs.write(reinterpret_cast<const char*>(r.ptr), r.size);
+        }
+    }
 
     /**
-     * @brief Allocate and initiate the input data for the kernel
+     * @brief Load the input data from the data cache if possible or generate it with generateInputData().
+     *          Generated data is stored in the cache for later runs.
+     *          All ranks either load or generate the data, because the generation may require communication.
      * 
-     * @return std::unique_ptr<TData> A data class containing the initialized data
+     * @return std::unique_ptr<TData> The initialized input data
      */
-    virtual std::unique_ptr<TData>
-    generateInputData() = 0;
+    std::unique_ptr<TData>
+    generateOrLoadInputData() {
+        if (executionSettings->programSettings->dataCachePath.empty()) {
+            return generateInputData();
+        }
+        std::string file_path = getInputDataCacheFile();
+        std::unique_ptr<TData> data;
+        int loaded = 0;
+        if (access(file_path.c_str(), R_OK) == 0) {
+            data = allocateInputData();
+            if (data) {
+                loaded = loadInputDataFromCache(file_path, getInputDataRegions(*data));
+            }
+        }
+#ifdef _USE_MPI_
+        int all_loaded = 0;
+        MPI_Allreduce(&loaded, &all_loaded, 1, MPI_INT, MPI_LAND, executionSettings->communicator);
+        loaded = all_loaded;
+#endif
+        if (loaded) {
+            if (mpi_comm_rank == 0) {
+                std::cout << "Input data loaded from cache" << std::endl;
+            }
+            return data;
+        }
+        data = generateInputData();
+        auto regions = getInputDataRegions(*data);
+        if (!regions.empty()) {
+            storeInputDataToCache(file_path, regions);
+        }
+        else if (mpi_comm_rank == 0) {
+            std::cerr << "WARNING: Data cache is not supported by this benchmark!" << std::endl;
+        }
+        return data;
+    }
 
     /**
      * @brief Execute the benchmark kernel and measure performance
@@ -340,6 +1801,27 @@ public:
     virtual bool
     checkInputParameters() { return true;}
 
+    /**
+     * @brief Method that can be overwritten by inheriting classes to derive settings from the programmed bitstream,
+     *          e.g. the data type of the kernels. It is called on all ranks after the bitstream is programmed and
+     *          for every point of a sweep, before the input parameters are checked.
+     *          The program in the executionSettings is a nullptr, if the benchmark is only tested.
+     * 
+     */
+    virtual void
+    adaptSettingsToBitstream() {}
+
+    /**
+     * @brief Method that can be overwritten by inheriting classes to indicate that the calculation can share the work
+     *          between all devices in the execution settings. Otherwise, the setup will fail if more than one
+     *          device per rank is requested.
+     * 
+     * @return true If multiple devices per rank are supported
+     * @return false If only a single device per rank is supported
+     */
+    virtual bool
+    supportsMultipleDevices() { return false;}
+
     /**
     * Parses and returns program options using the cxxopts library.
     * The parsed parameters are depending on the benchmark that is implementing
@@ -369,6 +1851,8 @@ public:
                 ("f,file", "Kernel file name", cxxopts::value<std::string>())
                 ("n", "Number of repetitions",
                 cxxopts::value<uint>()->default_value(std::to_string(DEFAULT_REPETITIONS)))
+                ("warmup", "Number of additional repetitions that are executed before the measured repetitions. Their measurements are discarded",
+                cxxopts::value<uint>()->default_value("0"))
 #ifdef INTEL_FPGA
                 ("i", "Use memory Interleaving")
 #endif
@@ -376,6 +1860,40 @@ public:
                 ("device", "Index of the device that has to be used. If not given you "\
             "will be asked which device to use if there are multiple devices "\
             "available.", cxxopts::value<int>()->default_value(std::to_string(DEFAULT_DEVICE)))
+                ("devices-per-rank", "Number of devices used by every rank. The devices are selected consecutively starting with the given device. "\
+            "The work is shared between all devices, if it is supported by the benchmark",
+                cxxopts::value<uint>()->default_value("1"))
+                ("sweep", "Execute the benchmark for multiple values of an option within the same process and reuse the device setup. "\
+            "Give the option name and a comma separated list or a range start:end:step, e.g. s=1024,4096 or s=1024:8192:x2 to double the value",
+                cxxopts::value<std::string>()->default_value(""))
+                ("scale-replications", "Execute the benchmark for 1 up to the given number of kernel replications within the same process "\
+            "and report the throughput and parallel efficiency for every number of replications. The data is split over the used replications")
+                ("scale-ranks", "Execute the benchmark on nested sub-communicators of 1, 4, 16, ... ranks within the same job and report the parallel efficiency. "\
+            "Valid values: STRONG keeps the total problem size, WEAK the problem size per rank, BOTH executes both scalings",
+                cxxopts::value<std::string>()->default_value(""))
+                ("scaling-metric", "Name of the result that is used for the replication and rank scaling. By default, the first result given as a rate is used",
+                cxxopts::value<std::string>()->default_value(""))
+                ("power-source", "Sample the board power during the kernel execution and report the energy and performance per watt. "\
+            "Supported sources are sysfs, fpgainfo, xbutil, auto or cmd:<command> to parse the power in Watts from the output of a command",
+                cxxopts::value<std::string>()->default_value(""))
+                ("power-interval", "Time between two power samples in ms",
+                cxxopts::value<uint>()->default_value("10"))
+                ("soak", "Repeat the kernel execution for the given wall-clock duration in seconds and report the monitored result, "\
+            "the board temperature and power of every iteration. The input data is generated again before every iteration and the output of the last iteration is validated",
+                cxxopts::value<uint>()->default_value("0"))
+                ("soak-file", "Write the samples of the soak mode to the given file while the benchmark is running. "\
+            "Files ending with .prom are written in the Prometheus textfile format, all other files as CSV",
+                cxxopts::value<std::string>()->default_value(""))
+                ("soak-metric", "Name of the result that is monitored in the soak mode. By default, the first result given as a rate is used",
+                cxxopts::value<std::string>()->default_value(""))
+                ("soak-threshold", "Report an iteration as degraded, if the monitored result drops by more than the given percentage compared to the first iteration",
+                cxxopts::value<double>()->default_value("5"))
+                ("temperature-source", "Read the board temperature after every soak iteration. The same sources as for --power-source are supported",
+                cxxopts::value<std::string>()->default_value(""))
+                ("trace", "Record the host, MPI and device activity of all ranks and write it to the given file in the Chrome trace format",
+                cxxopts::value<std::string>()->default_value(""))
+                ("reuse-bitstream", "Do not reconfigure the FPGA, if it is already configured with the given kernel file. "\
+            "For Intel, the loaded bitstream is recorded by previous runs with this option, so the board must not be reconfigured by other applications in between")
                 ("platform", "Index of the platform that has to be used. If not given "\
             "you will be asked which platform to use if there are multiple "\
             "platforms available.",
@@ -389,6 +1907,27 @@ public:
                 cxxopts::value<std::string>()->default_value(DEFAULT_COMM_TYPE))
 #endif
                 ("test", "Only test given configuration and skip execution and validation")
+                ("dry-run-memory", "Only estimate the host and device memory required by the given configuration and compare it to the "\
+            "available memory. No data is generated and the kernel is not executed")
+                ("dump-json", "Dump the configuration and all measurement results of the benchmark to the given file in JSON format",
+                cxxopts::value<std::string>()->default_value(""))
+                ("baseline", "Compare the results with the JSON dump of an earlier run with the same settings and exit with an error, "\
+            "if a metric degraded by more than the tolerance",
+                cxxopts::value<std::string>()->default_value(""))
+                ("baseline-tolerance", "Accepted degradation of a metric compared to the baseline in percent. "\
+            "It is increased, if the variation of the repetitions of both runs is higher",
+                cxxopts::value<double>()->default_value("5"))
+                ("data-cache", "Directory used to store the generated input data of every MPI rank. If data for the same configuration is found in the directory, it is loaded instead of generated. Only supported by some benchmarks",
+                cxxopts::value<std::string>()->default_value(""))
+                ("numa-node", "NUMA node the host buffers are bound to. -1 uses the node the device is attached to, if it can be detected. Use -2 to disable the binding",
+                cxxopts::value<int>()->default_value("-1"))
+                ("hugepages", "Use huge pages for the host buffers to reduce the overhead of PCIe transfers. Optionally, the page size in MiB can be given e.g. --hugepages=1024 for 1 GiB pages",
+                cxxopts::value<uint>()->default_value("0")->implicit_value("2"))
+                ("memory-banks", "Memory banks the buffers of the kernel replications are placed in e.g. HBM pseudo-channels. "\
+                "Use a comma separated list with one bank per replication, separate the banks of the individual buffers of a replication with ':' "\
+                "or use rr:N for round robin placement over N banks. auto uses round robin placement over the banks read from the kernel file. "\
+                "A JSON file containing the banks of every replication as nested arrays in the key 'banks' can be given instead. By default, the benchmarks use their own placement",
+                cxxopts::value<std::string>()->default_value(""))
                 ("h,help", "Print this help");
 
 
@@ -441,6 +1980,119 @@ public:
         std::cout << *executionSettings << std::endl;
     }
 
+    /**
+     * @brief Write the configuration, the raw timings of all repetitions and the derived results
+     *          of the benchmark to a file in JSON format. It has to be called after collectAndPrintResults().
+     * 
+     * @param file_path Path to the output file. An existing file will be overwritten.
+     * @param validationSuccess Result of the output validation that will be contained in the dump
+     */
+    void
+    dumpConfigurationAndResults(const std::string &file_path, bool validationSuccess) {
+        std::ofstream fs(file_path, std::ofstream::out);
+        if (!fs.is_open()) {
+            std::cerr << "WARNING: Could not open " << file_path << " to dump the results!" << std::endl;
+            return;
+        }
+        json dump;
+        dump["version"] = VERSION;
+        dump["config_time"] = CONFIG_TIME;
+        dump["git_commit"] = GIT_COMMIT_HASH;
+#ifdef _USE_MPI_
+        dump["mpi"] = {{"version", MPI_VERSION}, {"subversion", MPI_SUBVERSION}};
+#endif
+        std::string device_name;
+        if (executionSettings->device) {
+            executionSettings->device->getInfo(CL_DEVICE_NAME, &device_name);
+        }
+        dump["device"] = device_name;
+        std::vector<std::string> device_names;
+        for (const auto &d : executionSettings->devices) {
+            device_names.push_back(d.getInfo<CL_DEVICE_NAME>());
+        }
+        dump["devices"] = device_names;
+        dump["kernel_file"] = executionSettings->programSettings->kernelFileName;
+        dump["settings"] = executionSettings->getSettingsMap();
+        dump["timings"] = timings;
+        json json_results;
+        for (const auto &r : results) {
+            json_results[r.first] = r.second.toJson();
+        }
+        dump["results"] = json_results;
+        if (!memoryUsage.is_null()) {
+            dump["memory"] = memoryUsage;
+        }
+        dump["validated"] = validationSuccess;
+        fs << dump.dump(4) << std::endl;
+    }
+
+    /**
+     * @brief Compare the results of the last execution with the JSON dump given with --baseline and print the
+     *          comparison of every metric. The settings of both runs have to be the same.
+     *          It has to be called after collectAndPrintResults() and is only executed on rank 0.
+     * 
+     * @return true If no metric degraded by more than the tolerance
+     * @return false If a metric degraded, the baseline can not be loaded or was created with different settings
+     */
+    bool
+    compareToBaseline() {
+        if (mpi_comm_rank != 0) {
+            return true;
+        }
+        const auto &settings = *executionSettings->programSettings;
+        std::cout << HLINE << "Compare results to baseline " << settings.baselineFile << std::endl << HLINE;
+        json reference;
+        try {
+            reference = baseline::loadBaseline(settings.baselineFile);
+        }
+        catch (const std::exception &e) {
+            std::cerr << "ERROR: " << e.what() << std::endl;
+            return false;
+        }
+        json current_settings = executionSettings->getSettingsMap();
+        auto differences = baseline::settingsDifferences(current_settings, reference.value("settings", json::object()));
+        if (!differences.empty()) {
+            for (const auto &d : differences) {
+                std::cerr << "ERROR: Setting '" << d << "' differs from the baseline!" << std::endl;
+            }
+            return false;
+        }
+        if (!reference.value("validated", true)) {
+            std::cerr << "WARNING: The output of the baseline run was not validated successfully!" << std::endl;
+        }
+        json current_results;
+        for (const auto &r : results) {
+            current_results[r.first] = r.second.toJson();
+        }
+        // Both runs contribute to the variation of the difference
+        double cv_current = baseline::maxVariation(json(timings));
+        double cv_reference = baseline::maxVariation(reference.value("timings", json::object()));
+        double variation = std::sqrt(cv_current * cv_current + cv_reference * cv_reference);
+        auto comparisons = baseline::compareResults(current_results, reference["results"],
+                                                    settings.baselineTolerance / 100.0, variation);
+        bool passed = true;
+        std::cout << std::setw(ENTRY_SPACE * 2) << "Metric" << std::setw(ENTRY_SPACE) << "Baseline"
+                  << std::setw(ENTRY_SPACE) << "Current" << std::setw(ENTRY_SPACE) << "Change %"
+                  << std::setw(ENTRY_SPACE) << "Tolerance %" << "  Status" << std::endl;
+        for (const auto &c : comparisons) {
+            std::cout << std::setw(ENTRY_SPACE * 2) << c.name << std::setw(ENTRY_SPACE) << c.baseline
+                      << std::setw(ENTRY_SPACE) << c.value << std::setw(ENTRY_SPACE) << c.change * 100.0
+                      << std::setw(ENTRY_SPACE) << c.tolerance * 100.0 << "  "
+                      << (c.passed ? "PASS" : (std::isnan(c.value) ? "FAIL (missing)" : "FAIL")) << std::endl;
+            passed = passed && c.passed;
+        }
+        if (comparisons.empty()) {
+            std::cerr << "WARNING: The baseline does not contain any comparable metric!" << std::endl;
+        }
+        if (passed) {
+            std::cout << "Baseline comparison: SUCCESS!" << std::endl;
+        }
+        else {
+            std::cerr << "ERROR: PERFORMANCE REGRESSION COMPARED TO THE BASELINE!" << std::endl;
+        }
+        return passed;
+    }
+
     /**
      * @brief Selects and prepares the target device and prints the final configuration.
      *          This method will initialize the executionSettings that are needed for the 
@@ -467,6 +2119,7 @@ public:
             strcpy(tmp_argv[i], argv[i]);
         }
         tmp_argv[argc] = nullptr;
+        programArguments.assign(argv, argv + argc);
 
         try {
 
@@ -475,18 +2128,50 @@ public:
             std::unique_ptr<cl::Context> context;
             std::unique_ptr<cl::Program> program;
             std::unique_ptr<cl::Device> usedDevice;
+            std::vector<cl::Device> usedDevices;
+
+            if (programSettings->devicesPerRank > 1 && !supportsMultipleDevices()) {
+                throw std::runtime_error("The benchmark does not support multiple devices per rank!");
+            }
+
+            if (programSettings->communicationType == CommunicationType::smi) {
+                // Fail before the bitstream is programmed instead of in the kernel execution
+                throw std::runtime_error("The communication type SMI is not implemented by the benchmarks!");
+            }
 
             if (!programSettings->testOnly) {
-                usedDevice = fpga_setup::selectFPGADevice(programSettings->defaultPlatform,
-                                                                    programSettings->defaultDevice);
+                usedDevices = fpga_setup::selectFPGADevices(programSettings->defaultPlatform,
+                                                                    programSettings->defaultDevice,
+                                                                    programSettings->devicesPerRank);
+                usedDevice = std::unique_ptr<cl::Device>(new cl::Device(usedDevices[0]));
 
-                context = std::unique_ptr<cl::Context>(new cl::Context(*usedDevice));
+                context = fpga_setup::createContext(*usedDevice, programSettings->kernelFileName,
+                                                                    programSettings->reuseBitstream);
                 program = fpga_setup::fpgaSetup(context.get(), {*usedDevice},
-                                                                    &programSettings->kernelFileName);
+                                                                    &programSettings->kernelFileName,
+                                                                    programSettings->reuseBitstream);
+                if (programSettings->numaNode == -1) {
+                    programSettings->numaNode = numa::getDeviceNode(*usedDevice);
+                }
+            }
+            numa::setDefaultNode(programSettings->numaNode);
+            numa::setHugepageSize(programSettings->hugepageSize);
+            if (!programSettings->memoryBanks.setTopology(programSettings->kernelFileName)) {
+                std::cerr << "WARNING: Memory topology could not be read from the kernel file. The default placement of the buffers is used." << std::endl;
             }
 
             executionSettings = std::unique_ptr<ExecutionSettings<TSettings>>(new ExecutionSettings<TSettings>(std::move(programSettings), std::move(usedDevice), 
                                                                     std::move(context), std::move(program)));
+            // Every additional device gets its own context and program, so they can be used independently
+            for (size_t i = 1; i < usedDevices.size(); i++) {
+                auto device_context = fpga_setup::createContext(usedDevices[i], executionSettings->programSettings->kernelFileName,
+                                                                    executionSettings->programSettings->reuseBitstream);
+                auto device_program = fpga_setup::fpgaSetup(device_context.get(), {usedDevices[i]},
+                                                                    &executionSettings->programSettings->kernelFileName,
+                                                                    executionSettings->programSettings->reuseBitstream);
+                executionSettings->addDevice(usedDevices[i], *device_context, *device_program);
+            }
+            adaptSettingsToBitstream();
             if (mpi_comm_rank == 0) {
                 if (!checkInputParameters()) {
                     std::cerr << "ERROR: Input parameter check failed!" << std::endl;
@@ -514,7 +2199,8 @@ public:
 
     /**
      * @brief Execute the benchmark. This includes the initialization of the 
-     *          input data, exectuon of the kernel, validation and printing the result
+     *          input data, exectuon of the kernel, validation and printing the result.
+     *          If a sweep is given in the program settings, this is done for every point of the sweep.
      * 
      * @return true If the validation is a success
      * @return false If the validation fails or an execution error occured
@@ -533,68 +2219,44 @@ public:
             }
             return benchmark_setup_succeeded;
         }
-        if (mpi_comm_rank == 0) {
-            std::cout << HLINE << "Start benchmark using the given configuration. Generating data..." << std::endl
-                    << HLINE;
+        if (executionSettings->programSettings->dryRunMemory) {
+            return executeMemoryDryRun();
         }
-       try {
-            auto gen_start = std::chrono::high_resolution_clock::now();
-            std::unique_ptr<TData> data = generateInputData();
-            std::chrono::duration<double> gen_time = std::chrono::high_resolution_clock::now() - gen_start;
-            
-#ifdef _USE_MPI_
-            MPI_Barrier(MPI_COMM_WORLD);
-#endif
-
-            if (mpi_comm_rank == 0) {
-                std::cout << "Generation Time: " << gen_time.count() << " s"  << std::endl;
-                std::cout << HLINE << "Execute benchmark kernel..." << std::endl
-                        << HLINE;
+        if (executionSettings->programSettings->soakDuration > 0) {
+            if (!executionSettings->programSettings->sweep.empty() || executionSettings->programSettings->scaleReplications
+                    || !executionSettings->programSettings->scaleRanks.empty() || !executionSettings->programSettings->baselineFile.empty()) {
+                std::cerr << "ERROR: The soak mode can not be combined with a sweep, a scaling or a baseline comparison!" << std::endl;
+                return false;
             }
-
-            bool validateSuccess = false;
-            auto exe_start = std::chrono::high_resolution_clock::now();
-            std::unique_ptr<TOutput> output =  executeKernel(*data);
-
-#ifdef _USE_MPI_
-        MPI_Barrier(MPI_COMM_WORLD);
-#endif
-
-            std::chrono::duration<double> exe_time = std::chrono::high_resolution_clock::now() - exe_start;
-
-            if (mpi_comm_rank == 0) {
-                std::cout << "Execution Time: " << exe_time.count() << " s"  << std::endl;
-                std::cout << HLINE << "Validate output..." << std::endl
-                        << HLINE;
+            return executeSoak();
+        }
+        if (!executionSettings->programSettings->baselineFile.empty()) {
+            if (!executionSettings->programSettings->sweep.empty() || executionSettings->programSettings->scaleReplications
+                    || !executionSettings->programSettings->scaleRanks.empty()) {
+                std::cerr << "ERROR: The baseline comparison can not be combined with a sweep or a scaling!" << std::endl;
+                return false;
             }
-
-            if (!executionSettings->programSettings->skipValidation) {
-                auto eval_start = std::chrono::high_resolution_clock::now();
-                validateSuccess = validateOutputAndPrintError(*data);
-                std::chrono::duration<double> eval_time = std::chrono::high_resolution_clock::now() - eval_start;
-
-                if (mpi_comm_rank == 0) {
-                    std::cout << "Validation Time: " << eval_time.count() << " s" << std::endl;
-                }
+            // A failed validation is already reported as error, so the results are only compared for a valid run
+            return executeConfiguration() && compareToBaseline();
+        }
+        if (!executionSettings->programSettings->scaleRanks.empty()) {
+            if (!executionSettings->programSettings->sweep.empty() || executionSettings->programSettings->scaleReplications) {
+                std::cerr << "ERROR: The rank scaling can not be combined with a sweep or the replication scaling!" << std::endl;
+                return false;
             }
-            collectAndPrintResults(*output);
-
-            if (mpi_comm_rank == 0) {
-                if (!validateSuccess) {
-                    std::cerr << "ERROR: VALIDATION OF OUTPUT DATA FAILED!" << std::endl;
-                }
-                else {
-                    std::cout << "Validation: SUCCESS!" << std::endl;
-                }
+            return executeRankScaling();
+        }
+        if (executionSettings->programSettings->scaleReplications) {
+            if (!executionSettings->programSettings->sweep.empty()) {
+                std::cerr << "ERROR: The replication scaling can not be combined with a sweep!" << std::endl;
+                return false;
             }
-
-            return validateSuccess;
-       }
-       catch (const std::exception& e) {
-            std::cerr << "An error occured while executing the benchmark: " << std::endl;
-            std::cerr << "\t" << e.what() << std::endl;
-            return false;
-       }
+            return executeReplicationScaling();
+        }
+        if (!executionSettings->programSettings->sweep.empty()) {
+            return executeSweep();
+        }
+        return executeConfiguration();
     }
 
     /**
@@ -606,6 +2268,15 @@ public:
         return *executionSettings;
     }
 
+    /**
+     * @brief Get the derived results of the last execution e.g. to combine the results of multiple benchmarks
+     * 
+     * @return const std::map<std::string, HpccResult>& The results. The key is the name of the metric.
+     */
+    const std::map<std::string, HpccResult>& getResults() const {
+        return results;
+    }
+
     HpccFpgaBenchmark(int argc, char* argv[]) {
 #ifdef _USE_MPI_
         int isMpiInitialized;
@@ -667,10 +2338,13 @@ std::ostream& operator<<(std::ostream& os, ExecutionSettings<TSettings> const& p
         else {
             device_name = "TEST RUN: Not selected!";
         }
-        for (auto k : printedExecutionSettings.programSettings->getSettingsMap()) {
+        for (auto k : printedExecutionSettings.getSettingsMap()) {
             os   << std::setw(2 * ENTRY_SPACE) << k.first << k.second << std::endl;
         }
         os  << std::setw(2 * ENTRY_SPACE) << "Device"  << device_name << std::endl;
+        for (size_t i = 1; i < printedExecutionSettings.devices.size(); i++) {
+            os  << std::setw(2 * ENTRY_SPACE) << ("Device " + std::to_string(i))  << printedExecutionSettings.devices[i].getInfo<CL_DEVICE_NAME>() << std::endl;
+        }
         os << std::right;
         return os;
 }
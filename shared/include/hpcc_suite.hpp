@@ -0,0 +1,344 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef HPCC_BASE_SUITE_H_
+#define HPCC_BASE_SUITE_H_
+
+/* C++ standard library headers */
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <stdexcept>
+
+/**
+ * @brief Contains the interface that is used to execute multiple benchmarks in a single process.
+ *          This header does not depend on the parameters.h of a benchmark, so it can be included by the suite
+ *          and by all benchmarks.
+ *
+ */
+namespace hpcc_suite {
+
+/**
+ * @brief A single result of a benchmark in the suite
+ *
+ */
+struct SuiteResult {
+
+    /**
+     * @brief The value of the result
+     *
+     */
+    double value;
+
+    /**
+     * @brief The unit of the value
+     *
+     */
+    std::string unit;
+};
+
+/**
+ * @brief Summary of a single benchmark that was executed by the suite
+ *
+ */
+struct BenchmarkSummary {
+
+    /**
+     * @brief Name of the benchmark that is used as prefix in the summary e.g. STREAM
+     *
+     */
+    std::string name;
+
+    /**
+     * @brief True, if the setup, execution and validation of the benchmark succeeded
+     *
+     */
+    bool success;
+
+    /**
+     * @brief The derived results of the benchmark like bandwidths or FLOP rates
+     *
+     */
+    std::map<std::string, SuiteResult> results;
+};
+
+/**
+ * @brief Split a string into program arguments at white spaces.
+ *          Arguments that contain white spaces can be given in single or double quotes.
+ *
+ * @param arguments The arguments as single string e.g. "-f kernel.aocx -n 5"
+ * @return std::vector<std::string> The separated arguments
+ */
+inline std::vector<std::string>
+splitArguments(const std::string &arguments) {
+    std::vector<std::string> result;
+    std::string current;
+    bool in_argument = false;
+    char quote = 0;
+    for (char c : arguments) {
+        if (quote != 0) {
+            if (c == quote) {
+                quote = 0;
+            }
+            else {
+                current.push_back(c);
+            }
+        }
+        else if (c == '"' || c == '\'') {
+            quote = c;
+            in_argument = true;
+        }
+        else if (c == ' ' || c == '\t' || c == '\n') {
+            if (in_argument) {
+                result.push_back(current);
+                current.clear();
+                in_argument = false;
+            }
+        }
+        else {
+            current.push_back(c);
+            in_argument = true;
+        }
+    }
+    if (quote != 0) {
+        throw std::runtime_error("Missing closing quote in arguments: " + arguments);
+    }
+    if (in_argument) {
+        result.push_back(current);
+    }
+    return result;
+}
+
+/**
+ * @brief Create the combined summary of all executed benchmarks in the key=value format of the HPCC output file.
+ *          Every result is prefixed with the name of its benchmark. The overall success is only given,
+ *          if all benchmarks succeeded.
+ *
+ * @param summaries The summaries of the executed benchmarks in the order of their execution
+ * @return std::string The summary section
+ */
+inline std::string
+formatSummary(const std::vector<BenchmarkSummary> &summaries) {
+    std::stringstream ss;
+    ss.precision(6);
+    ss << "Begin of Summary section." << std::endl;
+    bool success = true;
+    for (const auto &s : summaries) {
+        for (const auto &r : s.results) {
+            ss << s.name << "_" << r.first << "=" << r.second.value << std::endl;
+        }
+        ss << s.name << "_Success=" << (s.success ? 1 : 0) << std::endl;
+        success = success && s.success;
+    }
+    ss << "Success=" << ((success && !summaries.empty()) ? 1 : 0) << std::endl;
+    ss << "End of Summary section." << std::endl;
+    return ss.str();
+}
+
+/**
+ * @brief A benchmark kernel placed in the roofline model
+ *
+ */
+struct RooflineEntry {
+
+    /**
+     * @brief Name of the benchmark and the suffix of its results e.g. FFT_log12
+     *
+     */
+    std::string name;
+
+    /**
+     * @brief Arithmetic intensity of the kernel in FLOP/Byte
+     *
+     */
+    double intensity;
+
+    /**
+     * @brief The measured FLOP rate in GFLOP/s
+     *
+     */
+    double gflops;
+
+    /**
+     * @brief The attainable FLOP rate in GFLOP/s for the intensity of the kernel
+     *
+     */
+    double attainable;
+};
+
+/**
+ * @brief Place the kernels of all benchmarks that report an arithmetic intensity in the roofline model.
+ *          The memory roof is given by the best Triad rate of STREAM. The compute roof is only used if a peak is given.
+ *          The measured FLOP rate is taken from the gflops result or, if not available, from the gflops_min result
+ *          with the same suffix as the arithmetic intensity.
+ *
+ * @param summaries The summaries of the executed benchmarks. Has to contain the results of STREAM.
+ * @param peak_gflops The peak FLOP rate of the device in GFLOP/s or 0, if only the memory roof should be used
+ * @return std::vector<RooflineEntry> The roofline entries of all kernels in the order of the summaries.
+ *          Empty, if the Triad bandwidth is not available.
+ */
+inline std::vector<RooflineEntry>
+computeRoofline(const std::vector<BenchmarkSummary> &summaries, double peak_gflops) {
+    const std::string intensity_key = "arithmetic_intensity";
+    auto stream = std::find_if(summaries.begin(), summaries.end(), [](const BenchmarkSummary &s) {return s.name == "STREAM";});
+    std::vector<RooflineEntry> entries;
+    if (stream == summaries.end() || stream->results.count("Triad_best_rate") == 0) {
+        return entries;
+    }
+    // The bandwidth is given in MB/s
+    double bandwidth = stream->results.at("Triad_best_rate").value * 1.0e-3;
+    for (const auto &s : summaries) {
+        for (const auto &r : s.results) {
+            if (r.first.compare(0, intensity_key.size(), intensity_key) != 0) {
+                continue;
+            }
+            std::string suffix = r.first.substr(intensity_key.size());
+            auto rate = s.results.find("gflops" + suffix);
+            if (rate == s.results.end()) {
+                rate = s.results.find("gflops_min" + suffix);
+            }
+            if (rate == s.results.end()) {
+                continue;
+            }
+            double attainable = r.second.value * bandwidth;
+            if (peak_gflops > 0) {
+                attainable = std::min(attainable, peak_gflops);
+            }
+            entries.push_back({s.name + suffix, r.second.value, rate->second.value, attainable});
+        }
+    }
+    return entries;
+}
+
+/**
+ * @brief Create a summary that contains the attainable FLOP rate and the achieved fraction of it for every roofline entry,
+ *          so the roofline analysis is also contained in the combined summary
+ *
+ * @param entries The roofline entries
+ * @return BenchmarkSummary The summary with the name Roofline
+ */
+inline BenchmarkSummary
+rooflineSummary(const std::vector<RooflineEntry> &entries) {
+    BenchmarkSummary summary;
+    summary.name = "Roofline";
+    summary.success = !entries.empty();
+    for (const auto &e : entries) {
+        summary.results[e.name + "_attainable_gflops"] = {e.attainable, "GFLOP/s"};
+        summary.results[e.name + "_fraction"] = {e.gflops / e.attainable, ""};
+    }
+    return summary;
+}
+
+/**
+ * @brief Format the roofline entries as table, sorted by the achieved fraction of the attainable FLOP rate.
+ *          The kernels with the lowest fraction come first, because they have the highest potential for optimization.
+ *
+ * @param entries The roofline entries
+ * @return std::string The table
+ */
+inline std::string
+formatRoofline(std::vector<RooflineEntry> entries) {
+    std::sort(entries.begin(), entries.end(), [](const RooflineEntry &a, const RooflineEntry &b) {
+        return a.gflops / a.attainable < b.gflops / b.attainable;
+    });
+    std::stringstream ss;
+    ss.precision(4);
+    ss << std::setw(16) << std::left << "Kernel" << std::right
+        << std::setw(16) << "FLOP/Byte"
+        << std::setw(16) << "GFLOP/s"
+        << std::setw(16) << "Attainable"
+        << std::setw(12) << "Fraction" << std::endl;
+    for (const auto &e : entries) {
+        ss << std::setw(16) << std::left << e.name << std::right
+            << std::setw(16) << e.intensity
+            << std::setw(16) << e.gflops
+            << std::setw(16) << e.attainable
+            << std::setw(12) << e.gflops / e.attainable << std::endl;
+    }
+    return ss.str();
+}
+
+/**
+ * @brief Setup and execute a benchmark with the given arguments and collect its results.
+ *          Has to be instantiated in a source file of the benchmark, so it uses the parameters.h of the benchmark.
+ *          MPI has to be initialized before, so the benchmark will not finalize it.
+ *
+ * @tparam TBenchmark The benchmark class
+ * @param name Name of the benchmark used in the summary
+ * @param args The program arguments of the benchmark without the name of the executable
+ * @param execute The method that is used to execute the benchmark after its setup
+ * @return BenchmarkSummary The summary of the benchmark execution
+ */
+template<class TBenchmark>
+BenchmarkSummary
+runBenchmark(const std::string &name, const std::vector<std::string> &args, bool (TBenchmark::*execute)() = &TBenchmark::executeBenchmark) {
+    std::vector<std::string> arg_storage;
+    arg_storage.push_back(name);
+    arg_storage.insert(arg_storage.end(), args.begin(), args.end());
+    std::vector<char*> argv;
+    for (auto &a : arg_storage) {
+        argv.push_back(&a[0]);
+    }
+    argv.push_back(nullptr);
+
+    BenchmarkSummary summary;
+    summary.name = name;
+    TBenchmark bm(static_cast<int>(arg_storage.size()), argv.data());
+    summary.success = (bm.*execute)();
+    for (const auto &r : bm.getResults()) {
+        summary.results[r.first] = {r.second.value, r.second.unit};
+    }
+    return summary;
+}
+
+} // namespace hpcc_suite
+
+/**
+ * @brief Entry points of the benchmarks for the execution within the suite.
+ *          They are implemented in the suite_entry.cpp of every benchmark.
+ *
+ */
+namespace stream {
+    hpcc_suite::BenchmarkSummary runSuiteBenchmark(const std::vector<std::string> &args);
+}
+namespace random_access {
+    hpcc_suite::BenchmarkSummary runSuiteBenchmark(const std::vector<std::string> &args);
+}
+namespace transpose {
+    hpcc_suite::BenchmarkSummary runSuiteBenchmark(const std::vector<std::string> &args);
+}
+namespace fft {
+    hpcc_suite::BenchmarkSummary runSuiteBenchmark(const std::vector<std::string> &args);
+}
+namespace gemm {
+    hpcc_suite::BenchmarkSummary runSuiteBenchmark(const std::vector<std::string> &args);
+}
+namespace linpack {
+    hpcc_suite::BenchmarkSummary runSuiteBenchmark(const std::vector<std::string> &args);
+}
+namespace network {
+    hpcc_suite::BenchmarkSummary runSuiteBenchmark(const std::vector<std::string> &args);
+}
+
+#endif
@@ -0,0 +1,185 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef HPCC_BASE_KERNEL_COUNTERS_H_
+#define HPCC_BASE_KERNEL_COUNTERS_H_
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/* External libraries */
+#ifdef USE_DEPRECATED_HPP_HEADER
+#include "CL/cl.hpp"
+#else
+#include OPENCL_HPP_HEADER
+#endif
+
+/* Project's headers */
+#include "setup/fpga_setup.hpp"
+
+/**
+ * @brief Contains the host side of the device side kernel counters defined in shared/device/kernel_counters.h.
+ *          The kernels are only instrumented if the benchmark is built with USE_KERNEL_COUNTERS for Intel FPGA.
+ *
+ */
+namespace kernel_counters {
+
+/**
+ * @brief Index of the counters within the slot of a kernel. Has to match the definitions in kernel_counters.h.
+ *
+ */
+const uint CYCLES = 0;
+const uint ACTIVE = 1;
+const uint CHANNEL_STALLS = 2;
+const uint COUNTERS_PER_KERNEL = 3;
+
+/**
+ * @brief Buffer on the device that contains the counters of all instrumented kernels of a bitstream.
+ *          The kernels accumulate their counters, so the buffer has to be reset before every repetition.
+ *
+ */
+class KernelCounters {
+
+private:
+
+    /**
+     * @brief Name of the kernel of every counter slot
+     *
+     */
+    std::vector<std::string> slot_names;
+
+    /**
+     * @brief The counters that were read last from the device
+     *
+     */
+    std::vector<cl_ulong> values;
+
+    /**
+     * @brief The buffer on the device the kernels write their counters to
+     *
+     */
+    cl::Buffer buffer;
+
+public:
+
+    /**
+     * @brief Construct a new Kernel Counters object and create the counter buffer on the device
+     *
+     * @param context The context of the device
+     * @param names Name of the kernel of every slot in the order of the slots defined in the kernel code
+     */
+    KernelCounters(const cl::Context &context, const std::vector<std::string> &names) : slot_names(names),
+                    values(names.size() * COUNTERS_PER_KERNEL, 0) {
+        int err;
+        buffer = cl::Buffer(context, CL_MEM_READ_WRITE, sizeof(cl_ulong) * values.size(), nullptr, &err);
+        ASSERT_CL(err)
+    }
+
+    /**
+     * @brief Set the counter buffer as argument of an instrumented kernel
+     *
+     * @param kernel The kernel
+     * @param index The index of the counter argument. It is always the last argument of the kernel.
+     */
+    void
+    setKernelArg(cl::Kernel &kernel, cl_uint index) {
+        ASSERT_CL(kernel.setArg(index, buffer))
+    }
+
+    /**
+     * @brief Set all counters on the device to zero. Blocks until the counters are reset.
+     *
+     * @param queue The queue that is used for the transfer
+     */
+    void
+    reset(cl::CommandQueue &queue) {
+        std::fill(values.begin(), values.end(), 0);
+        ASSERT_CL(queue.enqueueWriteBuffer(buffer, CL_TRUE, 0, sizeof(cl_ulong) * values.size(), values.data()))
+    }
+
+    /**
+     * @brief Read the counters from the device. Has to be called after all kernels are finished.
+     *
+     * @param queue The queue that is used for the transfer
+     */
+    void
+    read(cl::CommandQueue &queue) {
+        ASSERT_CL(queue.enqueueReadBuffer(buffer, CL_TRUE, 0, sizeof(cl_ulong) * values.size(), values.data()))
+    }
+
+    /**
+     * @brief Get a counter of a slot that was read last from the device
+     *
+     * @param slot The slot of the kernel
+     * @param counter Index of the counter e.g. CYCLES
+     * @return cl_ulong The value of the counter
+     */
+    cl_ulong
+    get(uint slot, uint counter) const {
+        return values[slot * COUNTERS_PER_KERNEL + counter];
+    }
+
+    /**
+     * @brief Print the counters of all slots that were read last from the device.
+     *          The cycles that are not active and not stalled by channels are printed as memory stalls.
+     *          They also contain the latency of the pipelines, so they are only a good estimate for the memory stalls
+     *          if the kernel spends most of its time in the pipelined loops.
+     *
+     * @param repetition The repetition the counters belong to
+     * @param out The stream the counters are printed to
+     */
+    void
+    print(uint repetition, std::ostream &out = std::cout) const {
+        std::ios_base::fmtflags flags = out.flags();
+        std::streamsize precision = out.precision();
+        out << "Kernel counters of repetition " << repetition << ":" << std::endl;
+        out << std::setw(24) << std::left << "Kernel" << std::right
+            << std::setw(16) << "Cycles"
+            << std::setw(16) << "Active"
+            << std::setw(16) << "Channel Stalls"
+            << std::setw(16) << "Memory Stalls"
+            << std::setw(10) << "Active %" << std::endl;
+        for (uint s = 0; s < slot_names.size(); s++) {
+            cl_ulong cycles = get(s, CYCLES);
+            cl_ulong active = get(s, ACTIVE);
+            cl_ulong channel = get(s, CHANNEL_STALLS);
+            // The counters are sampled independently, so the difference may be slightly negative
+            cl_ulong memory = (cycles > active + channel) ? cycles - active - channel : 0;
+            double active_percent = (cycles > 0) ? 100.0 * static_cast<double>(active) / static_cast<double>(cycles) : 0.0;
+            out << std::setw(24) << std::left << slot_names[s] << std::right
+                << std::setw(16) << cycles
+                << std::setw(16) << active
+                << std::setw(16) << channel
+                << std::setw(16) << memory
+                << std::setw(10) << std::fixed << std::setprecision(2) << active_percent << std::endl;
+        }
+        out.flags(flags);
+        out.precision(precision);
+    }
+
+};
+
+} // namespace kernel_counters
+
+#endif // HPCC_BASE_KERNEL_COUNTERS_H_
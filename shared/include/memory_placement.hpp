@@ -0,0 +1,262 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef HPCC_BASE_MEMORY_PLACEMENT_H_
+#define HPCC_BASE_MEMORY_PLACEMENT_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/* External libraries */
+#ifdef USE_DEPRECATED_HPP_HEADER
+#include "CL/cl.hpp"
+#else
+#include OPENCL_HPP_HEADER
+#endif
+#ifdef INTEL_FPGA
+#include "CL/cl_ext_intelfpga.h"
+#endif
+#ifdef XILINX_FPGA
+#include "CL/cl_ext_xilinx.h"
+#endif
+
+/* Project's headers */
+#include "memory_tracker.hpp"
+
+/**
+ * @brief Contains the placement policy that maps the buffers of the kernel replications to memory banks
+ *          e.g. the pseudo-channels of HBM. The bandwidth only scales with the number of banks, if the buffers
+ *          of the replications are placed in distinct banks.
+ *
+ */
+namespace placement {
+
+/**
+ * @brief Read the memory topology of the device from the bitstream.
+ *          For Xilinx, the used memory banks are read from the MEM_TOPOLOGY section of the xclbin file.
+ *          The returned values are the topology indices of the DDR and HBM banks.
+ *          For Intel, the interfaces of the default global memory are counted in the board specification
+ *          that is embedded in the aocx file.
+ *
+ * @param kernel_file Path to the bitstream
+ * @return std::vector<int> The available memory banks. Empty, if the topology could not be read.
+ */
+std::vector<int>
+readMemoryTopology(const std::string &kernel_file);
+
+/**
+ * @brief Map from the buffers of every kernel replication to a memory bank.
+ *          The map is given as a string in one of the following formats:
+ *          - empty: Every benchmark uses its own default placement
+ *          - "0,1,2,3": All buffers of replication r are placed in the r-th bank of the list
+ *          - "0:1:2,3:4:5": The buffers of a replication are separated with ':', so buffer b of replication 1 is placed in the b-th bank of "3:4:5"
+ *          - "rr:32": Round robin over 32 banks. Buffer b of replication r is placed in bank (r * buffers_per_replication + b) % 32
+ *          - "auto": Round robin over the banks that are read from the bitstream with readMemoryTopology()
+ *          - a path to a JSON file ending with .json that contains the banks of every replication and buffer as
+ *              nested arrays in the key "banks" e.g. {"banks": [[0, 1, 2], [3, 4, 5]]}
+ *          If there are more replications than entries in the list, the list is repeated.
+ *
+ */
+class BankMap {
+
+    /**
+     * @brief The banks for every replication and buffer
+     *
+     */
+    std::vector<std::vector<int>> banks;
+
+    /**
+     * @brief Number of banks used for round robin placement. 0, if the explicit list is used
+     *
+     */
+    int roundRobinBanks = 0;
+
+    /**
+     * @brief True, if round robin placement over the detected memory topology is used
+     *
+     */
+    bool automatic = false;
+
+    /**
+     * @brief The memory banks of the device used for the automatic placement
+     *
+     */
+    std::vector<int> topology;
+
+    /**
+     * @brief The string the map was created from
+     *
+     */
+    std::string description;
+
+public:
+
+    /**
+     * @brief Construct an empty map, so the benchmarks use their default placement
+     *
+     */
+    BankMap() = default;
+
+    /**
+     * @brief Construct a new Bank Map object from its string representation
+     *
+     * @param map The map in one of the formats described for the class
+     * @throws std::runtime_error if the string or JSON file can not be parsed
+     */
+    explicit BankMap(const std::string &map);
+
+    /**
+     * @brief Set the memory topology that is used for the automatic placement
+     *
+     * @param kernel_file Path to the bitstream the topology is read from. Nothing is done, if the map does not use the automatic placement.
+     * @return true, if the map does not use the automatic placement or the topology could be read
+     */
+    bool
+    setTopology(const std::string &kernel_file);
+
+    /**
+     * @brief Check if the map is empty, so the benchmarks use their default placement
+     *
+     * @return true, if no placement is given
+     */
+    bool
+    empty() const {
+        return banks.empty() && roundRobinBanks == 0 && topology.empty();
+    }
+
+    /**
+     * @brief Get the memory bank of a buffer
+     *
+     * @param replication Index of the kernel replication
+     * @param buffer Index of the buffer within the replication
+     * @param buffers_per_replication Number of buffers every replication uses
+     * @param default_bank The bank that is returned, if the map is empty
+     * @return int The memory bank or default_bank, if the map is empty
+     */
+    int
+    bank(unsigned replication, unsigned buffer, unsigned buffers_per_replication, int default_bank = -1) const {
+        if (!topology.empty()) {
+            return topology[(replication * buffers_per_replication + buffer) % topology.size()];
+        }
+        if (roundRobinBanks > 0) {
+            return (replication * buffers_per_replication + buffer) % roundRobinBanks;
+        }
+        if (banks.empty()) {
+            return default_bank;
+        }
+        const std::vector<int> &replication_banks = banks[replication % banks.size()];
+        return replication_banks[buffer % replication_banks.size()];
+    }
+
+    /**
+     * @brief Get the string representation of the map
+     *
+     * @return std::string The map as it was given or "Default", if it is empty
+     */
+    std::string
+    toString() const {
+        if (automatic) {
+            return "auto (" + std::to_string(topology.size()) + " banks)";
+        }
+        return empty() ? "Default" : description;
+    }
+
+};
+
+/**
+ * @brief Callback of OpenCL that removes a released buffer from the memory tracker
+ *
+ */
+inline void CL_CALLBACK
+releaseTrackedBuffer(cl_mem buffer, void* bank) {
+    size_t size = 0;
+    clGetMemObjectInfo(buffer, CL_MEM_SIZE, sizeof(size), &size, nullptr);
+    memory_tracker::getTracker().recordDeviceFree(static_cast<int>(reinterpret_cast<intptr_t>(bank)), size);
+}
+
+/**
+ * @brief Add a buffer to the device memory accounting of the memory tracker.
+ *          The buffer is removed from the accounting, when it is released by the runtime.
+ *
+ * @param buffer The created buffer. Invalid buffers are ignored.
+ * @param bank The memory bank of the buffer. Negative values are accounted as placed by the runtime.
+ */
+inline void
+trackBuffer(const cl::Buffer &buffer, int bank) {
+    if (buffer() == nullptr) {
+        return;
+    }
+    size_t size = 0;
+    if (clGetMemObjectInfo(buffer(), CL_MEM_SIZE, sizeof(size), &size, nullptr) != CL_SUCCESS) {
+        return;
+    }
+    bank = (bank < 0) ? memory_tracker::DEFAULT_BANK : bank;
+    memory_tracker::getTracker().recordDeviceAllocation(bank, size);
+    clSetMemObjectDestructorCallback(buffer(), releaseTrackedBuffer, reinterpret_cast<void*>(static_cast<intptr_t>(bank)));
+}
+
+/**
+ * @brief Create a buffer in the given memory bank.
+ *          For Xilinx devices, the bank is selected at runtime with the memory topology index.
+ *          For Intel devices with HBM, the pseudo-channel is selected with the buffer_location attribute of the
+ *          kernel argument when the kernel is generated, so the kernel has to be generated with the same map.
+ *          For Intel devices without HBM, the bank is selected with the memory channel flags.
+ *
+ * @param context The OpenCL context
+ * @param flags The memory flags of the buffer
+ * @param size Size of the buffer in bytes
+ * @param bank The memory bank. Negative values leave the placement to the runtime.
+ * @param err Optional pointer to store the error code
+ * @return cl::Buffer The created buffer
+ */
+inline cl::Buffer
+createBuffer(const cl::Context &context, cl_mem_flags flags, size_t size, int bank, cl_int *err = nullptr) {
+    // The bank is not used, if the target does not support the placement
+    static_cast<void>(bank);
+#if defined(XILINX_FPGA) && defined(XCL_MEM_TOPOLOGY)
+    if (bank >= 0) {
+        cl_mem_ext_ptr_t ext;
+        ext.flags = static_cast<unsigned>(bank) | XCL_MEM_TOPOLOGY;
+        ext.obj = nullptr;
+        ext.param = 0;
+        cl::Buffer buffer(context, flags | CL_MEM_EXT_PTR_XILINX, size, &ext, err);
+        trackBuffer(buffer, bank);
+        return buffer;
+    }
+#endif
+#ifdef INTEL_FPGA
+#ifdef USE_HBM
+    flags |= CL_MEM_HETEROGENEOUS_INTELFPGA;
+#else
+    if (bank >= 0) {
+        flags |= ((bank + 1) << 16);
+    }
+#endif
+#endif
+    cl::Buffer buffer(context, flags, size, nullptr, err);
+    trackBuffer(buffer, bank);
+    return buffer;
+}
+
+} // namespace placement
+
+#endif
@@ -0,0 +1,311 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef HPCC_BASE_MEMORY_TRACKER_H_
+#define HPCC_BASE_MEMORY_TRACKER_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Contains the accounting of the host and device memory that is allocated by a benchmark
+ *
+ */
+namespace memory_tracker {
+
+/**
+ * @brief Bank index used for device buffers that are placed by the runtime
+ *
+ */
+const int DEFAULT_BANK = -1;
+
+/**
+ * @brief A single allocation that is expected for the current configuration of a benchmark.
+ *          It is used for the memory estimate of the dry run, so nothing has to be allocated.
+ *
+ */
+struct MemoryRequirement {
+
+    /**
+     * @brief Name of the allocation e.g. the name of the array or buffer
+     *
+     */
+    std::string name;
+
+    /**
+     * @brief Size of a single allocation in bytes
+     *
+     */
+    size_t bytes;
+
+    /**
+     * @brief Number of allocations of this size e.g. one buffer per kernel replication
+     *
+     */
+    size_t count;
+
+    /**
+     * @brief True, if the memory is allocated on the device instead of the host
+     *
+     */
+    bool device;
+};
+
+/**
+ * @brief Keeps track of the host memory allocated with numa::memalign() and the buffers created with
+ *          placement::createBuffer() or registered with trackBuffer(). Allocations can be recorded from multiple threads.
+ *
+ */
+class MemoryTracker {
+
+private:
+
+    /**
+     * @brief Sizes of the currently allocated host memory blocks
+     *
+     */
+    std::map<const void*, size_t> hostAllocations;
+
+    /**
+     * @brief Currently allocated host memory in bytes
+     *
+     */
+    size_t hostBytes = 0;
+
+    /**
+     * @brief Highest value of hostBytes since the start of the program
+     *
+     */
+    size_t peakHostBytes = 0;
+
+    /**
+     * @brief Currently allocated device memory in bytes per memory bank
+     *
+     */
+    std::map<int, size_t> deviceBytes;
+
+    /**
+     * @brief Highest value of deviceBytes per memory bank since the start of the program
+     *
+     */
+    std::map<int, size_t> peakDeviceBytes;
+
+    /**
+     * @brief Highest value of the sum of the device memory of all banks
+     *
+     */
+    size_t peakTotalDeviceBytes = 0;
+
+    /**
+     * @brief Mutex used to protect the counters
+     *
+     */
+    std::mutex mutex;
+
+public:
+
+    /**
+     * @brief Record a host memory block
+     *
+     * @param ptr Address of the block
+     * @param bytes Size of the block
+     */
+    void
+    recordHostAllocation(const void* ptr, size_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex);
+        hostAllocations[ptr] = bytes;
+        hostBytes += bytes;
+        peakHostBytes = std::max(peakHostBytes, hostBytes);
+    }
+
+    /**
+     * @brief Record that a host memory block was freed. Unknown addresses are ignored.
+     *
+     * @param ptr Address of the block
+     */
+    void
+    recordHostFree(const void* ptr) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = hostAllocations.find(ptr);
+        if (it != hostAllocations.end()) {
+            hostBytes -= it->second;
+            hostAllocations.erase(it);
+        }
+    }
+
+    /**
+     * @brief Record a device buffer
+     *
+     * @param bank Memory bank of the buffer or DEFAULT_BANK
+     * @param bytes Size of the buffer
+     */
+    void
+    recordDeviceAllocation(int bank, size_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex);
+        deviceBytes[bank] += bytes;
+        peakDeviceBytes[bank] = std::max(peakDeviceBytes[bank], deviceBytes[bank]);
+        size_t total = 0;
+        for (const auto &b : deviceBytes) {
+            total += b.second;
+        }
+        peakTotalDeviceBytes = std::max(peakTotalDeviceBytes, total);
+    }
+
+    /**
+     * @brief Record that a device buffer was released
+     *
+     * @param bank Memory bank of the buffer or DEFAULT_BANK
+     * @param bytes Size of the buffer
+     */
+    void
+    recordDeviceFree(int bank, size_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex);
+        deviceBytes[bank] -= std::min(deviceBytes[bank], bytes);
+    }
+
+    /**
+     * @brief Get the highest amount of tracked host memory
+     *
+     * @return size_t Bytes
+     */
+    size_t
+    getPeakHostBytes() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return peakHostBytes;
+    }
+
+    /**
+     * @brief Get the highest amount of device memory per memory bank
+     *
+     * @return std::map<int, size_t> Bytes for every bank. The key DEFAULT_BANK is used for buffers placed by the runtime.
+     */
+    std::map<int, size_t>
+    getPeakDeviceBytes() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return peakDeviceBytes;
+    }
+
+    /**
+     * @brief Get the highest amount of device memory of all banks together
+     *
+     * @return size_t Bytes
+     */
+    size_t
+    getPeakTotalDeviceBytes() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return peakTotalDeviceBytes;
+    }
+};
+
+/**
+ * @brief Get the memory tracker of the process
+ *
+ * @return MemoryTracker& The tracker used by the allocation functions of the benchmark framework
+ */
+inline MemoryTracker &
+getTracker() {
+    static MemoryTracker tracker;
+    return tracker;
+}
+
+/**
+ * @brief Get the peak resident set size of the process. This also contains memory that is not tracked e.g. std::vector.
+ *
+ * @return size_t Bytes or 0, if not available
+ */
+inline size_t
+peakResidentSetSize() {
+#ifdef __linux__
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        // ru_maxrss is given in KiB on Linux
+        return static_cast<size_t>(usage.ru_maxrss) * 1024;
+    }
+#endif
+    return 0;
+}
+
+/**
+ * @brief Get the size of the physical memory of the host
+ *
+ * @return size_t Bytes or 0, if not available
+ */
+inline size_t
+physicalMemorySize() {
+#ifdef __linux__
+    long pages = sysconf(_SC_PHYS_PAGES);
+    long page_size = sysconf(_SC_PAGESIZE);
+    if (pages > 0 && page_size > 0) {
+        return static_cast<size_t>(pages) * static_cast<size_t>(page_size);
+    }
+#endif
+    return 0;
+}
+
+/**
+ * @brief Format a number of bytes with a binary prefix
+ *
+ * @param bytes The number of bytes
+ * @return std::string e.g. "1.50 GiB"
+ */
+inline std::string
+formatBytes(double bytes) {
+    const char* units[] = {"B", "KiB", "MiB", "GiB", "TiB"};
+    int unit = 0;
+    while (bytes >= 1024.0 && unit < 4) {
+        bytes /= 1024.0;
+        unit++;
+    }
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(2) << bytes << " " << units[unit];
+    return ss.str();
+}
+
+/**
+ * @brief Sum up the estimated host or device memory
+ *
+ * @param requirements The estimated allocations
+ * @param device True to sum up the device memory, false for the host memory
+ * @return size_t Bytes
+ */
+inline size_t
+totalBytes(const std::vector<MemoryRequirement> &requirements, bool device) {
+    size_t total = 0;
+    for (const auto &r : requirements) {
+        total += (r.device == device) ? r.bytes * r.count : 0;
+    }
+    return total;
+}
+
+} // namespace memory_tracker
+
+#endif
@@ -0,0 +1,297 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef HPCC_BASE_NUMA_ALLOCATION_H_
+#define HPCC_BASE_NUMA_ALLOCATION_H_
+
+#include <cstdlib>
+#include <cstdio>
+#include <string>
+#include <fstream>
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <iostream>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#endif
+
+/* External libraries */
+#ifdef USE_DEPRECATED_HPP_HEADER
+#include "CL/cl.hpp"
+#else
+#include OPENCL_HPP_HEADER
+#endif
+
+/* Project's headers */
+#include "memory_tracker.hpp"
+
+/**
+ * @brief Contains helpers to allocate host buffers on the NUMA node the used FPGA is attached to.
+ *          The memory policy is only set for the allocated pages, so the pages are placed on the node
+ *          when they are touched first. No additional library is required, the kernel is called directly.
+ *          Optionally, the buffers can be backed by huge pages to reduce the TLB and DMA descriptor overhead
+ *          of large transfers.
+ *
+ */
+namespace numa {
+
+/**
+ * @brief Memory policy of mbind that restricts the allocation to the nodes in the mask (MPOL_BIND in linux/mempolicy.h)
+ *
+ */
+const int MPOL_BIND_POLICY = 2;
+
+/**
+ * @brief The node used by memalign(). Negative, if the memory should not be bound to a node.
+ *
+ * @return int& Reference to the node
+ */
+inline int&
+defaultNode() {
+    static int node = -1;
+    return node;
+}
+
+/**
+ * @brief Set the node all following allocations with memalign() will be bound to
+ *
+ * @param node The NUMA node. Negative values disable the binding
+ */
+inline void
+setDefaultNode(int node) {
+    defaultNode() = node;
+}
+
+/**
+ * @brief Size of the huge pages used by memalign() in MiB. 0, if huge pages should not be used.
+ *
+ * @return uint& Reference to the size
+ */
+inline uint&
+hugepageSize() {
+    static uint size = 0;
+    return size;
+}
+
+/**
+ * @brief Use huge pages for all following allocations with memalign()
+ *
+ * @param size_mib Size of the huge pages in MiB e.g. 2 or 1024. 0 disables the usage of huge pages
+ */
+inline void
+setHugepageSize(uint size_mib) {
+    hugepageSize() = size_mib;
+}
+
+/**
+ * @brief Sizes of the memory regions that were allocated with mmap, so they can be released with munmap in free()
+ *
+ * @return std::map<void*, size_t>& Map from the start address to the size of the mapping
+ */
+inline std::map<void*, size_t>&
+mappedRegions() {
+    static std::map<void*, size_t> regions;
+    return regions;
+}
+
+/**
+ * @brief Mutex used to protect the map of mapped regions
+ *
+ * @return std::mutex& The mutex
+ */
+inline std::mutex&
+mappedRegionsMutex() {
+    static std::mutex m;
+    return m;
+}
+
+/**
+ * @brief Get the NUMA node of a PCIe device from sysfs
+ *
+ * @param bdf The PCIe address of the device in the format DDDD:BB:DD.F
+ * @return int The NUMA node of the device or -1, if it is unknown
+ */
+inline int
+getNodeOfPciDevice(const std::string &bdf) {
+    std::ifstream fs("/sys/bus/pci/devices/" + bdf + "/numa_node");
+    int node = -1;
+    if (fs.is_open()) {
+        fs >> node;
+    }
+    return (fs.fail()) ? -1 : node;
+}
+
+/**
+ * @brief Get the PCIe address of the given OpenCL device.
+ *          The PCIe address is only available, if the runtime supports cl_khr_pci_bus_info.
+ *
+ * @param device The OpenCL device
+ * @return std::string The PCIe address in the format DDDD:BB:DD.F or an empty string, if it could not be detected
+ */
+inline std::string
+getDevicePciAddress(const cl::Device &device) {
+#ifdef CL_DEVICE_PCI_BUS_INFO_KHR
+    cl_device_pci_bus_info_khr info;
+    if (clGetDeviceInfo(device(), CL_DEVICE_PCI_BUS_INFO_KHR, sizeof(info), &info, nullptr) == CL_SUCCESS) {
+        char bdf[16];
+        snprintf(bdf, sizeof(bdf), "%04x:%02x:%02x.%x", info.pci_domain, info.pci_bus, info.pci_device, info.pci_function);
+        return bdf;
+    }
+#endif
+    return "";
+}
+
+/**
+ * @brief Get the NUMA node the given OpenCL device is attached to.
+ *          The PCIe address is only available, if the runtime supports cl_khr_pci_bus_info.
+ *
+ * @param device The OpenCL device
+ * @return int The NUMA node of the device or -1, if it could not be detected
+ */
+inline int
+getDeviceNode(const cl::Device &device) {
+    std::string bdf = getDevicePciAddress(device);
+    return bdf.empty() ? -1 : getNodeOfPciDevice(bdf);
+}
+
+/**
+ * @brief Set the memory policy of the pages in the given memory region, so they will be allocated on the given node
+ *
+ * @param ptr Start of the memory region. Should be aligned to the page size.
+ * @param size Size of the memory region in bytes
+ * @param node The NUMA node
+ * @return int 0 on success
+ */
+inline int
+bindToNode(void* ptr, size_t size, int node) {
+#if defined(__linux__) && defined(SYS_mbind)
+    if (node < 0 || node >= static_cast<int>(sizeof(unsigned long) * 8)) {
+        return -1;
+    }
+    unsigned long mask = 1ul << node;
+    return static_cast<int>(syscall(SYS_mbind, ptr, size, MPOL_BIND_POLICY, &mask, sizeof(mask) * 8 + 1, 0));
+#else
+    return -1;
+#endif
+}
+
+/**
+ * @brief Allocate memory backed by huge pages
+ *
+ * @param size Size of the memory in bytes
+ * @param size_mib Size of the huge pages in MiB
+ * @return void* Pointer to the memory or nullptr, if no huge pages are available
+ */
+inline void*
+allocateHugepages(size_t size, uint size_mib) {
+#if defined(__linux__) && defined(MAP_HUGETLB)
+    size_t page_size = static_cast<size_t>(size_mib) << 20;
+    size_t mapped_size = (size + page_size - 1) / page_size * page_size;
+    int page_size_log = 0;
+    while ((static_cast<size_t>(1) << page_size_log) < page_size) {
+        page_size_log++;
+    }
+    // Encode the page size in the flags as it is done by MAP_HUGE_2MB and MAP_HUGE_1GB
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (page_size_log << 26);
+    void* ptr = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (ptr == MAP_FAILED) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(mappedRegionsMutex());
+    mappedRegions()[ptr] = mapped_size;
+    return ptr;
+#else
+    return nullptr;
+#endif
+}
+
+/**
+ * @brief Replacement for posix_memalign that binds the allocated memory to the node set with setDefaultNode().
+ *          In this case, the alignment is increased to the page size.
+ *          If the binding fails, the memory is allocated without it.
+ *          If huge pages are selected with setHugepageSize(), the memory is mapped with huge pages instead.
+ *          It falls back to normal pages, if not enough huge pages are available.
+ *          The memory has to be freed with numa::free().
+ *
+ * @param ptr Pointer that will contain the address of the allocated memory
+ * @param alignment Minimum alignment of the memory in bytes
+ * @param size Size of the memory in bytes
+ * @return int 0 on success, the error code of posix_memalign otherwise
+ */
+inline int
+memalign(void** ptr, size_t alignment, size_t size) {
+    int node = defaultNode();
+    if (hugepageSize() > 0 && size > 0) {
+        void* hp = allocateHugepages(size, hugepageSize());
+        if (hp != nullptr) {
+            if (node >= 0) {
+                bindToNode(hp, size, node);
+            }
+            *ptr = hp;
+            memory_tracker::getTracker().recordHostAllocation(hp, size);
+            return 0;
+        }
+        std::cerr << "WARNING: Not enough huge pages of size " << hugepageSize() << " MiB available. Fall back to normal pages." << std::endl;
+    }
+    if (node >= 0) {
+#ifdef __linux__
+        alignment = std::max(alignment, static_cast<size_t>(sysconf(_SC_PAGESIZE)));
+#endif
+    }
+    int err = posix_memalign(ptr, alignment, size);
+    if (err == 0 && node >= 0 && size > 0) {
+        bindToNode(*ptr, size, node);
+    }
+    if (err == 0) {
+        memory_tracker::getTracker().recordHostAllocation(*ptr, size);
+    }
+    return err;
+}
+
+/**
+ * @brief Free memory that was allocated with memalign()
+ *
+ * @param ptr Pointer to the memory
+ */
+inline void
+free(void* ptr) {
+    memory_tracker::getTracker().recordHostFree(ptr);
+#ifdef __linux__
+    {
+        std::lock_guard<std::mutex> lock(mappedRegionsMutex());
+        auto it = mappedRegions().find(ptr);
+        if (it != mappedRegions().end()) {
+            munmap(ptr, it->second);
+            mappedRegions().erase(it);
+            return;
+        }
+    }
+#endif
+    std::free(ptr);
+}
+
+} // namespace numa
+
+#endif
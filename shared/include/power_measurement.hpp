@@ -0,0 +1,220 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef HPCC_BASE_POWER_MEASUREMENT_H_
+#define HPCC_BASE_POWER_MEASUREMENT_H_
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* External libraries */
+#ifdef USE_DEPRECATED_HPP_HEADER
+#include "CL/cl.hpp"
+#else
+#include OPENCL_HPP_HEADER
+#endif
+
+/**
+ * @brief Contains the sampling of the board power during the execution of the benchmark kernels.
+ *          The sampled power is used to calculate the energy and the performance per watt of the benchmarks.
+ *
+ */
+namespace power {
+
+/**
+ * @brief Function that reads the current power of the board in Watt
+ *
+ */
+typedef std::function<double()> PowerSource;
+
+/**
+ * @brief Result of a power measurement
+ *
+ */
+struct PowerMeasurement {
+
+    /**
+     * @brief Average power over the measurement in Watt
+     *
+     */
+    double averagePower;
+
+    /**
+     * @brief Maximum sampled power in Watt
+     *
+     */
+    double maxPower;
+
+    /**
+     * @brief Consumed energy in Joule integrated over all samples
+     *
+     */
+    double energy;
+
+    /**
+     * @brief Duration of the measurement in seconds
+     *
+     */
+    double duration;
+
+    /**
+     * @brief Number of power samples
+     *
+     */
+    size_t samples;
+};
+
+/**
+ * @brief Samples a power source in a background thread between the calls of start() and stop()
+ *
+ */
+class PowerSampler {
+
+    /**
+     * @brief Timestamp and power in Watt of a single sample
+     *
+     */
+    typedef std::pair<std::chrono::high_resolution_clock::time_point, double> Sample;
+
+    PowerSource source;
+
+    std::chrono::milliseconds interval;
+
+    std::vector<Sample> samples;
+
+    std::chrono::high_resolution_clock::time_point startTime;
+
+    std::atomic<bool> running;
+
+    std::thread thread;
+
+    /**
+     * @brief Exception thrown by the power source in the sampling thread. It is rethrown by stop()
+     *
+     */
+    std::exception_ptr error;
+
+    void
+    sample();
+
+public:
+
+    /**
+     * @brief Construct a new Power Sampler
+     *
+     * @param source The power source that is sampled
+     * @param interval The time between two samples
+     */
+    PowerSampler(PowerSource source, std::chrono::milliseconds interval);
+
+    /**
+     * @brief Stops the sampling thread if it is still running
+     *
+     */
+    ~PowerSampler();
+
+    /**
+     * @brief Start the sampling in a background thread. Previous samples are discarded.
+     *          The first sample is taken immediately.
+     *
+     */
+    void
+    start();
+
+    /**
+     * @brief Stop the sampling and calculate the energy and average power over all samples
+     *
+     * @return PowerMeasurement The measurement since the last call of start()
+     * @throw std::runtime_error if the power source failed during the measurement
+     */
+    PowerMeasurement
+    stop();
+};
+
+/**
+ * @brief Parse the power in Watt from the output of a board management tool like fpgainfo or xbutil.
+ *          The first number that is followed by the unit Watts or W is used.
+ *
+ * @param output The output of the tool
+ * @return double The power in Watt
+ * @throw std::runtime_error if the output does not contain a power value
+ */
+double
+parsePowerOutput(const std::string &output);
+
+/**
+ * @brief Create a power source for the given device. The following sources are supported:
+ *          - "sysfs": Read power1_input of the hwmon interface of the PCIe device (e.g. xocl/xmgmt driver)
+ *          - "fpgainfo": Parse the output of `fpgainfo power` of the Intel OPAE tools
+ *          - "xbutil": Parse the output of `xbutil examine -r electrical` of XRT
+ *          - "cmd:<command>": Parse the output of an arbitrary command with parsePowerOutput()
+ *          - "auto": Use sysfs if it is available for the device, fpgainfo for Intel and xbutil for Xilinx otherwise
+ *
+ * @param name Name of the power source
+ * @param device The device whose power should be measured
+ * @return PowerSource The power source
+ * @throw std::runtime_error if the source is not supported or not available for the device
+ */
+PowerSource
+createPowerSource(const std::string &name, const cl::Device &device);
+
+/**
+ * @brief Function that reads the current temperature of the board in degree Celsius
+ *
+ */
+typedef std::function<double()> TemperatureSource;
+
+/**
+ * @brief Parse the temperature in degree Celsius from the output of a board management tool like fpgainfo or xbutil.
+ *          The first number that is followed by the unit Celsius or C is used.
+ *
+ * @param output The output of the tool
+ * @return double The temperature in degree Celsius
+ * @throw std::runtime_error if the output does not contain a temperature value
+ */
+double
+parseTemperatureOutput(const std::string &output);
+
+/**
+ * @brief Create a temperature source for the given device. The same sources as for the power are supported:
+ *          - "sysfs": Read temp1_input of the hwmon interface of the PCIe device
+ *          - "fpgainfo": Parse the output of `fpgainfo temp` of the Intel OPAE tools
+ *          - "xbutil": Parse the output of `xbutil examine -r thermal` of XRT
+ *          - "cmd:<command>": Parse the output of an arbitrary command with parseTemperatureOutput()
+ *          - "auto": Use sysfs if it is available for the device, fpgainfo for Intel and xbutil for Xilinx otherwise
+ *
+ * @param name Name of the temperature source
+ * @param device The device whose temperature should be measured
+ * @return TemperatureSource The temperature source
+ * @throw std::runtime_error if the source is not supported or not available for the device
+ */
+TemperatureSource
+createTemperatureSource(const std::string &name, const cl::Device &device);
+
+} // namespace power
+
+#endif
@@ -0,0 +1,276 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef HPCC_BASE_PROFILING_H_
+#define HPCC_BASE_PROFILING_H_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <limits>
+#include <algorithm>
+#include <cctype>
+
+/* External libraries */
+#ifdef USE_DEPRECATED_HPP_HEADER
+#include "CL/cl.hpp"
+#else
+#include OPENCL_HPP_HEADER
+#endif
+
+/* Project's headers */
+#include "setup/fpga_setup.hpp"
+#include "tracing.hpp"
+
+/**
+ * @brief Contains helpers to measure the device-side execution time of OpenCL commands
+ *          using the OpenCL event profiling. All command queues that are used with these helpers
+ *          have to be created with the property PROFILING_QUEUE_PROPERTIES.
+ *
+ */
+namespace profiling {
+
+/**
+ * @brief Properties that have to be used for the creation of command queues that are profiled
+ *
+ */
+const cl_command_queue_properties PROFILING_QUEUE_PROPERTIES = CL_QUEUE_PROFILING_ENABLE;
+
+/**
+ * @brief Device-side timestamps of a single OpenCL command like a kernel execution or a buffer transfer
+ *
+ */
+struct DeviceTiming {
+
+    /**
+     * @brief Name of the profiled command e.g. "kernel" or "write_A"
+     *
+     */
+    std::string name;
+
+    /**
+     * @brief The kernel replication the command was executed for
+     *
+     */
+    uint replication;
+
+    /**
+     * @brief The repetition the command was executed in
+     *
+     */
+    uint repetition;
+
+    /**
+     * @brief Device timestamp in ns when the command started its execution
+     *
+     */
+    cl_ulong start;
+
+    /**
+     * @brief Device timestamp in ns when the command finished its execution
+     *
+     */
+    cl_ulong end;
+
+    /**
+     * @brief Get the execution time of the command on the device
+     *
+     * @return double the execution time in seconds
+     */
+    double
+    duration() const {
+        return static_cast<double>(end - start) * 1.0e-9;
+    }
+};
+
+/**
+ * @brief Collects the events of profiled OpenCL commands and converts them into DeviceTimings
+ *        after the commands are completed.
+ *        Events can be recorded from multiple threads.
+ *
+ */
+class EventProfiler {
+
+private:
+
+    /**
+     * @brief A recorded event that was not converted to a DeviceTiming yet
+     *
+     */
+    struct PendingEvent {
+        std::string name;
+        uint replication;
+        cl::Event event;
+        int64_t hostTime;
+    };
+
+    /**
+     * @brief Events that were recorded since the last call to collect()
+     *
+     */
+    std::vector<PendingEvent> pending;
+
+    /**
+     * @brief Mutex used to protect the list of pending events
+     *
+     */
+    std::mutex pending_mutex;
+
+    /**
+     * @brief Offset in ns that is added to the device timestamps to get the host time.
+     *          It is estimated with the smallest difference between the host time of the enqueue and the queued timestamp of the device.
+     *
+     */
+    int64_t deviceClockOffset = std::numeric_limits<int64_t>::max();
+
+    /**
+     * @brief Add the timings of the pending events to the trace. The device timestamps are converted to the host time.
+     *
+     * @param first First timing that belongs to the pending events
+     * @param last End of the timings that belong to the pending events
+     */
+    void
+    traceDeviceTimings(std::vector<DeviceTiming>::const_iterator first, std::vector<DeviceTiming>::const_iterator last) {
+        for (auto &p : pending) {
+            cl_ulong queued;
+            ASSERT_CL(p.event.getProfilingInfo(CL_PROFILING_COMMAND_QUEUED, &queued))
+            deviceClockOffset = std::min(deviceClockOffset, p.hostTime - static_cast<int64_t>(queued));
+        }
+        tracing::Tracer &tracer = tracing::getTracer();
+        for (auto t = first; t != last; t++) {
+            std::string lower_name = t->name;
+            std::transform(lower_name.begin(), lower_name.end(), lower_name.begin(), ::tolower);
+            bool is_transfer = lower_name.find("write") != std::string::npos || lower_name.find("read") != std::string::npos;
+            uint32_t track = tracing::DEVICE_TRACK_OFFSET + t->replication;
+            tracer.setTrackName(track, "Device Replication " + std::to_string(t->replication));
+            tracer.recordSpan(t->name, is_transfer ? "transfer" : "kernel", track,
+                              static_cast<int64_t>(t->start) + deviceClockOffset, static_cast<int64_t>(t->end) + deviceClockOffset);
+        }
+    }
+
+public:
+
+    /**
+     * @brief All timings that were collected so far
+     *
+     */
+    std::vector<DeviceTiming> timings;
+
+    /**
+     * @brief Record the event of an enqueued command.
+     *
+     * @param name Name of the command
+     * @param replication The kernel replication the command belongs to
+     * @param event The event that was returned by the enqueue call. The queue has to be created with profiling enabled.
+     */
+    void
+    record(const std::string &name, uint replication, const cl::Event &event) {
+        int64_t host_time = tracing::Tracer::now();
+        std::lock_guard<std::mutex> lock(pending_mutex);
+        pending.push_back({name, replication, event, host_time});
+        if (tracing::getTracer().isEnabled()) {
+            tracing::getTracer().recordInstant("enqueue " + name, "enqueue", tracing::DEVICE_TRACK_OFFSET + replication, host_time);
+        }
+    }
+
+    /**
+     * @brief Wait for all recorded events and convert them to DeviceTimings.
+     *          It should be called after the queues are finished, so the host waiting time is not
+     *          influencing the measurement.
+     *
+     * @param repetition The repetition all pending events belong to
+     */
+    void
+    collect(uint repetition) {
+        std::lock_guard<std::mutex> lock(pending_mutex);
+        for (auto &p : pending) {
+            ASSERT_CL(p.event.wait())
+            cl_ulong start;
+            cl_ulong end;
+            ASSERT_CL(p.event.getProfilingInfo(CL_PROFILING_COMMAND_START, &start))
+            ASSERT_CL(p.event.getProfilingInfo(CL_PROFILING_COMMAND_END, &end))
+            timings.push_back({p.name, p.replication, repetition, start, end});
+        }
+        if (tracing::getTracer().isEnabled()) {
+            traceDeviceTimings(timings.end() - pending.size(), timings.end());
+        }
+        pending.clear();
+    }
+
+};
+
+/**
+ * @brief Convert a list of device timings into a map of execution times.
+ *          The keys are build from the command name and its replication e.g. "kernel_0".
+ *          The value contains the summed up execution time of all commands with the same
+ *          name and replication for every repetition.
+ *
+ * @param timings The device timings that should be converted
+ * @return std::map<std::string, std::vector<double>> map of execution times in seconds
+ */
+inline std::map<std::string, std::vector<double>>
+toTimingsMap(const std::vector<DeviceTiming> &timings) {
+    std::map<std::string, std::vector<double>> map;
+    for (const auto &t : timings) {
+        auto &v = map[t.name + "_" + std::to_string(t.replication)];
+        if (v.size() <= t.repetition) {
+            v.resize(t.repetition + 1, 0.0);
+        }
+        v[t.repetition] += t.duration();
+    }
+    return map;
+}
+
+/**
+ * @brief Calculate the time span on the device between the first start and the last end of
+ *          the commands with the given name for every repetition. This includes the skew between
+ *          the kernel replications.
+ *
+ * @param timings The device timings
+ * @param name Name of the commands that should be considered
+ * @return std::vector<double> The time span in seconds for every repetition
+ */
+inline std::vector<double>
+getTotalSpan(const std::vector<DeviceTiming> &timings, const std::string &name) {
+    std::vector<cl_ulong> starts;
+    std::vector<cl_ulong> ends;
+    for (const auto &t : timings) {
+        if (t.name != name) {
+            continue;
+        }
+        if (starts.size() <= t.repetition) {
+            starts.resize(t.repetition + 1, std::numeric_limits<cl_ulong>::max());
+            ends.resize(t.repetition + 1, 0);
+        }
+        starts[t.repetition] = std::min(starts[t.repetition], t.start);
+        ends[t.repetition] = std::max(ends[t.repetition], t.end);
+    }
+    std::vector<double> spans;
+    for (size_t i = 0; i < starts.size(); i++) {
+        spans.push_back((ends[i] > starts[i]) ? static_cast<double>(ends[i] - starts[i]) * 1.0e-9 : 0.0);
+    }
+    return spans;
+}
+
+} // namespace profiling
+
+#endif
@@ -0,0 +1,166 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef HPCC_BASE_RDMA_BUFFER_H_
+#define HPCC_BASE_RDMA_BUFFER_H_
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+/* Project's headers */
+#include "memory_placement.hpp"
+
+/**
+ * @brief Contains the device buffers used by the RDMA communication type.
+ *          The buffers are allocated in device memory that is exposed in the PCIe BAR of the FPGA and stay mapped
+ *          during their whole lifetime. The mapped pointer addresses the device memory itself, so an MPI library
+ *          with peer-to-peer support e.g. UCX with dma-buf can transfer the data between the NIC and the FPGA without
+ *          a copy to host memory.
+ *
+ */
+namespace rdma {
+
+/**
+ * @brief Check, if the host code was compiled with a runtime that can allocate device buffers in the PCIe BAR
+ *
+ * @return true if P2P buffers can be created
+ */
+inline bool
+isSupported() {
+#if defined(XILINX_FPGA) && defined(XCL_MEM_EXT_P2P_BUFFER)
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief A device buffer in the PCIe BAR of the FPGA that is mapped into the address space of the host.
+ *          The buffer can not be copied, because it is unmapped on destruction.
+ *
+ */
+class P2PBuffer {
+
+    /**
+     * @brief Queue used to map and unmap the buffer
+     *
+     */
+    cl::CommandQueue queue;
+
+    /**
+     * @brief The device buffer
+     *
+     */
+    cl::Buffer buffer;
+
+    /**
+     * @brief Host pointer to the mapped device memory
+     *
+     */
+    void* mapped = nullptr;
+
+    /**
+     * @brief Size of the buffer in bytes
+     *
+     */
+    size_t size;
+
+public:
+
+    /**
+     * @brief Allocate a buffer in the PCIe BAR of the device and map it into the address space of the host
+     *
+     * @param context The context used for the allocation
+     * @param device The device that holds the buffer
+     * @param size_ Size of the buffer in bytes
+     * @throw std::runtime_error if P2P buffers are not supported or the buffer could not be created
+     */
+    P2PBuffer(const cl::Context &context, const cl::Device &device, size_t size_) : size(size_) {
+#if defined(XILINX_FPGA) && defined(XCL_MEM_EXT_P2P_BUFFER)
+        int err;
+        queue = cl::CommandQueue(context, device, 0, &err);
+        if (err != CL_SUCCESS) {
+            throw std::runtime_error("Command queue for P2P buffer could not be created: " + std::to_string(err));
+        }
+        cl_mem_ext_ptr_t ext;
+        ext.flags = XCL_MEM_EXT_P2P_BUFFER;
+        ext.obj = nullptr;
+        ext.param = 0;
+        buffer = cl::Buffer(context, CL_MEM_READ_WRITE | CL_MEM_EXT_PTR_XILINX, size, &ext, &err);
+        if (err != CL_SUCCESS) {
+            throw std::runtime_error("P2P buffer could not be created: " + std::to_string(err) +
+                                ". Make sure P2P is enabled for the device e.g. with xbutil configure --p2p enable");
+        }
+        mapped = queue.enqueueMapBuffer(buffer, CL_TRUE, CL_MAP_READ | CL_MAP_WRITE, 0, size, nullptr, nullptr, &err);
+        if (err != CL_SUCCESS) {
+            throw std::runtime_error("P2P buffer could not be mapped: " + std::to_string(err));
+        }
+        placement::trackBuffer(buffer, memory_tracker::DEFAULT_BANK);
+#else
+        static_cast<void>(context);
+        static_cast<void>(device);
+        throw std::runtime_error("P2P buffers are not supported by the used OpenCL runtime. The RDMA communication type requires a Xilinx device with P2P support");
+#endif
+    }
+
+    P2PBuffer(const P2PBuffer&) = delete;
+    P2PBuffer& operator=(const P2PBuffer&) = delete;
+
+    ~P2PBuffer() {
+        if (mapped != nullptr) {
+            queue.enqueueUnmapMemObject(buffer, mapped);
+            queue.finish();
+        }
+    }
+
+    /**
+     * @brief The device buffer that can be used as kernel argument
+     *
+     */
+    cl::Buffer&
+    getBuffer() {
+        return buffer;
+    }
+
+    /**
+     * @brief Host pointer to the device memory that can be passed to MPI
+     *
+     */
+    template<typename T>
+    T*
+    data() {
+        return reinterpret_cast<T*>(mapped);
+    }
+
+    /**
+     * @brief Size of the buffer in bytes
+     *
+     */
+    size_t
+    getSize() const {
+        return size;
+    }
+};
+
+} // namespace rdma
+
+#endif
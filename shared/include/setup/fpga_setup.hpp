@@ -122,17 +122,55 @@ line number.
 */
 #define ASSERT_CL(err) fpga_setup::handleClReturnCode(err, __FILE__, __LINE__);
 
+/**
+Calculates an ID of the given bitstream that is used to check if it is already loaded on a device.
+For xclbin files, the UUID from the file header is used. For all other files,
+a 64 bit FNV-1a hash of the whole file is used.
+
+@param data Pointer to the content of the bitstream file
+@param size Size of the bitstream file in bytes
+@return The ID as string of hexadecimal digits
+*/
+    std::string
+    getBitstreamId(const unsigned char *data, size_t size);
+
+/**
+Reads the ID of the bitstream that is currently loaded on the device.
+For Xilinx, the UUID of the loaded xclbin is read from the driver in sysfs.
+Otherwise, the ID recorded by a previous run with fpgaSetup() is used.
+
+@param device The OpenCL device
+@return The ID in the same format as getBitstreamId() or an empty string, if it is unknown
+*/
+    std::string
+    getLoadedBitstreamId(const cl::Device &device);
+
+/**
+Creates the context for the given device.
+If reuseLoadedBitstream is set and the device is already configured with the given
+kernel file, the context is created in a way that the runtime will not reconfigure the FPGA.
+
+@param device The OpenCL device
+@param usedKernelFile The path to the kernel file that will be used with the context
+@param reuseLoadedBitstream Skip the reconfiguration, if the bitstream is already loaded on the device
+@return The created context
+*/
+    std::unique_ptr<cl::Context>
+    createContext(const cl::Device &device, const std::string &usedKernelFile, bool reuseLoadedBitstream);
+
 /**
 Sets up the given FPGA with the kernel in the provided file.
+The file is memory-mapped and passed to the runtime without copying it.
 
 @param context The context used for the program
 @param program The devices used for the program
 @param usedKernelFile The path to the kernel file
+@param reuseLoadedBitstream Record the loaded bitstream for every device, so the reconfiguration can be skipped by later runs
 @return The program that is used to create the benchmark kernels
 */
     std::unique_ptr<cl::Program>
     fpgaSetup(const cl::Context *context, std::vector<cl::Device> deviceList,
-              const std::string *usedKernelFile);
+              const std::string *usedKernelFile, bool reuseLoadedBitstream = false);
 
 /**
 Sets up the C++ environment by configuring std::cout and checking the clock
@@ -159,5 +197,23 @@ choose a device.
     std::unique_ptr<cl::Device>
     selectFPGADevice(int defaultPlatform, int defaultDevice);
 
+/**
+Searches and selects multiple FPGA devices that are used by the same rank.
+The selected devices are consecutive in the list of available devices.
+
+@param defaultPlatform The index of the platform that has to be used. If a
+                        value < 0 is given, the platform can be chosen
+                        interactively
+@param defaultDevice The index of the first device that has to be used. If a
+                        value < 0 is given, the device can be chosen
+                        interactively for a single device. With MPI or multiple devices,
+                        every rank uses the next count devices.
+@param count The number of devices that will be selected
+
+@return A list containing the selected devices
+*/
+    std::vector<cl::Device>
+    selectFPGADevices(int defaultPlatform, int defaultDevice, uint count);
+
 }  // namespace fpga_setup
 #endif  // SRC_HOST_FPGA_SETUP_H_
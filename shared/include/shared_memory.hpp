@@ -0,0 +1,285 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef HPCC_BASE_SHARED_MEMORY_H_
+#define HPCC_BASE_SHARED_MEMORY_H_
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/* External library headers */
+#include "mpi.h"
+
+/**
+ * @brief Contains helpers to exchange data between MPI ranks on the same node over shared memory.
+ *          The ranks can directly read the data of other ranks on the node instead of copying it with MPI.
+ *
+ */
+namespace shared_memory {
+
+/**
+ * @brief Alignment of the segments in the shared buffer in bytes. The segments are used as host pointers of
+ *          OpenCL buffers, so they are aligned like the other host buffers.
+ *
+ */
+const size_t SEGMENT_ALIGNMENT = 4096;
+
+/**
+ * @brief A buffer that contains a segment of the same size for every rank of a communicator.
+ *          The segments of the ranks on the same node are allocated with MPI_Win_allocate_shared, so every rank can
+ *          directly access the segments of the other ranks on its node. The creation and destruction are collective
+ *          operations of the communicator.
+ *          Accesses to the segments of other ranks have to be ordered by a synchronization of the involved ranks
+ *          which is enclosed by calls to synchronize().
+ *
+ */
+class NodeSharedBuffer {
+
+private:
+
+    /**
+     * @brief Communicator that contains the ranks that share their segments
+     *
+     */
+    MPI_Comm node_comm = MPI_COMM_NULL;
+
+    /**
+     * @brief The shared memory window that contains the segments
+     *
+     */
+    MPI_Win window = MPI_WIN_NULL;
+
+    /**
+     * @brief The rank in node_comm for every rank of the communicator or MPI_UNDEFINED for ranks on other nodes
+     *
+     */
+    std::vector<int> node_ranks;
+
+    /**
+     * @brief Size of a segment in bytes
+     *
+     */
+    size_t segment_size;
+
+    /**
+     * @brief The local segment
+     *
+     */
+    char* local_segment = nullptr;
+
+public:
+
+    /**
+     * @brief Construct a new Node Shared Buffer object
+     *
+     * @param comm The communicator. All ranks of it have to construct the buffer.
+     * @param size Size of a segment in bytes
+     * @param enabled If false, the segments are not shared and every rank can only access its own segment.
+     *                  This can be used to compare the shared memory exchange with the exchange over MPI.
+     */
+    NodeSharedBuffer(MPI_Comm comm, size_t size, bool enabled = true) : segment_size(size) {
+        int comm_rank;
+        int comm_size;
+        MPI_Comm_rank(comm, &comm_rank);
+        MPI_Comm_size(comm, &comm_size);
+        if (enabled) {
+            MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, comm_rank, MPI_INFO_NULL, &node_comm);
+        }
+        else {
+            MPI_Comm_split(comm, comm_rank, 0, &node_comm);
+        }
+        // Round up the segments so all of them are aligned if they are allocated contiguously
+        size_t aligned_size = ((size + SEGMENT_ALIGNMENT - 1) / SEGMENT_ALIGNMENT) * SEGMENT_ALIGNMENT;
+        MPI_Info info;
+        MPI_Info_create(&info);
+        // Every segment can then be placed on the NUMA node of its rank
+        MPI_Info_set(info, "alloc_shared_noncontig", "true");
+        int err = MPI_Win_allocate_shared(static_cast<MPI_Aint>(aligned_size), 1, info, node_comm, &local_segment, &window);
+        MPI_Info_free(&info);
+        if (err != MPI_SUCCESS) {
+            MPI_Comm_free(&node_comm);
+            throw std::runtime_error("Allocation of shared memory window failed!");
+        }
+        // Remote segments are accessed with load and store operations, so a passive access epoch is kept open
+        MPI_Win_lock_all(MPI_MODE_NOCHECK, window);
+
+        std::vector<int> comm_ranks(comm_size);
+        for (int r = 0; r < comm_size; r++) {
+            comm_ranks[r] = r;
+        }
+        node_ranks.resize(comm_size);
+        MPI_Group comm_group;
+        MPI_Group node_group;
+        MPI_Comm_group(comm, &comm_group);
+        MPI_Comm_group(node_comm, &node_group);
+        MPI_Group_translate_ranks(comm_group, comm_size, comm_ranks.data(), node_group, node_ranks.data());
+        MPI_Group_free(&comm_group);
+        MPI_Group_free(&node_group);
+    }
+
+    NodeSharedBuffer(const NodeSharedBuffer&) = delete;
+    NodeSharedBuffer& operator=(const NodeSharedBuffer&) = delete;
+
+    /**
+     * @brief Destroy the Node Shared Buffer object and free the shared memory.
+     *          The segments of other ranks must not be accessed anymore.
+     *
+     */
+    ~NodeSharedBuffer() {
+        int isMpiFinalized;
+        MPI_Finalized(&isMpiFinalized);
+        if (!isMpiFinalized) {
+            MPI_Win_unlock_all(window);
+            MPI_Win_free(&window);
+            MPI_Comm_free(&node_comm);
+        }
+    }
+
+    /**
+     * @brief Check, if the segment of a rank can be accessed directly
+     *
+     * @param rank The rank in the communicator of the buffer
+     * @return true if the rank shares its segment with this rank
+     */
+    bool
+    isShared(int rank) const {
+        return rank >= 0 && rank < static_cast<int>(node_ranks.size()) && node_ranks[rank] != MPI_UNDEFINED;
+    }
+
+    /**
+     * @brief Check, if all ranks of the communicator share their segments
+     *
+     * @return true if all segments can be accessed directly
+     */
+    bool
+    isNodeLocal() const {
+        for (int r : node_ranks) {
+            if (r == MPI_UNDEFINED) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Get the segment of this rank
+     *
+     * @tparam T Data type the segment is interpreted as
+     * @param offset Offset in the segment in bytes
+     * @return T* Pointer to the segment
+     */
+    template<typename T>
+    T*
+    data(size_t offset = 0) {
+        return reinterpret_cast<T*>(local_segment + offset);
+    }
+
+    /**
+     * @brief Get the segment of another rank on the same node
+     *
+     * @tparam T Data type the segment is interpreted as
+     * @param rank The rank in the communicator of the buffer
+     * @param offset Offset in the segment in bytes
+     * @return T* Pointer to the segment of the rank
+     */
+    template<typename T>
+    T*
+    data(int rank, size_t offset) {
+        if (!isShared(rank)) {
+            throw std::runtime_error("Segment of rank " + std::to_string(rank) + " is not shared with this rank!");
+        }
+        MPI_Aint size;
+        int disp_unit;
+        char* segment;
+        MPI_Win_shared_query(window, node_ranks[rank], &size, &disp_unit, &segment);
+        return reinterpret_cast<T*>(segment + offset);
+    }
+
+    /**
+     * @brief Translate a pointer into the local segment to the same position in the segment of another rank
+     *
+     * @tparam T Data type the segment is interpreted as
+     * @param local Pointer into the local segment
+     * @param rank The rank in the communicator of the buffer
+     * @return T* Pointer to the same position in the segment of the rank
+     */
+    template<typename T>
+    T*
+    translate(T* local, int rank) {
+        return data<T>(rank, reinterpret_cast<char*>(local) - local_segment);
+    }
+
+    /**
+     * @brief Check, if a pointer points into the local segment
+     *
+     * @param ptr The pointer
+     * @return true if it points into the local segment
+     */
+    bool
+    isLocalSegment(const void* ptr) const {
+        const char* p = reinterpret_cast<const char*>(ptr);
+        return p >= local_segment && p < local_segment + segment_size;
+    }
+
+    /**
+     * @brief Synchronize the private and public copy of the window. Has to be called before and after
+     *          the ranks are synchronized e.g. with a barrier or a message to make the stores of other ranks visible.
+     *
+     */
+    void
+    synchronize() {
+        MPI_Win_sync(window);
+    }
+
+    /**
+     * @brief Synchronize all ranks of a communicator, so all stores to the segments before the call are visible
+     *          to all ranks afterwards
+     *
+     * @param comm The communicator that is synchronized
+     */
+    void
+    fence(MPI_Comm comm) {
+        synchronize();
+        MPI_Barrier(comm);
+        synchronize();
+    }
+
+    /**
+     * @brief Synchronize with a single rank, so the stores of both ranks to the segments before the call are visible
+     *          to both ranks afterwards
+     *
+     * @param rank The rank in comm that is synchronized with. It has to call this method with this rank.
+     * @param comm The communicator of the ranks
+     */
+    void
+    fence(int rank, MPI_Comm comm) {
+        synchronize();
+        MPI_Sendrecv(nullptr, 0, MPI_BYTE, rank, 0, nullptr, 0, MPI_BYTE, rank, 0, comm, MPI_STATUS_IGNORE);
+        synchronize();
+    }
+
+};
+
+}  // namespace shared_memory
+
+#endif // HPCC_BASE_SHARED_MEMORY_H_
@@ -0,0 +1,225 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef HPCC_BASE_SOAK_H_
+#define HPCC_BASE_SOAK_H_
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+/**
+ * @brief Contains the time series output of the soak mode, that repeats the benchmark execution for a given wall-clock duration
+ *
+ */
+namespace soak {
+
+/**
+ * @brief Measurements of a single soak iteration. Sensor values that are not measured are NaN.
+ *
+ */
+struct SoakSample {
+
+    /**
+     * @brief Index of the iteration starting with 0
+     *
+     */
+    unsigned iteration;
+
+    /**
+     * @brief Time since the start of the soak run in seconds
+     *
+     */
+    double elapsed;
+
+    /**
+     * @brief Value of the monitored throughput result
+     *
+     */
+    double throughput;
+
+    /**
+     * @brief Highest board temperature of all devices in degree Celsius
+     *
+     */
+    double temperature;
+
+    /**
+     * @brief Average board power of all devices during the iteration in Watt
+     *
+     */
+    double power;
+
+    /**
+     * @brief True, if the throughput dropped below the threshold relative to the first iteration
+     *
+     */
+    bool degraded;
+};
+
+/**
+ * @brief Check, if the throughput of an iteration is degraded compared to the reference value
+ *
+ * @param value The throughput of the iteration
+ * @param reference The throughput of the first iteration
+ * @param threshold Allowed drop of the throughput in percent
+ * @return true if the value is more than threshold percent lower than the reference
+ */
+inline bool
+isDegraded(double value, double reference, double threshold) {
+    return value < reference * (1.0 - threshold / 100.0);
+}
+
+/**
+ * @brief Writes the soak samples to a file while the benchmark is running.
+ *          If the file name ends with .prom, the file is written in the Prometheus text exposition format
+ *          and replaced with the latest sample after every iteration, so it can be read by the textfile collector
+ *          of the node exporter. Otherwise, every sample is appended as a line of a CSV file.
+ *
+ */
+class SoakWriter {
+
+    /**
+     * @brief Path to the output file
+     *
+     */
+    std::string path;
+
+    /**
+     * @brief Name of the monitored metric
+     *
+     */
+    std::string metric;
+
+    /**
+     * @brief Unit of the monitored metric
+     *
+     */
+    std::string unit;
+
+    /**
+     * @brief True, if the Prometheus format is used
+     *
+     */
+    bool prometheus;
+
+    /**
+     * @brief Number of degraded iterations so far
+     *
+     */
+    unsigned degradedIterations = 0;
+
+    /**
+     * @brief Stream of the CSV file
+     *
+     */
+    std::ofstream csv;
+
+    /**
+     * @brief Format a value for the output. NaN is written as empty field for CSV and NaN for Prometheus.
+     *
+     */
+    std::string
+    format(double value) const {
+        if (std::isnan(value)) {
+            return prometheus ? "NaN" : "";
+        }
+        std::stringstream ss;
+        ss << std::setprecision(10) << value;
+        return ss.str();
+    }
+
+public:
+
+    /**
+     * @brief Construct a new Soak Writer and write the header of the CSV file
+     *
+     * @param path_ Path to the output file
+     * @param metric_ Name of the monitored result e.g. gflops
+     * @param unit_ Unit of the monitored result
+     * @throw std::runtime_error if the file can not be opened
+     */
+    SoakWriter(const std::string &path_, const std::string &metric_, const std::string &unit_) : path(path_),
+                    metric(metric_), unit(unit_) {
+        prometheus = path.size() > 5 && path.compare(path.size() - 5, 5, ".prom") == 0;
+        if (!prometheus) {
+            csv.open(path);
+            if (!csv.is_open()) {
+                throw std::runtime_error("Soak output file could not be opened: " + path);
+            }
+            csv << "iteration,elapsed_s," << metric << "_" << unit << ",temperature_C,power_W,degraded" << std::endl;
+        }
+    }
+
+    /**
+     * @brief Write a sample. The CSV file is flushed after every sample, so it can be observed during the run.
+     *
+     * @param s The sample
+     * @throw std::runtime_error if the Prometheus file can not be written
+     */
+    void
+    write(const SoakSample &s) {
+        degradedIterations += s.degraded ? 1 : 0;
+        if (!prometheus) {
+            csv << s.iteration << "," << format(s.elapsed) << "," << format(s.throughput) << ","
+                << format(s.temperature) << "," << format(s.power) << "," << (s.degraded ? 1 : 0) << std::endl;
+            return;
+        }
+        // Write to a temporary file and rename it, so the collector never reads a partially written file
+        std::string tmp_path = path + ".tmp";
+        {
+            std::ofstream fs(tmp_path);
+            if (!fs.is_open()) {
+                throw std::runtime_error("Soak output file could not be opened: " + tmp_path);
+            }
+            std::string label = "{metric=\"" + metric + "\",unit=\"" + unit + "\"}";
+            fs << "# HELP hpcc_soak_throughput Monitored result of the last soak iteration" << std::endl
+               << "# TYPE hpcc_soak_throughput gauge" << std::endl
+               << "hpcc_soak_throughput" << label << " " << format(s.throughput) << std::endl
+               << "# HELP hpcc_soak_temperature_celsius Highest board temperature in the last soak iteration" << std::endl
+               << "# TYPE hpcc_soak_temperature_celsius gauge" << std::endl
+               << "hpcc_soak_temperature_celsius " << format(s.temperature) << std::endl
+               << "# HELP hpcc_soak_power_watts Average board power in the last soak iteration" << std::endl
+               << "# TYPE hpcc_soak_power_watts gauge" << std::endl
+               << "hpcc_soak_power_watts " << format(s.power) << std::endl
+               << "# HELP hpcc_soak_iterations_total Number of executed soak iterations" << std::endl
+               << "# TYPE hpcc_soak_iterations_total counter" << std::endl
+               << "hpcc_soak_iterations_total " << (s.iteration + 1) << std::endl
+               << "# HELP hpcc_soak_degraded_iterations_total Number of soak iterations below the degradation threshold" << std::endl
+               << "# TYPE hpcc_soak_degraded_iterations_total counter" << std::endl
+               << "hpcc_soak_degraded_iterations_total " << degradedIterations << std::endl
+               << "# HELP hpcc_soak_elapsed_seconds Time since the start of the soak run" << std::endl
+               << "# TYPE hpcc_soak_elapsed_seconds gauge" << std::endl
+               << "hpcc_soak_elapsed_seconds " << format(s.elapsed) << std::endl;
+        }
+        if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+            throw std::runtime_error("Soak output file could not be replaced: " + path);
+        }
+    }
+};
+
+} // namespace soak
+
+#endif
@@ -0,0 +1,160 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef HPCC_BASE_STATISTICS_H_
+#define HPCC_BASE_STATISTICS_H_
+
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <stdexcept>
+
+/**
+ * @brief Contains helpers to calculate statistics over the measurements of all repetitions of a benchmark
+ *
+ */
+namespace statistics {
+
+/**
+ * @brief Coefficient of variation above which the measurements are considered to be unstable
+ *
+ */
+const double CV_WARNING_THRESHOLD = 0.05;
+
+/**
+ * @brief Statistics of a series of measurements
+ *
+ */
+struct Statistics {
+
+    /**
+     * @brief Smallest measurement
+     *
+     */
+    double min;
+
+    /**
+     * @brief Largest measurement
+     *
+     */
+    double max;
+
+    /**
+     * @brief Arithmetic mean of the measurements
+     *
+     */
+    double mean;
+
+    /**
+     * @brief Median of the measurements
+     *
+     */
+    double median;
+
+    /**
+     * @brief Sample standard deviation of the measurements. 0 for a single measurement
+     *
+     */
+    double stddev;
+
+    /**
+     * @brief 95th percentile of the measurements
+     *
+     */
+    double p95;
+
+    /**
+     * @brief 99th percentile of the measurements
+     *
+     */
+    double p99;
+
+    /**
+     * @brief Coefficient of variation, the standard deviation divided by the mean
+     *
+     */
+    double cv;
+};
+
+/**
+ * @brief Get a percentile of sorted measurements using the nearest-rank method
+ *
+ * @param sorted The measurements sorted in ascending order. Must not be empty.
+ * @param p The percentile in the range (0,1]
+ * @return double The smallest measurement that is larger or equal to p of all measurements
+ */
+inline double
+percentile(const std::vector<double> &sorted, double p) {
+    size_t rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+    return sorted[std::min(std::max(rank, static_cast<size_t>(1)), sorted.size()) - 1];
+}
+
+/**
+ * @brief Calculate the statistics of the given measurements
+ *
+ * @param values The measurements of all repetitions
+ * @return Statistics The statistics of the measurements
+ * @throw std::runtime_error if no measurements are given
+ */
+inline Statistics
+computeStatistics(const std::vector<double> &values) {
+    if (values.empty()) {
+        throw std::runtime_error("Statistics can not be calculated without measurements!");
+    }
+    std::vector<double> sorted(values);
+    std::sort(sorted.begin(), sorted.end());
+    Statistics s;
+    s.min = sorted.front();
+    s.max = sorted.back();
+    s.mean = std::accumulate(sorted.begin(), sorted.end(), 0.0) / sorted.size();
+    size_t mid = sorted.size() / 2;
+    s.median = (sorted.size() % 2 == 0) ? (sorted[mid - 1] + sorted[mid]) / 2.0 : sorted[mid];
+    double sum_sq = 0.0;
+    for (double v : sorted) {
+        sum_sq += (v - s.mean) * (v - s.mean);
+    }
+    s.stddev = (sorted.size() > 1) ? std::sqrt(sum_sq / (sorted.size() - 1)) : 0.0;
+    s.p95 = percentile(sorted, 0.95);
+    s.p99 = percentile(sorted, 0.99);
+    s.cv = (s.mean != 0.0) ? s.stddev / s.mean : 0.0;
+    return s;
+}
+
+/**
+ * @brief Remove the measurements of the warm-up repetitions. At least one measurement is kept.
+ *
+ * @param values The measurements of all repetitions including the warm-up
+ * @param warmup The number of warm-up repetitions at the beginning of the measurements
+ * @return std::vector<double> The remaining measurements
+ */
+inline std::vector<double>
+discardWarmup(const std::vector<double> &values, size_t warmup) {
+    if (values.empty()) {
+        return values;
+    }
+    size_t discarded = std::min(warmup, values.size() - 1);
+    return std::vector<double>(values.begin() + discarded, values.end());
+}
+
+} // namespace statistics
+
+#endif
@@ -0,0 +1,291 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef HPCC_BASE_TRACING_H_
+#define HPCC_BASE_TRACING_H_
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Contains the recording of a timeline of the host, MPI and device activity of all ranks.
+ *          The timeline is written in the Chrome trace event format and can be opened with
+ *          chrome://tracing or https://ui.perfetto.dev
+ *
+ */
+namespace tracing {
+
+/**
+ * @brief Track of the host thread that executes the benchmark
+ *
+ */
+const uint32_t HOST_TRACK = 0;
+
+/**
+ * @brief Track of the MPI calls
+ *
+ */
+const uint32_t MPI_TRACK = 1;
+
+/**
+ * @brief The commands of a kernel replication on the device are recorded on the track DEVICE_TRACK_OFFSET + replication
+ *
+ */
+const uint32_t DEVICE_TRACK_OFFSET = 100;
+
+/**
+ * @brief A single recorded activity
+ *
+ */
+struct TraceEvent {
+
+    /**
+     * @brief Name of the activity e.g. the name of the MPI function or the profiled command
+     *
+     */
+    std::string name;
+
+    /**
+     * @brief Category of the activity: host, mpi, kernel, transfer or enqueue
+     *
+     */
+    std::string category;
+
+    /**
+     * @brief Track the event is shown on
+     *
+     */
+    uint32_t track;
+
+    /**
+     * @brief Start time in ns relative to the epoch of the tracer
+     *
+     */
+    int64_t start;
+
+    /**
+     * @brief Duration in ns. Negative for instant events
+     *
+     */
+    int64_t duration;
+};
+
+/**
+ * @brief Records the activity of a rank. All timestamps are converted to the clock of rank 0 using the offset
+ *          determined by synchronizeClocks(). Events can be recorded from multiple threads.
+ *
+ */
+class Tracer {
+
+private:
+
+    /**
+     * @brief True, if events are recorded
+     *
+     */
+    bool enabled = false;
+
+    /**
+     * @brief Host time in ns that is used as time zero of the trace
+     *
+     */
+    int64_t epoch = 0;
+
+    /**
+     * @brief Offset in ns that is added to the local host time to get the time of rank 0
+     *
+     */
+    int64_t clockOffset = 0;
+
+    /**
+     * @brief All events recorded since the tracer was enabled
+     *
+     */
+    std::vector<TraceEvent> events;
+
+    /**
+     * @brief Names of the tracks that are used by the recorded events
+     *
+     */
+    std::map<uint32_t, std::string> trackNames;
+
+    /**
+     * @brief Mutex used to protect the events
+     *
+     */
+    std::mutex events_mutex;
+
+public:
+
+    /**
+     * @brief Get the current host time
+     *
+     * @return int64_t host time in ns of a monotonic clock
+     */
+    static int64_t
+    now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * @brief Check if events are recorded. Used to skip the recording with low overhead.
+     *
+     */
+    bool
+    isEnabled() const {
+        return enabled;
+    }
+
+    /**
+     * @brief Remove all recorded events and start the recording. If MPI is used, the clocks of all ranks are
+     *          synchronized, so this has to be called by all ranks.
+     *
+     */
+    void
+    start();
+
+    /**
+     * @brief Stop the recording. The recorded events are kept until the next call of start()
+     *
+     */
+    void
+    stop() {
+        enabled = false;
+    }
+
+    /**
+     * @brief Record an activity with a duration
+     *
+     * @param name Name of the activity
+     * @param category Category of the activity
+     * @param track Track the activity is shown on
+     * @param start Local host time in ns when the activity started
+     * @param end Local host time in ns when the activity ended
+     */
+    void
+    recordSpan(const std::string &name, const std::string &category, uint32_t track, int64_t start, int64_t end) {
+        if (!enabled) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(events_mutex);
+        events.push_back({name, category, track, start + clockOffset - epoch, end - start});
+    }
+
+    /**
+     * @brief Record an activity without duration like the enqueue of a command
+     *
+     * @param name Name of the activity
+     * @param category Category of the activity
+     * @param track Track the activity is shown on
+     * @param time Local host time in ns of the activity
+     */
+    void
+    recordInstant(const std::string &name, const std::string &category, uint32_t track, int64_t time) {
+        if (!enabled) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(events_mutex);
+        events.push_back({name, category, track, time + clockOffset - epoch, -1});
+    }
+
+    /**
+     * @brief Set the name of a track that is shown in the timeline
+     *
+     * @param track The track
+     * @param name The name of the track
+     */
+    void
+    setTrackName(uint32_t track, const std::string &name) {
+        std::lock_guard<std::mutex> lock(events_mutex);
+        trackNames[track] = name;
+    }
+
+    /**
+     * @brief Get the events recorded by this rank
+     *
+     */
+    const std::vector<TraceEvent> &
+    getEvents() const {
+        return events;
+    }
+
+    /**
+     * @brief Serialize the events of this rank to a comma separated list of Chrome trace events
+     *
+     * @param rank The MPI rank that is used as process id of the events
+     * @return std::string The serialized events without enclosing brackets
+     */
+    std::string
+    toChromeTraceEvents(int rank);
+
+    /**
+     * @brief Write the recorded events of all ranks to a single file in the Chrome trace event format.
+     *          The events are collected by rank 0, so this has to be called by all ranks.
+     *
+     * @param path Path to the output file
+     * @throw std::runtime_error if the file can not be written
+     */
+    void
+    write(const std::string &path);
+};
+
+/**
+ * @brief Get the tracer of the process
+ *
+ * @return Tracer& the tracer that is used by the benchmark framework and the MPI wrappers
+ */
+Tracer &
+getTracer();
+
+/**
+ * @brief Records the lifetime of the object as span on the host track
+ *
+ */
+class ScopedSpan {
+
+private:
+
+    std::string name;
+    int64_t startTime;
+
+public:
+
+    /**
+     * @brief Start a new span
+     *
+     * @param name Name of the span
+     */
+    explicit ScopedSpan(const std::string &name) : name(name), startTime(getTracer().isEnabled() ? Tracer::now() : 0) {}
+
+    ~ScopedSpan() {
+        if (getTracer().isEnabled()) {
+            getTracer().recordSpan(name, "host", HOST_TRACK, startTime, Tracer::now());
+        }
+    }
+};
+
+} // namespace tracing
+
+#endif
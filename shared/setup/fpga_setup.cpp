@@ -10,14 +10,120 @@
 #include <iomanip>
 #include <chrono>
 #include <fstream>
+#include <sstream>
+#include <cstdint>
+#include <cctype>
+
+/* POSIX headers used to memory-map the kernel file */
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 /* External libraries */
 #include "parameters.h"
+#include "numa_allocation.hpp"
+
+#ifdef INTEL_FPGA
+#include "CL/cl_ext_intelfpga.h"
+#endif
 
 #ifdef _USE_MPI_
 #include "mpi.h"
 #endif
 
+namespace {
+
+/**
+ * @brief Magic string and offset of the UUID in the header of xclbin (axlf) files as defined in xclbin.h of XRT
+ *
+ */
+const char XCLBIN_MAGIC[] = "xclbin2";
+const size_t AXLF_UUID_OFFSET = 416;
+const size_t AXLF_UUID_SIZE = 16;
+
+/**
+ * @brief Prefix of the files that record the bitstream that was loaded by a previous run on a device
+ *
+ */
+const char LOADED_BITSTREAM_RECORD_PREFIX[] = "/tmp/hpcc_fpga_loaded_bitstream_";
+
+/**
+ * @brief Read-only memory mapping of a file that is released when the object is destroyed
+ *
+ */
+class MappedFile {
+public:
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+
+    explicit MappedFile(const std::string &path) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) == 0 && file_stat.st_size > 0) {
+            void* mapped = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped != MAP_FAILED) {
+                madvise(mapped, file_stat.st_size, MADV_SEQUENTIAL);
+                data = reinterpret_cast<const unsigned char*>(mapped);
+                size = file_stat.st_size;
+            }
+        }
+        close(fd);
+    }
+
+    ~MappedFile() {
+        if (data != nullptr) {
+            munmap(const_cast<unsigned char*>(data), size);
+        }
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+};
+
+/**
+ * @brief Get the path of the file that records the bitstream loaded on the device
+ *
+ * @param device The OpenCL device
+ * @return std::string Path to the record file, unique for every device of the node
+ */
+std::string
+getLoadedBitstreamRecord(const cl::Device &device) {
+    std::string name = numa::getDevicePciAddress(device);
+    if (name.empty()) {
+        name = device.getInfo<CL_DEVICE_NAME>();
+    }
+    for (auto &c : name) {
+        if (!std::isalnum(static_cast<unsigned char>(c))) {
+            c = '_';
+        }
+    }
+    return LOADED_BITSTREAM_RECORD_PREFIX + name;
+}
+
+/**
+ * @brief Remove all characters that are not hexadecimal digits and convert the remaining ones to lower case,
+ *          so IDs with different formatting can be compared
+ *
+ * @param id The ID as read from the file or the driver
+ * @return std::string The normalized ID
+ */
+std::string
+normalizeBitstreamId(const std::string &id) {
+    std::string normalized;
+    for (auto c : id) {
+        if (std::isxdigit(static_cast<unsigned char>(c))) {
+            normalized.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+        }
+    }
+    return normalized;
+}
+
+}  // namespace
+
 namespace fpga_setup {
 
 FpgaSetupException::FpgaSetupException(std::string message) : error_message(message) {}
@@ -118,17 +224,79 @@ Converts the reveived OpenCL error to a string
         }
     }
 
+    std::string
+    getBitstreamId(const unsigned char *data, size_t size) {
+        std::stringstream ss;
+        ss << std::hex << std::setfill('0');
+        if (size >= AXLF_UUID_OFFSET + AXLF_UUID_SIZE && std::string(reinterpret_cast<const char*>(data), sizeof(XCLBIN_MAGIC) - 1) == XCLBIN_MAGIC) {
+            // The UUID of the xclbin is also shown by the driver for the loaded bitstream
+            for (size_t i = AXLF_UUID_OFFSET; i < AXLF_UUID_OFFSET + AXLF_UUID_SIZE; i++) {
+                ss << std::setw(2) << static_cast<unsigned>(data[i]);
+            }
+        }
+        else {
+            // 64 bit FNV-1a hash over the whole bitstream
+            uint64_t hash = 14695981039346656037ull;
+            for (size_t i = 0; i < size; i++) {
+                hash ^= data[i];
+                hash *= 1099511628211ull;
+            }
+            ss << std::setw(16) << hash;
+        }
+        return ss.str();
+    }
+
+    std::string
+    getLoadedBitstreamId(const cl::Device &device) {
+        std::string id;
+        // The Xilinx driver shows the UUID of the loaded xclbin in sysfs
+        std::string bdf = numa::getDevicePciAddress(device);
+        if (!bdf.empty()) {
+            std::ifstream fs("/sys/bus/pci/devices/" + bdf + "/xclbinuuid");
+            if (fs.is_open() && (fs >> id)) {
+                return normalizeBitstreamId(id);
+            }
+        }
+        // Otherwise use the bitstream that was recorded by a previous run
+        std::ifstream fs(getLoadedBitstreamRecord(device));
+        if (fs.is_open() && (fs >> id)) {
+            return normalizeBitstreamId(id);
+        }
+        return "";
+    }
+
+    std::unique_ptr<cl::Context>
+    createContext(const cl::Device &device, const std::string &usedKernelFile, bool reuseLoadedBitstream) {
+        if (reuseLoadedBitstream) {
+            MappedFile file(usedKernelFile);
+            if (file.data != nullptr && getLoadedBitstreamId(device) == getBitstreamId(file.data, file.size)) {
+                std::cout << "Device is already configured with " << usedKernelFile << ". Reconfiguration is skipped." << std::endl;
+#ifdef CL_CONTEXT_COMPILER_MODE_PRELOADED_BINARY_ONLY_INTELFPGA
+                // The Intel runtime only reads the kernel interfaces from the binary and does not reprogram the device
+                cl_context_properties properties[] = {CL_CONTEXT_COMPILER_MODE_INTELFPGA, CL_CONTEXT_COMPILER_MODE_PRELOADED_BINARY_ONLY_INTELFPGA, 0};
+                int err;
+                std::unique_ptr<cl::Context> context(new cl::Context(device, properties, nullptr, nullptr, &err));
+                ASSERT_CL(err)
+                return context;
+#endif
+                // The Xilinx runtime does not download the xclbin again, if its UUID matches the loaded one
+            }
+        }
+        return std::unique_ptr<cl::Context>(new cl::Context(device));
+    }
+
 /**
 Sets up the given FPGA with the kernel in the provided file.
 
 @param context The context used for the program
 @param program The devices used for the program
 @param usedKernelFile The path to the kernel file
+@param reuseLoadedBitstream Record the loaded bitstream for every device, so the reconfiguration can be skipped by later runs
 @return The program that is used to create the benchmark kernels
 */
     std::unique_ptr<cl::Program>
     fpgaSetup(const cl::Context *context, std::vector<cl::Device> deviceList,
-              const std::string *usedKernelFile) {
+              const std::string *usedKernelFile, bool reuseLoadedBitstream) {
         int err;
         int world_rank = 0;
 
@@ -141,34 +309,38 @@ Sets up the given FPGA with the kernel in the provided file.
             std::cout << "FPGA Setup:" << usedKernelFile->c_str() << std::endl;
         }
 
-        // Open file stream if possible
-        std::ifstream aocxStream(usedKernelFile->c_str(), std::ifstream::binary);
-        if (!aocxStream.is_open()) {
+        // Map the file into memory, so it is passed to the runtime without copying it
+        MappedFile kernelFile(*usedKernelFile);
+        if (kernelFile.data == nullptr) {
             std::cerr << "Not possible to open from given file!" << std::endl;
             throw FpgaSetupException("Not possible to open from given file: " + *usedKernelFile);
         }
 
-        // Read in file contents and create program from binaries
-        aocxStream.seekg(0, aocxStream.end);
-        long file_size = aocxStream.tellg();
-        aocxStream.seekg(0, aocxStream.beg);
-        std::vector<unsigned char> buf(file_size);
-        aocxStream.read(reinterpret_cast<char *>(buf.data()), file_size);
-
-
-#ifdef USE_DEPRECATED_HPP_HEADER
-        cl::Program::Binaries mybinaries;
-        mybinaries.push_back({buf.data(), file_size});
-#else
-        cl::Program::Binaries mybinaries{buf};
-#endif
-
-        // Create the Program from the AOCX file.
-        cl::Program program(*context, deviceList, mybinaries, NULL, &err);
+        // Create the Program from the AOCX file. The C API is used, because the binaries of the C++ wrapper
+        // would require a copy of the file.
+        std::vector<cl_device_id> device_ids;
+        std::vector<const unsigned char*> binaries;
+        std::vector<size_t> binary_sizes;
+        for (const auto &d : deviceList) {
+            device_ids.push_back(d());
+            binaries.push_back(kernelFile.data);
+            binary_sizes.push_back(kernelFile.size);
+        }
+        cl_program program_id = clCreateProgramWithBinary((*context)(), device_ids.size(), device_ids.data(),
+                                                        binary_sizes.data(), binaries.data(), nullptr, &err);
         ASSERT_CL(err)
+        cl::Program program(program_id);
 
         // Build the program (required for fast emulation on Intel)
         ASSERT_CL(program.build());
+
+        if (reuseLoadedBitstream) {
+            std::string id = getBitstreamId(kernelFile.data, kernelFile.size);
+            for (const auto &d : deviceList) {
+                std::ofstream fs(getLoadedBitstreamRecord(d));
+                fs << id << std::endl;
+            }
+        }
         
         if (world_rank == 0) {
             std::cout << "Prepared FPGA successfully for global Execution!" <<
@@ -225,6 +397,25 @@ choose a device.
 */
     std::unique_ptr<cl::Device>
     selectFPGADevice(int defaultPlatform, int defaultDevice) {
+        return std::unique_ptr<cl::Device>(new cl::Device(selectFPGADevices(defaultPlatform, defaultDevice, 1)[0]));
+    }
+
+/**
+Searches and selects multiple FPGA devices that are used by the same rank.
+
+@param defaultPlatform The index of the platform that has to be used. If a
+                        value < 0 is given, the platform can be chosen
+                        interactively
+@param defaultDevice The index of the first device that has to be used. If a
+                        value < 0 is given, the device can be chosen
+                        interactively for a single device. With MPI or multiple devices,
+                        every rank uses the next count devices.
+@param count The number of devices that will be selected
+
+@return A list containing the selected devices
+*/
+    std::vector<cl::Device>
+    selectFPGADevices(int defaultPlatform, int defaultDevice, uint count) {
         // Integer used to store return codes of OpenCL library calls
         int err;
 
@@ -274,10 +465,14 @@ choose a device.
         err = platform.getDevices(CL_DEVICE_TYPE_ACCELERATOR, &deviceList);
         ASSERT_CL(err)
 
+        if (!deviceList.empty() && (count == 0 || count > deviceList.size())) {
+            throw FpgaSetupException("Invalid number of devices per rank specified: " + std::to_string(count) + "/" + std::to_string(deviceList.size()));
+        }
+
         // Choose taget device
         long unsigned int chosenDeviceId = 0;
         if (defaultDevice >= 0) {
-            if (defaultDevice < static_cast<int>(deviceList.size())) {
+            if (static_cast<long unsigned int>(defaultDevice) + count <= deviceList.size()) {
                 chosenDeviceId = defaultDevice;
             } else {
                 std::cerr << "Default device " << defaultDevice
@@ -286,7 +481,7 @@ choose a device.
                 throw FpgaSetupException("Invalid device index specified: " + std::to_string(defaultDevice) + "/" + std::to_string(deviceList.size() - 1));
             }
         } else if (deviceList.size() > 1) {
-            if (world_size == 1) {
+            if (world_size == 1 && count == 1) {
                     std::cout <<
                               "Multiple devices have been found. Select the device by"\
                             " typing a number:" << std::endl;
@@ -300,7 +495,8 @@ choose a device.
                 std::cout << "Enter device id [0-" << deviceList.size() - 1 << "]:";
                 std::cin >> chosenDeviceId;
             } else {
-                chosenDeviceId = static_cast<long unsigned int>(world_rank % deviceList.size());
+                // Every rank uses the next count devices. The devices of a rank are always consecutive
+                chosenDeviceId = static_cast<long unsigned int>((world_rank * count) % (deviceList.size() - deviceList.size() % count));
             }
         } else if (deviceList.size() == 1) {
             chosenDeviceId = 0;
@@ -314,12 +510,14 @@ choose a device.
             std::cout << "Selection summary:" << std::endl;
             std::cout << "Platform Name: " <<
                       platform.getInfo<CL_PLATFORM_NAME>() << std::endl;
-            std::cout << "Device Name:   " <<
-                      deviceList[chosenDeviceId].getInfo<CL_DEVICE_NAME>() << std::endl;
+            for (uint i = 0; i < count; i++) {
+                std::cout << "Device Name:   " <<
+                          deviceList[chosenDeviceId + i].getInfo<CL_DEVICE_NAME>() << std::endl;
+            }
             std::cout << HLINE;
         }
 
-        return std::unique_ptr<cl::Device>(new cl::Device(deviceList[chosenDeviceId]));
+        return std::vector<cl::Device>(deviceList.begin() + chosenDeviceId, deviceList.begin() + chosenDeviceId + count);
     }
 
 }  // namespace fpga_setup
\ No newline at end of file
@@ -0,0 +1,189 @@
+//
+// Created by Marius Meyer on 12.03.22.
+//
+
+#include "memory_placement.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+
+#include "nlohmann/json.hpp"
+
+namespace {
+
+/**
+ * @brief Offsets and constants of the xclbin (axlf) file format as defined in xclbin.h of XRT
+ *
+ */
+const char XCLBIN_MAGIC[] = "xclbin2";
+const size_t AXLF_NUM_SECTIONS_OFFSET = 448;
+const size_t AXLF_SECTIONS_OFFSET = 456;
+const size_t AXLF_SECTION_HEADER_SIZE = 40;
+const size_t AXLF_SECTION_OFFSET_OFFSET = 24;
+const uint32_t AXLF_MEM_TOPOLOGY_KIND = 6;
+const size_t MEM_DATA_SIZE = 40;
+const uint8_t MEM_TYPE_DDR3 = 0;
+const uint8_t MEM_TYPE_DDR4 = 1;
+const uint8_t MEM_TYPE_DRAM = 2;
+const uint8_t MEM_TYPE_HBM = 6;
+
+template<typename T>
+bool
+readValue(const std::string &file, size_t offset, T &value) {
+    if (offset + sizeof(T) > file.size()) {
+        return false;
+    }
+    std::memcpy(&value, file.data() + offset, sizeof(T));
+    return true;
+}
+
+std::vector<int>
+readXclbinTopology(const std::string &file) {
+    std::vector<int> banks;
+    uint32_t num_sections = 0;
+    if (!readValue(file, AXLF_NUM_SECTIONS_OFFSET, num_sections)) {
+        return banks;
+    }
+    for (uint32_t s = 0; s < num_sections; s++) {
+        size_t header = AXLF_SECTIONS_OFFSET + s * AXLF_SECTION_HEADER_SIZE;
+        uint32_t kind = 0;
+        uint64_t section_offset = 0;
+        if (!readValue(file, header, kind) || !readValue(file, header + AXLF_SECTION_OFFSET_OFFSET, section_offset)) {
+            return banks;
+        }
+        if (kind != AXLF_MEM_TOPOLOGY_KIND) {
+            continue;
+        }
+        int32_t count = 0;
+        if (!readValue(file, section_offset, count)) {
+            return banks;
+        }
+        for (int32_t m = 0; m < count; m++) {
+            size_t mem_data = section_offset + 8 + m * MEM_DATA_SIZE;
+            uint8_t type = 0;
+            uint8_t used = 0;
+            if (!readValue(file, mem_data, type) || !readValue(file, mem_data + 1, used)) {
+                return banks;
+            }
+            if (used && (type == MEM_TYPE_DDR3 || type == MEM_TYPE_DDR4 || type == MEM_TYPE_DRAM || type == MEM_TYPE_HBM)) {
+                banks.push_back(m);
+            }
+        }
+        break;
+    }
+    return banks;
+}
+
+std::vector<int>
+readIntelTopology(const std::string &file) {
+    std::vector<int> banks;
+    // The first global memory in the board specification is the default memory
+    size_t start = file.find("<global_mem");
+    if (start == std::string::npos) {
+        return banks;
+    }
+    size_t end = file.find("</global_mem>", start);
+    if (end == std::string::npos) {
+        return banks;
+    }
+    int count = 0;
+    for (size_t pos = file.find("<interface", start); pos < end; pos = file.find("<interface", pos + 1)) {
+        banks.push_back(count++);
+    }
+    return banks;
+}
+
+}  // namespace
+
+std::vector<int>
+placement::readMemoryTopology(const std::string &kernel_file) {
+    std::ifstream fs(kernel_file, std::ios::binary);
+    if (!fs.is_open()) {
+        return std::vector<int>();
+    }
+    std::string file((std::istreambuf_iterator<char>(fs)), std::istreambuf_iterator<char>());
+    if (file.compare(0, sizeof(XCLBIN_MAGIC) - 1, XCLBIN_MAGIC) == 0) {
+        return readXclbinTopology(file);
+    }
+    return readIntelTopology(file);
+}
+
+placement::BankMap::BankMap(const std::string &map) : description(map) {
+    if (map.empty()) {
+        return;
+    }
+    if (map == "auto") {
+        automatic = true;
+        return;
+    }
+    try {
+        if (map.size() > 5 && map.compare(map.size() - 5, 5, ".json") == 0) {
+            std::ifstream fs(map);
+            if (!fs.is_open()) {
+                throw std::runtime_error("Memory bank map file could not be opened: " + map);
+            }
+            nlohmann::json j = nlohmann::json::parse(fs);
+            for (auto &replication : j.at("banks")) {
+                std::vector<int> replication_banks = replication.get<std::vector<int>>();
+                for (int b : replication_banks) {
+                    if (b < 0) {
+                        throw std::invalid_argument("negative bank");
+                    }
+                }
+                if (replication_banks.empty()) {
+                    throw std::invalid_argument("empty replication");
+                }
+                banks.push_back(replication_banks);
+            }
+            if (banks.empty()) {
+                throw std::invalid_argument("empty map");
+            }
+            return;
+        }
+        if (map.compare(0, 3, "rr:") == 0) {
+            roundRobinBanks = std::stoi(map.substr(3));
+            if (roundRobinBanks <= 0) {
+                throw std::invalid_argument("number of banks");
+            }
+            return;
+        }
+        std::stringstream replications(map);
+        std::string replication;
+        while (std::getline(replications, replication, ',')) {
+            std::stringstream buffers(replication);
+            std::string buffer;
+            std::vector<int> replication_banks;
+            while (std::getline(buffers, buffer, ':')) {
+                int bank = std::stoi(buffer);
+                if (bank < 0) {
+                    throw std::invalid_argument("negative bank");
+                }
+                replication_banks.push_back(bank);
+            }
+            if (replication_banks.empty()) {
+                throw std::invalid_argument("empty replication");
+            }
+            banks.push_back(replication_banks);
+        }
+    }
+    catch (std::logic_error &) {
+        throw std::runtime_error("Memory bank map could not be parsed: " + map);
+    }
+    catch (nlohmann::json::exception &) {
+        throw std::runtime_error("Memory bank map could not be parsed: " + map);
+    }
+}
+
+bool
+placement::BankMap::setTopology(const std::string &kernel_file) {
+    if (!automatic) {
+        return true;
+    }
+    topology = readMemoryTopology(kernel_file);
+    return !topology.empty();
+}
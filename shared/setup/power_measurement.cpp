@@ -0,0 +1,235 @@
+//
+// Created by Marius Meyer on 18.03.22.
+//
+
+#include "power_measurement.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <glob.h>
+#include <regex>
+#include <stdexcept>
+
+#include "numa_allocation.hpp"
+
+namespace {
+
+/**
+ * @brief Execute a command and return its standard output
+ *
+ */
+std::string
+readCommandOutput(const std::string &command) {
+    FILE* pipe = popen(command.c_str(), "r");
+    if (!pipe) {
+        throw std::runtime_error("Power measurement command could not be executed: " + command);
+    }
+    std::string output;
+    char buffer[256];
+    while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
+        output += buffer;
+    }
+    if (pclose(pipe) != 0) {
+        throw std::runtime_error("Power measurement command failed: " + command);
+    }
+    return output;
+}
+
+/**
+ * @brief Find an input of the hwmon interface of the PCIe device e.g. power1_input
+ *
+ * @return std::string Path to the file or an empty string, if the device has no such sensor
+ */
+std::string
+findHwmonInput(const std::string &bdf, const std::string &input) {
+    if (bdf.empty()) {
+        return "";
+    }
+    std::string pattern = "/sys/bus/pci/devices/" + bdf + "/hwmon/hwmon*/" + input;
+    glob_t result;
+    std::string path;
+    if (glob(pattern.c_str(), 0, nullptr, &result) == 0 && result.gl_pathc > 0) {
+        path = result.gl_pathv[0];
+    }
+    globfree(&result);
+    return path;
+}
+
+/**
+ * @brief Create a source that reads a hwmon input and scales the value with the given factor
+ *
+ */
+std::function<double()>
+createHwmonSource(const std::string &path, double factor) {
+    return [path, factor]() {
+        std::ifstream file(path);
+        double value;
+        if (!(file >> value)) {
+            throw std::runtime_error("Sensor could not be read from " + path);
+        }
+        return value * factor;
+    };
+}
+
+/**
+ * @brief Create a source from the output of a command
+ *
+ * @param command The executed command
+ * @param parse Function that parses the value from the output of the command
+ */
+std::function<double()>
+createCommandSource(const std::string &command, double (*parse)(const std::string&)) {
+    return [command, parse]() {
+        return parse(readCommandOutput(command + " 2>/dev/null"));
+    };
+}
+
+/**
+ * @brief Create a source for a sensor of the device using the hwmon interface, the vendor tools or a command
+ *
+ * @param name Name of the source
+ * @param device The device
+ * @param hwmon_input Name of the hwmon input
+ * @param hwmon_factor Factor that converts the value of the hwmon input to the unit of the source
+ * @param fpgainfo_command The fpgainfo sub command that prints the value
+ * @param xbutil_report The xbutil report that contains the value
+ * @param parse Function that parses the value from the output of the tools
+ */
+std::function<double()>
+createSensorSource(const std::string &name, const cl::Device &device, const std::string &hwmon_input, double hwmon_factor,
+                    const std::string &fpgainfo_command, const std::string &xbutil_report, double (*parse)(const std::string&)) {
+    std::string bdf = numa::getDevicePciAddress(device);
+    if (name == "sysfs" || name == "auto") {
+        std::string path = findHwmonInput(bdf, hwmon_input);
+        if (!path.empty()) {
+            return createHwmonSource(path, hwmon_factor);
+        }
+        if (name == "sysfs") {
+            throw std::runtime_error("No hwmon sensor " + hwmon_input + " found for the device" + (bdf.empty() ? std::string("") : " " + bdf));
+        }
+    }
+#ifdef INTEL_FPGA
+    if (name == "fpgainfo" || name == "auto") {
+#else
+    if (name == "fpgainfo") {
+#endif
+        return createCommandSource("fpgainfo " + fpgainfo_command + (bdf.empty() ? std::string("") : " -B 0x" + bdf.substr(5, 2)), parse);
+    }
+#ifdef INTEL_FPGA
+    if (name == "xbutil") {
+#else
+    if (name == "xbutil" || name == "auto") {
+#endif
+        return createCommandSource("xbutil examine -r " + xbutil_report + (bdf.empty() ? std::string("") : " -d " + bdf), parse);
+    }
+    if (name.compare(0, 4, "cmd:") == 0 && name.size() > 4) {
+        return createCommandSource(name.substr(4), parse);
+    }
+    throw std::runtime_error("Unknown sensor source: " + name);
+}
+
+} // namespace
+
+namespace power {
+
+PowerSampler::PowerSampler(PowerSource source, std::chrono::milliseconds interval) : source(source),
+                                                interval(interval), running(false) {}
+
+PowerSampler::~PowerSampler() {
+    running = false;
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void
+PowerSampler::sample() {
+    try {
+        while (running) {
+            double value = source();
+            samples.emplace_back(std::chrono::high_resolution_clock::now(), value);
+            std::this_thread::sleep_for(interval);
+        }
+    }
+    catch (...) {
+        error = std::current_exception();
+    }
+}
+
+void
+PowerSampler::start() {
+    if (running) {
+        throw std::runtime_error("Power sampler is already running!");
+    }
+    samples.clear();
+    error = nullptr;
+    startTime = std::chrono::high_resolution_clock::now();
+    running = true;
+    thread = std::thread(&PowerSampler::sample, this);
+}
+
+PowerMeasurement
+PowerSampler::stop() {
+    auto stop_time = std::chrono::high_resolution_clock::now();
+    running = false;
+    if (thread.joinable()) {
+        thread.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    PowerMeasurement m = {0.0, 0.0, 0.0, 0.0, samples.size()};
+    m.duration = std::chrono::duration<double>(stop_time - startTime).count();
+    if (samples.empty()) {
+        return m;
+    }
+    // Trapezoidal integration over the sampled interval. The average power is used for the remaining
+    // time of the measurement window before the first and after the last sample.
+    double sampled_energy = 0.0;
+    for (size_t i = 1; i < samples.size(); i++) {
+        double dt = std::chrono::duration<double>(samples[i].first - samples[i - 1].first).count();
+        sampled_energy += dt * (samples[i].second + samples[i - 1].second) / 2.0;
+    }
+    double sampled_time = std::chrono::duration<double>(samples.back().first - samples.front().first).count();
+    m.averagePower = (sampled_time > 0.0) ? sampled_energy / sampled_time : samples.front().second;
+    for (const auto &s : samples) {
+        m.maxPower = std::max(m.maxPower, s.second);
+    }
+    m.energy = m.averagePower * m.duration;
+    return m;
+}
+
+double
+parsePowerOutput(const std::string &output) {
+    std::regex power_regex("([0-9]+(\\.[0-9]+)?)\\s*(Watts|W)\\b");
+    std::smatch match;
+    if (!std::regex_search(output, match, power_regex)) {
+        throw std::runtime_error("Power could not be read from output: " + output);
+    }
+    return std::stod(match[1].str());
+}
+
+PowerSource
+createPowerSource(const std::string &name, const cl::Device &device) {
+    // The hwmon interface gives the power in micro Watt
+    return createSensorSource(name, device, "power1_input", 1.0e-6, "power", "electrical", parsePowerOutput);
+}
+
+double
+parseTemperatureOutput(const std::string &output) {
+    std::regex temperature_regex("(-?[0-9]+(\\.[0-9]+)?)\\s*(\xC2\xB0\\s*)?(Celsius|C)\\b");
+    std::smatch match;
+    if (!std::regex_search(output, match, temperature_regex)) {
+        throw std::runtime_error("Temperature could not be read from output: " + output);
+    }
+    return std::stod(match[1].str());
+}
+
+TemperatureSource
+createTemperatureSource(const std::string &name, const cl::Device &device) {
+    // The hwmon interface gives the temperature in milli degree Celsius
+    return createSensorSource(name, device, "temp1_input", 1.0e-3, "temp", "thermal", parseTemperatureOutput);
+}
+
+} // namespace power
@@ -0,0 +1,266 @@
+//
+// Created by Marius Meyer on 14.10.22.
+//
+
+#include "tracing.hpp"
+
+#include <fstream>
+#include <stdexcept>
+
+#ifdef _USE_MPI_
+#include "mpi.h"
+#endif
+
+#include "nlohmann/json.hpp"
+
+namespace {
+
+/**
+ * @brief Number of message exchanges that are used to determine the clock offset to rank 0
+ *
+ */
+const int CLOCK_SYNC_ROUNDS = 10;
+
+#ifdef _USE_MPI_
+/**
+ * @brief Determine the offset of the local clock to the clock of rank 0 with ping-pong messages.
+ *          The exchange with the lowest round trip time is used to estimate the offset.
+ *          The PMPI functions are used, so the synchronization does not show up in the trace.
+ *
+ * @return int64_t Offset in ns that has to be added to the local time to get the time of rank 0
+ */
+int64_t
+synchronizeWithRankZero() {
+    int rank;
+    int size;
+    PMPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    PMPI_Comm_size(MPI_COMM_WORLD, &size);
+    int64_t offset = 0;
+    if (rank == 0) {
+        for (int r = 1; r < size; r++) {
+            for (int i = 0; i < CLOCK_SYNC_ROUNDS; i++) {
+                int64_t request;
+                PMPI_Recv(&request, 1, MPI_INT64_T, r, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+                int64_t t = tracing::Tracer::now();
+                PMPI_Send(&t, 1, MPI_INT64_T, r, 0, MPI_COMM_WORLD);
+            }
+        }
+    }
+    else {
+        int64_t min_rtt = -1;
+        for (int i = 0; i < CLOCK_SYNC_ROUNDS; i++) {
+            int64_t t1 = tracing::Tracer::now();
+            int64_t remote;
+            PMPI_Send(&t1, 1, MPI_INT64_T, 0, 0, MPI_COMM_WORLD);
+            PMPI_Recv(&remote, 1, MPI_INT64_T, 0, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            int64_t t2 = tracing::Tracer::now();
+            if (min_rtt < 0 || t2 - t1 < min_rtt) {
+                min_rtt = t2 - t1;
+                offset = remote - (t1 + (t2 - t1) / 2);
+            }
+        }
+    }
+    return offset;
+}
+#endif
+
+} // namespace
+
+void
+tracing::Tracer::start() {
+    {
+        std::lock_guard<std::mutex> lock(events_mutex);
+        events.clear();
+    }
+    clockOffset = 0;
+#ifdef _USE_MPI_
+    clockOffset = synchronizeWithRankZero();
+    // The epoch is taken from rank 0, so the times of all ranks are relative to the same point in time
+    epoch = now();
+    PMPI_Bcast(&epoch, 1, MPI_INT64_T, 0, MPI_COMM_WORLD);
+#else
+    epoch = now();
+#endif
+    setTrackName(HOST_TRACK, "Host");
+    setTrackName(MPI_TRACK, "MPI");
+    enabled = true;
+}
+
+std::string
+tracing::Tracer::toChromeTraceEvents(int rank) {
+    std::lock_guard<std::mutex> lock(events_mutex);
+    nlohmann::json list = nlohmann::json::array();
+    list.push_back({{"name", "process_name"}, {"ph", "M"}, {"pid", rank}, {"args", {{"name", "Rank " + std::to_string(rank)}}}});
+    for (const auto &t : trackNames) {
+        list.push_back({{"name", "thread_name"}, {"ph", "M"}, {"pid", rank}, {"tid", t.first}, {"args", {{"name", t.second}}}});
+    }
+    for (const auto &e : events) {
+        nlohmann::json j = {{"name", e.name}, {"cat", e.category}, {"pid", rank}, {"tid", e.track},
+                            {"ts", static_cast<double>(e.start) * 1.0e-3}};
+        if (e.duration < 0) {
+            j["ph"] = "i";
+            j["s"] = "t";
+        }
+        else {
+            j["ph"] = "X";
+            j["dur"] = static_cast<double>(e.duration) * 1.0e-3;
+        }
+        list.push_back(j);
+    }
+    std::string serialized = list.dump();
+    // Remove the brackets, so the events of all ranks can be concatenated
+    return serialized.substr(1, serialized.size() - 2);
+}
+
+void
+tracing::Tracer::write(const std::string &path) {
+    int rank = 0;
+    int size = 1;
+#ifdef _USE_MPI_
+    PMPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    PMPI_Comm_size(MPI_COMM_WORLD, &size);
+#endif
+    std::string local = toChromeTraceEvents(rank);
+    std::vector<std::string> all_events;
+#ifdef _USE_MPI_
+    int local_size = static_cast<int>(local.size());
+    std::vector<int> sizes(size);
+    PMPI_Gather(&local_size, 1, MPI_INT, sizes.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+    std::vector<int> displacements(size, 0);
+    for (int i = 1; i < size; i++) {
+        displacements[i] = displacements[i - 1] + sizes[i - 1];
+    }
+    std::vector<char> buffer((rank == 0) ? displacements[size - 1] + sizes[size - 1] : 0);
+    PMPI_Gatherv(local.data(), local_size, MPI_CHAR, buffer.data(), sizes.data(), displacements.data(), MPI_CHAR, 0, MPI_COMM_WORLD);
+    if (rank == 0) {
+        for (int i = 0; i < size; i++) {
+            all_events.emplace_back(buffer.data() + displacements[i], sizes[i]);
+        }
+    }
+#else
+    all_events.push_back(local);
+#endif
+    if (rank > 0) {
+        return;
+    }
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Trace file could not be written: " + path);
+    }
+    file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    for (const auto &e : all_events) {
+        if (e.empty()) {
+            continue;
+        }
+        file << (first ? "" : ",") << e;
+        first = false;
+    }
+    file << "]}" << std::endl;
+}
+
+tracing::Tracer &
+tracing::getTracer() {
+    static Tracer tracer;
+    return tracer;
+}
+
+#ifdef _USE_MPI_
+/*
+ * Wrappers for the MPI functions used by the benchmarks. They are linked instead of the functions of the MPI library
+ * and record the calls, if the tracer is enabled. The calls are forwarded to the MPI profiling interface.
+ */
+namespace {
+
+template<typename F>
+int
+traceMpiCall(const char *name, F call) {
+    tracing::Tracer &tracer = tracing::getTracer();
+    if (!tracer.isEnabled()) {
+        return call();
+    }
+    int64_t start = tracing::Tracer::now();
+    int result = call();
+    tracer.recordSpan(name, "mpi", tracing::MPI_TRACK, start, tracing::Tracer::now());
+    return result;
+}
+
+} // namespace
+
+int
+MPI_Send(const void *buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm) {
+    return traceMpiCall("MPI_Send", [&]() { return PMPI_Send(buf, count, datatype, dest, tag, comm); });
+}
+
+int
+MPI_Recv(void *buf, int count, MPI_Datatype datatype, int source, int tag, MPI_Comm comm, MPI_Status *status) {
+    return traceMpiCall("MPI_Recv", [&]() { return PMPI_Recv(buf, count, datatype, source, tag, comm, status); });
+}
+
+int
+MPI_Sendrecv(const void *sendbuf, int sendcount, MPI_Datatype sendtype, int dest, int sendtag, void *recvbuf, int recvcount,
+             MPI_Datatype recvtype, int source, int recvtag, MPI_Comm comm, MPI_Status *status) {
+    return traceMpiCall("MPI_Sendrecv", [&]() { return PMPI_Sendrecv(sendbuf, sendcount, sendtype, dest, sendtag, recvbuf, recvcount,
+                                                                      recvtype, source, recvtag, comm, status); });
+}
+
+int
+MPI_Isend(const void *buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm, MPI_Request *request) {
+    return traceMpiCall("MPI_Isend", [&]() { return PMPI_Isend(buf, count, datatype, dest, tag, comm, request); });
+}
+
+int
+MPI_Irecv(void *buf, int count, MPI_Datatype datatype, int source, int tag, MPI_Comm comm, MPI_Request *request) {
+    return traceMpiCall("MPI_Irecv", [&]() { return PMPI_Irecv(buf, count, datatype, source, tag, comm, request); });
+}
+
+int
+MPI_Wait(MPI_Request *request, MPI_Status *status) {
+    return traceMpiCall("MPI_Wait", [&]() { return PMPI_Wait(request, status); });
+}
+
+int
+MPI_Waitall(int count, MPI_Request array_of_requests[], MPI_Status array_of_statuses[]) {
+    return traceMpiCall("MPI_Waitall", [&]() { return PMPI_Waitall(count, array_of_requests, array_of_statuses); });
+}
+
+int
+MPI_Waitany(int count, MPI_Request array_of_requests[], int *index, MPI_Status *status) {
+    return traceMpiCall("MPI_Waitany", [&]() { return PMPI_Waitany(count, array_of_requests, index, status); });
+}
+
+int
+MPI_Barrier(MPI_Comm comm) {
+    return traceMpiCall("MPI_Barrier", [&]() { return PMPI_Barrier(comm); });
+}
+
+int
+MPI_Bcast(void *buffer, int count, MPI_Datatype datatype, int root, MPI_Comm comm) {
+    return traceMpiCall("MPI_Bcast", [&]() { return PMPI_Bcast(buffer, count, datatype, root, comm); });
+}
+
+int
+MPI_Ibcast(void *buffer, int count, MPI_Datatype datatype, int root, MPI_Comm comm, MPI_Request *request) {
+    return traceMpiCall("MPI_Ibcast", [&]() { return PMPI_Ibcast(buffer, count, datatype, root, comm, request); });
+}
+
+int
+MPI_Reduce(const void *sendbuf, void *recvbuf, int count, MPI_Datatype datatype, MPI_Op op, int root, MPI_Comm comm) {
+    return traceMpiCall("MPI_Reduce", [&]() { return PMPI_Reduce(sendbuf, recvbuf, count, datatype, op, root, comm); });
+}
+
+int
+MPI_Allreduce(const void *sendbuf, void *recvbuf, int count, MPI_Datatype datatype, MPI_Op op, MPI_Comm comm) {
+    return traceMpiCall("MPI_Allreduce", [&]() { return PMPI_Allreduce(sendbuf, recvbuf, count, datatype, op, comm); });
+}
+
+int
+MPI_Alltoall(const void *sendbuf, int sendcount, MPI_Datatype sendtype, void *recvbuf, int recvcount, MPI_Datatype recvtype, MPI_Comm comm) {
+    return traceMpiCall("MPI_Alltoall", [&]() { return PMPI_Alltoall(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, comm); });
+}
+
+int
+MPI_Gather(const void *sendbuf, int sendcount, MPI_Datatype sendtype, void *recvbuf, int recvcount, MPI_Datatype recvtype, int root, MPI_Comm comm) {
+    return traceMpiCall("MPI_Gather", [&]() { return PMPI_Gather(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, root, comm); });
+}
+#endif
@@ -8,6 +8,15 @@
 #include "test_program_settings.h"
 #include "gmock/gmock.h"
 #include "hpcc_benchmark.hpp"
+#include "profiling.hpp"
+#include "counter_rng.hpp"
+#include "async_execution.hpp"
+#include "hpcc_suite.hpp"
+#include "half_conversion.hpp"
+#include "memory_tracker.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 
 
 // Dirty GoogleTest and static library hack
@@ -110,6 +119,41 @@ public:
 
 };
 
+/**
+ * Benchmark that supports the data cache by storing the integer input data
+ */
+class CachedBenchmark : public SuccessBenchmark {
+
+public:
+
+    std::unique_ptr<int>
+    allocateInputData() override {
+        return std::unique_ptr<int>(new int);
+    }
+
+    std::vector<hpcc_base::DataRegion>
+    getInputDataRegions(int &data) override {
+        return {{&data, sizeof(int)}};
+    }
+
+};
+
+/**
+ * Benchmark that estimates a host allocation of the given size for the memory dry run
+ */
+class EstimatedBenchmark : public SuccessBenchmark {
+
+public:
+
+    size_t estimatedHostBytes = 1024;
+
+    std::vector<memory_tracker::MemoryRequirement>
+    estimateMemoryUsage() override {
+        return {{"data", estimatedHostBytes, 1, false}};
+    }
+
+};
+
 class BaseHpccBenchmarkTest :public  ::testing::Test {
 
 public:
@@ -187,6 +231,29 @@ TEST_F(BaseHpccBenchmarkTest, FindNonExistingDevice) {
     ASSERT_THROW(fpga_setup::selectFPGADevice(bm->getExecutionSettings().programSettings->defaultPlatform, 100).get(), fpga_setup::FpgaSetupException);
 }
 
+/**
+ * Checks if requesting more devices than available leads to an error
+ */
+TEST_F(BaseHpccBenchmarkTest, FindTooManyDevices) {
+    ASSERT_THROW(fpga_setup::selectFPGADevices(bm->getExecutionSettings().programSettings->defaultPlatform, bm->getExecutionSettings().programSettings->defaultDevice, 100), fpga_setup::FpgaSetupException);
+}
+
+/**
+ * Checks if the first device is contained in the list of all used devices
+ */
+TEST_F(BaseHpccBenchmarkTest, SelectedDeviceIsInDeviceList) {
+    auto &settings = bm->getExecutionSettings();
+    if (settings.device) {
+        ASSERT_EQ(settings.devices.size(), 1);
+        EXPECT_EQ(settings.devices[0](), (*settings.device)());
+        EXPECT_EQ(settings.contexts.size(), 1);
+        EXPECT_EQ(settings.programs.size(), 1);
+    }
+    else {
+        EXPECT_TRUE(settings.devices.empty());
+    }
+}
+
 /**
  * Execute kernel and validation is success
  */
@@ -210,6 +277,102 @@ TEST_F(BaseHpccBenchmarkTest, FailedExe) {
     EXPECT_FALSE(bm->executeBenchmark());
 }
 
+/**
+ * Configuration and results are dumped to a JSON file if a path is given
+ */
+TEST_F(BaseHpccBenchmarkTest, JsonDumpContainsConfigurationAndValidation) {
+    bm->getExecutionSettings().programSettings->dumpfilePath = "hpcc_base_test_dump.json";
+    EXPECT_TRUE(bm->executeBenchmark());
+    std::ifstream fs("hpcc_base_test_dump.json");
+    ASSERT_TRUE(fs.is_open());
+    json dump = json::parse(fs);
+    EXPECT_TRUE(dump["validated"].get<bool>());
+    EXPECT_EQ(dump["settings"].size(), bm->getExecutionSettings().programSettings->getSettingsMap().size());
+    EXPECT_TRUE(dump.contains("timings"));
+    EXPECT_TRUE(dump.contains("results"));
+}
+
+/**
+ * The memory dry run only prints the estimate and does not generate or execute anything
+ */
+TEST_F(BaseHpccBenchmarkTest, NothingExecutedInMemoryDryRun) {
+    bm->getExecutionSettings().programSettings->dryRunMemory = true;
+    EXPECT_TRUE(bm->executeBenchmark());
+    EXPECT_EQ(bm->validateOutputcalled, 0);
+    EXPECT_EQ(bm->executeKernelcalled, 0);
+    EXPECT_EQ(bm->generateInputDatacalled, 0);
+}
+
+/**
+ * The memory dry run fails if the estimate exceeds the host memory
+ */
+TEST(MemoryTrackerTest, DryRunFailsForOversizedEstimate) {
+    EstimatedBenchmark bm;
+    bm.setupBenchmark(global_argc, global_argv);
+    bm.getExecutionSettings().programSettings->dryRunMemory = true;
+    EXPECT_TRUE(bm.executeBenchmark());
+    bm.estimatedHostBytes = std::numeric_limits<size_t>::max();
+    EXPECT_FALSE(bm.executeBenchmark());
+    EXPECT_EQ(bm.generateInputDatacalled, 0);
+}
+
+/**
+ * Host blocks allocated with numa::memalign are accounted until they are freed and the peak is kept
+ */
+TEST(MemoryTrackerTest, HostAllocationsAreTracked) {
+    auto &tracker = memory_tracker::getTracker();
+    size_t peak = tracker.getPeakHostBytes();
+    char* first;
+    char* second;
+    numa::memalign(reinterpret_cast<void**>(&first), 64, 1 << 20);
+    numa::free(first);
+    numa::memalign(reinterpret_cast<void**>(&second), 64, 1 << 20);
+    EXPECT_GE(tracker.getPeakHostBytes(), peak + (1 << 20));
+    EXPECT_LT(tracker.getPeakHostBytes(), peak + (2 << 20));
+    numa::free(second);
+    EXPECT_GT(memory_tracker::peakResidentSetSize(), 0);
+}
+
+/**
+ * Device memory is accounted per bank
+ */
+TEST(MemoryTrackerTest, DeviceAllocationsAreTrackedPerBank) {
+    memory_tracker::MemoryTracker tracker;
+    tracker.recordDeviceAllocation(0, 100);
+    tracker.recordDeviceAllocation(1, 50);
+    tracker.recordDeviceFree(0, 100);
+    tracker.recordDeviceAllocation(0, 20);
+    EXPECT_EQ(tracker.getPeakDeviceBytes()[0], 100);
+    EXPECT_EQ(tracker.getPeakDeviceBytes()[1], 50);
+    EXPECT_EQ(tracker.getPeakTotalDeviceBytes(), 150);
+    EXPECT_EQ(memory_tracker::formatBytes(1536.0), "1.50 KiB");
+}
+
+/**
+ * Input data is loaded from the data cache in the second execution
+ */
+TEST(DataCacheTest, InputDataIsLoadedFromCache) {
+    CachedBenchmark bm;
+    bm.setupBenchmark(global_argc, global_argv);
+    bm.getExecutionSettings().programSettings->dataCachePath = ".";
+    std::remove(bm.getInputDataCacheFile().c_str());
+    EXPECT_TRUE(bm.executeBenchmark());
+    EXPECT_EQ(bm.generateInputDatacalled, 1);
+    EXPECT_TRUE(bm.executeBenchmark());
+    EXPECT_EQ(bm.generateInputDatacalled, 1);
+    std::remove(bm.getInputDataCacheFile().c_str());
+}
+
+/**
+ * Input data is always generated if the benchmark does not support the data cache
+ */
+TEST_F(BaseHpccBenchmarkTest, InputDataIsGeneratedWithoutCacheSupport) {
+    bm->getExecutionSettings().programSettings->dataCachePath = ".";
+    EXPECT_TRUE(bm->executeBenchmark());
+    EXPECT_TRUE(bm->executeBenchmark());
+    EXPECT_EQ(bm->generateInputDatacalled, 2);
+}
+
 /**
  * Benchmark Setup is successful with default data
  */
@@ -237,6 +400,149 @@ TEST(SetupTest, BenchmarkConfigurationFailsExecution) {
     EXPECT_FALSE(bm->executeBenchmark());
 }
 
+/**
+ * Benchmark Setup fails if multiple devices per rank are requested, but not supported by the benchmark
+ */
+TEST(SetupTest, BenchmarkSetupFailsForUnsupportedMultipleDevices) {
+    std::unique_ptr<MinimalBenchmark> bm = std::unique_ptr<MinimalBenchmark>(new MinimalBenchmark());
+    std::vector<char*> tmp_argv(global_argv, global_argv + global_argc);
+    char devices_str[] = "--devices-per-rank=2";
+    tmp_argv.push_back(devices_str);
+    tmp_argv.push_back(nullptr);
+    EXPECT_FALSE(bm->setupBenchmark(global_argc + 1, tmp_argv.data()));
+}
+
+/**
+ * All points of a sweep are executed with the changed option
+ */
+TEST(SetupTest, SweepExecutesAllPoints) {
+    std::unique_ptr<SuccessBenchmark> bm = std::unique_ptr<SuccessBenchmark>(new SuccessBenchmark());
+    std::vector<char*> tmp_argv(global_argv, global_argv + global_argc);
+    char sweep_str[] = "--sweep=n=1:3:1";
+    tmp_argv.push_back(sweep_str);
+    tmp_argv.push_back(nullptr);
+    ASSERT_TRUE(bm->setupBenchmark(global_argc + 1, tmp_argv.data()));
+    bm->getExecutionSettings().programSettings->testOnly = false;
+    EXPECT_TRUE(bm->executeBenchmark());
+    EXPECT_EQ(bm->executeKernelcalled, 3);
+    EXPECT_EQ(bm->generateInputDatacalled, 3);
+    EXPECT_EQ(bm->getExecutionSettings().programSettings->numRepetitions, 3);
+}
+
+#ifdef NUM_REPLICATIONS
+/**
+ * The replication scaling executes the benchmark for every number of replications
+ */
+TEST(SetupTest, ReplicationScalingExecutesAllReplications) {
+    std::unique_ptr<SuccessBenchmark> bm = std::unique_ptr<SuccessBenchmark>(new SuccessBenchmark());
+    std::vector<char*> tmp_argv(global_argv, global_argv + global_argc);
+    char scaling_str[] = "--scale-replications";
+    tmp_argv.push_back(scaling_str);
+    tmp_argv.push_back(nullptr);
+    ASSERT_TRUE(bm->setupBenchmark(global_argc + 1, tmp_argv.data()));
+    bm->getExecutionSettings().programSettings->testOnly = false;
+    uint replications = bm->getExecutionSettings().programSettings->kernelReplications;
+    // The test benchmark does not report a rate that could be used for the scaling
+    EXPECT_FALSE(bm->executeBenchmark());
+    EXPECT_EQ(bm->executeKernelcalled, replications);
+    EXPECT_EQ(bm->getExecutionSettings().programSettings->kernelReplications, replications);
+}
+#endif
+
+/**
+ * Check if the rank scaling is rejected, if the benchmark does not support it
+ */
+TEST(SetupTest, RankScalingFailsWithoutBenchmarkSupport) {
+    std::unique_ptr<SuccessBenchmark> bm = std::unique_ptr<SuccessBenchmark>(new SuccessBenchmark());
+    std::vector<char*> tmp_argv(global_argv, global_argv + global_argc);
+    char scaling_str[] = "--scale-ranks=WEAK";
+    tmp_argv.push_back(scaling_str);
+    tmp_argv.push_back(nullptr);
+    ASSERT_TRUE(bm->setupBenchmark(global_argc + 1, tmp_argv.data()));
+    bm->getExecutionSettings().programSettings->testOnly = false;
+    EXPECT_FALSE(bm->executeBenchmark());
+    EXPECT_EQ(bm->executeKernelcalled, 0);
+}
+
+/**
+ * Check if the parallel efficiency is relative to linear scaling
+ */
+TEST(SweepTest, ParallelEfficiencyIsRelativeToLinearScaling) {
+    EXPECT_DOUBLE_EQ(hpcc_base::parallelEfficiency(2.0, 1.0, 2), 1.0);
+    EXPECT_DOUBLE_EQ(hpcc_base::parallelEfficiency(3.0, 1.0, 4), 0.75);
+}
+
+/**
+ * Check if ranks are not failing the rank scaling because of points they did not take part in
+ */
+TEST(SweepTest, RankScalingIgnoresPointsOutsideOfSubCommunicator) {
+    EXPECT_TRUE(hpcc_base::rankScalingValidated({true, false, false}, {true, false, false}));
+    EXPECT_FALSE(hpcc_base::rankScalingValidated({true, true, false}, {true, false, false}));
+    EXPECT_TRUE(hpcc_base::rankScalingValidated({}, {}));
+}
+
+#ifdef _USE_MPI_
+/**
+ * Benchmark that supports the rank scaling and reports a rate together with the number of ranks of every point
+ */
+class RankScalingBenchmark : public SuccessBenchmark {
+
+public:
+
+    std::vector<std::string> pointRanks;
+
+    std::vector<std::string>
+    getRankScalingArguments(int ranks, bool weak) override {
+        return {};
+    }
+
+    void
+    collectAndPrintResults(const int &output) override {
+        pointRanks.push_back(executionSettings->getSettingsMap()["MPI Ranks"]);
+        results.emplace("rate", hpcc_base::HpccResult(1.0, "1/s"));
+    }
+};
+
+/**
+ * The rank scaling succeeds on all ranks, if all points are validated. Ranks that are not part of the
+ * first point with a single rank must not fail the scaling. Every point reports the size of its sub-communicator.
+ */
+TEST(SetupTest, RankScalingSucceedsOnAllRanks) {
+    std::unique_ptr<RankScalingBenchmark> bm = std::unique_ptr<RankScalingBenchmark>(new RankScalingBenchmark());
+    std::vector<char*> tmp_argv(global_argv, global_argv + global_argc);
+    char scaling_str[] = "--scale-ranks=WEAK";
+    tmp_argv.push_back(scaling_str);
+    tmp_argv.push_back(nullptr);
+    ASSERT_TRUE(bm->setupBenchmark(global_argc + 1, tmp_argv.data()));
+    bm->getExecutionSettings().programSettings->testOnly = false;
+    int world_rank;
+    int world_size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+    EXPECT_TRUE(bm->executeBenchmark());
+    if (world_rank == 0) {
+        ASSERT_FALSE(bm->pointRanks.empty());
+        EXPECT_EQ(bm->pointRanks[0], "1");
+    }
+    EXPECT_EQ(bm->getExecutionSettings().programSettings->mpiRanks, world_size);
+}
+#endif
+
+/**
+ * Options used for the device setup can not be changed in a sweep
+ */
+TEST(SetupTest, SweepFailsForDeviceOptions) {
+    std::unique_ptr<SuccessBenchmark> bm = std::unique_ptr<SuccessBenchmark>(new SuccessBenchmark());
+    std::vector<char*> tmp_argv(global_argv, global_argv + global_argc);
+    char sweep_str[] = "--sweep=device=0,1";
+    tmp_argv.push_back(sweep_str);
+    tmp_argv.push_back(nullptr);
+    ASSERT_TRUE(bm->setupBenchmark(global_argc + 1, tmp_argv.data()));
+    bm->getExecutionSettings().programSettings->testOnly = false;
+    EXPECT_FALSE(bm->executeBenchmark());
+    EXPECT_EQ(bm->executeKernelcalled, 0);
+}
+
 /**
  * Benchmark Setup fails with empty data
  */
@@ -251,3 +557,538 @@ TEST(SetupTest, BenchmarkSetupFails) {
     delete [] tmp_argv;
     delete [] name_str;
 }
+
+
+/**
+ * Durations of the same command and replication are summed up per repetition
+ */
+TEST(ProfilingTest, TimingsMapSumsUpDurationsPerRepetition) {
+    std::vector<profiling::DeviceTiming> timings = {
+        {"kernel", 0, 0, 0, 1000000000},
+        {"kernel", 0, 0, 2000000000, 3000000000},
+        {"kernel", 1, 0, 0, 500000000},
+        {"kernel", 0, 1, 0, 2000000000}};
+    auto map = profiling::toTimingsMap(timings);
+    EXPECT_EQ(map.size(), 2);
+    ASSERT_EQ(map["kernel_0"].size(), 2);
+    EXPECT_DOUBLE_EQ(map["kernel_0"][0], 2.0);
+    EXPECT_DOUBLE_EQ(map["kernel_0"][1], 2.0);
+    ASSERT_EQ(map["kernel_1"].size(), 1);
+    EXPECT_DOUBLE_EQ(map["kernel_1"][0], 0.5);
+}
+
+/**
+ * The total span includes the skew between the replications
+ */
+TEST(ProfilingTest, TotalSpanIncludesSkewOfReplications) {
+    std::vector<profiling::DeviceTiming> timings = {
+        {"kernel", 0, 0, 1000000000, 2000000000},
+        {"kernel", 1, 0, 1500000000, 3000000000},
+        {"write", 0, 0, 0, 1000000000}};
+    auto spans = profiling::getTotalSpan(timings, "kernel");
+    ASSERT_EQ(spans.size(), 1);
+    EXPECT_DOUBLE_EQ(spans[0], 2.0);
+}
+
+/**
+ * Memory bound to a NUMA node is aligned to the page size and can be written
+ */
+TEST(NumaAllocationTest, BoundMemoryIsPageAligned) {
+    numa::setDefaultNode(0);
+    char* ptr = nullptr;
+    EXPECT_EQ(numa::memalign(reinterpret_cast<void**>(&ptr), 64, 3 * 4096), 0);
+    ASSERT_NE(ptr, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % 4096, 0);
+    std::fill(ptr, ptr + 3 * 4096, 1);
+    EXPECT_EQ(ptr[3 * 4096 - 1], 1);
+    numa::free(ptr);
+    numa::setDefaultNode(-1);
+}
+
+/**
+ * Without a NUMA node the requested alignment is used
+ */
+TEST(NumaAllocationTest, UnboundMemoryUsesGivenAlignment) {
+    numa::setDefaultNode(-1);
+    char* ptr = nullptr;
+    EXPECT_EQ(numa::memalign(reinterpret_cast<void**>(&ptr), 64, 100), 0);
+    ASSERT_NE(ptr, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % 64, 0);
+    numa::free(ptr);
+}
+
+/**
+ * Allocations with huge pages are aligned to the huge page size or fall back to normal pages
+ */
+TEST(NumaAllocationTest, HugepageMemoryIsAlignedOrFallsBack) {
+    numa::setHugepageSize(2);
+    char* ptr = nullptr;
+    EXPECT_EQ(numa::memalign(reinterpret_cast<void**>(&ptr), 64, 4096), 0);
+    ASSERT_NE(ptr, nullptr);
+    bool is_mapped = numa::mappedRegions().count(ptr) > 0;
+    if (is_mapped) {
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % (2 << 20), 0);
+    }
+    else {
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % 64, 0);
+    }
+    ptr[4095] = 1;
+    numa::free(ptr);
+    EXPECT_EQ(numa::mappedRegions().count(ptr), 0);
+    numa::setHugepageSize(0);
+}
+
+/**
+ * Check if the buffers are mapped to the given memory banks
+ */
+TEST(MemoryPlacementTest, ExplicitBanksArePerReplicationAndBuffer) {
+    placement::BankMap map("0:1:2,3:4:5");
+    EXPECT_EQ(map.bank(0, 2, 3), 2);
+    EXPECT_EQ(map.bank(1, 0, 3), 3);
+    // the list is repeated for additional replications
+    EXPECT_EQ(map.bank(2, 1, 3), 1);
+    placement::BankMap single("7,8");
+    EXPECT_EQ(single.bank(1, 2, 3), 8);
+}
+
+/**
+ * Check if round robin placement uses distinct banks for all buffers
+ */
+TEST(MemoryPlacementTest, RoundRobinUsesDistinctBanks) {
+    placement::BankMap map("rr:32");
+    EXPECT_EQ(map.bank(0, 0, 3), 0);
+    EXPECT_EQ(map.bank(3, 1, 3), 10);
+    EXPECT_EQ(map.bank(11, 2, 3), 3);
+}
+
+/**
+ * Check if an empty map leaves the placement to the runtime and invalid maps are rejected
+ */
+TEST(MemoryPlacementTest, EmptyAndInvalidMaps) {
+    placement::BankMap map("");
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.bank(1, 1, 3), -1);
+    EXPECT_THROW(placement::BankMap("0,a"), std::runtime_error);
+    EXPECT_THROW(placement::BankMap("0,,1"), std::runtime_error);
+    EXPECT_THROW(placement::BankMap("rr:0"), std::runtime_error);
+}
+
+/**
+ * Check if the bank map is read from a JSON file
+ */
+TEST(MemoryPlacementTest, BanksAreReadFromJsonFile) {
+    {
+        std::ofstream fs("test_memory_banks.json");
+        fs << "{\"banks\": [[0, 1, 2], [3, 4, 5]]}";
+    }
+    placement::BankMap map("test_memory_banks.json");
+    EXPECT_EQ(map.bank(1, 2, 3), 5);
+    EXPECT_EQ(map.bank(2, 0, 3), 0);
+    std::remove("test_memory_banks.json");
+    EXPECT_THROW(placement::BankMap("test_memory_banks.json"), std::runtime_error);
+}
+
+/**
+ * Check if the used DDR and HBM banks are read from the memory topology of an xclbin file
+ */
+TEST(MemoryPlacementTest, AutomaticPlacementUsesXclbinTopology) {
+    std::string file(1200, '\0');
+    file.replace(0, 7, "xclbin2");
+    uint32_t num_sections = 1;
+    uint32_t kind = 6;
+    uint64_t offset = 1000;
+    int32_t count = 4;
+    std::memcpy(&file[448], &num_sections, sizeof(num_sections));
+    std::memcpy(&file[456], &kind, sizeof(kind));
+    std::memcpy(&file[456 + 24], &offset, sizeof(offset));
+    std::memcpy(&file[offset], &count, sizeof(count));
+    // HBM used, HBM unused, streaming used, DDR4 used
+    const uint8_t types[] = {6, 6, 3, 1};
+    const uint8_t used[] = {1, 0, 1, 1};
+    for (int m = 0; m < count; m++) {
+        file[offset + 8 + m * 40] = types[m];
+        file[offset + 9 + m * 40] = used[m];
+    }
+    {
+        std::ofstream fs("test_topology.xclbin", std::ios::binary);
+        fs << file;
+    }
+    placement::BankMap map("auto");
+    EXPECT_TRUE(map.setTopology("test_topology.xclbin"));
+    EXPECT_EQ(map.bank(0, 0, 1), 0);
+    EXPECT_EQ(map.bank(1, 0, 1), 3);
+    EXPECT_EQ(map.bank(2, 0, 1), 0);
+    std::remove("test_topology.xclbin");
+    EXPECT_FALSE(map.setTopology("test_topology.xclbin"));
+}
+
+/**
+ * Check if the UUID of an xclbin file is used as bitstream ID
+ */
+TEST(BitstreamIdTest, XclbinIdIsUuid) {
+    std::vector<unsigned char> file(1000, 0);
+    std::memcpy(file.data(), "xclbin2", 7);
+    for (int i = 0; i < 16; i++) {
+        file[416 + i] = i;
+    }
+    EXPECT_EQ(fpga_setup::getBitstreamId(file.data(), file.size()), "000102030405060708090a0b0c0d0e0f");
+    // The content of the kernels does not change the ID
+    file[900] = 1;
+    EXPECT_EQ(fpga_setup::getBitstreamId(file.data(), file.size()), "000102030405060708090a0b0c0d0e0f");
+}
+
+/**
+ * Check if the hash of other bitstreams changes with the content
+ */
+TEST(BitstreamIdTest, HashDependsOnContent) {
+    std::vector<unsigned char> file(100, 1);
+    std::string id = fpga_setup::getBitstreamId(file.data(), file.size());
+    EXPECT_EQ(id.size(), 16);
+    EXPECT_EQ(fpga_setup::getBitstreamId(file.data(), file.size()), id);
+    file[50] = 2;
+    EXPECT_NE(fpga_setup::getBitstreamId(file.data(), file.size()), id);
+}
+
+/**
+ * Check if lists and ranges of sweep values are parsed correctly
+ */
+TEST(SweepTest, ListsAndRangesAreParsed) {
+    auto list = hpcc_base::parseSweep("s=1,4,2");
+    EXPECT_EQ(list.first, "s");
+    EXPECT_EQ(list.second, std::vector<std::string>({"1", "4", "2"}));
+    auto range = hpcc_base::parseSweep("matrix_size=256:1024:256");
+    EXPECT_EQ(range.first, "matrix_size");
+    EXPECT_EQ(range.second, std::vector<std::string>({"256", "512", "768", "1024"}));
+    auto factor = hpcc_base::parseSweep("s=1024:8192:x2");
+    EXPECT_EQ(factor.second, std::vector<std::string>({"1024", "2048", "4096", "8192"}));
+}
+
+/**
+ * Check if invalid sweeps are rejected
+ */
+TEST(SweepTest, InvalidSweepsThrow) {
+    EXPECT_THROW(hpcc_base::parseSweep("s"), std::runtime_error);
+    EXPECT_THROW(hpcc_base::parseSweep("=1,2"), std::runtime_error);
+    EXPECT_THROW(hpcc_base::parseSweep("s=1:4"), std::runtime_error);
+    EXPECT_THROW(hpcc_base::parseSweep("s=1:4:x1"), std::runtime_error);
+    EXPECT_THROW(hpcc_base::parseSweep("s=4:1:1"), std::runtime_error);
+}
+
+/**
+ * Check if the statistics are calculated correctly for known measurements
+ */
+TEST(StatisticsTest, StatisticsOfKnownValues) {
+    std::vector<double> values({4.0, 1.0, 3.0, 2.0});
+    auto s = statistics::computeStatistics(values);
+    EXPECT_DOUBLE_EQ(s.min, 1.0);
+    EXPECT_DOUBLE_EQ(s.max, 4.0);
+    EXPECT_DOUBLE_EQ(s.mean, 2.5);
+    EXPECT_DOUBLE_EQ(s.median, 2.5);
+    EXPECT_DOUBLE_EQ(s.stddev, std::sqrt(5.0 / 3.0));
+    EXPECT_DOUBLE_EQ(s.p95, 4.0);
+    EXPECT_DOUBLE_EQ(s.p99, 4.0);
+    EXPECT_DOUBLE_EQ(s.cv, std::sqrt(5.0 / 3.0) / 2.5);
+    auto single = statistics::computeStatistics({2.0});
+    EXPECT_DOUBLE_EQ(single.median, 2.0);
+    EXPECT_DOUBLE_EQ(single.stddev, 0.0);
+    EXPECT_THROW(statistics::computeStatistics({}), std::runtime_error);
+}
+
+/**
+ * Check if the warm-up measurements are removed but at least one measurement is kept
+ */
+TEST(StatisticsTest, WarmupIsDiscarded) {
+    std::vector<double> values({10.0, 1.0, 2.0});
+    EXPECT_EQ(statistics::discardWarmup(values, 0), values);
+    EXPECT_EQ(statistics::discardWarmup(values, 1), std::vector<double>({1.0, 2.0}));
+    EXPECT_EQ(statistics::discardWarmup(values, 5), std::vector<double>({2.0}));
+    EXPECT_TRUE(statistics::discardWarmup({}, 2).empty());
+}
+
+/**
+ * Check if the power is parsed from the output of the board management tools
+ */
+TEST(PowerMeasurementTest, PowerIsParsedFromToolOutput) {
+    EXPECT_DOUBLE_EQ(power::parsePowerOutput("Board Power\nTotal Input Power              : 74.63 Watts\n"), 74.63);
+    EXPECT_DOUBLE_EQ(power::parsePowerOutput("  Power                  : 24 W\n"), 24.0);
+    EXPECT_THROW(power::parsePowerOutput("12V Backplane Current : 2.5 Amps"), std::runtime_error);
+    EXPECT_THROW(power::createPowerSource("unknown", cl::Device()), std::runtime_error);
+}
+
+/**
+ * Check if the temperature is parsed from the output of the board management tools
+ */
+TEST(PowerMeasurementTest, TemperatureIsParsedFromToolOutput) {
+    EXPECT_DOUBLE_EQ(power::parseTemperatureOutput("FPGA Core Temperature          : 61.5 Celsius\n"), 61.5);
+    EXPECT_DOUBLE_EQ(power::parseTemperatureOutput("  FPGA                 : 48 C\n"), 48.0);
+    EXPECT_DOUBLE_EQ(power::parseTemperatureOutput("Board temperature: 35\xC2\xB0""C"), 35.0);
+    EXPECT_THROW(power::parseTemperatureOutput("Fan speed: 3000 RPM"), std::runtime_error);
+    EXPECT_THROW(power::createTemperatureSource("unknown", cl::Device()), std::runtime_error);
+}
+
+/**
+ * Check if an iteration is only reported as degraded if the drop exceeds the threshold
+ */
+TEST(SoakTest, DegradationUsesThreshold) {
+    EXPECT_FALSE(soak::isDegraded(100.0, 100.0, 5.0));
+    EXPECT_FALSE(soak::isDegraded(96.0, 100.0, 5.0));
+    EXPECT_TRUE(soak::isDegraded(94.0, 100.0, 5.0));
+    EXPECT_FALSE(soak::isDegraded(120.0, 100.0, 0.0));
+}
+
+/**
+ * Check if the soak samples are appended to the CSV file and the Prometheus file only contains the last sample
+ */
+TEST(SoakTest, SamplesAreWrittenToFile) {
+    std::string csv_path = "soak_test.csv";
+    std::string prom_path = "soak_test.prom";
+    {
+        soak::SoakWriter csv(csv_path, "gflops", "GFLOP/s");
+        soak::SoakWriter prom(prom_path, "gflops", "GFLOP/s");
+        double nan = std::numeric_limits<double>::quiet_NaN();
+        csv.write({0, 1.5, 100.0, 55.0, nan, false});
+        csv.write({1, 3.0, 90.0, 60.0, nan, true});
+        prom.write({0, 1.5, 100.0, 55.0, nan, false});
+        prom.write({1, 3.0, 90.0, 60.0, nan, true});
+    }
+    std::ifstream csv_file(csv_path);
+    std::string line;
+    std::vector<std::string> lines;
+    while (std::getline(csv_file, line)) {
+        lines.push_back(line);
+    }
+    ASSERT_EQ(lines.size(), 3u);
+    EXPECT_EQ(lines[0], "iteration,elapsed_s,gflops_GFLOP/s,temperature_C,power_W,degraded");
+    EXPECT_EQ(lines[2], "1,3,90,60,,1");
+
+    std::ifstream prom_file(prom_path);
+    std::stringstream prom;
+    prom << prom_file.rdbuf();
+    EXPECT_NE(prom.str().find("hpcc_soak_throughput{metric=\"gflops\",unit=\"GFLOP/s\"} 90\n"), std::string::npos);
+    EXPECT_NE(prom.str().find("hpcc_soak_power_watts NaN\n"), std::string::npos);
+    EXPECT_NE(prom.str().find("hpcc_soak_degraded_iterations_total 1\n"), std::string::npos);
+    std::remove(csv_path.c_str());
+    std::remove(prom_path.c_str());
+}
+
+/**
+ * Check if rates have to increase and times have to decrease and the tolerance is widened by the variation
+ */
+TEST(BaselineTest, MetricsAreComparedWithTolerance) {
+    json reference = {{"gflops", {{"value", 100.0}, {"unit", "GFLOP/s"}}}, {"t_min", {{"value", 1.0}, {"unit", "s"}}},
+                        {"t_cv", {{"value", 0.01}, {"unit", ""}}}, {"removed", {{"value", 1.0}, {"unit", "s"}}}};
+    json current = {{"gflops", {{"value", 94.0}, {"unit", "GFLOP/s"}}}, {"t_min", {{"value", 0.9}, {"unit", "s"}}},
+                        {"t_cv", {{"value", 0.5}, {"unit", ""}}}, {"added", {{"value", 1.0}, {"unit", "s"}}}};
+    auto c = baseline::compareResults(current, reference, 0.05, 0.0);
+    ASSERT_EQ(c.size(), 3u);
+    std::map<std::string, baseline::MetricComparison> m;
+    for (const auto &r : c) {
+        m.emplace(r.name, r);
+    }
+    EXPECT_FALSE(m.at("gflops").passed);
+    EXPECT_NEAR(m.at("gflops").change, -0.06, 1.0e-12);
+    EXPECT_TRUE(m.at("t_min").passed);
+    EXPECT_NEAR(m.at("t_min").change, 0.1, 1.0e-12);
+    EXPECT_FALSE(m.at("removed").passed);
+    EXPECT_TRUE(std::isnan(m.at("removed").value));
+    // A variation of 3% accepts a drop of 9%
+    auto widened = baseline::compareResults(current, reference, 0.05, 0.03);
+    EXPECT_TRUE(widened[0].passed);
+    EXPECT_NEAR(widened[0].tolerance, 0.09, 1.0e-12);
+}
+
+/**
+ * Check if different settings are detected and settings without influence on the measurement are ignored
+ */
+TEST(BaselineTest, SettingsDifferencesAreDetected) {
+    json reference = {{"Repetitions", "10"}, {"Kernel File", "gemm.aocx"}, {"Baseline", "None"}};
+    json current = {{"Repetitions", "10"}, {"Kernel File", "gemm.aocx"}, {"Baseline", "last.json"}};
+    EXPECT_TRUE(baseline::settingsDifferences(current, reference).empty());
+    current["Kernel File"] = "other.aocx";
+    current["Trace File"] = "trace.json";
+    reference["Warm-up Repetitions"] = "1";
+    EXPECT_EQ(baseline::settingsDifferences(current, reference), std::vector<std::string>({"Kernel File", "Warm-up Repetitions"}));
+    EXPECT_DOUBLE_EQ(baseline::maxVariation(json::object()), 0.0);
+    EXPECT_GT(baseline::maxVariation({{"t", {1.0, 2.0}}, {"single", {5.0}}}), 0.4);
+}
+
+/**
+ * Check if the SIMD conversion of half precision values matches the scalar conversion for all values
+ */
+TEST(HalfConversionTest, SimdConversionMatchesScalarConversion) {
+    std::vector<uint16_t> halfs(1 << 16);
+    for (size_t i = 0; i < halfs.size(); i++) {
+        halfs[i] = static_cast<uint16_t>(i);
+    }
+    // An odd number of values also covers the remainder of the vectorized loops
+    size_t count = halfs.size() - 3;
+    std::vector<float> floats(count);
+    half_conversion::halfToFloat(halfs.data(), floats.data(), count);
+    std::vector<uint16_t> converted(count);
+    half_conversion::floatToHalf(floats.data(), converted.data(), count);
+    for (size_t i = 0; i < count; i++) {
+        float expected = half_conversion::halfToFloatScalar(halfs[i]);
+        if (std::isnan(expected)) {
+            EXPECT_TRUE(std::isnan(floats[i]));
+            continue;
+        }
+        EXPECT_EQ(floats[i], expected);
+        EXPECT_EQ(converted[i], halfs[i]);
+    }
+}
+
+/**
+ * Check if single precision values are rounded to the nearest even half precision value
+ */
+TEST(HalfConversionTest, FloatIsRoundedToNearestEven) {
+    EXPECT_EQ(half_conversion::floatToHalfScalar(1.0f), 0x3C00);
+    // Exactly between 1 and the next half precision value, so it is rounded to the even value 1
+    EXPECT_EQ(half_conversion::floatToHalfScalar(1.0f + 1.0f / 2048), 0x3C00);
+    EXPECT_EQ(half_conversion::floatToHalfScalar(1.0f + 3.0f / 2048), 0x3C02);
+    EXPECT_EQ(half_conversion::floatToHalfScalar(65520.0f), 0x7C00);
+    EXPECT_EQ(half_conversion::floatToHalfScalar(-0.0f), 0x8000);
+    // Smallest subnormal half precision value
+    EXPECT_EQ(half_conversion::floatToHalfScalar(5.9604645e-8f), 0x0001);
+    std::vector<float> values = {1.0f + 1.0f / 2048, 1.0f + 3.0f / 2048, 65520.0f, -0.0f, 5.9604645e-8f, 
+                                    3.14159f, -2.71828f, 1.0e-6f, 60000.0f, 0.5f, 0.25f, 0.125f, 100.0f, 1000.0f, 1.0e-5f, 2.0f, 3.0f};
+    std::vector<uint16_t> converted(values.size());
+    half_conversion::floatToHalf(values.data(), converted.data(), values.size());
+    for (size_t i = 0; i < values.size(); i++) {
+        EXPECT_EQ(converted[i], half_conversion::floatToHalfScalar(values[i]));
+    }
+}
+
+/**
+ * Check if the energy of a constant power source is integrated over the measurement window
+ */
+TEST(PowerMeasurementTest, ConstantPowerIsIntegrated) {
+    power::PowerSampler sampler([]() { return 10.0; }, std::chrono::milliseconds(1));
+    sampler.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    auto m = sampler.stop();
+    EXPECT_GT(m.samples, 1u);
+    EXPECT_DOUBLE_EQ(m.averagePower, 10.0);
+    EXPECT_DOUBLE_EQ(m.maxPower, 10.0);
+    EXPECT_NEAR(m.energy, 10.0 * m.duration, 1.0e-9);
+}
+
+/**
+ * Check the Philox implementation against the known answer tests of the reference implementation
+ */
+TEST(CounterRngTest, PhiloxKnownAnswers) {
+    EXPECT_EQ(rng::philox4x32({{0, 0, 0, 0}}, {{0, 0}}),
+                (std::array<uint32_t, 4>({{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}})));
+    EXPECT_EQ(rng::philox4x32({{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}}, {{0xffffffff, 0xffffffff}}),
+                (std::array<uint32_t, 4>({{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}})));
+    EXPECT_EQ(rng::philox4x32({{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}}, {{0xa4093822, 0x299f31d0}}),
+                (std::array<uint32_t, 4>({{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}})));
+}
+
+/**
+ * Check if the random numbers are in the given range and only depend on seed, stream and index
+ */
+TEST(CounterRngTest, UniformValuesAreInRangeAndReproducible) {
+    for (uint64_t i = 0; i < 1000; i++) {
+        double v = rng::uniform(1, 0, i, -1.0, 1.0);
+        EXPECT_GE(v, -1.0);
+        EXPECT_LT(v, 1.0);
+        EXPECT_EQ(v, rng::uniform(1, 0, i, -1.0, 1.0));
+    }
+    EXPECT_NE(rng::uniform(1, 0, 5), rng::uniform(1, 1, 5));
+    EXPECT_NE(rng::uniform(1, 0, 5), rng::uniform(2, 0, 5));
+    EXPECT_NE(rng::uniform(1, 0, 5), rng::uniform(1, 0, 6));
+}
+
+/**
+ * Check if the operations of the execution graph are executed after their dependencies
+ */
+TEST(ExecutionGraphTest, HostOperationsRespectDependencies) {
+    async_execution::ExecutionGraph graph;
+    std::vector<int> order;
+    auto first = graph.addHostOperation([&order]() { order.push_back(0); });
+    auto second = graph.addHostOperation([&order]() { order.push_back(1); }, {first});
+    graph.addHostOperation([&order]() { order.push_back(2); }, {first, second});
+    EXPECT_EQ(graph.size(), 3u);
+    EXPECT_FALSE(graph.isCompleted(first));
+    graph.wait();
+    EXPECT_EQ(order, std::vector<int>({0, 1, 2}));
+    EXPECT_TRUE(graph.isCompleted(second));
+    EXPECT_THROW(graph.event(first), std::runtime_error);
+}
+
+/**
+ * Check if dependencies have to be added before the dependent operations
+ */
+TEST(ExecutionGraphTest, UnknownDependenciesThrow) {
+    async_execution::ExecutionGraph graph;
+    EXPECT_THROW(graph.addHostOperation([]() {}, {0}), std::runtime_error);
+}
+
+/**
+ * The written trace contains the recorded spans and instant events in the Chrome trace format
+ */
+TEST(TracingTest, ChromeTraceContainsRecordedEvents) {
+    auto &tracer = tracing::getTracer();
+    tracer.start();
+    {
+        tracing::ScopedSpan span("test span");
+    }
+    tracer.recordInstant("test instant", "enqueue", tracing::DEVICE_TRACK_OFFSET, tracing::Tracer::now());
+    tracer.stop();
+    tracer.recordInstant("ignored instant", "enqueue", tracing::DEVICE_TRACK_OFFSET, tracing::Tracer::now());
+    EXPECT_EQ(tracer.getEvents().size(), 2);
+    tracer.write("hpcc_base_test_trace.json");
+
+    int rank = 0;
+#ifdef _USE_MPI_
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+    if (rank != 0) {
+        return;
+    }
+    std::ifstream fs("hpcc_base_test_trace.json");
+    ASSERT_TRUE(fs.is_open());
+    json trace = json::parse(fs);
+    bool found_span = false;
+    bool found_instant = false;
+    for (auto &e : trace["traceEvents"]) {
+        if (e["name"] == "test span") {
+            found_span = true;
+            EXPECT_EQ(e["ph"], "X");
+            EXPECT_GE(e["dur"].get<double>(), 0.0);
+        }
+        if (e["name"] == "test instant") {
+            found_instant = true;
+            EXPECT_EQ(e["ph"], "i");
+        }
+        EXPECT_NE(e["name"], "ignored instant");
+    }
+    EXPECT_TRUE(found_span);
+    EXPECT_TRUE(found_instant);
+}
+
+/**
+ * Check if the arguments of a benchmark in the suite are split at white spaces, but not within quotes
+ */
+TEST(SuiteTest, ArgumentsAreSplitAtWhiteSpaces) {
+    EXPECT_EQ(hpcc_suite::splitArguments("  -f 'my kernel.aocx'  -n 5 --sweep=\"s=1, 2\""),
+                std::vector<std::string>({"-f", "my kernel.aocx", "-n", "5", "--sweep=s=1, 2"}));
+    EXPECT_TRUE(hpcc_suite::splitArguments("").empty());
+    EXPECT_THROW(hpcc_suite::splitArguments("-f 'kernel.aocx"), std::runtime_error);
+}
+
+/**
+ * Check if the summary contains the results of all benchmarks and only succeeds if all benchmarks succeeded
+ */
+TEST(SuiteTest, SummaryContainsAllBenchmarks) {
+    hpcc_suite::BenchmarkSummary gemm{"GEMM", true, {{"gflops", {2.5, "GFLOP/s"}}}};
+    hpcc_suite::BenchmarkSummary fft{"FFT", false, {}};
+    std::string summary = hpcc_suite::formatSummary({gemm});
+    EXPECT_NE(summary.find("Begin of Summary section."), std::string::npos);
+    EXPECT_NE(summary.find("GEMM_gflops=2.5\n"), std::string::npos);
+    EXPECT_NE(summary.find("GEMM_Success=1\n"), std::string::npos);
+    EXPECT_NE(summary.find("\nSuccess=1\n"), std::string::npos);
+    summary = hpcc_suite::formatSummary({gemm, fft});
+    EXPECT_NE(summary.find("FFT_Success=0\n"), std::string::npos);
+    EXPECT_NE(summary.find("\nSuccess=0\n"), std::string::npos);
+}
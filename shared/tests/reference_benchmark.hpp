@@ -0,0 +1,88 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef SHARED_TESTS_REFERENCE_BENCHMARK_HPP_
+#define SHARED_TESTS_REFERENCE_BENCHMARK_HPP_
+
+/* C++ standard library headers */
+#include <cstdint>
+#include <vector>
+
+/* External library headers */
+#include "benchmark/benchmark.h"
+#ifdef _OPENMP
+#include "omp.h"
+#endif
+
+/**
+ * @brief Helpers for the microbenchmarks of the host reference implementations.
+ *          Every benchmark is executed for a list of sizes and thread counts. The first argument of a benchmark is
+ *          the size, the second argument the number of OpenMP threads.
+ *
+ */
+namespace reference_benchmark {
+
+/**
+ * @brief Get the thread counts the reference implementations are measured with.
+ *          They are doubled starting with a single thread. The maximum number of OpenMP threads is always included.
+ *
+ * @return std::vector<int64_t> The thread counts
+ */
+inline std::vector<int64_t>
+threadCounts() {
+#ifdef _OPENMP
+    int64_t max_threads = omp_get_max_threads();
+#else
+    int64_t max_threads = 1;
+#endif
+    std::vector<int64_t> counts;
+    for (int64_t t = 1; t < max_threads; t *= 2) {
+        counts.push_back(t);
+    }
+    counts.push_back(max_threads);
+    return counts;
+}
+
+/**
+ * @brief Set the number of OpenMP threads given as second argument of the benchmark
+ *
+ * @param state The state of the running benchmark
+ */
+inline void
+setThreads(benchmark::State &state) {
+#ifdef _OPENMP
+    omp_set_num_threads(static_cast<int>(state.range(1)));
+#endif
+}
+
+}  // namespace reference_benchmark
+
+/**
+ * @brief Register a reference benchmark for all given sizes and thread counts.
+ *          The wall clock time is used, because the implementations are parallelized with OpenMP.
+ *
+ */
+#define REFERENCE_BENCHMARK(func, ...) \
+    BENCHMARK(func)->ArgsProduct({{__VA_ARGS__}, reference_benchmark::threadCounts()})->ArgNames({"size", "omp_threads"}) \
+                   ->UseRealTime()->Unit(benchmark::kMillisecond)
+
+#endif // SHARED_TESTS_REFERENCE_BENCHMARK_HPP_
@@ -0,0 +1,180 @@
+/*
+Copyright (c) 2022 Marius Meyer
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/* C++ standard library headers */
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/* External library headers */
+#include "mpi.h"
+#include "cxxopts.hpp"
+
+/* Project's headers */
+#include "hpcc_suite.hpp"
+
+namespace {
+
+/**
+ * @brief A benchmark that is linked into the suite
+ *
+ */
+struct SuiteBenchmark {
+
+    /**
+     * @brief Name of the option that is used to give the arguments of the benchmark
+     *
+     */
+    std::string option;
+
+    /**
+     * @brief Entry point of the benchmark
+     *
+     */
+    hpcc_suite::BenchmarkSummary (*run)(const std::vector<std::string> &args);
+};
+
+/**
+ * @brief All benchmarks of the suite in the order they are executed
+ *
+ */
+const std::vector<SuiteBenchmark> suite_benchmarks = {
+#ifdef HPCC_SUITE_WITH_STREAM
+    {"stream", stream::runSuiteBenchmark},
+#endif
+#ifdef HPCC_SUITE_WITH_RANDOMACCESS
+    {"randomaccess", random_access::runSuiteBenchmark},
+#endif
+#ifdef HPCC_SUITE_WITH_PTRANS
+    {"ptrans", transpose::runSuiteBenchmark},
+#endif
+#ifdef HPCC_SUITE_WITH_FFT
+    {"fft", fft::runSuiteBenchmark},
+#endif
+#ifdef HPCC_SUITE_WITH_GEMM
+    {"gemm", gemm::runSuiteBenchmark},
+#endif
+#ifdef HPCC_SUITE_WITH_LINPACK
+    {"linpack", linpack::runSuiteBenchmark},
+#endif
+#ifdef HPCC_SUITE_WITH_B_EFF
+    {"b_eff", network::runSuiteBenchmark},
+#endif
+};
+
+}  // namespace
+
+/**
+The program entry point.
+Executes all benchmarks that are given with their arguments one after another within the same MPI job
+and prints the combined summary of all benchmarks.
+*/
+int
+main(int argc, char *argv[]) {
+    // MPI is initialized once for all benchmarks, so they will not finalize it
+    MPI_Init(&argc, &argv);
+    int mpi_comm_rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &mpi_comm_rank);
+
+    cxxopts::Options options(argv[0], "Executes multiple HPCC FPGA benchmarks one after another in a single MPI job.\n"
+                                        "The benchmarks are executed with the given arguments e.g. --stream=\"-f stream.aocx -n 5\".\n"
+                                        "Only the benchmarks with arguments are executed.");
+    options.add_options()
+            ("common", "Arguments that are used for all benchmarks e.g. --common=\"--platform 0\"",
+             cxxopts::value<std::string>()->default_value(""))
+            ("no-reuse-bitstream", "Always reconfigure the FPGA for every benchmark. By default, the reconfiguration is skipped if the bitstream is already loaded")
+            ("summary", "Write the combined summary of all benchmarks to the given file",
+             cxxopts::value<std::string>()->default_value(""))
+            ("roofline", "Place the GEMM, FFT and LINPACK kernels in the roofline model using the Triad bandwidth of STREAM. Requires the execution of STREAM")
+            ("peak-gflops", "Peak FLOP rate of the device in GFLOP/s used as compute roof in the roofline model. If 0, only the memory roof is used",
+             cxxopts::value<double>()->default_value("0"))
+            ("h,help", "Print this help");
+    for (const auto &bm : suite_benchmarks) {
+        options.add_options("Benchmarks")
+            (bm.option, "Arguments of the benchmark", cxxopts::value<std::string>());
+    }
+
+    std::vector<hpcc_suite::BenchmarkSummary> summaries;
+    bool success = true;
+    try {
+        auto result = options.parse(argc, argv);
+        if (result.count("h")) {
+            if (mpi_comm_rank == 0) {
+                std::cout << options.help({"", "Benchmarks"}) << std::endl;
+            }
+            MPI_Finalize();
+            return 0;
+        }
+        auto common_args = hpcc_suite::splitArguments(result["common"].as<std::string>());
+        bool roofline = result.count("roofline") > 0;
+        if (roofline && result.count("stream") == 0) {
+            throw std::runtime_error("The roofline analysis requires the execution of STREAM!");
+        }
+        if (result.count("no-reuse-bitstream") == 0) {
+            common_args.push_back("--reuse-bitstream");
+        }
+        for (const auto &bm : suite_benchmarks) {
+            if (result.count(bm.option) == 0) {
+                continue;
+            }
+            auto args = hpcc_suite::splitArguments(result[bm.option].as<std::string>());
+            args.insert(args.end(), common_args.begin(), common_args.end());
+            summaries.push_back(bm.run(args));
+            success = success && summaries.back().success;
+            // Start the next benchmark on all ranks at the same time
+            MPI_Barrier(MPI_COMM_WORLD);
+        }
+        if (summaries.empty()) {
+            throw std::runtime_error("No benchmark was selected! Use -h to show all available options.");
+        }
+
+        if (roofline && mpi_comm_rank == 0) {
+            auto entries = hpcc_suite::computeRoofline(summaries, result["peak-gflops"].as<double>());
+            std::cout << "Roofline analysis:" << std::endl << hpcc_suite::formatRoofline(entries);
+            summaries.push_back(hpcc_suite::rooflineSummary(entries));
+            success = success && summaries.back().success;
+        }
+
+        if (mpi_comm_rank == 0) {
+            std::string summary = hpcc_suite::formatSummary(summaries);
+            std::cout << summary;
+            auto summary_file = result["summary"].as<std::string>();
+            if (!summary_file.empty()) {
+                std::ofstream fs(summary_file);
+                if (!fs.is_open()) {
+                    std::cerr << "WARNING: Could not open " << summary_file << " to write the summary!" << std::endl;
+                }
+                fs << summary;
+            }
+        }
+    }
+    catch (const std::exception &e) {
+        if (mpi_comm_rank == 0) {
+            std::cerr << "ERROR: " << e.what() << std::endl;
+        }
+        success = false;
+    }
+
+    MPI_Finalize();
+    return success ? 0 : 1;
+}